@@ -0,0 +1,210 @@
+"""
+Overhead benchmark for the allocator proxy.
+
+Builds the allocator benchmark of examples/07-custom-allocator linked
+directly against an allocator, and linked against the ToolchainKit allocator
+proxy forwarding to the same allocator, then reports the median time of each
+benchmark over several runs (interleaved, so background load affects every
+variant alike):
+
+- direct: the allocator linked into the executable (system malloc by default)
+- proxy: the proxy loading the allocator at startup
+- proxy, stats: with per-size-class counters
+- proxy, sampled: with counters and one in --sample allocation sites recorded
+
+Usage:
+    python scripts/benchmarks/bench_allocator_proxy.py [--cxx PATH]
+                                                       [--allocator LIBRARY]
+                                                       [--runs N] [--sample N]
+                                                       [--json]
+
+Example:
+    python scripts/benchmarks/bench_allocator_proxy.py \\
+        --allocator /usr/lib/x86_64-linux-gnu/libjemalloc.so.2
+"""
+
+import argparse
+import json
+import os
+import re
+import statistics
+import subprocess
+import sys
+import tempfile
+from pathlib import Path
+
+ROOT = Path(__file__).resolve().parents[2]
+BENCH_SOURCE = ROOT / "examples" / "07-custom-allocator" / "src" / "benchmark.cpp"
+PROXY_SOURCE = (
+    ROOT / "toolchainkit" / "data" / "runtime" / "allocator" / "tk_malloc_proxy.cpp"
+)
+
+MAIN_SOURCE = "void run_benchmark();\nint main() { run_benchmark(); }\n"
+
+# "Small allocations (64 bytes)        :      1.234 ms (...)"
+_RESULT_LINE = re.compile(r"^(.+?)\s+:\s+([\d.]+) ms")
+
+
+def _run(command: list, cwd: Path) -> None:
+    """Run a build command, raising with its stderr on failure."""
+    result = subprocess.run(
+        command, cwd=cwd, capture_output=True, text=True, check=False
+    )
+    if result.returncode != 0:
+        raise RuntimeError(f"{' '.join(command)}\n{result.stderr.strip()}")
+
+
+def build_proxy(cxx: str, work_dir: Path) -> Path:
+    """Build the proxy as a shared library the way the toolchain file does."""
+    library = work_dir / "libtoolchainkit_allocator_proxy.so"
+    flags = ["-O2", "-std=c++17", "-fPIC", "-shared", "-fvisibility=hidden"]
+    _run(
+        [cxx, *flags, "-fno-builtin", str(PROXY_SOURCE), "-o", str(library)]
+        + ["-ldl", "-pthread"],
+        work_dir,
+    )
+    return library
+
+
+def build_variants(cxx: str, allocator: str, work_dir: Path) -> dict:
+    """
+    Build the benchmark linked directly and through the proxy.
+
+    Returns:
+        Mapping of binary name to path
+    """
+    proxy = build_proxy(cxx, work_dir)
+    main = work_dir / "main.cpp"
+    main.write_text(MAIN_SOURCE)
+    direct = []
+    if allocator != "system":
+        direct = [allocator, f"-Wl,-rpath,{Path(allocator).parent}"]
+    builds = {
+        "direct": direct,
+        "proxy": [str(proxy), f"-Wl,-rpath,{proxy.parent}"],
+    }
+    binaries = {}
+    for name, flags in builds.items():
+        binary = work_dir / f"bench_{name}"
+        _run(
+            [cxx, "-O2", "-std=c++17", str(main), str(BENCH_SOURCE), *flags]
+            + ["-o", str(binary)],
+            work_dir,
+        )
+        binaries[name] = binary
+    return binaries
+
+
+def parse_results(output: str) -> dict:
+    """Parse benchmark names and milliseconds from the benchmark's output."""
+    results = {}
+    for line in output.splitlines():
+        match = _RESULT_LINE.match(line)
+        if match:
+            results[match.group(1).strip()] = float(match.group(2))
+    return results
+
+
+def run_benchmark(cxx: str, allocator: str, runs: int, sample: int) -> dict:
+    """
+    Build and time every variant.
+
+    Args:
+        cxx: C++ compiler driver
+        allocator: Allocator library, or "system" for the C library's malloc
+        runs: Runs per variant (medians are reported)
+        sample: Sampling rate of the sampled proxy variant
+
+    Returns:
+        Dictionary with milliseconds per benchmark per variant
+    """
+    with tempfile.TemporaryDirectory() as tmp:
+        work_dir = Path(tmp)
+        binaries = build_variants(cxx, allocator, work_dir)
+        proxy_env = {
+            "TOOLCHAINKIT_ALLOCATOR": allocator,
+            "TOOLCHAINKIT_ALLOCATOR_REPORT": str(work_dir / "report.%p.json"),
+        }
+        variants = [
+            ("direct", "direct", {}),
+            ("proxy", "proxy", proxy_env),
+            (
+                "proxy, stats",
+                "proxy",
+                {**proxy_env, "TOOLCHAINKIT_ALLOCATOR_STATS": "1"},
+            ),
+            (
+                f"proxy, sample={sample}",
+                "proxy",
+                {**proxy_env, "TOOLCHAINKIT_ALLOCATOR_SAMPLE": str(sample)},
+            ),
+        ]
+        samples = {name: {} for name, _, _ in variants}
+        for _ in range(runs):
+            for name, binary, env in variants:
+                output = subprocess.run(
+                    [str(binaries[binary])],
+                    env={**os.environ, **env},
+                    capture_output=True,
+                    text=True,
+                    check=True,
+                ).stdout
+                for benchmark, ms in parse_results(output).items():
+                    samples[name].setdefault(benchmark, []).append(ms)
+
+    results = []
+    for name, _, _ in variants:
+        medians = {b: statistics.median(ms) for b, ms in samples[name].items()}
+        results.append(
+            {"variant": name, "benchmarks": medians, "total_ms": sum(medians.values())}
+        )
+    baseline = results[0]["total_ms"]
+    for result in results:
+        result["overhead"] = result["total_ms"] / baseline - 1 if baseline else 0.0
+    return {"cxx": cxx, "allocator": allocator, "runs": runs, "variants": results}
+
+
+def main():
+    """Main entry point."""
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    parser.add_argument("--cxx", default="c++", help="C++ compiler (default: c++)")
+    parser.add_argument(
+        "--allocator",
+        default="system",
+        help="Allocator library to link and to load (default: system malloc)",
+    )
+    parser.add_argument("--runs", type=int, default=20)
+    parser.add_argument("--sample", type=int, default=1000)
+    parser.add_argument("--json", action="store_true", help="Print JSON results")
+    args = parser.parse_args()
+
+    try:
+        result = run_benchmark(args.cxx, args.allocator, args.runs, args.sample)
+    except (OSError, RuntimeError, subprocess.CalledProcessError) as e:
+        print(f"Error: {e}", file=sys.stderr)
+        sys.exit(1)
+
+    if args.json:
+        print(json.dumps(result, indent=2))
+        return
+
+    variants = result["variants"]
+    width = max(len(b) for b in variants[0]["benchmarks"])
+    print(
+        f"Allocator proxy overhead ({result['allocator']}), "
+        f"median of {result['runs']} runs, ms"
+    )
+    print(f"  {'':<{width}}" + "".join(f"{v['variant']:>20}" for v in variants))
+    for benchmark in variants[0]["benchmarks"]:
+        row = "".join(
+            f"{v['benchmarks'].get(benchmark, float('nan')):>20.3f}" for v in variants
+        )
+        print(f"  {benchmark:<{width}}{row}")
+    total = "".join(f"{v['total_ms']:>20.3f}" for v in variants)
+    print(f"  {'Total':<{width}}{total}")
+    change = "".join(f"{v['overhead']:>+20.1%}" for v in variants)
+    print(f"  {'Change':<{width}}{change}")
+
+
+if __name__ == "__main__":
+    main()
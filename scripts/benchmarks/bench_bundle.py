@@ -0,0 +1,164 @@
+"""
+Offline bundle import benchmark.
+
+Compares installing a synthetic toolchain tree from a tar.gz archive (the
+download path: extract, then write the integrity manifest) with importing
+the same tree from a bundle (parallel unpack, manifest from the hashes
+verified while unpacking). Archive and bundle are read from the page cache,
+so the numbers measure unpacking, not the network or the disk.
+
+Usage:
+    python scripts/benchmarks/bench_bundle.py [--files N] [--size-mb N]
+                                              [--codec zstd|zlib] [--json]
+
+Example:
+    python scripts/benchmarks/bench_bundle.py --files 4000 --size-mb 400
+"""
+
+import argparse
+import json
+import os
+import random
+import shutil
+import sys
+import tarfile
+import tempfile
+import time
+from pathlib import Path
+
+sys.path.insert(0, str(Path(__file__).resolve().parents[2]))
+
+from toolchainkit.config.lockfile import LockedComponent, LockFile  # noqa: E402
+from toolchainkit.core.bundle import default_codec  # noqa: E402
+from toolchainkit.core.filesystem import extract_archive  # noqa: E402
+from toolchainkit.core.manifest import write_manifest  # noqa: E402
+from toolchainkit.toolchain.prefetch import export_bundle, import_bundle  # noqa: E402
+
+TOOLCHAIN_ID = "bench-1.0-linux-x64"
+
+
+def build_tree(root: Path, files: int, size_mb: int) -> None:
+    """Create a toolchain-like tree: many small headers, a few large binaries."""
+    rng = random.Random(1)
+    # Compressible but not trivial content, like real object code
+    words = [os.urandom(8).hex().encode() for _ in range(512)]
+    block = b" ".join(rng.choice(words) for _ in range(64 * 1024))
+    big = max(1, files // 400)
+    big_size = size_mb * 1024 * 1024 * 3 // 4 // big
+    small_size = size_mb * 1024 * 1024 // 4 // max(1, files - big)
+    for i in range(files):
+        path = root / f"dir{i % 40}" / f"file{i}"
+        path.parent.mkdir(parents=True, exist_ok=True)
+        size = big_size if i < big else small_size
+        with open(path, "wb") as f:
+            while size > 0:
+                chunk = block[: min(size, len(block))]
+                f.write(chunk)
+                size -= len(chunk)
+
+
+def _best(func, repeats: int) -> float:
+    """Best wall time of several runs (func returns a directory to remove)."""
+    samples = []
+    for _ in range(repeats):
+        start = time.perf_counter()
+        cleanup = func()
+        samples.append(time.perf_counter() - start)
+        shutil.rmtree(cleanup)
+    return min(samples)
+
+
+def run_benchmark(files: int, size_mb: int, codec: str, repeats: int) -> dict:
+    """
+    Time archive extraction and bundle import of the same tree.
+
+    Args:
+        files: Number of files in the tree
+        size_mb: Total tree size in MiB
+        codec: Bundle codec
+        repeats: Runs per case (best is reported)
+
+    Returns:
+        Dictionary of case name -> {"seconds", "bytes"}
+    """
+    results = {}
+    with tempfile.TemporaryDirectory() as tmp:
+        tmp = Path(tmp)
+        online = tmp / "online"
+        tree = online / "toolchains" / TOOLCHAIN_ID
+        build_tree(tree, files, size_mb)
+
+        archive = tmp / "toolchain.tar.gz"
+        with tarfile.open(archive, "w:gz") as tar:
+            tar.add(tree, arcname=TOOLCHAIN_ID)
+        lock = LockFile(
+            toolchains={
+                TOOLCHAIN_ID: LockedComponent(
+                    url="https://example.com/toolchain.tar.gz",
+                    sha256="0" * 64,
+                    size_bytes=archive.stat().st_size,
+                )
+            }
+        )
+        bundle = tmp / "deps.tkb"
+        start = time.perf_counter()
+        export_bundle(lock, bundle, cache_dir=online, codec=codec)
+        export_seconds = time.perf_counter() - start
+        for path in (archive, bundle):
+            path.read_bytes()  # Warm the page cache
+
+        def from_archive():
+            target = tmp / "archive"
+            extract_archive(archive, target)
+            write_manifest(target / TOOLCHAIN_ID)
+            return target
+
+        def from_bundle():
+            target = tmp / "offline"
+            import_bundle(bundle, lock, cache_dir=target)
+            return target
+
+        results["export bundle"] = {
+            "seconds": export_seconds,
+            "bytes": bundle.stat().st_size,
+        }
+        results["tar.gz extract + manifest"] = {
+            "seconds": _best(from_archive, repeats),
+            "bytes": archive.stat().st_size,
+        }
+        results[f"bundle import ({codec})"] = {
+            "seconds": _best(from_bundle, repeats),
+            "bytes": bundle.stat().st_size,
+        }
+    return results
+
+
+def main():
+    """Main entry point."""
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    parser.add_argument("--files", type=int, default=4000)
+    parser.add_argument("--size-mb", type=int, default=400)
+    parser.add_argument("--codec", choices=["zstd", "zlib"], default=default_codec())
+    parser.add_argument("--repeats", type=int, default=3)
+    parser.add_argument("--json", action="store_true", help="Print JSON results")
+    args = parser.parse_args()
+
+    results = run_benchmark(args.files, args.size_mb, args.codec, args.repeats)
+
+    if args.json:
+        print(json.dumps(results, indent=2))
+        return
+
+    print(
+        f"Toolchain install: {args.files} files, {args.size_mb} MB "
+        f"({os.cpu_count()} CPUs)"
+    )
+    for name, result in results.items():
+        print(
+            f"  {name:<28} {result['seconds']:6.2f} s  "
+            f"({result['bytes'] / 1024**2:6.1f} MB on disk)"
+        )
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,155 @@
+"""
+Throughput benchmark for the embedded compiler cache server.
+
+Simulates a parallel build against ``CacheServer``: each worker thread plays
+a compiler launcher slot (like ``-jN``) that looks up an object, misses, and
+uploads it (cold build), then a second pass fetches every object again
+(warm build). Object sizes follow a log-uniform distribution between 4 KB
+and 2 MB, roughly matching C++ object files.
+
+Usage:
+    python scripts/benchmarks/bench_cache_server.py [--jobs N] [--objects N]
+                                                     [--compression CODEC] [--json]
+
+Example:
+    python scripts/benchmarks/bench_cache_server.py --jobs 16 --objects 2000
+"""
+
+import argparse
+import json
+import statistics
+import sys
+import tempfile
+import threading
+import time
+from concurrent.futures import ThreadPoolExecutor
+from pathlib import Path
+
+import requests
+
+sys.path.insert(0, str(Path(__file__).resolve().parents[2]))
+
+from toolchainkit.caching.benchmark import (  # noqa: E402
+    object_size_distribution,
+    percentile,
+    synthetic_payload,
+)
+from toolchainkit.caching.server import CacheServer, DiskLRUStore  # noqa: E402
+
+
+def _run_phase(url: str, jobs: int, work: list, phase: str) -> dict:
+    """Run one build phase and collect latency/throughput figures."""
+    latencies = []
+    transferred = 0
+    sessions = {}
+
+    def _session():
+        # One keep-alive connection per compile slot
+        ident = threading.get_ident()
+        if ident not in sessions:
+            sessions[ident] = requests.Session()
+        return sessions[ident]
+
+    def compile_unit(item):
+        key, data = item
+        session = _session()
+        start = time.perf_counter()
+        response = session.get(url + key, timeout=30)
+        if phase == "cold":
+            assert response.status_code == 404
+            session.put(url + key, data=data, timeout=30)
+        else:
+            assert response.status_code == 200 and len(response.content) == len(data)
+        return time.perf_counter() - start, len(data)
+
+    start = time.perf_counter()
+    with ThreadPoolExecutor(max_workers=jobs) as pool:
+        for latency, size in pool.map(compile_unit, work):
+            latencies.append(latency)
+            transferred += size
+    elapsed = time.perf_counter() - start
+
+    for session in sessions.values():
+        session.close()
+
+    return {
+        "phase": phase,
+        "requests": len(work),
+        "seconds": elapsed,
+        "ops_per_sec": len(work) / elapsed,
+        "mb_per_sec": transferred / elapsed / (1024 * 1024),
+        "p50_ms": percentile(latencies, 50) * 1000,
+        "p99_ms": percentile(latencies, 99) * 1000,
+        "mean_ms": statistics.mean(latencies) * 1000,
+    }
+
+
+def run_benchmark(jobs: int, objects: int, compression: str) -> dict:
+    """
+    Run cold and warm build phases against a fresh server.
+
+    Args:
+        jobs: Number of concurrent compile slots
+        objects: Number of cache objects (translation units)
+        compression: Store compression codec
+
+    Returns:
+        Dictionary with per-phase results and store statistics
+    """
+    sizes = object_size_distribution(objects)
+    work = [
+        (f"{i % 256:02x}/obj{i:06d}", synthetic_payload(s, i))
+        for i, s in enumerate(sizes)
+    ]
+
+    with tempfile.TemporaryDirectory() as tmp:
+        store = DiskLRUStore(Path(tmp), max_size="8G", compression=compression)
+        with CacheServer(store, port=0).start() as server:
+            cold = _run_phase(server.url, jobs, work, "cold")
+            warm = _run_phase(server.url, jobs, work, "warm")
+            stats = store.stats().to_dict()
+
+    return {
+        "jobs": jobs,
+        "objects": objects,
+        "compression": compression,
+        "total_mb": sum(sizes) / (1024 * 1024),
+        "phases": [cold, warm],
+        "store": stats,
+    }
+
+
+def main():
+    """Main entry point."""
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    parser.add_argument("--jobs", type=int, default=16)
+    parser.add_argument("--objects", type=int, default=1000)
+    parser.add_argument(
+        "--compression", choices=["zlib", "zstd", "none"], default="zlib"
+    )
+    parser.add_argument("--json", action="store_true", help="Print JSON results")
+    args = parser.parse_args()
+
+    result = run_benchmark(args.jobs, args.objects, args.compression)
+
+    if args.json:
+        print(json.dumps(result, indent=2))
+        return
+
+    print(
+        f"Cache server: {result['objects']} objects, {result['total_mb']:.1f} MB, "
+        f"-j{result['jobs']}, compression={result['compression']}"
+    )
+    for phase in result["phases"]:
+        print(
+            f"  {phase['phase']:>4}: {phase['ops_per_sec']:8.1f} ops/s "
+            f"{phase['mb_per_sec']:8.1f} MB/s  "
+            f"p50 {phase['p50_ms']:6.2f} ms  p99 {phase['p99_ms']:6.2f} ms"
+        )
+    store = result["store"]
+    ratio = store["bytes_in"] / store["stored_bytes"] if store["stored_bytes"] else 0
+    print(f"  stored {store['stored_bytes'] / 1024**2:.1f} MB (ratio {ratio:.2f}x)")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,105 @@
+"""
+CLI startup benchmark.
+
+Runs ``tkgen <command> --help`` in fresh interpreters and reports the best
+wall time, the interpreter's own startup for comparison and the number of
+toolchainkit modules imported while parsing arguments.
+
+Usage:
+    python scripts/benchmarks/bench_cli_startup.py [--runs N] [--json]
+
+Example:
+    python scripts/benchmarks/bench_cli_startup.py --runs 20
+"""
+
+import argparse
+import json
+import subprocess
+import sys
+import time
+from pathlib import Path
+
+ROOT = Path(__file__).resolve().parents[2]
+
+COMMANDS = [
+    [],
+    ["init"],
+    ["configure"],
+    ["doctor"],
+    ["upgrade"],
+    ["cache"],
+]
+
+PROBE = """
+import sys
+from toolchainkit.cli.parser import CLI
+try:
+    CLI().run(sys.argv[1:])
+except SystemExit:
+    pass
+print(sum(1 for m in sys.modules if m.startswith("toolchainkit")))
+"""
+
+
+def best_of(argv: list, runs: int) -> float:
+    """Best wall time in seconds of running argv in a fresh interpreter."""
+    best = float("inf")
+    for _ in range(runs):
+        start = time.perf_counter()
+        subprocess.run(argv, cwd=ROOT, capture_output=True, check=False)
+        best = min(best, time.perf_counter() - start)
+    return best
+
+
+def run_benchmark(runs: int) -> dict:
+    """
+    Time --help of every command.
+
+    Returns:
+        Dictionary of case name -> {"seconds", "modules"}
+    """
+    results = {
+        "python -c pass": {
+            "seconds": best_of([sys.executable, "-c", "pass"], runs),
+            "modules": 0,
+        }
+    }
+    for command in COMMANDS:
+        argv = [*command, "--help"]
+        probe = subprocess.run(
+            [sys.executable, "-c", PROBE, *argv],
+            cwd=ROOT,
+            capture_output=True,
+            text=True,
+            check=False,
+        )
+        results[" ".join(["tkgen", *argv])] = {
+            "seconds": best_of([sys.executable, "-m", "toolchainkit.cli", *argv], runs),
+            "modules": int(probe.stdout.strip().splitlines()[-1]),
+        }
+    return results
+
+
+def main():
+    """Main entry point."""
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    parser.add_argument("--runs", type=int, default=10)
+    parser.add_argument("--json", action="store_true", help="Print JSON results")
+    args = parser.parse_args()
+
+    results = run_benchmark(args.runs)
+
+    if args.json:
+        print(json.dumps(results, indent=2))
+        return
+
+    print(f"CLI startup, best of {args.runs} runs")
+    for name, result in results.items():
+        print(
+            f"  {name:<24} {result['seconds'] * 1000:7.1f} ms  "
+            f"{result['modules']:3d} toolchainkit modules"
+        )
+
+
+if __name__ == "__main__":
+    main()
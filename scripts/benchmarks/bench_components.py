@@ -0,0 +1,169 @@
+"""
+Component selection benchmark.
+
+Builds a synthetic tree with the layout and rough proportions of an LLVM
+release (clang, lld, runtimes, tools, lldb, MLIR, Flang, static libraries,
+documentation), packs it as tar.gz and compares a full install (extract,
+then write the integrity manifest) with installs of the ``minimal`` and
+``analysis`` profiles from ``toolchains.json``. Adding the ``bolt``
+component to a minimal install afterwards is timed as well.
+
+Usage:
+    python scripts/benchmarks/bench_components.py [--size-mb N] [--json]
+
+Example:
+    python scripts/benchmarks/bench_components.py --size-mb 500
+"""
+
+import argparse
+import json
+import os
+import shutil
+import sys
+import tarfile
+import tempfile
+import time
+from pathlib import Path
+
+sys.path.insert(0, str(Path(__file__).resolve().parents[2]))
+
+from toolchainkit.core.filesystem import directory_size, extract_archive  # noqa: E402
+from toolchainkit.core.manifest import write_manifest  # noqa: E402
+from toolchainkit.toolchain.components import (  # noqa: E402
+    member_filter,
+    resolve_selection,
+)
+from toolchainkit.toolchain.downloader import _component_root, _merge_tree  # noqa: E402
+from toolchainkit.toolchain.metadata_registry import (  # noqa: E402
+    ToolchainMetadataRegistry,
+)
+
+ROOT = "clang+llvm-18.1.8-x86_64-linux-gnu"
+
+# (relative path, share of the total size) - roughly an LLVM 18 release
+LAYOUT = [
+    ("bin/clang-18", 0.07),
+    ("bin/lld", 0.04),
+    ("lib/libLLVM-18.so", 0.07),
+    ("lib/libclang-cpp.so.18", 0.04),
+    ("lib/clang/18/include/stddef.h", 0.001),
+    ("lib/x86_64-unknown-linux-gnu/libc++.a", 0.01),
+    ("lib/libomp.so", 0.005),
+    ("bin/llvm-ar", 0.01),
+    ("bin/llvm-objdump", 0.01),
+    ("bin/llvm-profdata", 0.01),
+    ("bin/clang-tidy", 0.04),
+    ("bin/clangd", 0.05),
+    ("bin/clang-format", 0.01),
+    ("bin/lldb", 0.01),
+    ("lib/liblldb.so.18", 0.05),
+    ("bin/llvm-bolt", 0.03),
+    ("lib/libbolt_rt_instr.a", 0.001),
+    ("bin/mlir-opt", 0.04),
+    ("lib/libMLIRIR.a", 0.12),
+    ("bin/flang-new", 0.05),
+    ("lib/libFortranRuntime.a", 0.03),
+    ("lib/libLLVMCore.a", 0.12),
+    ("lib/libclangAST.a", 0.10),
+    ("include/llvm/IR/Module.h", 0.01),
+    ("share/doc/LLVM/index.html", 0.002),
+    ("README.txt", 0.0001),
+]
+
+
+def build_archive(tmp: Path, size_mb: int) -> Path:
+    """Create the synthetic release tree and pack it as tar.gz."""
+    source = tmp / "source" / ROOT
+    block = os.urandom(256 * 1024) + bytes(256 * 1024)  # Half compressible
+    for rel, share in LAYOUT:
+        path = source / rel
+        path.parent.mkdir(parents=True, exist_ok=True)
+        size = max(1, int(size_mb * 1024 * 1024 * share))
+        with open(path, "wb") as f:
+            while size > 0:
+                f.write(block[:size])
+                size -= len(block)
+    archive = tmp / f"{ROOT}.tar.gz"
+    with tarfile.open(archive, "w:gz", compresslevel=1) as tar:
+        tar.add(source, arcname=ROOT)
+    shutil.rmtree(tmp / "source")
+    return archive
+
+
+def install(archive: Path, destination: Path, keep=None) -> float:
+    """Extract and write the manifest, returning the elapsed seconds."""
+    start = time.perf_counter()
+    extract_archive(archive, destination, member_filter=keep)
+    write_manifest(destination / ROOT)
+    return time.perf_counter() - start
+
+
+def run_benchmark(size_mb: int) -> dict:
+    """
+    Time full and profile installs of the same archive.
+
+    Returns:
+        Dictionary of case name -> {"bytes", "files", "seconds"}
+    """
+    metadata = ToolchainMetadataRegistry().lookup("llvm", "18", "linux-x64")
+    components, profiles = metadata.components, metadata.profiles
+
+    results = {}
+    with tempfile.TemporaryDirectory() as tmp:
+        tmp = Path(tmp)
+        archive = build_archive(tmp, size_mb)
+        archive.read_bytes()  # Warm the page cache
+
+        for name in ("full", "minimal", "analysis"):
+            selection = resolve_selection(components, profiles, name)
+            keep = member_filter(components, selection) if selection else None
+            destination = tmp / name
+            seconds = install(archive, destination, keep)
+            root = destination / ROOT
+            results[name] = {
+                "bytes": directory_size(root),
+                "files": sum(1 for p in root.rglob("*") if p.is_file()),
+                "seconds": seconds,
+            }
+
+        start = time.perf_counter()
+        staging = tmp / "bolt"
+        extract_archive(
+            archive, staging, member_filter=member_filter(components, ["bolt"], True)
+        )
+        added, added_bytes = _merge_tree(
+            _component_root(staging, tmp / "minimal" / ROOT), tmp / "minimal" / ROOT
+        )
+        results["add bolt to minimal"] = {
+            "bytes": added_bytes,
+            "files": len(added),
+            "seconds": time.perf_counter() - start,
+        }
+    return results
+
+
+def main():
+    """Main entry point."""
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    parser.add_argument("--size-mb", type=int, default=300)
+    parser.add_argument("--json", action="store_true", help="Print JSON results")
+    args = parser.parse_args()
+
+    results = run_benchmark(args.size_mb)
+
+    if args.json:
+        print(json.dumps(results, indent=2))
+        return
+
+    full = results["full"]
+    print(f"LLVM-like release, {args.size_mb} MB uncompressed")
+    for name, result in results.items():
+        print(
+            f"  {name:<20} {result['bytes'] / 1024**2:7.1f} MB "
+            f"({100 * result['bytes'] / full['bytes']:5.1f}%)  "
+            f"{result['files']:3d} files  {result['seconds']:6.2f} s"
+        )
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,133 @@
+"""
+tkgen daemon benchmark.
+
+Creates a throwaway home directory and CMake project with an installed
+(stub) LLVM toolchain, then times repeated ``tkgen configure``, ``doctor``
+and ``verify`` runs in fresh interpreters, first in-process and then served
+by a running ``tkgen daemon``.
+
+Usage:
+    python scripts/benchmarks/bench_daemon.py [--runs N] [--json]
+
+Example:
+    python scripts/benchmarks/bench_daemon.py --runs 20
+"""
+
+import argparse
+import json
+import os
+import statistics
+import subprocess
+import sys
+import tempfile
+import time
+from pathlib import Path
+
+ROOT = Path(__file__).resolve().parents[2]
+
+COMMANDS = {
+    "configure": ["configure", "--toolchain", "llvm-18"],
+    "doctor": ["doctor"],
+    "verify": ["verify"],
+}
+
+
+def tkgen(env: dict, cwd: Path, *argv: str) -> subprocess.CompletedProcess:
+    """Run tkgen in a fresh interpreter."""
+    return subprocess.run(
+        [sys.executable, "-m", "toolchainkit.cli", *argv],
+        cwd=cwd,
+        env=env,
+        capture_output=True,
+        check=False,
+    )
+
+
+def setup(tmp: Path) -> tuple:
+    """Create the home directory, stub toolchain and project."""
+    home = tmp / "home"
+    toolchain = home / ".toolchainkit" / "toolchains" / "llvm-18.1.8-linux-x64"
+    for tool in ("clang", "clang++"):
+        path = toolchain / "bin" / tool
+        path.parent.mkdir(parents=True, exist_ok=True)
+        path.write_text("#!/bin/sh\necho 'clang version 18.1.8'\n")
+        path.chmod(0o755)
+
+    project = tmp / "project"
+    project.mkdir()
+    (project / "CMakeLists.txt").write_text(
+        "cmake_minimum_required(VERSION 3.20)\nproject(bench CXX)\n"
+    )
+    env = dict(
+        os.environ,
+        HOME=str(home),
+        PYTHONPATH=str(ROOT),
+        TOOLCHAINKIT_DAEMON_SOCKET=str(tmp / "daemon.sock"),
+    )
+    tkgen(env, project, "init", "--minimal")
+    return env, project
+
+
+def time_runs(env: dict, cwd: Path, argv: list, runs: int) -> dict:
+    """Median and minimum wall time of runs, plus the last exit code."""
+    times = []
+    for _ in range(runs):
+        start = time.perf_counter()
+        result = tkgen(env, cwd, *argv)
+        times.append(time.perf_counter() - start)
+    return {
+        "median": statistics.median(times),
+        "min": min(times),
+        "exit": result.returncode,
+    }
+
+
+def run_benchmark(runs: int) -> dict:
+    """
+    Time every command without and with the daemon.
+
+    Returns:
+        Dictionary of command -> {"in-process": stats, "daemon": stats}
+    """
+    results = {name: {} for name in COMMANDS}
+    with tempfile.TemporaryDirectory() as tmp:
+        env, project = setup(Path(tmp))
+
+        for name, argv in COMMANDS.items():
+            results[name]["in-process"] = time_runs(env, project, argv, runs)
+
+        tkgen(env, project, "daemon", "start")
+        try:
+            for name, argv in COMMANDS.items():
+                tkgen(env, project, *argv)  # Let the daemon settle
+                results[name]["daemon"] = time_runs(env, project, argv, runs)
+        finally:
+            tkgen(env, project, "daemon", "stop")
+    return results
+
+
+def main():
+    """Main entry point."""
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    parser.add_argument("--runs", type=int, default=10)
+    parser.add_argument("--json", action="store_true", help="Print JSON results")
+    args = parser.parse_args()
+
+    results = run_benchmark(args.runs)
+
+    if args.json:
+        print(json.dumps(results, indent=2))
+        return
+
+    print(f"tkgen latency, {args.runs} runs (median / min)")
+    for name, modes in results.items():
+        cold, warm = modes["in-process"], modes["daemon"]
+        print(
+            f"  {name:<10} in-process {cold['median'] * 1000:6.0f} / "
+            f"{cold['min'] * 1000:4.0f} ms   daemon {warm['median'] * 1000:6.0f} / "
+            f"{warm['min'] * 1000:4.0f} ms   ({cold['median'] / warm['median']:.1f}x)"
+        )
+
+
+if __name__ == "__main__":
+    main()
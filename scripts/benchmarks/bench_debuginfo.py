@@ -0,0 +1,216 @@
+"""
+Link time and build directory size benchmark for the debuginfo layers.
+
+Builds the synthetic project used by the linker benchmark twice, once with
+the flags composed from the given layers and once with ``debuginfo/<name>``
+added, then reports compile time, median link time and the size of the
+build directory (objects, .dwo files and the linked binary). With split
+DWARF enabled, the time to package a .dwp is reported as well.
+
+Usage:
+    python scripts/benchmarks/bench_debuginfo.py [--layers LIST] [--cxx PATH]
+                                                 [--units N] [--functions N]
+                                                 [--repeats N] [--json]
+
+Example:
+    python scripts/benchmarks/bench_debuginfo.py \\
+        --layers base/gcc-13,platform/linux-x64,buildtype/debug --units 64
+"""
+
+import argparse
+import json
+import os
+import shutil
+import statistics
+import subprocess
+import sys
+import tempfile
+import time
+from concurrent.futures import ThreadPoolExecutor
+from pathlib import Path
+
+sys.path.insert(0, str(Path(__file__).resolve().parents[2]))
+
+from toolchainkit.config.composer import LayerComposer  # noqa: E402
+from toolchainkit.toolchain.linker_benchmark import synthetic_unit_source  # noqa: E402
+
+
+def _dir_size(path: Path) -> int:
+    """Total size of all files below path."""
+    return sum(f.stat().st_size for f in path.rglob("*") if f.is_file())
+
+
+def _run(command: list, cwd: Path) -> None:
+    """Run a build command, raising with its stderr on failure."""
+    result = subprocess.run(command, cwd=cwd, capture_output=True, text=True)
+    if result.returncode != 0:
+        raise RuntimeError(f"{' '.join(command)}\n{result.stderr.strip()}")
+
+
+def build_variant(
+    cxx: str, config, work_dir: Path, units: int, functions: int, repeats: int
+) -> dict:
+    """
+    Compile and link the synthetic project with one composed configuration.
+
+    Args:
+        cxx: C++ compiler driver
+        config: ComposedConfig providing compile and link flags
+        work_dir: Build directory for this variant
+        units: Synthetic translation units
+        functions: Functions per translation unit
+        repeats: Timed links (median is reported)
+
+    Returns:
+        Dictionary with timings and sizes
+    """
+    work_dir.mkdir(parents=True)
+    compile_flags = list(config.compile_flags) + [f"-D{d}" for d in config.defines]
+    link_flags = list(config.link_flags)
+
+    def compile_unit(unit: int) -> Path:
+        source = work_dir / f"unit{unit}.cpp"
+        source.write_text(synthetic_unit_source(unit, units, functions))
+        obj = work_dir / f"unit{unit}.o"
+        _run([cxx, "-c", *compile_flags, str(source), "-o", str(obj)], work_dir)
+        return obj
+
+    start = time.perf_counter()
+    with ThreadPoolExecutor(max_workers=os.cpu_count() or 1) as pool:
+        objects = [str(obj) for obj in pool.map(compile_unit, range(units + 1))]
+    compile_seconds = time.perf_counter() - start
+
+    binary = work_dir / "app"
+    samples = []
+    for run in range(repeats + 1):
+        start = time.perf_counter()
+        _run([cxx, *objects, "-o", str(binary), *link_flags], work_dir)
+        if run > 0:  # First link warms the page cache
+            samples.append(time.perf_counter() - start)
+
+    for source in work_dir.glob("*.cpp"):
+        source.unlink()
+
+    result = {
+        "compile_seconds": compile_seconds,
+        "link_seconds": statistics.median(samples),
+        "build_dir_bytes": _dir_size(work_dir),
+        "binary_bytes": binary.stat().st_size,
+        "dwp_seconds": None,
+    }
+
+    dwp = config.cmake_variables.get("TOOLCHAINKIT_DWP")
+    if dwp and shutil.which(dwp):
+        start = time.perf_counter()
+        _run([dwp, "-e", str(binary), "-o", str(binary) + ".dwp"], work_dir)
+        result["dwp_seconds"] = time.perf_counter() - start
+        result["dwp_bytes"] = Path(str(binary) + ".dwp").stat().st_size
+    return result
+
+
+def run_benchmark(
+    layers: str, debuginfo: str, cxx: str, units: int, functions: int, repeats: int
+) -> dict:
+    """
+    Build the synthetic project with and without the debuginfo layer.
+
+    Args:
+        layers: Comma-separated layer list without a debuginfo layer
+        debuginfo: Debuginfo layer name (e.g., "fast")
+        cxx: C++ compiler driver
+        units: Synthetic translation units
+        functions: Functions per translation unit
+        repeats: Timed links per variant
+
+    Returns:
+        Dictionary with per-variant results
+    """
+    specs = [
+        {"type": spec.split("/")[0], "name": spec.split("/")[1]}
+        for spec in layers.split(",")
+    ]
+    composer = LayerComposer()
+    variants = {
+        "baseline": composer.compose(specs),
+        f"debuginfo/{debuginfo}": composer.compose(
+            specs + [{"type": "debuginfo", "name": debuginfo}]
+        ),
+    }
+
+    results = []
+    with tempfile.TemporaryDirectory() as tmp:
+        for name, config in variants.items():
+            result = build_variant(
+                cxx,
+                config,
+                Path(tmp) / name.replace("/", "-"),
+                units,
+                functions,
+                repeats,
+            )
+            result["variant"] = name
+            result["layer_flags"] = [
+                f
+                for f in config.compile_flags + config.link_flags
+                if f.startswith(("-g", "-Wl,--gdb"))
+            ]
+            results.append(result)
+
+    return {
+        "layers": layers,
+        "cxx": cxx,
+        "units": units,
+        "functions": functions,
+        "variants": results,
+    }
+
+
+def main():
+    """Main entry point."""
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    parser.add_argument(
+        "--layers", default="base/gcc-13,platform/linux-x64,buildtype/debug"
+    )
+    parser.add_argument("--debuginfo", default="fast")
+    parser.add_argument(
+        "--cxx", default=None, help="C++ compiler (default: g++/clang++)"
+    )
+    parser.add_argument("--units", type=int, default=64)
+    parser.add_argument("--functions", type=int, default=400)
+    parser.add_argument("--repeats", type=int, default=5)
+    parser.add_argument("--json", action="store_true", help="Print JSON results")
+    args = parser.parse_args()
+
+    cxx = args.cxx or ("clang++" if "base/clang" in args.layers else "g++")
+    result = run_benchmark(
+        args.layers, args.debuginfo, cxx, args.units, args.functions, args.repeats
+    )
+
+    if args.json:
+        print(json.dumps(result, indent=2))
+        return
+
+    print(
+        f"Debug info: {result['layers']} ({cxx}), "
+        f"{result['units']} units x {result['functions']} functions"
+    )
+    baseline = result["variants"][0]
+    for variant in result["variants"]:
+        link_delta = variant["link_seconds"] / baseline["link_seconds"] - 1
+        size_delta = variant["build_dir_bytes"] / baseline["build_dir_bytes"] - 1
+        print(
+            f"  {variant['variant']:>16}: compile {variant['compile_seconds']:6.2f} s  "
+            f"link {variant['link_seconds'] * 1000:7.1f} ms ({link_delta:+.0%})  "
+            f"build dir {variant['build_dir_bytes'] / 1024**2:7.1f} MB ({size_delta:+.0%})  "
+            f"binary {variant['binary_bytes'] / 1024**2:6.1f} MB"
+        )
+        if variant["dwp_seconds"] is not None:
+            print(
+                f"  {'':>16}  dwp {variant['dwp_seconds'] * 1000:7.1f} ms  "
+                f"{variant['dwp_bytes'] / 1024**2:6.1f} MB"
+            )
+        print(f"  {'':>16}  {' '.join(variant['layer_flags'])}")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,156 @@
+"""
+Delta upgrade benchmark.
+
+Compares upgrading a synthetic toolchain tree to a point release by
+downloading the full tar.gz archive (extract, then write the integrity
+manifest) with applying a delta patch against the installed base version.
+Transfer time is estimated from the file sizes and --bandwidth-mbps; the
+local work (extraction or patching) is measured.
+
+Usage:
+    python scripts/benchmarks/bench_delta_upgrade.py [--files N] [--size-mb N]
+                                                     [--changed PCT]
+                                                     [--bandwidth-mbps N] [--json]
+
+Example:
+    python scripts/benchmarks/bench_delta_upgrade.py --size-mb 400 --changed 10
+"""
+
+import argparse
+import json
+import os
+import random
+import shutil
+import sys
+import tarfile
+import tempfile
+import time
+from pathlib import Path
+
+sys.path.insert(0, str(Path(__file__).resolve().parents[2]))
+
+from toolchainkit.core.filesystem import extract_archive  # noqa: E402
+from toolchainkit.core.manifest import write_manifest  # noqa: E402
+from toolchainkit.toolchain.delta import (  # noqa: E402
+    _zstd_module,
+    apply_delta,
+    create_delta,
+)
+
+BASE_ID = "bench-1.0.0-linux-x64"
+TARGET_ID = "bench-1.0.1-linux-x64"
+
+
+def build_trees(tmp: Path, files: int, size_mb: int, changed: float):
+    """
+    Create a base tree and a point release of it.
+
+    The target renames the versioned resource directory, edits a few
+    regions of ``changed`` percent of the files and replaces one file.
+    """
+    rng = random.Random(1)
+    words = [os.urandom(8).hex().encode() for _ in range(512)]
+    block = b" ".join(rng.choice(words) for _ in range(64 * 1024))
+    big = max(1, files // 400)
+    big_size = size_mb * 1024 * 1024 * 3 // 4 // big
+    small_size = size_mb * 1024 * 1024 // 4 // max(1, files - big)
+
+    base, target = tmp / BASE_ID, tmp / TARGET_ID
+    for i in range(files):
+        rel = Path(f"dir{i % 40}") / f"file{i}"
+        if i % 40 == 0:
+            rel = Path("lib") / "1.0.0" / f"file{i}"
+        size = big_size if i < big else small_size
+        data = bytearray((block * (size // len(block) + 1))[:size])
+        data[:16] = i.to_bytes(16, "little")
+        for root, version in ((base, "1.0.0"), (target, "1.0.1")):
+            path = root / Path(*(version if p == "1.0.0" else p for p in rel.parts))
+            path.parent.mkdir(parents=True, exist_ok=True)
+            if root is target and rng.random() < changed / 100:
+                for _ in range(8):
+                    at = rng.randrange(len(data))
+                    data[at : at + 64] = os.urandom(min(64, len(data) - at))
+            path.write_bytes(data)
+    (target / "dir1" / "file1").write_bytes(os.urandom(small_size))
+    return base, target
+
+
+def run_benchmark(
+    files: int, size_mb: int, changed: float, bandwidth_mbps: float
+) -> dict:
+    """
+    Time a full and a delta upgrade of the same tree.
+
+    Returns:
+        Dictionary of case name -> {"bytes", "transfer_seconds", "local_seconds"}
+    """
+    results = {}
+    with tempfile.TemporaryDirectory() as tmp:
+        tmp = Path(tmp)
+        base, target = build_trees(tmp, files, size_mb, changed)
+        write_manifest(base)
+
+        archive = tmp / "target.tar.gz"
+        with tarfile.open(archive, "w:gz") as tar:
+            tar.add(target, arcname=TARGET_ID)
+        patch = tmp / "upgrade.tkdelta"
+        created = create_delta(base, target, patch, BASE_ID, TARGET_ID)
+        for path in (archive, patch):
+            path.read_bytes()  # Warm the page cache
+
+        start = time.perf_counter()
+        extract_archive(archive, tmp / "full")
+        write_manifest(tmp / "full" / TARGET_ID)
+        full_seconds = time.perf_counter() - start
+        shutil.rmtree(tmp / "full")
+
+        applied = apply_delta(patch, base, tmp / "delta" / TARGET_ID)
+
+        bytes_per_second = bandwidth_mbps * 1e6 / 8
+        for name, size, seconds in (
+            ("full archive", archive.stat().st_size, full_seconds),
+            ("delta", patch.stat().st_size, applied.seconds),
+        ):
+            results[name] = {
+                "bytes": size,
+                "transfer_seconds": size / bytes_per_second,
+                "local_seconds": seconds,
+            }
+        results["delta"]["summary"] = created.summary()
+    return results
+
+
+def main():
+    """Main entry point."""
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    parser.add_argument("--files", type=int, default=2000)
+    parser.add_argument("--size-mb", type=int, default=200)
+    parser.add_argument(
+        "--changed", type=float, default=10, help="Percent of files edited"
+    )
+    parser.add_argument("--bandwidth-mbps", type=float, default=100)
+    parser.add_argument("--json", action="store_true", help="Print JSON results")
+    args = parser.parse_args()
+
+    results = run_benchmark(args.files, args.size_mb, args.changed, args.bandwidth_mbps)
+
+    if args.json:
+        print(json.dumps(results, indent=2))
+        return
+
+    print(
+        f"Point-release upgrade: {args.files} files, {args.size_mb} MB, "
+        f"{args.changed:g}% edited, {args.bandwidth_mbps:g} Mbit/s "
+        f"(binary patches: {'yes' if _zstd_module() else 'no, zstandard missing'})"
+    )
+    for name, result in results.items():
+        total = result["transfer_seconds"] + result["local_seconds"]
+        print(
+            f"  {name:<14} {result['bytes'] / 1024**2:7.1f} MB  "
+            f"transfer {result['transfer_seconds']:6.2f} s + "
+            f"local {result['local_seconds']:5.2f} s = {total:6.2f} s"
+        )
+
+
+if __name__ == "__main__":
+    main()
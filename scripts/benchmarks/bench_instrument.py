@@ -0,0 +1,179 @@
+"""
+Per-call overhead benchmark for the instrument-functions runtime.
+
+Builds scripts/benchmarks/instrument/bench_instrument.cpp without
+instrumentation and with -finstrument-functions against several hook
+implementations, then reports nanoseconds per call of a small function and
+the overhead over the uninstrumented build:
+
+- empty hooks: the C library's no-op __cyg_profile_func_enter/exit
+- naive: a mutex-protected std::vector of steady_clock timestamps
+- runtime: the ToolchainKit runtime recording every call
+- runtime, sampled: the runtime recording about one call in --sample
+- runtime, excluded: the runtime with the function excluded by name
+
+Usage:
+    python scripts/benchmarks/bench_instrument.py [--cxx PATH] [--calls N]
+                                                  [--repeats N] [--sample N]
+                                                  [--json]
+
+Example:
+    python scripts/benchmarks/bench_instrument.py --cxx clang++ --calls 20000000
+"""
+
+import argparse
+import json
+import os
+import subprocess
+import sys
+import tempfile
+from pathlib import Path
+
+ROOT = Path(__file__).resolve().parents[2]
+BENCH_SOURCE = Path(__file__).resolve().parent / "instrument" / "bench_instrument.cpp"
+RUNTIME_DIR = ROOT / "toolchainkit" / "data" / "runtime" / "instrument"
+
+
+def _run(command: list, cwd: Path) -> None:
+    """Run a build command, raising with its stderr on failure."""
+    result = subprocess.run(
+        command, cwd=cwd, capture_output=True, text=True, check=False
+    )
+    if result.returncode != 0:
+        raise RuntimeError(f"{' '.join(command)}\n{result.stderr.strip()}")
+
+
+def _is_clang(cxx: str) -> bool:
+    result = subprocess.run(
+        [cxx, "--version"], capture_output=True, text=True, check=False
+    )
+    return "clang" in result.stdout
+
+
+def build_runtime(cxx: str, work_dir: Path) -> Path:
+    """Build the runtime as a shared library the way the toolchain file does."""
+    library = work_dir / "libtoolchainkit_instrument.so"
+    flags = ["-O2", "-std=c++17", "-fPIC", "-shared", "-fvisibility=hidden"]
+    if not _is_clang(cxx):
+        flags.append("-fno-instrument-functions")
+    _run(
+        [cxx, *flags, str(RUNTIME_DIR / "tk_instrument.cpp"), "-o", str(library)]
+        + ["-ldl", "-pthread"],
+        work_dir,
+    )
+    return library
+
+
+def build_variants(cxx: str, work_dir: Path) -> dict:
+    """
+    Build the benchmark binaries.
+
+    Returns:
+        Mapping of binary name to path
+    """
+    library = build_runtime(cxx, work_dir)
+    builds = {
+        "none": [],
+        "hooks": ["-finstrument-functions"],
+        "naive": ["-finstrument-functions", "-DTK_BENCH_NAIVE_HOOKS", "-pthread"],
+        "runtime": [
+            "-finstrument-functions",
+            str(library),
+            f"-Wl,-rpath,{library.parent}",
+        ],
+    }
+    binaries = {}
+    for name, flags in builds.items():
+        binary = work_dir / f"bench_{name}"
+        _run(
+            [cxx, "-O2", "-std=c++17", str(BENCH_SOURCE), *flags, "-o", str(binary)],
+            work_dir,
+        )
+        binaries[name] = binary
+    return binaries
+
+
+def run_benchmark(cxx: str, calls: int, repeats: int, sample: int) -> dict:
+    """
+    Build and time every variant.
+
+    Args:
+        cxx: C++ compiler driver
+        calls: Calls per timed loop
+        repeats: Timed loops per variant (median is reported)
+        sample: Sampling rate of the sampled runtime variant
+
+    Returns:
+        Dictionary with nanoseconds per call per variant
+    """
+    with tempfile.TemporaryDirectory() as tmp:
+        work_dir = Path(tmp)
+        binaries = build_variants(cxx, work_dir)
+        base_env = dict(
+            os.environ,
+            TOOLCHAINKIT_INSTRUMENT_OUTPUT=str(work_dir / "trace.%p.json"),
+            TOOLCHAINKIT_INSTRUMENT_SIGNAL="0",
+        )
+        variants = [
+            ("none", "none", {}),
+            ("empty hooks", "hooks", {}),
+            ("naive", "naive", {}),
+            ("runtime", "runtime", {}),
+            (
+                f"runtime, sample={sample}",
+                "runtime",
+                {"TOOLCHAINKIT_INSTRUMENT_SAMPLE": str(sample)},
+            ),
+            (
+                "runtime, excluded",
+                "runtime",
+                {"TOOLCHAINKIT_INSTRUMENT_EXCLUDE": "bench_leaf"},
+            ),
+        ]
+        results = []
+        for name, binary, env in variants:
+            output = subprocess.run(
+                [str(binaries[binary]), str(calls), str(repeats)],
+                env={**base_env, **env},
+                capture_output=True,
+                text=True,
+                check=True,
+            ).stdout
+            results.append({"variant": name, "ns_per_call": float(output.strip())})
+
+    baseline = results[0]["ns_per_call"]
+    for result in results:
+        result["overhead_ns"] = result["ns_per_call"] - baseline
+    return {"cxx": cxx, "calls": calls, "repeats": repeats, "variants": results}
+
+
+def main():
+    """Main entry point."""
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    parser.add_argument("--cxx", default="c++", help="C++ compiler (default: c++)")
+    parser.add_argument("--calls", type=int, default=10_000_000)
+    parser.add_argument("--repeats", type=int, default=5)
+    parser.add_argument("--sample", type=int, default=100)
+    parser.add_argument("--json", action="store_true", help="Print JSON results")
+    args = parser.parse_args()
+
+    try:
+        result = run_benchmark(args.cxx, args.calls, args.repeats, args.sample)
+    except (OSError, RuntimeError, subprocess.CalledProcessError) as e:
+        print(f"Error: {e}", file=sys.stderr)
+        sys.exit(1)
+
+    if args.json:
+        print(json.dumps(result, indent=2))
+        return
+
+    print(f"Instrumentation overhead ({result['cxx']}), {result['calls']:,} calls")
+    for variant in result["variants"]:
+        print(
+            f"  {variant['variant']:>22}: {variant['ns_per_call']:7.2f} ns/call  "
+            f"(+{variant['overhead_ns']:.2f} ns)"
+        )
+
+
+if __name__ == "__main__":
+    main()
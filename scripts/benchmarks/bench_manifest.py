@@ -0,0 +1,127 @@
+"""
+Integrity manifest benchmark.
+
+Creates a synthetic installation tree shaped like an LLVM toolchain (a few
+large binaries, many headers and small libraries), then times manifest
+creation, warm (stat-only) verification and deep verification.
+
+Usage:
+    python scripts/benchmarks/bench_manifest.py [--path DIR] [--size-mb N]
+                                                [--files N] [--json]
+
+Example:
+    python scripts/benchmarks/bench_manifest.py --size-mb 1024 --files 8000
+    python scripts/benchmarks/bench_manifest.py --path ~/.toolchainkit/toolchains/llvm-18
+"""
+
+import argparse
+import json
+import os
+import sys
+import tempfile
+import time
+from pathlib import Path
+
+sys.path.insert(0, str(Path(__file__).resolve().parents[2]))
+
+from toolchainkit.core.manifest import IntegrityManifest  # noqa: E402
+
+
+def create_tree(root: Path, size_mb: int, files: int) -> None:
+    """
+    Create a synthetic toolchain tree.
+
+    Half of the bytes go to eight large "binaries"; the rest is spread over
+    many small files in nested directories.
+
+    Args:
+        root: Directory to create
+        size_mb: Approximate total size in MiB
+        files: Approximate number of files
+    """
+    large = 8
+    large_size = size_mb * 1024 * 1024 // (2 * large)
+    small_size = max(1, size_mb * 1024 * 1024 // (2 * max(1, files - large)))
+    chunk = os.urandom(1024 * 1024)
+
+    (root / "bin").mkdir(parents=True)
+    for i in range(large):
+        with open(root / "bin" / f"tool{i}", "wb") as f:
+            remaining = large_size
+            while remaining > 0:
+                f.write(chunk[: min(remaining, len(chunk))])
+                remaining -= len(chunk)
+
+    for i in range(files - large):
+        directory = root / "include" / f"group{i % 64}"
+        directory.mkdir(parents=True, exist_ok=True)
+        offset = (
+            (i * 4099) % (len(chunk) - small_size) if small_size < len(chunk) else 0
+        )
+        (directory / f"header{i}.h").write_bytes(chunk[offset : offset + small_size])
+
+
+def run_benchmark(root: Path, repeats: int) -> dict:
+    """
+    Time manifest creation and verification of a tree.
+
+    Args:
+        root: Installation directory
+        repeats: Warm verifications (best is reported)
+
+    Returns:
+        Dictionary with timings
+    """
+    start = time.perf_counter()
+    manifest = IntegrityManifest.create(root)
+    manifest.save()
+    create_seconds = time.perf_counter() - start
+
+    warm = min(
+        IntegrityManifest.load(root).verify().seconds for _ in range(max(1, repeats))
+    )
+    deep = IntegrityManifest.load(root).verify(deep=True).seconds
+
+    return {
+        "path": str(root),
+        "files": len(manifest.entries),
+        "bytes": manifest.total_size,
+        "create_seconds": create_seconds,
+        "warm_verify_seconds": warm,
+        "deep_verify_seconds": deep,
+    }
+
+
+def main():
+    """Main entry point."""
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    parser.add_argument("--path", type=Path, help="Existing tree (default: synthetic)")
+    parser.add_argument("--size-mb", type=int, default=1024)
+    parser.add_argument("--files", type=int, default=8000)
+    parser.add_argument("--repeats", type=int, default=5)
+    parser.add_argument("--json", action="store_true", help="Print JSON results")
+    args = parser.parse_args()
+
+    if args.path:
+        result = run_benchmark(args.path, args.repeats)
+    else:
+        with tempfile.TemporaryDirectory() as tmp:
+            root = Path(tmp) / "toolchain"
+            create_tree(root, args.size_mb, args.files)
+            result = run_benchmark(root, args.repeats)
+
+    if args.json:
+        print(json.dumps(result, indent=2))
+        return
+
+    print(
+        f"Manifest: {result['files']} files, {result['bytes'] / 1024**2:.0f} MB "
+        f"({os.cpu_count()} CPUs)"
+    )
+    print(f"  create:      {result['create_seconds'] * 1000:8.1f} ms")
+    print(f"  warm verify: {result['warm_verify_seconds'] * 1000:8.1f} ms")
+    print(f"  deep verify: {result['deep_verify_seconds'] * 1000:8.1f} ms")
+
+
+if __name__ == "__main__":
+    main()
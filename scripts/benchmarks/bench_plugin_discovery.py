@@ -0,0 +1,151 @@
+"""
+Plugin discovery and loading benchmark.
+
+Creates a directory of generated compiler plugins that declare their
+capabilities, then times ``PluginManager.discover_and_load_all()`` in fresh
+interpreters: without the manifest index and loading every plugin (the old
+behaviour), with a warm index and eager loading, and with a warm index and
+lazy loading. Each fresh interpreter measures only the discovery and load
+call, not its own startup.
+
+Usage:
+    python scripts/benchmarks/bench_plugin_discovery.py [--plugins N] [--runs N] [--json]
+
+Example:
+    python scripts/benchmarks/bench_plugin_discovery.py --plugins 12 --runs 20
+"""
+
+import argparse
+import json
+import os
+import statistics
+import subprocess
+import sys
+import tempfile
+from pathlib import Path
+
+ROOT = Path(__file__).resolve().parents[2]
+
+MANIFEST = """\
+name: bench-{i}
+version: 1.0.0
+type: compiler
+description: Generated benchmark plugin {i}
+author: Benchmark
+entry_point: bench_plugin_{i}.BenchPlugin
+provides:
+  compilers: [bench-{i}]
+"""
+
+MODULE = """\
+import dataclasses
+import email.parser
+import xml.dom.minidom
+
+from toolchainkit.plugins import CompilerPlugin
+
+
+class BenchPlugin(CompilerPlugin):
+    def metadata(self):
+        return {{"name": "bench-{i}", "version": "1.0.0"}}
+
+    def initialize(self, context):
+        context.register_compiler("bench-{i}", {{"name": "bench-{i}"}})
+"""
+
+PROBE = """\
+import sys, time
+from pathlib import Path
+from toolchainkit.plugins.index import PluginIndex
+from toolchainkit.plugins.manager import PluginManager
+from toolchainkit.plugins.registry import PluginRegistry
+
+use_index, lazy = sys.argv[1] == "1", sys.argv[2] == "1"
+index = PluginIndex(Path(sys.argv[3]))
+if not use_index:
+    index.clear()
+start = time.perf_counter()
+manager = PluginManager(registry=PluginRegistry())
+manager.discoverer.index = index
+manager.discover_and_load_all(cache_base_dir=Path(sys.argv[4]), lazy=lazy)
+print(time.perf_counter() - start)
+"""
+
+MODES = {
+    "no index, eager": ("0", "0"),
+    "index, eager": ("1", "0"),
+    "index, lazy": ("1", "1"),
+}
+
+
+def setup(tmp: Path, count: int) -> dict:
+    """Create the plugins and an environment pointing discovery at them."""
+    plugins = tmp / "plugins"
+    for i in range(count):
+        plugin_dir = plugins / f"bench-{i}"
+        plugin_dir.mkdir(parents=True)
+        (plugin_dir / "plugin.yaml").write_text(MANIFEST.format(i=i))
+        (plugin_dir / f"bench_plugin_{i}.py").write_text(MODULE.format(i=i))
+    home = tmp / "home"
+    home.mkdir()
+    return dict(
+        os.environ,
+        HOME=str(home),
+        PYTHONPATH=str(ROOT),
+        TOOLCHAINKIT_PLUGIN_PATH=str(plugins),
+    )
+
+
+def run_benchmark(count: int, runs: int) -> dict:
+    """
+    Time discovery and loading in each mode.
+
+    Returns:
+        Dictionary of mode -> {"median": seconds, "min": seconds}
+    """
+    results = {}
+    with tempfile.TemporaryDirectory() as tmp:
+        tmp = Path(tmp)
+        env = setup(tmp, count)
+        index = str(tmp / "index.json")
+        cache = str(tmp / "cache")
+        for mode, (use_index, lazy) in MODES.items():
+            times = []
+            for _ in range(runs + 1):
+                result = subprocess.run(
+                    [sys.executable, "-c", PROBE, use_index, lazy, index, cache],
+                    env=env,
+                    capture_output=True,
+                    text=True,
+                    check=True,
+                )
+                times.append(float(result.stdout))
+            times = times[1:]  # First run writes the index
+            results[mode] = {"median": statistics.median(times), "min": min(times)}
+    return results
+
+
+def main():
+    """Main entry point."""
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    parser.add_argument("--plugins", type=int, default=12)
+    parser.add_argument("--runs", type=int, default=10)
+    parser.add_argument("--json", action="store_true", help="Print JSON results")
+    args = parser.parse_args()
+
+    results = run_benchmark(args.plugins, args.runs)
+
+    if args.json:
+        print(json.dumps(results, indent=2))
+        return
+
+    print(f"Plugin discovery + load, {args.plugins} plugins, {args.runs} runs")
+    for mode, stats in results.items():
+        print(
+            f"  {mode:<16} {stats['median'] * 1000:7.1f} ms median  "
+            f"{stats['min'] * 1000:7.1f} ms min"
+        )
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,137 @@
+"""
+Archive re-pack benchmark.
+
+Packs a synthetic toolchain tree as .tar.xz and compares re-materializing it
+from the downloads cache with extract_archive() (single-threaded LZMA) and
+from its seekable re-pack (parallel frame decoding). The one-off cost of
+repacking and reading a single file from the re-pack are timed as well.
+Frames use zstd when the zstandard package is installed, zlib otherwise.
+
+Usage:
+    python scripts/benchmarks/bench_repack.py [--files N] [--size-mb N]
+                                              [--workers N] [--json]
+
+Example:
+    python scripts/benchmarks/bench_repack.py --size-mb 500 --workers 8
+"""
+
+import argparse
+import json
+import os
+import random
+import shutil
+import sys
+import tarfile
+import tempfile
+import time
+from pathlib import Path
+
+sys.path.insert(0, str(Path(__file__).resolve().parents[2]))
+
+from toolchainkit.core.bundle import default_codec  # noqa: E402
+from toolchainkit.core.filesystem import extract_archive  # noqa: E402
+from toolchainkit.toolchain.repack import open_repacked, repack_archive  # noqa: E402
+
+ROOT = "bench-1.0.0"
+
+
+def build_archive(tmp: Path, files: int, size_mb: int) -> Path:
+    """Create a tree of compressible files and pack it as tar.xz."""
+    rng = random.Random(1)
+    words = [os.urandom(8).hex().encode() for _ in range(512)]
+    block = b" ".join(rng.choice(words) for _ in range(64 * 1024))
+    big = max(1, files // 400)
+    big_size = size_mb * 1024 * 1024 * 3 // 4 // big
+    small_size = size_mb * 1024 * 1024 // 4 // max(1, files - big)
+
+    source = tmp / "source" / ROOT
+    for i in range(files):
+        path = source / f"dir{i % 40}" / f"file{i}"
+        path.parent.mkdir(parents=True, exist_ok=True)
+        size = big_size if i < big else small_size
+        data = bytearray((block * (size // len(block) + 1))[:size])
+        data[:16] = i.to_bytes(16, "little")
+        path.write_bytes(data)
+
+    archive = tmp / f"{ROOT}.tar.xz"
+    with tarfile.open(archive, "w:xz", preset=1) as tar:
+        tar.add(source, arcname=ROOT)
+    shutil.rmtree(tmp / "source")
+    return archive
+
+
+def run_benchmark(files: int, size_mb: int, workers: int) -> dict:
+    """
+    Time extraction from the archive and from its re-pack.
+
+    Returns:
+        Dictionary of case name -> {"bytes", "seconds"}
+    """
+    results = {}
+    with tempfile.TemporaryDirectory() as tmp:
+        tmp = Path(tmp)
+        archive = build_archive(tmp, files, size_mb)
+        archive.read_bytes()  # Warm the page cache
+
+        start = time.perf_counter()
+        extract_archive(archive, tmp / "xz")
+        results["extract .tar.xz"] = {
+            "bytes": archive.stat().st_size,
+            "seconds": time.perf_counter() - start,
+        }
+        shutil.rmtree(tmp / "xz")
+
+        start = time.perf_counter()
+        bundle = repack_archive(archive, "0" * 64, workers=workers)
+        results["repack (once)"] = {
+            "bytes": bundle.stat().st_size,
+            "seconds": time.perf_counter() - start,
+        }
+        bundle.read_bytes()
+
+        repacked = open_repacked(archive, "0" * 64)
+        start = time.perf_counter()
+        repacked.extract(tmp / "repacked", workers=workers)
+        results["extract re-pack"] = {
+            "bytes": bundle.stat().st_size,
+            "seconds": time.perf_counter() - start,
+        }
+
+        member = f"{ROOT}/dir1/file1"
+        start = time.perf_counter()
+        data = repacked.read(member)
+        results["read one file"] = {
+            "bytes": len(data),
+            "seconds": time.perf_counter() - start,
+        }
+    return results
+
+
+def main():
+    """Main entry point."""
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    parser.add_argument("--files", type=int, default=2000)
+    parser.add_argument("--size-mb", type=int, default=200)
+    parser.add_argument("--workers", type=int, default=os.cpu_count() or 1)
+    parser.add_argument("--json", action="store_true", help="Print JSON results")
+    args = parser.parse_args()
+
+    results = run_benchmark(args.files, args.size_mb, args.workers)
+
+    if args.json:
+        print(json.dumps(results, indent=2))
+        return
+
+    print(
+        f"Re-materializing {args.files} files, {args.size_mb} MB "
+        f"({default_codec()} frames, {args.workers} workers)"
+    )
+    for name, result in results.items():
+        print(
+            f"  {name:<16} {result['bytes'] / 1024**2:7.1f} MB  "
+            f"{result['seconds']:6.2f} s"
+        )
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,193 @@
+"""
+Cold build tool bootstrap benchmark.
+
+Serves synthetic CMake, Ninja and sccache archives from a local mirror
+(a threaded HTTP server with optional per-request latency and per-connection
+bandwidth limit) and times a cold install of all three with
+``ToolInstaller`` run serially (one worker) and concurrently.
+
+Usage:
+    python scripts/benchmarks/bench_tool_install.py [--size-mb N] [--latency-ms N]
+                                                    [--mbps N] [--workers N] [--json]
+
+Example:
+    python scripts/benchmarks/bench_tool_install.py --size-mb 16 --mbps 100
+"""
+
+import argparse
+import io
+import json
+import os
+import sys
+import tarfile
+import tempfile
+import threading
+import time
+import zipfile
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+from pathlib import Path
+from unittest import mock
+
+sys.path.insert(0, str(Path(__file__).resolve().parents[2]))
+
+from toolchainkit.core.platform import PlatformInfo  # noqa: E402
+from toolchainkit.packages.tool_downloader import (  # noqa: E402
+    CMakeDownloader,
+    NinjaDownloader,
+    SccacheDownloader,
+)
+from toolchainkit.packages.tool_installer import ToolInstaller  # noqa: E402
+
+PLATFORM = PlatformInfo(
+    os="linux", arch="x64", os_version="6.0", distribution="ubuntu", abi="glibc-2.35"
+)
+TOOLS = ["cmake", "ninja", "sccache"]
+
+
+def _tar(members: dict) -> bytes:
+    """Build a tar.gz from {name: data}."""
+    buffer = io.BytesIO()
+    with tarfile.open(fileobj=buffer, mode="w:gz", compresslevel=1) as tar:
+        for name, data in members.items():
+            info = tarfile.TarInfo(name)
+            info.size = len(data)
+            info.mode = 0o755
+            tar.addfile(info, io.BytesIO(data))
+    return buffer.getvalue()
+
+
+def _zip(members: dict) -> bytes:
+    """Build a zip from {name: data}."""
+    buffer = io.BytesIO()
+    with zipfile.ZipFile(buffer, "w", zipfile.ZIP_STORED) as archive:
+        for name, data in members.items():
+            archive.writestr(name, data)
+    return buffer.getvalue()
+
+
+def build_archives(size_mb: int) -> dict:
+    """Synthetic release archives of roughly ``size_mb`` each, by file name."""
+    payload = os.urandom(size_mb * 1024 * 1024)
+    return {
+        "cmake.tar.gz": _tar({"cmake-3.28.1-linux-x86_64/bin/cmake": payload}),
+        "ninja.zip": _zip({"ninja": payload}),
+        "sccache.tar.gz": _tar({"sccache-v0.7.4/sccache": payload}),
+    }
+
+
+def start_mirror(archives: dict, latency: float, bytes_per_second: float):
+    """Start the local mirror; returns (server, base_url)."""
+
+    class Handler(BaseHTTPRequestHandler):
+        protocol_version = "HTTP/1.1"
+
+        def do_GET(self):
+            data = archives.get(self.path.lstrip("/"))
+            if data is None:
+                self.send_error(404)
+                return
+            time.sleep(latency)
+            self.send_response(200)
+            self.send_header("Content-Length", str(len(data)))
+            self.end_headers()
+            step = 256 * 1024
+            for offset in range(0, len(data), step):
+                self.wfile.write(data[offset : offset + step])
+                if bytes_per_second:
+                    time.sleep(step / bytes_per_second)
+
+        def log_message(self, *args):
+            pass
+
+    server = ThreadingHTTPServer(("127.0.0.1", 0), Handler)
+    server.daemon_threads = True
+    threading.Thread(target=server.serve_forever, daemon=True).start()
+    return server, f"http://127.0.0.1:{server.server_address[1]}"
+
+
+def run_benchmark(
+    size_mb: int, latency_ms: float, mbps: float, workers: int, repeats: int
+) -> dict:
+    """
+    Time cold installs from the local mirror.
+
+    Args:
+        size_mb: Payload size of each archive in MiB
+        latency_ms: Delay before each response
+        mbps: Per-connection bandwidth limit in MB/s (0 = unlimited)
+        workers: Concurrent installs for the concurrent case
+        repeats: Runs per case (best is reported)
+
+    Returns:
+        Dictionary of case name -> {"seconds"}
+    """
+    archives = build_archives(size_mb)
+    server, base = start_mirror(archives, latency_ms / 1000, mbps * 1024 * 1024)
+    urls = {
+        CMakeDownloader: f"{base}/cmake.tar.gz",
+        NinjaDownloader: f"{base}/ninja.zip",
+        SccacheDownloader: f"{base}/sccache.tar.gz",
+    }
+    patches = [
+        mock.patch.object(cls, "_get_download_url", lambda self, url=url: url)
+        for cls, url in urls.items()
+    ]
+    for patch in patches:
+        patch.start()
+
+    results = {}
+    try:
+        for name, max_workers in (("serial", 1), (f"concurrent ({workers})", workers)):
+            samples = []
+            for _ in range(repeats):
+                with tempfile.TemporaryDirectory() as tmp:
+                    installer = ToolInstaller(
+                        Path(tmp), PLATFORM, max_workers=max_workers
+                    )
+                    start = time.perf_counter()
+                    installed = installer.install(TOOLS)
+                    samples.append(time.perf_counter() - start)
+                failed = [r.name for r in installed.values() if not r.success]
+                if failed:
+                    raise RuntimeError(f"Install failed: {', '.join(failed)}")
+            results[name] = {"seconds": min(samples)}
+    finally:
+        for patch in patches:
+            patch.stop()
+        server.shutdown()
+    return results
+
+
+def main():
+    """Main entry point."""
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    parser.add_argument("--size-mb", type=int, default=16)
+    parser.add_argument("--latency-ms", type=float, default=50)
+    parser.add_argument("--mbps", type=float, default=50)
+    parser.add_argument("--workers", type=int, default=4)
+    parser.add_argument("--repeats", type=int, default=3)
+    parser.add_argument("--json", action="store_true", help="Print JSON results")
+    args = parser.parse_args()
+
+    results = run_benchmark(
+        args.size_mb, args.latency_ms, args.mbps, args.workers, args.repeats
+    )
+
+    if args.json:
+        print(json.dumps(results, indent=2))
+        return
+
+    print(
+        f"Cold install of {', '.join(TOOLS)}: {args.size_mb} MB each, "
+        f"{args.latency_ms:.0f} ms latency, {args.mbps:.0f} MB/s per connection"
+    )
+    serial = results["serial"]["seconds"]
+    for name, result in results.items():
+        print(
+            f"  {name:<16} {result['seconds']:6.2f} s  "
+            f"({serial / result['seconds']:.2f}x)"
+        )
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,89 @@
+"""
+Phase tracing overhead benchmark.
+
+Times an empty ``tracing.span()`` block and a call to a ``@tracing.traced``
+function with tracing off and on, against the same code without
+instrumentation. With tracing off the instrumentation must stay well under
+a microsecond, since spans sit on download, hashing and lock paths.
+
+Usage:
+    python scripts/benchmarks/bench_tracing.py [--iterations N] [--json]
+
+Example:
+    python scripts/benchmarks/bench_tracing.py --iterations 200000
+"""
+
+import argparse
+import json
+import sys
+import time
+from pathlib import Path
+
+sys.path.insert(0, str(Path(__file__).resolve().parents[2]))
+
+from toolchainkit.core import tracing  # noqa: E402
+
+
+def plain():
+    return None
+
+
+@tracing.traced("bench")
+def decorated():
+    return None
+
+
+def _time(func, iterations: int) -> float:
+    """Nanoseconds per call of func()."""
+    start = time.perf_counter_ns()
+    for _ in range(iterations):
+        func()
+    return (time.perf_counter_ns() - start) / iterations
+
+
+def _span():
+    with tracing.span("bench"):
+        pass
+
+
+def run_benchmark(iterations: int) -> dict:
+    """
+    Time instrumented calls with tracing off and on.
+
+    Returns:
+        Dictionary of case -> nanoseconds per call
+    """
+    results = {
+        "plain call": _time(plain, iterations),
+        "span, off": _time(_span, iterations),
+        "traced call, off": _time(decorated, iterations),
+    }
+    tracing.enable()
+    try:
+        results["span, on"] = _time(_span, iterations)
+        results["traced call, on"] = _time(decorated, iterations)
+    finally:
+        tracing.disable()
+    return results
+
+
+def main():
+    """Main entry point."""
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    parser.add_argument("--iterations", type=int, default=100000)
+    parser.add_argument("--json", action="store_true", help="Print JSON results")
+    args = parser.parse_args()
+
+    results = run_benchmark(args.iterations)
+
+    if args.json:
+        print(json.dumps(results, indent=2))
+        return
+
+    print(f"Tracing overhead, {args.iterations} iterations")
+    for case, ns in results.items():
+        print(f"  {case:<18} {ns:8.0f} ns/call")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,102 @@
+// Per-call overhead of -finstrument-functions hooks.
+//
+// Times a loop calling a small function that is never inlined and prints
+// nanoseconds per call. bench_instrument.py builds this file once without
+// instrumentation and several times with it: against the C library's empty
+// hooks, the ToolchainKit runtime (full recording, sampling, exclusion) and
+// TK_BENCH_NAIVE_HOOKS, a mutex-and-vector recorder for comparison.
+//
+// Usage: bench_instrument [CALLS] [REPEATS]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#ifdef TK_BENCH_NAIVE_HOOKS
+#include <mutex>
+
+namespace {
+
+struct NaiveEvent {
+    void* fn;
+    long long ns;
+    bool exit;
+};
+
+__attribute__((no_instrument_function)) std::mutex& naive_mutex() {
+    static std::mutex mutex;
+    return mutex;
+}
+
+__attribute__((no_instrument_function)) std::vector<NaiveEvent>& naive_events() {
+    static auto* events = new std::vector<NaiveEvent>();  // Hooks run after exit()
+    return *events;
+}
+
+// The standard library code below is instrumented too: guard against
+// recursing into the hooks.
+thread_local bool naive_busy = false;
+
+__attribute__((no_instrument_function)) void naive_record(void* fn, bool exit) {
+    if (naive_busy) {
+        return;
+    }
+    naive_busy = true;
+    long long ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                       std::chrono::steady_clock::now().time_since_epoch())
+                       .count();
+    {
+        std::lock_guard<std::mutex> lock(naive_mutex());
+        std::vector<NaiveEvent>& events = naive_events();
+        if (events.size() == 1 << 20) {
+            events.clear();  // Stands in for writing the events out
+        }
+        events.push_back({fn, ns, exit});
+    }
+    naive_busy = false;
+}
+
+}  // namespace
+
+extern "C" __attribute__((no_instrument_function)) void __cyg_profile_func_enter(void* fn,
+                                                                                 void*) {
+    naive_record(fn, false);
+}
+
+extern "C" __attribute__((no_instrument_function)) void __cyg_profile_func_exit(void* fn,
+                                                                                void*) {
+    naive_record(fn, true);
+}
+#endif
+
+__attribute__((noinline)) int bench_leaf(int value) {
+    __asm__ __volatile__("");
+    return value * 3 + 1;
+}
+
+__attribute__((noinline)) double bench_loop(long calls) {
+    auto start = std::chrono::steady_clock::now();
+    int sink = 0;
+    for (long i = 0; i < calls; ++i) {
+        sink += bench_leaf(int(i));
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    __asm__ __volatile__("" : : "r"(sink));
+    return std::chrono::duration<double, std::nano>(elapsed).count() / double(calls);
+}
+
+int main(int argc, char** argv) {
+    long calls = argc > 1 ? atol(argv[1]) : 10000000;
+    int repeats = argc > 2 ? atoi(argv[2]) : 5;
+
+    bench_loop(calls / 10);  // Warm up: page in the ring buffer, resolve symbols
+    std::vector<double> samples;
+    for (int i = 0; i < repeats; ++i) {
+        samples.push_back(bench_loop(calls));
+    }
+    std::sort(samples.begin(), samples.end());
+    printf("%.3f\n", samples[samples.size() / 2]);
+    return 0;
+}
@@ -0,0 +1,282 @@
+"""
+Compare benchmark results against a baseline.
+
+Rounds of one run are not independent: they share the machine's state
+for the whole run (frequency, cache and page-cache contents, neighbours),
+so a rank test over them finds "significant" differences between two runs
+of the same code. Compare several runs of each side instead, interleaved
+(base, current, base, current, ...) so drift affects both alike. Each run
+then contributes one sample, its median.
+
+A benchmark is reported as a regression only if it is materially and
+consistently slower:
+
+- the median grew by more than the threshold (default 5%), and
+- the effect size A, the probability that a current sample is slower than
+  a baseline sample (0.5: no difference), is at least the minimum effect
+  (default 0.8), and
+- with a single run per side, a two-sided Mann-Whitney U test on the
+  rounds also gives p < alpha (default 0.01). A handful of run medians
+  cannot reach a small p-value, so with several runs the effect size
+  decides.
+
+The rank statistics make no normality assumption, so a few outliers (a GC
+pause, a busy neighbour) cannot cause or hide a regression on their own.
+
+Usage:
+    python -m tests.benchmarks.compare BASELINE... CURRENT... [--alpha A]
+        [--threshold T] [--min-effect E] [--json]
+
+    Give the same number of results files for each side, baselines first.
+
+Example:
+    for run in 1 2 3; do
+        (cd ../base && pytest tests/benchmarks --benchmark -p no:xdist --benchmark-json "$OLDPWD/base-$run.json")
+        pytest tests/benchmarks --benchmark -p no:xdist --benchmark-json current-$run.json
+    done
+    python -m tests.benchmarks.compare base-{1,2,3}.json current-{1,2,3}.json
+
+Exits with 1 if any benchmark regressed. Baselines from another machine
+are only comparable in direction; compare runs made on the same machine.
+"""
+
+import argparse
+import json
+import math
+import statistics
+import sys
+from dataclasses import asdict, dataclass
+from typing import Dict, List, Optional, Sequence, Tuple
+
+from tests.benchmarks.harness import BenchmarkResult, format_time, load_results
+
+DEFAULT_ALPHA = 0.01
+DEFAULT_THRESHOLD = 0.05
+DEFAULT_MIN_EFFECT = 0.8
+
+
+@dataclass
+class Comparison:
+    """Outcome for one benchmark."""
+
+    name: str
+    status: str  # regression, improvement, unchanged, new, missing
+    baseline_median: Optional[float] = None
+    current_median: Optional[float] = None
+    change: Optional[float] = None  # Relative change of the median
+    p_value: Optional[float] = None
+    effect: Optional[float] = None  # P(current sample > baseline sample)
+    runs: int = 1  # Runs per side; with more than one, samples are run medians
+
+
+def mann_whitney_u(a: Sequence[float], b: Sequence[float]) -> Tuple[float, float]:
+    """
+    Two-sided Mann-Whitney U test (normal approximation, tie-corrected).
+
+    Args:
+        a: First sample
+        b: Second sample
+
+    Returns:
+        (U statistic of a, p-value)
+    """
+    n1, n2 = len(a), len(b)
+    if n1 == 0 or n2 == 0:
+        return 0.0, 1.0
+
+    values = sorted([(v, 0) for v in a] + [(v, 1) for v in b])
+    ranks = [0.0] * len(values)
+    tie_term = 0.0
+    i = 0
+    while i < len(values):
+        j = i
+        while j + 1 < len(values) and values[j + 1][0] == values[i][0]:
+            j += 1
+        rank = (i + j) / 2 + 1
+        for k in range(i, j + 1):
+            ranks[k] = rank
+        ties = j - i + 1
+        tie_term += ties**3 - ties
+        i = j + 1
+
+    rank_sum = sum(r for r, (_, sample) in zip(ranks, values) if sample == 0)
+    u = rank_sum - n1 * (n1 + 1) / 2
+    n = n1 + n2
+    variance = n1 * n2 / 12 * ((n + 1) - tie_term / (n * (n - 1)))
+    if variance <= 0:
+        return u, 1.0
+    # Continuity correction
+    z = (abs(u - n1 * n2 / 2) - 0.5) / math.sqrt(variance)
+    p = math.erfc(max(z, 0.0) / math.sqrt(2))
+    return u, min(p, 1.0)
+
+
+def _samples(runs: Sequence[BenchmarkResult], per_run: bool) -> List[float]:
+    """Run medians, or the rounds of all runs."""
+    if per_run:
+        return [run.median for run in runs]
+    return [sample for run in runs for sample in run.samples]
+
+
+def compare_one(
+    baseline: Sequence[BenchmarkResult],
+    current: Sequence[BenchmarkResult],
+    alpha: float = DEFAULT_ALPHA,
+    threshold: float = DEFAULT_THRESHOLD,
+    min_effect: float = DEFAULT_MIN_EFFECT,
+) -> Comparison:
+    """
+    Compare one benchmark.
+
+    Args:
+        baseline: Results of the benchmark in each baseline run
+        current: Results of the benchmark in each current run
+        alpha: Significance level, only used with a single run per side
+        threshold: Minimum relative change of the median
+        min_effect: Minimum probability that a sample of the slower side is
+            slower than one of the other
+
+    Returns:
+        The comparison; with several runs per side, samples are run medians
+    """
+    per_run = len(baseline) > 1 and len(current) > 1
+    a, b = _samples(baseline, per_run), _samples(current, per_run)
+    u, p = mann_whitney_u(a, b)
+    effect = 1 - u / (len(a) * len(b))
+    baseline_median, current_median = statistics.median(a), statistics.median(b)
+    change = current_median / baseline_median - 1 if baseline_median else 0.0
+    significant = per_run or p < alpha
+    status = "unchanged"
+    if significant and change > threshold and effect >= min_effect:
+        status = "regression"
+    elif significant and change < -threshold and effect <= 1 - min_effect:
+        status = "improvement"
+    return Comparison(
+        name=current[0].name,
+        status=status,
+        baseline_median=baseline_median,
+        current_median=current_median,
+        change=change,
+        p_value=p,
+        effect=effect,
+        runs=min(len(baseline), len(current)),
+    )
+
+
+def compare(
+    baseline: Dict[str, List[BenchmarkResult]],
+    current: Dict[str, List[BenchmarkResult]],
+    alpha: float = DEFAULT_ALPHA,
+    threshold: float = DEFAULT_THRESHOLD,
+    min_effect: float = DEFAULT_MIN_EFFECT,
+) -> List[Comparison]:
+    """
+    Compare every benchmark of two sets of runs (see load_runs()).
+
+    Returns:
+        One Comparison per benchmark name on either side, sorted by name
+    """
+    comparisons = []
+    for name in sorted(set(baseline) | set(current)):
+        if name not in baseline:
+            median = statistics.median(_samples(current[name], per_run=False))
+            comparisons.append(Comparison(name, "new", current_median=median))
+        elif name not in current:
+            median = statistics.median(_samples(baseline[name], per_run=False))
+            comparisons.append(Comparison(name, "missing", baseline_median=median))
+        else:
+            comparisons.append(
+                compare_one(baseline[name], current[name], alpha, threshold, min_effect)
+            )
+    return comparisons
+
+
+def load_runs(paths: Sequence[str]) -> Dict[str, List[BenchmarkResult]]:
+    """Read results files of several runs; maps names to one result per run."""
+    runs: Dict[str, List[BenchmarkResult]] = {}
+    for path in paths:
+        for name, result in load_results(path).items():
+            runs.setdefault(name, []).append(result)
+    return runs
+
+
+def format_table(comparisons: List[Comparison]) -> str:
+    """Format comparisons as a text table."""
+    width = max([len(c.name) for c in comparisons] + [9])
+    header = (
+        f"{'Benchmark':<{width}}  {'Baseline':>10}  {'Current':>10}  "
+        f"{'Change':>8}  {'p':>7}  {'A':>5}  Status"
+    )
+    lines = [header]
+    for c in comparisons:
+        baseline = format_time(c.baseline_median) if c.baseline_median else "-"
+        current = format_time(c.current_median) if c.current_median else "-"
+        change = f"{c.change:+.1%}" if c.change is not None else "-"
+        p = f"{c.p_value:.4f}" if c.p_value is not None else "-"
+        effect = f"{c.effect:.2f}" if c.effect is not None else "-"
+        lines.append(
+            f"{c.name:<{width}}  {baseline:>10}  {current:>10}  "
+            f"{change:>8}  {p:>7}  {effect:>5}  {c.status}"
+        )
+    return "\n".join(lines)
+
+
+def main(argv: Optional[List[str]] = None) -> int:
+    """Main entry point."""
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    parser.add_argument(
+        "results",
+        nargs="+",
+        metavar="RESULTS",
+        help="Baseline results JSON files, then as many current ones",
+    )
+    parser.add_argument(
+        "--alpha",
+        type=float,
+        default=DEFAULT_ALPHA,
+        help="Significance level with a single run per side (default: 0.01)",
+    )
+    parser.add_argument(
+        "--threshold",
+        type=float,
+        default=DEFAULT_THRESHOLD,
+        help="Minimum relative slowdown of the median (default: 0.05)",
+    )
+    parser.add_argument(
+        "--min-effect",
+        type=float,
+        default=DEFAULT_MIN_EFFECT,
+        help="Minimum probability that a current sample is slower (default: 0.8)",
+    )
+    parser.add_argument("--json", action="store_true", help="Print JSON results")
+    args = parser.parse_args(argv)
+    if len(args.results) % 2:
+        parser.error("give as many current results files as baseline ones")
+    half = len(args.results) // 2
+
+    try:
+        comparisons = compare(
+            load_runs(args.results[:half]),
+            load_runs(args.results[half:]),
+            args.alpha,
+            args.threshold,
+            args.min_effect,
+        )
+    except (OSError, ValueError, KeyError) as e:
+        print(f"Error: {e}", file=sys.stderr)
+        return 2
+
+    if args.json:
+        print(json.dumps([asdict(c) for c in comparisons], indent=2))
+    else:
+        print(format_table(comparisons))
+
+    regressions = [c.name for c in comparisons if c.status == "regression"]
+    if regressions:
+        print(f"\n{len(regressions)} regression(s): {', '.join(regressions)}")
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
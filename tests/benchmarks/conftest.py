@@ -0,0 +1,75 @@
+"""
+Fixtures and reporting for the benchmark suite.
+
+Benchmarks only run with --benchmark. Results are printed as a table at the
+end of the session and written to --benchmark-json PATH if given. Run the
+suite in one process (-p no:xdist or -n 0): results collected in xdist
+workers are not reported.
+"""
+
+from pathlib import Path
+
+import pytest
+
+from tests.benchmarks.harness import (
+    DEFAULT_ROUNDS,
+    BenchmarkResult,
+    format_time,
+    measure,
+    save_results,
+)
+
+_results = []
+
+
+@pytest.fixture
+def bench(request):
+    """
+    Time a callable and record the result under the test's name.
+
+    Usage:
+        def test_thing(bench):
+            bench(thing, group="core", size=10)
+
+    Keyword arguments other than setup, rounds, warmup and group are stored
+    as benchmark parameters.
+    """
+
+    def run(func, setup=None, rounds=None, warmup=1, group=None, **params):
+        rounds = request.config.getoption("--benchmark-rounds") or rounds
+        result = BenchmarkResult(
+            name=request.node.name,
+            group=group or request.node.module.__name__.rsplit("_", 1)[-1],
+            samples=measure(
+                func, setup=setup, rounds=rounds or DEFAULT_ROUNDS, warmup=warmup
+            ),
+            params=params,
+        )
+        _results.append(result)
+        return result
+
+    return run
+
+
+def pytest_terminal_summary(terminalreporter, config):
+    """Print the results table."""
+    if not _results:
+        return
+    terminalreporter.section("benchmarks")
+    width = max(len(r.name) for r in _results)
+    terminalreporter.write_line(
+        f"{'Benchmark':<{width}}  {'Median':>10}  {'Min':>10}  {'Stdev':>10}  Rounds"
+    )
+    for result in sorted(_results, key=lambda r: (r.group, r.name)):
+        terminalreporter.write_line(
+            f"{result.name:<{width}}  {format_time(result.median):>10}  "
+            f"{format_time(min(result.samples)):>10}  "
+            f"{format_time(result.stdev):>10}  {len(result.samples):>6}"
+        )
+
+
+def pytest_sessionfinish(session):
+    """Write --benchmark-json."""
+    path = session.config.getoption("--benchmark-json")
+    if path and _results:
+        save_results(Path(path), _results)
@@ -0,0 +1,188 @@
+"""
+Timing harness and result files for the benchmark suite.
+
+A benchmark is a callable timed over several rounds. Calls that take less
+than MIN_SAMPLE_TIME are repeated inside a round so timer resolution and
+loop overhead do not dominate; every sample is stored as seconds per call.
+The garbage collector is disabled while a round runs.
+
+Results files are JSON:
+
+    {
+      "version": 1,
+      "created": "2026-01-01T12:00:00",
+      "machine": {"platform": "...", "python": "...", "cpu_count": 8},
+      "benchmarks": {
+        "test_compose[minimal]": {
+          "group": "layers",
+          "samples": [0.0012, ...],
+          "median": 0.0012, "mean": ..., "stdev": ..., "min": ...,
+          "params": {"layers": 3}
+        }
+      }
+    }
+
+Only "samples" is needed to compare two files (compare.py); the other
+statistics are for reading the file.
+"""
+
+import functools
+import gc
+import json
+import os
+import platform
+import statistics
+import sys
+import time
+from dataclasses import dataclass, field
+from datetime import datetime
+from pathlib import Path
+from typing import Any, Callable, Dict, List, Optional
+
+RESULTS_VERSION = 1
+
+# Rounds shorter than this repeat the call
+MIN_SAMPLE_TIME = 0.005
+
+DEFAULT_ROUNDS = 15
+
+
+@dataclass
+class BenchmarkResult:
+    """Samples of one benchmark, in seconds per call."""
+
+    name: str
+    group: str
+    samples: List[float]
+    params: Dict[str, Any] = field(default_factory=dict)
+
+    @property
+    def median(self) -> float:
+        return statistics.median(self.samples)
+
+    @property
+    def mean(self) -> float:
+        return statistics.fmean(self.samples)
+
+    @property
+    def stdev(self) -> float:
+        return statistics.stdev(self.samples) if len(self.samples) > 1 else 0.0
+
+    def to_dict(self) -> Dict[str, Any]:
+        return {
+            "group": self.group,
+            "samples": self.samples,
+            "median": self.median,
+            "mean": self.mean,
+            "stdev": self.stdev,
+            "min": min(self.samples),
+            "params": self.params,
+        }
+
+    @classmethod
+    def from_dict(cls, name: str, data: Dict[str, Any]) -> "BenchmarkResult":
+        return cls(
+            name=name,
+            group=data.get("group", ""),
+            samples=[float(s) for s in data["samples"]],
+            params=data.get("params", {}),
+        )
+
+
+def _run_round(func: Callable[[], Any], loops: int) -> float:
+    gc_was_enabled = gc.isenabled()
+    gc.disable()
+    try:
+        start = time.perf_counter()
+        for _ in range(loops):
+            func()
+        return (time.perf_counter() - start) / loops
+    finally:
+        if gc_was_enabled:
+            gc.enable()
+
+
+def measure(
+    func: Callable[..., Any],
+    setup: Optional[Callable[[], Any]] = None,
+    rounds: int = DEFAULT_ROUNDS,
+    warmup: int = 1,
+) -> List[float]:
+    """
+    Time a callable.
+
+    Args:
+        func: Function to time; called with setup()'s result if setup is given
+        setup: Called before every call, untimed (e.g. to empty a destination
+            directory); calls with a setup are never repeated within a round
+        rounds: Number of samples
+        warmup: Untimed calls before the first round
+
+    Returns:
+        Seconds per call, one sample per round
+    """
+    if setup is not None:
+        samples = []
+        for i in range(warmup + rounds):
+            arg = setup()
+            sample = _run_round(functools.partial(func, arg), 1)
+            if i >= warmup:
+                samples.append(sample)
+        return samples
+
+    for _ in range(warmup):
+        func()
+    loops = 1
+    while True:
+        sample = _run_round(func, loops)
+        if sample * loops >= MIN_SAMPLE_TIME or loops >= 1 << 20:
+            break
+        loops = max(loops * 2, int(MIN_SAMPLE_TIME / max(sample, 1e-9)) + 1)
+    return [sample] + [_run_round(func, loops) for _ in range(rounds - 1)]
+
+
+def machine_info() -> Dict[str, Any]:
+    """Description of the machine results were measured on."""
+    return {
+        "platform": platform.platform(),
+        "machine": platform.machine(),
+        "python": sys.version.split()[0],
+        "cpu_count": os.cpu_count(),
+    }
+
+
+def save_results(path: Path, results: List[BenchmarkResult]) -> None:
+    """Write benchmark results as JSON."""
+    data = {
+        "version": RESULTS_VERSION,
+        "created": datetime.now().isoformat(timespec="seconds"),
+        "machine": machine_info(),
+        "benchmarks": {r.name: r.to_dict() for r in results},
+    }
+    path = Path(path)
+    path.parent.mkdir(parents=True, exist_ok=True)
+    path.write_text(json.dumps(data, indent=2, sort_keys=True) + "\n")
+
+
+def load_results(path: Path) -> Dict[str, BenchmarkResult]:
+    """
+    Read a results file.
+
+    Raises:
+        ValueError: If the file is not a results file of this version
+    """
+    data = json.loads(Path(path).read_text())
+    if data.get("version") != RESULTS_VERSION:
+        raise ValueError(f"{path}: unsupported results version {data.get('version')}")
+    return {
+        name: BenchmarkResult.from_dict(name, entry)
+        for name, entry in data["benchmarks"].items()
+    }
+
+
+def format_time(seconds: float) -> str:
+    """Human-readable duration (ns, µs, ms or s)."""
+    for unit, scale in (("s", 1.0), ("ms", 1e-3), ("µs", 1e-6)):
+        if seconds >= scale:
+            return f"{seconds / scale:.2f} {unit}"
+    return f"{seconds / 1e-9:.0f} ns"
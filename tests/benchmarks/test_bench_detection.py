@@ -0,0 +1,57 @@
+"""
+Benchmarks for system toolchain detection.
+
+PATH is replaced with a directory of stub compilers that answer --version
+and -dumpmachine like clang and GCC, so the PATH search cost (one process
+per query) is measured without real compilers. Standard locations and
+package manager directories of the machine are still searched.
+"""
+
+import os
+import sys
+
+import pytest
+
+from toolchainkit.core.platform import detect_platform
+from toolchainkit.toolchain.system_detector import SystemToolchainDetector
+
+pytestmark = [
+    pytest.mark.benchmark,
+    pytest.mark.skipif(sys.platform == "win32", reason="stub compilers are sh"),
+]
+
+STUBS = {
+    "clang++": "clang version 18.1.8\nTarget: x86_64-unknown-linux-gnu",
+    "clang": "clang version 18.1.8\nTarget: x86_64-unknown-linux-gnu",
+    "g++": "g++ (GCC) 13.2.0",
+    "gcc": "gcc (GCC) 13.2.0",
+}
+
+STUB = """#!/bin/sh
+case "$1" in
+  -dumpmachine) echo x86_64-linux-gnu ;;
+  *) printf '%s\\n' "{version}" ;;
+esac
+"""
+
+
+@pytest.fixture
+def stub_path(tmp_path, monkeypatch):
+    """PATH containing only stub compilers."""
+    bin_dir = tmp_path / "bin"
+    bin_dir.mkdir()
+    for name, version in STUBS.items():
+        stub = bin_dir / name
+        stub.write_text(STUB.format(version=version))
+        stub.chmod(0o755)
+    monkeypatch.setenv("PATH", str(bin_dir) + os.pathsep + "/bin")
+    return bin_dir
+
+
+def test_detect_all(bench, stub_path):
+    """Detect every system toolchain."""
+    detector = SystemToolchainDetector(detect_platform())
+    found = detector.detect_all()
+    assert {tc.type for tc in found} >= {"llvm", "gcc"}
+
+    bench(detector.detect_all, rounds=10, compilers=len(STUBS))
@@ -0,0 +1,92 @@
+"""
+Benchmarks for download_file against a local HTTP server.
+
+The server can throttle its sending rate to emulate a network link. The
+unthrottled case measures the client's own per-byte cost (chunk handling,
+hashing, progress reporting, writing); the throttled case shows whether
+the client keeps up with the link.
+"""
+
+import hashlib
+import threading
+import time
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+
+import pytest
+
+from toolchainkit.core import download
+from toolchainkit.core.download import download_file, set_mirrors
+
+pytestmark = pytest.mark.benchmark
+
+SIZE = 8 * 1024 * 1024
+CHUNK = 64 * 1024
+CONTENT = bytes(range(256)) * (SIZE // 256)
+SHA256 = hashlib.sha256(CONTENT).hexdigest()
+
+# Bytes per second; None sends as fast as possible
+RATES = {"unthrottled": None, "200MBps": 200 * 1000 * 1000}
+
+
+class ThrottledServer:
+    """Serves CONTENT at a fixed maximum rate."""
+
+    def __init__(self, rate):
+        class Handler(BaseHTTPRequestHandler):
+            protocol_version = "HTTP/1.1"
+
+            def log_message(self, *args):
+                pass
+
+            def do_GET(self):
+                self.send_response(200)
+                self.send_header("Content-Length", str(SIZE))
+                self.end_headers()
+                start = time.perf_counter()
+                for offset in range(0, SIZE, CHUNK):
+                    self.wfile.write(CONTENT[offset : offset + CHUNK])
+                    if rate:
+                        delay = (offset + CHUNK) / rate - (time.perf_counter() - start)
+                        if delay > 0:
+                            time.sleep(delay)
+
+        self._httpd = ThreadingHTTPServer(("127.0.0.1", 0), Handler)
+        self._httpd.daemon_threads = True
+        self.url = f"http://127.0.0.1:{self._httpd.server_address[1]}/file.tar.xz"
+        threading.Thread(target=self._httpd.serve_forever, daemon=True).start()
+
+    def close(self):
+        self._httpd.shutdown()
+        self._httpd.server_close()
+
+
+@pytest.fixture(autouse=True)
+def no_mirrors(monkeypatch):
+    """Download from the server only."""
+    monkeypatch.delenv(download.MIRRORS_ENV, raising=False)
+    set_mirrors(None)
+    yield
+    download._mirror_stats.clear()
+
+
+@pytest.mark.parametrize("rate", list(RATES))
+def test_download_file(bench, tmp_path, rate):
+    """Download and verify SIZE bytes."""
+    server = ThrottledServer(RATES[rate])
+    destination = tmp_path / "file.tar.xz"
+
+    def setup():
+        destination.unlink(missing_ok=True)
+        return destination
+
+    try:
+        bench(
+            lambda dest: download_file(server.url, dest, expected_sha256=SHA256),
+            setup=setup,
+            rounds=10,
+            bytes=SIZE,
+            rate=RATES[rate],
+        )
+    finally:
+        server.close()
+    assert destination.stat().st_size == SIZE
@@ -0,0 +1,89 @@
+"""
+Benchmarks for archive extraction.
+
+Synthetic archives resemble a small toolchain: a few large binaries and
+many small headers, with compressible and incompressible content.
+"""
+
+import io
+import os
+import random
+import shutil
+import tarfile
+import zipfile
+
+import pytest
+
+from toolchainkit.core.filesystem import extract_archive
+
+pytestmark = pytest.mark.benchmark
+
+HEADERS = 400
+HEADER_SIZE = 4 * 1024
+BINARIES = 4
+BINARY_SIZE = 2 * 1024 * 1024
+
+
+def _members():
+    rng = random.Random(42)
+    line = b"#pragma once\nnamespace bench { int value(); }\n"
+    header = line * (HEADER_SIZE // len(line))
+    for i in range(HEADERS):
+        yield f"toolchain/include/h{i // 50}/header{i}.h", header
+    for i in range(BINARIES):
+        # Half random, half zeros: compresses to about 50%
+        half = BINARY_SIZE // 2
+        yield f"toolchain/bin/tool{i}", rng.randbytes(half) + bytes(half)
+
+
+def _write_tar(path, mode):
+    with tarfile.open(path, mode) as tar:
+        for name, data in _members():
+            info = tarfile.TarInfo(name)
+            info.size = len(data)
+            info.mode = 0o755 if "/bin/" in name else 0o644
+            tar.addfile(info, io.BytesIO(data))
+
+
+def _write_zip(path):
+    with zipfile.ZipFile(path, "w", zipfile.ZIP_DEFLATED) as archive:
+        for name, data in _members():
+            archive.writestr(name, data)
+
+
+WRITERS = {
+    "tar.gz": lambda path: _write_tar(path, "w:gz"),
+    "tar.xz": lambda path: _write_tar(path, "w:xz"),
+    "zip": _write_zip,
+}
+
+
+@pytest.fixture(scope="module")
+def archives(tmp_path_factory):
+    """One synthetic archive per format."""
+    directory = tmp_path_factory.mktemp("archives")
+    paths = {}
+    for fmt, write in WRITERS.items():
+        paths[fmt] = directory / f"toolchain.{fmt}"
+        write(paths[fmt])
+    return paths
+
+
+@pytest.mark.parametrize("fmt", sorted(WRITERS))
+def test_extract_archive(bench, archives, tmp_path, fmt):
+    """Extract the whole archive into an empty directory."""
+    destination = tmp_path / "out"
+
+    def setup():
+        shutil.rmtree(destination, ignore_errors=True)
+        return destination
+
+    result = bench(
+        lambda dest: extract_archive(archives[fmt], dest),
+        setup=setup,
+        rounds=8,
+        files=HEADERS + BINARIES,
+        archive_bytes=os.path.getsize(archives[fmt]),
+    )
+    assert (destination / "toolchain" / "bin" / "tool0").stat().st_size == BINARY_SIZE
+    assert result.samples
@@ -0,0 +1,69 @@
+"""
+Benchmarks for layer composition and toolchain file generation.
+"""
+
+import pytest
+
+from toolchainkit.cmake.toolchain_generator import CMakeToolchainGenerator
+from toolchainkit.config.composer import LayerComposer
+from toolchainkit.core.filecache import clear_file_cache
+
+pytestmark = pytest.mark.benchmark
+
+LAYER_SETS = {
+    "minimal": [
+        {"type": "base", "name": "clang-18"},
+        {"type": "platform", "name": "linux-x64"},
+        {"type": "buildtype", "name": "release"},
+    ],
+    "full": [
+        {"type": "base", "name": "clang-18"},
+        {"type": "platform", "name": "linux-x64"},
+        {"type": "buildtype", "name": "relwithdebinfo"},
+        {"type": "optimization", "name": "lto-thin"},
+        {"type": "linker", "name": "lld"},
+        {"type": "debuginfo", "name": "fast"},
+        {"type": "sanitizer", "name": "address"},
+    ],
+}
+
+
+@pytest.fixture
+def global_layers(tmp_path):
+    """Empty global layers directory, so only built-in layers are found."""
+    path = tmp_path / "global-layers"
+    path.mkdir()
+    return path
+
+
+@pytest.mark.parametrize("layers", sorted(LAYER_SETS))
+def test_compose_cold(bench, layers, global_layers):
+    """First composition in a process: layer YAML is read and parsed."""
+    specs = LAYER_SETS[layers]
+
+    def compose():
+        clear_file_cache()
+        LayerComposer(global_layers_dir=global_layers).compose(specs)
+
+    bench(compose, layers=len(specs))
+
+
+@pytest.mark.parametrize("layers", sorted(LAYER_SETS))
+def test_compose_warm(bench, layers, global_layers):
+    """Repeated composition with loaded layers."""
+    specs = LAYER_SETS[layers]
+    composer = LayerComposer(global_layers_dir=global_layers)
+    composer.compose(specs)
+
+    bench(lambda: composer.compose(specs), layers=len(specs))
+
+
+@pytest.mark.parametrize("layers", sorted(LAYER_SETS))
+def test_generate_from_layers(bench, layers, global_layers, tmp_path):
+    """Compose and write a CMake toolchain file."""
+    specs = LAYER_SETS[layers]
+    generator = CMakeToolchainGenerator(tmp_path / "project")
+    generator.layer_composer.global_layers_dir = global_layers
+
+    result = bench(lambda: generator.generate_from_layers(specs), layers=len(specs))
+    assert result.samples
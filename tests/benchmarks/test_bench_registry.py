@@ -0,0 +1,64 @@
+"""
+Benchmarks for the toolchain cache registry.
+
+Every registry update takes the registry file lock, loads the JSON file and
+writes it back atomically; concurrent writers serialize on the lock.
+"""
+
+import threading
+
+import pytest
+
+from toolchainkit.core.cache_registry import ToolchainCacheRegistry
+
+pytestmark = pytest.mark.benchmark
+
+TOOLCHAINS = 50
+OPERATIONS = 10
+
+
+@pytest.fixture
+def registry(tmp_path):
+    """Registry with TOOLCHAINS registered toolchains."""
+    registry = ToolchainCacheRegistry(tmp_path / "registry.json")
+    with registry.transaction():
+        for i in range(TOOLCHAINS):
+            registry.register_toolchain(
+                f"llvm-18.1.{i}-linux-x64",
+                tmp_path / "toolchains" / f"llvm-{i}",
+                512.0,
+                f"sha256:{i:064x}",
+                f"https://example.com/llvm-{i}.tar.xz",
+            )
+    return registry
+
+
+def test_lookup(bench, registry):
+    """Read one toolchain's metadata."""
+    bench(lambda: registry.get_toolchain_info("llvm-18.1.7-linux-x64"))
+
+
+def test_update(bench, registry):
+    """One locked read-modify-write."""
+    bench(lambda: registry.update_last_used("llvm-18.1.7-linux-x64"))
+
+
+@pytest.mark.parametrize("threads", [1, 4])
+def test_concurrent_updates(bench, registry, tmp_path, threads):
+    """OPERATIONS reference updates per thread, all threads at once."""
+
+    def worker(index):
+        toolchain_id = f"llvm-18.1.{index}-linux-x64"
+        for op in range(OPERATIONS):
+            project = tmp_path / "projects" / f"p{index}-{op}"
+            registry.add_project_reference(toolchain_id, project)
+            registry.update_last_used(toolchain_id)
+
+    def run():
+        workers = [threading.Thread(target=worker, args=(i,)) for i in range(threads)]
+        for thread in workers:
+            thread.start()
+        for thread in workers:
+            thread.join()
+
+    bench(run, rounds=10, threads=threads, operations=threads * OPERATIONS * 2)
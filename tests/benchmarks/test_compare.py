@@ -0,0 +1,176 @@
+"""
+Tests for the benchmark harness and the baseline comparison tool.
+
+These run in the normal test suite; the benchmarks themselves need
+--benchmark.
+"""
+
+import json
+
+import pytest
+
+from tests.benchmarks.compare import (
+    compare,
+    compare_one,
+    load_runs,
+    main,
+    mann_whitney_u,
+)
+from tests.benchmarks.harness import (
+    BenchmarkResult,
+    format_time,
+    load_results,
+    measure,
+    save_results,
+)
+
+FAST = [1.00, 1.02, 0.98, 1.01, 0.99, 1.03, 0.97, 1.00, 1.02, 0.98]
+SLOW = [x * 1.2 for x in FAST]
+
+
+def result(name, samples):
+    return BenchmarkResult(name=name, group="test", samples=list(samples))
+
+
+def runs(name, *samples):
+    return [result(name, s) for s in samples]
+
+
+class TestMannWhitneyU:
+    def test_separated_samples(self):
+        u, p = mann_whitney_u(FAST, SLOW)
+        assert u == 0
+        assert p < 0.001
+
+    def test_identical_samples(self):
+        _, p = mann_whitney_u(FAST, FAST)
+        assert p == pytest.approx(1.0)
+
+    def test_all_ties(self):
+        assert mann_whitney_u([1.0] * 5, [1.0] * 5) == (12.5, 1.0)
+
+    def test_symmetric(self):
+        _, p1 = mann_whitney_u(FAST, SLOW)
+        _, p2 = mann_whitney_u(SLOW, FAST)
+        assert p1 == pytest.approx(p2)
+
+    def test_empty(self):
+        assert mann_whitney_u([], FAST) == (0.0, 1.0)
+
+
+class TestCompare:
+    def test_regression_and_improvement(self):
+        comparison = compare_one(runs("a", FAST), runs("a", SLOW))
+        assert comparison.status == "regression"
+        assert comparison.effect == 1.0
+        assert compare_one(runs("a", SLOW), runs("a", FAST)).status == ("improvement")
+
+    def test_small_change_is_not_a_regression(self):
+        slightly = [x * 1.02 for x in FAST]
+        comparison = compare_one(runs("a", FAST), runs("a", slightly))
+        assert comparison.status == "unchanged"
+        assert comparison.change == pytest.approx(0.02)
+
+    def test_outlier_is_not_a_regression(self):
+        noisy = FAST[:-1] + [5.0]
+        assert compare_one(runs("a", FAST), runs("a", noisy)).status == ("unchanged")
+
+    def test_small_effect_is_not_a_regression(self):
+        # Median 15% slower and significant, but half the rounds are unchanged
+        overlapping = sorted(FAST * 20)
+        slower = overlapping[:100] + [x * 1.3 for x in overlapping[100:]]
+        comparison = compare_one(runs("a", overlapping), runs("a", slower))
+        assert comparison.p_value < 0.01
+        assert comparison.change > 0.05
+        assert comparison.effect < 0.8
+        assert comparison.status == "unchanged"
+
+    def test_run_medians_are_the_samples(self):
+        # Rounds differ within each run; what counts is every run being slower
+        baseline = runs("a", FAST, [x * 1.01 for x in FAST], [x * 0.99 for x in FAST])
+        current = runs("a", *[[x * 1.2 for x in run.samples] for run in baseline])
+        comparison = compare_one(baseline, current)
+        assert comparison.runs == 3
+        assert comparison.current_median == pytest.approx(1.2)
+        assert comparison.status == "regression"
+
+        # One slow run of three is not consistent enough
+        current = runs("a", SLOW, FAST, FAST)
+        assert compare_one(baseline, current).status == "unchanged"
+
+    def test_new_and_missing(self):
+        comparisons = compare(
+            {"old": runs("old", FAST), "same": runs("same", FAST)},
+            {"new": runs("new", FAST), "same": runs("same", FAST)},
+        )
+        assert [(c.name, c.status) for c in comparisons] == [
+            ("new", "new"),
+            ("old", "missing"),
+            ("same", "unchanged"),
+        ]
+
+
+class TestResultsFiles:
+    def test_round_trip(self, tmp_path):
+        path = tmp_path / "results.json"
+        save_results(path, [BenchmarkResult("a", "g", FAST, {"size": 3})])
+
+        data = json.loads(path.read_text())
+        assert data["machine"]["cpu_count"]
+        assert data["benchmarks"]["a"]["median"] == pytest.approx(1.0)
+
+        loaded = load_results(path)
+        assert loaded["a"].samples == FAST
+        assert loaded["a"].params == {"size": 3}
+
+    def test_wrong_version(self, tmp_path):
+        path = tmp_path / "results.json"
+        path.write_text('{"version": 99, "benchmarks": {}}')
+        with pytest.raises(ValueError):
+            load_results(path)
+
+    def test_main_exit_code(self, tmp_path, capsys):
+        baseline = tmp_path / "baseline.json"
+        current = tmp_path / "current.json"
+        save_results(baseline, [result("a", FAST)])
+        save_results(current, [result("a", SLOW)])
+
+        assert main([str(baseline), str(baseline)]) == 0
+        assert main([str(baseline), str(current)]) == 1
+        assert "1 regression(s): a" in capsys.readouterr().out
+        assert main([str(baseline), str(tmp_path / "missing.json")]) == 2
+
+    def test_main_several_runs(self, tmp_path, capsys):
+        paths = []
+        for side, factor in (("base", 1.0), ("current", 1.2)):
+            for run in range(3):
+                path = tmp_path / f"{side}-{run}.json"
+                save_results(path, [result("a", [x * factor for x in FAST])])
+                paths.append(str(path))
+
+        assert len(load_runs(paths[:3])["a"]) == 3
+        assert main(paths) == 1
+        assert "1 regression(s): a" in capsys.readouterr().out
+        with pytest.raises(SystemExit):
+            main(paths[:3])
+
+
+class TestMeasure:
+    def test_fast_calls_are_repeated(self):
+        calls = []
+        samples = measure(lambda: calls.append(1), rounds=3, warmup=0)
+        assert len(samples) == 3
+        assert len(calls) > 3
+
+    def test_setup_runs_before_every_call(self):
+        seen = []
+        counter = iter(range(100))
+        samples = measure(seen.append, setup=lambda: next(counter), rounds=3)
+        assert len(samples) == 3
+        assert seen == [0, 1, 2, 3]
+
+    def test_format_time(self):
+        assert format_time(2.5) == "2.50 s"
+        assert format_time(0.0025) == "2.50 ms"
+        assert format_time(2.5e-6) == "2.50 µs"
+        assert format_time(2.5e-8) == "25 ns"
@@ -0,0 +1,333 @@
+"""
+Unit tests for the remote cache backend benchmark.
+
+Runs against local stand-in servers: the embedded HTTP cache server plus
+minimal Redis (RESP) and Memcached (text protocol) servers.
+"""
+
+import socketserver
+import threading
+
+import pytest
+
+from toolchainkit.caching.benchmark import (
+    BackendBenchmark,
+    MemcachedBackendClient,
+    RedisBackendClient,
+    RemoteCacheBenchmark,
+    create_client,
+    object_size_distribution,
+    percentile,
+    synthetic_payload,
+)
+from toolchainkit.caching.detection import BuildCacheConfig
+from toolchainkit.caching.remote import RemoteCacheConfig, RemoteCacheConfigurator
+from toolchainkit.caching.server import CacheServer, DiskLRUStore
+
+
+class _ThreadedServer(socketserver.ThreadingTCPServer):
+    daemon_threads = True
+    allow_reuse_address = True
+
+
+class _RedisHandler(socketserver.StreamRequestHandler):
+    """Just enough RESP for AUTH/SELECT/SET/GET/DEL."""
+
+    def handle(self):
+        store = self.server.store
+        while True:
+            header = self.rfile.readline()
+            if not header:
+                return
+            parts = []
+            for _ in range(int(header[1:])):
+                length = int(self.rfile.readline()[1:])
+                parts.append(self.rfile.read(length + 2)[:-2])
+            command = parts[0].upper()
+            if command == b"SET":
+                store[parts[1]] = parts[2]
+                self.wfile.write(b"+OK\r\n")
+            elif command == b"GET":
+                value = store.get(parts[1])
+                if value is None:
+                    self.wfile.write(b"$-1\r\n")
+                else:
+                    self.wfile.write(b"$%d\r\n%s\r\n" % (len(value), value))
+            elif command == b"DEL":
+                self.wfile.write(
+                    b":%d\r\n" % int(store.pop(parts[1], None) is not None)
+                )
+            elif command == b"AUTH" and parts[1] != b"secret":
+                self.wfile.write(b"-WRONGPASS invalid password\r\n")
+            else:
+                self.wfile.write(b"+OK\r\n")
+
+
+class _MemcachedHandler(socketserver.StreamRequestHandler):
+    """Just enough memcached text protocol for set/get/delete."""
+
+    def handle(self):
+        store = self.server.store
+        while True:
+            line = self.rfile.readline()
+            if not line:
+                return
+            words = line.split()
+            if words[0] == b"set":
+                data = self.rfile.read(int(words[4]) + 2)[:-2]
+                if len(data) > 1024 * 1024:
+                    self.wfile.write(b"SERVER_ERROR object too large for cache\r\n")
+                    continue
+                store[words[1]] = data
+                self.wfile.write(b"STORED\r\n")
+            elif words[0] == b"get":
+                value = store.get(words[1])
+                if value is not None:
+                    self.wfile.write(
+                        b"VALUE %s 0 %d\r\n%s\r\n" % (words[1], len(value), value)
+                    )
+                self.wfile.write(b"END\r\n")
+            elif words[0] == b"delete":
+                found = store.pop(words[1], None) is not None
+                self.wfile.write(b"DELETED\r\n" if found else b"NOT_FOUND\r\n")
+
+
+def _start(handler):
+    server = _ThreadedServer(("127.0.0.1", 0), handler)
+    server.store = {}
+    threading.Thread(
+        target=server.serve_forever, kwargs={"poll_interval": 0.05}, daemon=True
+    ).start()
+    return server
+
+
+@pytest.fixture
+def redis_server():
+    """Stand-in Redis server."""
+    server = _start(_RedisHandler)
+    yield server
+    server.shutdown()
+    server.server_close()
+
+
+@pytest.fixture
+def memcached_server():
+    """Stand-in Memcached server."""
+    server = _start(_MemcachedHandler)
+    yield server
+    server.shutdown()
+    server.server_close()
+
+
+@pytest.fixture
+def http_server(tmp_path):
+    """Embedded HTTP cache server."""
+    store = DiskLRUStore(tmp_path / "http", max_size="100M", compression="none")
+    server = CacheServer(store, port=0).start()
+    yield server
+    server.shutdown()
+
+
+def _redis(server, **kwargs):
+    host, port = server.server_address
+    return RemoteCacheConfig(
+        backend_type="redis", endpoint=f"redis://{host}:{port}", **kwargs
+    )
+
+
+def _memcached(server):
+    host, port = server.server_address
+    return RemoteCacheConfig(backend_type="memcached", endpoint=f"{host}:{port}")
+
+
+def _unreachable():
+    return RemoteCacheConfig(backend_type="redis", endpoint="redis://127.0.0.1:1")
+
+
+SMALL = {"objects": 20, "concurrency": 4, "max_size": 64 * 1024}
+
+
+class TestWorkload:
+    """Tests for the synthetic workload helpers."""
+
+    def test_sizes_are_deterministic_and_bounded(self):
+        """Test the size distribution is reproducible and in range."""
+        sizes = object_size_distribution(500, seed=1)
+
+        assert sizes == object_size_distribution(500, seed=1)
+        assert all(4 * 1024 <= s <= 2 * 1024 * 1024 for s in sizes)
+        # Log-uniform: most objects are small
+        assert percentile(sizes, 50) < 200 * 1024
+
+    def test_payload(self):
+        """Test payloads have the requested size."""
+        assert len(synthetic_payload(10000, 3)) == 10000
+        assert synthetic_payload(100, 3) == synthetic_payload(100, 3)
+
+    def test_percentile(self):
+        """Test nearest-rank percentile."""
+        values = list(range(1, 101))
+        assert percentile(values, 50) == 51
+        assert percentile(values, 99) == 99
+        assert percentile([], 50) == 0.0
+
+    def test_invalid_workload(self):
+        """Test non-positive workload parameters are rejected."""
+        with pytest.raises(ValueError):
+            RemoteCacheBenchmark(objects=0)
+
+
+class TestClients:
+    """Tests for the wire-protocol clients."""
+
+    def test_redis_roundtrip(self, redis_server):
+        """Test Redis put/get/delete."""
+        client = create_client(_redis(redis_server))
+        assert isinstance(client, RedisBackendClient)
+
+        client.put("k", b"\x00binary\r\n")
+        assert client.get("k") == b"\x00binary\r\n"
+        client.delete("k")
+        assert client.get("k") is None
+        client.close()
+
+    def test_redis_auth_error(self, redis_server):
+        """Test Redis errors surface as exceptions."""
+        with pytest.raises(RuntimeError, match="WRONGPASS"):
+            create_client(_redis(redis_server, credentials={"password": "bad"}))
+
+    def test_memcached_roundtrip(self, memcached_server):
+        """Test Memcached put/get/delete."""
+        client = create_client(_memcached(memcached_server))
+        assert isinstance(client, MemcachedBackendClient)
+
+        client.put("k", b"value")
+        assert client.get("k") == b"value"
+        client.delete("k")
+        assert client.get("k") is None
+        client.close()
+
+    def test_unsupported_backend(self):
+        """Test GCS cannot be benchmarked."""
+        config = RemoteCacheConfig(backend_type="gcs", bucket="b")
+        with pytest.raises(ValueError, match="not supported"):
+            create_client(config)
+
+
+class TestRemoteCacheBenchmark:
+    """Tests for benchmark runs and selection."""
+
+    def test_http_backend(self, http_server):
+        """Test benchmarking the HTTP cache server."""
+        config = RemoteCacheConfig(backend_type="http", endpoint=http_server.url)
+        result = RemoteCacheBenchmark(**SMALL).run(config)
+
+        assert result.reachable
+        assert result.operations == 40
+        assert result.failures == 0
+        assert result.mb_per_sec > 0
+        assert 0 < result.p50_ms <= result.p99_ms
+        # Benchmark objects are cleaned up
+        assert http_server.store.stats().objects == 0
+
+    def test_redis_backend(self, redis_server):
+        """Test benchmarking Redis."""
+        result = RemoteCacheBenchmark(**SMALL).run(_redis(redis_server))
+
+        assert result.reachable
+        assert result.failures == 0
+        assert redis_server.store == {}
+
+    def test_memcached_clamps_to_item_limit(self, memcached_server):
+        """Test objects larger than the memcached item limit are clamped."""
+        bench = RemoteCacheBenchmark(objects=5, min_size=2 * 1024 * 1024)
+        result = bench.run(_memcached(memcached_server))
+
+        assert result.reachable
+        assert result.failures == 0
+
+    def test_unreachable_backend(self):
+        """Test unreachable backends are reported, not raised."""
+        result = RemoteCacheBenchmark(**SMALL).run(_unreachable())
+
+        assert not result.reachable
+        assert result.error
+        assert "unreachable" in str(result)
+
+    def test_select_fastest_throughput(self, redis_server, mocker):
+        """Test the faster backend wins on throughput."""
+        # Every clock read advances by the backend's stubbed operation time
+        clock = {"now": 0.0, "step": 0.0}
+
+        def perf_counter():
+            clock["now"] += clock["step"]
+            return clock["now"]
+
+        mocker.patch("toolchainkit.caching.benchmark.time.perf_counter", perf_counter)
+        bench = RemoteCacheBenchmark(**{**SMALL, "concurrency": 1})
+        results = []
+        for step, config in [
+            (0.02, _redis(redis_server)),
+            (0.0, _unreachable()),
+            (0.001, _redis(redis_server)),
+        ]:
+            clock["step"] = step
+            results.append(bench.run(config))
+
+        best = RemoteCacheBenchmark.select_fastest(results)
+        assert best is results[2]
+        assert RemoteCacheBenchmark.select_fastest(results, "latency") is results[2]
+
+    def test_select_prefers_clean_backends(self):
+        """Test backends with failures rank below clean ones."""
+        flaky = BackendBenchmark("http", "a", True, failures=2, mb_per_sec=500.0)
+        clean = BackendBenchmark("redis", "b", True, mb_per_sec=100.0)
+
+        assert RemoteCacheBenchmark.select_fastest([flaky, clean]) is clean
+
+    def test_select_none_reachable(self):
+        """Test None when nothing is reachable."""
+        down = BackendBenchmark("redis", "a", False)
+        assert RemoteCacheBenchmark.select_fastest([down]) is None
+
+    def test_select_invalid_criterion(self):
+        """Test unknown criteria are rejected."""
+        with pytest.raises(ValueError):
+            RemoteCacheBenchmark.select_fastest([], "cost")
+
+
+class TestConfiguratorAutoSelect:
+    """Tests for auto-selection in RemoteCacheConfigurator."""
+
+    @pytest.fixture
+    def configurator(self, tmp_path):
+        exe = tmp_path / "sccache"
+        exe.touch()
+        return RemoteCacheConfigurator(
+            BuildCacheConfig(tool="sccache", executable_path=exe, cache_dir=tmp_path)
+        )
+
+    def test_select_backend(self, configurator, http_server, redis_server):
+        """Test select_backend returns the winning configuration."""
+        http = RemoteCacheConfig(backend_type="http", endpoint=http_server.url)
+        down = _unreachable()
+
+        selected, results = configurator.select_backend([down, http], **SMALL)
+
+        assert selected is http
+        assert len(results) == 2
+        assert not results[0].reachable
+
+    def test_get_all_env_vars_auto_selects(self, configurator, redis_server):
+        """Test launcher env vars use the auto-selected backend."""
+        redis = _redis(redis_server)
+
+        env_vars = configurator.get_all_env_vars(candidates=[_unreachable(), redis])
+
+        assert env_vars["SCCACHE_REDIS"] == redis.endpoint
+
+    def test_get_all_env_vars_no_reachable_backend(self, configurator):
+        """Test no remote variables when nothing is reachable."""
+        env_vars = configurator.get_all_env_vars(candidates=[_unreachable()])
+
+        assert "SCCACHE_REDIS" not in env_vars
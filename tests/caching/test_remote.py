@@ -99,6 +99,57 @@ class TestRemoteCacheConfig:
         assert config.bucket == "my-gcs-cache"
 
 
+class TestRemoteCacheConfigFromUrl:
+    """Test building configurations from URLs and config entries."""
+
+    def test_http_url(self):
+        """Test http(s) URLs map to the HTTP backend."""
+        config = RemoteCacheConfig.from_url("https://cache.example.com/sccache")
+        assert config.backend_type == "http"
+        assert config.endpoint == "https://cache.example.com/sccache"
+
+    def test_redis_url(self):
+        """Test redis URLs keep the full endpoint."""
+        config = RemoteCacheConfig.from_url("redis://cache:6379/1")
+        assert config.backend_type == "redis"
+        assert config.endpoint == "redis://cache:6379/1"
+
+    def test_memcached_url(self):
+        """Test memcached URLs become host:port endpoints."""
+        config = RemoteCacheConfig.from_url("memcached://mc1:11211")
+        assert config.backend_type == "memcached"
+        assert config.endpoint == "mc1:11211"
+
+    def test_bucket_urls(self):
+        """Test s3:// and gs:// URLs become bucket + prefix."""
+        s3 = RemoteCacheConfig.from_url("s3://my-cache/sccache")
+        assert (s3.backend_type, s3.bucket, s3.prefix) == ("s3", "my-cache", "sccache")
+
+        gcs = RemoteCacheConfig.from_url("gs://my-cache")
+        assert (gcs.backend_type, gcs.bucket, gcs.prefix) == ("gcs", "my-cache", None)
+
+    def test_unknown_scheme(self):
+        """Test unknown schemes are rejected."""
+        with pytest.raises(ValueError, match="Unrecognized"):
+            RemoteCacheConfig.from_url("ftp://cache")
+
+    def test_from_dict(self):
+        """Test toolchainkit.yaml remote entries."""
+        config = RemoteCacheConfig.from_dict(
+            {"type": "redis", "endpoint": "redis://cache:6379", "prefix": "ci"}
+        )
+        assert config.backend_type == "redis"
+        assert config.prefix == "ci"
+
+    def test_from_dict_bucket_endpoint(self):
+        """Test s3 entries with an s3:// endpoint."""
+        config = RemoteCacheConfig.from_dict(
+            {"type": "s3", "endpoint": "s3://my-cache/sccache", "region": "eu-west-1"}
+        )
+        assert config.bucket == "my-cache"
+        assert config.region == "eu-west-1"
+
+
 # =============================================================================
 # SecureCredentialHandler Tests
 # =============================================================================
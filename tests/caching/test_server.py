@@ -0,0 +1,482 @@
+"""
+Unit tests for the embedded compiler cache server.
+
+Tests DiskLRUStore eviction/compression and the CacheServer HTTP protocol
+subset used by sccache (WebDAV) and ccache (HTTP storage).
+"""
+
+import json
+import os
+import threading
+from concurrent.futures import ThreadPoolExecutor
+
+import pytest
+import requests
+
+from toolchainkit.caching.detection import BuildCacheConfig
+from toolchainkit.caching.remote import RemoteCacheConfigurator
+from toolchainkit.caching.server import (
+    CacheServer,
+    DiskLRUStore,
+    clear_server_state,
+    fetch_server_stats,
+    find_local_server,
+    parse_size,
+    write_server_state,
+)
+
+
+# =============================================================================
+# parse_size Tests
+# =============================================================================
+
+
+class TestParseSize:
+    """Tests for human-readable size parsing."""
+
+    @pytest.mark.parametrize(
+        "text,expected",
+        [
+            ("1024", 1024),
+            ("1K", 1024),
+            ("512M", 512 * 1024**2),
+            ("10G", 10 * 1024**3),
+            ("1.5G", int(1.5 * 1024**3)),
+            ("2GiB", 2 * 1024**3),
+            (4096, 4096),
+        ],
+    )
+    def test_parse_valid(self, text, expected):
+        """Test valid size strings."""
+        assert parse_size(text) == expected
+
+    @pytest.mark.parametrize("text", ["", "abc", "-1G", "G"])
+    def test_parse_invalid(self, text):
+        """Test malformed size strings raise ValueError."""
+        with pytest.raises(ValueError):
+            parse_size(text)
+
+
+# =============================================================================
+# DiskLRUStore Tests
+# =============================================================================
+
+
+class TestDiskLRUStore:
+    """Tests for the disk-backed LRU store."""
+
+    def test_put_get_roundtrip(self, tmp_path):
+        """Test storing and fetching an object."""
+        store = DiskLRUStore(tmp_path, max_size="1M")
+        store.put("ab/cdef", b"object data")
+
+        assert store.get("ab/cdef") == b"object data"
+        assert store.contains("ab/cdef")
+
+    def test_get_missing_returns_none(self, tmp_path):
+        """Test fetching an unknown key."""
+        store = DiskLRUStore(tmp_path, max_size="1M")
+
+        assert store.get("missing") is None
+        assert store.stats().misses == 1
+
+    def test_corrupt_object_is_dropped(self, tmp_path):
+        """Test a truncated object on disk is a miss and is removed."""
+        store = DiskLRUStore(tmp_path, max_size="1M", compression="zlib")
+        store.put("key", b"a" * 10_000)
+        (path,) = [p for p in (tmp_path / "objects").rglob("*") if p.is_file()]
+        path.write_bytes(path.read_bytes()[:20])
+
+        assert store.get("key") is None
+        assert not path.exists()
+        assert not store.contains("key")
+        stats = store.stats()
+        assert (stats.objects, stats.stored_bytes, stats.hits) == (0, 0, 0)
+
+        store.put("key", b"fresh")
+        assert store.get("key") == b"fresh"
+
+    def test_compressible_object_stored_compressed(self, tmp_path):
+        """Test compressible objects use less disk than their payload."""
+        store = DiskLRUStore(tmp_path, max_size="10M", compression="zlib")
+        data = b"a" * 100_000
+        store.put("key", data)
+
+        assert store.stats().stored_bytes < len(data) // 10
+        assert store.get("key") == data
+
+    def test_incompressible_object_stored_raw(self, tmp_path):
+        """Test already-compressed payloads are not recompressed."""
+        store = DiskLRUStore(tmp_path, max_size="10M", compression="zlib")
+        data = os.urandom(10_000)
+        store.put("key", data)
+
+        # Header only overhead
+        assert store.stats().stored_bytes == len(data) + 5
+        assert store.get("key") == data
+
+    def test_no_compression(self, tmp_path):
+        """Test compression can be disabled."""
+        store = DiskLRUStore(tmp_path, max_size="10M", compression="none")
+        store.put("key", b"a" * 10_000)
+
+        assert store.stats().stored_bytes == 10_005
+
+    def test_invalid_compression_raises(self, tmp_path):
+        """Test unknown codecs are rejected."""
+        with pytest.raises(ValueError, match="Invalid compression"):
+            DiskLRUStore(tmp_path, compression="lzma")
+
+    def test_lru_eviction(self, tmp_path):
+        """Test least-recently-used objects are evicted when over limit."""
+        store = DiskLRUStore(tmp_path, max_size=3 * 1005, compression="none")
+        store.put("a", b"x" * 1000)
+        store.put("b", b"x" * 1000)
+        store.put("c", b"x" * 1000)
+
+        # Touch 'a' so 'b' becomes least recently used
+        assert store.get("a") is not None
+        store.put("d", b"x" * 1000)
+
+        assert store.contains("a")
+        assert not store.contains("b")
+        assert store.contains("c")
+        assert store.contains("d")
+        assert store.stats().evictions == 1
+        assert store.stats().stored_bytes <= store.max_size
+
+    def test_oversized_object_not_stored(self, tmp_path):
+        """Test objects larger than the whole store are dropped."""
+        store = DiskLRUStore(tmp_path, max_size=100, compression="none")
+        store.put("big", b"x" * 1000)
+
+        assert store.get("big") is None
+
+    def test_overwrite_updates_accounting(self, tmp_path):
+        """Test rewriting a key does not double count its size."""
+        store = DiskLRUStore(tmp_path, max_size="1M", compression="none")
+        store.put("key", b"x" * 100)
+        store.put("key", b"y" * 200)
+
+        stats = store.stats()
+        assert stats.objects == 1
+        assert stats.stored_bytes == 205
+        assert store.get("key") == b"y" * 200
+
+    def test_delete(self, tmp_path):
+        """Test deleting objects."""
+        store = DiskLRUStore(tmp_path, max_size="1M")
+        store.put("key", b"data")
+
+        assert store.delete("key") is True
+        assert store.delete("key") is False
+        assert store.get("key") is None
+        assert store.stats().objects == 0
+
+    def test_index_rebuilt_on_restart(self, tmp_path):
+        """Test a new store instance sees objects from a previous run."""
+        store = DiskLRUStore(tmp_path, max_size="1M")
+        store.put("persisted", b"data")
+
+        reopened = DiskLRUStore(tmp_path, max_size="1M")
+
+        assert reopened.get("persisted") == b"data"
+        assert reopened.stats().objects == 1
+
+    def test_restart_with_smaller_limit_evicts(self, tmp_path):
+        """Test reopening with a smaller limit trims the store."""
+        store = DiskLRUStore(tmp_path, max_size="1M", compression="none")
+        for i in range(10):
+            store.put(f"k{i}", b"x" * 1000)
+
+        reopened = DiskLRUStore(tmp_path, max_size=3000, compression="none")
+
+        assert reopened.stats().stored_bytes <= 3000
+
+    def test_concurrent_puts_and_gets(self, tmp_path):
+        """Test concurrent access keeps accounting consistent."""
+        store = DiskLRUStore(tmp_path, max_size="10M", compression="none")
+
+        def worker(i):
+            key = f"key-{i % 20}"
+            store.put(key, bytes([i % 256]) * 1000)
+            return store.get(key) is not None
+
+        with ThreadPoolExecutor(max_workers=8) as pool:
+            results = list(pool.map(worker, range(200)))
+
+        assert all(results)
+        stats = store.stats()
+        assert stats.objects == 20
+        assert stats.stored_bytes == 20 * 1005
+
+
+# =============================================================================
+# CacheServer Tests
+# =============================================================================
+
+
+@pytest.fixture
+def cache_server(tmp_path):
+    """Start a cache server on a free port."""
+    store = DiskLRUStore(tmp_path / "store", max_size="10M")
+    server = CacheServer(store, host="127.0.0.1", port=0).start()
+    yield server
+    server.shutdown()
+
+
+class TestCacheServer:
+    """Tests for the HTTP protocol subset."""
+
+    def test_put_then_get(self, cache_server):
+        """Test ccache-style PUT/GET roundtrip."""
+        url = cache_server.url + "ab/cdef0123"
+
+        assert requests.put(url, data=b"payload", timeout=5).status_code == 201
+        response = requests.get(url, timeout=5)
+
+        assert response.status_code == 200
+        assert response.content == b"payload"
+
+    def test_get_missing_is_404(self, cache_server):
+        """Test cache miss returns 404."""
+        response = requests.get(cache_server.url + "missing", timeout=5)
+        assert response.status_code == 404
+
+    def test_corrupt_object_is_404(self, cache_server):
+        """Test a corrupt object on disk is served as a miss."""
+        url = cache_server.url + "ab/cdef0123"
+        requests.put(url, data=b"payload", timeout=5)
+        store = cache_server.store
+        store._object_path(store._digest("ab/cdef0123")).write_bytes(b"TKC")
+
+        assert requests.get(url, timeout=5).status_code == 404
+
+    def test_head(self, cache_server):
+        """Test HEAD reports presence."""
+        url = cache_server.url + "key"
+        assert requests.head(url, timeout=5).status_code == 404
+        requests.put(url, data=b"x", timeout=5)
+        assert requests.head(url, timeout=5).status_code == 200
+
+    def test_delete(self, cache_server):
+        """Test DELETE removes objects."""
+        url = cache_server.url + "key"
+        requests.put(url, data=b"x", timeout=5)
+
+        assert requests.delete(url, timeout=5).status_code == 204
+        assert requests.get(url, timeout=5).status_code == 404
+
+    def test_webdav_mkcol_and_propfind(self, cache_server):
+        """Test WebDAV verbs used by sccache's backend."""
+        base = cache_server.url
+        assert (
+            requests.request("MKCOL", base + "sccache/", timeout=5).status_code == 201
+        )
+
+        requests.put(base + "sccache/a/b/obj", data=b"x", timeout=5)
+        found = requests.request("PROPFIND", base + "sccache/a/b/obj", timeout=5)
+        missing = requests.request("PROPFIND", base + "sccache/nope", timeout=5)
+
+        assert found.status_code == 207
+        assert missing.status_code == 404
+
+    def test_path_traversal_rejected(self, cache_server):
+        """Test '..' segments are rejected."""
+        import http.client
+
+        conn = http.client.HTTPConnection("127.0.0.1", cache_server.port, timeout=5)
+        conn.request("GET", "/a/../../etc/passwd")
+        assert conn.getresponse().status == 400
+        conn.close()
+
+    def test_stats_endpoint(self, cache_server):
+        """Test /_stats reports counters."""
+        requests.put(cache_server.url + "k", data=b"abc", timeout=5)
+        requests.get(cache_server.url + "k", timeout=5)
+        requests.get(cache_server.url + "missing", timeout=5)
+
+        stats = requests.get(cache_server.url + "_stats", timeout=5).json()
+
+        assert stats["puts"] == 1
+        assert stats["hits"] == 1
+        assert stats["misses"] == 1
+        assert stats["bytes_out"] == 3
+
+    def test_token_required(self, tmp_path):
+        """Test bearer-token authentication."""
+        store = DiskLRUStore(tmp_path, max_size="1M")
+        with CacheServer(store, port=0, token="s3cret").start() as server:
+            url = server.url + "key"
+            assert requests.put(url, data=b"x", timeout=5).status_code == 401
+            ok = requests.put(
+                url,
+                data=b"x",
+                headers={"Authorization": "Bearer s3cret"},
+                timeout=5,
+            )
+            assert ok.status_code == 201
+
+    def test_stats_require_token(self, tmp_path, monkeypatch):
+        """Test /_stats is behind the token like every other request."""
+        monkeypatch.delenv("SCCACHE_WEBDAV_TOKEN", raising=False)
+        store = DiskLRUStore(tmp_path, max_size="1M")
+        with CacheServer(store, port=0, token="s3cret").start() as server:
+            denied = requests.get(server.url + "_stats", timeout=5)
+
+            assert denied.status_code == 401
+            assert fetch_server_stats(server.url) is None
+            assert fetch_server_stats(server.url, token="s3cret")["puts"] == 0
+
+    @pytest.mark.parametrize(
+        "headers, status",
+        [
+            ({}, 411),
+            ({"Content-Length": "-1"}, 411),
+            ({"Content-Length": "ten"}, 411),
+            ({"Content-Length": "2000"}, 413),
+        ],
+    )
+    def test_put_length_checked(self, tmp_path, headers, status):
+        """Test missing, malformed and oversized bodies are rejected unread."""
+        import http.client
+
+        store = DiskLRUStore(tmp_path, max_size="1M")
+        with CacheServer(store, port=0, max_body=1000).start() as server:
+            conn = http.client.HTTPConnection("127.0.0.1", server.port, timeout=5)
+            conn.putrequest("PUT", "/key")
+            for name, value in headers.items():
+                conn.putheader(name, value)
+            conn.endheaders()
+            assert conn.getresponse().status == status
+            conn.close()
+
+        assert store.get("key") is None
+
+    def test_chunked_body_limit(self, tmp_path):
+        """Test chunked uploads count toward the body limit."""
+        store = DiskLRUStore(tmp_path, max_size="1M")
+        with CacheServer(store, port=0, max_body=1000).start() as server:
+            small = requests.put(
+                server.url + "small", data=iter([b"x" * 500]), timeout=5
+            )
+            large = requests.put(
+                server.url + "large", data=iter([b"x" * 600] * 2), timeout=5
+            )
+
+        assert small.status_code == 201
+        assert large.status_code == 413
+
+    def test_concurrent_clients(self, cache_server):
+        """Test parallel clients are served concurrently."""
+        errors = []
+
+        def client(i):
+            with requests.Session() as session:
+                for j in range(10):
+                    url = f"{cache_server.url}obj/{i}/{j}"
+                    data = f"{i}-{j}".encode() * 100
+                    if session.put(url, data=data, timeout=5).status_code != 201:
+                        errors.append(url)
+                    if session.get(url, timeout=5).content != data:
+                        errors.append(url)
+
+        threads = [threading.Thread(target=client, args=(i,)) for i in range(8)]
+        for t in threads:
+            t.start()
+        for t in threads:
+            t.join()
+
+        assert errors == []
+        assert cache_server.store.stats().objects == 80
+
+
+# =============================================================================
+# Discovery / Configurator Integration
+# =============================================================================
+
+
+class TestLocalServerDiscovery:
+    """Tests for auto-targeting a running local server."""
+
+    @pytest.fixture
+    def sccache_config(self, tmp_path):
+        exe = tmp_path / "sccache"
+        exe.touch()
+        return BuildCacheConfig(
+            tool="sccache", executable_path=exe, cache_dir=tmp_path / "cache"
+        )
+
+    def test_state_roundtrip(self, cache_server, tmp_path):
+        """Test written state is discovered while the server runs."""
+        write_server_state(cache_server, tmp_path)
+
+        found = find_local_server(tmp_path)
+
+        assert found == (f"http://127.0.0.1:{cache_server.port}/", False)
+        state = json.loads((tmp_path / "cache-server.json").read_text())
+        assert state["pid"] == os.getpid()
+
+        clear_server_state(tmp_path)
+        assert not (tmp_path / "cache-server.json").exists()
+
+    def test_stale_state_ignored(self, tmp_path):
+        """Test state for a stopped server is ignored."""
+        store = DiskLRUStore(tmp_path / "store")
+        server = CacheServer(store, port=0)
+        write_server_state(server, tmp_path)
+        server.shutdown()
+
+        assert find_local_server(tmp_path) is None
+
+    def test_no_state(self, tmp_path):
+        """Test discovery without any server."""
+        assert find_local_server(tmp_path) is None
+
+    def test_configure_local_server_sccache(self, sccache_config):
+        """Test sccache is pointed at the WebDAV endpoint."""
+        configurator = RemoteCacheConfigurator(sccache_config)
+        env = configurator.configure_local_server("http://box:8420/", token="t")
+
+        assert env == {
+            "SCCACHE_WEBDAV_ENDPOINT": "http://box:8420/",
+            "SCCACHE_WEBDAV_TOKEN": "t",
+        }
+
+    def test_configure_local_server_ccache(self, tmp_path):
+        """Test ccache is pointed at the HTTP storage endpoint."""
+        exe = tmp_path / "ccache"
+        exe.touch()
+        config = BuildCacheConfig(
+            tool="ccache", executable_path=exe, cache_dir=tmp_path / "cache"
+        )
+        env = RemoteCacheConfigurator(config).configure_local_server(
+            "http://box:8420/", token="t"
+        )
+
+        assert env == {"CCACHE_REMOTE_STORAGE": "http://box:8420|bearer-token=t"}
+
+    def test_configure_local_server_autodiscovery(
+        self, sccache_config, cache_server, tmp_path, monkeypatch
+    ):
+        """Test configurator auto-targets the advertised server."""
+        monkeypatch.setattr(
+            "toolchainkit.core.directory.get_global_cache_dir", lambda: tmp_path
+        )
+        write_server_state(cache_server, tmp_path)
+
+        env = RemoteCacheConfigurator(sccache_config).configure_local_server()
+
+        assert env["SCCACHE_WEBDAV_ENDPOINT"] == (
+            f"http://127.0.0.1:{cache_server.port}/"
+        )
+
+    def test_configure_local_server_none_running(
+        self, sccache_config, tmp_path, monkeypatch
+    ):
+        """Test auto-targeting without a running server yields no env."""
+        monkeypatch.setattr(
+            "toolchainkit.core.directory.get_global_cache_dir", lambda: tmp_path
+        )
+
+        assert RemoteCacheConfigurator(sccache_config).configure_local_server() == {}
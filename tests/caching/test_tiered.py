@@ -0,0 +1,378 @@
+"""
+Unit tests for the two-tier (local + remote) compiler cache.
+
+Uses an in-process CacheServer as the remote tier.
+"""
+
+import threading
+import time
+
+import pytest
+import requests
+
+from toolchainkit.caching.detection import BuildCacheConfig
+from toolchainkit.caching.launcher import CacheStats, CompilerLauncherConfig
+from toolchainkit.caching.server import CacheServer, DiskLRUStore
+from toolchainkit.caching.tiered import (
+    HTTPRemoteTier,
+    RemoteTier,
+    TieredCacheStats,
+    TieredStore,
+)
+
+
+class SlowRemote(RemoteTier):
+    """In-memory remote tier with artificial latency and call tracking."""
+
+    def __init__(self, delay: float = 0.0, fail_puts: bool = False):
+        self.objects = {}
+        self.delay = delay
+        self.fail_puts = fail_puts
+        self.gets = 0
+        self.heads = 0
+        self.lock = threading.Lock()
+
+    def get(self, key):
+        time.sleep(self.delay)
+        with self.lock:
+            self.gets += 1
+            return self.objects.get(key)
+
+    def put(self, key, data):
+        time.sleep(self.delay)
+        if self.fail_puts:
+            raise ConnectionError("remote down")
+        with self.lock:
+            self.objects[key] = data
+
+    def contains(self, key):
+        with self.lock:
+            self.heads += 1
+            return key in self.objects
+
+
+@pytest.fixture
+def remote_server(tmp_path):
+    """Remote tier stand-in: a plain cache server."""
+    store = DiskLRUStore(tmp_path / "remote", max_size="10M")
+    server = CacheServer(store, port=0).start()
+    yield server
+    server.shutdown()
+
+
+def make_tiered(tmp_path, remote, branch="main", **kwargs):
+    local = DiskLRUStore(tmp_path / "local", max_size="10M")
+    return TieredStore(local, remote, branch=branch, **kwargs)
+
+
+class TestTieredStore:
+    """Tests for lookup order, write-behind and metrics."""
+
+    def test_local_hit_does_not_touch_remote(self, tmp_path):
+        """Test local hits are served without remote GETs."""
+        remote = SlowRemote()
+        store = make_tiered(tmp_path, remote)
+        store.put("k", b"data")
+        store.flush()
+        gets_before = remote.gets
+
+        assert store.get("k") == b"data"
+        assert remote.gets == gets_before
+
+        stats = store.stats()
+        assert stats.local_hits == 1
+        assert stats.remote_hits == 0
+        assert stats.bytes_saved == 4
+        store.close()
+
+    def test_remote_hit_populates_local(self, tmp_path):
+        """Test remote hits are copied into the local tier."""
+        remote = SlowRemote()
+        remote.objects["k"] = b"remote data"
+        store = make_tiered(tmp_path, remote)
+
+        assert store.get("k") == b"remote data"
+        assert store.local.contains("k")
+        assert store.get("k") == b"remote data"
+
+        stats = store.stats()
+        assert stats.remote_hits == 1
+        assert stats.local_hits == 1
+        assert stats.hits == 2
+        store.close()
+
+    def test_local_copies_are_not_puts(self, tmp_path):
+        """Test remote-hit and prefetch copies are not counted as client puts."""
+        remote = SlowRemote()
+        remote.objects.update({"k": b"remote data", "p": b"prefetched"})
+        store = make_tiered(tmp_path, remote)
+
+        store.get("k")
+        assert store.prefetch(["p"]) == 1
+        stats = store.stats()
+        assert stats.puts == 0
+        assert stats.bytes_in == 0
+        assert stats.bytes_out == len(b"remote data")
+        assert stats.backfill_bytes == len(b"remote data")
+        assert stats.prefetched_bytes == len(b"prefetched")
+
+        store.put("new", b"client data")
+        stats = store.stats()
+        assert stats.puts == 1
+        assert stats.bytes_in == len(b"client data")
+        store.close()
+
+    def test_miss_in_both_tiers(self, tmp_path):
+        """Test misses are counted once."""
+        store = make_tiered(tmp_path, SlowRemote())
+
+        assert store.get("missing") is None
+        assert store.stats().misses == 1
+        store.close()
+
+    def test_contains_does_not_download(self, tmp_path):
+        """Test remote existence checks skip the GET and the local copy."""
+        remote = SlowRemote()
+        remote.objects["k"] = b"v"
+        store = make_tiered(tmp_path, remote)
+
+        assert store.contains("k")
+        assert not store.contains("missing")
+        assert remote.gets == 0
+        assert remote.heads == 2
+        assert not store.local.contains("k")
+        stats = store.stats()
+        assert (stats.remote_hits, stats.misses) == (1, 1)
+        store.close()
+
+    def test_write_behind_is_asynchronous(self, tmp_path):
+        """Test PUT returns before the slow remote upload completes."""
+        remote = SlowRemote(delay=0.3)
+        store = make_tiered(tmp_path, remote, upload_workers=1)
+
+        start = time.perf_counter()
+        store.put("k", b"data")
+        elapsed = time.perf_counter() - start
+
+        assert elapsed < 0.2
+        assert store.stats().uploads_pending == 1
+        store.flush()
+        assert remote.objects["k"] == b"data"
+        assert store.stats().uploads_pending == 0
+        store.close()
+
+    def test_upload_failures_are_counted(self, tmp_path):
+        """Test failed uploads do not break local caching."""
+        remote = SlowRemote(fail_puts=True)
+        store = make_tiered(tmp_path, remote, branch=None)
+
+        store.put("k", b"data")
+        store.flush()
+
+        assert store.get("k") == b"data"
+        assert store.stats().upload_errors == 1
+        store.close()
+
+    def test_full_queue_uploads_inline(self, tmp_path):
+        """Test back-pressure when the upload queue is full."""
+        remote = SlowRemote(delay=0.05)
+        store = make_tiered(tmp_path, remote, upload_workers=1, upload_queue_size=1)
+
+        for i in range(5):
+            store.put(f"k{i}", b"x")
+        store.flush()
+
+        assert len(remote.objects) == 5
+        store.close()
+
+    def test_stats_type(self, tmp_path):
+        """Test stats include tier counters."""
+        store = make_tiered(tmp_path, SlowRemote())
+        stats = store.stats()
+
+        assert isinstance(stats, TieredCacheStats)
+        assert "local_hits" in stats.to_dict()
+        store.close()
+
+
+class TestManifestPrefetch:
+    """Tests for branch manifests and prefetch."""
+
+    def test_manifest_written_on_close(self, tmp_path):
+        """Test keys used in a session are saved for the branch."""
+        remote = SlowRemote()
+        remote.objects["a"] = b"1"
+        store = make_tiered(tmp_path, remote, branch="feature/x")
+        store.get("a")
+        store.put("b", b"2")
+        store.get("missing")
+        store.close()
+
+        manifest = tmp_path / "local" / "manifests" / "feature_x.txt"
+        assert manifest.read_text().split() == ["a", "b", "missing"]
+        assert remote.objects["_manifests/feature_x"] == b"a\nb\nmissing\n"
+
+    def test_prefetch_from_local_manifest(self, tmp_path):
+        """Test the next session prefetches last session's keys."""
+        remote = SlowRemote()
+        remote.objects.update({"a": b"1", "b": b"2", "unused": b"3"})
+        first = make_tiered(tmp_path, remote)
+        first.get("a")
+        first.get("b")
+        first.close()
+
+        # Fresh local tier, same manifest dir
+        for path in (tmp_path / "local" / "objects").rglob("*"):
+            if path.is_file():
+                path.unlink()
+        second = make_tiered(tmp_path, remote)
+
+        assert second.prefetch() == 2
+        assert second.local.contains("a")
+        assert not second.local.contains("unused")
+        assert second.stats().prefetched == 2
+
+        gets_before = remote.gets
+        assert second.get("a") == b"1"
+        assert remote.gets == gets_before
+        second.close()
+
+    def test_prefetch_from_remote_manifest(self, tmp_path):
+        """Test an ephemeral runner pulls the manifest from the remote tier."""
+        remote = SlowRemote()
+        remote.objects.update({"a": b"1", "_manifests/main": b"a\n"})
+        store = make_tiered(tmp_path, remote)
+
+        assert store.prefetch() == 1
+        assert store.local.contains("a")
+        store.close()
+
+    def test_prefetch_skips_present_keys(self, tmp_path):
+        """Test prefetch only fetches keys missing locally."""
+        remote = SlowRemote()
+        remote.objects["a"] = b"1"
+        store = make_tiered(tmp_path, remote)
+        store.local.put("a", b"1")
+
+        assert store.prefetch(["a"]) == 0
+        store.close()
+
+    def test_manifest_checkpointed(self, tmp_path):
+        """Test the manifest is saved periodically, not only on close."""
+        store = make_tiered(tmp_path, SlowRemote(), checkpoint_interval=0.05)
+        store.put("a", b"1")
+        manifest = tmp_path / "local" / "manifests" / "main.txt"
+
+        deadline = time.monotonic() + 5
+        while not manifest.exists() and time.monotonic() < deadline:
+            time.sleep(0.01)
+        assert manifest.read_text().split() == ["a"]
+        store.close()
+
+    def test_no_branch_disables_manifest(self, tmp_path):
+        """Test manifests are disabled without a branch."""
+        store = make_tiered(tmp_path, SlowRemote(), branch=None)
+        store.put("a", b"1")
+        store.close()
+
+        assert store.load_manifest() == []
+        assert not (tmp_path / "local" / "manifests").exists()
+
+
+class TestTieredServer:
+    """End-to-end: client -> tiered local server -> remote server."""
+
+    def test_through_local_server(self, tmp_path, remote_server):
+        """Test objects flow through both HTTP tiers."""
+        store = make_tiered(tmp_path, HTTPRemoteTier(remote_server.url))
+        with CacheServer(store, port=0).start() as local_server:
+            url = local_server.url + "ab/obj"
+            assert requests.put(url, data=b"payload", timeout=5).status_code == 201
+            store.flush()
+
+            # Uploaded to remote by write-behind
+            remote_resp = requests.get(remote_server.url + "ab/obj", timeout=5)
+            assert remote_resp.content == b"payload"
+
+            assert requests.get(url, timeout=5).content == b"payload"
+            stats = requests.get(local_server.url + "_stats", timeout=5).json()
+            assert stats["local_hits"] == 1
+        store.close()
+
+    def test_http_tier_quotes_keys(self, tmp_path, remote_server):
+        """Test keys with URL metacharacters round-trip and HEAD is used."""
+        remote = HTTPRemoteTier(remote_server.url)
+        key = "ab/a b#c?d%25"
+        remote.put(key, b"payload")
+
+        assert remote.get(key) == b"payload"
+        assert remote.contains(key)
+        assert not remote.contains("ab/a b")
+        assert remote_server.store.stats().objects == 1
+        remote.close()
+
+
+class TestCacheStatsTiers:
+    """Tests for tier metrics surfaced through CacheStats."""
+
+    def test_str_without_tiers(self):
+        """Test string form is unchanged without tier data."""
+        stats = CacheStats(hits=1, misses=1, errors=0, cache_size=0, hit_rate=50.0)
+        assert "local_hits" not in str(stats)
+
+    def test_str_with_tiers(self):
+        """Test string form includes tier data."""
+        stats = CacheStats(
+            hits=3,
+            misses=1,
+            errors=0,
+            cache_size=0,
+            hit_rate=75.0,
+            local_hits=2,
+            remote_hits=1,
+            bytes_saved=1024,
+        )
+        assert "local_hits=2" in str(stats)
+        assert "bytes_saved=1024" in str(stats)
+
+    def test_get_stats_merges_tier_counters(self, tmp_path, mocker):
+        """Test launcher stats include tier metrics from the server."""
+        exe = tmp_path / "sccache"
+        exe.touch()
+        launcher = CompilerLauncherConfig(
+            BuildCacheConfig(
+                tool="sccache", executable_path=exe, cache_dir=tmp_path / "c"
+            )
+        )
+        mocker.patch(
+            "subprocess.run",
+            return_value=mocker.Mock(stdout="Cache hits  4\nCache misses  1\n"),
+        )
+        mocker.patch(
+            "toolchainkit.caching.server.fetch_server_stats",
+            return_value={"local_hits": 3, "remote_hits": 1, "bytes_saved": 99},
+        )
+
+        stats = launcher.get_stats()
+
+        assert stats.hits == 4
+        assert stats.local_hits == 3
+        assert stats.remote_hits == 1
+        assert stats.bytes_saved == 99
+
+    def test_get_stats_without_tiered_server(self, tmp_path, mocker):
+        """Test plain servers do not contribute tier metrics."""
+        exe = tmp_path / "ccache"
+        exe.touch()
+        launcher = CompilerLauncherConfig(
+            BuildCacheConfig(tool="ccache", executable_path=exe, cache_dir=tmp_path)
+        )
+        mocker.patch("subprocess.run", return_value=mocker.Mock(stdout=""))
+        mocker.patch(
+            "toolchainkit.caching.server.fetch_server_stats",
+            return_value={"hits": 1},
+        )
+
+        stats = launcher.get_stats()
+
+        assert stats.local_hits == 0
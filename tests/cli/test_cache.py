@@ -0,0 +1,149 @@
+"""
+Tests for cache command.
+"""
+
+import json
+import os
+import signal
+import subprocess
+import sys
+import time
+from pathlib import Path
+from unittest.mock import Mock
+
+import pytest
+import requests
+
+from toolchainkit.caching.server import STATE_FILE_NAME, CacheServer, DiskLRUStore
+from toolchainkit.cli.commands import cache
+
+
+@pytest.fixture
+def http_server(tmp_path):
+    """Embedded HTTP cache server as benchmark target."""
+    store = DiskLRUStore(tmp_path / "store", max_size="100M")
+    server = CacheServer(store, port=0).start()
+    yield server
+    server.shutdown()
+
+
+def _bench_args(tmp_path, urls, **kwargs):
+    defaults = dict(
+        urls=urls,
+        objects=10,
+        concurrency=2,
+        criterion="throughput",
+        json=False,
+        config=None,
+        project_root=tmp_path,
+    )
+    defaults.update(kwargs)
+    return Mock(**defaults)
+
+
+class TestCacheBench:
+    """Test cache bench command."""
+
+    def test_bench_urls(self, tmp_path, http_server, capsys):
+        """Test benchmarking backends given on the command line."""
+        args = _bench_args(tmp_path, [http_server.url, "redis://127.0.0.1:1"])
+
+        assert cache.run_bench(args) == 0
+
+        out = capsys.readouterr().out
+        assert "unreachable" in out
+        assert f"endpoint: {http_server.url}" in out
+
+    def test_bench_json(self, tmp_path, http_server, capsys):
+        """Test JSON output."""
+        args = _bench_args(
+            tmp_path, ["redis://127.0.0.1:1", http_server.url], json=True
+        )
+
+        assert cache.run_bench(args) == 0
+
+        data = json.loads(capsys.readouterr().out)
+        assert data["selected"] == 1
+        assert data["results"][1]["reachable"] is True
+
+    def test_bench_from_config(self, tmp_path, http_server, capsys):
+        """Test candidates are read from build.caching.remote."""
+        (tmp_path / "toolchainkit.yaml").write_text(
+            "version: 1\n"
+            "toolchains:\n"
+            "  - name: llvm-18\n"
+            "    type: clang\n"
+            "    version: 18.1.8\n"
+            "build:\n"
+            "  caching:\n"
+            "    enabled: true\n"
+            "    remote:\n"
+            "      - type: http\n"
+            f"        endpoint: {http_server.url}\n"
+        )
+        args = _bench_args(tmp_path, [])
+
+        assert cache.run_bench(args) == 0
+        assert "Fastest backend: http" in capsys.readouterr().out
+
+    def test_bench_no_candidates(self, tmp_path):
+        """Test error without URLs or config."""
+        assert cache.run_bench(_bench_args(tmp_path, [])) == 1
+
+    def test_bench_nothing_reachable(self, tmp_path):
+        """Test error when no backend is reachable."""
+        args = _bench_args(tmp_path, ["redis://127.0.0.1:1"])
+        assert cache.run_bench(args) == 1
+
+    def test_bench_invalid_url(self, tmp_path):
+        """Test error for unknown URL schemes."""
+        assert cache.run_bench(_bench_args(tmp_path, ["ftp://x"])) == 1
+
+
+@pytest.mark.skipif(sys.platform == "win32", reason="Needs SIGTERM")
+class TestCacheServe:
+    """Test tkgen cache serve as a process."""
+
+    def test_sigterm_flushes_upstream(self, tmp_path, http_server):
+        """Test SIGTERM uploads pending objects and the manifest, then exits."""
+        home = tmp_path / "home"
+        env = dict(
+            os.environ,
+            HOME=str(home),
+            PYTHONPATH=str(Path(__file__).resolve().parents[2]),
+        )
+        process = subprocess.Popen(
+            [
+                sys.executable,
+                "-m",
+                "toolchainkit.cli",
+                "cache",
+                "serve",
+                "--port",
+                "0",
+                "--dir",
+                str(tmp_path / "local"),
+                "--upstream",
+                http_server.url,
+                "--branch",
+                "main",
+                "--no-prefetch",
+            ],
+            env=env,
+            stdout=subprocess.DEVNULL,
+            stderr=subprocess.DEVNULL,
+        )
+        state = home / ".toolchainkit" / STATE_FILE_NAME
+        deadline = time.monotonic() + 30
+        while not state.exists() and time.monotonic() < deadline:
+            assert process.poll() is None, "server exited"
+            time.sleep(0.05)
+        url = json.loads(state.read_text())["url"]
+        assert requests.put(url + "ab/obj", data=b"x", timeout=5).status_code == 201
+
+        process.send_signal(signal.SIGTERM)
+
+        assert process.wait(timeout=30) == 0
+        assert not state.exists()
+        assert http_server.store.get("ab/obj") == b"x"
+        assert http_server.store.get("_manifests/main") == b"ab/obj\n"
@@ -2,216 +2,122 @@
 Tests for cleanup command.
 """
 
-import logging
-from unittest.mock import Mock
+from argparse import Namespace
+from datetime import datetime, timedelta
 
+import pytest
 
 from toolchainkit.cli.commands import cleanup
-
-
-class TestCleanupCommand:
-    """Test cleanup command functionality."""
-
-    def test_cleanup_basic_run(self):
-        """Test basic cleanup command execution."""
-        args = Mock(
-            dry_run=False,
-            unused=False,
-            older_than=None,
-            toolchain=None,
-        )
-
-        result = cleanup.run(args)
-
-        assert result == 0
-
-    def test_cleanup_with_dry_run(self):
-        """Test cleanup with --dry-run flag."""
-        args = Mock(
-            dry_run=True,
-            unused=False,
-            older_than=None,
-            toolchain=None,
-        )
-
-        result = cleanup.run(args)
-
-        assert result == 0
-
-    def test_cleanup_with_unused_flag(self):
-        """Test cleanup with --unused flag."""
-        args = Mock(
-            dry_run=False,
-            unused=True,
-            older_than=None,
-            toolchain=None,
-        )
-
-        result = cleanup.run(args)
-
-        assert result == 0
-
-    def test_cleanup_with_older_than(self):
-        """Test cleanup with --older-than parameter."""
-        args = Mock(
-            dry_run=False,
-            unused=False,
-            older_than="30d",
-            toolchain=None,
-        )
-
-        result = cleanup.run(args)
-
-        assert result == 0
-
-    def test_cleanup_with_specific_toolchain(self):
-        """Test cleanup with specific toolchain."""
-        args = Mock(
-            dry_run=False,
-            unused=False,
-            older_than=None,
-            toolchain="gcc-11.2.0",
-        )
-
-        result = cleanup.run(args)
-
-        assert result == 0
-
-    def test_cleanup_with_all_options(self):
-        """Test cleanup with all options combined."""
-        args = Mock(
-            dry_run=True,
-            unused=True,
-            older_than="7d",
-            toolchain="clang-14.0.0",
-        )
-
-        result = cleanup.run(args)
-
-        assert result == 0
-
-    def test_cleanup_logs_info_message(self, caplog):
-        """Test that cleanup logs an info message."""
-        args = Mock(
-            dry_run=False,
-            unused=False,
-            older_than=None,
-            toolchain=None,
+from toolchainkit.core.cache_registry import ToolchainCacheRegistry
+from toolchainkit.toolchain.cleanup import QUOTA_ENV, set_cache_quota
+
+MB = 1024 * 1024
+
+
+def make_args(**kwargs):
+    defaults = dict(
+        dry_run=False,
+        unused=False,
+        older_than=None,
+        toolchain=None,
+        stats=False,
+        quota=None,
+    )
+    defaults.update(kwargs)
+    return Namespace(**defaults)
+
+
+@pytest.fixture
+def registry(tmp_path, monkeypatch):
+    """Global cache with an unused and a referenced toolchain."""
+    monkeypatch.setattr(
+        "toolchainkit.core.cache_registry.get_global_cache_dir", lambda: tmp_path
+    )
+    monkeypatch.delenv(QUOTA_ENV, raising=False)
+    set_cache_quota(None)
+
+    registry = ToolchainCacheRegistry()
+    for tc_id in ("gcc-11.2.0", "llvm-18.1.8"):
+        path = tmp_path / "toolchains" / tc_id
+        path.mkdir(parents=True)
+        registry.register_toolchain(
+            tc_id, path, 10.0, "sha256:a", "http://a", size_bytes=10 * MB
         )
+    (tmp_path / "project").mkdir()
+    registry.add_project_reference("llvm-18.1.8", tmp_path / "project")
+    registry.register_artifact(tmp_path / "downloads" / "gcc.tar.xz", "download", MB)
 
-        with caplog.at_level(logging.INFO):
-            cleanup.run(args)
+    with registry.transaction():
+        data = registry._load_registry()
+        data["toolchains"]["gcc-11.2.0"]["last_used"] = (
+            datetime.now() - timedelta(days=60)
+        ).isoformat()
+        registry._save_registry(data)
+    yield registry
+    set_cache_quota(None)
 
-        assert "Cleanup command" in caplog.text
-
-    def test_cleanup_logs_debug_arguments(self, caplog):
-        """Test that cleanup logs debug information."""
-        args = Mock(
-            dry_run=True,
-            unused=True,
-            older_than="14d",
-            toolchain="gcc",
-        )
-
-        with caplog.at_level(logging.DEBUG):
-            cleanup.run(args)
-
-        assert "Arguments:" in caplog.text
-
-    def test_cleanup_output_dry_run_true(self, capsys):
-        """Test cleanup output shows dry_run True."""
-        args = Mock(
-            dry_run=True,
-            unused=False,
-            older_than=None,
-            toolchain=None,
-        )
 
-        cleanup.run(args)
-        captured = capsys.readouterr()
-
-        assert "--dry-run: True" in captured.out
-
-    def test_cleanup_output_dry_run_false(self, capsys):
-        """Test cleanup output shows dry_run False."""
-        args = Mock(
-            dry_run=False,
-            unused=False,
-            older_than=None,
-            toolchain=None,
-        )
-
-        cleanup.run(args)
-        captured = capsys.readouterr()
-
-        assert "--dry-run: False" in captured.out
+class TestCleanupCommand:
+    """Test cleanup command functionality."""
 
-    def test_cleanup_output_unused_flag(self, capsys):
-        """Test cleanup output shows unused flag."""
-        args = Mock(
-            dry_run=False,
-            unused=True,
-            older_than=None,
-            toolchain=None,
+    def test_stats(self, registry, capsys, monkeypatch):
+        """--stats reads sizes from the registry without walking the cache."""
+        monkeypatch.setattr(
+            "pathlib.Path.rglob", lambda *args: pytest.fail("cache was walked")
         )
 
-        cleanup.run(args)
-        captured = capsys.readouterr()
+        assert cleanup.run(make_args(stats=True)) == 0
 
-        assert "--unused: True" in captured.out
+        out = capsys.readouterr().out
+        assert "Toolchains:     2  20.0 MB" in out
+        assert "Downloads:" in out
+        assert "Total:" in out and "21.0 MB" in out
+        assert "Quota:       none" in out
 
-    def test_cleanup_output_older_than(self, capsys):
-        """Test cleanup output shows older-than value."""
-        args = Mock(
-            dry_run=False,
-            unused=False,
-            older_than="30d",
-            toolchain=None,
-        )
+    def test_stats_with_quota(self, registry, capsys, monkeypatch):
+        monkeypatch.setenv(QUOTA_ENV, "42M")
 
-        cleanup.run(args)
-        captured = capsys.readouterr()
+        cleanup.run(make_args(stats=True))
 
-        assert "--older-than: 30d" in captured.out
+        assert "42.0 MB (50% used" in capsys.readouterr().out
 
-    def test_cleanup_output_toolchain(self, capsys):
-        """Test cleanup output shows toolchain value."""
-        args = Mock(
-            dry_run=False,
-            unused=False,
-            older_than=None,
-            toolchain="gcc-11.2.0",
-        )
+    def test_no_options_shows_stats(self, registry, capsys):
+        assert cleanup.run(make_args()) == 0
+        assert "Total:" in capsys.readouterr().out
 
-        cleanup.run(args)
-        captured = capsys.readouterr()
+    def test_remove_toolchain(self, registry, capsys):
+        assert cleanup.run(make_args(toolchain="gcc-11.2.0")) == 0
+        assert registry.get_toolchain_info("gcc-11.2.0") is None
+        assert "Removed 1 item(s), 10.0 MB reclaimed" in capsys.readouterr().out
 
-        assert "--toolchain: gcc-11.2.0" in captured.out
+    def test_referenced_toolchain_is_kept(self, registry, capsys):
+        assert cleanup.run(make_args(toolchain="llvm-18.1.8")) == 0
+        assert registry.get_toolchain_info("llvm-18.1.8") is not None
+        assert "Referenced by 1 projects" in capsys.readouterr().err
 
-    def test_cleanup_returns_zero_exit_code(self):
-        """Test cleanup always returns 0 (success)."""
-        args = Mock(
-            dry_run=False,
-            unused=False,
-            older_than=None,
-            toolchain=None,
-        )
+    def test_unused(self, registry):
+        assert cleanup.run(make_args(unused=True)) == 0
+        assert registry.list_toolchains() == ["llvm-18.1.8"]
 
-        result = cleanup.run(args)
+    def test_older_than(self, registry):
+        cleanup.run(make_args(older_than=90))
+        assert registry.get_toolchain_info("gcc-11.2.0") is not None
 
-        assert result == 0
-        assert isinstance(result, int)
+        cleanup.run(make_args(older_than=30))
+        assert registry.get_toolchain_info("gcc-11.2.0") is None
 
-    def test_cleanup_handles_none_values(self):
-        """Test cleanup handles None values in arguments."""
-        args = Mock(
-            dry_run=None,
-            unused=None,
-            older_than=None,
-            toolchain=None,
-        )
+    def test_dry_run(self, registry, capsys):
+        assert cleanup.run(make_args(unused=True, dry_run=True)) == 0
+        assert registry.get_toolchain_info("gcc-11.2.0") is not None
+        assert "Would remove: gcc-11.2.0" in capsys.readouterr().out
 
-        # Should not raise an exception
-        result = cleanup.run(args)
+    def test_quota(self, registry, capsys):
+        assert cleanup.run(make_args(quota="12M")) == 0
+        # The oldest unreferenced toolchain goes first
+        assert registry.get_toolchain_info("gcc-11.2.0") is None
+        assert registry.get_toolchain_info("llvm-18.1.8") is not None
+        assert "Removed: gcc-11.2.0" in capsys.readouterr().out
 
-        assert result == 0
+    def test_invalid_quota(self, registry, capsys):
+        assert cleanup.run(make_args(quota="lots")) == 1
+        assert "lots" in capsys.readouterr().err
@@ -305,6 +305,50 @@ class TestBootstrap:
             assert mock_print.call_count > 0
 
 
+class TestCachingConfig:
+    """Test reading the compiler caching settings."""
+
+    def test_build_caching(self):
+        """Test build.caching, as parse_config() reads it."""
+        config = {"build": {"caching": {"enabled": True, "tool": "sccache"}}}
+        assert configure._caching_config(config) == {
+            "enabled": True,
+            "tool": "sccache",
+        }
+
+    def test_top_level_cache(self):
+        """Test a top-level cache mapping is still honoured."""
+        config = {"build": {"types": ["Release"]}, "cache": {"enabled": True}}
+        assert configure._caching_config(config) == {"enabled": True}
+
+    def test_not_configured(self):
+        """Test a configuration without caching."""
+        assert configure._caching_config({"build": None}) == {}
+
+
+class TestToolchainReference:
+    """Test configure records the project's toolchain in the cache registry."""
+
+    def test_reference_recorded(self, tmp_path, monkeypatch):
+        """Test the project references the configured toolchain."""
+        from toolchainkit.core.cache_registry import ToolchainCacheRegistry
+
+        monkeypatch.setattr(
+            "toolchainkit.core.directory.get_global_cache_dir", lambda: tmp_path
+        )
+        registry = ToolchainCacheRegistry(tmp_path / "registry.json")
+        registry.register_toolchain(
+            "llvm-18-linux-x64", tmp_path / "tc", 1.0, "sha256:a", "http://a"
+        )
+        project = tmp_path / "project"
+        project.mkdir()
+
+        configure._record_toolchain_use("llvm-18-linux-x64", project)
+
+        info = registry.get_toolchain_info("llvm-18-linux-x64")
+        assert info["projects"] == [str(project.resolve())]
+
+
 class TestToolchainTypeDetection:
     """Test compiler type detection from toolchain names."""
 
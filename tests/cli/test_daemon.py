@@ -0,0 +1,184 @@
+"""
+Tests for the tkgen daemon.
+
+Runs a daemon in a subprocess with its own home directory and socket, and
+checks that commands served by it behave like in-process runs, that watched
+changes rebuild the warm state and that the client falls back when no
+daemon is listening.
+"""
+
+import os
+import socket
+import subprocess
+import sys
+import time
+from pathlib import Path
+
+import pytest
+
+from toolchainkit.cli.daemon import (
+    DAEMON_ENV,
+    SOCKET_ENV,
+    _connect,
+    _peer_uid,
+    _Watcher,
+    request,
+    run_client,
+    supported,
+)
+
+REPO = Path(__file__).resolve().parents[2]
+
+pytestmark = pytest.mark.skipif(not supported(), reason="Unix only")
+
+
+def tkgen(env, cwd, *argv):
+    """Run tkgen in a fresh interpreter."""
+    return subprocess.run(
+        [sys.executable, "-m", "toolchainkit.cli", *argv],
+        cwd=cwd,
+        env=env,
+        capture_output=True,
+        text=True,
+        timeout=60,
+    )
+
+
+@pytest.fixture
+def env(tmp_path):
+    """Environment with a private home directory and daemon socket."""
+    home = tmp_path / "home"
+    home.mkdir()
+    return dict(
+        os.environ,
+        HOME=str(home),
+        PYTHONPATH=str(REPO),
+        **{SOCKET_ENV: str(tmp_path / "d.sock")},
+    )
+
+
+@pytest.fixture
+def daemon(env, tmp_path):
+    """A daemon serving in the foreground of a subprocess."""
+    process = subprocess.Popen(
+        [sys.executable, "-m", "toolchainkit.cli", "daemon", "start", "--foreground"],
+        env=env,
+        stdout=subprocess.DEVNULL,
+        stderr=subprocess.DEVNULL,
+    )
+    path = Path(env[SOCKET_ENV])
+    deadline = time.monotonic() + 30
+    while time.monotonic() < deadline:
+        try:
+            request({"op": "status"}, path)
+            break
+        except OSError:
+            assert process.poll() is None, "daemon exited"
+            time.sleep(0.05)
+    yield path
+    process.terminate()
+    process.wait(timeout=10)
+
+
+@pytest.fixture
+def project(tmp_path):
+    """CMake project directory."""
+    project = tmp_path / "project"
+    project.mkdir()
+    (project / "CMakeLists.txt").write_text("project(test CXX)\n")
+    return project
+
+
+class TestWatcher:
+    def test_detects_changes(self, tmp_path):
+        existing = tmp_path / "a.yaml"
+        existing.write_text("a")
+        watcher = _Watcher([existing, tmp_path / "b.yaml"])
+        assert not watcher.changed()
+
+        (tmp_path / "b.yaml").write_text("b")
+        assert watcher.changed()
+
+
+class TestClient:
+    def test_no_daemon_runs_in_process(self, env, monkeypatch, tmp_path):
+        monkeypatch.setenv(SOCKET_ENV, env[SOCKET_ENV])
+        assert run_client(["doctor"]) is None
+
+        # Socket file left behind by a daemon that died
+        stale = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+        stale.bind(env[SOCKET_ENV])
+        stale.close()
+        assert run_client(["doctor"]) is None
+
+    def test_disabled(self, daemon, env, monkeypatch):
+        monkeypatch.setenv(SOCKET_ENV, env[SOCKET_ENV])
+        monkeypatch.setenv(DAEMON_ENV, "0")
+        assert run_client(["--version"]) is None
+
+    def test_socket_accessible_to_others(self, env, monkeypatch):
+        monkeypatch.setenv(SOCKET_ENV, env[SOCKET_ENV])
+        listening = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+        listening.bind(env[SOCKET_ENV])
+        listening.listen(1)
+        try:
+            os.chmod(env[SOCKET_ENV], 0o777)
+            with pytest.raises(PermissionError, match="other users"):
+                _connect(Path(env[SOCKET_ENV]))
+            assert run_client(["doctor"]) is None
+
+            os.chmod(env[SOCKET_ENV], 0o700)
+            _connect(Path(env[SOCKET_ENV])).close()
+        finally:
+            listening.close()
+
+    @pytest.mark.skipif(not hasattr(socket, "SO_PEERCRED"), reason="Linux only")
+    def test_peer_uid(self):
+        left, right = socket.socketpair()
+        with left, right:
+            assert _peer_uid(left) == os.getuid()
+
+
+class TestDaemon:
+    def test_commands_match_in_process(self, daemon, env, project):
+        served = tkgen(env, project, "init", "--minimal")
+        assert served.returncode == 0
+        assert (project / "toolchainkit.yaml").exists()
+
+        status = request({"op": "status"}, daemon)
+        assert status["requests"] == 1
+
+        served = tkgen(env, project, "verify", "--full")
+        local = tkgen(dict(env, **{DAEMON_ENV: "0"}), project, "verify", "--full")
+        assert (served.returncode, served.stdout) == (local.returncode, local.stdout)
+
+        served = tkgen(env, project / "..", "configure", "--toolchain", "llvm-18")
+        assert served.returncode == 1
+        assert request({"op": "status"}, daemon)["requests"] == 3
+
+    def test_other_home_runs_in_process(self, daemon, env, project, tmp_path):
+        home = tmp_path / "other-home"
+        home.mkdir()
+        served = tkgen(dict(env, HOME=str(home)), project, "--version")
+        assert served.returncode == 0
+        assert "ToolchainKit" in served.stdout
+        assert request({"op": "status"}, daemon)["requests"] == 0
+
+    def test_watched_change_rebuilds_state(self, daemon, env, project):
+        tkgen(env, project, "--version")
+        assert request({"op": "status"}, daemon)["generation"] == 1
+
+        layer = Path(env["HOME"]) / ".toolchainkit" / "layers" / "buildtype"
+        layer.mkdir(parents=True)
+        (layer / "custom.yaml").write_text("type: buildtype\nname: custom\n")
+
+        served = tkgen(env, project, "--version")
+        assert served.returncode == 0
+        assert "ToolchainKit" in served.stdout
+        assert request({"op": "status"}, daemon)["generation"] == 2
+
+    def test_stop(self, daemon, env, project):
+        result = tkgen(env, project, "daemon", "stop")
+        assert result.returncode == 0
+        assert not daemon.exists()
+        assert "No tkgen daemon" in tkgen(env, project, "daemon", "status").stdout
@@ -2,6 +2,8 @@
 Tests for CLI argument parser.
 """
 
+import json
+
 import pytest
 from unittest.mock import patch
 from pathlib import Path
@@ -235,6 +237,14 @@ class TestCleanupCommand:
 
         assert args.toolchain == "llvm-17"
 
+    def test_cleanup_stats_and_quota(self):
+        """Test cleanup with --stats and --quota."""
+        cli = CLI()
+        args = cli.parse_args(["cleanup", "--stats", "--quota", "50G"])
+
+        assert args.stats is True
+        assert args.quota == "50G"
+
     def test_cleanup_all_options(self):
         """Test cleanup with all options."""
         cli = CLI()
@@ -302,6 +312,196 @@ class TestVerifyCommand:
         assert args.full is True
 
 
+class TestCacheCommand:
+    """Test cache command parsing."""
+
+    def test_cache_serve_defaults(self):
+        """Test cache serve with defaults."""
+        cli = CLI()
+        args = cli.parse_args(["cache", "serve"])
+
+        assert args.command == "cache"
+        assert args.cache_command == "serve"
+        assert args.host == "127.0.0.1"
+        assert args.port == 8420
+        assert args.max_size == "10G"
+        assert args.compression == "zlib"
+        assert args.dir is None
+        assert args.token is None
+
+    def test_cache_serve_all_options(self):
+        """Test cache serve with all options."""
+        cli = CLI()
+        args = cli.parse_args(
+            [
+                "cache",
+                "serve",
+                "--host",
+                "0.0.0.0",
+                "--port",
+                "9000",
+                "--dir",
+                "/srv/cache",
+                "--max-size",
+                "50G",
+                "--compression",
+                "none",
+                "--token",
+                "abc",
+            ]
+        )
+
+        assert args.host == "0.0.0.0"
+        assert args.port == 9000
+        assert args.dir == Path("/srv/cache")
+        assert args.max_size == "50G"
+        assert args.compression == "none"
+        assert args.token == "abc"
+
+    def test_cache_serve_tiered_options(self):
+        """Test cache serve with an upstream tier."""
+        cli = CLI()
+        args = cli.parse_args(
+            [
+                "cache",
+                "serve",
+                "--upstream",
+                "https://cache.example.com/",
+                "--upstream-token",
+                "xyz",
+                "--branch",
+                "main",
+                "--no-prefetch",
+            ]
+        )
+
+        assert args.upstream == "https://cache.example.com/"
+        assert args.upstream_token == "xyz"
+        assert args.branch == "main"
+        assert args.no_prefetch is True
+
+    def test_cache_stats(self):
+        """Test cache stats parsing."""
+        cli = CLI()
+        args = cli.parse_args(["cache", "stats"])
+
+        assert args.cache_command == "stats"
+
+    def test_cache_bench(self):
+        """Test cache bench parsing."""
+        cli = CLI()
+        args = cli.parse_args(
+            [
+                "cache",
+                "bench",
+                "http://a:8420/",
+                "redis://b:6379",
+                "-j",
+                "16",
+                "--objects",
+                "50",
+                "--criterion",
+                "latency",
+                "--json",
+            ]
+        )
+
+        assert args.cache_command == "bench"
+        assert args.urls == ["http://a:8420/", "redis://b:6379"]
+        assert args.concurrency == 16
+        assert args.objects == 50
+        assert args.criterion == "latency"
+        assert args.json is True
+
+    def test_cache_bench_defaults(self):
+        """Test cache bench defaults."""
+        cli = CLI()
+        args = cli.parse_args(["cache", "bench"])
+
+        assert args.urls == []
+        assert args.concurrency == 8
+        assert args.objects == 200
+        assert args.criterion == "throughput"
+
+    @patch("toolchainkit.cli.commands.cache.run_stats")
+    def test_dispatch_cache_stats(self, mock_run):
+        """Test dispatching to cache stats."""
+        mock_run.return_value = 0
+        cli = CLI()
+
+        assert cli.run(["cache", "stats"]) == 0
+        assert mock_run.called
+
+    @patch("toolchainkit.cli.commands.cache.run_serve")
+    def test_dispatch_cache_serve(self, mock_run):
+        """Test dispatching to cache serve."""
+        mock_run.return_value = 0
+        cli = CLI()
+
+        assert cli.run(["cache", "serve"]) == 0
+        assert mock_run.called
+
+
+class TestFetchAndBundleCommands:
+    """Test fetch and bundle command parsing."""
+
+    def test_fetch_from_lock(self):
+        """Test fetch --from-lock with defaults."""
+        args = CLI().parse_args(["fetch", "--from-lock"])
+
+        assert args.command == "fetch"
+        assert args.from_lock is True
+        assert args.jobs == 4
+        assert args.force is False
+
+    def test_bundle_pin(self):
+        """Test bundle pin takes no arguments."""
+        args = CLI().parse_args(["bundle", "pin"])
+
+        assert args.bundle_command == "pin"
+
+    def test_bundle_export(self):
+        """Test bundle export options."""
+        args = CLI().parse_args(
+            ["bundle", "export", "deps.tkb", "--codec", "zlib", "-j", "2"]
+        )
+
+        assert args.bundle_command == "export"
+        assert args.output == Path("deps.tkb")
+        assert args.codec == "zlib"
+        assert args.jobs == 2
+
+    def test_bundle_import(self):
+        """Test bundle import options."""
+        args = CLI().parse_args(["bundle", "import", "deps.tkb", "--no-lock"])
+
+        assert args.bundle_command == "import"
+        assert args.bundle == Path("deps.tkb")
+        assert args.no_lock is True
+        assert args.force is False
+
+    def test_bundle_delta(self):
+        """Test bundle delta arguments."""
+        args = CLI().parse_args(
+            ["bundle", "delta", "llvm-18.1.7-linux-x64", "llvm-18.1.8-linux-x64", "d"]
+        )
+
+        assert args.bundle_command == "delta"
+        assert args.base == "llvm-18.1.7-linux-x64"
+        assert args.output == Path("d")
+        assert args.no_binary is False
+
+    def test_mirror_serve(self):
+        """Test mirror serve options."""
+        args = CLI().parse_args(["mirror", "serve", "--host", "0.0.0.0"])
+
+        assert args.command == "mirror"
+        assert args.mirror_command == "serve"
+        assert args.host == "0.0.0.0"
+        assert args.port == 8421
+        assert args.dir is None
+
+
 class TestGlobalOptions:
     """Test global options."""
 
@@ -505,6 +705,52 @@ class TestHelpText:
         assert "toolchain" in captured.out.lower()
 
 
+class TestTracing:
+    """Test --trace and TOOLCHAINKIT_TRACE."""
+
+    def test_trace_file_written(self, tmp_path, monkeypatch, capsys):
+        """Test --trace-file writes a Chrome trace and prints a summary."""
+        monkeypatch.delenv("TOOLCHAINKIT_TRACE", raising=False)
+        trace = tmp_path / "trace.json"
+        cli = CLI()
+        with patch("toolchainkit.cli.commands.doctor.run", return_value=0):
+            result = cli.run(["--trace-file", str(trace), "doctor"])
+
+        assert result == 0
+        names = [e["name"] for e in json.loads(trace.read_text())["traceEvents"]]
+        assert "tkgen doctor" in names
+        assert "load plugins" in names
+        err = capsys.readouterr().err
+        assert "Trace:" in err
+        assert "tkgen doctor" in err
+
+    def test_trace_file_from_environment(self, tmp_path, monkeypatch):
+        """Test TOOLCHAINKIT_TRACE selects the trace file."""
+        cli = CLI()
+        args = cli.parse_args(["--project-root", str(tmp_path), "doctor"])
+
+        monkeypatch.setenv("TOOLCHAINKIT_TRACE", "0")
+        assert cli._trace_file(args) is None
+        monkeypatch.setenv("TOOLCHAINKIT_TRACE", "1")
+        expected = tmp_path.resolve() / ".toolchainkit" / "trace-doctor.json"
+        assert cli._trace_file(args) == expected
+        monkeypatch.setenv("TOOLCHAINKIT_TRACE", str(tmp_path / "t.json"))
+        assert cli._trace_file(args) == tmp_path / "t.json"
+
+    def test_untraced_run_leaves_tracing_off(self, monkeypatch):
+        """Test commands run without a tracer unless requested."""
+        from toolchainkit.core import tracing
+
+        monkeypatch.delenv("TOOLCHAINKIT_TRACE", raising=False)
+        seen = []
+        with patch(
+            "toolchainkit.cli.commands.doctor.run",
+            side_effect=lambda args: seen.append(tracing.get_tracer()) or 0,
+        ):
+            assert CLI().run(["doctor"]) == 0
+        assert seen == [None]
+
+
 class TestIntegration:
     """Integration tests for CLI."""
 
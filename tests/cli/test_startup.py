@@ -0,0 +1,61 @@
+"""
+Tests for tkgen startup cost.
+
+Runs the CLI in a fresh interpreter and checks that parsing arguments does
+not import the heavy dependencies and subsystems that only some commands
+need.
+"""
+
+import json
+import subprocess
+import sys
+
+import pytest
+
+PROBE = """
+import json, sys
+from toolchainkit.cli.parser import CLI
+try:
+    CLI().run(sys.argv[1:])
+except SystemExit:
+    pass
+print(json.dumps(sorted(sys.modules)))
+"""
+
+HEAVY = [
+    "requests",
+    "yaml",
+    "jinja2",
+    "filelock",
+    "toolchainkit.packages",
+    "toolchainkit.toolchain.strategies",
+    "toolchainkit.toolchain.downloader",
+]
+
+
+def loaded_modules(*argv):
+    """Modules imported by a fresh interpreter running tkgen with argv."""
+    result = subprocess.run(
+        [sys.executable, "-c", PROBE, *argv],
+        capture_output=True,
+        text=True,
+        check=True,
+    )
+    return json.loads(result.stdout.strip().splitlines()[-1])
+
+
+@pytest.mark.parametrize(
+    "argv",
+    [
+        ["--help"],
+        ["--version"],
+        ["init", "--help"],
+        ["configure", "--help"],
+        ["bootstrap", "--help"],
+    ],
+)
+def test_parsing_imports_no_heavy_modules(argv):
+    """Test --help and --version stay free of heavy imports."""
+    modules = loaded_modules(*argv)
+    assert [m for m in HEAVY if m in modules] == []
+    assert len([m for m in modules if m.startswith("toolchainkit")]) <= 5
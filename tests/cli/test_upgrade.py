@@ -8,6 +8,9 @@ Tests cover:
 - CLI command functionality
 """
 
+import threading
+import time
+
 import pytest
 from pathlib import Path
 from unittest.mock import Mock, MagicMock, patch
@@ -23,6 +26,7 @@ from toolchainkit.toolchain.upgrader import (
     upgrade_toolchainkit,
 )
 from toolchainkit.cli.commands import upgrade as upgrade_command
+from toolchainkit.core.filesystem import atomic_write
 
 
 # ============================================================================
@@ -426,6 +430,132 @@ class TestToolchainUpgrader:
         assert len(results) == 0
 
 
+class TestParallelUpgrade:
+    """Test upgrade_all_toolchains with a real registry."""
+
+    IDS = ["llvm-18.1.7-linux-x64", "gcc-13.1.0-linux-x64", "llvm-17.0.5-linux-x64"]
+
+    @pytest.fixture
+    def upgrader(self, tmp_path, monkeypatch):
+        """Upgrader with a registry of three toolchains and a fake downloader."""
+        from toolchainkit.core.cache_registry import ToolchainCacheRegistry
+
+        monkeypatch.setattr(
+            "toolchainkit.toolchain.upgrader.get_global_cache_dir", lambda: tmp_path
+        )
+        registry = ToolchainCacheRegistry(tmp_path / "registry.json")
+        for toolchain_id in self.IDS:
+            (tmp_path / toolchain_id).mkdir()
+            registry.register_toolchain(
+                toolchain_id, tmp_path / toolchain_id, 1.0, "sha256:x", "x"
+            )
+        registry.add_project_reference(self.IDS[1], tmp_path / "project")
+
+        upgrader = ToolchainUpgrader.__new__(ToolchainUpgrader)
+        upgrader.cache_registry = registry
+        upgrader.verifier = Mock()
+        upgrader.verifier.verify.return_value = Mock(success=True)
+        latest = {"llvm": "18.1.8", "gcc": "13.2.0"}
+
+        def check(toolchain_id):
+            kind, version = toolchain_id.split("-")[:2]
+            return UpdateInfo(version, latest[kind], f"https://x/{kind}", "abc", 1)
+
+        upgrader.check_for_updates = Mock(side_effect=check)
+
+        self.active = self.peak = 0
+        lock = threading.Lock()
+
+        def download_and_install(toolchain_id, url, checksum, progress_callback):
+            with lock:
+                self.active += 1
+                self.peak = max(self.peak, self.active)
+            time.sleep(0.1)
+            with lock:
+                self.active -= 1
+            if toolchain_id.startswith("gcc"):
+                raise RuntimeError("disk full")
+            path = tmp_path / toolchain_id
+            path.mkdir(exist_ok=True)
+            registry.register_toolchain(toolchain_id, path, 1.0, "sha256:y", url)
+            return path
+
+        upgrader.downloader = Mock()
+        upgrader.downloader.download_and_install.side_effect = download_and_install
+        return upgrader
+
+    def test_bounded_concurrency_and_isolated_failures(self, upgrader, tmp_path):
+        """Test upgrades overlap up to the limit and failures stay isolated."""
+        results = upgrader.upgrade_all_toolchains(workers=2)
+
+        assert [r.toolchain_id for r in results] == self.IDS
+        assert [r.success for r in results] == [True, False, True]
+        assert "disk full" in results[1].error
+        assert self.peak == 2
+
+        registry = upgrader.cache_registry
+        assert sorted(registry.list_toolchains()) == [
+            "gcc-13.1.0-linux-x64",
+            "llvm-18.1.8-linux-x64",
+        ]
+        assert not (tmp_path / "llvm-18.1.7-linux-x64").exists()
+        assert not (tmp_path / "llvm-17.0.5-linux-x64").exists()
+
+    def test_registry_committed_once(self, upgrader, tmp_path):
+        """Test project references and removals are one registry write."""
+        upgrader.check_for_updates.side_effect = lambda toolchain_id: UpdateInfo(
+            "13.1.0", "13.2.0", "https://x/gcc", "abc", 1
+        )
+        upgrader.downloader.download_and_install.side_effect = (
+            lambda toolchain_id, **kwargs: tmp_path / toolchain_id
+        )
+        upgrader.cache_registry.register_toolchain(
+            "gcc-13.2.0-linux-x64", tmp_path / "gcc-13.2.0-linux-x64", 1.0, "s", "x"
+        )
+
+        with patch(
+            "toolchainkit.core.cache_registry.atomic_write", wraps=atomic_write
+        ) as write:
+            upgrader.commit_upgrades(
+                [(toolchain_id, "gcc-13.2.0-linux-x64") for toolchain_id in self.IDS]
+            )
+
+        assert write.call_count == 1
+        info = upgrader.cache_registry.get_toolchain_info("gcc-13.2.0-linux-x64")
+        assert info["projects"] == [str((tmp_path / "project").resolve())]
+        assert upgrader.cache_registry.list_toolchains() == [
+            "gcc-13.1.0-linux-x64",
+            "gcc-13.2.0-linux-x64",
+        ]
+
+    def test_failed_check_is_reported(self, upgrader):
+        """Test a toolchain whose update check fails gets a failed result."""
+        check = upgrader.check_for_updates.side_effect
+
+        def failing(toolchain_id):
+            if toolchain_id == self.IDS[0]:
+                raise ConnectionError("index unreachable")
+            return check(toolchain_id)
+
+        upgrader.check_for_updates.side_effect = failing
+        assert list(upgrader.check_all_updates()) == self.IDS[1:]
+
+        results = upgrader.upgrade_all_toolchains()
+
+        assert [r.toolchain_id for r in results] == self.IDS
+        assert [r.success for r in results] == [False, False, True]
+        assert "index unreachable" in results[0].error
+
+    def test_check_all_updates_skips_failures(self, upgrader):
+        """Test toolchains whose check fails are left out."""
+        upgrader.check_for_updates.side_effect = lambda toolchain_id: (
+            None
+            if toolchain_id.startswith("gcc")
+            else UpdateInfo("1", "2", "u", "s", 1)
+        )
+        assert list(upgrader.check_all_updates()) == [self.IDS[0], self.IDS[2]]
+
+
 # ============================================================================
 # CLI Command Tests
 # ============================================================================
@@ -760,8 +890,14 @@ class TestUpgradeCommandExtended:
         mock_upgrader.check_for_updates.return_value = Mock(
             latest_version="13.2.0", current_version="13.1.0", size_mb=400
         )
-        mock_upgrader.upgrade_toolchain.return_value = Mock(
-            success=True, new_version="13.2.0"
+        mock_upgrader.upgrade_toolchain.return_value = UpgradeResult(
+            toolchain_id="gcc-13.1.0",
+            old_version="13.1.0",
+            new_version="13.2.0",
+            success=True,
+            method="delta",
+            bytes_transferred=12 * 1024**2,
+            seconds=3.0,
         )
         mock_upgrader_cls.return_value = mock_upgrader
 
@@ -770,6 +906,7 @@ class TestUpgradeCommandExtended:
         assert result == 0
         captured = capsys.readouterr()
         assert "Upgraded to 13.2.0" in captured.out
+        assert "(delta, 12.0 MB in 3.0s)" in captured.out
 
     @patch("toolchainkit.cli.commands.upgrade.ToolchainUpgrader")
     @patch("toolchainkit.core.cache_registry.ToolchainCacheRegistry")
@@ -991,15 +1128,17 @@ class TestUpgradeCommandExtended:
             Mock(latest_version="13.2.0", current_version="13.1.0", size_mb=400),
             Mock(latest_version="18.1.8", current_version="18.1.7", size_mb=500),
         ]
-        mock_upgrader.upgrade_toolchain.side_effect = [
-            Mock(success=True, new_version="13.2.0"),
-            Mock(success=True, new_version="18.1.8"),
+        mock_upgrader.upgrade_all_toolchains.return_value = [
+            UpgradeResult("gcc-13.1.0", "13.1.0", "13.2.0", success=True),
+            UpgradeResult("clang-18.1.7", "18.1.7", "18.1.8", success=True),
         ]
         mock_upgrader_cls.return_value = mock_upgrader
 
         result = upgrade_command._upgrade_all_toolchains()
 
         assert result == 0
+        updates = mock_upgrader.upgrade_all_toolchains.call_args.kwargs["updates"]
+        assert list(updates) == ["gcc-13.1.0", "clang-18.1.7"]
         captured = capsys.readouterr()
         assert "2 upgraded, 0 failed" in captured.out
 
@@ -1022,9 +1161,11 @@ class TestUpgradeCommandExtended:
             Mock(latest_version="13.2.0", current_version="13.1.0", size_mb=400),
             Mock(latest_version="18.1.8", current_version="18.1.7", size_mb=500),
         ]
-        mock_upgrader.upgrade_toolchain.side_effect = [
-            Mock(success=True, new_version="13.2.0"),
-            Mock(success=False, error="Download failed"),
+        mock_upgrader.upgrade_all_toolchains.return_value = [
+            UpgradeResult("gcc-13.1.0", "13.1.0", "13.2.0", success=True),
+            UpgradeResult(
+                "clang-18.1.7", "18.1.7", "unknown", False, error="Download failed"
+            ),
         ]
         mock_upgrader_cls.return_value = mock_upgrader
 
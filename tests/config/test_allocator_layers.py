@@ -272,6 +272,147 @@ class TestLdPreloadMethod:
         assert "LD_PRELOAD" not in context.runtime_env
 
 
+class TestProxyMethod:
+    """Test proxy integration method."""
+
+    def test_proxy_sets_runtime_variables(self):
+        """Test the proxy runtime, allocator and defaults are passed to CMake."""
+        layer = AllocatorLayer(
+            "jemalloc", "jemalloc", method="proxy", proxy={"stats": True, "sample": 100}
+        )
+        layer._available_library = "/usr/lib/libjemalloc.so.2"
+        context = LayerContext()
+        context.platform = "linux-x64"
+        context.compiler = "gcc"
+
+        layer._apply_proxy_method(context)
+
+        variables = context.cmake_variables
+        assert variables["TOOLCHAINKIT_ALLOCATOR_PROXY_RUNTIME"].endswith(
+            "runtime/allocator/tk_malloc_proxy.cpp"
+        )
+        assert Path(variables["TOOLCHAINKIT_ALLOCATOR_PROXY_RUNTIME"]).exists()
+        assert (
+            variables["TOOLCHAINKIT_ALLOCATOR_PROXY_LIBRARY"]
+            == "/usr/lib/libjemalloc.so.2"
+        )
+        assert variables["TOOLCHAINKIT_ALLOCATOR_PROXY_DEFINITIONS"] == (
+            "TK_MALLOC_DEFAULT_STATS=1;TK_MALLOC_DEFAULT_SAMPLE=100"
+        )
+        assert "-ljemalloc" not in context.link_flags
+
+    def test_proxy_falls_back_to_link_on_windows(self):
+        """Test platforms without ELF interposition link the allocator."""
+        layer = AllocatorLayer("mimalloc", "mimalloc", method="proxy")
+        context = LayerContext()
+        context.platform = "windows-x64"
+        context.compiler = "msvc"
+
+        layer._apply_proxy_method(context)
+
+        assert "-lmimalloc" in context.link_flags
+        assert "TOOLCHAINKIT_ALLOCATOR_PROXY_RUNTIME" not in context.cmake_variables
+
+    def test_default_allocator_behind_proxy(self):
+        """Test the default allocator with the proxy still builds the proxy."""
+        layer = AllocatorLayer("proxy", "default", method="proxy")
+        context = LayerContext()
+        context.platform = "linux-x64"
+        context.compiler = "gcc"
+
+        layer.apply(context)
+
+        assert context.cmake_variables["TOOLCHAINKIT_ALLOCATOR_PROXY_LIBRARY"] == ""
+        assert context.cmake_variables["TOOLCHAINKIT_ALLOCATOR_PROXY_DEFINITIONS"] == (
+            "TK_MALLOC_DEFAULT_STATS=0;TK_MALLOC_DEFAULT_SAMPLE=0"
+        )
+        assert layer in context.applied_layers
+
+    def test_default_allocator_behind_proxy_conflicts_with_tsan(self):
+        """Test the proxy conflicts with ThreadSanitizer's allocator."""
+        layer = AllocatorLayer("proxy", "default", method="proxy")
+        context = LayerContext()
+        context.platform = "linux-x64"
+        context.sanitizers.add("thread")
+
+        with pytest.raises(LayerConflictError, match="ThreadSanitizer"):
+            layer.apply(context)
+
+    @pytest.mark.parametrize(
+        "proxy", [{"sample": -1}, {"sample": "10"}, {"sample": True}, {"stats": 1}]
+    )
+    def test_invalid_settings(self, proxy):
+        """Test invalid sampling rates and stats flags are rejected."""
+        with pytest.raises(ValueError, match="Invalid allocator proxy"):
+            AllocatorLayer("proxy", "default", method="proxy", proxy=proxy)
+
+    def test_toolchain_file_links_proxy(self, tmp_path):
+        """Test the generated toolchain file builds and links the proxy."""
+        from toolchainkit.cmake.toolchain_generator import CMakeToolchainGenerator
+
+        generator = CMakeToolchainGenerator(tmp_path)
+        toolchain_file = generator.generate_from_layers(
+            [
+                {"type": "base", "name": "gcc-13"},
+                {"type": "platform", "name": "linux-x64"},
+                {"type": "buildtype", "name": "release"},
+                {"type": "allocator", "name": "proxy"},
+            ],
+            "proxy-test",
+        )
+        content = toolchain_file.read_text()
+
+        assert "function(toolchainkit_allocator_proxy)" in content
+        assert "link_libraries(toolchainkit_allocator_proxy)" in content
+
+
+class TestReplayDriver:
+    """Test the allocation trace replay driver."""
+
+    def test_default_allocator_provides_replay_driver(self):
+        """Test every allocator layer passes the replay source to CMake."""
+        layer = AllocatorLayer("default", "default")
+        context = LayerContext()
+        context.platform = "linux-x64"
+        context.compiler = "gcc"
+
+        layer.apply(context)
+
+        source = context.cmake_variables["TOOLCHAINKIT_ALLOCATOR_REPLAY_SOURCE"]
+        assert source.endswith("runtime/allocator/tk_alloc_replay.cpp")
+        assert Path(source).exists()
+
+    def test_no_replay_driver_for_msvc(self):
+        """Test the POSIX-only driver is not provided on Windows."""
+        layer = AllocatorLayer("default", "default")
+        context = LayerContext()
+        context.platform = "windows-x64"
+        context.compiler = "msvc"
+
+        layer.apply(context)
+
+        assert "TOOLCHAINKIT_ALLOCATOR_REPLAY_SOURCE" not in context.cmake_variables
+
+    def test_toolchain_file_defines_replay_target(self, tmp_path):
+        """Test the replay executable is deferred and excluded from all."""
+        from toolchainkit.cmake.toolchain_generator import CMakeToolchainGenerator
+
+        generator = CMakeToolchainGenerator(tmp_path)
+        toolchain_file = generator.generate_from_layers(
+            [
+                {"type": "base", "name": "gcc-13"},
+                {"type": "platform", "name": "linux-x64"},
+                {"type": "buildtype", "name": "release"},
+                {"type": "allocator", "name": "proxy"},
+            ],
+            "replay-test",
+        )
+        content = toolchain_file.read_text()
+
+        assert "add_executable(toolchainkit_alloc_replay EXCLUDE_FROM_ALL" in content
+        assert "CALL toolchainkit_allocator_replay)" in content
+
+
 class TestAllocatorNotFound:
     """Test behavior when allocator is not found."""
 
@@ -383,6 +524,7 @@ class TestAllocatorYAMLLoading:
             "nedmalloc",
             "tbbmalloc",
             "default",
+            "proxy",
         ]
 
         import yaml
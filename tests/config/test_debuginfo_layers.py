@@ -0,0 +1,188 @@
+"""Tests for DebugInfoLayer configuration."""
+
+from pathlib import Path
+
+import toolchainkit
+
+from toolchainkit.cmake.toolchain_generator import CMakeToolchainGenerator
+from toolchainkit.cmake.yaml_compiler import YAMLCompilerLoader
+from toolchainkit.config import LayerComposer
+from toolchainkit.config.layers import DebugInfoLayer, LayerContext, LinkerLayer
+
+
+def _layer(**kwargs):
+    linkers = [
+        LinkerLayer(
+            "lld",
+            "lld",
+            "-fuse-ld=lld",
+            features={
+                "gdb_index": True,
+                "compress_debug": True,
+                "compress_debug_zstd": True,
+            },
+        ),
+        LinkerLayer(
+            "gold",
+            "gold",
+            "-fuse-ld=gold",
+            features={"gdb_index": True, "compress_debug": True},
+        ),
+        LinkerLayer("ld", "ld", "-fuse-ld=ld", features={"compress_debug": True}),
+    ]
+    options = {
+        "enable": ["split_dwarf", "gdb_index"],
+        "compression": ["zstd", "zlib"],
+        "dwp": True,
+        "linkers": linkers,
+    }
+    options.update(kwargs)
+    return DebugInfoLayer("fast", **options)
+
+
+def _context(compiler="clang", version="18.1.8", platform="linux-x64", linker="lld"):
+    context = LayerContext(
+        compiler=compiler, compiler_version=version, platform=platform
+    )
+    context.compile_flags = ["-O0", "-g3"]
+    context.link_flags = ["-g"]
+    if linker:
+        context.link_flags.append(f"-fuse-ld={linker}")
+    return context
+
+
+class TestDebugInfoLayer:
+    """Test feature selection from compiler and linker capabilities."""
+
+    def test_clang_lld_enables_everything(self):
+        """Test all features with a toolchain that supports them."""
+        layer = _layer()
+        context = _context()
+        layer.apply(context)
+
+        assert layer.enabled == ["split_dwarf", "gdb_index", "compress_zstd"]
+        assert "-gsplit-dwarf" in context.compile_flags
+        assert "-gz=zstd" in context.compile_flags
+        assert "-Wl,--gdb-index" in context.link_flags
+        assert "-gz=zstd" in context.link_flags
+        assert context.cmake_variables["TOOLCHAINKIT_DWP"].endswith("llvm-dwp")
+        assert "debuginfo" in context.layer_types
+
+    def test_old_compiler_falls_back_to_zlib(self):
+        """Test zstd is skipped below the compiler's min_version."""
+        layer = _layer()
+        context = _context(compiler="gcc", version="12.3.0", linker="lld")
+        layer.apply(context)
+
+        assert "compress_zlib" in layer.enabled
+        assert "-gz=zlib" in context.compile_flags
+        assert "-gz=zstd" not in context.compile_flags
+
+    def test_linker_without_zstd_falls_back_to_zlib(self):
+        """Test gold gets zlib compression even with GCC 13."""
+        layer = _layer()
+        context = _context(compiler="gcc", version="13.2.0", linker="gold")
+        layer.apply(context)
+
+        assert "compress_zlib" in layer.enabled
+        assert "gdb_index" in layer.enabled
+
+    def test_default_linker_has_no_gdb_index(self):
+        """Test GNU ld (no -fuse-ld) skips --gdb-index."""
+        layer = _layer()
+        context = _context(compiler="gcc", version="13.2.0", linker=None)
+        layer.apply(context)
+
+        assert "gdb_index" not in layer.enabled
+        assert "-Wl,--gdb-index" not in context.link_flags
+        assert "-gsplit-dwarf" in context.compile_flags
+        assert context.cmake_variables["TOOLCHAINKIT_DWP"] == "dwp"
+
+    def test_no_debug_info_is_noop(self):
+        """Test release builds without -g are left alone."""
+        layer = _layer()
+        context = _context()
+        context.compile_flags = ["-O3"]
+        layer.apply(context)
+
+        assert layer.enabled == []
+        assert context.compile_flags == ["-O3"]
+        assert "TOOLCHAINKIT_DWP" not in context.cmake_variables
+
+    def test_unsupported_platform_is_noop(self):
+        """Test non-ELF targets get no debug info features."""
+        layer = _layer()
+        context = _context(platform="macos-arm64", linker=None)
+        layer.apply(context)
+
+        assert layer.enabled == []
+
+    def test_msvc_has_no_capabilities(self):
+        """Test compilers without debug_info features are skipped."""
+        layer = _layer()
+        context = _context(compiler="msvc", version="19.38", platform="windows-x64")
+        layer.apply(context)
+
+        assert layer.enabled == []
+
+    def test_dwp_disabled(self):
+        """Test dwp: false does not export the packaging tool."""
+        layer = _layer(dwp=False)
+        context = _context()
+        layer.apply(context)
+
+        assert "split_dwarf" in layer.enabled
+        assert "TOOLCHAINKIT_DWP" not in context.cmake_variables
+
+
+class TestCompilerCapabilities:
+    """Test debug_info features in the built-in compiler YAML files."""
+
+    def test_min_version(self):
+        """Test min_version gates compress_zstd."""
+        loader = YAMLCompilerLoader(Path(toolchainkit.__file__).parent / "data")
+        clang = loader.load("clang", "linux-x64")
+
+        assert clang.get_debug_info_flags("compress_zstd", "15.0.7") is None
+        assert clang.get_debug_info_flags("compress_zstd", "16.0.0") is not None
+        assert clang.get_debug_info_flags("compress_zstd") is not None
+        assert clang.get_debug_info_flags("unknown") is None
+
+
+class TestComposition:
+    """Test debuginfo/fast through the composer and toolchain generator."""
+
+    SPECS = [
+        {"type": "base", "name": "clang-18"},
+        {"type": "platform", "name": "linux-x64"},
+        {"type": "buildtype", "name": "debug"},
+    ]
+
+    def test_applied_after_linker(self):
+        """Test the layer sees a linker listed after it."""
+        composer = LayerComposer()
+        config = composer.compose(
+            self.SPECS[:2]
+            + [{"type": "debuginfo", "name": "fast"}]
+            + self.SPECS[2:]
+            + [{"type": "linker", "name": "ld"}]
+        )
+
+        assert config.layers[-1].layer_type == "debuginfo"
+        assert "-gsplit-dwarf" in config.compile_flags
+        assert "-Wl,--gdb-index" not in config.link_flags
+
+    def test_toolchain_file_has_dwp_helper(self, tmp_path):
+        """Test the generated toolchain file defines toolchainkit_package_dwp."""
+        generator = CMakeToolchainGenerator(tmp_path)
+        toolchain_file = generator.generate_from_layers(
+            self.SPECS + [{"type": "debuginfo", "name": "fast"}], "debuginfo-test"
+        )
+        content = toolchain_file.read_text()
+
+        assert "function(toolchainkit_package_dwp target)" in content
+        assert "find_program(TOOLCHAINKIT_DWP NAMES llvm-dwp llvm-dwp-18 dwp" in content
+        assert '"/usr/lib/llvm-18/bin"' in content
+        assert "set(TOOLCHAINKIT_DWP" not in content
+        assert "No dwp tool found" in content
+        assert "-gsplit-dwarf" in content
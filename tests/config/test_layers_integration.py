@@ -72,6 +72,42 @@ class TestLayerSystemBasics:
         assert "-flto=thin" in config.link_flags
         assert "LTO_ENABLED=1" in config.defines
 
+    def test_compose_with_bolt_requires_component(self, composer, monkeypatch):
+        """Test that a layer's toolchain components are collected and installed."""
+        calls = []
+        monkeypatch.setattr(
+            "toolchainkit.toolchain.components.ensure_components",
+            lambda root, components: calls.append((root, components)) or [],
+        )
+        layer_specs = [
+            {"type": "base", "name": "clang-18"},
+            {"type": "platform", "name": "linux-x64"},
+            {"type": "buildtype", "name": "release"},
+            {"type": "optimization", "name": "bolt"},
+        ]
+
+        config = composer.compose(layer_specs)
+        assert config.required_components == {"bolt"}
+        assert "-Wl,--emit-relocs" in config.link_flags
+        assert calls == []
+
+        composer.compose(layer_specs, toolchain_root="/opt/llvm-18")
+        assert [components for _root, components in calls] == [["bolt"]]
+
+    def test_bolt_requires_clang(self, composer):
+        """Test that BOLT is rejected for GCC, whose toolchain has no llvm-bolt."""
+        from toolchainkit.config.layers import LayerRequirementError
+
+        layer_specs = [
+            {"type": "base", "name": "gcc-13"},
+            {"type": "platform", "name": "linux-x64"},
+            {"type": "buildtype", "name": "release"},
+            {"type": "optimization", "name": "bolt"},
+        ]
+
+        with pytest.raises(LayerRequirementError, match="compiler"):
+            composer.compose(layer_specs)
+
     def test_list_builtin_layers(self, composer):
         """Test listing built-in layers."""
         layers = composer.list_layers("base")
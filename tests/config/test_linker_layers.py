@@ -0,0 +1,239 @@
+"""Tests for LinkerLayer and AutoLinkerLayer configuration."""
+
+from pathlib import Path
+
+import pytest
+
+from toolchainkit.config import LayerComposer
+from toolchainkit.config.layers import (
+    AutoLinkerLayer,
+    LayerContext,
+    LayerRequirementError,
+    LinkerLayer,
+)
+from toolchainkit.toolchain import linker_benchmark
+from toolchainkit.toolchain.linker_benchmark import LinkerTiming
+
+
+def _linkers():
+    return {
+        "ld": LinkerLayer(
+            "ld",
+            "ld",
+            "-fuse-ld=ld",
+            supported_platforms=["linux"],
+            features={"full_lto": True},
+            speed="slow",
+        ),
+        "gold": LinkerLayer(
+            "gold",
+            "gold",
+            "-fuse-ld=gold",
+            supported_platforms=["linux"],
+            features={"full_lto": True},
+            speed="moderate",
+        ),
+        "lld": LinkerLayer(
+            "lld",
+            "lld",
+            "-fuse-ld=lld",
+            features={"thin_lto": True, "full_lto": True},
+            speed="fast",
+        ),
+        "mold": LinkerLayer(
+            "mold",
+            "mold",
+            "-fuse-ld=mold",
+            supported_platforms=["linux"],
+            supported_compilers=["gcc", "clang"],
+            features={"thin_lto": True, "full_lto": True},
+            speed="very_fast",
+        ),
+    }
+
+
+def _context(compiler="clang", platform="linux-x64", lto=None):
+    context = LayerContext(compiler=compiler, platform=platform)
+    context.link_flags = ["-pthread", "-fuse-ld=lld"]
+    if lto:
+        context.compile_flags.append(lto)
+        context.link_flags.append(lto)
+    return context
+
+
+class TestLinkerLayer:
+    """Test explicit linker layers."""
+
+    def test_apply_replaces_base_linker(self):
+        """Test the base layer's -fuse-ld is replaced, not duplicated."""
+        context = _context()
+        _linkers()["mold"].apply(context)
+
+        assert context.link_flags == ["-pthread", "-fuse-ld=mold"]
+        assert "linker" in context.layer_types
+
+    def test_thin_lto_requires_support(self):
+        """Test ThinLTO rejects linkers without thin_lto."""
+        linkers = _linkers()
+        context = _context(lto="-flto=thin")
+
+        assert "ThinLTO" in linkers["gold"].incompatibility(context)
+        assert linkers["lld"].incompatibility(context) is None
+        with pytest.raises(LayerRequirementError, match="ThinLTO"):
+            linkers["ld"].validate(context)
+
+    def test_gcc_lto_rejects_lld(self):
+        """Test lld cannot link GCC LTO objects."""
+        context = _context(compiler="gcc", lto="-flto")
+
+        assert _linkers()["lld"].incompatibility(context)
+        assert _linkers()["gold"].incompatibility(context) is None
+
+    def test_platform_and_compiler(self):
+        """Test platform and compiler restrictions."""
+        assert _linkers()["mold"].incompatibility(_context(platform="macos-arm64"))
+        assert _linkers()["mold"].incompatibility(_context(compiler="msvc"))
+        assert (
+            _linkers()["lld"].incompatibility(_context(platform="macos-arm64")) is None
+        )
+
+
+class TestAutoLinkerLayer:
+    """Test measured linker selection."""
+
+    @pytest.fixture
+    def fake_toolchain(self, tmp_path, monkeypatch):
+        """Fake compiler plus gold/lld/mold; returns the benchmark call log."""
+        bin_dir = tmp_path / "bin"
+        bin_dir.mkdir()
+        for name in ("clang++", "ld.gold", "ld.lld", "mold"):
+            exe = bin_dir / name
+            exe.write_text("#!/bin/sh\n")
+            exe.chmod(0o755)
+
+        calls = []
+
+        def fake_run(self, linkers, cpu_count=None):
+            calls.append(sorted(linkers))
+            return [
+                LinkerTiming("gold", None, 0.10, 3),
+                LinkerTiming("lld", 4, 0.30, 3),
+                LinkerTiming("mold", 4, 0.20, 3),
+            ]
+
+        monkeypatch.setenv("PATH", str(bin_dir))
+        monkeypatch.delenv("TOOLCHAINKIT_LINKER_BENCHMARK", raising=False)
+        monkeypatch.setattr(linker_benchmark.LinkerBenchmark, "run", fake_run)
+        return calls
+
+    def _layer(self, tmp_path):
+        return AutoLinkerLayer(
+            "auto", list(_linkers().values()), cache_path=tmp_path / "cache.json"
+        )
+
+    def _clang_context(self, tmp_path, lto=None):
+        context = _context(lto=lto)
+        context.cmake_variables["CMAKE_CXX_COMPILER"] = "{{toolchain_root}}/bin/clang++"
+        context.variables["toolchain_root"] = str(tmp_path)
+        return context
+
+    def test_measured_choice(self, tmp_path, fake_toolchain):
+        """Test the fastest measured linker wins."""
+        layer = self._layer(tmp_path)
+        context = self._clang_context(tmp_path)
+
+        layer.apply(context)
+
+        assert layer.selected.linker == "gold"
+        assert context.link_flags == ["-pthread", "-fuse-ld=gold"]
+        assert fake_toolchain == [["gold", "lld", "mold"]]
+
+    def test_respects_thin_lto(self, tmp_path, fake_toolchain):
+        """Test incompatible linkers are skipped even when fastest."""
+        layer = self._layer(tmp_path)
+        context = self._clang_context(tmp_path, lto="-flto=thin")
+
+        layer.apply(context)
+
+        assert layer.selected.linker == "mold"
+        assert "-fuse-ld=mold" in context.link_flags
+        assert "-Wl,--thread-count=4" in context.link_flags
+        assert "-fuse-ld=lld" not in context.link_flags
+
+    def test_measurement_is_cached(self, tmp_path, fake_toolchain):
+        """Test the benchmark runs once per toolchain."""
+        self._layer(tmp_path).apply(self._clang_context(tmp_path))
+        self._layer(tmp_path).apply(self._clang_context(tmp_path, lto="-flto=thin"))
+
+        assert len(fake_toolchain) == 1
+        assert (tmp_path / "cache.json").exists()
+
+    def test_heuristic_when_disabled(self, tmp_path, fake_toolchain, monkeypatch):
+        """Test declared speeds are used when measuring is disabled."""
+        monkeypatch.setenv("TOOLCHAINKIT_LINKER_BENCHMARK", "0")
+        layer = self._layer(tmp_path)
+        context = self._clang_context(tmp_path)
+
+        layer.apply(context)
+
+        assert fake_toolchain == []
+        assert layer.timing is None
+        assert layer.selected.linker == "mold"
+
+    def test_no_compatible_linker(self, tmp_path):
+        """Test an error when no candidate fits the configuration."""
+        layer = AutoLinkerLayer("auto", [_linkers()["gold"]])
+
+        with pytest.raises(LayerRequirementError):
+            layer.apply(_context(lto="-flto=thin"))
+
+
+class TestLinkerComposition:
+    """Test linker layers through LayerComposer."""
+
+    @pytest.fixture
+    def composer(self, tmp_path):
+        """Create layer composer."""
+        return LayerComposer(project_root=tmp_path)
+
+    def test_linker_layers_listed(self, composer):
+        """Test built-in linker layers are discoverable."""
+        layers = composer.list_layers("linker")
+        assert {"linker/auto", "linker/gold", "linker/lld"} <= set(layers)
+
+    def test_explicit_linker(self, composer):
+        """Test an explicit linker layer overrides the base layer."""
+        config = composer.compose(
+            [
+                {"type": "base", "name": "clang-18"},
+                {"type": "platform", "name": "linux-x64"},
+                {"type": "buildtype", "name": "release"},
+                {"type": "linker", "name": "mold"},
+            ]
+        )
+
+        assert "-fuse-ld=mold" in config.link_flags
+        assert "-fuse-ld=lld" not in config.link_flags
+
+    def test_auto_applied_after_optimization(self, composer, monkeypatch):
+        """Test linker/auto sees LTO from layers listed after it."""
+        monkeypatch.setenv("TOOLCHAINKIT_LINKER_BENCHMARK", "0")
+        monkeypatch.setattr(
+            linker_benchmark,
+            "find_linker",
+            lambda name, search_dirs=(): Path(f"/usr/bin/{name}"),
+        )
+
+        config = composer.compose(
+            [
+                {"type": "base", "name": "clang-18"},
+                {"type": "linker", "name": "auto"},
+                {"type": "platform", "name": "linux-x64"},
+                {"type": "buildtype", "name": "release"},
+                {"type": "optimization", "name": "lto-thin"},
+            ]
+        )
+
+        assert config.layers[-1].name == "auto"
+        fuse = [f for f in config.link_flags if f.startswith("-fuse-ld=")]
+        assert fuse == ["-fuse-ld=mold"]
@@ -199,6 +199,20 @@ class TestLockFile:
         assert "llvm-18" in lock.toolchains
         assert isinstance(lock.toolchains["llvm-18"], LockedComponent)
 
+    def test_sysroots_roundtrip(self):
+        """Test sysroots are written only when present and read back."""
+        comp = LockedComponent(
+            url="https://example.com/rpi.tar.gz",
+            sha256="abc123",
+            size_bytes=1024,
+            version="11",
+        )
+
+        assert "sysroots" not in LockFile().to_dict()
+        lock = LockFile.from_dict(LockFile(sysroots={"rpi": comp}).to_dict())
+
+        assert lock.sysroots["rpi"].version == "11"
+
 
 class TestLockFileManagerInit:
     """Tests for LockFileManager initialization."""
@@ -539,6 +553,40 @@ class TestLockFileVerification:
         assert len(issues) == 1
         assert "hash mismatch" in issues[0].lower()
 
+    @patch("toolchainkit.core.cache_registry.ToolchainCacheRegistry")
+    @patch("toolchainkit.core.directory.get_global_cache_dir")
+    def test_verify_modified_toolchain_files(
+        self, mock_cache_dir, mock_registry_class, temp_dir
+    ):
+        """Test verification detects files changed since installation."""
+        from toolchainkit.core.manifest import write_manifest
+
+        install_dir = temp_dir / "llvm"
+        (install_dir / "bin").mkdir(parents=True)
+        (install_dir / "bin" / "clang").write_bytes(b"clang")
+        write_manifest(install_dir)
+        (install_dir / "bin" / "clang").write_bytes(b"patched")
+
+        mock_cache_dir.return_value = temp_dir / ".toolchainkit"
+        mock_registry = Mock()
+        mock_registry.get_toolchain_info.return_value = {
+            "path": str(install_dir),
+            "hash": "abc123",
+        }
+        mock_registry_class.return_value = mock_registry
+
+        manager = LockFileManager(temp_dir)
+        comp = LockedComponent(
+            url="https://example.com/file.tar.gz", sha256="abc123", size_bytes=1024
+        )
+
+        verified, issues = manager.verify(LockFile(toolchains={"llvm-18": comp}))
+
+        assert verified is False
+        assert "files changed" in issues[0]
+        assert "bin/clang" in issues[0]
+        mock_registry_class.assert_called_once()
+
 
 class TestLockFileDiff:
     """Tests for lock file diff computation."""
@@ -2,7 +2,9 @@
 
 import pytest
 
+from toolchainkit.cmake.toolchain_generator import CMakeToolchainGenerator
 from toolchainkit.config.layers import (
+    LayerRequirementError,
     ProfilingLayer,
     LayerContext,
 )
@@ -104,6 +106,112 @@ class TestInstrumentFunctions:
         assert context.compile_flags.count("-finstrument-functions") == 1
 
 
+class TestInstrumentRuntime:
+    """Test the recording runtime of the instrument-functions layer."""
+
+    INSTRUMENT = {
+        "runtime": True,
+        "output_format": "folded",
+        "sample": 10,
+        "exclude": ["std::", "Logger::"],
+        "signal": 0,
+        "after_inlining": True,
+    }
+
+    def _apply(self, compiler, platform="linux-x64"):
+        layer = ProfilingLayer(
+            name="instrument-functions",
+            profiling_type="instrument_functions",
+            instrument=self.INSTRUMENT,
+        )
+        context = LayerContext(compiler=compiler, platform=platform)
+        layer.apply(context)
+        return context
+
+    def test_gcc_excludes_at_compile_time(self):
+        """Test GCC gets the exclusion list and the runtime does not."""
+        context = self._apply("gcc")
+
+        assert "-finstrument-functions" in context.compile_flags
+        assert (
+            "-finstrument-functions-exclude-function-list=std::,Logger::"
+            in context.compile_flags
+        )
+        runtime = context.cmake_variables["TOOLCHAINKIT_INSTRUMENT_RUNTIME"]
+        assert runtime.endswith("runtime/instrument/tk_instrument.cpp")
+        definitions = context.cmake_variables[
+            "TOOLCHAINKIT_INSTRUMENT_DEFINITIONS"
+        ].split(";")
+        assert definitions == [
+            "TK_INSTRUMENT_DEFAULT_FORMAT=folded",
+            "TK_INSTRUMENT_DEFAULT_SAMPLE=10",
+            "TK_INSTRUMENT_DEFAULT_SIGNAL=0",
+        ]
+
+    def test_clang_excludes_at_run_time(self):
+        """Test Clang instruments after inlining and the runtime filters."""
+        context = self._apply("clang")
+
+        assert "-finstrument-functions-after-inlining" in context.compile_flags
+        assert "-finstrument-functions" not in context.compile_flags
+        assert not any("exclude" in f for f in context.compile_flags)
+        assert (
+            "TK_INSTRUMENT_DEFAULT_EXCLUDE=std::,Logger::"
+            in (context.cmake_variables["TOOLCHAINKIT_INSTRUMENT_DEFINITIONS"])
+        )
+
+    def test_no_runtime_on_windows(self):
+        """Test targets without a runtime build get the flags only."""
+        context = self._apply("clang", platform="windows-x64")
+
+        assert "TOOLCHAINKIT_INSTRUMENT_RUNTIME" not in context.cmake_variables
+
+    def test_runtime_disabled(self):
+        """Test runtime: false leaves the hooks to the project."""
+        layer = ProfilingLayer(
+            name="instrument-functions",
+            profiling_type="instrument_functions",
+            instrument={"runtime": False},
+        )
+        context = LayerContext(compiler="gcc", platform="linux-x64")
+        layer.apply(context)
+
+        assert context.cmake_variables == {}
+
+    @pytest.mark.parametrize(
+        "instrument", [{"output_format": "pprof"}, {"sample": 0}, {"sample": "10"}]
+    )
+    def test_invalid_settings(self, instrument):
+        """Test invalid output formats and sampling rates are rejected."""
+        with pytest.raises(ValueError, match="Invalid instrument"):
+            ProfilingLayer(
+                name="instrument-functions",
+                profiling_type="instrument_functions",
+                instrument=instrument,
+            )
+
+    def test_toolchain_file_links_runtime(self, tmp_path):
+        """Test the generated toolchain file builds and links the runtime."""
+        generator = CMakeToolchainGenerator(tmp_path)
+        toolchain_file = generator.generate_from_layers(
+            [
+                {"type": "base", "name": "gcc-13"},
+                {"type": "platform", "name": "linux-x64"},
+                {"type": "buildtype", "name": "release"},
+                {"type": "profiling", "name": "instrument-functions"},
+            ],
+            "instrument-test",
+        )
+        content = toolchain_file.read_text()
+
+        assert "-finstrument-functions-exclude-function-list=std::,__gnu_cxx::" in (
+            content
+        )
+        assert "function(toolchainkit_instrument_runtime)" in content
+        assert "link_libraries(toolchainkit_instrument)" in content
+        assert "-fno-instrument-functions" in content
+
+
 class TestAsanProfile:
     """Test ASan profiling functionality."""
 
@@ -190,6 +298,62 @@ class TestPerf:
         assert "-g3" in context.compile_flags
 
 
+class TestOptRemarks:
+    """Test optimization remark profiling functionality."""
+
+    REMARKS = {
+        "flags": {
+            "clang": [
+                "-fsave-optimization-record",
+                "-foptimization-record-passes=inline",
+            ],
+            "gcc": ["-fsave-optimization-record", "-fopt-info-vec-missed"],
+        }
+    }
+
+    def test_flags_per_compiler(self):
+        """Test the compiler's remark flags go into a CMake variable."""
+        layer = ProfilingLayer(
+            name="opt-remarks", profiling_type="opt_remarks", remarks=self.REMARKS
+        )
+        context = LayerContext(compiler="gcc")
+        layer.apply(context)
+
+        assert context.cmake_variables["TOOLCHAINKIT_OPT_REMARKS_FLAGS"] == (
+            "-fsave-optimization-record;-fopt-info-vec-missed"
+        )
+        # Applied per target by the toolchain file, not globally
+        assert context.compile_flags == []
+
+    def test_unsupported_compiler(self):
+        """Test a compiler without remark flags is rejected."""
+        layer = ProfilingLayer(
+            name="opt-remarks", profiling_type="opt_remarks", remarks=self.REMARKS
+        )
+        with pytest.raises(LayerRequirementError, match="msvc"):
+            layer.apply(LayerContext(compiler="msvc"))
+
+    def test_toolchain_file_applies_flags_per_target(self, tmp_path):
+        """Test the generated toolchain file defines the per-target helper."""
+        generator = CMakeToolchainGenerator(tmp_path)
+        toolchain_file = generator.generate_from_layers(
+            [
+                {"type": "base", "name": "clang-18"},
+                {"type": "platform", "name": "linux-x64"},
+                {"type": "buildtype", "name": "release"},
+                {"type": "profiling", "name": "opt-remarks"},
+            ],
+            "remarks-test",
+        )
+        content = toolchain_file.read_text()
+
+        flags_init = [line for line in content.splitlines() if "FLAGS_INIT" in line]
+        assert "-fsave-optimization-record" in content
+        assert not any("-fsave-optimization-record" in line for line in flags_init)
+        assert "function(toolchainkit_opt_remarks)" in content
+        assert "TOOLCHAINKIT_OPT_REMARKS_TARGETS" in content
+
+
 class TestInvalidProfilingType:
     """Test invalid profiling types."""
 
@@ -0,0 +1,190 @@
+"""Tests for the optimization/startup layer."""
+
+import pytest
+
+from toolchainkit.cmake.toolchain_generator import CMakeToolchainGenerator
+from toolchainkit.config import LayerComposer
+from toolchainkit.config.layers import LayerContext, LinkerLayer, StartupLayer
+
+ALL_FEATURES = {
+    "hash_style": True,
+    "bind_now": True,
+    "bsymbolic_functions": True,
+    "relr": True,
+    "static_pie": True,
+}
+
+
+def _layer(**kwargs):
+    linkers = [
+        LinkerLayer("lld", "lld", "-fuse-ld=lld", features=ALL_FEATURES),
+        LinkerLayer(
+            "gold",
+            "gold",
+            "-fuse-ld=gold",
+            features={**ALL_FEATURES, "relr": False, "static_pie": False},
+        ),
+        LinkerLayer("ld", "ld", "-fuse-ld=ld", features=ALL_FEATURES),
+    ]
+    options = {
+        "visibility": "hidden",
+        "semantic_interposition": False,
+        "bsymbolic_functions": True,
+        "hash_style": "gnu",
+        "binding": "lazy",
+        "relr": True,
+        "linkers": linkers,
+    }
+    options.update(kwargs)
+    return StartupLayer("startup", **options)
+
+
+def _context(compiler="clang", platform="linux-x64", linker="lld"):
+    context = LayerContext(compiler=compiler, platform=platform)
+    context.compile_flags = ["-O2"]
+    if linker:
+        context.link_flags = [f"-fuse-ld={linker}"]
+    return context
+
+
+class TestStartupLayer:
+    """Test option selection from linker capabilities."""
+
+    def test_lld_enables_everything(self):
+        """Test all options with a linker that supports them."""
+        layer = _layer()
+        context = _context()
+        layer.apply(context)
+
+        assert "-fvisibility=hidden" in context.compile_flags
+        assert "-fvisibility-inlines-hidden" in context.compile_flags
+        assert "-fno-semantic-interposition" in context.compile_flags
+        assert context.link_flags == [
+            "-fuse-ld=lld",
+            "-Wl,--hash-style=gnu",
+            "-Wl,-z,lazy",
+            "-Wl,--pack-dyn-relocs=relr",
+        ]
+        assert context.cmake_variables["TOOLCHAINKIT_SHARED_LINKER_FLAGS"] == (
+            "-Wl,-Bsymbolic-functions"
+        )
+        assert layer.enabled == [
+            "visibility",
+            "semantic_interposition",
+            "bsymbolic_functions",
+            "hash_style",
+            "binding",
+            "relr",
+        ]
+
+    def test_unsupported_linker_features_are_skipped(self):
+        """Test gold gets no RELR or static PIE."""
+        layer = _layer(static_pie=True)
+        context = _context(linker="gold")
+        layer.apply(context)
+
+        assert "relr" not in layer.enabled
+        assert "static_pie" not in layer.enabled
+        assert "TOOLCHAINKIT_EXE_LINKER_FLAGS" not in context.cmake_variables
+        assert "-Wl,--hash-style=gnu" in context.link_flags
+
+    def test_default_linker_uses_generic_relr_flag(self):
+        """Test GNU ld (no -fuse-ld) gets -z pack-relative-relocs."""
+        layer = _layer()
+        context = _context(compiler="gcc", linker=None)
+        layer.apply(context)
+
+        assert "-Wl,-z,pack-relative-relocs" in context.link_flags
+
+    def test_static_pie(self):
+        """Test static PIE is an executable-only flag with PIC objects."""
+        layer = _layer(static_pie=True)
+        context = _context()
+        layer.apply(context)
+
+        assert context.cmake_variables["TOOLCHAINKIT_EXE_LINKER_FLAGS"] == "-static-pie"
+        assert context.cmake_variables["CMAKE_POSITION_INDEPENDENT_CODE"] == "ON"
+        assert "-static-pie" not in context.link_flags
+
+    def test_static_pie_skipped_with_sanitizers(self):
+        """Test sanitizer runtimes keep the binary dynamic."""
+        layer = _layer(static_pie=True)
+        context = _context()
+        context.sanitizers.add("address")
+        layer.apply(context)
+
+        assert "static_pie" not in layer.enabled
+
+    def test_lazy_binding_keeps_earlier_bind_now(self):
+        """Test -z now from a security layer wins over lazy binding."""
+        layer = _layer()
+        context = _context()
+        context.link_flags.append("-Wl,-z,now")
+        layer.apply(context)
+
+        assert "-Wl,-z,lazy" not in context.link_flags
+        assert "binding" not in layer.enabled
+
+    def test_macos_only_visibility(self):
+        """Test Mach-O targets get symbol visibility only."""
+        layer = _layer()
+        context = _context(platform="macos-arm64", linker=None)
+        layer.apply(context)
+
+        assert layer.enabled == ["visibility"]
+        assert context.link_flags == []
+
+    def test_msvc_is_noop(self):
+        """Test MSVC gets no GCC/Clang flags."""
+        layer = _layer()
+        context = _context(compiler="msvc", platform="windows-x64", linker=None)
+        layer.apply(context)
+
+        assert layer.enabled == []
+        assert context.compile_flags == ["-O2"]
+
+    def test_invalid_binding(self):
+        """Test binding must be now or lazy."""
+        with pytest.raises(ValueError, match="binding"):
+            _layer(binding="eager")
+
+
+class TestComposition:
+    """Test optimization/startup through the composer and toolchain generator."""
+
+    SPECS = [
+        {"type": "base", "name": "gcc-13"},
+        {"type": "platform", "name": "linux-x64"},
+        {"type": "buildtype", "name": "release"},
+    ]
+
+    def test_applied_after_linker(self):
+        """Test the layer sees a linker selected later in the list."""
+        config = LayerComposer().compose(
+            self.SPECS
+            + [
+                {"type": "optimization", "name": "startup"},
+                {"type": "linker", "name": "gold"},
+            ]
+        )
+
+        startup = config.layers[-1]
+        assert isinstance(startup, StartupLayer)
+        assert "-fuse-ld=gold" in config.link_flags
+        assert "-Wl,--hash-style=gnu" in config.link_flags
+        assert not any("relr" in f or "pack-relative" in f for f in config.link_flags)
+
+    def test_toolchain_file_appends_shared_flags(self, tmp_path):
+        """Test shared-library-only flags reach the shared linker flags only."""
+        generator = CMakeToolchainGenerator(tmp_path)
+        toolchain_file = generator.generate_from_layers(
+            self.SPECS + [{"type": "optimization", "name": "startup"}], "startup-test"
+        )
+        content = toolchain_file.read_text()
+
+        assert "-fno-semantic-interposition" in content
+        assert (
+            'string(APPEND CMAKE_SHARED_LINKER_FLAGS_INIT " '
+            '${TOOLCHAINKIT_SHARED_LINKER_FLAGS}")'
+        ) in content
+        assert 'EXE_LINKER_FLAGS_INIT " ${' not in content
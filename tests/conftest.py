@@ -40,6 +40,27 @@ def pytest_addoption(parser):
         default=False,
         help="run integration tests that require network access",
     )
+    parser.addoption(
+        "--benchmark",
+        action="store_true",
+        default=False,
+        help="run performance benchmarks in tests/benchmarks (use without -n)",
+    )
+    parser.addoption(
+        "--benchmark-json",
+        action="store",
+        default=None,
+        metavar="PATH",
+        help="write benchmark results to a JSON file (see tests/benchmarks/compare.py)",
+    )
+    parser.addoption(
+        "--benchmark-rounds",
+        action="store",
+        type=int,
+        default=None,
+        metavar="N",
+        help="samples per benchmark, overriding each benchmark's default",
+    )
     parser.addoption(
         "--link-validation",
         action="store_true",
@@ -77,6 +98,7 @@ def pytest_collection_modifyitems(config, items):
     """
     Skip integration tests unless --integration flag is provided.
     Skip link validation tests unless --link-validation flag is provided.
+    Skip benchmarks unless --benchmark flag is provided.
     """
     if not config.getoption("--integration"):
         skip_integration = pytest.mark.skip(reason="need --integration option to run")
@@ -90,6 +112,11 @@ def pytest_collection_modifyitems(config, items):
         for item in items:
             if "link_validation" in item.keywords:
                 item.add_marker(skip_link_validation)
+    if not config.getoption("--benchmark"):
+        skip_benchmark = pytest.mark.skip(reason="need --benchmark option to run")
+        for item in items:
+            if "benchmark" in item.keywords:
+                item.add_marker(skip_benchmark)
 
 
 def pytest_configure(config):
@@ -105,6 +132,10 @@ def pytest_configure(config):
         "markers",
         "link_validation: marks tests as link validation tests (requires --link-validation)",
     )
+    config.addinivalue_line(
+        "markers",
+        "benchmark: marks performance benchmarks (requires --benchmark)",
+    )
     config.addinivalue_line(
         "markers",
         "link_validation_slow: marks tests as slow link validation tests (full downloads)",
@@ -0,0 +1,294 @@
+"""
+Unit tests for offline bundles.
+
+Tests writing, reading and parallel unpacking of bundle components.
+"""
+
+import os
+import sys
+import tarfile
+import zipfile
+
+import pytest
+
+from toolchainkit.core import bundle as bundle_module
+from toolchainkit.core.bundle import (
+    BundleError,
+    BundleReader,
+    BundleWriter,
+    default_codec,
+)
+
+
+@pytest.fixture
+def tree(tmp_path):
+    """Small installation tree with nested, empty, large and linked entries."""
+    root = tmp_path / "src"
+    (root / "bin").mkdir(parents=True)
+    (root / "lib" / "empty").mkdir(parents=True)
+    (root / "bin" / "clang").write_bytes(os.urandom(300_000))
+    (root / "bin" / "clang").chmod(0o755)
+    (root / "lib" / "libc.a").write_bytes(b"archive" * 1000)
+    (root / "README").write_text("hello")
+    (root / "empty.txt").touch()
+    if sys.platform != "win32":
+        os.symlink("clang", root / "bin" / "clang++")
+    return root
+
+
+def write_bundle(path, source, **kwargs):
+    """Write one toolchain component and return the bundle path."""
+    with BundleWriter(path, **kwargs) as writer:
+        writer.add_tree(
+            "toolchain", "llvm-18", source, root="toolchains/llvm-18", sha256="abc"
+        )
+    return path
+
+
+class TestRoundTrip:
+    """Test export and unpack of a component."""
+
+    @pytest.mark.parametrize("workers", [1, 4])
+    def test_extract_matches_source(self, tmp_path, tree, workers):
+        """Test unpacked files, modes, dirs and links match the source."""
+        path = write_bundle(tmp_path / "b.tkb", tree, frame_size=64 * 1024)
+        reader = BundleReader(path)
+        component = reader.get("llvm-18")
+
+        hashes = reader.extract(component, tmp_path / "out", workers=workers)
+
+        out = tmp_path / "out"
+        for rel in ("bin/clang", "lib/libc.a", "README", "empty.txt"):
+            assert (out / rel).read_bytes() == (tree / rel).read_bytes()
+        assert (out / "lib" / "empty").is_dir()
+        assert set(hashes) == {"bin/clang", "lib/libc.a", "README", "empty.txt"}
+        if sys.platform != "win32":
+            assert os.stat(out / "bin" / "clang").st_mode & 0o777 == 0o755
+            assert os.readlink(out / "bin" / "clang++") == "clang"
+
+    def test_index(self, tmp_path, tree):
+        """Test the index records the component and splits large files."""
+        path = write_bundle(tmp_path / "b.tkb", tree, frame_size=64 * 1024)
+
+        reader = BundleReader(path)
+        component = reader.components[0]
+
+        assert (component.kind, component.name, component.sha256) == (
+            "toolchain",
+            "llvm-18",
+            "abc",
+        )
+        assert component.root == "toolchains/llvm-18"
+        assert reader.codec.name == default_codec()
+        clang = next(f for f in component.files if f.path == "bin/clang")
+        assert len(clang.frames) == 5
+        assert component.compressed_size < component.total_size
+
+    def test_single_file(self, tmp_path):
+        """Test a single file can be added as a component."""
+        exe = tmp_path / "ninja"
+        exe.write_bytes(b"ninja binary")
+        with BundleWriter(tmp_path / "b.tkb") as writer:
+            writer.add_tree("tool", "ninja", exe, root="tools")
+
+        reader = BundleReader(tmp_path / "b.tkb")
+        reader.extract(reader.get("ninja", kind="tool"), tmp_path / "out")
+
+        assert (tmp_path / "out" / "ninja").read_bytes() == b"ninja binary"
+
+
+class TestArchives:
+    """Test transcoding archives and partial reads."""
+
+    @pytest.mark.parametrize("mode", ["w:gz", "w:xz"])
+    def test_tar_matches_source(self, tmp_path, tree, mode):
+        """Test a transcoded tar unpacks like the archive, hard links included."""
+        archive = tmp_path / "llvm.tar"
+        (tree / "bin" / "clang-18").hardlink_to(tree / "bin" / "clang")
+        with tarfile.open(archive, mode) as tar:
+            tar.add(tree, arcname="./llvm-18")
+        with BundleWriter(tmp_path / "b.tkb", frame_size=64 * 1024, workers=2) as w:
+            w.add_archive("archive", "llvm.tar", archive, "llvm.tar", sha256="abc")
+
+        reader = BundleReader(tmp_path / "b.tkb")
+        component = reader.get("llvm.tar", kind="archive")
+        reader.extract(component, tmp_path / "out")
+
+        out = tmp_path / "out" / "llvm-18"
+        for rel in ("bin/clang", "bin/clang-18", "lib/libc.a", "README", "empty.txt"):
+            assert (out / rel).read_bytes() == (tree / rel).read_bytes()
+        assert (out / "lib" / "empty").is_dir()
+        assert component.sha256 == "abc"
+        clang, clang_18 = (
+            next(f for f in component.files if f.path == f"llvm-18/bin/{name}")
+            for name in ("clang", "clang-18")
+        )
+        assert clang_18.frames == clang.frames
+        if sys.platform != "win32":
+            assert os.stat(out / "bin" / "clang").st_mode & 0o777 == 0o755
+            assert os.readlink(out / "bin" / "clang++") == "clang"
+
+    def test_zip(self, tmp_path):
+        """Test a transcoded zip archive."""
+        archive = tmp_path / "tool.zip"
+        with zipfile.ZipFile(archive, "w") as zf:
+            zf.writestr("tool/", "")
+            zf.writestr("tool/bin/run.exe", b"MZ" * 1000)
+        with BundleWriter(tmp_path / "b.tkb") as writer:
+            writer.add_archive("archive", "tool.zip", archive, "tool.zip")
+
+        reader = BundleReader(tmp_path / "b.tkb")
+        reader.extract(reader.get("tool.zip"), tmp_path / "out")
+
+        assert (tmp_path / "out" / "tool" / "bin" / "run.exe").read_bytes() == (
+            b"MZ" * 1000
+        )
+
+    def test_not_an_archive(self, tmp_path):
+        """Test transcoding garbage raises BundleError."""
+        junk = tmp_path / "junk.tar.xz"
+        junk.write_bytes(b"not an archive")
+
+        with pytest.raises(BundleError, match="junk.tar.xz"):
+            with BundleWriter(tmp_path / "b.tkb") as writer:
+                writer.add_archive("archive", "junk", junk, "junk")
+        assert not (tmp_path / "b.tkb").exists()
+
+    def test_member_filter_and_progress(self, tmp_path, tree):
+        """Test a filtered unpack writes and reports only the kept files."""
+        path = write_bundle(tmp_path / "b.tkb", tree)
+        reader = BundleReader(path)
+        progress = []
+
+        hashes = reader.extract(
+            reader.get("llvm-18"),
+            tmp_path / "out",
+            member_filter=lambda rel: not rel.startswith("bin"),
+            progress_callback=lambda done, total: progress.append((done, total)),
+        )
+
+        assert set(hashes) == {"lib/libc.a", "README", "empty.txt"}
+        assert not (tmp_path / "out" / "bin").exists()
+        assert progress[-1] == (7005, 7005)
+
+    def test_read_single_file(self, tmp_path, tree):
+        """Test reading one file decodes and verifies only that file."""
+        path = write_bundle(tmp_path / "b.tkb", tree, frame_size=64 * 1024)
+        reader = BundleReader(path)
+        component = reader.get("llvm-18")
+
+        assert (
+            reader.read(component, "bin/clang") == (tree / "bin" / "clang").read_bytes()
+        )
+        with pytest.raises(BundleError, match="no file"):
+            reader.read(component, "bin/missing")
+        next(f for f in component.files if f.path == "README").sha256 = "0" * 64
+        with pytest.raises(BundleError, match="Checksum mismatch"):
+            reader.read(component, "README")
+
+
+class TestErrors:
+    """Test invalid and damaged bundles."""
+
+    def test_not_a_bundle(self, tmp_path):
+        """Test reading a non-bundle raises BundleError."""
+        path = tmp_path / "x.tkb"
+        path.write_bytes(b"not a bundle at all, not even close")
+
+        with pytest.raises(BundleError, match="Not a ToolchainKit bundle"):
+            BundleReader(path)
+
+    def test_truncated(self, tmp_path, tree):
+        """Test a bundle without its trailer is rejected."""
+        path = write_bundle(tmp_path / "b.tkb", tree)
+        path.write_bytes(path.read_bytes()[:-10])
+
+        with pytest.raises(BundleError):
+            BundleReader(path)
+
+    def test_corrupt_frame(self, tmp_path, tree):
+        """Test a damaged frame is detected while unpacking."""
+        path = write_bundle(tmp_path / "b.tkb", tree, codec="zlib")
+        reader = BundleReader(path)
+        component = reader.get("llvm-18")
+        offset, _ = next(f for f in component.files if f.path == "README").frames[0]
+        data = bytearray(path.read_bytes())
+        data[offset + 2] ^= 0xFF
+        path.write_bytes(bytes(data))
+
+        with pytest.raises(BundleError):
+            reader.extract(component, tmp_path / "out")
+
+    def test_checksum_mismatch(self, tmp_path, tree):
+        """Test a file whose recorded hash differs is rejected and removed."""
+        path = write_bundle(tmp_path / "b.tkb", tree)
+        reader = BundleReader(path)
+        component = reader.get("llvm-18")
+        next(f for f in component.files if f.path == "README").sha256 = "0" * 64
+
+        with pytest.raises(BundleError, match="Checksum mismatch for README"):
+            reader.extract(component, tmp_path / "out")
+        assert not (tmp_path / "out" / "README").exists()
+
+    def test_path_traversal(self, tmp_path, tree):
+        """Test paths escaping the destination are refused."""
+        path = write_bundle(tmp_path / "b.tkb", tree)
+        reader = BundleReader(path)
+        component = reader.get("llvm-18")
+        component.files[0].path = "../../evil"
+
+        with pytest.raises(BundleError, match="directory traversal"):
+            reader.extract(component, tmp_path / "out")
+        assert not (tmp_path / "evil").exists()
+
+    @pytest.mark.skipif(sys.platform == "win32", reason="Needs symlinks")
+    @pytest.mark.parametrize(
+        "links, match",
+        [
+            ([("a", "/etc"), ("a/x", "y")], "points outside"),
+            ([("bin/up", "../../outside")], "points outside"),
+            ([("a", "bin"), ("a/x", "clang")], "symbolic link"),
+        ],
+    )
+    def test_hostile_links(self, tmp_path, tree, links, match):
+        """Test links pointing out of the destination or nested in links."""
+        path = write_bundle(tmp_path / "b.tkb", tree)
+        reader = BundleReader(path)
+        component = reader.get("llvm-18")
+        component.links = links
+
+        with pytest.raises(BundleError, match=match):
+            reader.extract(component, tmp_path / "out")
+        assert not (tmp_path / "out" / "bin" / "x").exists()
+
+    @pytest.mark.skipif(sys.platform == "win32", reason="Needs symlinks")
+    def test_existing_link_in_destination(self, tmp_path, tree):
+        """Test members are not written through links already unpacked."""
+        outside = tmp_path / "outside"
+        outside.mkdir()
+        out = tmp_path / "out"
+        out.mkdir()
+        os.symlink(outside, out / "bin")
+        reader = BundleReader(write_bundle(tmp_path / "b.tkb", tree))
+
+        with pytest.raises(BundleError, match="symbolic link"):
+            reader.extract(reader.get("llvm-18"), out)
+        assert list(outside.iterdir()) == []
+
+    def test_zstd_unavailable(self, tmp_path, monkeypatch):
+        """Test zstd without the zstandard package raises BundleError."""
+        monkeypatch.setattr(bundle_module, "_zstd_module", lambda: None)
+
+        assert default_codec() == "zlib"
+        with pytest.raises(BundleError, match="zstandard"):
+            BundleWriter(tmp_path / "b.tkb", codec="zstd")
+
+    def test_abort_removes_file(self, tmp_path, tree):
+        """Test an exception while writing deletes the partial bundle."""
+        path = tmp_path / "b.tkb"
+        with pytest.raises(RuntimeError):
+            with BundleWriter(path) as writer:
+                writer.add_tree("toolchain", "x", tree, root="toolchains/x")
+                raise RuntimeError("interrupted")
+
+        assert not path.exists()
@@ -266,6 +266,23 @@ class TestProjectReferences:
         # Should not raise exception
         registry.remove_project_reference("test-tc", Path("/nonexistent"))
 
+    def test_set_project_toolchain_moves_reference(self, tmp_path):
+        """Test a configured project references only its current toolchain."""
+        registry = ToolchainCacheRegistry(tmp_path / "registry.json")
+        for tc_id in ("old-tc", "new-tc"):
+            registry.register_toolchain(
+                tc_id, Path("/test"), 100.0, "sha256:x", "http://x"
+            )
+        registry.add_project_reference("old-tc", Path("/project1"))
+        registry.add_project_reference("old-tc", Path("/project2"))
+
+        assert registry.set_project_toolchain("new-tc", Path("/project1"))
+
+        project1 = str(Path("/project1").resolve())
+        assert registry.get_toolchain_info("new-tc")["projects"] == [project1]
+        assert project1 not in registry.get_toolchain_info("old-tc")["projects"]
+        assert not registry.set_project_toolchain("missing", Path("/project1"))
+
 
 class TestUnusedDetection:
     """Test unused toolchain detection."""
@@ -353,6 +370,76 @@ class TestStatistics:
         assert stats["unused_toolchains"] == 2
         assert stats["reclaimable_size_mb"] == 750.0
 
+    def test_byte_accounting(self, tmp_path):
+        """Test sizes in bytes for toolchains and artifacts."""
+        registry = ToolchainCacheRegistry(tmp_path / "registry.json")
+
+        registry.register_toolchain(
+            "tc1", Path("/tc1"), 1.0, "sha256:a", "http://a", size_bytes=1000
+        )
+        registry.register_toolchain("tc2", Path("/tc2"), 2.0, "sha256:b", "http://b")
+        registry.add_project_reference("tc1", Path("/project"))
+        registry.register_artifact(tmp_path / "llvm.tar.xz", "download", 300)
+        registry.register_artifact(tmp_path / "rpi-11", "sysroot", 200)
+
+        stats = registry.get_cache_stats()
+
+        assert stats["toolchain_bytes"] == 1000 + 2 * 1024 * 1024
+        assert stats["artifact_bytes"] == {"download": 300, "sysroot": 200}
+        assert stats["total_bytes"] == stats["toolchain_bytes"] + 500
+        assert stats["reclaimable_bytes"] == 2 * 1024 * 1024
+
+    def test_artifacts(self, tmp_path):
+        """Test registering, touching and removing artifacts."""
+        registry = ToolchainCacheRegistry(tmp_path / "registry.json")
+        archive = tmp_path / "llvm.tar.xz"
+
+        registry.register_artifact(archive, "download", 300)
+        before = registry.list_artifacts()[str(archive.resolve())]["last_used"]
+
+        assert registry.touch_artifact(archive)
+        assert not registry.touch_artifact(tmp_path / "missing")
+        after = registry.list_artifacts()[str(archive.resolve())]["last_used"]
+        assert after >= before
+
+        registry.unregister_artifact(archive)
+        assert registry.list_artifacts() == {}
+
+    def test_components(self, tmp_path):
+        """Test recording and extending a partial installation."""
+        registry = ToolchainCacheRegistry(tmp_path / "registry.json")
+        patterns = {"compiler": ["bin/clang"], "bolt": ["bin/llvm-bolt"]}
+        registry.register_toolchain(
+            "tc1",
+            tmp_path / "tc1",
+            1.0,
+            "sha256:a",
+            "http://a",
+            size_bytes=1000,
+            components=["compiler"],
+            component_patterns=patterns,
+        )
+
+        assert registry.find_toolchain(tmp_path / "tc1") == "tc1"
+        assert registry.find_toolchain(tmp_path / "other") is None
+
+        registry.add_components("tc1", ["bolt"], 500)
+        info = registry.get_toolchain_info("tc1")
+        assert info["components"] == ["bolt", "compiler"]
+        assert info["component_patterns"] == patterns
+        assert info["size_bytes"] == 1500
+        assert registry.get_cache_stats()["toolchain_bytes"] == 1500
+
+    def test_update_last_used_returns_entry(self, tmp_path):
+        """Test update_last_used returns the entry for cached installs."""
+        registry = ToolchainCacheRegistry(tmp_path / "registry.json")
+        registry.register_toolchain(
+            "tc1", Path("/tc1"), 1.0, "sha256:a", "http://a", size_bytes=1000
+        )
+
+        assert registry.update_last_used("tc1")["size_bytes"] == 1000
+        assert registry.update_last_used("missing") is None
+
     def test_mark_cleanup(self, tmp_path):
         """Test marking cleanup timestamp."""
         registry = ToolchainCacheRegistry(tmp_path / "registry.json")
@@ -496,6 +583,80 @@ class TestLocking:
                 with registry._lock():
                     pass
 
+    def test_lock_is_reentrant(self, tmp_path):
+        """Test registry methods can be called while the lock is held."""
+        registry = ToolchainCacheRegistry(tmp_path / "registry.json", lock_timeout=1)
+
+        with registry.lock():
+            registry.register_toolchain(
+                "test-tc", tmp_path / "tc", 1.0, "sha256:x", "http://x"
+            )
+            assert registry.get_toolchain_info("test-tc") is not None
+
+
+class TestTransactions:
+    """Test batched registry updates."""
+
+    def test_single_write(self, tmp_path):
+        """Test all changes in a transaction are written once."""
+        registry = ToolchainCacheRegistry(tmp_path / "registry.json")
+
+        from toolchainkit.core import cache_registry
+
+        with patch.object(
+            cache_registry, "atomic_write", wraps=cache_registry.atomic_write
+        ) as write:
+            with registry.transaction():
+                for i in range(3):
+                    registry.register_toolchain(
+                        f"tc-{i}", tmp_path / f"tc-{i}", 1.0, "sha256:x", "http://x"
+                    )
+                registry.add_project_reference("tc-0", tmp_path / "project")
+                registry.unregister_toolchain("tc-2")
+                # Changes are visible inside the transaction
+                assert registry.list_toolchains() == ["tc-0", "tc-1"]
+                assert not registry.registry_path.exists()
+
+        assert write.call_count == 1
+        data = json.loads(registry.registry_path.read_text())
+        assert sorted(data["toolchains"]) == ["tc-0", "tc-1"]
+        assert data["toolchains"]["tc-0"]["projects"] == [
+            str((tmp_path / "project").resolve())
+        ]
+
+    def test_rollback_on_error(self, tmp_path):
+        """Test nothing is written when the transaction raises."""
+        registry = ToolchainCacheRegistry(tmp_path / "registry.json")
+        registry.register_toolchain("kept", tmp_path / "k", 1.0, "sha256:x", "x")
+
+        with pytest.raises(ToolchainNotInCacheError):
+            with registry.transaction():
+                registry.unregister_toolchain("kept")
+                registry.add_project_reference("missing", tmp_path / "project")
+
+        assert registry.list_toolchains() == ["kept"]
+
+    def test_other_threads_wait(self, tmp_path):
+        """Test other threads do not see uncommitted changes."""
+        import threading
+
+        registry = ToolchainCacheRegistry(tmp_path / "registry.json")
+        seen = []
+
+        def register():
+            registry.register_toolchain("b", tmp_path / "b", 1.0, "sha256:x", "x")
+            seen.append(registry.list_toolchains())
+
+        with registry.transaction():
+            registry.register_toolchain("a", tmp_path / "a", 1.0, "sha256:x", "x")
+            thread = threading.Thread(target=register)
+            thread.start()
+            thread.join(0.3)
+            assert thread.is_alive()  # blocked on the registry lock
+
+        thread.join()
+        assert seen == [["a", "b"]]
+
 
 class TestErrorHandling:
     """Test error handling."""
@@ -17,6 +17,9 @@ from toolchainkit.core.download import (
     DownloadError,
     ChecksumError,
     StreamingHasher,
+    get_session,
+    progress_listener,
+    _with_listener,
 )
 
 
@@ -348,7 +351,7 @@ class TestDownloadFile:
         def request_callback(request):
             assert "Range" in request.headers
             assert request.headers["Range"] == f"bytes={partial_size}-"
-            return (200, {}, full_content[partial_size:])
+            return (206, {}, full_content[partial_size:])
 
         responses.add_callback(
             responses.GET,
@@ -500,3 +503,43 @@ class TestDownloadFile:
 
 if __name__ == "__main__":
     pytest.main([__file__, "-v"])
+
+
+class TestSharedSession:
+    """Test the shared session and thread-local progress listener."""
+
+    def test_session_is_shared(self):
+        """Test downloads reuse one session."""
+        assert get_session() is get_session()
+
+    @responses.activate
+    def test_progress_listener(self, tmp_path):
+        """Test a listener sees downloads alongside the explicit callback."""
+        url = "https://example.com/file.bin"
+        content = b"x" * 1000
+        responses.add(
+            responses.GET,
+            url,
+            body=content,
+            status=200,
+            headers={"content-length": str(len(content))},
+        )
+        heard, explicit = [], []
+
+        with progress_listener(heard.append):
+            download_file(url, tmp_path / "file.bin", progress_callback=explicit.append)
+
+        assert heard and heard[-1].bytes_downloaded == len(content)
+        assert [p.bytes_downloaded for p in explicit] == [
+            p.bytes_downloaded for p in heard
+        ]
+
+    def test_listener_is_restored(self):
+        """Test nested listeners restore the previous one."""
+        outer, inner = object(), object()
+
+        with progress_listener(outer):
+            with progress_listener(inner):
+                assert _with_listener(None) is inner
+            assert _with_listener(None) is outer
+        assert _with_listener(None) is None
@@ -0,0 +1,58 @@
+"""
+Tests for the process-wide parsed file cache.
+"""
+
+import json
+import os
+
+import pytest
+
+from toolchainkit.core.filecache import clear_file_cache, load_cached
+
+
+def parse(path):
+    parse.calls += 1
+    return json.loads(path.read_text())
+
+
+parse.calls = 0
+
+
+@pytest.fixture(autouse=True)
+def reset():
+    clear_file_cache()
+    parse.calls = 0
+    yield
+    clear_file_cache()
+
+
+def test_reuses_until_file_changes(tmp_path):
+    path = tmp_path / "data.json"
+    path.write_text('{"a": 1}')
+
+    first = load_cached(path, parse)
+    assert load_cached(path, parse) is first
+    assert parse.calls == 1
+
+    path.write_text('{"a": 22}')
+    os.utime(path, ns=(0, 10**9))
+    assert load_cached(path, parse) == {"a": 22}
+    assert parse.calls == 2
+
+
+def test_errors_are_not_cached(tmp_path):
+    path = tmp_path / "data.json"
+    path.write_text("{")
+    for _ in range(2):
+        with pytest.raises(json.JSONDecodeError):
+            load_cached(path, parse)
+    assert parse.calls == 2
+
+
+def test_clear(tmp_path):
+    path = tmp_path / "data.json"
+    path.write_text("[]")
+    load_cached(path, parse)
+    clear_file_cache()
+    load_cached(path, parse)
+    assert parse.calls == 2
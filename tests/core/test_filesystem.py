@@ -485,6 +485,19 @@ class TestArchiveExtraction:
         assert (dest / "file.txt").exists()
         assert (dest / "file.txt").read_text() == "Content"
 
+    def test_extract_with_member_filter(
+        self, temp_dir, sample_zip_archive, sample_tar_gz_archive
+    ):
+        """Test that a member filter skips members of zip and tar archives."""
+        for archive in (sample_zip_archive, sample_tar_gz_archive):
+            dest = temp_dir / f"filtered-{archive.name}"
+            extract_archive(
+                archive, dest, member_filter=lambda name: "subdir" not in name
+            )
+
+            assert (dest / "file1.txt").read_text() == "Content 1"
+            assert not (dest / "subdir" / "file2.txt").exists()
+
 
 # ============================================================================
 # Safe File Operations Tests
@@ -0,0 +1,142 @@
+"""
+Unit tests for the hashing engine.
+
+Tests single-file, multi-digest, parallel and fast-mode hashing.
+"""
+
+import hashlib
+
+import pytest
+
+from toolchainkit.core import hashing
+from toolchainkit.core.hashing import (
+    MMAP_THRESHOLD,
+    fast_algorithm,
+    hash_file,
+    hash_file_multi,
+    hash_files,
+    new_hasher,
+    update_from_file,
+)
+
+
+@pytest.fixture(params=["small", "large"])
+def data_file(request, tmp_path):
+    """File below or above the mmap threshold."""
+    size = 10_000 if request.param == "small" else MMAP_THRESHOLD + 12345
+    data = bytes(range(256)) * (size // 256) + b"tail"
+    path = tmp_path / f"{request.param}.bin"
+    path.write_bytes(data)
+    return path, data
+
+
+class TestHashFile:
+    """Test hash_file and hash_file_multi."""
+
+    def test_matches_hashlib(self, data_file):
+        """Test digests match hashlib for read and mmap paths."""
+        path, data = data_file
+
+        assert hash_file(path) == hashlib.sha256(data).hexdigest()
+        assert hash_file(path, "sha512") == hashlib.sha512(data).hexdigest()
+
+    def test_multi_digest(self, data_file):
+        """Test several digests from one read."""
+        path, data = data_file
+
+        digests = hash_file_multi(path, ["sha256", "md5", "sha1"])
+
+        assert digests == {
+            "sha256": hashlib.sha256(data).hexdigest(),
+            "md5": hashlib.md5(data).hexdigest(),
+            "sha1": hashlib.sha1(data).hexdigest(),
+        }
+
+    def test_progress(self, data_file):
+        """Test progress reaches the file size."""
+        path, data = data_file
+        calls = []
+
+        hash_file(path, progress_callback=lambda done, total: calls.append(done))
+
+        assert calls[-1] == len(data)
+
+    def test_empty_file(self, tmp_path):
+        """Test an empty file hashes like empty bytes."""
+        path = tmp_path / "empty"
+        path.touch()
+
+        assert hash_file(path) == hashlib.sha256(b"").hexdigest()
+
+    def test_small_read_size(self, data_file):
+        """Test a custom read size gives the same digest."""
+        path, data = data_file
+
+        assert hash_file(path, read_size=1000) == hashlib.sha256(data).hexdigest()
+
+    def test_update_existing_hasher(self, tmp_path):
+        """Test feeding a file to a hasher that already has data."""
+        path = tmp_path / "part"
+        path.write_bytes(b"world")
+        hasher = hashlib.sha256(b"hello ")
+
+        update_from_file(hasher, path)
+
+        assert hasher.hexdigest() == hashlib.sha256(b"hello world").hexdigest()
+
+    def test_unsupported_algorithm(self, tmp_path):
+        """Test unknown algorithms raise ValueError."""
+        with pytest.raises(ValueError, match="Unsupported hash algorithm"):
+            new_hasher("nope")
+
+    def test_missing_file(self, tmp_path):
+        """Test a missing file raises OSError."""
+        with pytest.raises(OSError):
+            hash_file(tmp_path / "missing")
+
+
+class TestHashFiles:
+    """Test parallel hashing of many files."""
+
+    def test_parallel_matches_serial(self, tmp_path):
+        """Test parallel results match per-file hashes, in input order."""
+        paths = []
+        for i in range(20):
+            path = tmp_path / f"f{i}"
+            path.write_bytes(str(i).encode() * 1000)
+            paths.append(path)
+
+        result = hash_files(paths, workers=4)
+
+        assert list(result) == paths
+        assert result == {p: hashlib.sha256(p.read_bytes()).hexdigest() for p in paths}
+
+
+class TestFastMode:
+    """Test the fast non-cryptographic mode."""
+
+    def test_falls_back_to_sha256(self, tmp_path, monkeypatch):
+        """Test fast mode uses SHA256 without blake3 or xxhash."""
+        monkeypatch.setattr(hashing, "_blake3", lambda: None)
+        monkeypatch.setattr(hashing, "_xxh3_128", lambda: None)
+        path = tmp_path / "f"
+        path.write_bytes(b"data")
+
+        assert fast_algorithm() == "sha256"
+        assert hash_file(path, "fast") == hashlib.sha256(b"data").hexdigest()
+
+    def test_prefers_installed_backend(self, monkeypatch):
+        """Test an installed xxhash is selected."""
+
+        class FakeXXH3:
+            def update(self, data):
+                pass
+
+            def hexdigest(self):
+                return "0" * 32
+
+        monkeypatch.setattr(hashing, "_blake3", lambda: None)
+        monkeypatch.setattr(hashing, "_xxh3_128", lambda: FakeXXH3)
+
+        assert fast_algorithm() == "xxh3_128"
+        assert isinstance(new_hasher("fast"), FakeXXH3)
@@ -0,0 +1,184 @@
+"""
+Unit tests for integrity manifests.
+
+Tests manifest creation, stat-cached verification and deep verification.
+"""
+
+import hashlib
+import os
+
+import pytest
+
+from toolchainkit.core.manifest import (
+    MANIFEST_NAME,
+    IntegrityManifest,
+    ManifestError,
+    find_manifest,
+    write_manifest,
+)
+
+
+@pytest.fixture
+def install_dir(tmp_path):
+    """Create a small installation tree with a manifest."""
+    root = tmp_path / "llvm-18"
+    (root / "bin").mkdir(parents=True)
+    (root / "lib").mkdir()
+    (root / "bin" / "clang").write_bytes(b"clang binary")
+    (root / "lib" / "libc++.a").write_bytes(b"x" * 4096)
+    write_manifest(root)
+    return root
+
+
+class TestCreate:
+    """Test manifest creation."""
+
+    def test_records_hash_size_and_mtime(self, install_dir):
+        """Test every file is recorded with its hash, size and mtime."""
+        manifest = IntegrityManifest.load(install_dir)
+        entry = manifest.entries["bin/clang"]
+
+        assert set(manifest.entries) == {"bin/clang", "lib/libc++.a"}
+        assert entry.sha256 == hashlib.sha256(b"clang binary").hexdigest()
+        assert entry.size == 12
+        assert entry.mtime_ns == (install_dir / "bin" / "clang").stat().st_mtime_ns
+        assert manifest.total_size == 12 + 4096
+
+    def test_manifest_not_recorded(self, install_dir):
+        """Test the manifest file does not list itself."""
+        assert (install_dir / MANIFEST_NAME).exists()
+        assert MANIFEST_NAME not in IntegrityManifest.load(install_dir).entries
+
+    def test_symlink_recorded_as_target(self, tmp_path):
+        """Test symbolic links store their target instead of content."""
+        (tmp_path / "clang-18").write_bytes(b"clang")
+        try:
+            (tmp_path / "clang").symlink_to("clang-18")
+        except (OSError, NotImplementedError):
+            pytest.skip("Symlinks not supported on this system")
+
+        manifest = IntegrityManifest.create(tmp_path)
+
+        assert manifest.entries["clang"].sha256 == "link:clang-18"
+
+    def test_load_missing(self, tmp_path):
+        """Test loading a directory without a manifest returns None."""
+        assert IntegrityManifest.load(tmp_path) is None
+
+    def test_load_invalid(self, tmp_path):
+        """Test an unreadable manifest raises ManifestError."""
+        (tmp_path / MANIFEST_NAME).write_text("{not json")
+
+        with pytest.raises(ManifestError):
+            IntegrityManifest.load(tmp_path)
+
+
+class TestVerify:
+    """Test verification against a manifest."""
+
+    def test_warm_verify_hashes_nothing(self, install_dir):
+        """Test unchanged files are trusted from their stat data."""
+        result = IntegrityManifest.load(install_dir).verify()
+
+        assert result.ok
+        assert result.checked == 2
+        assert result.rehashed == 0
+
+    def test_deep_verify_hashes_everything(self, install_dir):
+        """Test deep mode re-hashes every file."""
+        result = IntegrityManifest.load(install_dir).verify(deep=True, workers=2)
+
+        assert result.ok
+        assert result.rehashed == 2
+
+    def test_modified_file(self, install_dir):
+        """Test a file with new content is reported."""
+        (install_dir / "bin" / "clang").write_bytes(b"patched binary")
+
+        result = IntegrityManifest.load(install_dir).verify()
+
+        assert not result.ok
+        assert result.modified == ["bin/clang"]
+        assert "1 modified" in result.summary()
+
+    def test_same_size_tamper_caught_by_deep(self, install_dir):
+        """Test content changes hidden behind restored stat data need deep mode."""
+        clang = install_dir / "bin" / "clang"
+        st = clang.stat()
+        clang.write_bytes(b"CLANG BINARY")
+        os.utime(clang, ns=(st.st_atime_ns, st.st_mtime_ns))
+        manifest = IntegrityManifest.load(install_dir)
+
+        assert manifest.verify().ok
+        assert manifest.verify(deep=True).modified == ["bin/clang"]
+
+    def test_touched_file_refreshes_stat(self, install_dir):
+        """Test a touched but unchanged file is re-hashed once when updating."""
+        clang = install_dir / "bin" / "clang"
+        st = clang.stat()
+        os.utime(clang, ns=(st.st_atime_ns, st.st_mtime_ns + 10**9))
+
+        first = IntegrityManifest.load(install_dir).verify(update=True)
+        second = IntegrityManifest.load(install_dir).verify()
+
+        assert first.ok and first.rehashed == 1
+        assert second.ok and second.rehashed == 0
+
+    def test_verify_leaves_manifest_alone(self, install_dir):
+        """Test a plain check does not write the manifest."""
+        manifest_file = install_dir / MANIFEST_NAME
+        before = manifest_file.read_bytes()
+        clang = install_dir / "bin" / "clang"
+        st = clang.stat()
+        os.utime(clang, ns=(st.st_atime_ns, st.st_mtime_ns + 10**9))
+
+        assert IntegrityManifest.load(install_dir).verify().ok
+        assert manifest_file.read_bytes() == before
+
+    def test_missing_and_unexpected(self, install_dir):
+        """Test removed and added files are reported."""
+        (install_dir / "lib" / "libc++.a").unlink()
+        (install_dir / "bin" / "injected").write_bytes(b"?")
+
+        result = IntegrityManifest.load(install_dir).verify()
+
+        assert result.missing == ["lib/libc++.a"]
+        assert result.unexpected == ["bin/injected"]
+
+    def test_unexpected_files_only_fail_strict(self, install_dir):
+        """Test added files such as __pycache__ are only a difference if strict."""
+        (install_dir / "lib" / "__pycache__").mkdir()
+        (install_dir / "lib" / "__pycache__" / "x.pyc").write_bytes(b"?")
+        manifest = IntegrityManifest.load(install_dir)
+
+        result = manifest.verify()
+        assert result.ok
+        assert result.unexpected == ["lib/__pycache__/x.pyc"]
+        assert "1 unexpected file(s) ignored" in result.summary()
+        assert not manifest.verify(strict=True).ok
+
+
+class TestFileHash:
+    """Test single-file lookups used by lock file verification."""
+
+    def test_cached_hash(self, install_dir):
+        """Test a file's hash comes from the manifest."""
+        manifest = find_manifest(install_dir / "bin" / "clang")
+
+        assert manifest.file_hash(install_dir / "bin" / "clang") == (
+            hashlib.sha256(b"clang binary").hexdigest()
+        )
+
+    def test_changed_file_rehashed(self, install_dir):
+        """Test a file with changed stat data is hashed again."""
+        (install_dir / "bin" / "clang").write_bytes(b"new")
+        manifest = IntegrityManifest.load(install_dir)
+
+        assert manifest.file_hash(install_dir / "bin" / "clang") == (
+            hashlib.sha256(b"new").hexdigest()
+        )
+
+    def test_find_manifest_stops(self, install_dir):
+        """Test the search does not go above stop_at."""
+        assert find_manifest(install_dir / "bin", stop_at=install_dir / "bin") is None
+        assert find_manifest(install_dir / "bin" / "clang") is not None
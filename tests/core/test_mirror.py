@@ -0,0 +1,280 @@
+"""
+Tests for mirror-aware downloads and the download mirror server.
+
+Every source is a real local HTTP server: the MirrorServer itself, and a
+scriptable origin that can be slow, cut transfers short, ignore Range or
+serve corrupted bytes.
+"""
+
+import hashlib
+import threading
+import time
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+
+import pytest
+import requests
+
+from toolchainkit.core import download
+from toolchainkit.core.download import (
+    ChecksumError,
+    DownloadError,
+    download_file,
+    get_mirrors,
+    mirror_urls,
+    rank_mirrors,
+    set_mirrors,
+)
+from toolchainkit.core.mirror import MirrorServer, parse_range, summarize_directory
+
+CONTENT = bytes(range(256)) * 2048  # 512 KiB
+SHA256 = hashlib.sha256(CONTENT).hexdigest()
+
+
+class ScriptedServer:
+    """Local HTTP origin with configurable misbehaviour."""
+
+    def __init__(
+        self,
+        content=CONTENT,
+        delay=0.0,
+        cut_after=None,
+        ignore_range=False,
+        status=200,
+    ):
+        self.content = content
+        self.delay = delay
+        self.cut_after = cut_after
+        self.ignore_range = ignore_range
+        self.status = status
+        self.requests = []
+        server = self
+
+        class Handler(BaseHTTPRequestHandler):
+            protocol_version = "HTTP/1.1"
+
+            def log_message(self, *args):
+                pass
+
+            def do_GET(self):
+                server.requests.append(self.headers.get("Range"))
+                time.sleep(server.delay)
+                if server.status != 200:
+                    self.send_response(server.status)
+                    self.send_header("Content-Length", "0")
+                    self.end_headers()
+                    return
+                data = server.content
+                first = 0
+                range_header = self.headers.get("Range")
+                if range_header and not server.ignore_range:
+                    first, last = parse_range(range_header, len(data))
+                    self.send_response(206)
+                    self.send_header(
+                        "Content-Range", f"bytes {first}-{last}/{len(data)}"
+                    )
+                    data = data[first : last + 1]
+                else:
+                    self.send_response(200)
+                self.send_header("Content-Length", str(len(data)))
+                self.end_headers()
+                if server.cut_after is not None and first == 0 and not range_header:
+                    self.wfile.write(data[: server.cut_after])
+                    self.close_connection = True
+                    return
+                self.wfile.write(data)
+
+        self._httpd = ThreadingHTTPServer(("127.0.0.1", 0), Handler)
+        self._httpd.daemon_threads = True
+        self.url = f"http://127.0.0.1:{self._httpd.server_address[1]}/file.tar.xz"
+        threading.Thread(target=self._httpd.serve_forever, daemon=True).start()
+
+    @property
+    def downloads(self):
+        """Requests other than mirror probes."""
+        return [r for r in self.requests if r != f"bytes=0-{download.PROBE_BYTES - 1}"]
+
+    def close(self):
+        self._httpd.shutdown()
+        self._httpd.server_close()
+
+
+@pytest.fixture(autouse=True)
+def clean_mirror_state(monkeypatch):
+    """Forget measurements and configured mirrors between tests."""
+    monkeypatch.delenv(download.MIRRORS_ENV, raising=False)
+    download._mirror_stats.clear()
+    set_mirrors(None)
+    yield
+    download._mirror_stats.clear()
+    set_mirrors(None)
+
+
+@pytest.fixture
+def servers():
+    started = []
+
+    def start(**kwargs):
+        server = ScriptedServer(**kwargs)
+        started.append(server)
+        return server
+
+    yield start
+    for server in started:
+        server.close()
+
+
+@pytest.fixture
+def mirror(tmp_path):
+    root = tmp_path / "mirror"
+    root.mkdir()
+    (root / "file.tar.xz").write_bytes(CONTENT)
+    with MirrorServer(root, port=0).start() as server:
+        yield server
+
+
+class TestParseRange:
+    def test_open_ended(self):
+        assert parse_range("bytes=100-", 1000) == (100, 999)
+
+    def test_bounded_and_clamped(self):
+        assert parse_range("bytes=0-99", 1000) == (0, 99)
+        assert parse_range("bytes=900-5000", 1000) == (900, 999)
+
+    def test_suffix(self):
+        assert parse_range("bytes=-100", 1000) == (900, 999)
+
+    def test_unsatisfiable(self):
+        assert parse_range("bytes=1000-", 1000) is None
+        assert parse_range("bytes=5-1", 1000) is None
+        assert parse_range("bytes=0-1,5-9", 1000) is None
+
+
+class TestMirrorServer:
+    def test_serves_file_and_ranges(self, mirror):
+        url = mirror.url + "file.tar.xz"
+        full = requests.get(url, timeout=5)
+        assert full.status_code == 200
+        assert full.content == CONTENT
+        assert full.headers["Accept-Ranges"] == "bytes"
+
+        part = requests.get(url, headers={"Range": "bytes=1000-1999"}, timeout=5)
+        assert part.status_code == 206
+        assert part.content == CONTENT[1000:2000]
+        assert part.headers["Content-Range"] == f"bytes 1000-1999/{len(CONTENT)}"
+
+    def test_unsatisfiable_range(self, mirror):
+        response = requests.get(
+            mirror.url + "file.tar.xz",
+            headers={"Range": f"bytes={len(CONTENT)}-"},
+            timeout=5,
+        )
+        assert response.status_code == 416
+
+    def test_missing_and_hidden_files(self, mirror):
+        (mirror.root / ".partial").write_bytes(b"x")
+        for path in ("missing.zip", ".partial", "../mirror/file.tar.xz", ""):
+            assert requests.get(mirror.url + path, timeout=5).status_code == 404
+
+    def test_head(self, mirror):
+        response = requests.head(mirror.url + "file.tar.xz", timeout=5)
+        assert response.status_code == 200
+        assert int(response.headers["Content-Length"]) == len(CONTENT)
+
+    def test_summarize_directory(self, mirror):
+        assert summarize_directory(mirror.root) == (1, len(CONTENT))
+
+
+class TestMirrorConfiguration:
+    def test_env_mirrors(self, monkeypatch):
+        monkeypatch.setenv(download.MIRRORS_ENV, "http://a:1, http://b:2/")
+        assert get_mirrors() == ["http://a:1", "http://b:2/"]
+        assert mirror_urls("https://github.com/x/y/clang.tar.xz") == [
+            "http://a:1/clang.tar.xz",
+            "http://b:2/clang.tar.xz",
+            "https://github.com/x/y/clang.tar.xz",
+        ]
+
+    def test_set_mirrors_overrides_env(self, monkeypatch):
+        monkeypatch.setenv(download.MIRRORS_ENV, "http://a:1")
+        set_mirrors(["http://lan:8421"])
+        urls = mirror_urls("https://host/f.zip", mirrors=["https://cdn/f.zip"])
+        assert urls == [
+            "https://cdn/f.zip",
+            "http://lan:8421/f.zip",
+            "https://host/f.zip",
+        ]
+
+
+class TestMirrorDownloads:
+    def test_rank_prefers_fast_and_drops_missing(self, servers, mirror):
+        slow = servers(delay=0.3)
+        missing = servers(status=404)
+        ranked = rank_mirrors([slow.url, missing.url, mirror.url + "file.tar.xz"])
+        assert ranked == [mirror.url + "file.tar.xz", slow.url]
+
+    def test_downloads_from_fastest_mirror(self, servers, mirror, tmp_path):
+        origin = servers(delay=0.3)
+        set_mirrors([mirror.url])
+        dest = download_file(origin.url, tmp_path / "f", expected_sha256=SHA256)
+        assert dest.read_bytes() == CONTENT
+        assert origin.downloads == []
+
+    def test_no_mirrors_without_hash(self, servers, tmp_path):
+        origin = servers(delay=0.2)
+        evil = servers(content=b"\0" * len(CONTENT))
+        set_mirrors([evil.url.rsplit("/", 1)[0]])
+        dest = download_file(origin.url, tmp_path / "f", mirrors=[evil.url])
+        assert dest.read_bytes() == CONTENT
+        assert evil.requests == []
+
+    def test_failover_keeps_received_bytes(self, servers, tmp_path):
+        origin = servers(delay=0.2)
+        flaky = servers(cut_after=200_000)
+        dest = download_file(
+            origin.url, tmp_path / "f", expected_sha256=SHA256, mirrors=[flaky.url]
+        )
+        assert dest.read_bytes() == CONTENT
+        # Whole chunks received before the cut are kept
+        (resumed,) = origin.downloads
+        assert resumed == f"bytes={3 * download.DOWNLOAD_CHUNK_SIZE}-"
+
+    def test_corrupt_mirror_is_dropped(self, servers, tmp_path):
+        origin = servers(delay=0.2)
+        evil = servers(content=b"\0" * len(CONTENT))
+        dest = download_file(
+            origin.url, tmp_path / "f", expected_sha256=SHA256, mirrors=[evil.url]
+        )
+        assert dest.read_bytes() == CONTENT
+        assert origin.downloads == [None]
+
+    def test_corrupt_origin_still_fails(self, servers, tmp_path):
+        origin = servers(content=b"\0" * len(CONTENT))
+        with pytest.raises(ChecksumError):
+            download_file(origin.url, tmp_path / "f", expected_sha256=SHA256)
+
+    def test_source_ignoring_range_restarts(self, servers, tmp_path):
+        flaky = servers(cut_after=100_000)
+        origin = servers(delay=0.2, ignore_range=True)
+        dest = download_file(
+            origin.url, tmp_path / "f", expected_sha256=SHA256, mirrors=[flaky.url]
+        )
+        assert dest.read_bytes() == CONTENT
+
+    def test_single_source_ignoring_range_restarts(
+        self, servers, tmp_path, monkeypatch
+    ):
+        monkeypatch.setattr(download.time, "sleep", lambda s: None)
+        origin = servers(cut_after=100_000, ignore_range=True)
+        dest = download_file(origin.url, tmp_path / "f")
+        assert dest.read_bytes() == CONTENT
+        assert origin.downloads[0] is None
+        assert origin.downloads[1].startswith("bytes=")
+
+    def test_all_sources_down(self, servers, tmp_path, monkeypatch):
+        monkeypatch.setattr(download.time, "sleep", lambda s: None)
+        origin = servers(status=503)
+        other = servers(status=503)
+        with pytest.raises(DownloadError):
+            download_file(
+                origin.url, tmp_path / "f", mirrors=[other.url], max_retries=2
+            )
@@ -0,0 +1,154 @@
+"""
+Tests for phase tracing.
+"""
+
+import json
+import threading
+
+import pytest
+
+from toolchainkit.core import tracing
+
+
+@pytest.fixture
+def tracer():
+    tracer = tracing.enable()
+    yield tracer
+    tracing.disable()
+
+
+@pytest.fixture
+def clock(monkeypatch):
+    """Span clock that only advances when told to; returns advance(ms)."""
+    now = [0]
+
+    def advance(ms):
+        now[0] += ms * 1_000_000
+
+    monkeypatch.setattr(tracing.time, "perf_counter_ns", lambda: now[0])
+    return advance
+
+
+def by_name(tracer):
+    return {event["name"]: event for event in tracer.events}
+
+
+def test_disabled_spans_record_nothing():
+    assert tracing.get_tracer() is None
+    with tracing.span("phase", size=1) as span:
+        span.set(result="ok")
+    tracing.annotate(ignored=True)
+
+    @tracing.traced("decorated")
+    def decorated():
+        return 42
+
+    assert decorated() == 42
+    assert tracing.span("phase") is tracing.span("other")
+
+
+def test_nested_spans_and_self_time(clock, tracer):
+    with tracing.span("outer", "test", project="demo"):
+        clock(10)
+        with tracing.span("inner") as span:
+            clock(20)
+            span.set(bytes=10)
+
+    events = by_name(tracer)
+    outer, inner = events["outer"], events["inner"]
+    assert outer["cat"] == "test"
+    assert outer["args"] == {"project": "demo"}
+    assert inner["args"] == {"bytes": 10}
+    assert inner["ts"] >= outer["ts"]
+    assert (outer["dur"], inner["dur"]) == (30_000, 20_000)
+    assert outer["self"] == 10_000
+    assert inner["self"] == inner["dur"]
+
+
+def test_error_is_recorded(tracer):
+    with pytest.raises(ValueError), tracing.span("failing"):
+        raise ValueError("boom")
+    assert by_name(tracer)["failing"]["args"] == {"error": "ValueError"}
+
+
+def test_traced_and_annotate(tracer):
+    @tracing.traced("download", "network")
+    def download(url):
+        tracing.annotate(url=url)
+        return url.upper()
+
+    assert download("a") == "A"
+    assert download.__name__ == "download"
+    event = by_name(tracer)["download"]
+    assert event["cat"] == "network"
+    assert event["args"] == {"url": "a"}
+
+
+def test_acquired_traces_wait_and_hold(tracer):
+    lock = threading.Lock()
+    lock.acquire()
+    threading.Timer(0.02, lock.release).start()
+
+    with tracing.acquired(lock, "registry") as held:
+        assert held is lock
+        assert lock.locked()
+    assert not lock.locked()
+
+    events = by_name(tracer)
+    assert events["lock wait: registry"]["dur"] >= 10_000
+    assert events["lock hold: registry"]["cat"] == "lock"
+
+
+def test_acquired_without_tracer():
+    lock = threading.Lock()
+    with tracing.acquired(lock, "registry"):
+        assert lock.locked()
+    assert not lock.locked()
+
+
+def test_spans_from_threads(tracer):
+    def work():
+        with tracing.span("worker"):
+            pass
+
+    with tracing.span("main"):
+        threads = [threading.Thread(target=work) for _ in range(3)]
+        for thread in threads:
+            thread.start()
+        for thread in threads:
+            thread.join()
+
+    main = by_name(tracer)["main"]
+    assert main["self"] == main["dur"]
+    assert len([e for e in tracer.events if e["name"] == "worker"]) == 3
+
+
+def test_chrome_trace(tracer, tmp_path):
+    with tracing.span("phase", path=tmp_path):
+        pass
+
+    path = tracer.write_chrome_trace(tmp_path / "out" / "trace.json")
+    data = json.loads(path.read_text())
+    metadata, event = data["traceEvents"]
+    assert metadata["ph"] == "M"
+    assert event["ph"] == "X"
+    assert event["name"] == "phase"
+    assert event["pid"] == tracer.pid
+    assert event["args"] == {"path": str(tmp_path)}
+
+
+def test_totals_and_summary(clock, tracer):
+    for _ in range(3):
+        with tracing.span("repeated"):
+            clock(1)
+    with tracing.span("slow"):
+        clock(10)
+
+    totals = tracer.totals()
+    assert [t["name"] for t in totals] == ["slow", "repeated"]
+    assert totals[1]["count"] == 3
+
+    summary = tracer.summary(limit=1)
+    assert "Self ms" in summary
+    assert "slow" in summary
+    assert "1 more span names" in summary
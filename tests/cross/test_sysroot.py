@@ -118,6 +118,32 @@ class TestSysrootDownload:
         mock_download.assert_called_once()
         mock_extract.assert_called_once()
 
+    @patch("toolchainkit.cross.sysroot.download_file")
+    @patch("toolchainkit.cross.sysroot.extract_archive")
+    def test_download_is_accounted(self, mock_extract, mock_download, temp_dir):
+        """Test that sysroots are recorded in the cache registry for the quota."""
+        manager = SysrootManager(temp_dir)
+        spec = SysrootSpec(
+            target="test-target",
+            version="1.0",
+            url="https://example.com/sysroot.tar.gz",
+            hash="abc123",
+        )
+
+        def mock_extract_side_effect(archive_path, destination, **kwargs):
+            (destination / "usr").mkdir(parents=True)
+            (destination / "usr" / "libc.so").write_bytes(b"x" * 100)
+
+        mock_extract.side_effect = mock_extract_side_effect
+
+        result = manager.download_sysroot(spec)
+        artifact = manager.registry.list_artifacts()[str(result.resolve())]
+        assert artifact["kind"] == "sysroot"
+        assert artifact["size_bytes"] == 100
+
+        manager.remove_sysroot("test-target", "1.0")
+        assert manager.registry.list_artifacts() == {}
+
     def test_download_existing_skips(self, temp_dir):
         """Test that existing sysroot is not re-downloaded."""
         manager = SysrootManager(temp_dir)
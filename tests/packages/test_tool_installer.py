@@ -0,0 +1,204 @@
+"""
+Unit tests for the concurrent build tool installer.
+
+Tests dependency ordering, concurrency, failure handling and aggregated
+progress using fake downloaders.
+"""
+
+import threading
+
+import pytest
+
+from toolchainkit.core.download import DownloadProgress, _with_listener
+from toolchainkit.core.platform import PlatformInfo
+from toolchainkit.packages.tool_installer import (
+    InstallProgress,
+    ToolInstaller,
+    ToolProgress,
+    ToolSpec,
+)
+
+
+@pytest.fixture
+def platform():
+    """Linux x64 platform."""
+    return PlatformInfo(
+        os="linux",
+        arch="x64",
+        os_version="5.15",
+        distribution="ubuntu",
+        abi="glibc-2.31",
+    )
+
+
+class FakeDownloader:
+    """Downloader that records calls and reports fake download progress."""
+
+    def __init__(self, name, tools_dir, log, installed=False, fail=False, hook=None):
+        self.name = name
+        self.tools_dir = tools_dir
+        self.log = log
+        self.installed = installed
+        self.fail = fail
+        self.hook = hook
+
+    def is_installed(self):
+        return self.installed
+
+    def download(self, **kwargs):
+        self.log.append((self.name, kwargs))
+        if self.hook:
+            self.hook()
+        if self.fail:
+            raise RuntimeError(f"{self.name} broke")
+        callback = _with_listener(None)
+        if callback:
+            callback(DownloadProgress(50, 100, 50.0, 0, 0))
+            callback(DownloadProgress(100, 100, 100.0, 0, 0))
+        return self.get_executable_path()
+
+    def get_executable_path(self):
+        return self.tools_dir / self.name / "bin" / self.name
+
+
+def make_specs(log, deps=None, **options):
+    """Fake specs for tools a, b, c with optional dependencies and options."""
+    deps = deps or {}
+    return {
+        name: ToolSpec(
+            lambda d, p, name=name: FakeDownloader(
+                name, d, log, **options.get(name, {})
+            ),
+            tuple(deps.get(name, ())),
+        )
+        for name in ("a", "b", "c")
+    }
+
+
+class TestToolInstaller:
+    """Test ToolInstaller scheduling."""
+
+    def test_installs_all(self, tmp_path, platform):
+        """Test every requested tool is installed with its path."""
+        log = []
+        installer = ToolInstaller(tmp_path, platform, specs=make_specs(log))
+
+        results = installer.install(["a", "b", "c"])
+
+        assert list(results) == ["a", "b", "c"]
+        assert all(r.success for r in results.values())
+        assert results["b"].path == tmp_path / "b" / "bin" / "b"
+        assert sorted(name for name, _ in log) == ["a", "b", "c"]
+
+    def test_installs_concurrently(self, tmp_path, platform):
+        """Test independent tools are installed at the same time."""
+        barrier = threading.Barrier(3, timeout=5)
+        log = []
+        specs = make_specs(log, **{n: {"hook": barrier.wait} for n in ("a", "b", "c")})
+
+        results = ToolInstaller(tmp_path, platform, max_workers=3, specs=specs).install(
+            ["a", "b", "c"]
+        )
+
+        assert all(r.success for r in results.values())
+
+    def test_dependency_installed_first(self, tmp_path, platform):
+        """Test a missing dependency is added and installed before its dependent."""
+        log = []
+        specs = make_specs(log, deps={"a": ["c"]})
+
+        results = ToolInstaller(tmp_path, platform, max_workers=4, specs=specs).install(
+            ["a"]
+        )
+
+        assert list(results) == ["c", "a"]
+        assert [name for name, _ in log] == ["c", "a"]
+
+    def test_failed_dependency_skips_dependent(self, tmp_path, platform):
+        """Test a tool is skipped when its dependency fails."""
+        log = []
+        specs = make_specs(log, deps={"a": ["b"]}, b={"fail": True})
+
+        results = ToolInstaller(tmp_path, platform, specs=specs).install(
+            ["a", "b", "c"]
+        )
+
+        assert not results["b"].success
+        assert "b broke" in results["b"].error
+        assert not results["a"].success
+        assert "dependency failed: b" in results["a"].error
+        assert results["c"].success
+        assert "a" not in [name for name, _ in log]
+
+    def test_already_installed(self, tmp_path, platform):
+        """Test installed tools are not downloaded again."""
+        log = []
+        specs = make_specs(log, a={"installed": True})
+
+        results = ToolInstaller(tmp_path, platform, specs=specs).install(["a"])
+
+        assert results["a"].success
+        assert results["a"].already_installed
+        assert log == []
+
+    def test_unknown_tool(self, tmp_path, platform):
+        """Test unknown tool names raise ValueError."""
+        installer = ToolInstaller(tmp_path, platform, specs=make_specs([]))
+
+        with pytest.raises(ValueError, match="Unknown tool: nope"):
+            installer.install(["nope"])
+
+    def test_dependency_cycle(self, tmp_path, platform):
+        """Test cyclic dependencies raise ValueError."""
+        specs = make_specs([], deps={"a": ["b"], "b": ["a"]})
+
+        with pytest.raises(ValueError, match="Dependency cycle"):
+            ToolInstaller(tmp_path, platform, specs=specs).install(["a"])
+
+    def test_hermetic_conan_waits_for_python(self, tmp_path, platform):
+        """Test Conan depends on Python and gets the hermetic flag."""
+        log = []
+        specs = {
+            name: ToolSpec(lambda d, p, name=name: FakeDownloader(name, d, log))
+            for name in ("python", "conan")
+        }
+
+        ToolInstaller(tmp_path, platform, hermetic_python=True, specs=specs).install(
+            ["conan"]
+        )
+
+        assert log == [("python", {}), ("conan", {"use_hermetic_python": True})]
+
+
+class TestInstallProgress:
+    """Test aggregated progress reporting."""
+
+    def test_progress_reaches_done(self, tmp_path, platform):
+        """Test download progress is aggregated and every tool ends done."""
+        snapshots = []
+
+        def record(progress):
+            snapshots.append(
+                (progress.finished, progress.bytes_downloaded, progress.total_bytes)
+            )
+
+        ToolInstaller(tmp_path, platform, specs=make_specs([])).install(
+            ["a", "b"], progress_callback=record
+        )
+
+        assert snapshots[-1] == (2, 200, 200)
+        assert any(done < 200 for _, done, _ in snapshots)
+
+    def test_summary(self):
+        """Test the status line lists active tools."""
+        progress = InstallProgress(
+            tools={
+                "cmake": ToolProgress("downloading", 512 * 1024, 1024 * 1024),
+                "ninja": ToolProgress("done", 256 * 1024, 256 * 1024),
+                "sccache": ToolProgress("installing", 0, 0),
+                "git": ToolProgress("pending"),
+            }
+        )
+
+        assert progress.finished == 1
+        assert progress.summary() == ("[1/4] 0.8/1.2 MB  cmake 50%, sccache installing")
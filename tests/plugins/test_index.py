@@ -0,0 +1,156 @@
+"""
+Tests for the persistent plugin manifest index.
+"""
+
+import os
+import warnings
+
+import pytest
+
+from toolchainkit.plugins import PluginDiscoverer, PluginValidationError
+from toolchainkit.plugins.index import PluginIndex
+from toolchainkit.plugins.metadata import PluginMetadataParser
+
+MANIFEST = """
+name: {name}
+version: {version}
+type: compiler
+description: Test plugin
+author: Test Author
+entry_point: test_module.TestClass
+provides:
+  compilers: [{name}]
+"""
+
+
+class CountingParser(PluginMetadataParser):
+    """Parser recording which manifests it parsed."""
+
+    def __init__(self):
+        self.parsed = []
+
+    def parse_file(self, yaml_path):
+        self.parsed.append(yaml_path.parent.name)
+        return super().parse_file(yaml_path)
+
+
+@pytest.fixture
+def plugins_dir(tmp_path):
+    directory = tmp_path / "plugins"
+    directory.mkdir()
+    return directory
+
+
+@pytest.fixture
+def index_path(tmp_path):
+    return tmp_path / "index.json"
+
+
+def write_plugin(directory, name, version="1.0.0"):
+    plugin_dir = directory / name
+    plugin_dir.mkdir(exist_ok=True)
+    manifest = plugin_dir / "plugin.yaml"
+    manifest.write_text(MANIFEST.format(name=name, version=version))
+    return manifest
+
+
+def scan(index_path, directory):
+    """Scan with a fresh index object, as a new process would."""
+    parser = CountingParser()
+    index = PluginIndex(index_path)
+    plugins = index.scan(directory, parser.parse_file)
+    index.save()
+    return plugins, parser.parsed
+
+
+class TestPluginIndex:
+    def test_unchanged_directory_is_not_parsed(self, plugins_dir, index_path):
+        write_plugin(plugins_dir, "alpha")
+        write_plugin(plugins_dir, "beta")
+        (plugins_dir / "not-a-plugin").mkdir()
+
+        plugins, parsed = scan(index_path, plugins_dir)
+        assert parsed == ["alpha", "beta"]
+        assert index_path.exists()
+
+        plugins, parsed = scan(index_path, plugins_dir)
+        assert parsed == []
+        assert [p.name for p in plugins] == ["alpha", "beta"]
+        assert plugins[0].plugin_dir == plugins_dir / "alpha"
+        assert plugins[0].provides == {"compilers": ["alpha"]}
+
+    def test_changed_manifest_is_reparsed(self, plugins_dir, index_path):
+        manifest = write_plugin(plugins_dir, "alpha")
+        scan(index_path, plugins_dir)
+
+        manifest.write_text(MANIFEST.format(name="alpha", version="2.0.0"))
+        os.utime(manifest, ns=(0, 10**9))
+        plugins, parsed = scan(index_path, plugins_dir)
+        assert parsed == ["alpha"]
+        assert plugins[0].version == "2.0.0"
+
+    def test_touched_manifest_is_rehashed_only(self, plugins_dir, index_path):
+        manifest = write_plugin(plugins_dir, "alpha")
+        scan(index_path, plugins_dir)
+
+        os.utime(manifest, ns=(0, 10**9))
+        plugins, parsed = scan(index_path, plugins_dir)
+        assert parsed == []
+        assert plugins[0].name == "alpha"
+
+    def test_added_and_removed_plugins(self, plugins_dir, index_path):
+        write_plugin(plugins_dir, "alpha")
+        scan(index_path, plugins_dir)
+
+        # New manifest in an existing subdirectory: no directory mtime change
+        (plugins_dir / "late").mkdir()
+        scan(index_path, plugins_dir)
+        write_plugin(plugins_dir, "late")
+        _, parsed = scan(index_path, plugins_dir)
+        assert parsed == ["late"]
+
+        (plugins_dir / "alpha" / "plugin.yaml").unlink()
+        (plugins_dir / "alpha").rmdir()
+        plugins, parsed = scan(index_path, plugins_dir)
+        assert [p.name for p in plugins] == ["late"]
+        assert parsed == []
+
+    def test_invalid_manifest_is_not_cached(self, plugins_dir, index_path):
+        (plugins_dir / "broken").mkdir()
+        (plugins_dir / "broken" / "plugin.yaml").write_text("name: broken\n")
+        errors = []
+
+        for _ in range(2):
+            index = PluginIndex(index_path)
+            parser = PluginMetadataParser()
+            plugins = index.scan(
+                plugins_dir, parser.parse_file, lambda path, e: errors.append(e)
+            )
+            index.save()
+            assert plugins == []
+
+        assert len(errors) == 2
+        assert all(isinstance(e, PluginValidationError) for e in errors)
+
+    def test_corrupt_index_is_rebuilt(self, plugins_dir, index_path):
+        write_plugin(plugins_dir, "alpha")
+        index_path.write_text("{not json")
+
+        _, parsed = scan(index_path, plugins_dir)
+        assert parsed == ["alpha"]
+        assert scan(index_path, plugins_dir)[1] == []
+
+
+class TestDiscovererUsesIndex:
+    def test_discover_in_directory(self, plugins_dir, index_path):
+        write_plugin(plugins_dir, "alpha")
+        (plugins_dir / "broken").mkdir()
+        (plugins_dir / "broken" / "plugin.yaml").write_text("name: broken\n")
+
+        discoverer = PluginDiscoverer(index=PluginIndex(index_path))
+        with warnings.catch_warnings(record=True) as caught:
+            warnings.simplefilter("always")
+            plugins = discoverer.discover_in_directory(plugins_dir)
+
+        assert [p.name for p in plugins] == ["alpha"]
+        assert any("Skipping invalid plugin" in str(w.message) for w in caught)
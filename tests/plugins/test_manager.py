@@ -9,6 +9,7 @@ import pytest
 
 from toolchainkit.plugins.manager import PluginManager
 from toolchainkit.plugins.metadata import PluginMetadata
+from toolchainkit.plugins.registry import PluginRegistry
 
 
 # Mock Objects
@@ -280,6 +281,67 @@ class TestDiscoverAndLoadAll:
         assert plugin_manager.get_loaded_plugins() == ["working-plugin"]
 
 
+# Test Lazy Loading
+
+
+class CompilerPlugin(MockPlugin):
+    """Mock plugin registering the compiler it declares."""
+
+    def initialize(self, context):
+        super().initialize(context)
+        context.register_compiler("zig", {"name": "zig"})
+
+
+class TestLazyLoading:
+    """Test plugins that declare capabilities are loaded on first use."""
+
+    @pytest.fixture
+    def lazy_metadata(self):
+        return PluginMetadata(
+            name="zig-compiler",
+            version="1.0.0",
+            type="compiler",
+            description="Zig",
+            author="Test Author",
+            entry_point="zig_plugin.ZigCompilerPlugin",
+            provides={"compilers": ["zig"]},
+        )
+
+    @pytest.fixture
+    def manager(self, lazy_metadata):
+        manager = PluginManager(registry=PluginRegistry())
+        manager.discoverer.discover = Mock(return_value=[lazy_metadata])
+        manager.loader.load = Mock(return_value=CompilerPlugin())
+        return manager
+
+    def test_plugin_imported_on_lookup(self, manager, lazy_metadata, tmp_path):
+        """Test the plugin module is only loaded when its compiler is needed."""
+        assert manager.discover_and_load_all(cache_base_dir=tmp_path) == 1
+        assert manager.registry.has_compiler("zig")
+        manager.loader.load.assert_not_called()
+        assert manager.get_loaded_plugins() == []
+
+        assert manager.registry.get_compiler("zig") == {"name": "zig"}
+        manager.loader.load.assert_called_once_with(lazy_metadata)
+        assert manager.get_loaded_plugins() == ["zig-compiler"]
+        assert (tmp_path / "zig-compiler").is_dir()
+
+    def test_eager_loading(self, manager, tmp_path):
+        """Test lazy=False loads declared plugins immediately."""
+        assert manager.discover_and_load_all(cache_base_dir=tmp_path, lazy=False) == 1
+        manager.loader.load.assert_called_once()
+        assert manager.get_loaded_plugins() == ["zig-compiler"]
+
+    def test_failing_deferred_plugin(self, manager, tmp_path):
+        """Test a deferred plugin failing to load surfaces as a missing entry."""
+        manager.loader.load = Mock(side_effect=Exception("Load failed"))
+        manager.discover_and_load_all(cache_base_dir=tmp_path)
+
+        with pytest.raises(KeyError):
+            manager.registry.get_compiler("zig")
+        manager.loader.load.assert_called_once()
+
+
 # Test Discover and Load One
 
 
@@ -642,6 +642,51 @@ another_unknown: 123
 
         assert metadata.name == "test"
 
+    def test_parse_provides(self, tmp_path):
+        """Test declared capabilities make the plugin lazy."""
+        yaml_file = tmp_path / "plugin.yaml"
+        yaml_file.write_text(
+            """
+name: zig-compiler
+version: 1.0.0
+type: compiler
+description: Zig
+author: Test
+entry_point: zig_plugin.ZigCompilerPlugin
+provides:
+  compilers: [zig]
+  backends: []
+""",
+            encoding="utf-8",
+        )
+
+        metadata = PluginMetadataParser().parse_file(yaml_file)
+
+        assert metadata.provides == {"compilers": ["zig"]}
+        assert metadata.is_lazy
+
+    @pytest.mark.parametrize(
+        "provides, message",
+        [
+            ("[zig]", "must be a dictionary"),
+            ("{linkers: [mold]}", "Unknown capability 'linkers'"),
+            ("{compilers: zig}", "'provides.compilers' must be a list"),
+        ],
+    )
+    def test_parse_invalid_provides(self, tmp_path, provides, message):
+        """Test malformed capability declarations are rejected."""
+        yaml_file = tmp_path / "plugin.yaml"
+        yaml_file.write_text(
+            "name: p\nversion: 1.0.0\ntype: compiler\ndescription: d\n"
+            f"author: a\nentry_point: m.C\nprovides: {provides}\n",
+            encoding="utf-8",
+        )
+
+        with pytest.raises(PluginValidationError) as exc_info:
+            PluginMetadataParser().parse_file(yaml_file)
+
+        assert message in str(exc_info.value)
+
 
 # ============================================================================
 # Test: PluginMetadataParser API
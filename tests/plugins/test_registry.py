@@ -353,6 +353,110 @@ class TestClearRegistry:
         assert registry.get_compiler("zig") is config2
 
 
+# ============================================================================
+# Test: Factory Registration
+# ============================================================================
+
+
+class TestFactoryRegistration:
+    """Test entries created on first lookup."""
+
+    def test_package_manager_factory_runs_once_on_lookup(self):
+        """Test factory is listed immediately but called only when looked up."""
+        registry = PluginRegistry()
+        calls = []
+
+        def factory():
+            calls.append(1)
+            return MockPackageManager("hunter")
+
+        registry.register_package_manager_factory("hunter", factory)
+        assert registry.has_package_manager("hunter")
+        assert registry.list_package_managers() == ["hunter"]
+        assert calls == []
+
+        manager = registry.get_package_manager("hunter")
+        assert registry.get_package_manager("hunter") is manager
+        assert calls == [1]
+
+    def test_factory_name_conflicts(self):
+        """Test factories and instances share one namespace."""
+        registry = PluginRegistry()
+        registry.register_compiler_strategy("zig", object())
+        with pytest.raises(ValueError):
+            registry.register_compiler_strategy_factory("zig", object)
+
+    def test_provider_factory_returning_none_is_dropped(self):
+        """Test unavailable providers are removed when providers are listed."""
+        registry = PluginRegistry()
+        provider = object()
+        registry.register_toolchain_provider_factory(lambda: None)
+        registry.register_toolchain_provider_factory(lambda: provider)
+
+        assert registry.get_toolchain_providers() == [provider]
+        assert registry.get_toolchain_providers() == [provider]
+
+
+class TestPluginLoaders:
+    """Test plugins loaded when a declared capability is first used."""
+
+    def test_plugin_loaded_on_first_lookup(self):
+        """Test declared names are visible but the plugin loads on lookup."""
+        registry = PluginRegistry()
+        calls = []
+
+        def load():
+            calls.append(1)
+            registry.register_compiler("zig", MockCompilerConfig("zig"))
+            registry.register_compiler_strategy("zig", "strategy")
+            registry.register_toolchain_provider("provider")
+
+        registry.register_plugin_loader(
+            {"compilers": ["zig"], "toolchain_providers": ["zig"]}, load
+        )
+        assert registry.has_compiler("zig")
+        assert registry.has_compiler_strategy("zig")
+        assert registry.list_compilers() == ["zig"]
+        assert calls == []
+
+        assert registry.get_compiler_strategy("zig") == "strategy"
+        assert registry.get_compiler("zig").name == "zig"
+        assert registry.get_toolchain_providers() == ["provider"]
+        assert registry.list_compiler_strategies() == ["zig"]
+        assert calls == [1]
+
+    def test_providers_listing_loads_provider_plugins(self):
+        """Test listing toolchain providers loads only plugins providing them."""
+        registry = PluginRegistry()
+        loaded = []
+        registry.register_plugin_loader(
+            {"toolchain_providers": ["zig"]}, lambda: loaded.append("zig")
+        )
+        registry.register_plugin_loader(
+            {"package_managers": ["hunter"]}, lambda: loaded.append("hunter")
+        )
+
+        registry.get_toolchain_providers()
+        assert loaded == ["zig"]
+        assert registry.list_package_managers() == ["hunter"]
+
+    def test_plugin_not_registering_declared_name(self):
+        """Test a plugin that does not register what it declared."""
+        registry = PluginRegistry()
+        registry.register_plugin_loader({"backends": ["meson"]}, lambda: None)
+
+        with pytest.raises(KeyError):
+            registry.get_backend("meson")
+        assert not registry.has_backend("meson")
+
+    def test_clear_forgets_pending_plugins(self):
+        """Test clear() drops plugins that were never loaded."""
+        registry = PluginRegistry()
+        registry.register_plugin_loader({"package_managers": ["hunter"]}, None)
+        registry.clear()
+        assert not registry.has_package_manager("hunter")
+
+
 # ============================================================================
 # Test: Global Registry
 # ============================================================================
@@ -0,0 +1,313 @@
+"""Tests for allocation traces, tkgen alloc-trace and the replay driver."""
+
+import json
+import os
+import shutil
+import struct
+import subprocess
+import sys
+from pathlib import Path
+
+import pytest
+
+import toolchainkit
+from toolchainkit.cli.parser import CLI
+from toolchainkit.profiling.alloc_trace import (
+    ALIGNED,
+    CALLOC,
+    FREE,
+    MALLOC,
+    REALLOC,
+    Event,
+    Trace,
+    TraceError,
+    format_summary,
+    merged_events,
+    read_trace,
+    summarize,
+    trim_trace,
+    write_trace,
+)
+
+RUNTIME_DIR = Path(toolchainkit.__file__).parent / "data" / "runtime" / "allocator"
+
+A, B, C, D = 0x7F0000001000, 0x7F0000002000, 0x7F0000003000, 0x7F0000000100
+
+
+def _sample_trace() -> Trace:
+    """Thread 0 allocates, thread 1 frees one of its blocks."""
+    return Trace(
+        start_ns=5_000,
+        threads={
+            0: [
+                Event(1_000, MALLOC, A, 100),
+                Event(2_000, CALLOC, B, 4000),
+                Event(3_000, ALIGNED, C, 64, alignment=4096),
+                Event(6_000, REALLOC, B, 8000, D),
+            ],
+            1: [
+                Event(500, FREE, 0x1234),  # Allocated before tracing
+                Event(4_000, FREE, A),
+                Event(7_000, FREE, C),
+            ],
+        },
+    )
+
+
+class TestTraceFile:
+    """Test reading and writing traces."""
+
+    @pytest.mark.parametrize("name", ["t.tkat", "t.tkat.gz", "t.tkat.xz"])
+    def test_roundtrip(self, tmp_path, name):
+        """Test plain and compressed traces read back unchanged."""
+        trace = _sample_trace()
+        write_trace(trace, tmp_path / name)
+
+        assert read_trace(tmp_path / name) == trace
+
+    def test_proxy_ticks_converted(self, tmp_path):
+        """Test tick times are converted with the frequency in the header."""
+        # start 1000 ticks, 0.5 ns per tick; chunk at tick 1100, one malloc
+        # 20 ticks later: size 16 at address 0x40
+        payload = bytes([MALLOC, 20, 16, 0x80, 0x01])
+        data = struct.pack("<4sIQdQ", b"TKAT", 1, 1000, 0.5, 0)
+        data += struct.pack("<IIQ", 7, len(payload), 1100) + payload
+        (tmp_path / "t.tkat").write_bytes(data + b"\x00\x00\x00")
+
+        trace = read_trace(tmp_path / "t.tkat")
+
+        assert trace.start_ns == 500
+        assert trace.threads == {7: [Event(60, MALLOC, 0x40, 16)]}
+
+    def test_not_a_trace(self, tmp_path):
+        """Test other files are rejected."""
+        (tmp_path / "t.tkat").write_bytes(b"TKAX" + bytes(28))
+
+        with pytest.raises(TraceError, match="not an allocation trace"):
+            read_trace(tmp_path / "t.tkat")
+
+    def test_corrupt_chunk(self, tmp_path):
+        """Test unknown events are reported."""
+        data = struct.pack("<4sIQdQ", b"TKAT", 1, 0, 1.0, 0)
+        data += struct.pack("<IIQ", 0, 2, 0) + bytes([7, 0])
+        (tmp_path / "t.tkat").write_bytes(data)
+
+        with pytest.raises(TraceError, match="Unknown trace event"):
+            read_trace(tmp_path / "t.tkat")
+
+
+class TestSummary:
+    """Test pairing frees with allocations across threads."""
+
+    def test_merged_order(self):
+        """Test events of all threads are merged in time order."""
+        times = [event.time for _, event in merged_events(_sample_trace())]
+
+        assert times == sorted(times)
+
+    def test_summarize(self):
+        """Test calls, bytes and cross-thread frees are counted."""
+        summary = summarize(_sample_trace())
+
+        assert summary.threads == 2
+        assert summary.events == 7
+        assert summary.calls == {
+            "malloc": 1,
+            "calloc": 1,
+            "aligned": 1,
+            "free": 3,
+            "realloc": 1,
+        }
+        assert summary.cross_thread_frees == 2
+        assert summary.unmatched_frees == 1
+        assert summary.peak_live_bytes == 8064  # After the realloc
+        assert summary.live_blocks_at_end == 1
+        assert summary.live_bytes_at_end == 8000
+        assert "Cross-thread frees: 2" in format_summary(summary)
+
+    def test_reused_address(self):
+        """Test an allocation at a live address frees the old block."""
+        trace = Trace(
+            threads={
+                0: [Event(1, MALLOC, A, 10), Event(3, MALLOC, A, 20)],
+                1: [Event(4, FREE, A)],
+            }
+        )
+        summary = summarize(trace)
+
+        assert summary.reordered == 1
+        assert summary.live_blocks_at_end == 0
+
+
+class TestTrim:
+    """Test cutting traces to a time window."""
+
+    def test_live_blocks_allocated_at_window_start(self):
+        """Test blocks live at the start are allocated on their thread."""
+        trimmed = trim_trace(_sample_trace(), start=3.5e-6, end=6.5e-6)
+
+        assert trimmed.start_ns == 8_500
+        assert trimmed.threads[0] == [
+            Event(0, MALLOC, A, 100),
+            Event(0, CALLOC, B, 4000),
+            Event(0, ALIGNED, C, 64, alignment=4096),
+            Event(2_500, REALLOC, B, 8000, D),
+        ]
+        assert trimmed.threads[1] == [Event(500, FREE, A)]
+        assert summarize(trimmed).cross_thread_frees == 1
+
+    def test_drop_live(self):
+        """Test frees of blocks allocated before the window are unmatched."""
+        trimmed = trim_trace(_sample_trace(), start=3.5e-6, keep_live=False)
+        summary = summarize(trimmed)
+
+        assert summary.events == 3
+        assert summary.unmatched_frees == 2
+
+
+class TestAllocTraceCommand:
+    """Test tkgen alloc-trace."""
+
+    def test_json_and_output(self, tmp_path, capsys):
+        """Test a window is summarized and written compressed."""
+        write_trace(_sample_trace(), tmp_path / "t.tkat")
+        output = tmp_path / "window.tkat.xz"
+
+        result = CLI().run(
+            [
+                "alloc-trace",
+                str(tmp_path / "t.tkat"),
+                "--start",
+                "3.5e-6",
+                "-o",
+                str(output),
+                "--json",
+            ]
+        )
+
+        assert result == 0
+        captured = capsys.readouterr()
+        assert json.loads(captured.out)["events"] == 6
+        assert "Trace:" not in captured.err  # Not the global --trace option
+        assert output.read_bytes()[:6] == b"\xfd7zXZ\x00"
+        assert summarize(read_trace(output)).events == 6
+
+    def test_invalid_window(self, tmp_path, capsys):
+        """Test --end must follow --start."""
+        write_trace(_sample_trace(), tmp_path / "t.tkat")
+
+        result = CLI().run(
+            ["alloc-trace", str(tmp_path / "t.tkat"), "--start", "2", "--end", "1"]
+        )
+
+        assert result == 1
+        assert "--end" in capsys.readouterr().err
+
+    def test_unreadable_trace(self, tmp_path, capsys):
+        """Test a missing trace is reported."""
+        assert CLI().run(["alloc-trace", str(tmp_path / "missing.tkat")]) == 1
+        assert "Cannot" in capsys.readouterr().err
+
+
+PROGRAM = r"""
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+__attribute__((noinline)) void* make_buffer(size_t size) {
+    void* p = malloc(size);
+    __asm__ __volatile__("" : : "r"(p) : "memory");
+    return p;
+}
+
+int main() {
+    std::vector<void*> blocks;
+    for (int i = 0; i < 2000; ++i) blocks.push_back(make_buffer(16 + i % 500));
+    std::thread consumer([&] {
+        for (void* p : blocks) free(p);
+    });
+    consumer.join();
+    void* p = nullptr;
+    if (posix_memalign(&p, 256, 100) != 0) return 1;
+    free(realloc(make_buffer(10), 5000));
+    free(p);
+    return 0;
+}
+"""
+
+
+@pytest.mark.skipif(
+    not sys.platform.startswith("linux") or shutil.which("g++") is None,
+    reason="Needs g++ on Linux",
+)
+class TestTraceAndReplay:
+    """Test tracing a program through the preloaded proxy and replaying it."""
+
+    def test_trace_and_replay(self, tmp_path):
+        """Test the replay makes the traced calls, with cross-thread frees."""
+        (tmp_path / "app.cpp").write_text(PROGRAM)
+        common = ["-O2", "-std=c++17", "-fno-builtin", "-Wall", "-Wextra", "-Werror"]
+        builds = [
+            [
+                *common,
+                "-fPIC",
+                "-shared",
+                "-fvisibility=hidden",
+                str(RUNTIME_DIR / "tk_malloc_proxy.cpp"),
+                "-o",
+                "libproxy.so",
+                "-ldl",
+            ],
+            [*common, str(RUNTIME_DIR / "tk_alloc_replay.cpp"), "-o", "replay"],
+            ["-O1", "-std=c++17", "app.cpp", "-o", "app"],
+        ]
+        for flags in builds:
+            result = subprocess.run(
+                ["g++", *flags, "-pthread"],
+                cwd=tmp_path,
+                capture_output=True,
+                text=True,
+                check=False,
+            )
+            assert result.returncode == 0, result.stderr
+
+        environment = {
+            name: value
+            for name, value in os.environ.items()
+            if not name.startswith("TOOLCHAINKIT_ALLOCATOR")
+        }
+        subprocess.run(
+            [str(tmp_path / "app")],
+            env={
+                **environment,
+                "LD_PRELOAD": str(tmp_path / "libproxy.so"),
+                "TOOLCHAINKIT_ALLOCATOR_TRACE": str(tmp_path / "app.%p.tkat"),
+            },
+            check=True,
+            timeout=60,
+        )
+        (trace_file,) = tmp_path.glob("app.*.tkat")
+        summary = summarize(read_trace(trace_file))
+
+        assert summary.threads >= 2
+        assert summary.calls["aligned"] >= 1
+        assert summary.calls["realloc"] >= 1
+        assert summary.cross_thread_frees >= 2000
+
+        output = subprocess.run(
+            [str(tmp_path / "replay"), "--json", "-"],
+            input=trace_file.read_bytes(),
+            env=environment,
+            capture_output=True,
+            check=True,
+            timeout=60,
+        ).stdout
+        replay = json.loads(output)
+
+        assert replay["threads"] == summary.threads
+        assert replay["cross_thread_frees"] == summary.cross_thread_frees
+        assert replay["unmatched_frees"] == summary.unmatched_frees
+        assert replay["calls"] == (
+            summary.events - summary.unmatched_frees + summary.reordered
+        )
+        assert replay["samples"]
@@ -0,0 +1,230 @@
+"""Tests for the allocator proxy runtime (built with the host g++)."""
+
+import json
+import os
+import shutil
+import subprocess
+import sys
+from pathlib import Path
+
+import pytest
+
+import toolchainkit
+
+RUNTIME_DIR = Path(toolchainkit.__file__).parent / "data" / "runtime" / "allocator"
+
+pytestmark = pytest.mark.skipif(
+    not sys.platform.startswith("linux") or shutil.which("g++") is None,
+    reason="Needs g++ on Linux",
+)
+
+PROGRAM = r"""
+#include "tk_malloc_proxy.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+
+__attribute__((noinline)) void* make_buffer(size_t size) {
+    void* p = malloc(size);
+    __asm__ __volatile__("" : : "r"(p) : "memory");
+    return p;
+}
+
+__attribute__((noinline)) int* make_array(size_t size) {
+    int* p = new int[size];
+    __asm__ __volatile__("" : : "r"(p) : "memory");
+    return p;
+}
+
+int main(int argc, char** argv) {
+    std::printf("%s\n", tk_malloc_proxy_allocator());
+    std::thread thread([] {
+        for (int i = 0; i < 1000; ++i) delete[] make_array(16);
+    });
+    for (int i = 0; i < 1000; ++i) free(make_buffer(100));
+    thread.join();
+
+    void* page = aligned_alloc(4096, 4096);
+    void* line = nullptr;
+    if (posix_memalign(&line, 256, 10) != 0 || uintptr_t(page) % 4096 != 0 ||
+        uintptr_t(line) % 256 != 0) {
+        return 1;
+    }
+    free(page);
+    free(line);
+    void* grown = realloc(realloc(nullptr, 10), 10000);
+    free(grown);
+
+    if (argc > 1) return tk_malloc_proxy_report(argv[1]) == 0 ? 0 : 2;
+    return 0;
+}
+"""
+
+# Forwards to glibc and counts the calls it receives
+TOY_ALLOCATOR = r"""
+#include <stdio.h>
+#include <stddef.h>
+#include <string.h>
+#include <unistd.h>
+
+extern void* __libc_malloc(size_t);
+extern void* __libc_calloc(size_t, size_t);
+extern void* __libc_realloc(void*, size_t);
+extern void* __libc_memalign(size_t, size_t);
+extern void __libc_free(void*);
+
+static unsigned long calls;
+
+void* malloc(size_t n) { __atomic_add_fetch(&calls, 1, 0); return __libc_malloc(n); }
+void* calloc(size_t n, size_t m) { __atomic_add_fetch(&calls, 1, 0); return __libc_calloc(n, m); }
+void* realloc(void* p, size_t n) { __atomic_add_fetch(&calls, 1, 0); return __libc_realloc(p, n); }
+void free(void* p) { __atomic_add_fetch(&calls, 1, 0); __libc_free(p); }
+int posix_memalign(void** p, size_t alignment, size_t n) {
+    __atomic_add_fetch(&calls, 1, 0);
+    *p = __libc_memalign(alignment, n);
+    return *p ? 0 : 12;
+}
+
+__attribute__((destructor)) static void done(void) {
+    char line[64];
+    snprintf(line, sizeof(line), "toy calls: %lu\n", calls);
+    ssize_t ignored = write(2, line, strlen(line));
+    (void)ignored;
+}
+"""
+
+
+def _compile(command, cwd):
+    result = subprocess.run(
+        command, cwd=cwd, capture_output=True, text=True, check=False
+    )
+    assert result.returncode == 0, result.stderr
+
+
+@pytest.fixture(scope="module")
+def work_dir(tmp_path_factory):
+    """Directory with the program linked with the proxy, and a toy allocator."""
+    work = tmp_path_factory.mktemp("allocator_proxy")
+    (work / "app.cpp").write_text(PROGRAM)
+    (work / "toy.c").write_text(TOY_ALLOCATOR)
+    _compile(
+        [
+            "g++",
+            "-O2",
+            "-std=c++17",
+            "-fPIC",
+            "-shared",
+            "-fvisibility=hidden",
+            "-fno-builtin",
+            "-Wall",
+            "-Wextra",
+            "-Werror",
+            str(RUNTIME_DIR / "tk_malloc_proxy.cpp"),
+            "-o",
+            "libtoolchainkit_allocator_proxy.so",
+            "-pthread",
+            "-ldl",
+        ],
+        work,
+    )
+    _compile(
+        [
+            "g++",
+            "-O1",
+            "-std=c++17",
+            f"-I{RUNTIME_DIR}",
+            "app.cpp",
+            "-o",
+            "app",
+            "-L.",
+            "-ltoolchainkit_allocator_proxy",
+            f"-Wl,-rpath,{work}",
+            "-pthread",
+        ],
+        work,
+    )
+    _compile(["gcc", "-O1", "-fPIC", "-shared", "toy.c", "-o", "libtoy.so"], work)
+    return work
+
+
+def _run(work_dir, tmp_path, *args, **env):
+    environment = dict(
+        os.environ,
+        TOOLCHAINKIT_ALLOCATOR_REPORT=str(tmp_path / "report.json"),
+    )
+    for name in ("TOOLCHAINKIT_ALLOCATOR", "TOOLCHAINKIT_ALLOCATOR_STATS"):
+        environment.pop(name, None)
+    environment.update(env)
+    return subprocess.run(
+        [str(work_dir / "app"), *args],
+        env=environment,
+        capture_output=True,
+        text=True,
+        check=True,
+        timeout=60,
+    )
+
+
+class TestAllocatorProxy:
+    """Test forwarding, statistics and sampling of the proxy."""
+
+    def test_system_allocator_by_default(self, work_dir, tmp_path):
+        """Test the C library's malloc is used and nothing is recorded."""
+        result = _run(work_dir, tmp_path)
+
+        assert result.stdout.strip() == "system"
+        assert not (tmp_path / "report.json").exists()
+
+    def test_forwards_to_selected_allocator(self, work_dir, tmp_path):
+        """Test TOOLCHAINKIT_ALLOCATOR selects the allocator at startup."""
+        toy = str(work_dir / "libtoy.so")
+        result = _run(work_dir, tmp_path, TOOLCHAINKIT_ALLOCATOR=toy)
+
+        assert result.stdout.strip() == toy
+        calls = int(result.stderr.split("toy calls:")[1].split()[0])
+        assert calls >= 4000
+
+    def test_unusable_allocator_falls_back(self, work_dir, tmp_path):
+        """Test a missing allocator warns and uses the system allocator."""
+        result = _run(
+            work_dir, tmp_path, TOOLCHAINKIT_ALLOCATOR=str(tmp_path / "missing.so")
+        )
+
+        assert result.stdout.strip() == "system"
+        assert "cannot use allocator" in result.stderr
+
+    def test_statistics_report(self, work_dir, tmp_path):
+        """Test the report counts allocations per thread and size class."""
+        _run(work_dir, tmp_path, TOOLCHAINKIT_ALLOCATOR_STATS="1")
+        report = json.loads((tmp_path / "report.json").read_text())
+
+        assert report["allocator"] == "system"
+        assert report["threads"] >= 2
+        assert report["allocations"] >= 2000
+        assert report["frees"] >= 2000
+        assert report["reallocs"] >= 1
+        classes = {c["max_size"]: c for c in report["size_classes"]}
+        assert classes[64]["allocations"] >= 1000  # make_array(16)
+        assert classes[128]["allocations"] >= 1000  # make_buffer(100)
+        assert report["sites"] == []
+
+    def test_sampled_sites(self, work_dir, tmp_path):
+        """Test sampled allocation sites are symbolized and sorted by bytes."""
+        _run(work_dir, tmp_path, TOOLCHAINKIT_ALLOCATOR_SAMPLE="1")
+        report = json.loads((tmp_path / "report.json").read_text())
+
+        sites = report["sites"]
+        assert report["sample_rate"] == 1
+        assert any(site["stack"][0] == "make_buffer(unsigned long)" for site in sites)
+        assert [s["bytes"] for s in sites] == sorted(
+            (s["bytes"] for s in sites), reverse=True
+        )
+
+    def test_report_on_request(self, work_dir, tmp_path):
+        """Test the program writes the report through the API."""
+        output = tmp_path / "requested.json"
+        _run(work_dir, tmp_path, str(output), TOOLCHAINKIT_ALLOCATOR_STATS="1")
+
+        assert json.loads(output.read_text())["allocations"] >= 2000
@@ -0,0 +1,188 @@
+"""Tests for the function instrumentation runtime (built with the host g++)."""
+
+import json
+import os
+import shutil
+import subprocess
+import sys
+from pathlib import Path
+
+import pytest
+
+import toolchainkit
+
+RUNTIME_DIR = Path(toolchainkit.__file__).parent / "data" / "runtime" / "instrument"
+
+pytestmark = pytest.mark.skipif(
+    not sys.platform.startswith("linux") or shutil.which("g++") is None,
+    reason="Needs g++ on Linux",
+)
+
+PROGRAM = r"""
+#include <csignal>
+#include <cstdlib>
+#include <thread>
+#include <unistd.h>
+
+namespace app {
+__attribute__((noinline)) int leaf(int x) { __asm__ __volatile__(""); return x + 1; }
+__attribute__((noinline)) int middle(int x) {
+    int sum = 0;
+    for (int i = 0; i < 3; ++i) sum += leaf(x + i);
+    return sum;
+}
+__attribute__((noinline)) int noisy(int x) { return x * 2; }
+}  // namespace app
+
+__attribute__((noinline)) void worker(int n) {
+    volatile int sum = 0;
+    for (int i = 0; i < n; ++i) sum += app::middle(i) + app::noisy(i);
+}
+
+int main() {
+    std::thread thread(worker, 1000);
+    worker(10);
+    thread.join();
+    if (std::getenv("RAISE")) {
+        std::raise(SIGUSR2);
+        usleep(200000);
+        _exit(0);  // Skip the dump at exit
+    }
+    return 0;
+}
+"""
+
+
+def _compile(command, cwd):
+    result = subprocess.run(
+        command, cwd=cwd, capture_output=True, text=True, check=False
+    )
+    assert result.returncode == 0, result.stderr
+
+
+@pytest.fixture(scope="module")
+def program(tmp_path_factory):
+    """Instrumented test program linked with the runtime."""
+    work = tmp_path_factory.mktemp("instrument")
+    (work / "app.cpp").write_text(PROGRAM)
+    _compile(
+        [
+            "g++",
+            "-O1",
+            "-std=c++17",
+            "-fPIC",
+            "-shared",
+            "-fvisibility=hidden",
+            "-fno-instrument-functions",
+            "-Wall",
+            "-Wextra",
+            "-Werror",
+            str(RUNTIME_DIR / "tk_instrument.cpp"),
+            "-o",
+            "libtoolchainkit_instrument.so",
+            "-pthread",
+            "-ldl",
+        ],
+        work,
+    )
+    _compile(
+        [
+            "g++",
+            "-O1",
+            "-std=c++17",
+            "-finstrument-functions",
+            "-finstrument-functions-exclude-function-list=std::",
+            "app.cpp",
+            "-o",
+            "app",
+            "-L.",
+            "-ltoolchainkit_instrument",
+            f"-Wl,-rpath,{work}",
+            "-pthread",
+        ],
+        work,
+    )
+    return work / "app"
+
+
+def _run(program, tmp_path, **env):
+    output = tmp_path / "trace.out"
+    environment = dict(os.environ, TOOLCHAINKIT_INSTRUMENT_OUTPUT=str(output))
+    environment.update(env)
+    subprocess.run([str(program)], env=environment, check=True, timeout=60)
+    return output
+
+
+def _complete_events(path):
+    events = json.loads(path.read_text())["traceEvents"]
+    return [e for e in events if e["ph"] == "X"]
+
+
+class TestInstrumentRuntime:
+    """Test recording and output of the runtime."""
+
+    def test_chrome_trace(self, program, tmp_path):
+        """Test every call is recorded with its name, thread and duration."""
+        events = _complete_events(_run(program, tmp_path))
+        names = [e["name"] for e in events]
+
+        assert names.count("app::middle(int)") == 1010
+        assert names.count("app::leaf(int)") == 3030
+        assert names.count("main") == 1
+        assert len({e["tid"] for e in events}) == 2
+        main = next(e for e in events if e["name"] == "main")
+        middle = next(e for e in events if e["name"] == "app::middle(int)")
+        assert all(e["dur"] >= 0 for e in events)
+        if middle["tid"] == main["tid"]:
+            assert main["ts"] <= middle["ts"]
+            assert middle["ts"] + middle["dur"] <= main["ts"] + main["dur"]
+
+    def test_folded_stacks(self, program, tmp_path):
+        """Test folded output has one line per stack with self time."""
+        output = _run(program, tmp_path, TOOLCHAINKIT_INSTRUMENT_FORMAT="folded")
+        stacks = dict(line.rsplit(" ", 1) for line in output.read_text().splitlines())
+
+        assert "worker(int);app::middle(int);app::leaf(int)" in stacks
+        assert "main;worker(int);app::middle(int);app::leaf(int)" in stacks
+        assert all(int(ns) > 0 for ns in stacks.values())
+
+    def test_exclusion_by_name(self, program, tmp_path):
+        """Test excluded functions are not recorded."""
+        output = _run(program, tmp_path, TOOLCHAINKIT_INSTRUMENT_EXCLUDE="noisy,leaf")
+        names = {e["name"] for e in _complete_events(output)}
+
+        assert "app::middle(int)" in names
+        assert "app::noisy(int)" not in names
+        assert "app::leaf(int)" not in names
+
+    def test_sampling(self, program, tmp_path):
+        """Test sampling records a fraction of the calls."""
+        output = _run(program, tmp_path, TOOLCHAINKIT_INSTRUMENT_SAMPLE="20")
+        events = _complete_events(output)
+
+        assert 0 < len(events) < 2000
+
+    def test_small_buffer_keeps_latest_events(self, program, tmp_path):
+        """Test a full ring keeps the most recent events."""
+        output = _run(program, tmp_path, TOOLCHAINKIT_INSTRUMENT_BUFFER="1")
+        events = _complete_events(output)
+
+        main_thread = {e["tid"] for e in events if e["name"] == "main"}
+        worker_calls = [e for e in events if e["tid"] not in main_thread]
+        # 1024 events per thread: the last 512 calls; the enter of the
+        # thread's outermost call was overwritten
+        assert 500 <= len(worker_calls) <= 512
+        assert "worker(int)" not in {e["name"] for e in worker_calls}
+
+    def test_dump_on_signal(self, program, tmp_path):
+        """Test the signal writes the output while the program runs."""
+        output = _run(program, tmp_path, RAISE="1")
+
+        assert output.exists()
+        assert _complete_events(output)
+
+    def test_disabled(self, program, tmp_path):
+        """Test TOOLCHAINKIT_INSTRUMENT=0 records nothing."""
+        output = _run(program, tmp_path, TOOLCHAINKIT_INSTRUMENT="0")
+
+        assert not output.exists()
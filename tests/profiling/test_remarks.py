@@ -0,0 +1,395 @@
+"""Tests for optimization remark aggregation and tkgen remarks."""
+
+import gzip
+import json
+
+import pytest
+
+from toolchainkit.cli.parser import CLI
+from toolchainkit.profiling.remarks import (
+    RemarksError,
+    aggregate,
+    apply_profile,
+    base_name,
+    collect,
+    find_record_files,
+    format_report,
+    load_profile,
+    parse_clang_yaml,
+    parse_gcc_json,
+    parse_perf_report,
+)
+
+CLANG_YAML = """\
+--- !Missed
+Pass:            loop-vectorize
+Name:            MissedDetails
+DebugLoc:        { File: src/kernels.cpp, Line: 12, Column: 5 }
+Function:        _Z6gatherPfPKfPKii
+Args:
+  - String:          loop not vectorized
+...
+--- !Analysis
+Pass:            loop-vectorize
+Name:            CantVectorizeMemory
+DebugLoc:        { File: src/kernels.cpp, Line: 12, Column: 5 }
+Function:        _Z6gatherPfPKfPKii
+Args:
+  - String:          'loop not vectorized: '
+  - String:          cannot identify array bounds
+...
+--- !Passed
+Pass:            loop-vectorize
+Name:            Vectorized
+DebugLoc:        { File: src/kernels.cpp, Line: 4, Column: 3 }
+Function:        _Z5saxpyPfPKffi
+Args:
+  - String:          'vectorized loop (vectorization width: '
+  - VectorizationFactor: '4'
+  - String:          ')'
+...
+--- !Missed
+Pass:            inline
+Name:            NoDefinition
+DebugLoc:        { File: src/main.cpp, Line: 30, Column: 10 }
+Function:        main
+Hotness:         250
+Args:
+  - Callee:          _Z5heavyf
+    DebugLoc:        { File: src/heavy.cpp, Line: 2, Column: 0 }
+  - String:          ' will not be inlined into '
+  - Caller:          main
+    DebugLoc:        { File: src/main.cpp, Line: 20, Column: 0 }
+  - String:          ' because its definition is unavailable'
+...
+--- !Missed
+Pass:            regalloc
+Name:            SpillReloadCopies
+DebugLoc:        { File: src/main.cpp, Line: 30, Column: 10 }
+Function:        main
+Args:
+  - NumSpills:       '2'
+  - String:          ' spills'
+...
+"""
+
+# Trimmed record of g++ -O3 -fsave-optimization-record (GCC 12)
+GCC_RECORD = [
+    {"format": "1", "generator": {"name": "GNU C++17", "version": "12.2.0"}},
+    [
+        {"name": "inline", "id": "0x10", "num": -1, "type": "ipa"},
+        {
+            "name": "vect",
+            "id": "0x20",
+            "num": 180,
+            "type": "gimple",
+            "children": [{"name": "dce", "id": "0x21", "num": 181}],
+        },
+    ],
+    [
+        {
+            "kind": "note",
+            "count": {"quality": "uninitialized", "value": 0},
+            "pass": "0x20",
+            "message": ["\nAnalyzing loop at k.cpp:3\n"],
+            "function": "_Z8sum_listP4Node",
+        },
+        {
+            "kind": "scope",
+            "location": {"file": "k.cpp", "line": 3, "column": 47},
+            "pass": "0x20",
+            "message": ["=== vect_analyze_loop_form ===\n"],
+            "function": "_Z8sum_listP4Node",
+            "children": [
+                {
+                    "kind": "failure",
+                    "count": {"quality": "precise", "value": 9000},
+                    "location": {"file": "k.cpp", "line": 3, "column": 47},
+                    "pass": "0x20",
+                    "message": [
+                        "not vectorized: number of iterations cannot be computed.\n"
+                    ],
+                    "function": "_Z8sum_listP4Node",
+                }
+            ],
+        },
+        {
+            "kind": "failure",
+            "count": {"quality": "precise", "value": 9000},
+            "location": {"file": "k.cpp", "line": 3, "column": 47},
+            "pass": "0x20",
+            "message": ["couldn't vectorize loop\n"],
+            "function": "_Z8sum_listP4Node",
+        },
+        {
+            "kind": "failure",
+            "count": {"quality": "guessed_local", "value": 955630225},
+            "location": {"file": "k.cpp", "line": 7, "column": 74},
+            "pass": "0x10",
+            "message": [
+                "  not inlinable: ",
+                {"symtab_node": "float call(float*, int)/159"},
+                " -> ",
+                {"symtab_node": "float heavy(float)/158"},
+                ", function not inlinable\n",
+                "Unit growth for small function inlining: 58->58 (0%)\n",
+            ],
+            "inlining_chain": [{"fndecl": "float call(float*, int)"}],
+        },
+        {
+            "kind": "success",
+            "count": {"quality": "guessed_local", "value": 10},
+            "location": {"file": "k.cpp", "line": 4, "column": 85},
+            "pass": "0x20",
+            "message": ["loop vectorized using 16 byte vectors\n"],
+            "function": "_Z5saxpyPfPKffi",
+        },
+        {
+            "kind": "failure",
+            "count": {"quality": "guessed_local", "value": 10},
+            "location": {"file": "k.cpp", "line": 4, "column": 85},
+            "pass": "0x20",
+            "message": ["Unknown misalignment, naturally aligned\n"],
+            "function": "_Z5saxpyPfPKffi",
+        },
+    ],
+]
+
+PERF_REPORT = """\
+# Samples: 12K of event 'cycles'
+#
+    61.30%  bench  bench              [.] _Z6gatherPfPKfPKii
+    20.10%  bench  bench              [.] _Z4callPfi
+     3.00%  bench  [kernel.kallsyms]  [k] native_write_msr
+"""
+
+
+@pytest.fixture
+def build_dir(tmp_path):
+    """Build tree with one Clang and one GCC record file."""
+    build = tmp_path / "build"
+    objects = build / "CMakeFiles" / "kernels.dir"
+    objects.mkdir(parents=True)
+    (objects / "kernels.cpp.opt.yaml").write_text(CLANG_YAML)
+    with gzip.open(objects / "k.cpp.opt-record.json.gz", "wt") as f:
+        json.dump(GCC_RECORD, f)
+    (objects / "kernels.cpp.o").write_bytes(b"\0")
+    return build
+
+
+class TestParseClangYaml:
+    """Test parsing of Clang YAML remarks."""
+
+    def test_kinds_and_messages(self):
+        """Test every document becomes a remark with its arguments joined."""
+        remarks = parse_clang_yaml(CLANG_YAML)
+
+        assert [r.kind for r in remarks] == [
+            "missed",
+            "analysis",
+            "passed",
+            "missed",
+            "missed",
+        ]
+        assert remarks[1].message == "loop not vectorized: cannot identify array bounds"
+        assert remarks[3].message == (
+            "_Z5heavyf will not be inlined into main because its definition "
+            "is unavailable"
+        )
+        assert remarks[3].hotness == 250
+        assert (remarks[0].file, remarks[0].line, remarks[0].column) == (
+            "src/kernels.cpp",
+            12,
+            5,
+        )
+
+    def test_pass_filter(self):
+        """Test remarks of other passes are skipped."""
+        remarks = parse_clang_yaml(CLANG_YAML, passes={"inline"})
+        assert [r.pass_name for r in remarks] == ["inline"]
+
+
+class TestParseGccJson:
+    """Test parsing of GCC optimization records."""
+
+    def test_nested_records(self):
+        """Test nested scopes are flattened and pass ids resolved."""
+        remarks = parse_gcc_json(GCC_RECORD)
+        missed = [r for r in remarks if r.kind == "missed"]
+
+        assert [r.pass_name for r in missed] == ["vect", "vect", "inline", "vect"]
+        assert missed[0].message == (
+            "not vectorized: number of iterations cannot be computed."
+        )
+        assert missed[0].hotness == 9000
+
+    def test_inlining_message(self):
+        """Test symbol nodes are rendered and statistics dropped."""
+        inline = next(r for r in parse_gcc_json(GCC_RECORD) if r.pass_name == "inline")
+
+        assert inline.message == (
+            "not inlinable: float call(float*, int) -> float heavy(float), "
+            "function not inlinable"
+        )
+        assert inline.function == "float call(float*, int)"
+        # Guessed counts are not hotness
+        assert inline.hotness is None
+
+    def test_not_a_record(self):
+        """Test other JSON is rejected."""
+        with pytest.raises(RemarksError):
+            parse_gcc_json({"version": 1})
+
+
+class TestAggregate:
+    """Test merging remarks into findings."""
+
+    def test_summary_with_reasons(self):
+        """Test the summary remark heads a finding and the others are reasons."""
+        findings = aggregate(parse_gcc_json(GCC_RECORD))
+        loop = next(f for f in findings if f.line == 3)
+
+        assert loop.message == "couldn't vectorize loop"
+        assert loop.reasons == [
+            "not vectorized: number of iterations cannot be computed."
+        ]
+        assert loop.hotness == 9000
+        assert loop.hotness_source == "compiler"
+
+    def test_vectorized_lines_are_dropped(self):
+        """Test a line with a vectorized loop has no finding."""
+        findings = aggregate(parse_gcc_json(GCC_RECORD))
+        assert [f.line for f in findings] == [3, 7]
+
+    def test_duplicates_are_counted(self):
+        """Test the same remark from several translation units is merged."""
+        remarks = parse_clang_yaml(CLANG_YAML) * 3
+        findings = aggregate(remarks)
+
+        vectorization = next(f for f in findings if f.category == "vectorization")
+        assert vectorization.count == 3
+        assert vectorization.reasons == [
+            "loop not vectorized: cannot identify array bounds"
+        ]
+        assert len(findings) == 2
+
+
+class TestProfile:
+    """Test joining findings with a perf profile."""
+
+    def test_parse_perf_report(self):
+        """Test sample shares are read per symbol."""
+        profile = parse_perf_report(PERF_REPORT)
+        assert profile == {
+            "_Z6gatherPfPKfPKii": 61.30,
+            "_Z4callPfi": 20.10,
+            "native_write_msr": 3.00,
+        }
+
+    def test_load_saved_report(self, tmp_path):
+        """Test a saved perf report is read without perf."""
+        path = tmp_path / "perf.txt"
+        path.write_text(PERF_REPORT)
+        assert load_profile(path)["_Z4callPfi"] == pytest.approx(20.10)
+
+    def test_base_name(self):
+        """Test return types and parameters are stripped."""
+        assert base_name("float call(float*, int)") == "call"
+        assert (
+            base_name("ns::Mat<float, 4>::mul(int) const") == "ns::Mat<float, 4>::mul"
+        )
+        assert base_name("std::vector<int, std::allocator<int> > make()") == "make"
+        assert base_name("main") == "main"
+
+    def test_apply_profile_matches_demangled_names(self):
+        """Test a GCC inlining finding matches the caller's mangled symbol."""
+        findings = aggregate(parse_gcc_json(GCC_RECORD))
+        apply_profile(findings, parse_perf_report(PERF_REPORT))
+
+        inline = next(f for f in findings if f.category == "inlining")
+        loop = next(f for f in findings if f.category == "vectorization")
+        assert inline.hotness == pytest.approx(20.10)
+        assert inline.hotness_source == "profile"
+        # Not in the profile: the compiler's count no longer ranks it
+        assert loop.hotness is None
+
+
+class TestCollect:
+    """Test aggregating a build tree."""
+
+    def test_find_record_files(self, build_dir):
+        """Test both record formats are found and objects ignored."""
+        names = [p.name for p in find_record_files(build_dir)]
+        assert names == ["k.cpp.opt-record.json.gz", "kernels.cpp.opt.yaml"]
+
+    def test_ranked_by_profile(self, build_dir, tmp_path):
+        """Test findings in hot functions come first."""
+        profile = tmp_path / "perf.txt"
+        profile.write_text(PERF_REPORT)
+        report = collect(build_dir, profile=profile)
+
+        assert report.record_files == 2
+        assert [f.location for f in report.findings[:2]] == [
+            "src/kernels.cpp:12:5",
+            "k.cpp:7:74",
+        ]
+        assert report.findings[0].function.startswith("gather(")
+
+    def test_category_filter(self, build_dir):
+        """Test only the requested category is reported."""
+        report = collect(build_dir, categories=["inlining"])
+        assert {f.category for f in report.findings} == {"inlining"}
+        # Compiler hotness ranks the Clang remark above the guessed GCC one
+        assert report.findings[0].hotness == 250
+
+    def test_unreadable_file_is_reported(self, build_dir):
+        """Test a corrupt record file does not abort the report."""
+        (build_dir / "bad.opt-record.json").write_text("{")
+        report = collect(build_dir)
+
+        assert len(report.errors) == 1
+        assert report.findings
+
+    def test_format_report(self, build_dir):
+        """Test the text report lists reasons under each finding."""
+        text = format_report(collect(build_dir), limit=1)
+
+        assert text.startswith("4 missed optimization(s)")
+        assert "Showing the 1 hottest" in text
+        assert "       - not vectorized: number of iterations" in text
+
+
+class TestRemarksCommand:
+    """Test tkgen remarks."""
+
+    def test_json(self, build_dir, tmp_path, capsys):
+        """Test --json prints the ranked findings."""
+        result = CLI().run(
+            ["--project-root", str(tmp_path), "remarks", "build", "--json"]
+        )
+
+        assert result == 0
+        data = json.loads(capsys.readouterr().out)
+        assert data["record_files"] == 2
+        assert len(data["findings"]) == 4
+
+    def test_no_records(self, tmp_path, capsys):
+        """Test a build without records is an error."""
+        (tmp_path / "build").mkdir()
+        assert CLI().run(["--project-root", str(tmp_path), "remarks"]) == 1
+        assert "opt-remarks" in capsys.readouterr().err
+
+    def test_missing_profile(self, build_dir, tmp_path, capsys):
+        """Test an unreadable profile is an error."""
+        result = CLI().run(
+            [
+                "--project-root",
+                str(tmp_path),
+                "remarks",
+                "build",
+                "--profile",
+                str(tmp_path / "missing.data"),
+            ]
+        )
+        assert result == 1
+        assert "Cannot load profile" in capsys.readouterr().err
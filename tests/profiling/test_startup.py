@@ -0,0 +1,164 @@
+"""Tests for startup time measurement and tkgen startup."""
+
+import json
+import sys
+
+import pytest
+
+from toolchainkit.cli.parser import CLI
+from toolchainkit.profiling.startup import (
+    LoaderStats,
+    StartupError,
+    StartupResult,
+    compare_startup,
+    format_results,
+    loader_statistics,
+    measure_startup,
+    parse_ld_debug_statistics,
+)
+
+LD_DEBUG_OUTPUT = """\
+     41027:
+     41027:     runtime linker statistics:
+     41027:       total startup time in dynamic loader: 412337 cycles
+     41027:                 time needed for relocation: 128816 cycles (31.2%)
+     41027:                      number of relocations: 94
+     41027:           number of relocations from cache: 3
+     41027:             number of relative relocations: 1206
+     41027:                time needed to load objects: 223604 cycles (54.2%)
+     41027:
+     41027:     runtime linker statistics:
+     41027:                final number of relocations: 117
+     41027:     final number of relocations from cache: 3
+"""
+
+PYTHON = [sys.executable, "-c", "pass"]
+
+
+class TestParseStatistics:
+    """Test LD_DEBUG=statistics parsing."""
+
+    def test_parse(self):
+        """Test every counter is read."""
+        stats = parse_ld_debug_statistics(LD_DEBUG_OUTPUT)
+
+        assert stats == LoaderStats(
+            startup_cycles=412337,
+            relocation_cycles=128816,
+            load_cycles=223604,
+            relocations=94,
+            relocations_from_cache=3,
+            relative_relocations=1206,
+            final_relocations=117,
+        )
+        assert stats.lazy_relocations == 23
+
+    def test_no_statistics(self):
+        """Test unrelated output gives None."""
+        assert parse_ld_debug_statistics("hello\n") is None
+
+    def test_lazy_unknown_without_final_count(self):
+        """Test a process killed before exit has no lazy relocation count."""
+        assert LoaderStats(relocations=5).lazy_relocations is None
+
+
+class TestFormat:
+    """Test the results table."""
+
+    def test_change_against_baseline(self):
+        """Test later commands are compared to the first."""
+        results = [
+            StartupResult(["./a"], [0.002, 0.002, 0.004]),
+            StartupResult(["./b"], [0.001, 0.001, 0.003], LoaderStats(relocations=7)),
+        ]
+        text = format_results(results)
+
+        assert "2.000 ms" in text
+        assert "-50.0%" in text
+        assert "Dynamic loader" in text
+        # Missing statistics for the baseline are shown as "-"
+        relocations = next(
+            line for line in text.splitlines() if "  relocations" in line
+        )
+        assert relocations.split()[-2:] == ["-", "7"]
+
+
+class TestMeasure:
+    """Test timing real commands."""
+
+    def test_measure(self):
+        """Test one sample per run."""
+        result = measure_startup(PYTHON, runs=3, warmup=1)
+
+        assert len(result.samples) == 3
+        assert all(s > 0 for s in result.samples)
+        assert result.minimum <= result.median <= result.p90
+
+    def test_compare_keeps_order(self):
+        """Test one result per command, baseline first."""
+        results = compare_startup(PYTHON, [sys.executable, "-S", "-c", "pass"], runs=2)
+
+        assert [r.command[1] for r in results] == ["-c", "-S"]
+        assert all(len(r.samples) == 2 for r in results)
+
+    def test_failing_command(self):
+        """Test a nonzero exit status is an error."""
+        with pytest.raises(StartupError, match="status 3"):
+            measure_startup(
+                [sys.executable, "-c", "raise SystemExit(3)"], runs=1, warmup=0
+            )
+
+    def test_missing_command(self):
+        """Test an unknown program is an error."""
+        with pytest.raises(StartupError, match="not found"):
+            measure_startup(["tk-no-such-program"], runs=1)
+
+    @pytest.mark.skipif(
+        not sys.platform.startswith("linux"), reason="glibc dynamic loader"
+    )
+    def test_loader_statistics(self):
+        """Test the loader reports relocations of a dynamic executable."""
+        stats = loader_statistics(PYTHON)
+
+        if stats is None:
+            pytest.skip("Loader does not support LD_DEBUG=statistics")
+        assert stats.relocations > 0
+
+
+class TestStartupCommand:
+    """Test tkgen startup."""
+
+    def test_json(self, capsys):
+        """Test JSON output with a baseline."""
+        result = CLI().run(
+            [
+                "startup",
+                "--runs",
+                "2",
+                "--warmup",
+                "0",
+                "--json",
+                "--baseline",
+                f"{sys.executable} -S -c pass",
+                *PYTHON,
+            ]
+        )
+
+        assert result == 0
+        data = json.loads(capsys.readouterr().out)
+        assert [d["command"][1] for d in data] == ["-S", "-c"]
+        assert len(data[1]["samples"]) == 2
+
+    def test_no_program(self, capsys):
+        """Test a program is required."""
+        assert CLI().run(["startup"]) == 1
+        assert "program" in capsys.readouterr().err.lower()
+
+    def test_failing_program(self, capsys):
+        """Test a failing program is reported."""
+        result = CLI().run(
+            ["startup", "--runs", "1", sys.executable, "-c", "raise SystemExit(2)"]
+        )
+
+        assert result == 1
+        assert "status 2" in capsys.readouterr().err
@@ -8,12 +8,18 @@ from datetime import datetime, timedelta
 import json
 
 from toolchainkit.toolchain.cleanup import (
+    QUOTA_ENV,
+    CacheQuota,
     ToolchainInfo,
     CleanupResult,
     ToolchainCleanupManager,
     ReferenceCounter,
+    enforce_cache_quota,
+    get_cache_quota,
+    set_cache_quota,
 )
 from toolchainkit.core.cache_registry import ToolchainCacheRegistry
+from toolchainkit.core.locking import LockManager
 
 
 @pytest.fixture
@@ -567,6 +573,149 @@ class TestToolchainCleanupManager:
         assert "free_space" in stats
 
 
+class TestCacheQuota:
+    @pytest.fixture(autouse=True)
+    def no_quota(self, monkeypatch):
+        monkeypatch.delenv(QUOTA_ENV, raising=False)
+        set_cache_quota(None)
+        yield
+        set_cache_quota(None)
+
+    def test_parse_size(self):
+        quota = CacheQuota.parse("2G")
+        assert quota.max_bytes == 2 * 1024**3
+        assert quota.high_bytes == int(2 * 1024**3 * 0.9)
+        assert quota.low_bytes == int(2 * 1024**3 * 0.75)
+
+    def test_parse_mapping(self):
+        quota = CacheQuota.parse(
+            {"max_size": "100M", "high_watermark": 1.0, "low_watermark": 0.5}
+        )
+        assert quota.max_bytes == 100 * 1024**2
+        assert quota.low_bytes == 50 * 1024**2
+
+    @pytest.mark.parametrize(
+        "value",
+        ["lots", "0", {"high_watermark": 0.9}, {"max_size": "1G", "low_watermark": 2}],
+    )
+    def test_parse_invalid(self, value):
+        with pytest.raises(ValueError):
+            CacheQuota.parse(value)
+
+    def test_env_and_override(self, monkeypatch):
+        assert get_cache_quota() is None
+        monkeypatch.setenv(QUOTA_ENV, "1G")
+        assert get_cache_quota().max_bytes == 1024**3
+        set_cache_quota(CacheQuota(1000))
+        assert get_cache_quota().max_bytes == 1000
+
+    def test_invalid_env_is_ignored(self, monkeypatch):
+        monkeypatch.setenv(QUOTA_ENV, "lots")
+        assert get_cache_quota() is None
+
+
+class TestEnforceQuota:
+    MB = 1024 * 1024
+
+    @pytest.fixture
+    def cache(self, mock_registry, temp_cache_dir):
+        """Registry with three toolchains and an archive, 10 MB each."""
+        now = datetime.now()
+        for i, tc_id in enumerate(["tc-old", "tc-used", "tc-new"]):
+            path = temp_cache_dir / "toolchains" / tc_id
+            path.mkdir(parents=True)
+            mock_registry.register_toolchain(
+                tc_id, path, 10.0, "sha256:a", "http://a", size_bytes=10 * self.MB
+            )
+        archive = temp_cache_dir / "downloads" / "tc.tar.xz"
+        archive.parent.mkdir()
+        archive.write_bytes(b"x")
+        mock_registry.register_artifact(archive, "download", 10 * self.MB)
+
+        with mock_registry.transaction():
+            data = mock_registry._load_registry()
+            for tc_id, age in (("tc-old", 30), ("tc-used", 40), ("tc-new", 1)):
+                stamp = (now - timedelta(days=age)).isoformat()
+                data["toolchains"][tc_id]["installed"] = stamp
+                data["toolchains"][tc_id]["last_used"] = stamp
+            stamp = (now - timedelta(days=10)).isoformat()
+            data["artifacts"][str(archive.resolve())]["installed"] = stamp
+            data["artifacts"][str(archive.resolve())]["last_used"] = stamp
+            project = temp_cache_dir.parent / "project"
+            project.mkdir()
+            data["toolchains"]["tc-used"]["projects"] = [str(project)]
+            mock_registry._save_registry(data)
+        return archive
+
+    def test_under_high_watermark(self, cleanup_manager, cache):
+        result = cleanup_manager.enforce_quota(CacheQuota(45 * self.MB))
+        assert result.removed == []
+
+    def test_evicts_lru_to_low_watermark(self, cleanup_manager, cache, temp_cache_dir):
+        # 40 MB used; high watermark 36 MB, low watermark 24 MB
+        result = cleanup_manager.enforce_quota(CacheQuota(40 * self.MB, 0.9, 0.6))
+
+        # Oldest first, skipping the referenced toolchain
+        assert result.removed == ["tc-old", str(cache.resolve())]
+        assert result.space_reclaimed == 20 * self.MB
+        assert not (temp_cache_dir / "toolchains" / "tc-old").exists()
+        assert not cache.exists()
+
+        stats = cleanup_manager.registry.get_cache_stats()
+        assert stats["total_bytes"] == 20 * self.MB
+        assert stats["artifact_bytes"] == {}
+
+    def test_never_evicts_referenced(self, cleanup_manager, cache):
+        result = cleanup_manager.enforce_quota(CacheQuota(self.MB))
+        assert "tc-used" not in result.removed
+        assert cleanup_manager.registry.get_toolchain_info("tc-used")
+
+    def test_ignores_references_of_deleted_projects(self, cleanup_manager, cache):
+        (cache.parents[2] / "project").rmdir()
+
+        result = cleanup_manager.enforce_quota(CacheQuota(40 * self.MB, 0.9, 0.6))
+
+        assert result.removed == ["tc-used", "tc-old"]
+
+    def test_skips_locked_toolchain(self, mock_registry, cache, tmp_path):
+        locks = LockManager(tmp_path / "locks")
+        manager = ToolchainCleanupManager(mock_registry, locks)
+
+        with locks.toolchain_lock("tc-old", timeout=1):
+            result = manager.enforce_quota(CacheQuota(40 * self.MB, 0.9, 0.6))
+
+        assert result.skipped == ["tc-old"]
+        assert result.removed == [str(cache.resolve()), "tc-new"]
+        assert mock_registry.get_toolchain_info("tc-old")
+
+    def test_protect(self, cleanup_manager, cache):
+        result = cleanup_manager.enforce_quota(
+            CacheQuota(40 * self.MB, 0.9, 0.6), protect=["tc-old"]
+        )
+        assert result.removed == [str(cache.resolve()), "tc-new"]
+
+    def test_dry_run(self, cleanup_manager, cache):
+        result = cleanup_manager.enforce_quota(
+            CacheQuota(40 * self.MB, 0.9, 0.6), dry_run=True
+        )
+        assert len(result.removed) == 2
+        assert cache.exists()
+        assert cleanup_manager.registry.get_toolchain_info("tc-old")
+
+    def test_enforce_cache_quota_without_quota(self, mock_registry, monkeypatch):
+        monkeypatch.delenv(QUOTA_ENV, raising=False)
+        assert enforce_cache_quota(mock_registry) is None
+
+    def test_enforce_cache_quota_uses_configured(self, mock_registry, cache):
+        set_cache_quota(CacheQuota(40 * self.MB, 0.9, 0.6))
+        try:
+            result = enforce_cache_quota(mock_registry, protect=["tc-new"])
+        finally:
+            set_cache_quota(None)
+        assert "tc-new" not in result.removed
+        assert "tc-old" in result.removed
+
+
 # Integration tests
 class TestCleanupIntegration:
     def test_full_workflow(self, temp_cache_dir, tmp_path):
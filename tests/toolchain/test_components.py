@@ -0,0 +1,221 @@
+"""
+Unit tests for component-selective toolchain installation.
+
+Tests selection resolution, the archive member filter, installing a profile
+from a real archive and adding a component to the installation later.
+"""
+
+import shutil
+import tarfile
+from unittest.mock import patch
+
+import pytest
+
+from toolchainkit.core.manifest import IntegrityManifest
+from toolchainkit.toolchain.components import (
+    ComponentError,
+    ensure_components,
+    member_component,
+    member_filter,
+    resolve_selection,
+)
+from toolchainkit.toolchain.downloader import (
+    ToolchainDownloader,
+    ToolchainDownloadError,
+)
+from toolchainkit.toolchain.metadata_registry import ToolchainMetadata
+
+COMPONENTS = {
+    "compiler": ["bin/clang*", "lib/clang/*"],
+    "linker": ["bin/lld", "bin/ld.lld"],
+    "debugger": ["bin/lldb*", "lib/liblldb*"],
+    "bolt": ["bin/llvm-bolt", "bin/perf2bolt", "lib/libbolt_rt*"],
+}
+PROFILES = {"minimal": ["compiler", "linker"]}
+
+FILES = {
+    "bin/clang": b"clang",
+    "bin/ld.lld": b"lld",
+    "bin/lldb": b"lldb" * 1000,
+    "lib/liblldb.so": b"liblldb" * 1000,
+    "bin/llvm-bolt": b"bolt" * 100,
+    "lib/libbolt_rt_instr.a": b"rt",
+    "lib/clang/18/include/stddef.h": b"#define X",
+    "README.txt": b"unclassified",
+}
+
+
+class TestResolveSelection:
+    def test_full(self):
+        assert resolve_selection(COMPONENTS, PROFILES, None) is None
+        assert resolve_selection(COMPONENTS, PROFILES, "full") is None
+        assert resolve_selection(COMPONENTS, PROFILES, ["minimal", "full"]) is None
+
+    def test_profile_and_components(self):
+        assert resolve_selection(COMPONENTS, PROFILES, "minimal") == [
+            "compiler",
+            "linker",
+        ]
+        assert resolve_selection(COMPONENTS, PROFILES, ["minimal", "bolt"]) == [
+            "bolt",
+            "compiler",
+            "linker",
+        ]
+
+    def test_everything_selected_is_full(self):
+        assert resolve_selection(COMPONENTS, PROFILES, list(COMPONENTS)) is None
+
+    def test_no_components_defined(self):
+        assert resolve_selection({}, {}, "minimal") is None
+
+    def test_unknown_name(self):
+        with pytest.raises(ComponentError, match="debuger"):
+            resolve_selection(COMPONENTS, PROFILES, ["debuger"])
+
+
+class TestMemberFilter:
+    def test_member_component_ignores_top_level_directory(self):
+        assert member_component(COMPONENTS, "bin/lldb") == ["debugger"]
+        assert member_component(COMPONENTS, "./llvm-18/bin/lldb-server") == ["debugger"]
+        assert member_component(COMPONENTS, "llvm-18/README.txt") == []
+
+    def test_keeps_selected_and_unclassified(self):
+        keep = member_filter(COMPONENTS, ["compiler"])
+        assert keep("llvm-18/bin/clang")
+        assert keep("llvm-18/README.txt")
+        assert not keep("llvm-18/bin/lldb")
+
+    def test_only(self):
+        keep = member_filter(COMPONENTS, ["bolt"], only=True)
+        assert keep("llvm-18/bin/llvm-bolt")
+        assert not keep("llvm-18/README.txt")
+        assert not keep("llvm-18/bin/clang")
+
+
+@pytest.fixture
+def archive(tmp_path):
+    """LLVM-like tar.gz with a top-level directory."""
+    source = tmp_path / "source" / "llvm-18.1.8"
+    for rel, data in FILES.items():
+        (source / rel).parent.mkdir(parents=True, exist_ok=True)
+        (source / rel).write_bytes(data)
+    path = tmp_path / "llvm-18.1.8-linux.tar.gz"
+    with tarfile.open(path, "w:gz") as tar:
+        tar.add(source, arcname=source.name)
+    return path
+
+
+@pytest.fixture
+def downloader(tmp_path, archive):
+    """Downloader whose registry serves the test archive."""
+    downloader = ToolchainDownloader(cache_dir=tmp_path / "cache")
+    metadata = ToolchainMetadata(
+        url=f"https://example.com/{archive.name}",
+        sha256="abc",
+        size_mb=1,
+        components=COMPONENTS,
+        profiles=PROFILES,
+    )
+    downloader.metadata_registry.lookup = lambda *args: metadata
+    downloader.metadata_registry.resolve_version = lambda *args: "18.1.8"
+    return downloader
+
+
+def fake_download(archive):
+    def download(url, destination, **kwargs):
+        destination.parent.mkdir(parents=True, exist_ok=True)
+        shutil.copy(archive, destination)
+
+    return download
+
+
+class TestSelectiveInstall:
+    def test_minimal_profile(self, downloader, archive):
+        with patch(
+            "toolchainkit.toolchain.downloader.download_file",
+            side_effect=fake_download(archive),
+        ):
+            result = downloader.download_toolchain(
+                "llvm", "18", "linux-x64", components="minimal"
+            )
+
+        root = result.toolchain_path
+        assert (root / "bin" / "clang").exists()
+        assert (root / "lib" / "clang" / "18" / "include" / "stddef.h").exists()
+        assert (root / "README.txt").exists()
+        assert not (root / "bin" / "lldb").exists()
+        assert not (root / "bin" / "llvm-bolt").exists()
+
+        entry = downloader.cache_registry.get_toolchain_info(result.toolchain_id)
+        assert entry["components"] == ["compiler", "linker"]
+        assert entry["component_patterns"] == COMPONENTS
+
+    def test_add_component_later(self, downloader, archive):
+        with patch(
+            "toolchainkit.toolchain.downloader.download_file",
+            side_effect=fake_download(archive),
+        ) as download:
+            result = downloader.download_toolchain(
+                "llvm", "18", "linux-x64", components="minimal"
+            )
+            root = result.toolchain_path
+            size = downloader.cache_registry.get_toolchain_info(result.toolchain_id)[
+                "size_bytes"
+            ]
+
+            added = ensure_components(root, ["bolt"], downloader=downloader)
+            assert added == ["bolt"]
+            # The archive was still cached
+            assert download.call_count == 1
+
+        assert (root / "bin" / "llvm-bolt").read_bytes() == FILES["bin/llvm-bolt"]
+        assert (root / "lib" / "libbolt_rt_instr.a").exists()
+        assert not (root / "bin" / "lldb").exists()
+        assert IntegrityManifest.load(root).verify().ok
+
+        entry = downloader.cache_registry.get_toolchain_info(result.toolchain_id)
+        assert entry["components"] == ["bolt", "compiler", "linker"]
+        assert entry["size_bytes"] == size + 402
+        assert ensure_components(root, ["bolt"], downloader=downloader) == []
+
+    def test_add_component_after_eviction(self, downloader, archive):
+        with patch(
+            "toolchainkit.toolchain.downloader.download_file",
+            side_effect=fake_download(archive),
+        ) as download:
+            result = downloader.download_toolchain(
+                "llvm", "18", "linux-x64", components="minimal"
+            )
+            for cached in downloader.downloads_dir.iterdir():
+                cached.unlink()
+            downloader.materialize_components(result.toolchain_id, ["debugger"])
+            assert download.call_count == 2
+
+        assert (result.toolchain_path / "bin" / "lldb").exists()
+
+    def test_unknown_component(self, downloader, archive):
+        with patch(
+            "toolchainkit.toolchain.downloader.download_file",
+            side_effect=fake_download(archive),
+        ):
+            with pytest.raises(ToolchainDownloadError, match="nope"):
+                downloader.download_toolchain(
+                    "llvm", "18", "linux-x64", components=["nope"]
+                )
+            result = downloader.download_toolchain(
+                "llvm", "18", "linux-x64", components="minimal"
+            )
+        with pytest.raises(ComponentError):
+            downloader.materialize_components(result.toolchain_id, ["nope"])
+
+    def test_full_install_needs_nothing(self, downloader, archive):
+        with patch(
+            "toolchainkit.toolchain.downloader.download_file",
+            side_effect=fake_download(archive),
+        ):
+            result = downloader.download_toolchain("llvm", "18", "linux-x64")
+        assert (result.toolchain_path / "bin" / "lldb").exists()
+        assert ensure_components(result.toolchain_path, ["bolt"], downloader) == []
+
+    def test_unregistered_path(self, downloader, tmp_path):
+        assert ensure_components(tmp_path, ["bolt"], downloader=downloader) == []
@@ -0,0 +1,215 @@
+"""
+Unit tests for delta upgrades.
+
+Tests creating and applying delta patches between two toolchain trees, and
+the upgrader's fallback to a full download.
+"""
+
+import os
+import sys
+from pathlib import Path
+from unittest.mock import MagicMock, Mock
+
+import pytest
+
+from toolchainkit.core.manifest import IntegrityManifest
+from toolchainkit.toolchain import delta as delta_module
+from toolchainkit.toolchain.delta import (
+    DeltaError,
+    apply_delta,
+    create_delta,
+    read_delta,
+)
+from toolchainkit.toolchain.downloader import DownloadResult, ToolchainDownloadError
+from toolchainkit.toolchain.upgrader import ToolchainUpgrader, UpdateInfo
+
+BASE_ID = "llvm-18.1.7-linux-x64"
+TARGET_ID = "llvm-18.1.8-linux-x64"
+
+
+@pytest.fixture
+def trees(tmp_path):
+    """Base and target versions sharing, renaming and changing files."""
+    base = tmp_path / BASE_ID
+    target = tmp_path / TARGET_ID
+    clang = os.urandom(200_000)
+    for root in (base, target):
+        (root / "bin").mkdir(parents=True)
+        (root / "include" / "empty").mkdir(parents=True)
+        (root / "bin" / "clang").write_bytes(clang)
+        (root / "bin" / "clang").chmod(0o755)
+        (root / "README").write_text("LLVM")
+
+    (base / "lib" / "clang" / "18.1.7").mkdir(parents=True)
+    (base / "lib" / "clang" / "18.1.7" / "stddef.h").write_text("#define X 1\n" * 500)
+    (base / "lib" / "libLLVM.so").write_bytes(b"A" * 50_000 + os.urandom(1000))
+    (base / "bin" / "old-tool").write_bytes(b"gone")
+
+    (target / "lib" / "clang" / "18.1.8").mkdir(parents=True)
+    (target / "lib" / "clang" / "18.1.8" / "stddef.h").write_text("#define X 1\n" * 500)
+    (target / "lib" / "libLLVM.so").write_bytes(b"B" * 50_000 + os.urandom(1000))
+    (target / "bin" / "new-tool").write_bytes(os.urandom(5000))
+    if sys.platform != "win32":
+        os.symlink("clang", target / "bin" / "clang++")
+    return base, target
+
+
+def same_tree(a: Path, b: Path) -> bool:
+    """Compare files, links and directories of two trees."""
+
+    def listing(root):
+        result = {}
+        for path in sorted(root.rglob("*")):
+            rel = path.relative_to(root).as_posix()
+            if rel == delta_module.MANIFEST_NAME:
+                continue
+            if path.is_symlink():
+                result[rel] = ("link", os.readlink(path))
+            elif path.is_dir():
+                result[rel] = ("dir",)
+            else:
+                mode = path.stat().st_mode & 0o111 if os.name != "nt" else 0
+                result[rel] = ("file", path.read_bytes(), mode)
+        return result
+
+    return listing(a) == listing(b)
+
+
+class TestDelta:
+    def test_roundtrip_without_binary_patches(self, trees, tmp_path):
+        base, target = trees
+        patch = tmp_path / "patch.tkdelta"
+        created = create_delta(
+            base, target, patch, BASE_ID, TARGET_ID, binary_patches=False
+        )
+        # clang, README and the renamed header are reused from the base
+        assert created.copied == 3
+        assert created.patched == 0
+        assert created.stored == 2
+
+        result = tmp_path / "out" / TARGET_ID
+        applied = apply_delta(patch, base, result)
+        assert same_tree(result, target)
+        assert applied.target_bytes == created.target_bytes
+        assert IntegrityManifest.load(result).verify().ok
+        assert not list((tmp_path / "out").glob(".*"))
+
+    def test_layout_is_recorded(self, trees, tmp_path):
+        base, target = trees
+        patch = tmp_path / "patch.tkdelta"
+        create_delta(base, target, patch, BASE_ID, TARGET_ID, binary_patches=False)
+        _reader, component, layout = read_delta(patch)
+        assert component.metadata["target"] == TARGET_ID
+        assert layout["files"]["lib/clang/18.1.8/stddef.h"][0] == "copy"
+        assert layout["files"]["lib/clang/18.1.8/stddef.h"][4] == (
+            "lib/clang/18.1.7/stddef.h"
+        )
+        assert "include/empty" in layout["dirs"]
+        assert "bin/old-tool" not in layout["files"]
+
+    def test_binary_patches(self, trees, tmp_path):
+        pytest.importorskip("zstandard")
+        base, target = trees
+        patch = tmp_path / "patch.tkdelta"
+        created = create_delta(base, target, patch, BASE_ID, TARGET_ID)
+        assert created.patched == 1  # libLLVM.so
+
+        result = tmp_path / "out" / TARGET_ID
+        apply_delta(patch, base, result)
+        assert same_tree(result, target)
+
+    def test_changed_base_is_rejected(self, trees, tmp_path):
+        base, target = trees
+        patch = tmp_path / "patch.tkdelta"
+        create_delta(base, target, patch, BASE_ID, TARGET_ID, binary_patches=False)
+        (base / "bin" / "clang").write_bytes(b"modified")
+
+        result = tmp_path / "out" / TARGET_ID
+        with pytest.raises(DeltaError, match="bin/clang"):
+            apply_delta(patch, base, result)
+        assert not (tmp_path / "out").exists() or not any((tmp_path / "out").iterdir())
+
+    def test_missing_base_file(self, trees, tmp_path):
+        base, target = trees
+        patch = tmp_path / "patch.tkdelta"
+        create_delta(base, target, patch, BASE_ID, TARGET_ID, binary_patches=False)
+        (base / "README").unlink()
+        with pytest.raises(DeltaError):
+            apply_delta(patch, base, tmp_path / "out" / TARGET_ID)
+
+    def test_not_a_delta(self, tmp_path):
+        junk = tmp_path / "junk.tkdelta"
+        junk.write_bytes(b"not a bundle")
+        with pytest.raises(DeltaError):
+            read_delta(junk)
+
+
+@pytest.fixture
+def upgrader(tmp_path, monkeypatch):
+    """Upgrader with mocked registries, downloader and verifier."""
+    monkeypatch.setattr(
+        "toolchainkit.toolchain.upgrader.get_global_cache_dir", lambda: tmp_path
+    )
+    upgrader = ToolchainUpgrader.__new__(ToolchainUpgrader)
+    upgrader.cache_dir = tmp_path
+    upgrader.cache_registry = Mock()
+    upgrader.cache_registry.lock = MagicMock()
+    upgrader.cache_registry.transaction = MagicMock()
+    upgrader.cache_registry.get_toolchain_info.return_value = {
+        "path": str(tmp_path),
+        "projects": [],
+    }
+    upgrader.metadata_registry = Mock()
+    upgrader.downloader = Mock()
+    upgrader.downloader.download_and_install.return_value = tmp_path / "full"
+    upgrader.verifier = Mock()
+    upgrader.verifier.verify.return_value = Mock(success=True)
+    upgrader.check_for_updates = Mock(
+        return_value=UpdateInfo(
+            "18.1.7",
+            "18.1.8",
+            "https://example.com/llvm.tar.xz",
+            "abc",
+            500,
+            deltas={"18.1.7": {"url": "https://example.com/d.tkdelta", "sha256": "d"}},
+        )
+    )
+    return upgrader
+
+
+class TestDeltaUpgrade:
+    def test_uses_delta(self, upgrader, tmp_path):
+        upgrader.downloader.install_delta.return_value = DownloadResult(
+            TARGET_ID, tmp_path / "delta", 0.0, 0.0, 0, False
+        )
+        result = upgrader.upgrade_toolchain(BASE_ID)
+        assert result.success
+        assert result.method == "delta"
+        upgrader.downloader.download_and_install.assert_not_called()
+
+    def test_falls_back_when_delta_fails(self, upgrader):
+        upgrader.downloader.install_delta.side_effect = ToolchainDownloadError("bad")
+        result = upgrader.upgrade_toolchain(BASE_ID)
+        assert result.success
+        assert result.method == "full"
+        upgrader.downloader.download_and_install.assert_called_once()
+
+    def test_falls_back_when_verification_fails(self, upgrader, tmp_path):
+        built = tmp_path / "delta"
+        built.mkdir()
+        upgrader.downloader.install_delta.return_value = DownloadResult(
+            TARGET_ID, built, 0.0, 0.0, 0, False
+        )
+        upgrader.verifier.verify.side_effect = [
+            Mock(success=False, error="broken", issues=[]),
+            Mock(success=True),
+        ]
+        result = upgrader.upgrade_toolchain(BASE_ID)
+        assert result.success
+        assert result.method == "full"
+        assert not built.exists()
+
+    def test_delta_disabled(self, upgrader):
+        result = upgrader.upgrade_toolchain(BASE_ID, delta=False)
+        assert result.method == "full"
+        upgrader.downloader.install_delta.assert_not_called()
@@ -0,0 +1,198 @@
+"""
+Tests for measured linker selection.
+"""
+
+import os
+import shutil
+from pathlib import Path
+
+import pytest
+
+from toolchainkit.toolchain.linker_benchmark import (
+    LinkerBenchmark,
+    LinkerSelectionCache,
+    LinkerTiming,
+    find_linker,
+    select_fastest,
+    thread_candidates,
+    toolchain_fingerprint,
+)
+
+
+def _fake_exe(path: Path) -> Path:
+    path.parent.mkdir(parents=True, exist_ok=True)
+    path.write_text("#!/bin/sh\n")
+    path.chmod(0o755)
+    return path
+
+
+class TestLinkerTiming:
+    """Test LinkerTiming flags and formatting."""
+
+    def test_lld_threads(self):
+        """Test lld thread flag."""
+        timing = LinkerTiming("lld", threads=8, seconds=0.5)
+        assert timing.link_flags() == ["-fuse-ld=lld", "-Wl,--threads=8"]
+
+    def test_mold_threads(self):
+        """Test mold thread flag."""
+        timing = LinkerTiming("mold", threads=4, seconds=0.5)
+        assert timing.link_flags() == ["-fuse-ld=mold", "-Wl,--thread-count=4"]
+
+    def test_gnu_ld_uses_bfd(self):
+        """Test GNU ld is selected as bfd and takes no thread flag."""
+        timing = LinkerTiming("ld", threads=4, seconds=1.0)
+        assert timing.link_flags() == ["-fuse-ld=bfd"]
+
+    def test_default_threads(self):
+        """Test no thread flag for the linker default."""
+        assert LinkerTiming("lld").link_flags() == ["-fuse-ld=lld"]
+
+    def test_str(self):
+        """Test summary formatting."""
+        assert "250 ms" in str(LinkerTiming("lld", 2, seconds=0.25))
+        assert "failed" in str(LinkerTiming("mold", error="boom"))
+
+
+class TestSelection:
+    """Test thread candidates and selection."""
+
+    def test_thread_candidates_parallel(self):
+        """Test parallel linkers get several thread counts."""
+        assert thread_candidates("lld", 16) == [None, 4, 8, 16]
+
+    def test_thread_candidates_single_cpu(self):
+        """Test duplicate counts collapse on small hosts."""
+        assert thread_candidates("mold", 1) == [None, 1]
+
+    def test_thread_candidates_serial(self):
+        """Test GNU ld is only measured with its default."""
+        assert thread_candidates("ld", 16) == [None]
+
+    def test_select_fastest_respects_allowed(self):
+        """Test incompatible linkers are skipped even if fastest."""
+        timings = [
+            LinkerTiming("gold", seconds=0.1),
+            LinkerTiming("lld", threads=4, seconds=0.3),
+            LinkerTiming("lld", threads=8, seconds=0.2),
+            LinkerTiming("mold", error="failed"),
+        ]
+
+        assert select_fastest(timings).linker == "gold"
+        best = select_fastest(timings, allowed={"lld", "mold"})
+        assert (best.linker, best.threads) == ("lld", 8)
+        assert select_fastest(timings, allowed={"mold"}) is None
+
+
+class TestDiscovery:
+    """Test linker discovery and fingerprints."""
+
+    def test_find_linker_in_search_dir(self, tmp_path):
+        """Test toolchain directories are searched before PATH."""
+        exe = _fake_exe(tmp_path / "bin" / "ld.lld")
+        assert find_linker("lld", [tmp_path / "bin"]) == exe
+
+    def test_find_linker_missing(self, tmp_path, monkeypatch):
+        """Test None when a linker is not installed."""
+        monkeypatch.setenv("PATH", str(tmp_path))
+        assert find_linker("mold", [tmp_path]) is None
+
+    def test_fingerprint_changes_with_tools(self, tmp_path):
+        """Test fingerprints change when a linker is added or updated."""
+        compiler = _fake_exe(tmp_path / "clang++")
+        lld = _fake_exe(tmp_path / "ld.lld")
+
+        base = toolchain_fingerprint(compiler, {})
+        with_lld = toolchain_fingerprint(compiler, {"lld": lld})
+        assert base != with_lld
+        assert with_lld == toolchain_fingerprint(compiler, {"lld": lld})
+
+        lld.write_text("#!/bin/sh\n# upgraded\n")
+        assert toolchain_fingerprint(compiler, {"lld": lld}) != with_lld
+
+
+class TestLinkerSelectionCache:
+    """Test the measurement cache."""
+
+    def test_roundtrip(self, tmp_path):
+        """Test timings survive a save/load cycle."""
+        cache = LinkerSelectionCache(tmp_path / "cache.json")
+        timings = [LinkerTiming("lld", 4, 0.2, 3), LinkerTiming("ld", error="x")]
+
+        assert cache.get("abc", 8) is None
+        cache.put("abc", 8, timings, Path("/usr/bin/clang++"))
+
+        assert cache.get("abc", 8) == timings
+
+    def test_keyed_by_cpu_count(self, tmp_path):
+        """Test a different host CPU count needs a new measurement."""
+        cache = LinkerSelectionCache(tmp_path / "cache.json")
+        cache.put("abc", 8, [LinkerTiming("lld", seconds=0.2)])
+
+        assert cache.get("abc", 16) is None
+        assert cache.get("other", 8) is None
+
+    def test_corrupt_file(self, tmp_path):
+        """Test a corrupt cache is treated as empty."""
+        path = tmp_path / "cache.json"
+        path.write_text("{not json")
+        cache = LinkerSelectionCache(path)
+
+        assert cache.get("abc", 8) is None
+        cache.put("abc", 8, [LinkerTiming("lld", seconds=0.2)])
+        assert cache.get("abc", 8)
+
+
+class TestLinkerBenchmark:
+    """Test link command construction and measurement."""
+
+    def test_project_link_command(self, tmp_path):
+        """Test replayed project links swap linker flags and output."""
+        bench = LinkerBenchmark(
+            Path("/usr/bin/c++"),
+            tmp_path,
+            link_command=[
+                "/usr/bin/c++",
+                "-fuse-ld=lld",
+                "-Wl,--threads=2",
+                "main.o",
+                "-o",
+                "bin/app",
+            ],
+        )
+        command = bench._command(LinkerTiming("mold", threads=4), tmp_path / "x.out")
+
+        assert command == [
+            "/usr/bin/c++",
+            "main.o",
+            "-o",
+            str(tmp_path / "x.out"),
+            "-fuse-ld=mold",
+            "-Wl,--thread-count=4",
+        ]
+
+    def test_failed_link_is_reported(self, tmp_path):
+        """Test failures are recorded instead of raised."""
+        bench = LinkerBenchmark(
+            Path("/nonexistent/c++"), tmp_path, link_command=["/nonexistent/c++"]
+        )
+        timing = bench.measure("lld")
+
+        assert not timing.ok
+        assert timing.error
+
+    @pytest.mark.skipif(
+        os.name != "posix" or not shutil.which("g++") or not shutil.which("ld.bfd"),
+        reason="requires g++ and GNU ld",
+    )
+    def test_synthetic_link(self, tmp_path):
+        """Test a real synthetic link with GNU ld."""
+        bench = LinkerBenchmark(
+            Path(shutil.which("g++")), tmp_path, units=2, functions=5, repeats=1
+        )
+        timings = bench.run(bench.available_linkers(["ld"]), cpu_count=2)
+
+        assert len(timings) == 1
+        assert timings[0].ok, timings[0].error
+        assert timings[0].runs == 1
+        assert len(list((tmp_path / "obj").glob("*.o"))) == 3
@@ -26,6 +26,7 @@ def temp_metadata_file(tmp_path):
                             "sha256": "abc123",
                             "size_mb": 500,
                             "stdlib": ["libc++", "libstdc++"],
+                            "mirrors": ["https://mirror.example.com/llvm.tar.xz"],
                         },
                         "windows-x64": {
                             "url": "https://example.com/llvm-18.1.8-win.exe",
@@ -175,6 +176,7 @@ class TestToolchainLookup:
         assert metadata.sha256 == "abc123"
         assert metadata.size_mb == 500
         assert "libc++" in metadata.stdlib
+        assert metadata.mirrors == ["https://mirror.example.com/llvm.tar.xz"]
 
     def test_lookup_windows_installer(self, registry):
         """Test lookup for Windows installer."""
@@ -0,0 +1,338 @@
+"""
+Unit tests for lock file driven prefetch and offline bundles.
+
+Tests concurrent prefetch (with mocked downloaders) and bundle export/import
+round trips verified against a lock file.
+"""
+
+import hashlib
+from unittest.mock import Mock, patch
+
+import pytest
+
+from toolchainkit.config.lockfile import LockedComponent, LockFile
+from toolchainkit.core.bundle import BundleError, BundleWriter
+from toolchainkit.core.cache_registry import ToolchainCacheRegistry
+from toolchainkit.core.manifest import IntegrityManifest
+from toolchainkit.core.platform import PlatformInfo
+from toolchainkit.toolchain.prefetch import (
+    export_bundle,
+    import_bundle,
+    pin_tree_digests,
+    prefetch_from_lock,
+)
+
+TOOL_BYTES = b"#!/bin/sh\necho mytool\n"
+
+
+@pytest.fixture
+def platform():
+    """Linux x64 platform."""
+    return PlatformInfo(
+        os="linux",
+        arch="x64",
+        os_version="5.15",
+        distribution="ubuntu",
+        abi="glibc-2.31",
+    )
+
+
+@pytest.fixture
+def lock():
+    """Lock file with one toolchain, one single-file tool and one sysroot."""
+    return LockFile(
+        toolchains={
+            "llvm-18-linux-x64": LockedComponent(
+                url="https://example.com/llvm.tar.xz", sha256="a" * 64, size_bytes=10
+            )
+        },
+        build_tools={
+            "mytool": LockedComponent(
+                url="https://example.com/mytool",
+                sha256="sha256:" + hashlib.sha256(TOOL_BYTES).hexdigest(),
+                size_bytes=len(TOOL_BYTES),
+            )
+        },
+        sysroots={
+            "rpi": LockedComponent(
+                url="https://example.com/rpi.tar.gz",
+                sha256="b" * 64,
+                size_bytes=10,
+                version="11",
+            )
+        },
+    )
+
+
+@pytest.fixture
+def cache(tmp_path):
+    """Global cache with the components of the lock fixture installed."""
+    cache_dir = tmp_path / "online"
+    toolchain = cache_dir / "toolchains" / "llvm-18-linux-x64"
+    (toolchain / "bin").mkdir(parents=True)
+    (toolchain / "bin" / "clang").write_bytes(b"clang" * 5000)
+    (toolchain / "lib").mkdir()
+    (toolchain / "lib" / "libc++.a").write_bytes(b"lib" * 300)
+    ToolchainCacheRegistry(cache_dir / "registry.json").register_toolchain(
+        "llvm-18-linux-x64",
+        toolchain,
+        size_mb=1,
+        hash_value="sha256:" + "a" * 64,
+        source_url="https://example.com/llvm.tar.xz",
+    )
+    (cache_dir / "tools").mkdir()
+    (cache_dir / "tools" / "mytool").write_bytes(TOOL_BYTES)
+    sysroot = cache_dir / "sysroots" / "rpi-11" / "usr" / "include"
+    sysroot.mkdir(parents=True)
+    (sysroot / "stdio.h").write_text("int printf(const char*, ...);")
+    return cache_dir
+
+
+@pytest.fixture
+def pinned(lock, cache, platform):
+    """The lock fixture with tree digests of the installed components."""
+    assert all(r.success for r in pin_tree_digests(lock, cache, platform))
+    return lock
+
+
+class TestPinTreeDigests:
+    """Test recording installed tree digests in the lock file."""
+
+    def test_pin(self, lock, cache, platform):
+        """Test every component gets a digest and trees get a manifest."""
+        results = pin_tree_digests(lock, cache, platform)
+
+        assert all(r.success for r in results), results
+        assert all(
+            c.tree_sha256.startswith("sha256:")
+            for c in [*lock.toolchains.values(), *lock.build_tools.values()]
+        )
+        assert "tree_sha256" in lock.sysroots["rpi"].to_dict()
+        assert IntegrityManifest.load(cache / "sysroots" / "rpi-11") is not None
+
+    def test_pin_refuses_modified_tree(self, lock, cache, platform):
+        """Test files changed since install are not pinned."""
+        toolchain = cache / "toolchains" / "llvm-18-linux-x64"
+        IntegrityManifest.create(toolchain).save()
+        (toolchain / "bin" / "clang").write_bytes(b"evil" * 6250)
+
+        results = pin_tree_digests(lock, cache, platform)
+
+        failed = {r.name: r.error for r in results if not r.success}
+        assert list(failed) == ["llvm-18-linux-x64"]
+        assert "changed since it was installed" in failed["llvm-18-linux-x64"]
+        assert lock.toolchains["llvm-18-linux-x64"].tree_sha256 is None
+
+
+class TestBundleRoundTrip:
+    """Test export on one cache and import into another."""
+
+    def test_export_import(self, tmp_path, pinned, cache, platform):
+        """Test every locked component arrives intact and registered."""
+        bundle = tmp_path / "deps.tkb"
+        offline = tmp_path / "offline"
+
+        components = export_bundle(pinned, bundle, cache_dir=cache, platform=platform)
+        results = import_bundle(bundle, pinned, cache_dir=offline, workers=2)
+
+        assert [(c.kind, c.name) for c in components] == [
+            ("toolchain", "llvm-18-linux-x64"),
+            ("tool", "mytool"),
+            ("sysroot", "rpi"),
+        ]
+        assert all(r.success and not r.cached for r in results), results
+        toolchain = offline / "toolchains" / "llvm-18-linux-x64"
+        assert (toolchain / "bin" / "clang").read_bytes() == b"clang" * 5000
+        assert (offline / "tools" / "mytool").read_bytes() == TOOL_BYTES
+        assert (
+            offline / "sysroots" / "rpi-11" / "usr" / "include" / "stdio.h"
+        ).exists()
+
+        info = ToolchainCacheRegistry(offline / "registry.json").get_toolchain_info(
+            "llvm-18-linux-x64"
+        )
+        assert info["hash"] == "sha256:" + "a" * 64
+        assert info["verified"]
+        assert IntegrityManifest.load(toolchain).verify().ok
+
+    def test_import_twice_is_cached(self, tmp_path, pinned, cache, platform):
+        """Test components already in the cache are not unpacked again."""
+        bundle = tmp_path / "deps.tkb"
+        export_bundle(pinned, bundle, cache_dir=cache, platform=platform)
+        import_bundle(bundle, pinned, cache_dir=tmp_path / "offline")
+
+        results = import_bundle(bundle, pinned, cache_dir=tmp_path / "offline")
+
+        assert all(r.success and r.cached for r in results)
+
+    def test_export_missing_component(self, tmp_path, lock, cache, platform):
+        """Test export refuses a lock with components that are not installed."""
+        (cache / "tools" / "mytool").unlink()
+
+        with pytest.raises(BundleError, match="tool mytool"):
+            export_bundle(lock, tmp_path / "x.tkb", cache_dir=cache, platform=platform)
+        assert not (tmp_path / "x.tkb").exists()
+
+    def test_export_requires_pinned_lock(self, tmp_path, lock, cache, platform):
+        """Test export refuses components without a tree digest."""
+        with pytest.raises(BundleError, match="tkgen bundle pin"):
+            export_bundle(lock, tmp_path / "x.tkb", cache_dir=cache, platform=platform)
+
+    def test_export_refuses_modified_tree(self, tmp_path, pinned, cache, platform):
+        """Test trees changed since pinning are not exported."""
+        clang = cache / "toolchains" / "llvm-18-linux-x64" / "bin" / "clang"
+        clang.write_bytes(b"evil" * 6250)
+
+        with pytest.raises(BundleError, match="changed since it was installed"):
+            export_bundle(
+                pinned, tmp_path / "x.tkb", cache_dir=cache, platform=platform
+            )
+
+    def test_import_rejects_tampered_bundle(self, tmp_path, pinned, cache, platform):
+        """Test a bundle claiming the locked hashes is checked by content."""
+        toolchain = cache / "toolchains" / "llvm-18-linux-x64"
+        (toolchain / "bin" / "clang").write_bytes(b"evil" * 6250)
+        bundle = tmp_path / "evil.tkb"
+        with BundleWriter(bundle) as writer:
+            writer.add_tree(
+                "toolchain",
+                "llvm-18-linux-x64",
+                toolchain,
+                root="toolchains/llvm-18-linux-x64",
+                sha256="a" * 64,
+                metadata={"registry_hash": "sha256:" + "a" * 64},
+            )
+        offline = tmp_path / "offline"
+
+        results = import_bundle(bundle, pinned, cache_dir=offline)
+
+        failed = {r.name: r.error for r in results if not r.success}
+        assert "do not match the lock file" in failed["llvm-18-linux-x64"]
+        assert not (offline / "toolchains" / "llvm-18-linux-x64").exists()
+        registry = ToolchainCacheRegistry(offline / "registry.json")
+        assert registry.get_toolchain_info("llvm-18-linux-x64") is None
+
+    def test_import_requires_pinned_lock(self, tmp_path, pinned, cache, platform):
+        """Test nothing is imported for lock entries without a tree digest."""
+        bundle = tmp_path / "deps.tkb"
+        export_bundle(pinned, bundle, cache_dir=cache, platform=platform)
+        pinned.sysroots["rpi"].tree_sha256 = None
+
+        results = import_bundle(bundle, pinned, cache_dir=tmp_path / "offline")
+
+        failed = {r.name: r.error for r in results if not r.success}
+        assert list(failed) == ["rpi"]
+        assert "tkgen bundle pin" in failed["rpi"]
+
+    def test_import_rejects_different_lock_hash(
+        self, tmp_path, pinned, cache, platform
+    ):
+        """Test a component exported for another pinned hash is refused."""
+        bundle = tmp_path / "deps.tkb"
+        export_bundle(pinned, bundle, cache_dir=cache, platform=platform)
+        pinned.toolchains["llvm-18-linux-x64"].sha256 = "c" * 64
+
+        results = import_bundle(bundle, pinned, cache_dir=tmp_path / "offline")
+
+        failed = {r.name: r.error for r in results if not r.success}
+        assert list(failed) == ["llvm-18-linux-x64"]
+        assert "lock file pins" in failed["llvm-18-linux-x64"]
+        assert not (tmp_path / "offline" / "toolchains" / "llvm-18-linux-x64").exists()
+
+    def test_import_reports_components_not_in_bundle(
+        self, tmp_path, pinned, cache, platform
+    ):
+        """Test locked components missing from the bundle fail the import."""
+        bundle = tmp_path / "deps.tkb"
+        export_bundle(pinned, bundle, cache_dir=cache, platform=platform)
+        pinned.build_tools["other"] = LockedComponent(
+            url="https://example.com/other", sha256="d" * 64, size_bytes=1
+        )
+
+        results = import_bundle(bundle, pinned, cache_dir=tmp_path / "offline")
+
+        assert [r.name for r in results if not r.success] == ["other"]
+
+    def test_import_without_lock(self, tmp_path, pinned, cache, platform):
+        """Test importing every component without a lock file is unverified."""
+        bundle = tmp_path / "deps.tkb"
+        export_bundle(pinned, bundle, cache_dir=cache, platform=platform)
+        offline = tmp_path / "offline"
+
+        results = import_bundle(bundle, cache_dir=offline)
+
+        assert len(results) == 3 and all(r.success for r in results)
+        registry = ToolchainCacheRegistry(offline / "registry.json")
+        assert not registry.get_toolchain_info("llvm-18-linux-x64")["verified"]
+
+
+class TestPrefetch:
+    """Test concurrent prefetch from a lock file."""
+
+    def test_prefetch(self, tmp_path, lock, platform):
+        """Test toolchains and sysroots are fetched with their locked pins."""
+        downloader = Mock()
+        downloader.download_locked.return_value = Mock(
+            toolchain_path=tmp_path / "tc", was_cached=False
+        )
+        sysroots = Mock()
+        sysroots.download_sysroot.return_value = tmp_path / "sysroot"
+        lock.build_tools.clear()
+
+        with (
+            patch(
+                "toolchainkit.toolchain.downloader.ToolchainDownloader",
+                return_value=downloader,
+            ),
+            patch("toolchainkit.cross.sysroot.SysrootManager", return_value=sysroots),
+        ):
+            results = prefetch_from_lock(lock, cache_dir=tmp_path, platform=platform)
+
+        assert [(r.kind, r.name, r.success) for r in results] == [
+            ("toolchain", "llvm-18-linux-x64", True),
+            ("sysroot", "rpi", True),
+        ]
+        kwargs = downloader.download_locked.call_args.kwargs
+        assert kwargs["url"] == "https://example.com/llvm.tar.xz"
+        assert kwargs["sha256"] == "a" * 64
+        spec = sysroots.download_sysroot.call_args.args[0]
+        assert (spec.target, spec.version, spec.hash) == ("rpi", "11", "b" * 64)
+
+    def test_prefetch_failure_is_reported(self, tmp_path, lock, platform):
+        """Test a failed download is reported without stopping the others."""
+        downloader = Mock()
+        downloader.download_locked.side_effect = RuntimeError("404")
+        lock.sysroots.clear()
+
+        with patch(
+            "toolchainkit.toolchain.downloader.ToolchainDownloader",
+            return_value=downloader,
+        ):
+            results = prefetch_from_lock(lock, cache_dir=tmp_path, platform=platform)
+
+        errors = {r.name: r.error for r in results}
+        assert errors["llvm-18-linux-x64"] == "404"
+        assert "No downloader for build tool: mytool" in errors["mytool"]
+
+    def test_prefetch_checks_tool_hash(self, tmp_path, platform):
+        """Test an installed tool whose executable differs from the lock fails."""
+        exe = tmp_path / "tools" / "ninja" / "ninja"
+        exe.parent.mkdir(parents=True)
+        exe.write_bytes(b"ninja")
+        installed = {"ninja": Mock(success=True, path=exe, error=None, seconds=0.1)}
+        lock = LockFile(
+            build_tools={
+                "ninja": LockedComponent(
+                    url="https://example.com/ninja.zip", sha256="e" * 64, size_bytes=5
+                )
+            }
+        )
+
+        with patch(
+            "toolchainkit.packages.tool_installer.ToolInstaller"
+        ) as installer_cls:
+            installer_cls.return_value.install.return_value = installed
+            results = prefetch_from_lock(lock, cache_dir=tmp_path, platform=platform)
+
+        assert not results[0].success
+        assert "Build tool hash mismatch: ninja" in results[0].error
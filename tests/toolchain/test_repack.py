@@ -0,0 +1,165 @@
+"""
+Unit tests for seekable re-packs of downloaded archives.
+
+Tests the repack setting, provenance checks and the downloader installing
+from, falling back from and adding components from a re-pack.
+"""
+
+import shutil
+import tarfile
+from unittest.mock import patch
+
+import pytest
+
+from toolchainkit.toolchain.downloader import ToolchainDownloader
+from toolchainkit.toolchain.metadata_registry import ToolchainMetadata
+from toolchainkit.toolchain.repack import (
+    REPACK_ENV,
+    open_repacked,
+    repack_archive,
+    repack_enabled,
+    repacked_path,
+    set_repack,
+)
+
+FILES = {
+    "bin/clang": b"clang" * 10_000,
+    "bin/lldb": b"lldb" * 1000,
+    "README.txt": b"readme",
+}
+COMPONENTS = {"compiler": ["bin/clang"], "debugger": ["bin/lldb"]}
+
+
+@pytest.fixture(autouse=True)
+def reset_repack():
+    """Clear the process-wide setting after each test."""
+    yield
+    set_repack(None)
+
+
+@pytest.fixture
+def archive(tmp_path):
+    """tar.xz with a top-level directory."""
+    source = tmp_path / "source" / "llvm-18.1.8"
+    for rel, data in FILES.items():
+        (source / rel).parent.mkdir(parents=True, exist_ok=True)
+        (source / rel).write_bytes(data)
+    path = tmp_path / "llvm-18.1.8-linux.tar.xz"
+    with tarfile.open(path, "w:xz") as tar:
+        tar.add(source, arcname=source.name)
+    return path
+
+
+@pytest.fixture
+def downloader(tmp_path, archive):
+    """Downloader whose registry serves the test archive."""
+    downloader = ToolchainDownloader(cache_dir=tmp_path / "cache")
+    metadata = ToolchainMetadata(
+        url=f"https://example.com/{archive.name}",
+        sha256="ABC",
+        size_mb=1,
+        components=COMPONENTS,
+        profiles={"minimal": ["compiler"]},
+    )
+    downloader.metadata_registry.lookup = lambda *args: metadata
+    downloader.metadata_registry.resolve_version = lambda *args: "18.1.8"
+    return downloader
+
+
+@pytest.fixture
+def download(archive):
+    """Patched download_file copying the test archive."""
+
+    def fake(url, destination, **kwargs):
+        shutil.copy(archive, destination)
+
+    with patch(
+        "toolchainkit.toolchain.downloader.download_file", side_effect=fake
+    ) as mock:
+        yield mock
+
+
+class TestSetting:
+    def test_environment(self, monkeypatch):
+        monkeypatch.delenv(REPACK_ENV, raising=False)
+        assert not repack_enabled()
+        monkeypatch.setenv(REPACK_ENV, "yes")
+        assert repack_enabled()
+        set_repack(False)
+        assert not repack_enabled()
+
+
+class TestRepack:
+    def test_roundtrip_and_provenance(self, tmp_path, archive):
+        path = repack_archive(archive, "sha256:ABC", "https://example.com/x")
+        assert path == repacked_path(archive)
+        assert archive.exists()
+
+        repacked = open_repacked(archive, "abc")
+        assert repacked.sha256 == "ABC"
+        assert repacked.component.metadata["url"] == "https://example.com/x"
+        assert repacked.read("llvm-18.1.8/bin/lldb") == FILES["bin/lldb"]
+
+        repacked.extract(tmp_path / "out")
+        for rel, data in FILES.items():
+            assert (tmp_path / "out" / "llvm-18.1.8" / rel).read_bytes() == data
+
+    def test_other_archive_is_ignored(self, archive):
+        repack_archive(archive, "abc")
+        assert open_repacked(archive, "def") is None
+        repacked_path(archive).write_bytes(b"garbage")
+        assert open_repacked(archive, "abc") is None
+
+
+class TestDownloaderRepack:
+    def test_install_repacks_and_reinstall_uses_it(self, downloader, download):
+        set_repack(True)
+        result = downloader.download_toolchain("llvm", "18", "linux-x64")
+
+        archive_path = downloader.downloads_dir / "llvm-18.1.8-linux.tar.xz"
+        bundle = repacked_path(archive_path)
+        assert bundle.exists()
+        assert not archive_path.exists()
+        artifacts = downloader.cache_registry.list_artifacts()
+        assert list(artifacts) == [str(bundle.resolve())]
+
+        shutil.rmtree(result.toolchain_path)
+        again = downloader.download_toolchain("llvm", "18", "linux-x64", force=True)
+        assert download.call_count == 1
+        assert (again.toolchain_path / "bin" / "clang").read_bytes() == (
+            FILES["bin/clang"]
+        )
+
+    def test_components_from_repack(self, downloader, download):
+        set_repack(True)
+        result = downloader.download_toolchain(
+            "llvm", "18", "linux-x64", components="minimal"
+        )
+        assert not (result.toolchain_path / "bin" / "lldb").exists()
+
+        assert downloader.materialize_components(result.toolchain_id, ["debugger"])
+        assert download.call_count == 1
+        assert (result.toolchain_path / "bin" / "lldb").read_bytes() == (
+            FILES["bin/lldb"]
+        )
+
+    def test_corrupt_repack_falls_back(self, downloader, download, archive):
+        repack_archive(archive, "abc")
+        bundle = downloader.downloads_dir / repacked_path(archive).name
+        data = bytearray(repacked_path(archive).read_bytes())
+        data[20:40] = bytes(20)
+        bundle.write_bytes(bytes(data))
+
+        result = downloader.download_toolchain("llvm", "18", "linux-x64")
+
+        assert download.call_count == 1
+        assert not bundle.exists()
+        assert (result.toolchain_path / "README.txt").read_bytes() == b"readme"
+
+    def test_disabled_keeps_archive(self, downloader, download, monkeypatch):
+        monkeypatch.delenv(REPACK_ENV, raising=False)
+        downloader.download_toolchain("llvm", "18", "linux-x64")
+
+        archive_path = downloader.downloads_dir / "llvm-18.1.8-linux.tar.xz"
+        assert archive_path.exists()
+        assert not repacked_path(archive_path).exists()
@@ -15,6 +15,7 @@ from toolchainkit.toolchain.verifier import (
     FilePresenceCheck,
     SymlinkCheck,
     ExecutabilityCheck,
+    IntegrityCheck,
     VersionCheck,
     ABICheck,
     CompileTestCheck,
@@ -231,6 +232,47 @@ class TestSymlinkCheck:
         assert "broken symlink" in result.message.lower()
 
 
+# Test IntegrityCheck
+
+
+class TestIntegrityCheck:
+    def test_no_manifest(self, tmp_path, llvm_spec):
+        """Test integrity check passes when no manifest was written."""
+        result = IntegrityCheck().check(tmp_path, llvm_spec)
+
+        assert result.passed is True
+        assert "no integrity manifest" in result.message.lower()
+
+    def test_modified_file(self, tmp_path, llvm_spec):
+        """Test integrity check detects a file changed after install."""
+        from toolchainkit.core.manifest import write_manifest
+
+        (tmp_path / "bin").mkdir()
+        (tmp_path / "bin" / "clang").write_bytes(b"clang")
+        write_manifest(tmp_path)
+        (tmp_path / "bin" / "clang").write_bytes(b"patched")
+
+        result = IntegrityCheck().check(tmp_path, llvm_spec)
+
+        assert result.passed is False
+        assert result.details["modified"] == ["bin/clang"]
+
+    def test_unexpected_file_warns(self, tmp_path, llvm_spec):
+        """Test files added after install only fail the strict check."""
+        from toolchainkit.core.manifest import write_manifest
+
+        (tmp_path / "bin").mkdir()
+        (tmp_path / "bin" / "clang").write_bytes(b"clang")
+        write_manifest(tmp_path)
+        (tmp_path / "bin" / "notes.txt").write_text("mine")
+
+        result = IntegrityCheck().check(tmp_path, llvm_spec)
+        assert result.passed is True
+        assert "bin/notes.txt" in result.warning
+
+        assert IntegrityCheck(strict=True).check(tmp_path, llvm_spec).passed is False
+
+
 # Test ExecutabilityCheck
 
 
@@ -529,17 +571,21 @@ class TestToolchainVerifier:
         verifier = ToolchainVerifier(linux_platform)
         checks = verifier.all_checks[VerificationLevel.THOROUGH]
 
-        assert len(checks) == 5
+        assert len(checks) == 6
         assert any(isinstance(c, ABICheck) for c in checks)
         assert any(isinstance(c, SymlinkCheck) for c in checks)
+        assert any(isinstance(c, IntegrityCheck) and not c.deep for c in checks)
 
     def test_paranoid_checks(self, linux_platform):
         """Test PARANOID level has correct checks."""
         verifier = ToolchainVerifier(linux_platform)
         checks = verifier.all_checks[VerificationLevel.PARANOID]
 
-        assert len(checks) == 6
+        assert len(checks) == 7
         assert any(isinstance(c, CompileTestCheck) for c in checks)
+        assert any(
+            isinstance(c, IntegrityCheck) and c.deep and c.strict for c in checks
+        )
 
     def test_verify_minimal_success(self, tmp_path, linux_platform, llvm_spec):
         """Test verification at MINIMAL level - success."""
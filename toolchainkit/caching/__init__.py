@@ -8,8 +8,15 @@ Modules:
     detection: Detect and install build cache tools (sccache, ccache)
     launcher: Configure compiler launcher for CMake integration
     remote: Configure remote cache backends (S3, Redis)
+    server: Embedded HTTP cache server with disk-backed LRU storage
+    tiered: Two-tier (local + remote) store for the cache server
+    benchmark: Latency/throughput benchmark and selection of remote backends
 """
 
+from .benchmark import (
+    BackendBenchmark,
+    RemoteCacheBenchmark,
+)
 from .detection import (
     BuildCacheConfig,
     BuildCacheDetector,
@@ -25,14 +32,24 @@ from .remote import (
     RemoteCacheConfigurator,
     SecureCredentialHandler,
 )
+from .server import (
+    CacheServer,
+    CacheServerStats,
+    DiskLRUStore,
+)
 
 __all__ = [
+    "BackendBenchmark",
     "BuildCacheConfig",
     "BuildCacheDetector",
     "BuildCacheInstaller",
     "BuildCacheManager",
+    "CacheServer",
+    "CacheServerStats",
     "CacheStats",
     "CompilerLauncherConfig",
+    "DiskLRUStore",
+    "RemoteCacheBenchmark",
     "RemoteCacheConfig",
     "RemoteCacheConfigurator",
     "SecureCredentialHandler",
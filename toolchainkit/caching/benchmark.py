@@ -0,0 +1,545 @@
+"""
+Latency/throughput benchmark for remote compiler cache backends.
+
+Replays a synthetic compile workload (a put followed by a get per object,
+object sizes drawn log-uniformly between 4 KB and 2 MB) against each
+configured backend at a fixed concurrency, and reports p50/p99 latency and
+MB/s. The fastest reachable backend can then be selected automatically.
+
+The HTTP, Redis and Memcached clients speak the wire protocols directly, so
+no client libraries are needed; S3 uses boto3 when installed.
+
+Usage:
+    from toolchainkit.caching.benchmark import RemoteCacheBenchmark
+    from toolchainkit.caching.remote import RemoteCacheConfig
+
+    candidates = [
+        RemoteCacheConfig(backend_type="http", endpoint="http://cache:8420/"),
+        RemoteCacheConfig(backend_type="redis", endpoint="redis://cache:6379"),
+    ]
+    bench = RemoteCacheBenchmark(objects=200, concurrency=8)
+    results = bench.run_all(candidates)
+    best = RemoteCacheBenchmark.select_fastest(results)
+"""
+
+import logging
+import math
+import random
+import socket
+import threading
+import time
+import uuid
+from concurrent.futures import ThreadPoolExecutor
+from dataclasses import asdict, dataclass
+from typing import Any, Dict, List, Optional, Sequence
+from urllib.parse import urlparse
+
+from .remote import RemoteCacheConfig
+
+logger = logging.getLogger(__name__)
+
+KEY_PREFIX = "tkbench"
+"""Namespace for benchmark objects (removed after each run)."""
+
+
+def object_size_distribution(
+    count: int,
+    seed: int = 42,
+    min_size: int = 4 * 1024,
+    max_size: int = 2 * 1024 * 1024,
+) -> List[int]:
+    """
+    Draw object sizes log-uniformly, roughly matching C++ object files.
+
+    Args:
+        count: Number of sizes
+        seed: Random seed (the same seed gives the same workload)
+        min_size: Smallest object in bytes
+        max_size: Largest object in bytes
+
+    Returns:
+        List of object sizes in bytes
+    """
+    rng = random.Random(seed)
+    low, high = math.log(min_size), math.log(max_size)
+    return [int(math.exp(rng.uniform(low, high))) for _ in range(count)]
+
+
+def synthetic_payload(size: int, seed: int) -> bytes:
+    """Payload that compresses roughly 2:1, like unstripped object code."""
+    rng = random.Random(seed)
+    noise = rng.randbytes(size // 2)
+    pattern = rng.randbytes(64) * (size // 128 + 1)
+    return (noise + pattern)[:size]
+
+
+def percentile(values: Sequence[float], pct: float) -> float:
+    """Nearest-rank percentile of values (0.0 for an empty sequence)."""
+    if not values:
+        return 0.0
+    ordered = sorted(values)
+    index = min(len(ordered) - 1, int(round(pct / 100.0 * (len(ordered) - 1))))
+    return ordered[index]
+
+
+@dataclass
+class BackendBenchmark:
+    """Benchmark result for one backend."""
+
+    backend: str
+    """Backend type ('http', 'redis', ...)."""
+
+    endpoint: str
+    """Endpoint or bucket that was measured."""
+
+    reachable: bool
+    """Whether the backend accepted the workload."""
+
+    error: Optional[str] = None
+    """First error encountered, if any."""
+
+    operations: int = 0
+    """Completed put/get operations."""
+
+    failures: int = 0
+    """Failed operations."""
+
+    bytes_transferred: int = 0
+    """Payload bytes sent plus received."""
+
+    seconds: float = 0.0
+    """Wall-clock duration of the workload."""
+
+    p50_ms: float = 0.0
+    """Median latency over all operations."""
+
+    p99_ms: float = 0.0
+    """99th percentile latency over all operations."""
+
+    put_p50_ms: float = 0.0
+    """Median put latency."""
+
+    get_p50_ms: float = 0.0
+    """Median get latency."""
+
+    mb_per_sec: float = 0.0
+    """Aggregate payload throughput."""
+
+    def to_dict(self) -> Dict[str, Any]:
+        """Return results as a JSON-serializable dictionary."""
+        return asdict(self)
+
+    def __str__(self) -> str:
+        """Format as a one-line summary."""
+        if not self.reachable:
+            return f"{self.backend:<10} {self.endpoint}: unreachable ({self.error})"
+        return (
+            f"{self.backend:<10} {self.mb_per_sec:8.1f} MB/s  "
+            f"p50 {self.p50_ms:7.2f} ms  p99 {self.p99_ms:7.2f} ms  "
+            f"({self.failures} failed)"
+        )
+
+
+class BackendClient:
+    """Minimal put/get/delete client used by the benchmark."""
+
+    max_object_size: Optional[int] = None
+    """Largest value the backend accepts (objects are clamped to it)."""
+
+    def put(self, key: str, data: bytes) -> None:
+        """Store an object (raise on failure)."""
+        raise NotImplementedError
+
+    def get(self, key: str) -> Optional[bytes]:
+        """Fetch an object, or None if absent."""
+        raise NotImplementedError
+
+    def delete(self, key: str) -> None:
+        """Remove an object (best effort)."""
+
+    def close(self) -> None:
+        """Release connections."""
+
+
+class HTTPBackendClient(BackendClient):
+    """WebDAV/HTTP cache client (sccache webdav/http, ccache http)."""
+
+    def __init__(self, config: RemoteCacheConfig, timeout: float = 30.0):
+        import requests
+
+        self.base = (
+            config.endpoint if config.endpoint.endswith("/") else config.endpoint + "/"
+        )
+        self.timeout = timeout
+        self.session = requests.Session()
+        if config.credentials and "token" in config.credentials:
+            self.session.headers["Authorization"] = (
+                f"Bearer {config.credentials['token']}"
+            )
+
+    def put(self, key: str, data: bytes) -> None:
+        response = self.session.put(self.base + key, data=data, timeout=self.timeout)
+        response.raise_for_status()
+
+    def get(self, key: str) -> Optional[bytes]:
+        response = self.session.get(self.base + key, timeout=self.timeout)
+        if response.status_code == 404:
+            return None
+        response.raise_for_status()
+        return response.content
+
+    def delete(self, key: str) -> None:
+        self.session.delete(self.base + key, timeout=self.timeout)
+
+    def close(self) -> None:
+        self.session.close()
+
+
+class _SocketClient(BackendClient):
+    """Buffered line/byte reader over a TCP connection."""
+
+    def __init__(self, host: str, port: int, timeout: float):
+        self.sock = socket.create_connection((host, port), timeout=timeout)
+        self.sock.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
+        self.reader = self.sock.makefile("rb")
+
+    def _readline(self) -> bytes:
+        line = self.reader.readline()
+        if not line:
+            raise ConnectionError("connection closed by server")
+        return line.rstrip(b"\r\n")
+
+    def _readexact(self, count: int) -> bytes:
+        data = self.reader.read(count)
+        if data is None or len(data) != count:
+            raise ConnectionError("connection closed by server")
+        return data
+
+    def close(self) -> None:
+        try:
+            self.reader.close()
+            self.sock.close()
+        except OSError:
+            pass
+
+
+class RedisBackendClient(_SocketClient):
+    """Redis client speaking RESP (sccache redis backend)."""
+
+    def __init__(self, config: RemoteCacheConfig, timeout: float = 30.0):
+        url = urlparse(config.endpoint)
+        super().__init__(url.hostname or "localhost", url.port or 6379, timeout)
+        try:
+            password = (config.credentials or {}).get("password") or url.password
+            if password:
+                self._command(b"AUTH", password.encode())
+            db = config.extra_config.get("db") or url.path.lstrip("/")
+            if db:
+                self._command(b"SELECT", str(db).encode())
+        except Exception:
+            self.close()
+            raise
+
+    def _command(self, *parts: bytes) -> Optional[bytes]:
+        request = [b"*%d\r\n" % len(parts)]
+        for part in parts:
+            request.append(b"$%d\r\n%s\r\n" % (len(part), part))
+        self.sock.sendall(b"".join(request))
+        return self._reply()
+
+    def _reply(self) -> Optional[bytes]:
+        line = self._readline()
+        kind, rest = line[:1], line[1:]
+        if kind == b"-":
+            raise RuntimeError(f"Redis error: {rest.decode(errors='replace')}")
+        if kind in (b"+", b":"):
+            return rest
+        if kind == b"$":
+            length = int(rest)
+            if length < 0:
+                return None
+            data = self._readexact(length + 2)
+            return data[:-2]
+        raise RuntimeError(f"Unexpected Redis reply: {line[:32]!r}")
+
+    def put(self, key: str, data: bytes) -> None:
+        self._command(b"SET", key.encode(), data)
+
+    def get(self, key: str) -> Optional[bytes]:
+        return self._command(b"GET", key.encode())
+
+    def delete(self, key: str) -> None:
+        self._command(b"DEL", key.encode())
+
+
+class MemcachedBackendClient(_SocketClient):
+    """Memcached client speaking the text protocol (first endpoint only)."""
+
+    max_object_size = 1024 * 1024 - 1024
+    """Default memcached item limit (1 MB) minus item overhead."""
+
+    def __init__(self, config: RemoteCacheConfig, timeout: float = 30.0):
+        first = config.endpoint.split(",")[0].strip()
+        if "://" in first:
+            first = first.split("://", 1)[1]
+        host, _, port = first.partition(":")
+        super().__init__(host or "localhost", int(port or 11211), timeout)
+
+    def put(self, key: str, data: bytes) -> None:
+        self.sock.sendall(b"set %s 0 0 %d\r\n%s\r\n" % (key.encode(), len(data), data))
+        reply = self._readline()
+        if reply != b"STORED":
+            raise RuntimeError(f"Memcached error: {reply.decode(errors='replace')}")
+
+    def get(self, key: str) -> Optional[bytes]:
+        self.sock.sendall(b"get %s\r\n" % key.encode())
+        header = self._readline()
+        if header == b"END":
+            return None
+        if not header.startswith(b"VALUE "):
+            raise RuntimeError(f"Memcached error: {header.decode(errors='replace')}")
+        length = int(header.split()[3])
+        data = self._readexact(length + 2)[:-2]
+        self._readline()  # END
+        return data
+
+    def delete(self, key: str) -> None:
+        self.sock.sendall(b"delete %s\r\n" % key.encode())
+        self._readline()
+
+
+class S3BackendClient(BackendClient):
+    """S3 client (requires boto3)."""
+
+    def __init__(self, config: RemoteCacheConfig, timeout: float = 30.0):
+        import boto3
+
+        kwargs: Dict[str, Any] = {}
+        if config.endpoint:
+            kwargs["endpoint_url"] = config.endpoint
+        if config.region:
+            kwargs["region_name"] = config.region
+        if config.credentials:
+            kwargs["aws_access_key_id"] = config.credentials.get("access_key")
+            kwargs["aws_secret_access_key"] = config.credentials.get("secret_key")
+        self.client = boto3.client("s3", **kwargs)
+        self.bucket = config.bucket
+        self.prefix = (config.prefix or "").strip("/")
+
+    def _key(self, key: str) -> str:
+        return f"{self.prefix}/{key}" if self.prefix else key
+
+    def put(self, key: str, data: bytes) -> None:
+        self.client.put_object(Bucket=self.bucket, Key=self._key(key), Body=data)
+
+    def get(self, key: str) -> Optional[bytes]:
+        try:
+            response = self.client.get_object(Bucket=self.bucket, Key=self._key(key))
+        except self.client.exceptions.NoSuchKey:
+            return None
+        return response["Body"].read()
+
+    def delete(self, key: str) -> None:
+        self.client.delete_object(Bucket=self.bucket, Key=self._key(key))
+
+
+_CLIENTS = {
+    "http": HTTPBackendClient,
+    "redis": RedisBackendClient,
+    "memcached": MemcachedBackendClient,
+    "s3": S3BackendClient,
+}
+
+
+def create_client(config: RemoteCacheConfig, timeout: float = 30.0) -> BackendClient:
+    """
+    Create a benchmark client for a backend configuration.
+
+    Args:
+        config: Remote cache configuration
+        timeout: Per-operation timeout in seconds
+
+    Returns:
+        Connected BackendClient
+
+    Raises:
+        ValueError: If the backend type cannot be benchmarked
+        ImportError: If an optional client library is missing
+        OSError: If the backend cannot be reached
+    """
+    client_class = _CLIENTS.get(config.backend_type)
+    if client_class is None:
+        raise ValueError(f"Benchmarking not supported for {config.backend_type}")
+    return client_class(config, timeout=timeout)
+
+
+def _describe(config: RemoteCacheConfig) -> str:
+    return config.endpoint or config.bucket or ""
+
+
+class RemoteCacheBenchmark:
+    """
+    Replay a compile-like put/get workload against remote cache backends.
+
+    Each object is written once and read back once, from ``concurrency``
+    worker threads that each hold their own connection (like ``-jN``
+    compiler launchers).
+
+    Example:
+        >>> bench = RemoteCacheBenchmark(objects=100, concurrency=4)
+        >>> result = bench.run(RemoteCacheConfig("http", "http://cache:8420/"))
+        >>> print(result.mb_per_sec, result.p99_ms)
+    """
+
+    def __init__(
+        self,
+        objects: int = 200,
+        concurrency: int = 8,
+        min_size: int = 4 * 1024,
+        max_size: int = 2 * 1024 * 1024,
+        seed: int = 42,
+        timeout: float = 30.0,
+    ):
+        """
+        Initialize benchmark workload.
+
+        Args:
+            objects: Number of objects put and fetched per backend
+            concurrency: Parallel connections
+            min_size: Smallest object in bytes
+            max_size: Largest object in bytes
+            seed: Random seed for sizes and payloads
+            timeout: Per-operation timeout in seconds
+        """
+        if objects < 1 or concurrency < 1:
+            raise ValueError("objects and concurrency must be positive")
+        self.objects = objects
+        self.concurrency = concurrency
+        self.sizes = object_size_distribution(objects, seed, min_size, max_size)
+        self.seed = seed
+        self.timeout = timeout
+
+    def run(self, config: RemoteCacheConfig) -> BackendBenchmark:
+        """
+        Benchmark one backend.
+
+        Args:
+            config: Remote cache configuration
+
+        Returns:
+            BackendBenchmark (``reachable`` is False if no connection could be
+            made or every operation failed)
+        """
+        result = BackendBenchmark(
+            backend=config.backend_type, endpoint=_describe(config), reachable=False
+        )
+        try:
+            probe = create_client(config, self.timeout)
+        except Exception as e:
+            result.error = str(e) or type(e).__name__
+            logger.info(f"Benchmark: {config.backend_type} unreachable: {e}")
+            return result
+
+        max_size = probe.max_object_size
+        run_id = uuid.uuid4().hex[:12]
+        work = [
+            (f"{KEY_PREFIX}-{run_id}-{i:06d}", min(size, max_size or size), i)
+            for i, size in enumerate(self.sizes)
+        ]
+
+        local = threading.local()
+        clients = [probe]
+        clients_lock = threading.Lock()
+        put_latencies: List[float] = []
+        get_latencies: List[float] = []
+        errors: List[str] = []
+        transferred = 0
+        stats_lock = threading.Lock()
+
+        def client() -> BackendClient:
+            if not hasattr(local, "client"):
+                local.client = create_client(config, self.timeout)
+                with clients_lock:
+                    clients.append(local.client)
+            return local.client
+
+        def one_object(item) -> None:
+            nonlocal transferred
+            key, size, index = item
+            data = synthetic_payload(size, self.seed + index)
+            try:
+                c = client()
+                start = time.perf_counter()
+                c.put(key, data)
+                put_time = time.perf_counter() - start
+                start = time.perf_counter()
+                fetched = c.get(key)
+                get_time = time.perf_counter() - start
+                if fetched != data:
+                    raise RuntimeError(f"{key}: read back {len(fetched or b'')} bytes")
+            except Exception as e:
+                with stats_lock:
+                    errors.append(f"{type(e).__name__}: {e}")
+                return
+            with stats_lock:
+                put_latencies.append(put_time)
+                get_latencies.append(get_time)
+                transferred += 2 * size
+
+        start = time.perf_counter()
+        with ThreadPoolExecutor(max_workers=self.concurrency) as pool:
+            list(pool.map(one_object, work))
+        elapsed = time.perf_counter() - start
+
+        try:
+            for key, _, _ in work:
+                probe.delete(key)
+        except Exception as e:
+            logger.debug(f"Benchmark cleanup failed: {e}")
+        for c in clients:
+            c.close()
+
+        latencies = put_latencies + get_latencies
+        result.operations = len(latencies)
+        result.failures = 2 * len(errors)
+        result.error = errors[0] if errors else None
+        result.reachable = bool(latencies)
+        result.bytes_transferred = transferred
+        result.seconds = elapsed
+        result.p50_ms = percentile(latencies, 50) * 1000
+        result.p99_ms = percentile(latencies, 99) * 1000
+        result.put_p50_ms = percentile(put_latencies, 50) * 1000
+        result.get_p50_ms = percentile(get_latencies, 50) * 1000
+        result.mb_per_sec = transferred / elapsed / (1024 * 1024) if elapsed else 0.0
+
+        logger.info(f"Benchmark: {result}")
+        return result
+
+    def run_all(self, configs: Sequence[RemoteCacheConfig]) -> List[BackendBenchmark]:
+        """Benchmark backends one after another (so they don't compete)."""
+        return [self.run(config) for config in configs]
+
+    @staticmethod
+    def select_fastest(
+        results: Sequence[BackendBenchmark], criterion: str = "throughput"
+    ) -> Optional[BackendBenchmark]:
+        """
+        Pick the best reachable backend.
+
+        Backends with failed operations rank below clean ones.
+
+        Args:
+            results: Benchmark results
+            criterion: 'throughput' (highest MB/s) or 'latency' (lowest p99)
+
+        Returns:
+            Best result, or None if no backend was reachable
+        """
+        if criterion not in ("throughput", "latency"):
+            raise ValueError(f"Unknown criterion: {criterion}")
+        candidates = [r for r in results if r.reachable]
+        if not candidates:
+            return None
+        if criterion == "throughput":
+            return max(candidates, key=lambda r: (r.failures == 0, r.mb_per_sec))
+        return min(candidates, key=lambda r: (r.failures != 0, r.p99_ms))
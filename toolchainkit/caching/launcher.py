@@ -59,12 +59,27 @@ class CacheStats:
     hit_rate: float
     """Hit rate as percentage (0-100)."""
 
+    local_hits: int = 0
+    """Hits answered by the local tier of a tiered cache server."""
+
+    remote_hits: int = 0
+    """Hits answered by the remote tier of a tiered cache server."""
+
+    bytes_saved: int = 0
+    """Bytes served by the local tier instead of the remote tier."""
+
     def __str__(self) -> str:
         """String representation of cache stats."""
-        return (
+        text = (
             f"CacheStats(hits={self.hits}, misses={self.misses}, "
-            f"errors={self.errors}, hit_rate={self.hit_rate:.1f}%)"
+            f"errors={self.errors}, hit_rate={self.hit_rate:.1f}%"
         )
+        if self.local_hits or self.remote_hits:
+            text += (
+                f", local_hits={self.local_hits}, remote_hits={self.remote_hits}, "
+                f"bytes_saved={self.bytes_saved}"
+            )
+        return text + ")"
 
 
 class CompilerLauncherConfig:
@@ -169,7 +184,7 @@ class CompilerLauncherConfig:
 
         return env_vars
 
-    def get_stats(self) -> Optional[CacheStats]:
+    def get_stats(self, include_tiers: bool = True) -> Optional[CacheStats]:
         """
         Get cache statistics from the cache tool.
 
@@ -177,6 +192,12 @@ class CompilerLauncherConfig:
         - sccache: `sccache --show-stats`
         - ccache: `ccache --show-stats`
 
+        When a tiered local cache server is running, its local/remote hit
+        counters are merged in.
+
+        Args:
+            include_tiers: Query a running tiered cache server for tier metrics
+
         Returns:
             CacheStats object with statistics, or None if unavailable
 
@@ -188,13 +209,21 @@ class CompilerLauncherConfig:
         """
         try:
             if self.cache_config.tool == "sccache":
-                return self._get_sccache_stats()
+                stats = self._get_sccache_stats()
             elif self.cache_config.tool == "ccache":
-                return self._get_ccache_stats()
+                stats = self._get_ccache_stats()
             else:
                 logger.warning(f"Unknown cache tool: {self.cache_config.tool}")
                 return None
 
+            if include_tiers:
+                tier_stats = self._get_tier_stats()
+                if tier_stats:
+                    stats.local_hits = tier_stats.get("local_hits", 0)
+                    stats.remote_hits = tier_stats.get("remote_hits", 0)
+                    stats.bytes_saved = tier_stats.get("bytes_saved", 0)
+            return stats
+
         except subprocess.TimeoutExpired:
             logger.error(f"Timeout getting stats from {self.cache_config.tool}")
             return None
@@ -205,6 +234,20 @@ class CompilerLauncherConfig:
             logger.error(f"Unexpected error getting stats: {e}", exc_info=True)
             return None
 
+    def _get_tier_stats(self) -> Optional[Dict[str, int]]:
+        """
+        Fetch counters from a running tiered local cache server.
+
+        Returns:
+            Server statistics dictionary, or None if no tiered server is running
+        """
+        from .server import fetch_server_stats
+
+        stats = fetch_server_stats()
+        if not stats or "local_hits" not in stats:
+            return None
+        return stats
+
     def _get_sccache_stats(self) -> CacheStats:
         """
         Parse sccache --show-stats output.
@@ -31,11 +31,14 @@ Usage:
 
 import logging
 from dataclasses import dataclass, field
-from typing import Dict, Optional, Tuple
+from typing import TYPE_CHECKING, Dict, List, Optional, Sequence, Tuple
 from urllib.parse import urlparse
 
 from .detection import BuildCacheConfig
 
+if TYPE_CHECKING:
+    from .benchmark import BackendBenchmark
+
 logger = logging.getLogger(__name__)
 
 
@@ -90,6 +93,72 @@ class RemoteCacheConfig:
                 f"{self.backend_type} backend requires 'endpoint' parameter"
             )
 
+    @classmethod
+    def from_url(cls, url: str) -> "RemoteCacheConfig":
+        """
+        Build a configuration from a backend URL.
+
+        Supported schemes: http(s)://, redis(s)://, memcached://host:port,
+        s3://bucket/prefix and gs://bucket/prefix.
+
+        Args:
+            url: Backend URL
+
+        Returns:
+            RemoteCacheConfig for the backend
+
+        Raises:
+            ValueError: If the scheme is not recognized
+
+        Example:
+            >>> RemoteCacheConfig.from_url("redis://cache:6379/1").backend_type
+            'redis'
+        """
+        parts = urlparse(url)
+        scheme = parts.scheme.lower()
+        if scheme in ("http", "https"):
+            return cls(backend_type="http", endpoint=url)
+        if scheme in ("redis", "rediss"):
+            return cls(backend_type="redis", endpoint=url)
+        if scheme in ("memcached", "memcache"):
+            return cls(backend_type="memcached", endpoint=parts.netloc)
+        if scheme in ("s3", "gs"):
+            return cls(
+                backend_type="s3" if scheme == "s3" else "gcs",
+                bucket=parts.netloc,
+                prefix=parts.path.strip("/") or None,
+            )
+        raise ValueError(f"Unrecognized remote cache URL: {url}")
+
+    @classmethod
+    def from_dict(cls, data: Dict) -> "RemoteCacheConfig":
+        """
+        Build a configuration from a ``build.caching.remote`` entry.
+
+        Args:
+            data: Mapping with 'type' and 'endpoint' (plus optional 'bucket',
+                'region', 'prefix', 'credentials')
+
+        Returns:
+            RemoteCacheConfig for the backend
+        """
+        backend = data.get("type") or data.get("backend_type")
+        endpoint = str(data.get("endpoint", ""))
+        if not backend:
+            return cls.from_url(endpoint)
+        if backend in ("s3", "gcs") and "bucket" not in data and "://" in endpoint:
+            config = cls.from_url(endpoint)
+            config.region = data.get("region", config.region)
+            return config
+        return cls(
+            backend_type=backend,
+            endpoint=endpoint,
+            credentials=data.get("credentials"),
+            bucket=data.get("bucket"),
+            region=data.get("region", "us-east-1"),
+            prefix=data.get("prefix"),
+        )
+
 
 class SecureCredentialHandler:
     """Handle credentials securely without logging sensitive data."""
@@ -100,6 +169,7 @@ class SecureCredentialHandler:
         "AWS_SECRET_ACCESS_KEY",
         "SCCACHE_REDIS_PASSWORD",
         "SCCACHE_HTTP_TOKEN",
+        "SCCACHE_WEBDAV_TOKEN",
         "GCS_CREDENTIALS_PATH",
     }
 
@@ -418,8 +488,115 @@ class RemoteCacheConfigurator:
 
         return env_vars
 
+    def configure_local_server(
+        self, url: Optional[str] = None, token: Optional[str] = None
+    ) -> Dict[str, str]:
+        """
+        Configure the cache tool to use an embedded ToolchainKit cache server.
+
+        When no URL is given, the server advertised by a running
+        ``tkgen cache serve`` in the global cache directory is used.
+
+        Environment Variables:
+        - SCCACHE_WEBDAV_ENDPOINT: Server URL (sccache WebDAV backend)
+        - SCCACHE_WEBDAV_TOKEN: Bearer token (sccache)
+        - CCACHE_REMOTE_STORAGE: Server URL with attributes (ccache HTTP storage)
+
+        Args:
+            url: Server base URL (e.g., 'http://buildbox:8420/')
+            token: Bearer token if the server requires one
+
+        Returns:
+            Dictionary of environment variables, empty if no server was found
+        """
+        if url is None:
+            from .server import find_local_server
+
+            found = find_local_server()
+            if found is None:
+                logger.info("No running local cache server found")
+                return {}
+            url, token_required = found
+            if token_required and not token:
+                logger.warning("Local cache server requires a token; none provided")
+
+        env_vars: Dict[str, str] = {}
+        if self.cache_config.tool == "sccache":
+            env_vars["SCCACHE_WEBDAV_ENDPOINT"] = url
+            if token:
+                env_vars["SCCACHE_WEBDAV_TOKEN"] = token
+        else:
+            storage = url.rstrip("/")
+            if token:
+                storage += f"|bearer-token={token}"
+            env_vars["CCACHE_REMOTE_STORAGE"] = storage
+
+        # Log (sanitized)
+        sanitized = SecureCredentialHandler.sanitize_for_logging(env_vars)
+        logger.debug(f"Configured local cache server: {sanitized}")
+
+        return env_vars
+
+    def benchmark(
+        self, configs: Sequence[RemoteCacheConfig], **kwargs
+    ) -> List["BackendBenchmark"]:
+        """
+        Measure latency and throughput of remote backends.
+
+        Replays a compile-like put/get workload against each backend in turn.
+
+        Args:
+            configs: Candidate backend configurations
+            **kwargs: Workload options for RemoteCacheBenchmark
+                (objects, concurrency, min_size, max_size, seed, timeout)
+
+        Returns:
+            One BackendBenchmark per configuration, in order
+        """
+        from .benchmark import RemoteCacheBenchmark
+
+        return RemoteCacheBenchmark(**kwargs).run_all(configs)
+
+    def select_backend(
+        self,
+        configs: Sequence[RemoteCacheConfig],
+        criterion: str = "throughput",
+        **kwargs,
+    ) -> Tuple[Optional[RemoteCacheConfig], List["BackendBenchmark"]]:
+        """
+        Benchmark candidate backends and pick the fastest reachable one.
+
+        Args:
+            configs: Candidate backend configurations
+            criterion: 'throughput' (highest MB/s) or 'latency' (lowest p99)
+            **kwargs: Workload options for RemoteCacheBenchmark
+
+        Returns:
+            Tuple of (selected configuration or None, all benchmark results)
+
+        Example:
+            >>> best, results = configurator.select_backend([http_cfg, redis_cfg])
+            >>> env_vars = configurator.get_all_env_vars(best)
+        """
+        from .benchmark import RemoteCacheBenchmark
+
+        results = self.benchmark(configs, **kwargs)
+        best = RemoteCacheBenchmark.select_fastest(results, criterion)
+        if best is None:
+            logger.warning("No reachable remote cache backend")
+            return None, results
+
+        selected = configs[results.index(best)]
+        logger.info(
+            f"Selected {selected.backend_type} remote cache "
+            f"({best.mb_per_sec:.1f} MB/s, p99 {best.p99_ms:.1f} ms)"
+        )
+        return selected, results
+
     def get_all_env_vars(
-        self, remote_config: Optional[RemoteCacheConfig] = None
+        self,
+        remote_config: Optional[RemoteCacheConfig] = None,
+        candidates: Optional[Sequence[RemoteCacheConfig]] = None,
     ) -> Dict[str, str]:
         """
         Get all environment variables including local + remote.
@@ -428,6 +605,8 @@ class RemoteCacheConfigurator:
 
         Args:
             remote_config: Optional remote cache configuration
+            candidates: Optional backends to auto-select from by benchmark
+                (used when remote_config is not given)
 
         Returns:
             Dictionary with all environment variables
@@ -438,6 +617,9 @@ class RemoteCacheConfigurator:
         launcher = CompilerLauncherConfig(self.cache_config)
         env_vars = launcher.configure_environment()
 
+        if remote_config is None and candidates:
+            remote_config, _ = self.select_backend(candidates)
+
         # Add remote backend if configured
         if remote_config:
             remote_env = self.configure(remote_config)
@@ -0,0 +1,835 @@
+"""
+Embedded compiler cache server for LAN sharing and hermetic testing.
+
+This module provides a small HTTP cache server that speaks the subset of
+HTTP used by sccache's WebDAV backend and ccache's HTTP remote storage:
+objects are stored with PUT and fetched with GET/HEAD on ``/<key>`` paths.
+Objects live in a disk-backed LRU store with a configurable size limit and
+are compressed per key when that actually saves space (objects produced by
+sccache are usually compressed already).
+
+Usage:
+    from pathlib import Path
+    from toolchainkit.caching.server import CacheServer, DiskLRUStore
+
+    store = DiskLRUStore(Path("~/.toolchainkit/cache-server").expanduser(),
+                         max_size="10G")
+    with CacheServer(store, host="0.0.0.0", port=8420) as server:
+        print(f"Serving compiler cache at {server.url}")
+        server.serve_forever()
+
+    # Point sccache/ccache at it
+    from toolchainkit.caching.remote import RemoteCacheConfigurator
+    env_vars = RemoteCacheConfigurator(cache_config).configure_local_server()
+"""
+
+import hashlib
+import json
+import logging
+import os
+import socket
+import tempfile
+import threading
+import time
+import zlib
+from collections import OrderedDict
+from dataclasses import asdict, dataclass
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+from pathlib import Path
+from typing import Dict, Iterator, Optional, Tuple, Union
+from urllib.parse import unquote, urlparse
+
+logger = logging.getLogger(__name__)
+
+DEFAULT_PORT = 8420
+"""Default TCP port for ``tkgen cache serve``."""
+
+MAX_OBJECT_SIZE = 1024**3
+"""Largest request body the server accepts (HTTP 413 above)."""
+
+STATE_FILE_NAME = "cache-server.json"
+"""Name of the state file advertising a running server in the global cache."""
+
+# On-disk object header: magic + codec byte
+_MAGIC = b"TKC1"
+_CODEC_NONE = 0
+_CODEC_ZLIB = 1
+_CODEC_ZSTD = 2
+
+# Objects smaller than this are never worth compressing
+_MIN_COMPRESS_SIZE = 512
+
+_SIZE_UNITS = {"": 1, "K": 1024, "M": 1024**2, "G": 1024**3, "T": 1024**4}
+
+
+def parse_size(size: Union[str, int]) -> int:
+    """
+    Parse a human-readable size such as ``'10G'`` or ``'512M'`` into bytes.
+
+    Uses the same suffixes as ``SCCACHE_CACHE_SIZE``/``CCACHE_MAXSIZE``.
+
+    Args:
+        size: Size string or integer byte count
+
+    Returns:
+        Size in bytes
+
+    Raises:
+        ValueError: If the size string is malformed
+
+    Example:
+        >>> parse_size("10G")
+        10737418240
+    """
+    if isinstance(size, int):
+        return size
+
+    text = str(size).strip().upper().rstrip("B").rstrip("I")
+    if not text:
+        raise ValueError(f"Invalid size: {size!r}")
+
+    unit = text[-1] if text[-1] in _SIZE_UNITS else ""
+    number = text[: -len(unit)] if unit else text
+    try:
+        value = float(number)
+    except ValueError:
+        raise ValueError(f"Invalid size: {size!r}")
+    if value < 0:
+        raise ValueError(f"Size must be non-negative: {size!r}")
+    return int(value * _SIZE_UNITS[unit])
+
+
+def _zstd_module():
+    """Return the zstandard module if installed, else None."""
+    try:
+        import zstandard  # type: ignore[import-not-found]
+
+        return zstandard
+    except ImportError:
+        return None
+
+
+@dataclass
+class CacheServerStats:
+    """Counters for a cache store, exposed at ``GET /_stats``."""
+
+    hits: int = 0
+    """Number of GET/HEAD requests answered from the store."""
+
+    misses: int = 0
+    """Number of GET/HEAD requests for unknown keys."""
+
+    puts: int = 0
+    """Number of objects written."""
+
+    evictions: int = 0
+    """Number of objects evicted by the LRU policy."""
+
+    bytes_in: int = 0
+    """Uncompressed bytes received via PUT."""
+
+    bytes_out: int = 0
+    """Uncompressed bytes served via GET."""
+
+    stored_bytes: int = 0
+    """Bytes currently used on disk (after compression)."""
+
+    objects: int = 0
+    """Number of objects currently stored."""
+
+    def to_dict(self) -> Dict[str, int]:
+        """Convert stats to a JSON-serializable dictionary."""
+        return asdict(self)
+
+
+class DiskLRUStore:
+    """
+    Disk-backed key/value store with LRU eviction and per-key compression.
+
+    Objects are stored as individual files named by the SHA-256 of their key,
+    so arbitrary sccache/ccache keys (including ``/`` separators) map safely
+    onto the filesystem. Writes go to a temporary file and are atomically
+    renamed into place, so concurrent readers never see partial objects.
+
+    The LRU index is kept in memory and rebuilt from file access times on
+    startup; reads refresh recency, and a PUT that pushes the store over
+    ``max_size`` evicts least-recently-used objects until it fits again.
+
+    Attributes:
+        root: Store directory
+        max_size: Maximum on-disk size in bytes
+        compression: Codec used for new objects ('zlib', 'zstd' or 'none')
+    """
+
+    def __init__(
+        self,
+        root: Path,
+        max_size: Union[str, int] = "10G",
+        compression: str = "zlib",
+        compression_level: int = 1,
+    ):
+        """
+        Initialize store.
+
+        Args:
+            root: Directory holding cached objects (created if missing)
+            max_size: Size limit as bytes or a string like '10G'
+            compression: 'zlib', 'zstd' (requires the zstandard package) or 'none'
+            compression_level: Codec compression level (low levels favour speed)
+
+        Raises:
+            ValueError: If compression codec is unknown or unavailable
+        """
+        if compression not in ("zlib", "zstd", "none"):
+            raise ValueError(
+                f"Invalid compression: {compression}. Must be 'zlib', 'zstd' or 'none'"
+            )
+        if compression == "zstd" and _zstd_module() is None:
+            raise ValueError("zstd compression requires the 'zstandard' package")
+
+        self.root = Path(root)
+        self.objects_dir = self.root / "objects"
+        self.objects_dir.mkdir(parents=True, exist_ok=True)
+        self.max_size = parse_size(max_size)
+        self.compression = compression
+        self.compression_level = compression_level
+
+        self._lock = threading.Lock()
+        # digest -> on-disk size, ordered least- to most-recently used
+        self._index: "OrderedDict[str, int]" = OrderedDict()
+        self._stats = CacheServerStats()
+        self._load_index()
+
+    # ------------------------------------------------------------------
+    # Public API
+    # ------------------------------------------------------------------
+
+    def get(self, key: str) -> Optional[bytes]:
+        """
+        Fetch an object.
+
+        Args:
+            key: Object key
+
+        Returns:
+            Uncompressed object bytes, or None if not cached
+        """
+        digest = self._digest(key)
+        with self._lock:
+            if digest not in self._index:
+                self._stats.misses += 1
+                return None
+            self._index.move_to_end(digest)
+
+        try:
+            raw = self._object_path(digest).read_bytes()
+        except FileNotFoundError:
+            # Evicted between the index lookup and the read
+            with self._lock:
+                self._drop(digest)
+                self._stats.misses += 1
+            return None
+
+        try:
+            data = self._decode(raw)
+        except ValueError as e:
+            # Truncated or corrupt on disk: forget it so the client refills it
+            logger.warning(f"Dropping corrupt cache object {digest}: {e}")
+            with self._lock:
+                self._drop(digest)
+                self._stats.misses += 1
+            try:
+                self._object_path(digest).unlink()
+            except OSError:
+                pass
+            return None
+        with self._lock:
+            self._stats.hits += 1
+            self._stats.bytes_out += len(data)
+        return data
+
+    def contains(self, key: str) -> bool:
+        """
+        Check whether a key is cached (counts as a hit or miss).
+
+        Args:
+            key: Object key
+
+        Returns:
+            True if the key is present
+        """
+        digest = self._digest(key)
+        with self._lock:
+            if digest in self._index:
+                self._index.move_to_end(digest)
+                self._stats.hits += 1
+                return True
+            self._stats.misses += 1
+            return False
+
+    def put(self, key: str, data: bytes) -> None:
+        """
+        Store an object, evicting least-recently-used objects if needed.
+
+        Objects larger than the whole store are silently dropped.
+
+        Args:
+            key: Object key
+            data: Uncompressed object bytes
+        """
+        encoded = self._encode(data)
+        if len(encoded) > self.max_size:
+            logger.debug(f"Object {key} larger than cache size limit, not storing")
+            return
+
+        digest = self._digest(key)
+        path = self._object_path(digest)
+        path.parent.mkdir(parents=True, exist_ok=True)
+
+        fd, tmp_name = tempfile.mkstemp(dir=path.parent, prefix=".tmp-")
+        try:
+            with os.fdopen(fd, "wb") as f:
+                f.write(encoded)
+            os.replace(tmp_name, path)
+        except BaseException:
+            try:
+                os.unlink(tmp_name)
+            except OSError:
+                pass
+            raise
+
+        with self._lock:
+            self._drop(digest)
+            self._index[digest] = len(encoded)
+            self._stats.stored_bytes += len(encoded)
+            self._stats.objects += 1
+            self._stats.puts += 1
+            self._stats.bytes_in += len(data)
+            victims = self._collect_victims(keep=digest)
+
+        for victim in victims:
+            try:
+                self._object_path(victim).unlink()
+            except FileNotFoundError:
+                pass
+
+    def delete(self, key: str) -> bool:
+        """
+        Remove an object.
+
+        Args:
+            key: Object key
+
+        Returns:
+            True if the object existed
+        """
+        digest = self._digest(key)
+        with self._lock:
+            existed = self._drop(digest)
+        if existed:
+            try:
+                self._object_path(digest).unlink()
+            except FileNotFoundError:
+                pass
+        return existed
+
+    def stats(self) -> CacheServerStats:
+        """Return a snapshot of the store counters."""
+        with self._lock:
+            return CacheServerStats(**self._stats.to_dict())
+
+    # ------------------------------------------------------------------
+    # Internals
+    # ------------------------------------------------------------------
+
+    @staticmethod
+    def _digest(key: str) -> str:
+        return hashlib.sha256(key.encode("utf-8")).hexdigest()
+
+    def _object_path(self, digest: str) -> Path:
+        return self.objects_dir / digest[:2] / digest
+
+    def _drop(self, digest: str) -> bool:
+        """Remove digest from index (lock must be held)."""
+        size = self._index.pop(digest, None)
+        if size is None:
+            return False
+        self._stats.stored_bytes -= size
+        self._stats.objects -= 1
+        return True
+
+    def _collect_victims(self, keep: str) -> list:
+        """Pop LRU entries until the store fits (lock must be held)."""
+        victims = []
+        while self._stats.stored_bytes > self.max_size and len(self._index) > 1:
+            digest = next(iter(self._index))
+            if digest == keep:
+                self._index.move_to_end(digest)
+                continue
+            self._drop(digest)
+            self._stats.evictions += 1
+            victims.append(digest)
+        return victims
+
+    def _iter_object_files(self) -> Iterator[Path]:
+        for shard in self.objects_dir.iterdir():
+            if not shard.is_dir():
+                continue
+            for path in shard.iterdir():
+                if path.name.startswith(".tmp-"):
+                    # Leftover from an interrupted write
+                    try:
+                        path.unlink()
+                    except OSError:
+                        pass
+                    continue
+                yield path
+
+    def _load_index(self) -> None:
+        """Rebuild the LRU index from files on disk, oldest access first."""
+        entries = []
+        for path in self._iter_object_files():
+            try:
+                st = path.stat()
+            except OSError:
+                continue
+            entries.append((max(st.st_atime, st.st_mtime), path.name, st.st_size))
+
+        entries.sort()
+        for _, digest, size in entries:
+            self._index[digest] = size
+            self._stats.stored_bytes += size
+            self._stats.objects += 1
+
+        victims = self._collect_victims(keep="")
+        for victim in victims:
+            try:
+                self._object_path(victim).unlink()
+            except FileNotFoundError:
+                pass
+
+        logger.debug(
+            f"Loaded cache store index: {self._stats.objects} objects, "
+            f"{self._stats.stored_bytes} bytes"
+        )
+
+    def _encode(self, data: bytes) -> bytes:
+        codec = _CODEC_NONE
+        payload = data
+        if self.compression != "none" and len(data) >= _MIN_COMPRESS_SIZE:
+            if self.compression == "zstd":
+                zstandard = _zstd_module()
+                compressed = zstandard.ZstdCompressor(
+                    level=self.compression_level
+                ).compress(data)
+                candidate = _CODEC_ZSTD
+            else:
+                compressed = zlib.compress(data, self.compression_level)
+                candidate = _CODEC_ZLIB
+            # Keep raw bytes when compression does not pay off
+            if len(compressed) < len(data) * 0.9:
+                codec, payload = candidate, compressed
+        return _MAGIC + bytes([codec]) + payload
+
+    @staticmethod
+    def _decode(raw: bytes) -> bytes:
+        """Decode a stored object; raises ValueError if it is corrupt."""
+        if len(raw) < 5 or raw[:4] != _MAGIC:
+            raise ValueError("Corrupted cache object (bad header)")
+        codec = raw[4]
+        payload = raw[5:]
+        if codec == _CODEC_NONE:
+            return payload
+        if codec == _CODEC_ZLIB:
+            try:
+                return zlib.decompress(payload)
+            except zlib.error as e:
+                raise ValueError(f"Corrupted cache object ({e})") from e
+        if codec == _CODEC_ZSTD:
+            zstandard = _zstd_module()
+            if zstandard is None:
+                raise ValueError(
+                    "Cache object is zstd-compressed but zstandard missing"
+                )
+            try:
+                return zstandard.ZstdDecompressor().decompress(payload)
+            except zstandard.ZstdError as e:
+                raise ValueError(f"Corrupted cache object ({e})") from e
+        raise ValueError(f"Corrupted cache object (unknown codec {codec})")
+
+
+class _CacheRequestHandler(BaseHTTPRequestHandler):
+    """HTTP handler implementing the sccache WebDAV and ccache HTTP subsets."""
+
+    server_version = "ToolchainKitCache/1.0"
+    protocol_version = "HTTP/1.1"
+
+    # Set by CacheServer on the server instance
+    @property
+    def store(self) -> DiskLRUStore:
+        return self.server.store  # type: ignore[attr-defined]
+
+    def log_message(self, format, *args):  # noqa: A002 - signature from base class
+        logger.debug("%s - %s", self.address_string(), format % args)
+
+    # -- helpers -------------------------------------------------------
+
+    def _key(self) -> Optional[str]:
+        path = unquote(urlparse(self.path).path).strip("/")
+        parts = [p for p in path.split("/") if p]
+        if not parts or any(p in (".", "..") for p in parts):
+            return None
+        return "/".join(parts)
+
+    def _authorized(self) -> bool:
+        token = self.server.token  # type: ignore[attr-defined]
+        if not token:
+            return True
+        return self.headers.get("Authorization", "") == f"Bearer {token}"
+
+    def _reply(
+        self, status: int, body: bytes = b"", content_type: Optional[str] = None
+    ) -> None:
+        self.send_response(status)
+        if content_type:
+            self.send_header("Content-Type", content_type)
+        self.send_header("Content-Length", str(len(body)))
+        self.end_headers()
+        if body and self.command != "HEAD":
+            self.wfile.write(body)
+
+    def _read_body(self, required: bool = True) -> Optional[bytes]:
+        """
+        Read the request body, at most the server's max_body bytes.
+
+        Sends 411 for a missing (when required) or malformed length and 413
+        for an oversized body, and returns None; the connection is closed
+        then, since the body was not read.
+        """
+        limit = self.server.max_body  # type: ignore[attr-defined]
+        if self.headers.get("Transfer-Encoding", "").lower() == "chunked":
+            chunks = []
+            total = 0
+            while True:
+                try:
+                    size = int(self.rfile.readline().split(b";")[0].strip(), 16)
+                except ValueError:
+                    return self._reject(411)
+                if size == 0:
+                    self.rfile.readline()
+                    break
+                total += size
+                if size < 0 or total > limit:
+                    return self._reject(413)
+                chunks.append(self.rfile.read(size))
+                self.rfile.readline()
+            return b"".join(chunks)
+        length = self.headers.get("Content-Length")
+        if length is None:
+            return self._reject(411) if required else b""
+        try:
+            size = int(length)
+        except ValueError:
+            return self._reject(411)
+        if size < 0:
+            return self._reject(411)
+        if size > limit:
+            return self._reject(413)
+        return self.rfile.read(size)
+
+    def _reject(self, status: int) -> None:
+        self.close_connection = True
+        self._reply(status)
+
+    def _guard(self) -> Optional[str]:
+        """Check auth and key; send an error reply and return None on failure."""
+        if not self._authorized():
+            self._reply(401)
+            return None
+        key = self._key()
+        if key is None:
+            self._reply(400)
+            return None
+        return key
+
+    # -- verbs ---------------------------------------------------------
+
+    def do_GET(self):
+        if urlparse(self.path).path == "/_stats":
+            if not self._authorized():
+                self._reply(401)
+                return
+            body = json.dumps(self.store.stats().to_dict()).encode("utf-8")
+            self._reply(200, body, "application/json")
+            return
+        key = self._guard()
+        if key is None:
+            return
+        data = self.store.get(key)
+        if data is None:
+            self._reply(404)
+        else:
+            self._reply(200, data, "application/octet-stream")
+
+    def do_HEAD(self):
+        key = self._guard()
+        if key is None:
+            return
+        self._reply(200 if self.store.contains(key) else 404)
+
+    def do_PUT(self):
+        key = self._guard()
+        if key is None:
+            return
+        body = self._read_body()
+        if body is None:
+            return
+        self.store.put(key, body)
+        self._reply(201)
+
+    def do_DELETE(self):
+        key = self._guard()
+        if key is None:
+            return
+        self._reply(204 if self.store.delete(key) else 404)
+
+    def do_MKCOL(self):
+        # WebDAV clients create parent collections before PUT; keys are flat here
+        if not self._authorized():
+            self._reply(401)
+            return
+        if self._read_body(required=False) is None:
+            return
+        self._reply(201)
+
+    def do_PROPFIND(self):
+        if not self._authorized():
+            self._reply(401)
+            return
+        if self._read_body(required=False) is None:
+            return
+        key = self._key()
+        if key is not None and not self.store.contains(key):
+            self._reply(404)
+            return
+        href = self.path
+        body = (
+            '<?xml version="1.0" encoding="utf-8"?>'
+            '<D:multistatus xmlns:D="DAV:"><D:response>'
+            f"<D:href>{href}</D:href>"
+            "<D:propstat><D:prop/><D:status>HTTP/1.1 200 OK</D:status>"
+            "</D:propstat></D:response></D:multistatus>"
+        ).encode("utf-8")
+        self._reply(207, body, 'application/xml; charset="utf-8"')
+
+
+class CacheServer:
+    """
+    Threaded HTTP server in front of a DiskLRUStore.
+
+    Each connection is handled on its own thread; the store's internal lock
+    only guards the in-memory index, so reads and writes of different
+    objects proceed concurrently.
+
+    Attributes:
+        store: Backing object store
+        host: Bind address
+        port: Bound TCP port (resolved after binding when 0 was requested)
+        token: Optional bearer token required on every request
+    """
+
+    def __init__(
+        self,
+        store: DiskLRUStore,
+        host: str = "127.0.0.1",
+        port: int = DEFAULT_PORT,
+        token: Optional[str] = None,
+        max_body: int = MAX_OBJECT_SIZE,
+    ):
+        """
+        Initialize and bind the server.
+
+        Args:
+            store: Backing object store
+            host: Bind address ('0.0.0.0' to serve the LAN)
+            port: TCP port (0 picks a free port)
+            token: Optional bearer token for authentication
+            max_body: Largest request body accepted, in bytes
+        """
+        self.store = store
+        self.token = token
+        self._httpd = ThreadingHTTPServer((host, port), _CacheRequestHandler)
+        self._httpd.daemon_threads = True
+        self._httpd.store = store  # type: ignore[attr-defined]
+        self._httpd.token = token  # type: ignore[attr-defined]
+        self._httpd.max_body = max_body  # type: ignore[attr-defined]
+        self.host, self.port = self._httpd.server_address[:2]
+        self._thread: Optional[threading.Thread] = None
+
+    @property
+    def url(self) -> str:
+        """Base URL clients should use."""
+        host = self.host
+        if host in ("0.0.0.0", ""):
+            host = socket.gethostname()
+        elif host == "::":
+            host = "localhost"
+        return f"http://{host}:{self.port}/"
+
+    def start(self) -> "CacheServer":
+        """Serve requests on a background thread."""
+        self._thread = threading.Thread(
+            target=self._httpd.serve_forever,
+            kwargs={"poll_interval": 0.05},
+            name="tk-cache-server",
+            daemon=True,
+        )
+        self._thread.start()
+        logger.info(f"Cache server listening on {self.url}")
+        return self
+
+    def serve_forever(self) -> None:
+        """Serve requests on the calling thread until shutdown()."""
+        logger.info(f"Cache server listening on {self.url}")
+        self._httpd.serve_forever()
+
+    def shutdown(self) -> None:
+        """Stop serving and release the socket."""
+        if self._thread is not None:
+            self._httpd.shutdown()
+            self._thread.join()
+            self._thread = None
+        self._httpd.server_close()
+
+    def __enter__(self) -> "CacheServer":
+        return self
+
+    def __exit__(self, exc_type, exc, tb) -> None:
+        self.shutdown()
+
+
+# ----------------------------------------------------------------------
+# Discovery (lets RemoteCacheConfigurator auto-target a running server)
+# ----------------------------------------------------------------------
+
+
+def _state_file(cache_dir: Optional[Path] = None) -> Path:
+    if cache_dir is None:
+        from ..core.directory import get_global_cache_dir
+
+        cache_dir = get_global_cache_dir()
+    return Path(cache_dir) / STATE_FILE_NAME
+
+
+def write_server_state(server: CacheServer, cache_dir: Optional[Path] = None) -> Path:
+    """
+    Advertise a running server in the global cache directory.
+
+    Args:
+        server: Running cache server
+        cache_dir: Global cache directory (default: ~/.toolchainkit)
+
+    Returns:
+        Path to the written state file
+    """
+    path = _state_file(cache_dir)
+    path.parent.mkdir(parents=True, exist_ok=True)
+    state = {
+        "url": server.url,
+        "host": server.host,
+        "port": server.port,
+        "pid": os.getpid(),
+        "store": str(server.store.root),
+        "token_required": bool(server.token),
+        "started": time.time(),
+    }
+    path.write_text(json.dumps(state, indent=2), encoding="utf-8")
+    return path
+
+
+def clear_server_state(cache_dir: Optional[Path] = None) -> None:
+    """Remove the server state file if it belongs to this process."""
+    path = _state_file(cache_dir)
+    try:
+        state = json.loads(path.read_text(encoding="utf-8"))
+    except (OSError, ValueError):
+        return
+    if state.get("pid") == os.getpid():
+        try:
+            path.unlink()
+        except OSError:
+            pass
+
+
+def _reachable(host: str, port: int, timeout: float = 0.5) -> bool:
+    try:
+        with socket.create_connection((host, port), timeout=timeout):
+            return True
+    except OSError:
+        return False
+
+
+def find_local_server(cache_dir: Optional[Path] = None) -> Optional[Tuple[str, bool]]:
+    """
+    Locate a running local cache server.
+
+    Args:
+        cache_dir: Global cache directory (default: ~/.toolchainkit)
+
+    Returns:
+        Tuple of (url, token_required), or None if no reachable server
+    """
+    path = _state_file(cache_dir)
+    try:
+        state = json.loads(path.read_text(encoding="utf-8"))
+    except (OSError, ValueError):
+        return None
+
+    host = state.get("host", "127.0.0.1")
+    if host in ("0.0.0.0", "::", ""):
+        host = "127.0.0.1"
+    port = state.get("port")
+    if not port or not _reachable(host, int(port)):
+        logger.debug(f"Stale cache server state in {path}")
+        return None
+    return f"http://{host}:{port}/", bool(state.get("token_required"))
+
+
+def fetch_server_stats(
+    url: Optional[str] = None,
+    cache_dir: Optional[Path] = None,
+    timeout: float = 2,
+    token: Optional[str] = None,
+) -> Optional[Dict[str, int]]:
+    """
+    Read counters from a cache server's ``/_stats`` endpoint.
+
+    Args:
+        url: Server base URL (default: the advertised local server)
+        cache_dir: Global cache directory used for discovery
+        timeout: Request timeout in seconds
+        token: Bearer token of a server started with --token (default:
+            SCCACHE_WEBDAV_TOKEN, which its sccache clients use)
+
+    Returns:
+        Statistics dictionary, or None if no server answered
+    """
+    if url is None:
+        found = find_local_server(cache_dir)
+        if found is None:
+            return None
+        url = found[0]
+
+    import requests
+
+    try:
+        token = token or os.environ.get("SCCACHE_WEBDAV_TOKEN")
+        headers = {"Authorization": f"Bearer {token}"} if token else {}
+        response = requests.get(
+            url.rstrip("/") + "/_stats", headers=headers, timeout=timeout
+        )
+        response.raise_for_status()
+        return response.json()
+    except (requests.RequestException, ValueError) as e:
+        logger.debug(f"Could not read cache server stats: {e}")
+        return None
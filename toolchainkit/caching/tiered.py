@@ -0,0 +1,527 @@
+"""
+Two-tier compiler cache: bounded local disk tier in front of a remote tier.
+
+A ``TieredStore`` plugs into ``CacheServer`` in place of a plain
+``DiskLRUStore``. sccache/ccache talk to the local server; lookups are
+answered from the local disk tier when possible and fall through to the
+remote tier otherwise. Uploads are queued and written to the remote tier by
+background threads (write-behind), so compiles never wait on a slow link.
+
+At startup the local tier can be prefetched from a manifest listing the keys
+that the last build on the same branch used. The manifest is written on
+shutdown, both locally and to the remote tier (so fresh CI runners can use it),
+and every ``checkpoint_interval`` seconds while serving, so a server that is
+killed keeps most of it.
+
+Usage:
+    from toolchainkit.caching.server import CacheServer, DiskLRUStore
+    from toolchainkit.caching.tiered import HTTPRemoteTier, TieredStore
+
+    local = DiskLRUStore(Path(".cache/local"), max_size="5G")
+    remote = HTTPRemoteTier("http://cache.example.com:8420/")
+    store = TieredStore(local, remote, branch="main")
+    store.prefetch()
+
+    with CacheServer(store, port=8421).start() as server:
+        ...  # run the build against server.url
+    store.close()  # flush uploads, save manifest
+"""
+
+import logging
+import queue
+import re
+import threading
+from concurrent.futures import ThreadPoolExecutor
+from dataclasses import dataclass
+from pathlib import Path
+from typing import Iterable, List, Optional, Set
+from urllib.parse import quote
+
+from .server import CacheServerStats, DiskLRUStore
+
+logger = logging.getLogger(__name__)
+
+MANIFEST_PREFIX = "_manifests"
+"""Remote key namespace holding per-branch prefetch manifests."""
+
+
+@dataclass
+class TieredCacheStats(CacheServerStats):
+    """Counters for a two-tier store (exposed at ``GET /_stats``)."""
+
+    local_hits: int = 0
+    """Lookups answered by the local disk tier."""
+
+    remote_hits: int = 0
+    """Lookups answered by the remote tier."""
+
+    bytes_saved: int = 0
+    """Bytes served locally that would otherwise have crossed the network."""
+
+    prefetched: int = 0
+    """Objects pulled into the local tier by manifest prefetch."""
+
+    prefetched_bytes: int = 0
+    """Bytes pulled into the local tier by manifest prefetch."""
+
+    backfill_bytes: int = 0
+    """Bytes of remote hits copied into the local tier."""
+
+    uploads_pending: int = 0
+    """Write-behind uploads not yet sent to the remote tier."""
+
+    upload_errors: int = 0
+    """Write-behind uploads that failed."""
+
+
+class RemoteTier:
+    """Interface for the remote tier of a TieredStore."""
+
+    def get(self, key: str) -> Optional[bytes]:
+        """Fetch an object, or None if absent."""
+        raise NotImplementedError
+
+    def put(self, key: str, data: bytes) -> None:
+        """Store an object (raise on failure)."""
+        raise NotImplementedError
+
+    def contains(self, key: str) -> bool:
+        """Check for an object; tiers override this to avoid a download."""
+        return self.get(key) is not None
+
+    def close(self) -> None:
+        """Release connections."""
+
+
+class HTTPRemoteTier(RemoteTier):
+    """
+    Remote tier speaking plain HTTP GET/PUT (WebDAV, ccache HTTP storage,
+    another ``tkgen cache serve`` instance).
+
+    Uses one keep-alive session per thread.
+    """
+
+    def __init__(self, url: str, token: Optional[str] = None, timeout: float = 30):
+        """
+        Initialize HTTP remote tier.
+
+        Args:
+            url: Base URL of the remote cache
+            token: Optional bearer token
+            timeout: Per-request timeout in seconds
+        """
+        self.url = url if url.endswith("/") else url + "/"
+        self.timeout = timeout
+        self._headers = {"Authorization": f"Bearer {token}"} if token else {}
+        self._local = threading.local()
+        self._sessions: list = []
+        self._sessions_lock = threading.Lock()
+
+    def _session(self):
+        session = getattr(self._local, "session", None)
+        if session is None:
+            import requests
+
+            session = requests.Session()
+            session.headers.update(self._headers)
+            self._local.session = session
+            with self._sessions_lock:
+                self._sessions.append(session)
+        return session
+
+    def _url(self, key: str) -> str:
+        return self.url + quote(key, safe="/")
+
+    def get(self, key: str) -> Optional[bytes]:
+        response = self._session().get(self._url(key), timeout=self.timeout)
+        if response.status_code == 404:
+            return None
+        response.raise_for_status()
+        return response.content
+
+    def put(self, key: str, data: bytes) -> None:
+        response = self._session().put(self._url(key), data=data, timeout=self.timeout)
+        response.raise_for_status()
+
+    def contains(self, key: str) -> bool:
+        response = self._session().head(self._url(key), timeout=self.timeout)
+        if response.status_code == 404:
+            return False
+        response.raise_for_status()
+        return True
+
+    def close(self) -> None:
+        with self._sessions_lock:
+            for session in self._sessions:
+                session.close()
+            self._sessions.clear()
+
+
+class S3RemoteTier(RemoteTier):
+    """Remote tier backed by an S3 bucket (requires boto3)."""
+
+    def __init__(
+        self,
+        bucket: str,
+        prefix: str = "",
+        region: Optional[str] = None,
+        endpoint: Optional[str] = None,
+    ):
+        """
+        Initialize S3 remote tier.
+
+        Args:
+            bucket: Bucket name
+            prefix: Key prefix for namespacing
+            region: AWS region
+            endpoint: Custom endpoint for S3-compatible storage
+
+        Raises:
+            ImportError: If boto3 is not installed
+        """
+        import boto3  # type: ignore[import-untyped]
+
+        kwargs = {}
+        if region:
+            kwargs["region_name"] = region
+        if endpoint:
+            kwargs["endpoint_url"] = endpoint
+        self._client = boto3.client("s3", **kwargs)
+        self.bucket = bucket
+        self.prefix = prefix
+
+    def get(self, key: str) -> Optional[bytes]:
+        try:
+            response = self._client.get_object(
+                Bucket=self.bucket, Key=self.prefix + key
+            )
+        except self._client.exceptions.NoSuchKey:
+            return None
+        return response["Body"].read()
+
+    def put(self, key: str, data: bytes) -> None:
+        self._client.put_object(Bucket=self.bucket, Key=self.prefix + key, Body=data)
+
+    def contains(self, key: str) -> bool:
+        from botocore.exceptions import ClientError  # type: ignore[import-untyped]
+
+        try:
+            self._client.head_object(Bucket=self.bucket, Key=self.prefix + key)
+        except ClientError as e:
+            if e.response.get("Error", {}).get("Code") in ("404", "NoSuchKey"):
+                return False
+            raise
+        return True
+
+
+class TieredStore:
+    """
+    Local disk tier in front of a remote tier, with prefetch and write-behind.
+
+    Exposes the same get/contains/put/delete/stats interface as DiskLRUStore
+    so it can back a CacheServer directly.
+
+    Attributes:
+        local: Local disk tier
+        remote: Remote tier
+        branch: Branch name used to select the prefetch manifest
+    """
+
+    def __init__(
+        self,
+        local: DiskLRUStore,
+        remote: RemoteTier,
+        branch: Optional[str] = None,
+        upload_workers: int = 4,
+        upload_queue_size: int = 1024,
+        checkpoint_interval: Optional[float] = 300,
+    ):
+        """
+        Initialize tiered store and start write-behind workers.
+
+        Args:
+            local: Local disk tier
+            remote: Remote tier
+            branch: Branch name for manifests (None disables manifests)
+            upload_workers: Number of background upload threads
+            upload_queue_size: Pending uploads before PUTs block on the remote
+            checkpoint_interval: Seconds between manifest saves while
+                running (None: only on close)
+        """
+        self.local = local
+        self.remote = remote
+        self.branch = branch
+        self.root = local.root
+
+        self._lock = threading.Lock()
+        self._stats = TieredCacheStats()
+        self._used_keys: Set[str] = set()
+
+        self._queue: "queue.Queue" = queue.Queue(maxsize=upload_queue_size)
+        self._workers: List[threading.Thread] = []
+        for i in range(upload_workers):
+            worker = threading.Thread(
+                target=self._upload_loop, name=f"tk-cache-upload-{i}", daemon=True
+            )
+            worker.start()
+            self._workers.append(worker)
+
+        self._stopping = threading.Event()
+        self._checkpointer: Optional[threading.Thread] = None
+        if checkpoint_interval and branch is not None:
+            self._checkpointer = threading.Thread(
+                target=self._checkpoint_loop,
+                args=(checkpoint_interval,),
+                name="tk-cache-checkpoint",
+                daemon=True,
+            )
+            self._checkpointer.start()
+
+    # ------------------------------------------------------------------
+    # Store interface
+    # ------------------------------------------------------------------
+
+    def get(self, key: str) -> Optional[bytes]:
+        """
+        Fetch an object from the local tier, then the remote tier.
+
+        Remote hits are copied into the local tier.
+        """
+        self._record_use(key)
+        data = self.local.get(key)
+        if data is not None:
+            with self._lock:
+                self._stats.local_hits += 1
+                self._stats.bytes_saved += len(data)
+                self._stats.bytes_out += len(data)
+            return data
+
+        try:
+            data = self.remote.get(key)
+        except Exception as e:
+            logger.debug(f"Remote tier GET {key} failed: {e}")
+            data = None
+
+        if data is None:
+            with self._lock:
+                self._stats.misses += 1
+            return None
+
+        self.local.put(key, data)
+        with self._lock:
+            self._stats.remote_hits += 1
+            self._stats.backfill_bytes += len(data)
+            self._stats.bytes_out += len(data)
+        return data
+
+    def contains(self, key: str) -> bool:
+        """Check for a key; the remote tier is asked without a download."""
+        self._record_use(key)
+        if self.local.contains(key):
+            with self._lock:
+                self._stats.local_hits += 1
+            return True
+        try:
+            found = self.remote.contains(key)
+        except Exception as e:
+            logger.debug(f"Remote tier HEAD {key} failed: {e}")
+            found = False
+        with self._lock:
+            if found:
+                self._stats.remote_hits += 1
+            else:
+                self._stats.misses += 1
+        return found
+
+    def put(self, key: str, data: bytes) -> None:
+        """Store locally and queue an asynchronous upload to the remote tier."""
+        self._record_use(key)
+        self.local.put(key, data)
+        with self._lock:
+            self._stats.puts += 1
+            self._stats.bytes_in += len(data)
+            self._stats.uploads_pending += 1
+        try:
+            self._queue.put_nowait((key, data))
+        except queue.Full:
+            # Back-pressure: upload on the caller's thread rather than drop it
+            self._upload(key, data)
+
+    def delete(self, key: str) -> bool:
+        """Remove an object from the local tier (the remote tier is shared)."""
+        return self.local.delete(key)
+
+    def stats(self) -> TieredCacheStats:
+        """
+        Return combined counters for both tiers.
+
+        Request counters (hits, misses, puts, bytes in and out) count client
+        requests; copies into the local tier on remote hits and prefetch are
+        counted separately. Eviction and usage figures are the local tier's.
+        """
+        local = self.local.stats()
+        with self._lock:
+            stats = TieredCacheStats(**self._stats.__dict__)
+        stats.hits = stats.local_hits + stats.remote_hits
+        stats.evictions = local.evictions
+        stats.stored_bytes = local.stored_bytes
+        stats.objects = local.objects
+        return stats
+
+    # ------------------------------------------------------------------
+    # Write-behind
+    # ------------------------------------------------------------------
+
+    def _upload(self, key: str, data: bytes) -> None:
+        try:
+            self.remote.put(key, data)
+        except Exception as e:
+            logger.warning(f"Write-behind upload of {key} failed: {e}")
+            with self._lock:
+                self._stats.upload_errors += 1
+        finally:
+            with self._lock:
+                self._stats.uploads_pending -= 1
+
+    def _upload_loop(self) -> None:
+        while True:
+            item = self._queue.get()
+            try:
+                if item is None:
+                    return
+                self._upload(*item)
+            finally:
+                self._queue.task_done()
+
+    def flush(self) -> None:
+        """Block until all queued uploads have been attempted."""
+        self._queue.join()
+
+    # ------------------------------------------------------------------
+    # Manifests and prefetch
+    # ------------------------------------------------------------------
+
+    def _record_use(self, key: str) -> None:
+        if self.branch is not None and not key.startswith(MANIFEST_PREFIX + "/"):
+            with self._lock:
+                self._used_keys.add(key)
+
+    def _manifest_name(self) -> str:
+        return re.sub(r"[^A-Za-z0-9._-]", "_", self.branch or "default")
+
+    def _local_manifest_path(self) -> Path:
+        return self.root / "manifests" / f"{self._manifest_name()}.txt"
+
+    def load_manifest(self) -> List[str]:
+        """
+        Load the key manifest for this branch.
+
+        Prefers the local copy and falls back to the remote tier.
+
+        Returns:
+            List of keys used by the last build on this branch
+        """
+        if self.branch is None:
+            return []
+
+        path = self._local_manifest_path()
+        text = None
+        if path.exists():
+            text = path.read_text(encoding="utf-8")
+        else:
+            try:
+                raw = self.remote.get(f"{MANIFEST_PREFIX}/{self._manifest_name()}")
+                text = raw.decode("utf-8") if raw is not None else None
+            except Exception as e:
+                logger.debug(f"Could not fetch remote manifest: {e}")
+        if not text:
+            return []
+        return [line for line in text.splitlines() if line]
+
+    def save_manifest(self) -> Optional[Path]:
+        """
+        Write the keys used in this session as the branch manifest.
+
+        Returns:
+            Path of the local manifest, or None if manifests are disabled
+        """
+        if self.branch is None:
+            return None
+        with self._lock:
+            keys = sorted(self._used_keys)
+        if not keys:
+            return None
+
+        text = "\n".join(keys) + "\n"
+        path = self._local_manifest_path()
+        path.parent.mkdir(parents=True, exist_ok=True)
+        path.write_text(text, encoding="utf-8")
+        try:
+            self.remote.put(
+                f"{MANIFEST_PREFIX}/{self._manifest_name()}", text.encode("utf-8")
+            )
+        except Exception as e:
+            logger.warning(f"Could not upload manifest: {e}")
+        return path
+
+    def prefetch(
+        self, keys: Optional[Iterable[str]] = None, max_workers: int = 16
+    ) -> int:
+        """
+        Pull objects into the local tier concurrently.
+
+        Args:
+            keys: Keys to fetch (default: this branch's manifest)
+            max_workers: Number of concurrent remote GETs
+
+        Returns:
+            Number of objects fetched from the remote tier
+        """
+        if keys is None:
+            keys = self.load_manifest()
+        missing = [k for k in keys if not self.local.contains(k)]
+        if not missing:
+            return 0
+
+        def fetch(key: str) -> Optional[int]:
+            try:
+                data = self.remote.get(key)
+            except Exception as e:
+                logger.debug(f"Prefetch of {key} failed: {e}")
+                return None
+            if data is None:
+                return None
+            self.local.put(key, data)
+            return len(data)
+
+        with ThreadPoolExecutor(max_workers=max_workers) as pool:
+            sizes = [size for size in pool.map(fetch, missing) if size is not None]
+        fetched = len(sizes)
+
+        with self._lock:
+            self._stats.prefetched += fetched
+            self._stats.prefetched_bytes += sum(sizes)
+        logger.info(f"Prefetched {fetched}/{len(missing)} objects for {self.branch}")
+        return fetched
+
+    def _checkpoint_loop(self, interval: float) -> None:
+        while not self._stopping.wait(interval):
+            try:
+                self.save_manifest()
+            except OSError as e:
+                logger.warning(f"Could not save manifest: {e}")
+
+    def close(self) -> None:
+        """Flush pending uploads, save the manifest and stop workers."""
+        self._stopping.set()
+        if self._checkpointer is not None:
+            self._checkpointer.join()
+            self._checkpointer = None
+        self.flush()
+        self.save_manifest()
+        for _ in self._workers:
+            self._queue.put(None)
+        for worker in self._workers:
+            worker.join()
+        self._workers.clear()
+        self.remote.close()
@@ -5,6 +5,15 @@ This module provides the command-line interface for ToolchainKit.
 """
 
 from .parser import CLI, main
-from . import utils
+
+
+def __getattr__(name: str):
+    # utils imports yaml; load it only when used
+    if name == "utils":
+        from . import utils
+
+        return utils
+    raise AttributeError(f"module {__name__!r} has no attribute {name!r}")
+
 
 __all__ = ["CLI", "main", "utils"]
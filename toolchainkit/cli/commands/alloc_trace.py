@@ -0,0 +1,63 @@
+"""
+Alloc-trace command implementation.
+
+Summarizes allocation traces recorded by the allocator proxy and writes
+trimmed or compressed copies for the replay driver.
+"""
+
+import json
+import logging
+
+from toolchainkit.cli.utils import print_error, safe_print
+
+logger = logging.getLogger(__name__)
+
+
+def run(args) -> int:
+    """
+    Run the alloc-trace command.
+
+    Args:
+        args: Parsed command-line arguments with:
+            - trace_path: Trace file
+            - start, end: Optional time window, seconds since the trace started
+            - drop_live: Do not allocate the blocks live at the window start
+            - output: Optional path of the (trimmed) trace to write
+            - json: Print JSON instead of text
+
+    Returns:
+        Exit code (0 for success)
+    """
+    from toolchainkit.profiling.alloc_trace import (
+        TraceError,
+        format_summary,
+        read_trace,
+        summarize,
+        trim_trace,
+        write_trace,
+    )
+
+    if args.start is not None and args.end is not None and args.end <= args.start:
+        print_error("--end must be after --start")
+        return 1
+
+    try:
+        trace = read_trace(args.trace_path)
+        if args.start is not None or args.end is not None:
+            trace = trim_trace(
+                trace, start=args.start, end=args.end, keep_live=not args.drop_live
+            )
+        if args.output:
+            write_trace(trace, args.output)
+    except TraceError as e:
+        print_error("Cannot process allocation trace", str(e))
+        return 1
+
+    summary = summarize(trace)
+    if args.json:
+        safe_print(json.dumps(summary.to_dict(), indent=2))
+    else:
+        safe_print(format_summary(summary))
+        if args.output:
+            safe_print(f"Wrote {args.output}")
+    return 0
@@ -0,0 +1,182 @@
+"""
+Bundle command implementation.
+
+Pins the installed trees of locked components in the lock file, exports
+them to an offline bundle, imports bundles into the global cache and writes
+delta patches between cached toolchains.
+"""
+
+import logging
+import time
+
+from toolchainkit.cli.commands.fetch import load_lock, print_results
+from toolchainkit.cli.utils import print_error, safe_print
+
+logger = logging.getLogger(__name__)
+
+
+def run_pin(args) -> int:
+    """
+    Record tree digests of the installed locked components in toolchainkit.lock.
+
+    Args:
+        args: Parsed command-line arguments
+
+    Returns:
+        Exit code (0 if every component was pinned)
+    """
+    from pathlib import Path
+
+    from toolchainkit.config.lockfile import LockFileManager
+    from toolchainkit.toolchain.prefetch import pin_tree_digests
+
+    lock = load_lock(args.project_root)
+    if lock is None:
+        return 1
+
+    results = pin_tree_digests(lock)
+    failed = print_results(results, "pinned")
+    LockFileManager(Path(args.project_root)).save(lock)
+
+    print()
+    if failed:
+        print_error(f"{failed} of {len(results)} components could not be pinned")
+        return 1
+    safe_print(f"✓ Pinned {len(results)} components in toolchainkit.lock")
+    return 0
+
+
+def run_export(args) -> int:
+    """
+    Write the installed components of toolchainkit.lock to a bundle.
+
+    Args:
+        args: Parsed command-line arguments with:
+            - output: Bundle file to write
+            - codec: Frame codec ('zstd', 'zlib' or None for best available)
+            - jobs: Compression threads
+
+    Returns:
+        Exit code (0 for success)
+    """
+    from toolchainkit.core.bundle import BundleError
+    from toolchainkit.toolchain.prefetch import export_bundle
+
+    lock = load_lock(args.project_root)
+    if lock is None:
+        return 1
+
+    start = time.perf_counter()
+    try:
+        components = export_bundle(
+            lock, args.output, codec=args.codec, workers=args.jobs
+        )
+    except (BundleError, OSError) as e:
+        print_error("Bundle export failed", str(e))
+        return 1
+
+    for component in components:
+        print(
+            f"  {component.kind} {component.name}: {len(component.files)} files, "
+            f"{component.total_size / 1024**2:.1f} -> "
+            f"{component.compressed_size / 1024**2:.1f} MB"
+        )
+    size_mb = args.output.stat().st_size / 1024**2
+    safe_print(
+        f"✓ Wrote {args.output} ({len(components)} components, {size_mb:.1f} MB) "
+        f"in {time.perf_counter() - start:.1f}s"
+    )
+    return 0
+
+
+def run_import(args) -> int:
+    """
+    Unpack a bundle into the global cache.
+
+    Args:
+        args: Parsed command-line arguments with:
+            - bundle: Bundle file
+            - jobs: Unpacking threads
+            - force: Replace cached components
+            - no_lock: Import without verifying against toolchainkit.lock
+
+    Returns:
+        Exit code (0 if every component was imported)
+    """
+    from toolchainkit.core.bundle import BundleError
+    from toolchainkit.toolchain.prefetch import import_bundle
+
+    lock = None
+    if not args.no_lock:
+        lock = load_lock(args.project_root)
+        if lock is None:
+            return 1
+
+    start = time.perf_counter()
+    try:
+        results = import_bundle(args.bundle, lock, workers=args.jobs, force=args.force)
+    except BundleError as e:
+        print_error("Bundle import failed", str(e))
+        return 1
+
+    failed = print_results(results, "imported")
+    print()
+    if failed:
+        print_error(f"{failed} of {len(results)} components failed")
+        return 1
+    safe_print(
+        f"✓ Imported {len(results)} components in {time.perf_counter() - start:.1f}s"
+    )
+    return 0
+
+
+def run_delta(args) -> int:
+    """
+    Write a delta patch between two toolchains in the global cache.
+
+    Args:
+        args: Parsed command-line arguments with:
+            - base: Base toolchain ID
+            - target: Target toolchain ID
+            - output: Patch file to write
+            - codec: Codec for stored files
+            - jobs: Hashing and diffing threads
+            - no_binary: Store changed files whole
+
+    Returns:
+        Exit code (0 for success)
+    """
+    from pathlib import Path
+
+    from toolchainkit.core.cache_registry import ToolchainCacheRegistry
+    from toolchainkit.core.directory import get_global_cache_dir
+    from toolchainkit.core.hashing import hash_file
+    from toolchainkit.toolchain.delta import DeltaError, create_delta
+
+    registry = ToolchainCacheRegistry(get_global_cache_dir() / "registry.json")
+    paths = []
+    for toolchain_id in (args.base, args.target):
+        info = registry.get_toolchain_info(toolchain_id)
+        if not info or not Path(info["path"]).is_dir():
+            print_error(f"Toolchain not installed: {toolchain_id}")
+            return 1
+        paths.append(Path(info["path"]))
+
+    try:
+        stats = create_delta(
+            paths[0],
+            paths[1],
+            args.output,
+            base_id=args.base,
+            target_id=args.target,
+            codec=args.codec,
+            workers=args.jobs,
+            binary_patches=not args.no_binary,
+        )
+    except DeltaError as e:
+        print_error("Delta creation failed", str(e))
+        return 1
+
+    safe_print(f"✓ Wrote {args.output}: {stats.summary()}")
+    print(f"  sha256: {hash_file(args.output, 'sha256')}")
+    return 0
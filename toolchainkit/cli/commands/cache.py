@@ -0,0 +1,268 @@
+"""
+Cache command implementation.
+
+Runs and inspects the embedded compiler cache server and benchmarks
+remote cache backends.
+"""
+
+import json
+import logging
+import signal
+import subprocess
+from pathlib import Path
+from typing import List, Optional
+
+from toolchainkit.cli.utils import print_error, safe_print
+
+logger = logging.getLogger(__name__)
+
+
+def _current_git_branch(project_root: Path) -> Optional[str]:
+    """Return the checked-out git branch of project_root, if any."""
+    try:
+        result = subprocess.run(
+            ["git", "rev-parse", "--abbrev-ref", "HEAD"],
+            cwd=project_root,
+            capture_output=True,
+            text=True,
+            timeout=5,
+        )
+    except (OSError, subprocess.TimeoutExpired):
+        return None
+    branch = result.stdout.strip()
+    if result.returncode != 0 or not branch or branch == "HEAD":
+        return None
+    return branch
+
+
+def run_serve(args) -> int:
+    """
+    Run the embedded cache server in the foreground.
+
+    Args:
+        args: Parsed command-line arguments with:
+            - host: Bind address
+            - port: TCP port
+            - dir: Store directory (default: <global cache>/cache-server)
+            - max_size: Size limit (e.g., '10G')
+            - compression: Object codec ('zlib', 'zstd', 'none')
+            - token: Optional bearer token
+            - upstream: Optional remote cache URL for tiered mode
+            - upstream_token: Bearer token for the upstream cache
+            - branch: Branch used for manifest prefetch
+            - no_prefetch: Skip manifest prefetch
+
+    Returns:
+        Exit code (0 for success)
+    """
+    from toolchainkit.caching.server import (
+        CacheServer,
+        DiskLRUStore,
+        clear_server_state,
+        write_server_state,
+    )
+    from toolchainkit.core.directory import get_global_cache_dir
+
+    store_dir = Path(args.dir) if args.dir else get_global_cache_dir() / "cache-server"
+    upstream = getattr(args, "upstream", None)
+
+    try:
+        store = DiskLRUStore(
+            store_dir, max_size=args.max_size, compression=args.compression
+        )
+        if upstream:
+            from toolchainkit.caching.tiered import HTTPRemoteTier, TieredStore
+
+            branch = args.branch or _current_git_branch(Path(args.project_root))
+            store = TieredStore(
+                store,
+                HTTPRemoteTier(upstream, token=args.upstream_token),
+                branch=branch,
+            )
+        server = CacheServer(store, host=args.host, port=args.port, token=args.token)
+    except (ValueError, OSError) as e:
+        logger.error(f"Failed to start cache server: {e}")
+        print_error("Failed to start cache server", str(e))
+        return 1
+
+    stats = store.stats()
+    safe_print(f"✓ Compiler cache server listening on {server.url}")
+    print(f"  Store: {store_dir}")
+    print(f"  Size limit: {args.max_size} ({stats.objects} objects cached)")
+    print(f"  Compression: {args.compression}")
+    if upstream:
+        print(f"  Upstream: {upstream} (write-behind)")
+        if not args.no_prefetch and store.branch:
+            fetched = store.prefetch()
+            print(f"  Prefetched {fetched} objects for branch '{store.branch}'")
+    print()
+    print("Point your builds at it with:")
+    print(f"  export SCCACHE_WEBDAV_ENDPOINT={server.url}")
+    print(f"  export CCACHE_REMOTE_STORAGE={server.url.rstrip('/')}")
+    print()
+    print("Press Ctrl+C to stop")
+
+    # Service managers and containers stop the server with SIGTERM; shut
+    # down as for Ctrl+C so pending uploads and the manifest are written
+    def terminate(signum, frame):
+        raise KeyboardInterrupt
+
+    previous = signal.signal(signal.SIGTERM, terminate)
+    write_server_state(server)
+    try:
+        server.serve_forever()
+    except KeyboardInterrupt:
+        print()
+        print("Stopping cache server")
+    finally:
+        signal.signal(signal.SIGTERM, previous)
+        clear_server_state()
+        server.shutdown()
+        if upstream:
+            print("Flushing pending uploads...")
+            store.close()
+
+    return 0
+
+
+def run_stats(args) -> int:
+    """
+    Print counters of the running local cache server.
+
+    Args:
+        args: Parsed command-line arguments
+
+    Returns:
+        Exit code (0 for success, 1 if no server is running)
+    """
+    from toolchainkit.caching.server import fetch_server_stats
+
+    stats = fetch_server_stats()
+    if stats is None:
+        print_error(
+            "No running cache server found", "Start one with 'tkgen cache serve'"
+        )
+        return 1
+
+    lookups = stats["hits"] + stats["misses"]
+    hit_rate = stats["hits"] / lookups * 100.0 if lookups else 0.0
+    print("Cache server statistics")
+    print(f"  Hits:       {stats['hits']} ({hit_rate:.1f}%)")
+    print(f"  Misses:     {stats['misses']}")
+    print(f"  Objects:    {stats['objects']}")
+    print(f"  Stored:     {stats['stored_bytes'] / (1024 * 1024):.1f} MB")
+    print(f"  Evictions:  {stats['evictions']}")
+
+    if "local_hits" in stats:
+        print(f"  Local hits:  {stats['local_hits']}")
+        print(f"  Remote hits: {stats['remote_hits']}")
+        print(
+            f"  Prefetched:  {stats['prefetched']} "
+            f"({stats['prefetched_bytes'] / (1024 * 1024):.1f} MB)"
+        )
+        print(f"  Backfilled:  {stats['backfill_bytes'] / (1024 * 1024):.1f} MB")
+        print(f"  Saved:       {stats['bytes_saved'] / (1024 * 1024):.1f} MB")
+        print(
+            f"  Uploads:     {stats['uploads_pending']} pending, "
+            f"{stats['upload_errors']} failed"
+        )
+
+    return 0
+
+
+def _bench_candidates(args) -> List:
+    """Backends named on the command line, else from the config file."""
+    from toolchainkit.caching.remote import RemoteCacheConfig
+
+    if args.urls:
+        return [RemoteCacheConfig.from_url(url) for url in args.urls]
+
+    from toolchainkit.config.parser import parse_config
+
+    config_file = (
+        Path(args.config)
+        if getattr(args, "config", None)
+        else Path(args.project_root) / "toolchainkit.yaml"
+    )
+    if not config_file.exists():
+        return []
+    remote = parse_config(config_file).build.caching.remote
+    if not remote:
+        return []
+    entries = remote if isinstance(remote, list) else [remote]
+    return [RemoteCacheConfig.from_dict(entry) for entry in entries]
+
+
+def run_bench(args) -> int:
+    """
+    Benchmark remote cache backends and recommend the fastest.
+
+    Args:
+        args: Parsed command-line arguments with:
+            - urls: Backend URLs (default: build.caching.remote from config)
+            - objects: Objects per backend
+            - concurrency: Parallel connections
+            - criterion: 'throughput' or 'latency'
+            - json: Print JSON instead of a table
+
+    Returns:
+        Exit code (0 if a backend was selected, 1 otherwise)
+    """
+    from toolchainkit.caching.benchmark import RemoteCacheBenchmark
+
+    try:
+        candidates = _bench_candidates(args)
+        bench = RemoteCacheBenchmark(objects=args.objects, concurrency=args.concurrency)
+    except Exception as e:
+        print_error("Invalid benchmark configuration", str(e))
+        return 1
+
+    if not candidates:
+        print_error(
+            "No remote cache backends to benchmark",
+            "Pass backend URLs or set build.caching.remote in toolchainkit.yaml",
+        )
+        return 1
+
+    results = bench.run_all(candidates)
+    best = RemoteCacheBenchmark.select_fastest(results, args.criterion)
+
+    if args.json:
+        print(
+            json.dumps(
+                {
+                    "objects": args.objects,
+                    "concurrency": args.concurrency,
+                    "criterion": args.criterion,
+                    "results": [r.to_dict() for r in results],
+                    "selected": results.index(best) if best else None,
+                },
+                indent=2,
+            )
+        )
+        return 0 if best else 1
+
+    print(
+        f"Remote cache benchmark: {args.objects} objects, "
+        f"-j{args.concurrency}, ranked by {args.criterion}"
+    )
+    for result in results:
+        marker = "*" if result is best else " "
+        print(f" {marker} {result}")
+    print()
+
+    if best is None:
+        print_error("No reachable backend")
+        return 1
+
+    index = results.index(best)
+    endpoint = args.urls[index] if args.urls else best.endpoint
+    safe_print(f"✓ Fastest backend: {best.backend} ({endpoint})")
+    print()
+    print("Configure it in toolchainkit.yaml:")
+    print("  build:")
+    print("    caching:")
+    print("      remote:")
+    print(f"        type: {best.backend}")
+    print(f"        endpoint: {endpoint}")
+    return 0
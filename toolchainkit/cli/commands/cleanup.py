@@ -1,33 +1,107 @@
 """
 Cleanup command implementation.
 
-Cleans up unused toolchains from shared cache.
+Cleans up unused toolchains from shared cache and enforces the cache quota.
 """
 
 import logging
 
+from toolchainkit.cli.utils import print_error, safe_print
+
 logger = logging.getLogger(__name__)
 
 
+def _mb(size_bytes: float) -> str:
+    return f"{size_bytes / (1024 * 1024):.1f} MB"
+
+
+def _print_stats(registry) -> None:
+    """Print cache usage recorded in the registry (no directory walk)."""
+    from toolchainkit.toolchain.cleanup import get_cache_quota
+
+    stats = registry.get_cache_stats()
+    safe_print(
+        f"Toolchains:  {stats['total_toolchains']:>4}  {_mb(stats['toolchain_bytes'])}"
+    )
+    for kind, size in sorted(stats["artifact_bytes"].items()):
+        safe_print(f"{kind.capitalize() + 's:':<12} {'':>4}  {_mb(size)}")
+    safe_print(f"Total:       {'':>4}  {_mb(stats['total_bytes'])}")
+    safe_print(
+        f"Unused:      {stats['unused_toolchains']:>4}  {_mb(stats['reclaimable_bytes'])}"
+    )
+
+    quota = get_cache_quota()
+    if quota:
+        used = stats["total_bytes"] / quota.max_bytes * 100
+        safe_print(
+            f"Quota:       {_mb(quota.max_bytes)} ({used:.0f}% used, evicting above "
+            f"{quota.high_watermark:.0%} down to {quota.low_watermark:.0%})"
+        )
+    else:
+        safe_print("Quota:       none")
+    if stats["last_cleanup"]:
+        safe_print(f"Last cleanup: {stats['last_cleanup']}")
+
+
+def _print_result(result, dry_run: bool) -> None:
+    verb = "Would remove" if dry_run else "Removed"
+    for item in result.removed:
+        safe_print(f"  {verb}: {item}")
+    for error in result.errors:
+        print_error(error)
+    safe_print(
+        f"{verb} {len(result.removed)} item(s), {_mb(result.space_reclaimed)} reclaimed"
+    )
+
+
 def run(args) -> int:
     """
     Run the cleanup command.
 
     Args:
-        args: Parsed command-line arguments
+        args: Parsed command-line arguments with:
+            - dry_run: Only show what would be removed
+            - unused: Remove toolchains with no project references
+            - older_than: Only remove toolchains unused for this many days
+            - toolchain: Remove this toolchain
+            - stats: Show cache statistics
+            - quota: Size to evict down to (default: configured quota)
 
     Returns:
-        Exit code (0 for success)
+        Exit code (0 for success, 1 for errors)
     """
-    logger.info("Cleanup command - to be implemented in future task")
+    from toolchainkit.core.cache_registry import ToolchainCacheRegistry
+    from toolchainkit.core.locking import LockManager
+    from toolchainkit.toolchain.cleanup import (
+        CacheQuota,
+        ToolchainCleanupManager,
+        get_cache_quota,
+    )
+
     logger.debug(f"Arguments: {args}")
+    registry = ToolchainCacheRegistry()
+    dry_run = bool(args.dry_run)
+
+    if args.stats:
+        _print_stats(registry)
+        return 0
 
-    # Placeholder implementation
-    print("ToolchainKit cleanup command")
-    print("This command will be fully implemented in a future task")
-    print(f"  --dry-run: {args.dry_run}")
-    print(f"  --unused: {args.unused}")
-    print(f"  --older-than: {args.older_than}")
-    print(f"  --toolchain: {args.toolchain}")
+    manager = ToolchainCleanupManager(registry, LockManager())
+    try:
+        if args.toolchain:
+            result = manager.cleanup([args.toolchain], dry_run=dry_run)
+        elif args.unused or args.older_than is not None:
+            unused = manager.list_unused(min_age_days=args.older_than or 0)
+            result = manager.cleanup([tc.id for tc in unused], dry_run=dry_run)
+        else:
+            quota = CacheQuota.parse(args.quota) if args.quota else get_cache_quota()
+            if quota is None:
+                _print_stats(registry)
+                return 0
+            result = manager.enforce_quota(quota, dry_run=dry_run)
+    except ValueError as e:
+        print_error(str(e))
+        return 1
 
-    return 0
+    _print_result(result, dry_run)
+    return 1 if result.failed else 0
@@ -12,6 +12,7 @@ from typing import Optional
 
 
 from toolchainkit.cli.utils import (
+    apply_download_config,
     check_initialized,
     format_success_message,
     get_package_manager_instance,
@@ -20,6 +21,7 @@ from toolchainkit.cli.utils import (
     print_warning,
     safe_print,
 )
+from toolchainkit.core import tracing
 
 logger = logging.getLogger(__name__)
 
@@ -67,11 +69,13 @@ def run(args) -> int:
     # 3. Load configuration
     logger.debug(f"Loading configuration from {config_file}")
     try:
-        config = load_yaml_config(config_file, required=True)
+        with tracing.span("load config", "config"):
+            config = load_yaml_config(config_file, required=True)
     except (FileNotFoundError, ValueError) as e:
         logger.error(f"Failed to load configuration: {e}")
         print_error("Failed to load configuration", str(e))
         return 1
+    apply_download_config(config)
 
     # 3.5. Auto-detect package manager if not configured or if configured but not available
     configured_pm = (
@@ -86,10 +90,14 @@ def run(args) -> int:
         # Verify configured package manager is actually available
         try:
             logger.debug(f"Verifying configured package manager: {configured_pm}")
-            pm_instance = get_package_manager_instance(
-                configured_pm, project_root, config.get("packages", {})
-            )
-            if not pm_instance.detect():
+            with tracing.span(
+                "detect package manager", "packages", manager=configured_pm
+            ):
+                pm_instance = get_package_manager_instance(
+                    configured_pm, project_root, config.get("packages", {})
+                )
+                found = pm_instance.detect()
+            if not found:
                 logger.warning(
                     f"Configured package manager '{configured_pm}' not found in project "
                     f"(no manifest file detected). Attempting auto-detection..."
@@ -159,13 +167,17 @@ def run(args) -> int:
         from toolchainkit.core.platform import detect_platform
         from toolchainkit.plugins.registry import get_global_registry
 
-        platform_info = detect_platform()
+        with tracing.span("detect platform", "platform"):
+            platform_info = detect_platform()
         platform_str = f"{platform_info.os}-{platform_info.arch}"
 
         # Get toolchain type and version from config if available
+        components = None
         if "toolchain" in config:
             toolchain_type = config["toolchain"].get("type", "")
             version = config["toolchain"].get("version", "latest")
+            # Component profile or list (e.g. "minimal"); default installs all
+            components = config["toolchain"].get("components")
         else:
             # Fallback: parse from toolchain name (format: type-version)
             parts = toolchain_name.rsplit("-", 1)
@@ -181,7 +193,9 @@ def run(args) -> int:
 
         # Get toolchain providers from registry
         registry = get_global_registry()
-        providers = registry.get_toolchain_providers()
+        with tracing.span("toolchain providers", "plugins") as span:
+            providers = registry.get_toolchain_providers()
+            span.set(count=len(providers))
 
         if not providers:
             raise RuntimeError(
@@ -250,12 +264,19 @@ def run(args) -> int:
         for provider in providers:
             if provider.can_provide(toolchain_type, version):
                 logger.info(f"Found provider for {toolchain_type}")
-                toolchain_path = provider.provide_toolchain(
-                    toolchain_type,
-                    version,
-                    platform_str,
-                    progress_callback=show_progress,
-                )
+                with tracing.span(
+                    "provide toolchain",
+                    "toolchain",
+                    provider=type(provider).__name__,
+                    toolchain=f"{toolchain_type}-{version}",
+                ):
+                    toolchain_path = provider.provide_toolchain(
+                        toolchain_type,
+                        version,
+                        platform_str,
+                        progress_callback=show_progress,
+                        components=components,
+                    )
                 if toolchain_path:
                     toolchain_id = provider.get_toolchain_id(
                         toolchain_type, version, platform_str
@@ -270,6 +291,7 @@ def run(args) -> int:
         logger.info(f"Toolchain installed at: {toolchain_path}")
         print(f"  Toolchain path: {toolchain_path}")
         print()
+        _record_toolchain_use(toolchain_id, project_root)
 
     except Exception as e:
         logger.error(f"Failed to download toolchain: {e}")
@@ -506,6 +528,20 @@ message(STATUS "  Using strategy configuration without toolchain binaries")
     return 0
 
 
+def _caching_config(config: dict) -> dict:
+    """
+    Compiler caching settings of a project configuration.
+
+    Reads ``build.caching`` (the schema parse_config() uses) and falls back
+    to a top-level ``cache`` mapping.
+    """
+    build = config.get("build")
+    caching = build.get("caching") if isinstance(build, dict) else None
+    if not isinstance(caching, dict):
+        caching = config.get("cache")
+    return caching if isinstance(caching, dict) else {}
+
+
 def _run_bootstrap(
     project_root: Path,
     args,
@@ -528,7 +564,7 @@ def _run_bootstrap(
     """
     import subprocess
     import os
-    from toolchainkit.packages.tool_downloader import NinjaDownloader
+    from toolchainkit.packages.tool_installer import ToolInstaller
     from toolchainkit.core.platform import detect_platform
 
     logger.info("Running bootstrap steps...")
@@ -572,30 +608,57 @@ def _run_bootstrap(
         except Exception as e:
             logger.warning(f"Failed to query strategy for preferred generator: {e}")
 
-    # Setup Ninja if it's the preferred generator
+    # Setup build tools (Ninja if it's the preferred generator, sccache if
+    # compiler caching is enabled), installing missing ones concurrently
+    tool_names = []
     if preferred_generator == "Ninja":
         logger.info("Strategy requires Ninja generator, setting up Ninja...")
-        print("Setting up Ninja build system...")
+        tool_names.append("ninja")
+    cache_config = _caching_config(config)
+    if (
+        cache_config.get("enabled")
+        and (cache_config.get("tool") or "sccache") == "sccache"
+        and not shutil.which("sccache")
+    ):
+        tool_names.append("sccache")
+
+    if tool_names:
+        print(f"Setting up build tools ({', '.join(tool_names)})...")
 
         try:
             from toolchainkit.core.directory import get_global_cache_dir
 
             global_cache_dir = get_global_cache_dir()
             tools_dir = global_cache_dir / "tools"
-            downloader = NinjaDownloader(tools_dir, platform=platform)
-            if not downloader.is_installed():
-                downloader.download()
-
-            ninja_path = downloader.get_executable_path()
-            if ninja_path:
-                use_ninja = True
-                # Add to PATH for this process
-                ninja_dir = ninja_path.parent
-                os.environ["PATH"] = str(ninja_dir) + os.pathsep + os.environ["PATH"]
-                print(f"  Ninja installed: {ninja_path}")
+            interactive = sys.stdout.isatty()
+
+            def show_progress(progress):
+                if interactive:
+                    sys.stdout.write(f"\r  {progress.summary():<78}")
+                    sys.stdout.flush()
+
+            installer = ToolInstaller(tools_dir, platform=platform)
+            results = installer.install(tool_names, progress_callback=show_progress)
+            if interactive:
+                sys.stdout.write("\n")
+
+            for name, result in results.items():
+                if not result.success:
+                    logger.warning(f"Failed to setup {name}: {result.error}")
+                    print_warning(f"Failed to setup {name}: {result.error}")
+                    continue
+                if result.path:
+                    # Add to PATH for this process
+                    os.environ["PATH"] = (
+                        str(result.path.parent) + os.pathsep + os.environ["PATH"]
+                    )
+                    print(f"  {name} installed: {result.path}")
+                if name == "ninja":
+                    ninja_path = result.path
+                    use_ninja = ninja_path is not None
         except Exception as e:
-            logger.warning(f"Failed to setup Ninja: {e}")
-            print_warning(f"Failed to setup Ninja: {e}")
+            logger.warning(f"Failed to setup build tools: {e}")
+            print_warning(f"Failed to setup build tools: {e}")
 
     # 2. Install Dependencies
     if config.get("packages") and config["packages"].get("manager"):
@@ -699,7 +762,8 @@ def _run_bootstrap(
 
     try:
         logger.debug(f"Running CMake: {cmake_cmd}")
-        subprocess.run(cmake_cmd, check=True)
+        with tracing.span("cmake configure", "subprocess", command=cmake_cmd):
+            subprocess.run(cmake_cmd, check=True)
         print("  CMake configuration successful")
         print()
     except subprocess.CalledProcessError as e:
@@ -712,6 +776,18 @@ def _run_bootstrap(
     return 0
 
 
+def _record_toolchain_use(toolchain_id: str, project_root: Path) -> None:
+    """Reference the toolchain from this project so quota eviction keeps it."""
+    from toolchainkit.core.cache_registry import ToolchainCacheRegistry
+    from toolchainkit.core.directory import get_global_cache_dir
+
+    try:
+        registry = ToolchainCacheRegistry(get_global_cache_dir() / "registry.json")
+        registry.set_project_toolchain(toolchain_id, project_root)
+    except Exception as e:
+        logger.warning(f"Could not record toolchain reference: {e}")
+
+
 def _merge_arguments(config: dict, args) -> dict:
     """
     Merge command-line arguments with config file.
@@ -737,6 +813,7 @@ def _merge_arguments(config: dict, args) -> dict:
     return merged
 
 
+@tracing.traced("generate conan profile", "packages")
 def _generate_conan_profile(
     project_root: Path,
     toolchain_name: str,
@@ -950,6 +1027,7 @@ tools.build:compiler_executables={{"c": "{c_compiler_str}", "cpp": "{cxx_compile
         raise Exception(f"Failed to write Conan profile to {profile_path}: {e}") from e
 
 
+@tracing.traced("install dependencies", "packages")
 def _install_dependencies(project_root: Path, packages_config: dict):
     """
     Install package dependencies based on configuration.
@@ -0,0 +1,154 @@
+"""
+Daemon command implementation.
+
+Starts, stops and inspects the per-user tkgen daemon that serves commands
+from a process with warm state (see toolchainkit.cli.daemon).
+"""
+
+import logging
+import os
+import subprocess
+import sys
+import time
+
+from toolchainkit.cli.utils import print_error, safe_print
+
+logger = logging.getLogger(__name__)
+
+
+def _status():
+    """Status of the running daemon, or None."""
+    from toolchainkit.cli.daemon import request
+
+    try:
+        return request({"op": "status"}, timeout=2.0)
+    except (OSError, ValueError):
+        return None
+
+
+def run_start(args) -> int:
+    """
+    Start the daemon in the background (or in the foreground).
+
+    Args:
+        args: Parsed command-line arguments with:
+            - foreground: Serve in this process until stopped
+            - idle_timeout: Minutes without requests before the daemon exits
+
+    Returns:
+        Exit code (0 for success)
+    """
+    from toolchainkit.cli.daemon import TkgenDaemon, socket_path, supported
+
+    if not supported():
+        print_error("The tkgen daemon is not supported on this platform")
+        return 1
+
+    status = _status()
+    if status is not None:
+        safe_print(f"✓ tkgen daemon already running (pid {status['pid']})")
+        return 0
+
+    path = socket_path()
+    if args.foreground:
+        daemon = TkgenDaemon(path, idle_timeout=args.idle_timeout * 60)
+        try:
+            daemon.warm()
+            daemon.serve_forever()
+        except OSError as e:
+            print_error("Failed to start tkgen daemon", str(e))
+            return 1
+        except KeyboardInterrupt:
+            pass
+        return 0
+
+    path.parent.mkdir(parents=True, exist_ok=True)
+    log_file = path.with_suffix(".log")
+    with open(log_file, "ab") as log:
+        process = subprocess.Popen(
+            [
+                sys.executable,
+                "-m",
+                "toolchainkit.cli",
+                "daemon",
+                "start",
+                "--foreground",
+                "--idle-timeout",
+                str(args.idle_timeout),
+            ],
+            stdin=subprocess.DEVNULL,
+            stdout=log,
+            stderr=subprocess.STDOUT,
+            start_new_session=True,
+        )
+
+    deadline = time.monotonic() + 30
+    while time.monotonic() < deadline:
+        status = _status()
+        if status is not None:
+            safe_print(f"✓ tkgen daemon started (pid {status['pid']})")
+            print(f"  Socket: {status['socket']}")
+            print(f"  Warm state built in {status['warm_seconds'] * 1000:.0f} ms")
+            return 0
+        if process.poll() is not None:
+            break
+        time.sleep(0.05)
+
+    print_error("Failed to start tkgen daemon", f"See {log_file}")
+    return 1
+
+
+def run_stop(args) -> int:
+    """
+    Stop the running daemon.
+
+    Args:
+        args: Parsed command-line arguments
+
+    Returns:
+        Exit code (0 for success, also when no daemon is running)
+    """
+    from toolchainkit.cli.daemon import request, socket_path
+
+    try:
+        request({"op": "stop"}, timeout=2.0)
+    except (OSError, ValueError):
+        print("No tkgen daemon is running")
+        return 0
+
+    path = socket_path()
+    deadline = time.monotonic() + 10
+    while path.exists() and time.monotonic() < deadline:
+        time.sleep(0.05)
+    safe_print("✓ tkgen daemon stopped")
+    return 0
+
+
+def run_status(args) -> int:
+    """
+    Print the state of the running daemon.
+
+    Args:
+        args: Parsed command-line arguments
+
+    Returns:
+        Exit code (0 if a daemon is running, 1 otherwise)
+    """
+    status = _status()
+    if status is None:
+        print("No tkgen daemon is running")
+        print("  Start one with 'tkgen daemon start'")
+        return 1
+
+    print(f"tkgen daemon (pid {status['pid']})")
+    print(f"  Socket:      {status['socket']}")
+    print(f"  Uptime:      {status['uptime'] / 60:.1f} min")
+    print(f"  Requests:    {status['requests']} ({status['running']} running)")
+    print(
+        f"  Warm state:  #{status['generation']}, built in "
+        f"{status['warm_seconds'] * 1000:.0f} ms"
+    )
+    print(f"  Watching:    {status['watched']} paths")
+    if os.path.realpath(status["python"]) != os.path.realpath(sys.executable):
+        print(f"  Python:      {status['python']} (not this interpreter)")
+    return 0
@@ -266,10 +266,11 @@ class CorruptedCacheCheck(DoctorCheck):
         self.cache_dir = cache_dir or get_global_cache_dir()
 
     def check(self) -> CheckResult:
-        """Check for corrupted cache files."""
+        """Check for corrupted cache files and damaged installations."""
         corrupted = self._find_corrupted_files()
+        damaged = self._find_damaged_installs()
 
-        if not corrupted:
+        if not corrupted and not damaged:
             return CheckResult(
                 name="Cache",
                 passed=True,
@@ -277,10 +278,23 @@ class CorruptedCacheCheck(DoctorCheck):
                 fixable=False,
             )
 
+        if not corrupted:
+            return CheckResult(
+                name="Cache",
+                passed=False,
+                message=f"{len(damaged)} damaged installation(s): "
+                + "; ".join(f"{path.name}: {summary}" for path, summary in damaged),
+                fix_command="Remove the damaged installation(s) and reinstall",
+                fixable=False,
+            )
+
+        message = f"{len(corrupted)} corrupted file(s) in cache"
+        if damaged:
+            message += f", {len(damaged)} damaged installation(s)"
         return CheckResult(
             name="Cache",
             passed=False,
-            message=f"{len(corrupted)} corrupted file(s) in cache",
+            message=message,
             fix_command="Run with --fix to clean corrupted cache files",
             fixable=True,
         )
@@ -338,6 +352,37 @@ class CorruptedCacheCheck(DoctorCheck):
 
         return corrupted
 
+    def _find_damaged_installs(self) -> List[tuple]:
+        """
+        Verify installed toolchains and tools against their manifests.
+
+        Only files whose size or mtime changed since installation are
+        re-hashed, so this stays fast on large warm toolchains.
+
+        Returns:
+            List of (installation path, summary) for installations that differ
+        """
+        from toolchainkit.core.manifest import (
+            MANIFEST_NAME,
+            IntegrityManifest,
+            ManifestError,
+        )
+
+        damaged: List[tuple] = []
+        manifests = list(self.cache_dir.glob(f"toolchains/*/{MANIFEST_NAME}"))
+        manifests += self.cache_dir.glob(f"tools/*/*/{MANIFEST_NAME}")
+        for manifest_file in manifests:
+            install_dir = manifest_file.parent
+            try:
+                manifest = IntegrityManifest.load(install_dir)
+                result = manifest.verify()
+            except ManifestError as e:
+                damaged.append((install_dir, str(e)))
+                continue
+            if not result.ok:
+                damaged.append((install_dir, result.summary()))
+        return damaged
+
 
 class DoctorRunner:
     """Manages running health checks and auto-fixes."""
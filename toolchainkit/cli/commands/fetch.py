@@ -0,0 +1,105 @@
+"""
+Fetch command implementation.
+
+Prefetches every component pinned in toolchainkit.lock into the global cache.
+"""
+
+import logging
+import time
+from pathlib import Path
+
+from toolchainkit.cli.utils import (
+    apply_download_config,
+    load_yaml_config,
+    print_error,
+    safe_print,
+)
+
+logger = logging.getLogger(__name__)
+
+
+def load_lock(project_root: Path):
+    """
+    Load the project's lock file, printing an error if there is none.
+
+    Args:
+        project_root: Project root directory
+
+    Returns:
+        LockFile, or None if missing or unreadable
+    """
+    from toolchainkit.config.lockfile import LockFileError, LockFileManager
+
+    try:
+        lock = LockFileManager(Path(project_root)).load()
+    except LockFileError as e:
+        print_error("Cannot read toolchainkit.lock", str(e))
+        return None
+    if lock is None:
+        print_error("No toolchainkit.lock found", f"Looked in {project_root}")
+    return lock
+
+
+def print_results(results, verb: str) -> int:
+    """
+    Print one line per component and return the number of failures.
+
+    Args:
+        results: FetchResult list
+        verb: Past tense of the action (e.g. 'fetched')
+
+    Returns:
+        Number of failed components
+    """
+    failed = 0
+    for result in results:
+        label = f"{result.kind} {result.name}"
+        if not result.success:
+            failed += 1
+            safe_print(f"  ✗ {label}: {result.error}")
+        elif result.cached:
+            safe_print(f"  ✓ {label} (cached)")
+        else:
+            safe_print(f"  ✓ {label} {verb} in {result.seconds:.1f}s")
+    return failed
+
+
+def run(args) -> int:
+    """
+    Run the fetch command.
+
+    Args:
+        args: Parsed command-line arguments with:
+            - from_lock: Fetch components pinned in toolchainkit.lock
+            - jobs: Concurrent downloads
+            - force: Re-download cached components
+
+    Returns:
+        Exit code (0 if every component is in the cache)
+    """
+    from toolchainkit.toolchain.prefetch import prefetch_from_lock
+
+    lock = load_lock(args.project_root)
+    if lock is None:
+        return 1
+    try:
+        apply_download_config(
+            load_yaml_config(Path(args.project_root) / "toolchainkit.yaml")
+        )
+    except ValueError as e:
+        logger.warning(f"Ignoring unreadable toolchainkit.yaml: {e}")
+
+    total = len(lock.toolchains) + len(lock.build_tools) + len(lock.sysroots)
+    print(f"Fetching {total} locked components (-j{args.jobs})...")
+    start = time.perf_counter()
+    results = prefetch_from_lock(lock, workers=args.jobs, force=args.force)
+    failed = print_results(results, "fetched")
+
+    print()
+    if failed:
+        print_error(f"{failed} of {len(results)} components failed")
+        return 1
+    safe_print(
+        f"✓ {len(results)} components ready in {time.perf_counter() - start:.1f}s"
+    )
+    return 0
@@ -0,0 +1,58 @@
+"""
+Mirror command implementation.
+
+Serves the global downloads directory so other machines can use it as a
+download mirror.
+"""
+
+import logging
+from pathlib import Path
+
+from toolchainkit.cli.utils import print_error, safe_print
+
+logger = logging.getLogger(__name__)
+
+
+def run_serve(args) -> int:
+    """
+    Run the download mirror in the foreground.
+
+    Args:
+        args: Parsed command-line arguments with:
+            - host: Bind address
+            - port: TCP port
+            - dir: Directory to serve (default: <global cache>/downloads)
+
+    Returns:
+        Exit code (0 for success)
+    """
+    from toolchainkit.core.directory import get_global_cache_dir
+    from toolchainkit.core.mirror import MirrorServer, summarize_directory
+
+    root = Path(args.dir) if args.dir else get_global_cache_dir() / "downloads"
+
+    try:
+        server = MirrorServer(root, host=args.host, port=args.port)
+    except OSError as e:
+        logger.error(f"Failed to start mirror server: {e}")
+        print_error("Failed to start mirror server", str(e))
+        return 1
+
+    count, total = summarize_directory(root)
+    safe_print(f"✓ Download mirror listening on {server.url}")
+    print(f"  Serving: {root} ({count} files, {total / 1024**2:.1f} MB)")
+    print()
+    print("Use it from other machines with:")
+    print(f"  export TOOLCHAINKIT_MIRRORS={server.url.rstrip('/')}")
+    print()
+    print("Press Ctrl+C to stop")
+
+    try:
+        server.serve_forever()
+    except KeyboardInterrupt:
+        print()
+        print("Stopping mirror server")
+    finally:
+        server.shutdown()
+
+    return 0
@@ -38,8 +38,8 @@ def run_list(args) -> int:
         manager = PluginManager(project_root=project_root)
 
         if args.loaded_only:
-            # Show only loaded plugins
-            loaded_count = manager.discover_and_load_all()
+            # Show only loaded plugins (including ones normally deferred)
+            loaded_count = manager.discover_and_load_all(lazy=False)
             loaded_plugins = manager.get_loaded_plugins()
 
             if not loaded_plugins:
@@ -64,7 +64,7 @@ def run_list(args) -> int:
 
             # Try to load plugins to see which ones work
             if args.verbose:
-                manager.discover_and_load_all()
+                manager.discover_and_load_all(lazy=False)
                 loaded_names = set(manager.get_loaded_plugins())
 
             safe_print(f"\n{len(all_plugins)} plugin(s) discovered:\n")
@@ -82,6 +82,8 @@ def run_list(args) -> int:
 
                 if args.verbose:
                     safe_print(f"     Type: {plugin_meta.type}")
+                    for kind, names in plugin_meta.provides.items():
+                        safe_print(f"     Provides {kind}: {', '.join(names)}")
                     safe_print(f"     Path: {plugin_meta.plugin_dir}")
                     if plugin_meta.description:
                         safe_print(f"     Description: {plugin_meta.description}")
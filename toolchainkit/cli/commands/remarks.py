@@ -0,0 +1,62 @@
+"""
+Remarks command implementation.
+
+Reports missed vectorizations and inlining failures from the optimization
+records of a build (profiling/opt-remarks layer).
+"""
+
+import json
+import logging
+from pathlib import Path
+
+from toolchainkit.cli.utils import print_error, safe_print
+
+logger = logging.getLogger(__name__)
+
+
+def run(args) -> int:
+    """
+    Run the remarks command.
+
+    Args:
+        args: Parsed command-line arguments with:
+            - build_dir: Build directory (relative to the project root)
+            - profile: Optional perf.data or perf report output
+            - category: vectorization, inlining or all
+            - limit: Number of findings to show (0 for all)
+            - json: Print JSON instead of text
+
+    Returns:
+        Exit code (0 for success)
+    """
+    from toolchainkit.profiling.remarks import CATEGORIES, RemarksError, collect
+
+    build_dir = Path(args.project_root) / args.build_dir
+    if not build_dir.is_dir():
+        print_error(f"Build directory not found: {build_dir}")
+        return 1
+
+    categories = CATEGORIES if args.category == "all" else (args.category,)
+    try:
+        report = collect(build_dir, profile=args.profile, categories=categories)
+    except RemarksError as e:
+        print_error("Cannot load profile", str(e))
+        return 1
+
+    if report.record_files == 0:
+        print_error(
+            f"No optimization records in {build_dir}",
+            "Build with the profiling/opt-remarks layer first",
+        )
+        return 1
+
+    if args.json:
+        data = report.to_dict()
+        if args.limit:
+            data["findings"] = data["findings"][: args.limit]
+        safe_print(json.dumps(data, indent=2))
+    else:
+        from toolchainkit.profiling.remarks import format_report
+
+        safe_print(format_report(report, limit=args.limit or None))
+    return 0
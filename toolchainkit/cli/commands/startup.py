@@ -0,0 +1,63 @@
+"""
+Startup command implementation.
+
+Measures how long a program takes from exec to exit and how much of that
+is spent in the dynamic loader, optionally against a baseline build
+(optimization/startup layer).
+"""
+
+import json
+import logging
+import shlex
+
+from toolchainkit.cli.utils import print_error, safe_print
+
+logger = logging.getLogger(__name__)
+
+
+def run(args) -> int:
+    """
+    Run the startup command.
+
+    Args:
+        args: Parsed command-line arguments with:
+            - program: Program and arguments to measure
+            - baseline: Optional baseline command line (one string)
+            - runs: Timed runs per command
+            - warmup: Untimed runs per command
+            - json: Print JSON instead of a table
+
+    Returns:
+        Exit code (0 for success)
+    """
+    from toolchainkit.profiling.startup import (
+        StartupError,
+        compare_startup,
+        format_results,
+    )
+
+    program = list(args.program)
+    if program and program[0] == "--":
+        program = program[1:]
+    if not program:
+        print_error("No program given", "Usage: tkgen startup [OPTIONS] PROGRAM [ARGS]")
+        return 1
+    if args.runs < 1:
+        print_error("--runs must be at least 1")
+        return 1
+
+    commands = [program]
+    if args.baseline:
+        commands.insert(0, shlex.split(args.baseline))
+
+    try:
+        results = compare_startup(*commands, runs=args.runs, warmup=args.warmup)
+    except StartupError as e:
+        print_error("Startup measurement failed", str(e))
+        return 1
+
+    if args.json:
+        safe_print(json.dumps([r.to_dict() for r in results], indent=2))
+    else:
+        safe_print(format_results(results))
+    return 0
@@ -5,8 +5,10 @@ Upgrades toolchains and ToolchainKit itself to latest versions.
 """
 
 import logging
+from concurrent.futures import ThreadPoolExecutor
 
 from toolchainkit.toolchain.upgrader import (
+    DEFAULT_CHECK_WORKERS,
     ToolchainUpgrader,
     check_toolchainkit_updates,
     upgrade_toolchainkit,
@@ -180,7 +182,9 @@ def _upgrade_toolchain(toolchain_name: str) -> int:
         print()  # New line after progress
 
         if result.success:
-            safe_print(f"✅ Upgraded to {result.new_version}")
+            safe_print(
+                f"✅ Upgraded to {result.new_version} {_transfer_summary(result)}"
+            )
             return 0
         else:
             safe_print(f"❌ Upgrade failed: {result.error}")
@@ -200,6 +204,14 @@ def _upgrade_toolchain(toolchain_name: str) -> int:
         return 1
 
 
+def _transfer_summary(result) -> str:
+    """Describe how an upgrade was installed, e.g. '(delta, 12.3 MB in 4.1s)'."""
+    return (
+        f"({result.method}, {result.bytes_transferred / 1024**2:.1f} MB "
+        f"in {result.seconds:.1f}s)"
+    )
+
+
 def _upgrade_all_toolchains() -> int:
     """
     Upgrade all installed toolchains.
@@ -226,16 +238,21 @@ def _upgrade_all_toolchains() -> int:
             print("No toolchains installed")
             return 0
 
-        # Check each for updates
-        updates_available = []
-
-        for toolchain_id in installed_ids:
+        # Check all for updates concurrently
+        def check(toolchain_id):
             try:
-                update_info = upgrader.check_for_updates(toolchain_id)
-                if update_info:
-                    updates_available.append((toolchain_id, update_info))
+                return upgrader.check_for_updates(toolchain_id)
             except Exception as e:
                 logger.warning(f"Failed to check {toolchain_id}: {e}")
+                return None
+
+        with ThreadPoolExecutor(max_workers=DEFAULT_CHECK_WORKERS) as pool:
+            checked = list(pool.map(check, installed_ids))
+        updates_available = [
+            (toolchain_id, update_info)
+            for toolchain_id, update_info in zip(installed_ids, checked)
+            if update_info
+        ]
 
         if not updates_available:
             safe_print("✅ All toolchains are up to date")
@@ -264,33 +281,24 @@ def _upgrade_all_toolchains() -> int:
             print("\nUpgrade cancelled")
             return 130
 
-        # Perform upgrades
+        # Perform upgrades (bounded pool, one registry update at the end)
+        print(f"Upgrading {len(updates_available)} toolchain(s)...")
+        results = upgrader.upgrade_all_toolchains(updates=dict(updates_available))
+
         print()
         success_count = 0
         failure_count = 0
-
-        for i, (toolchain_id, update_info) in enumerate(updates_available, 1):
-            print(f"[{i}/{len(updates_available)}] Upgrading {toolchain_id}...")
-
-            def progress_callback(phase: str, current: int, total: int):
-                """Display progress."""
-                if total > 0:
-                    percentage = (current / total) * 100
-                    print(f"\r  {phase}: {percentage:.1f}%", end="", flush=True)
-
-            result = upgrader.upgrade_toolchain(
-                toolchain_id=toolchain_id, progress_callback=progress_callback
-            )
-
-            print()  # New line after progress
-
+        for result in results:
             if result.success:
-                safe_print(f"  ✅ Upgraded to {result.new_version}")
+                safe_print(
+                    f"  ✅ {result.toolchain_id} → {result.new_version} "
+                    f"{_transfer_summary(result)}"
+                )
                 success_count += 1
             else:
-                safe_print(f"  ❌ Failed: {result.error}")
+                safe_print(f"  ❌ {result.toolchain_id}: {result.error}")
                 failure_count += 1
-            print()
+        print()
 
         # Summary
         print(f"Summary: {success_count} upgraded, {failure_count} failed")
@@ -0,0 +1,666 @@
+"""
+Persistent tkgen daemon.
+
+Every ``tkgen`` invocation starts a fresh interpreter that imports the
+command modules and their dependencies, registers the built-in strategies
+and package managers, detects the platform and parses the toolchain
+metadata and layer YAMLs before doing any work. ``tkgen daemon start`` runs
+a per-user background process that does this once and serves commands over
+a Unix domain socket:
+
+- The client (``tkgen`` itself) sends its arguments, working directory and
+  environment, and passes its stdin/stdout/stderr file descriptors.
+- The daemon forks a child per request. The child inherits the warm state,
+  switches to the client's directory, environment and descriptors, runs the
+  command and reports its exit code, so commands cannot leak state into the
+  daemon or into each other. Ctrl+C in the client interrupts the child.
+- Before each request the daemon stats the files its state was built from
+  (toolchain metadata, built-in and global layers, plugin configuration) and
+  rebuilds the state when one changed. It exits when toolchainkit's own
+  sources change and after an idle timeout.
+- Both ends only talk to the same user: the client checks the socket file's
+  owner and mode before connecting, and both check the peer's uid where the
+  platform reports it (SO_PEERCRED). Clients whose environment differs in a
+  variable the warm state depends on (see _STATE_ENV) run in-process.
+
+The daemon is opt-in: when none is running, or with ``TOOLCHAINKIT_DAEMON=0``,
+``tkgen`` runs in-process as before. Unix only.
+
+Example:
+    >>> daemon = TkgenDaemon(socket_path())
+    >>> daemon.warm()
+    >>> daemon.serve_forever()
+    >>> run_client(["doctor"])  # From another process: exit code or None
+"""
+
+import importlib
+import logging
+import os
+import sys
+import threading
+import time
+from pathlib import Path
+from typing import Dict, Iterable, List, Optional, Tuple
+
+# json, socket, struct and signal are imported where they are used: every
+# tkgen start imports this module to look for a daemon, and these imports
+# would double the cost of that check when no daemon is running.
+
+logger = logging.getLogger(__name__)
+
+DAEMON_ENV = "TOOLCHAINKIT_DAEMON"
+"""Set to '0', 'false', 'no' or 'off' to never use a running daemon."""
+
+SOCKET_ENV = "TOOLCHAINKIT_DAEMON_SOCKET"
+"""Overrides the socket path (default: <global cache>/daemon.sock)."""
+
+DEFAULT_IDLE_TIMEOUT = 3 * 3600
+"""Seconds without requests after which the daemon exits."""
+
+# Variables the warm state depends on (the global cache directory, plugin
+# search path and platform detection); the daemon only serves clients whose
+# values match its own
+_STATE_ENV = (
+    "HOME",
+    "USERPROFILE",
+    "TOOLCHAINKIT_PLUGIN_PATH",
+    "MACOSX_DEPLOYMENT_TARGET",
+)
+
+_HEADER = "!I"  # Message length prefix
+_HEADER_SIZE = 4
+_STDIO = (0, 1, 2)
+
+# Modules imported before the first request; missing optional ones are skipped
+_WARM_MODULES = (
+    "toolchainkit.cli.utils",
+    "toolchainkit.cli.commands.init",
+    "toolchainkit.cli.commands.bootstrap",
+    "toolchainkit.cli.commands.configure",
+    "toolchainkit.cli.commands.cleanup",
+    "toolchainkit.cli.commands.upgrade",
+    "toolchainkit.cli.commands.verify",
+    "toolchainkit.cli.commands.doctor",
+    "toolchainkit.cli.commands.vscode",
+    "toolchainkit.cli.commands.fetch",
+    "toolchainkit.config.composer",
+    "toolchainkit.cmake.toolchain_generator",
+    "toolchainkit.toolchain.downloader",
+    "toolchainkit.toolchain.providers",
+    "toolchainkit.packages",
+)
+
+
+def supported() -> bool:
+    """Whether this platform supports the daemon (fork and fd passing)."""
+    if not hasattr(os, "fork"):
+        return False
+    import socket
+
+    return hasattr(socket, "AF_UNIX") and hasattr(socket, "send_fds")
+
+
+def socket_path() -> Path:
+    """Path of the daemon's Unix domain socket."""
+    override = os.environ.get(SOCKET_ENV)
+    if override:
+        return Path(override)
+    from toolchainkit.core.directory import get_global_cache_dir
+
+    return get_global_cache_dir() / "daemon.sock"
+
+
+def _identity() -> Dict[str, str]:
+    """Interpreter and package; clients are only served by a matching daemon."""
+    return {
+        "python": sys.executable,
+        "package": str(Path(__file__).resolve().parents[1]),
+    }
+
+
+def _send(sock, message: dict, fds: Iterable[int] = ()) -> None:
+    """Send a length-prefixed JSON message, optionally with file descriptors."""
+    import json
+    import socket
+    import struct
+
+    data = json.dumps(message).encode("utf-8")
+    frame = struct.pack(_HEADER, len(data)) + data
+    sent = socket.send_fds(sock, [frame], list(fds))
+    if sent < len(frame):
+        sock.sendall(frame[sent:])
+
+
+def _recv(sock) -> Tuple[Optional[dict], List[int]]:
+    """
+    Receive one message sent with _send().
+
+    Returns:
+        (message, file descriptors); message is None if the peer closed the
+        connection before sending anything
+
+    Raises:
+        ConnectionError: If the connection closes mid-message
+    """
+    import json
+    import socket
+    import struct
+
+    data, fds, _flags, _addr = socket.recv_fds(sock, 65536, len(_STDIO))
+    if not data:
+        return None, fds
+    while (
+        len(data) < _HEADER_SIZE
+        or len(data) < _HEADER_SIZE + struct.unpack_from(_HEADER, data)[0]
+    ):
+        chunk = sock.recv(65536)
+        if not chunk:
+            for fd in fds:
+                os.close(fd)
+            raise ConnectionError("Connection closed mid-message")
+        data += chunk
+    (length,) = struct.unpack_from(_HEADER, data)
+    return json.loads(data[_HEADER_SIZE : _HEADER_SIZE + length]), fds
+
+
+def _peer_uid(sock) -> Optional[int]:
+    """User id of the process at the other end, or None if not reported."""
+    import socket
+    import struct
+
+    option = getattr(socket, "SO_PEERCRED", None)
+    if option is None:
+        return None
+    size = struct.calcsize("3i")
+    _pid, uid, _gid = struct.unpack(
+        "3i", sock.getsockopt(socket.SOL_SOCKET, option, size)
+    )
+    return uid
+
+
+def _check_socket_file(path: Path) -> None:
+    """
+    Check the socket belongs to this user and nobody else can connect to it.
+
+    Raises:
+        PermissionError: If it is not a socket, has another owner or is
+            accessible to the group or others
+    """
+    import stat
+
+    info = path.lstat()
+    if not stat.S_ISSOCK(info.st_mode):
+        raise PermissionError(f"{path} is not a socket")
+    if info.st_uid != os.getuid():
+        raise PermissionError(f"{path} belongs to uid {info.st_uid}")
+    if info.st_mode & 0o077:
+        raise PermissionError(f"{path} is accessible to other users")
+
+
+def _connect(path: Path, timeout: Optional[float] = None):
+    """
+    Connect to the daemon socket.
+
+    Raises:
+        PermissionError: If the socket or the process listening on it belongs
+            to another user
+        OSError: If no daemon is listening
+    """
+    import socket
+
+    _check_socket_file(path)
+    sock = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+    try:
+        sock.settimeout(timeout)
+        sock.connect(str(path))
+        uid = _peer_uid(sock)
+        if uid is not None and uid != os.getuid():
+            raise PermissionError(f"Daemon on {path} runs as uid {uid}")
+    except OSError:
+        sock.close()
+        raise
+    return sock
+
+
+def request(message: dict, path: Optional[Path] = None, timeout: float = 5.0) -> dict:
+    """
+    Send a control request ('status' or 'stop') to a running daemon.
+
+    Args:
+        message: Request, e.g. {"op": "status"}
+        path: Socket path (default: socket_path())
+        timeout: Seconds to wait for the reply
+
+    Returns:
+        The daemon's reply
+
+    Raises:
+        OSError: If no daemon is listening or it did not reply
+    """
+    with _connect(path or socket_path(), timeout) as sock:
+        _send(sock, message)
+        reply, _ = _recv(sock)
+    if reply is None:
+        raise ConnectionError("Daemon closed the connection")
+    return reply
+
+
+def _disabled() -> bool:
+    value = os.environ.get(DAEMON_ENV, "").strip().lower()
+    return value in ("0", "false", "no", "off")
+
+
+def run_client(argv: List[str]) -> Optional[int]:
+    """
+    Run a tkgen command in the daemon if one is running.
+
+    Args:
+        argv: Command-line arguments (without the program name)
+
+    Returns:
+        The command's exit code, or None if it must run in-process (no
+        daemon, daemon disabled or serving another installation, or the
+        daemon command itself)
+    """
+    if _disabled() or "daemon" in argv:
+        return None
+    path = socket_path()
+    if not path.exists() or not supported():
+        return None
+
+    try:
+        sock = _connect(path, timeout=5.0)
+    except PermissionError as e:
+        logger.warning(f"Not using tkgen daemon: {e}")
+        return None
+    except OSError:
+        return None  # Stale socket: the daemon is gone
+
+    with sock:
+        try:
+            for stream in (sys.stdout, sys.stderr):
+                stream.flush()
+            _send(
+                sock,
+                {
+                    "op": "run",
+                    "argv": list(argv),
+                    "cwd": os.getcwd(),
+                    "env": dict(os.environ),
+                    "encoding": sys.stdout.encoding or "utf-8",
+                    **_identity(),
+                },
+                _STDIO,
+            )
+            reply, _ = _recv(sock)
+        except OSError:
+            return None
+        if not reply or "pid" not in reply:
+            if reply and reply.get("error"):
+                logger.debug(f"Daemon declined request: {reply['error']}")
+            return None
+
+        # The command is running: from here on never fall back, it would run twice
+        sock.settimeout(None)
+        while True:
+            try:
+                reply, _ = _recv(sock)
+            except KeyboardInterrupt:
+                try:
+                    _send(sock, {"op": "interrupt"})
+                except OSError:
+                    return 130
+                continue
+            except OSError:
+                reply = None
+            if reply is None:
+                print("ERROR: Lost connection to tkgen daemon", file=sys.stderr)
+                return 1
+            if "exit" in reply:
+                return int(reply["exit"])
+
+
+class _Watcher:
+    """Detects changes to a set of files and directories by their stat data."""
+
+    def __init__(self, paths: Iterable[Path]):
+        from toolchainkit.core.filecache import file_signature
+
+        self._signature = file_signature
+        self.paths = sorted({Path(p) for p in paths})
+        self._snapshot = self._take()
+
+    def _take(self) -> List:
+        return [self._signature(p) for p in self.paths]
+
+    def changed(self) -> bool:
+        """Whether any path was created, deleted or modified since creation."""
+        return self._take() != self._snapshot
+
+
+def _tree(root: Path) -> List[Path]:
+    """A directory, its subdirectories and their files (if it exists)."""
+    if not root.is_dir():
+        return [root]
+    return [root, *root.rglob("*")]
+
+
+def _state_paths() -> List[Path]:
+    """Files the warm state is derived from."""
+    from toolchainkit.core.directory import get_global_cache_dir
+
+    package = Path(__file__).resolve().parents[1]
+    cache_dir = get_global_cache_dir()
+    return [
+        package / "data" / "toolchains.json",
+        *_tree(package / "data" / "layers"),
+        *_tree(package / "data" / "compilers"),
+        *_tree(cache_dir / "layers"),
+        cache_dir / "plugins",
+        cache_dir / "plugins.yaml",
+    ]
+
+
+def _code_paths() -> List[Path]:
+    """toolchainkit's own sources; the daemon exits when they change."""
+    package = Path(__file__).resolve().parents[1]
+    return [p for p in _tree(package) if p.is_dir() or p.suffix == ".py"]
+
+
+class TkgenDaemon:
+    """
+    Serves tkgen commands from a process with warm state.
+
+    Args:
+        path: Socket path (default: socket_path())
+        idle_timeout: Exit after this many seconds without requests
+    """
+
+    def __init__(
+        self,
+        path: Optional[Path] = None,
+        idle_timeout: float = DEFAULT_IDLE_TIMEOUT,
+    ):
+        self.path = Path(path) if path else socket_path()
+        self.idle_timeout = idle_timeout
+        self.started = time.time()
+        self.requests = 0
+        self.generation = 0
+        self.warm_seconds = 0.0
+        self._state: Optional[_Watcher] = None
+        self._code: Optional[_Watcher] = None
+        self._sock = None
+        self._cli = None
+        self._children: set = set()
+        self._stopping = False
+
+    def warm(self) -> None:
+        """Import command modules and build the cached state."""
+        from toolchainkit.cli.parser import CLI
+        from toolchainkit.config.composer import LayerComposer
+        from toolchainkit.core.filecache import clear_file_cache
+        from toolchainkit.core.initialization import initialize_core
+        from toolchainkit.core.platform import clear_platform_cache, detect_platform
+        from toolchainkit.plugins.registry import (
+            get_global_registry,
+            reset_global_registry,
+        )
+        from toolchainkit.toolchain.metadata_registry import ToolchainMetadataRegistry
+
+        start = time.perf_counter()
+        clear_file_cache()
+        clear_platform_cache()
+        reset_global_registry()
+
+        for module in _WARM_MODULES:
+            try:
+                importlib.import_module(module)
+            except ImportError as e:
+                logger.debug(f"Not preloading {module}: {e}")
+
+        initialize_core()
+        registry = get_global_registry()
+        for name in registry.list_compiler_strategies():
+            registry.get_compiler_strategy(name)
+        for name in registry.list_package_managers():
+            registry.get_package_manager(name)
+
+        detect_platform()
+        ToolchainMetadataRegistry()
+        layers = LayerComposer().preload()
+        self._cli = CLI()
+
+        self._state = _Watcher(_state_paths())
+        if self._code is None:
+            self._code = _Watcher(_code_paths())
+        self.generation += 1
+        self.warm_seconds = time.perf_counter() - start
+        logger.info(
+            f"Warm state #{self.generation} built in {self.warm_seconds * 1000:.0f} ms "
+            f"({layers} layers, {len(self._state.paths)} watched paths)"
+        )
+
+    def serve_forever(self) -> None:
+        """Accept requests until stopped, idle or toolchainkit changes."""
+        import signal
+        import socket
+
+        if self._state is None:
+            self.warm()
+        self._bind()
+        signal.signal(signal.SIGTERM, lambda *_: self.stop())
+        last_request = time.monotonic()
+        try:
+            while not self._stopping:
+                self._reap()
+                try:
+                    conn, _ = self._sock.accept()
+                except socket.timeout:
+                    if time.monotonic() - last_request > self.idle_timeout:
+                        logger.info("Idle timeout, exiting")
+                        break
+                    continue
+                except OSError:
+                    if self._stopping:
+                        break
+                    raise
+                last_request = time.monotonic()
+                with conn:
+                    self._handle(conn)
+        finally:
+            self._close()
+
+    def stop(self) -> None:
+        """Stop serving after the current request."""
+        self._stopping = True
+
+    def status(self) -> dict:
+        """Status reported by ``tkgen daemon status``."""
+        return {
+            "pid": os.getpid(),
+            "socket": str(self.path),
+            "uptime": time.time() - self.started,
+            "requests": self.requests,
+            "running": len(self._children),
+            "generation": self.generation,
+            "warm_seconds": self.warm_seconds,
+            "watched": len(self._state.paths) if self._state else 0,
+            **_identity(),
+        }
+
+    def _bind(self) -> None:
+        import socket
+
+        self.path.parent.mkdir(parents=True, exist_ok=True)
+        if self.path.exists():
+            try:
+                _connect(self.path, timeout=1.0).close()
+            except OSError:
+                # Left behind by a daemon that died, or not ours to use
+                self.path.unlink()
+            else:
+                raise OSError(f"A daemon is already listening on {self.path}")
+        sock = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+        old_umask = os.umask(0o077)  # Only this user may connect
+        try:
+            sock.bind(str(self.path))
+        finally:
+            os.umask(old_umask)
+        sock.listen(64)
+        sock.settimeout(1.0)
+        self._sock = sock
+        logger.info(f"Listening on {self.path} (pid {os.getpid()})")
+
+    def _close(self) -> None:
+        if self._sock is not None:
+            self._sock.close()
+            self._sock = None
+            try:
+                self.path.unlink()
+            except OSError:
+                pass
+
+    def _reap(self) -> None:
+        for pid in list(self._children):
+            try:
+                done, _ = os.waitpid(pid, os.WNOHANG)
+            except ChildProcessError:
+                done = pid
+            if done:
+                self._children.discard(pid)
+
+    def _handle(self, conn) -> None:
+        conn.settimeout(5.0)
+        fds: List[int] = []
+        try:
+            uid = _peer_uid(conn)
+            if uid is not None and uid != os.getuid():
+                logger.warning(f"Rejected connection from uid {uid}")
+                return
+            message, fds = _recv(conn)
+            if message is None:
+                return
+            op = message.get("op")
+            if op == "status":
+                _send(conn, self.status())
+            elif op == "stop":
+                _send(conn, {"stopping": True})
+                self.stop()
+            elif op == "run":
+                self._run(conn, message, fds)
+            else:
+                _send(conn, {"error": f"unknown request: {op}"})
+        except (OSError, ValueError) as e:
+            logger.warning(f"Bad request: {e}")
+        finally:
+            for fd in fds:
+                os.close(fd)
+
+    def _run(self, conn, message: dict, fds: List[int]) -> None:
+        if len(fds) != len(_STDIO):
+            _send(conn, {"error": "expected stdin, stdout and stderr"})
+            return
+        if {k: message.get(k) for k in _identity()} != _identity():
+            _send(conn, {"error": "daemon serves another installation"})
+            return
+        env = message.get("env") or {}
+        changed = [name for name in _STATE_ENV if env.get(name) != os.environ.get(name)]
+        if changed:
+            _send(conn, {"error": f"daemon runs with another {', '.join(changed)}"})
+            return
+        if self._code is not None and self._code.changed():
+            _send(conn, {"error": "toolchainkit changed, daemon restarting"})
+            self.stop()
+            return
+        if self._state is not None and self._state.changed():
+            logger.info("Watched files changed, rebuilding warm state")
+            self.warm()
+
+        # The child reports its pid, then the exit code
+        pid = os.fork()
+        if pid == 0:
+            self._sock.close()
+            os._exit(_run_child(conn, message, fds, self._cli))
+
+        self.requests += 1
+        self._children.add(pid)
+
+
+def _run_child(conn, message: dict, fds: List[int], cli) -> int:
+    """Run one command in a forked child with the prebuilt CLI."""
+    import signal
+
+    signal.signal(signal.SIGTERM, signal.SIG_DFL)
+    signal.signal(signal.SIGINT, signal.default_int_handler)
+    code = 1
+    try:
+        _send(conn, {"pid": os.getpid()})
+        for fd, target in zip(fds, _STDIO):
+            os.dup2(fd, target)
+            os.close(fd)
+        os.chdir(message["cwd"])
+        os.environ.clear()
+        os.environ.update(message["env"])
+        encoding = message.get("encoding") or "utf-8"
+        sys.stdin = open(0, "r", encoding=encoding, closefd=False)
+        # Line-buffered like a fresh interpreter's, so output interleaves
+        # correctly with that of subprocesses writing to the same descriptors
+        sys.stdout = open(
+            1,
+            "w",
+            buffering=1 if os.isatty(1) else -1,
+            encoding=encoding,
+            closefd=False,
+        )
+        sys.stderr = open(2, "w", buffering=1, encoding=encoding, closefd=False)
+        sys.argv = ["tkgen", *message["argv"]]
+
+        done = threading.Event()
+        conn.settimeout(None)
+        threading.Thread(
+            target=_forward_interrupts, args=(conn, done), daemon=True
+        ).start()
+
+        # --project-root defaults to the directory the parser was built in
+        cli.parser.set_defaults(project_root=Path.cwd())
+        try:
+            code = cli.run(message["argv"])
+        except SystemExit as e:
+            code = e.code if isinstance(e.code, int) else (0 if e.code is None else 1)
+            if not isinstance(e.code, (int, type(None))):
+                print(e.code, file=sys.stderr)
+        except KeyboardInterrupt:
+            code = 130
+        done.set()
+    except BaseException as e:  # The client must always get an exit code
+        try:
+            print(f"ERROR: tkgen daemon: {e}", file=sys.stderr)
+        except Exception:
+            pass
+    finally:
+        for stream in (sys.stdout, sys.stderr):
+            try:
+                stream.flush()
+            except Exception:
+                pass
+        try:
+            _send(conn, {"exit": code})
+        except OSError:
+            pass
+    return code
+
+
+def _forward_interrupts(conn, done: threading.Event) -> None:
+    """Turn client interrupts (or a vanished client) into SIGINT."""
+    import signal
+
+    while not done.is_set():
+        try:
+            message, _ = _recv(conn)
+        except (OSError, ValueError):
+            message = None
+        if done.is_set():
+            return
+        os.kill(os.getpid(), signal.SIGINT)
+        if message is None:
+            return
@@ -6,25 +6,43 @@ This module implements the command-line interface for ToolchainKit using argpars
 
 import argparse
 import logging
+import os
 import sys
 from pathlib import Path
 from typing import List, Optional
 
-# Get version from package
-try:
-    from importlib.metadata import version
+logger = logging.getLogger(__name__)
 
-    __version__ = version("toolchainkit")
-except Exception:
-    __version__ = "0.1.0"
+# Set to 1 (or a trace file path) to trace every command, like --trace
+TRACE_ENV = "TOOLCHAINKIT_TRACE"
 
-# Ensure package managers and plugins are registered
-try:
-    import toolchainkit.packages  # noqa: F401 - Import registers plugins in registry
-except ImportError:
-    pass
 
-logger = logging.getLogger(__name__)
+def _package_version() -> str:
+    """Installed version of toolchainkit (reading metadata costs ~10 ms)."""
+    try:
+        from importlib.metadata import version
+
+        return version("toolchainkit")
+    except Exception:
+        return "0.1.0"
+
+
+def __getattr__(name: str):
+    # __version__ is computed on first access, not at import
+    if name == "__version__":
+        return _package_version()
+    raise AttributeError(f"module {__name__!r} has no attribute {name!r}")
+
+
+class _VersionAction(argparse.Action):
+    """--version that looks up the version only when it is requested."""
+
+    def __init__(self, option_strings, dest=argparse.SUPPRESS, **kwargs):
+        super().__init__(option_strings, dest, nargs=0, **kwargs)
+
+    def __call__(self, parser, namespace, values, option_string=None):
+        parser._print_message(f"ToolchainKit {_package_version()}\n", sys.stdout)
+        parser.exit()
 
 
 class CLI:
@@ -50,7 +68,9 @@ class CLI:
 
         # Global options
         parser.add_argument(
-            "--version", action="version", version=f"ToolchainKit {__version__}"
+            "--version",
+            action=_VersionAction,
+            help="show program's version number and exit",
         )
         parser.add_argument(
             "--verbose", "-v", action="store_true", help="Enable verbose output"
@@ -74,6 +94,18 @@ class CLI:
             default=Path.cwd(),
             help="Project root directory (default: current directory)",
         )
+        parser.add_argument(
+            "--trace",
+            action="store_true",
+            help="Print a phase timing summary and write a Chrome trace",
+        )
+        parser.add_argument(
+            "--trace-file",
+            type=Path,
+            metavar="PATH",
+            help="Chrome trace output file; implies --trace "
+            "(default: .toolchainkit/trace-COMMAND.json)",
+        )
 
         # Subcommands
         subparsers = parser.add_subparsers(
@@ -89,6 +121,14 @@ class CLI:
         self._add_doctor_command(subparsers)
         self._add_plugin_command(subparsers)
         self._add_vscode_command(subparsers)
+        self._add_cache_command(subparsers)
+        self._add_fetch_command(subparsers)
+        self._add_bundle_command(subparsers)
+        self._add_mirror_command(subparsers)
+        self._add_daemon_command(subparsers)
+        self._add_remarks_command(subparsers)
+        self._add_startup_command(subparsers)
+        self._add_alloc_trace_command(subparsers)
 
         return parser
 
@@ -277,6 +317,17 @@ class CLI:
         parser.add_argument(
             "--toolchain", metavar="NAME", help="Remove specific toolchain"
         )
+        parser.add_argument(
+            "--stats",
+            action="store_true",
+            help="Show cache size and quota usage from the registry",
+        )
+        parser.add_argument(
+            "--quota",
+            metavar="SIZE",
+            help="Evict least recently used entries until the cache fits SIZE "
+            "(e.g., 50G; default: configured quota)",
+        )
 
     def _add_upgrade_command(self, subparsers):
         """Add 'upgrade' subcommand."""
@@ -398,6 +449,463 @@ class CLI:
             help="Build type for launch config (default: Debug)",
         )
 
+    def _add_cache_command(self, subparsers):
+        """Add 'cache' subcommand with sub-subcommands."""
+        parser = subparsers.add_parser(
+            "cache",
+            help="Manage the compiler cache",
+            description="Run and inspect the embedded compiler cache server",
+        )
+
+        cache_subparsers = parser.add_subparsers(
+            dest="cache_command", help="Cache commands", metavar="COMMAND"
+        )
+
+        # cache serve
+        serve_parser = cache_subparsers.add_parser(
+            "serve",
+            help="Run a local compiler cache server",
+            description="Serve an HTTP/WebDAV compiler cache for sccache and ccache",
+        )
+        serve_parser.add_argument(
+            "--host",
+            default="127.0.0.1",
+            metavar="ADDR",
+            help="Bind address (use 0.0.0.0 to serve the LAN) [default: 127.0.0.1]",
+        )
+        serve_parser.add_argument(
+            "--port",
+            type=int,
+            default=8420,
+            metavar="PORT",
+            help="TCP port [default: 8420]",
+        )
+        serve_parser.add_argument(
+            "--dir",
+            type=Path,
+            metavar="PATH",
+            help="Cache store directory (default: ~/.toolchainkit/cache-server)",
+        )
+        serve_parser.add_argument(
+            "--max-size",
+            default="10G",
+            metavar="SIZE",
+            help="Maximum store size, e.g. 512M or 50G [default: 10G]",
+        )
+        serve_parser.add_argument(
+            "--compression",
+            choices=["zlib", "zstd", "none"],
+            default="zlib",
+            metavar="CODEC",
+            help="Per-object compression (zlib|zstd|none) [default: zlib]",
+        )
+        serve_parser.add_argument(
+            "--token",
+            metavar="TOKEN",
+            help="Require this bearer token on every request",
+        )
+        serve_parser.add_argument(
+            "--upstream",
+            metavar="URL",
+            help="Remote HTTP cache to tier behind the local store (write-behind)",
+        )
+        serve_parser.add_argument(
+            "--upstream-token",
+            metavar="TOKEN",
+            help="Bearer token for the upstream cache",
+        )
+        serve_parser.add_argument(
+            "--branch",
+            metavar="NAME",
+            help="Branch whose key manifest is prefetched (default: current git branch)",
+        )
+        serve_parser.add_argument(
+            "--no-prefetch",
+            action="store_true",
+            help="Do not prefetch the branch manifest from the upstream cache",
+        )
+
+        # cache bench
+        bench_parser = cache_subparsers.add_parser(
+            "bench",
+            help="Benchmark remote cache backends",
+            description=(
+                "Measure p50/p99 latency and MB/s of remote cache backends "
+                "and recommend the fastest"
+            ),
+        )
+        bench_parser.add_argument(
+            "urls",
+            nargs="*",
+            metavar="URL",
+            help=(
+                "Backend URLs (http://, redis://, memcached://, s3://); "
+                "default: build.caching.remote from the config file"
+            ),
+        )
+        bench_parser.add_argument(
+            "--objects",
+            type=int,
+            default=200,
+            metavar="N",
+            help="Objects put and fetched per backend [default: 200]",
+        )
+        bench_parser.add_argument(
+            "--concurrency",
+            "-j",
+            type=int,
+            default=8,
+            metavar="N",
+            help="Parallel connections [default: 8]",
+        )
+        bench_parser.add_argument(
+            "--criterion",
+            choices=["throughput", "latency"],
+            default="throughput",
+            help="Rank by MB/s or by p99 latency [default: throughput]",
+        )
+        bench_parser.add_argument(
+            "--json", action="store_true", help="Print results as JSON"
+        )
+
+        # cache stats
+        cache_subparsers.add_parser(
+            "stats",
+            help="Show local cache server statistics",
+            description="Show hit/miss and tier counters of the running cache server",
+        )
+
+    def _add_fetch_command(self, subparsers):
+        """Add 'fetch' subcommand."""
+        parser = subparsers.add_parser(
+            "fetch",
+            help="Prefetch locked toolchains and tools",
+            description=(
+                "Download every toolchain, build tool and sysroot pinned in "
+                "toolchainkit.lock into the global cache"
+            ),
+        )
+        parser.add_argument(
+            "--from-lock",
+            action="store_true",
+            required=True,
+            help="Fetch the components pinned in toolchainkit.lock",
+        )
+        parser.add_argument(
+            "--jobs",
+            "-j",
+            type=int,
+            default=4,
+            metavar="N",
+            help="Concurrent downloads [default: 4]",
+        )
+        parser.add_argument(
+            "--force", action="store_true", help="Re-download cached components"
+        )
+
+    def _add_bundle_command(self, subparsers):
+        """Add 'bundle' subcommand with sub-subcommands."""
+        parser = subparsers.add_parser(
+            "bundle",
+            help="Export or import offline bundles",
+            description=(
+                "Pack the components pinned in toolchainkit.lock into one "
+                "offline bundle, or unpack a bundle into the global cache"
+            ),
+        )
+
+        bundle_subparsers = parser.add_subparsers(
+            dest="bundle_command", help="Bundle commands", metavar="COMMAND"
+        )
+
+        # bundle pin
+        bundle_subparsers.add_parser(
+            "pin",
+            help="Record installed tree digests in the lock file",
+            description=(
+                "Verify the installed components of toolchainkit.lock and record "
+                "their tree digests, which bundle import checks"
+            ),
+        )
+
+        # bundle export
+        export_parser = bundle_subparsers.add_parser(
+            "export",
+            help="Write locked components to a bundle",
+            description="Write the installed components of toolchainkit.lock to a bundle",
+        )
+        export_parser.add_argument("output", type=Path, help="Bundle file to write")
+        export_parser.add_argument(
+            "--codec",
+            choices=["zstd", "zlib"],
+            help="Frame compression [default: zstd if installed, else zlib]",
+        )
+        export_parser.add_argument(
+            "--jobs",
+            "-j",
+            type=int,
+            metavar="N",
+            help="Compression threads [default: CPU count]",
+        )
+
+        # bundle import
+        import_parser = bundle_subparsers.add_parser(
+            "import",
+            help="Unpack a bundle into the cache",
+            description=(
+                "Unpack a bundle into the global cache, verified against "
+                "toolchainkit.lock"
+            ),
+        )
+        import_parser.add_argument("bundle", type=Path, help="Bundle file")
+        import_parser.add_argument(
+            "--jobs",
+            "-j",
+            type=int,
+            metavar="N",
+            help="Unpacking threads [default: CPU count]",
+        )
+        import_parser.add_argument(
+            "--force", action="store_true", help="Replace cached components"
+        )
+        import_parser.add_argument(
+            "--no-lock",
+            action="store_true",
+            help="Import every component without a lock file",
+        )
+
+        # bundle delta
+        delta_parser = bundle_subparsers.add_parser(
+            "delta",
+            help="Write a delta patch between two cached toolchains",
+            description=(
+                "Write a patch that upgrades an installed toolchain to another "
+                "version (publish it under 'deltas' in the toolchain metadata)"
+            ),
+        )
+        delta_parser.add_argument("base", help="Installed base toolchain ID")
+        delta_parser.add_argument("target", help="Installed target toolchain ID")
+        delta_parser.add_argument("output", type=Path, help="Patch file to write")
+        delta_parser.add_argument(
+            "--codec",
+            choices=["zstd", "zlib"],
+            help="Compression of stored files [default: zstd if installed, else zlib]",
+        )
+        delta_parser.add_argument(
+            "--jobs",
+            "-j",
+            type=int,
+            metavar="N",
+            help="Hashing and diffing threads [default: CPU count]",
+        )
+        delta_parser.add_argument(
+            "--no-binary",
+            action="store_true",
+            help="Store changed files whole instead of diffing them",
+        )
+
+    def _add_mirror_command(self, subparsers):
+        """Add 'mirror' subcommand with sub-subcommands."""
+        parser = subparsers.add_parser(
+            "mirror",
+            help="Share downloaded archives with other machines",
+            description="Serve the global downloads directory as a download mirror",
+        )
+
+        mirror_subparsers = parser.add_subparsers(
+            dest="mirror_command", help="Mirror commands", metavar="COMMAND"
+        )
+
+        # mirror serve
+        serve_parser = mirror_subparsers.add_parser(
+            "serve",
+            help="Run a download mirror",
+            description=(
+                "Serve downloaded toolchain and tool archives over HTTP; list "
+                "the URL under download.mirrors or in TOOLCHAINKIT_MIRRORS"
+            ),
+        )
+        serve_parser.add_argument(
+            "--host",
+            default="127.0.0.1",
+            metavar="ADDR",
+            help="Bind address (use 0.0.0.0 to serve the LAN) [default: 127.0.0.1]",
+        )
+        serve_parser.add_argument(
+            "--port",
+            type=int,
+            default=8421,
+            metavar="PORT",
+            help="TCP port [default: 8421]",
+        )
+        serve_parser.add_argument(
+            "--dir",
+            type=Path,
+            metavar="PATH",
+            help="Directory to serve (default: ~/.toolchainkit/downloads)",
+        )
+
+    def _add_daemon_command(self, subparsers):
+        """Add 'daemon' subcommand with sub-subcommands."""
+        parser = subparsers.add_parser(
+            "daemon",
+            help="Serve tkgen commands from a warm background process",
+            description=(
+                "Run a per-user background process that keeps imports, platform "
+                "detection, toolchain metadata and layers loaded; tkgen uses it "
+                "automatically while it runs"
+            ),
+        )
+
+        daemon_subparsers = parser.add_subparsers(
+            dest="daemon_command", help="Daemon commands", metavar="COMMAND"
+        )
+
+        # daemon start
+        start_parser = daemon_subparsers.add_parser(
+            "start", help="Start the daemon", description="Start the tkgen daemon"
+        )
+        start_parser.add_argument(
+            "--foreground",
+            action="store_true",
+            help="Serve in this process instead of in the background",
+        )
+        start_parser.add_argument(
+            "--idle-timeout",
+            type=int,
+            default=180,
+            metavar="MINUTES",
+            help="Exit after this many minutes without requests [default: 180]",
+        )
+
+        # daemon stop / status
+        daemon_subparsers.add_parser(
+            "stop", help="Stop the daemon", description="Stop the tkgen daemon"
+        )
+        daemon_subparsers.add_parser(
+            "status",
+            help="Show daemon state",
+            description="Show the tkgen daemon's pid, requests and warm state",
+        )
+
+    def _add_remarks_command(self, subparsers):
+        """Add 'remarks' subcommand."""
+        parser = subparsers.add_parser(
+            "remarks",
+            help="Report missed vectorizations and inlining failures",
+            description=(
+                "Aggregate the optimization records of a build made with the "
+                "profiling/opt-remarks layer into a hotness-ranked report"
+            ),
+        )
+        parser.add_argument(
+            "build_dir",
+            nargs="?",
+            type=Path,
+            default=Path("build"),
+            help="Build directory to search for records [default: build]",
+        )
+        parser.add_argument(
+            "--profile",
+            type=Path,
+            metavar="PATH",
+            help="perf.data or 'perf report --stdio' output used to rank findings",
+        )
+        parser.add_argument(
+            "--category",
+            choices=["vectorization", "inlining", "all"],
+            default="all",
+            help="Kind of missed optimization to report [default: all]",
+        )
+        parser.add_argument(
+            "--limit",
+            type=int,
+            default=20,
+            metavar="N",
+            help="Show the N hottest findings, 0 for all [default: 20]",
+        )
+        parser.add_argument("--json", action="store_true", help="Print JSON")
+
+    def _add_startup_command(self, subparsers):
+        """Add 'startup' subcommand."""
+        parser = subparsers.add_parser(
+            "startup",
+            help="Measure program startup time",
+            description=(
+                "Time a program from exec to exit over many runs and report "
+                "dynamic loader statistics; with --baseline, compare two "
+                "builds with interleaved runs"
+            ),
+        )
+        parser.add_argument(
+            "--baseline",
+            metavar="COMMAND",
+            help="Baseline command line to compare against (quoted)",
+        )
+        parser.add_argument(
+            "--runs",
+            type=int,
+            default=50,
+            metavar="N",
+            help="Timed runs per command [default: 50]",
+        )
+        parser.add_argument(
+            "--warmup",
+            type=int,
+            default=3,
+            metavar="N",
+            help="Untimed runs per command first [default: 3]",
+        )
+        parser.add_argument("--json", action="store_true", help="Print JSON")
+        parser.add_argument(
+            "program",
+            nargs=argparse.REMAINDER,
+            help="Program and arguments to measure",
+        )
+
+    def _add_alloc_trace_command(self, subparsers):
+        """Add 'alloc-trace' subcommand."""
+        parser = subparsers.add_parser(
+            "alloc-trace",
+            help="Summarize, trim or compress an allocation trace",
+            description=(
+                "Summarize an allocation trace recorded by the allocator proxy "
+                "(TOOLCHAINKIT_ALLOCATOR_TRACE), optionally cut to a time window "
+                "and written to a new, compressed trace for replay"
+            ),
+        )
+        parser.add_argument(
+            "trace_path",
+            type=Path,
+            metavar="TRACE",
+            help="Trace file (plain, gzip or xz)",
+        )
+        parser.add_argument(
+            "--start",
+            type=float,
+            metavar="SECONDS",
+            help="Drop events before this time [default: trace start]",
+        )
+        parser.add_argument(
+            "--end",
+            type=float,
+            metavar="SECONDS",
+            help="Drop events from this time on [default: trace end]",
+        )
+        parser.add_argument(
+            "--drop-live",
+            action="store_true",
+            help="Do not allocate the blocks live at --start when the window begins",
+        )
+        parser.add_argument(
+            "-o",
+            "--output",
+            type=Path,
+            metavar="PATH",
+            help="Write the trace, compressed for a .gz or .xz path",
+        )
+        parser.add_argument("--json", action="store_true", help="Print JSON")
+
     def parse_args(self, args: Optional[List[str]] = None):
         """
         Parse command-line arguments.
@@ -430,8 +938,35 @@ class CLI:
             self.parser.print_help()
             return 1
 
+        trace_file = self._trace_file(parsed_args)
+        if trace_file is None:
+            return self._run_command(parsed_args)
+
+        from toolchainkit.core import tracing
+
+        tracer = tracing.enable()
+        try:
+            with tracing.span(f"tkgen {parsed_args.command}", "cli"):
+                return self._run_command(parsed_args)
+        finally:
+            tracing.disable()
+            self._write_trace(tracer, trace_file)
+
+    def _run_command(self, parsed_args) -> int:
+        """
+        Load plugins and run the parsed command.
+
+        Args:
+            parsed_args: Parsed arguments with command field
+
+        Returns:
+            Exit code (0 for success, non-zero for error)
+        """
+        from toolchainkit.core import tracing
+
         # Load plugins if config file is provided
-        self._load_plugins_from_config(parsed_args)
+        with tracing.span("load plugins", "plugins"):
+            self._load_plugins_from_config(parsed_args)
 
         # Dispatch to command handler
         try:
@@ -447,6 +982,43 @@ class CLI:
                 traceback.print_exc()
             return 1
 
+    def _trace_file(self, args) -> Optional[Path]:
+        """
+        Chrome trace output path if tracing is requested, else None.
+
+        Args:
+            args: Parsed arguments with trace/trace_file/project_root
+        """
+        if args.trace_file is not None:
+            return args.trace_file
+        env = os.environ.get(TRACE_ENV, "")
+        if env.lower() in ("", "0", "false", "no", "off"):
+            env = ""
+        if not (args.trace or env):
+            return None
+        if env and env.lower() not in ("1", "true", "yes", "on"):
+            return Path(env)
+        project_root = Path(args.project_root).resolve()
+        return project_root / ".toolchainkit" / f"trace-{args.command}.json"
+
+    def _write_trace(self, tracer, trace_file: Path) -> None:
+        """
+        Write the Chrome trace and print the phase summary to stderr.
+
+        Args:
+            tracer: Tracer with the recorded spans
+            trace_file: Chrome trace output path
+        """
+        try:
+            tracer.write_chrome_trace(trace_file)
+            written = f"written to {trace_file}"
+        except OSError as e:
+            logger.warning(f"Failed to write trace file {trace_file}: {e}")
+            written = "not written"
+        total = sum(e["dur"] for e in tracer.events if e["cat"] == "cli") / 1000
+        print(f"\nTrace: {total:.1f} ms, {written}", file=sys.stderr)
+        print(tracer.summary(), file=sys.stderr)
+
     def _load_plugins_from_config(self, args):
         """
         Load plugins from configuration file if available.
@@ -475,6 +1047,11 @@ class CLI:
                 logger.debug("No config file found, skipping plugin loading")
                 return
 
+            # Most configurations have no plugins; skip parsing YAML for them
+            if "plugins" not in config_file.read_text(errors="replace"):
+                logger.debug("No plugin paths configured")
+                return
+
             # Load configuration
             from toolchainkit.cli.utils import load_yaml_config
 
@@ -545,6 +1122,14 @@ class CLI:
         # Special handling for plugin command (has sub-commands)
         if args.command == "plugin":
             return self._dispatch_plugin_command(args)
+        if args.command == "cache":
+            return self._dispatch_cache_command(args)
+        if args.command == "bundle":
+            return self._dispatch_bundle_command(args)
+        if args.command == "mirror":
+            return self._dispatch_mirror_command(args)
+        if args.command == "daemon":
+            return self._dispatch_daemon_command(args)
 
         # Command module mapping
         command_map = {
@@ -556,6 +1141,10 @@ class CLI:
             "verify": "toolchainkit.cli.commands.verify",
             "doctor": "toolchainkit.cli.commands.doctor",
             "vscode": "toolchainkit.cli.commands.vscode",
+            "fetch": "toolchainkit.cli.commands.fetch",
+            "remarks": "toolchainkit.cli.commands.remarks",
+            "startup": "toolchainkit.cli.commands.startup",
+            "alloc-trace": "toolchainkit.cli.commands.alloc_trace",
         }
 
         module_name = command_map.get(args.command)
@@ -625,9 +1214,120 @@ class CLI:
                 traceback.print_exc()
             return 1
 
+    def _dispatch_cache_command(self, args) -> int:
+        """
+        Dispatch cache sub-commands.
+
+        Args:
+            args: Parsed arguments with cache_command field
+
+        Returns:
+            Exit code from command handler
+        """
+        if not getattr(args, "cache_command", None):
+            logger.error("No cache sub-command specified")
+            self.parser.parse_args(["cache", "--help"])
+            return 1
+
+        from toolchainkit.cli.commands import cache
+
+        cache_command_map = {
+            "serve": cache.run_serve,
+            "stats": cache.run_stats,
+            "bench": cache.run_bench,
+        }
+
+        handler = cache_command_map.get(args.cache_command)
+        if not handler:
+            logger.error(f"Unknown cache command: {args.cache_command}")
+            return 1
+
+        return handler(args)
+
+    def _dispatch_bundle_command(self, args) -> int:
+        """
+        Dispatch bundle sub-commands.
+
+        Args:
+            args: Parsed arguments with bundle_command field
+
+        Returns:
+            Exit code from command handler
+        """
+        if not getattr(args, "bundle_command", None):
+            logger.error("No bundle sub-command specified")
+            self.parser.parse_args(["bundle", "--help"])
+            return 1
+
+        from toolchainkit.cli.commands import bundle
+
+        bundle_command_map = {
+            "pin": bundle.run_pin,
+            "export": bundle.run_export,
+            "import": bundle.run_import,
+            "delta": bundle.run_delta,
+        }
+
+        return bundle_command_map[args.bundle_command](args)
+
+    def _dispatch_mirror_command(self, args) -> int:
+        """
+        Dispatch mirror sub-commands.
+
+        Args:
+            args: Parsed arguments with mirror_command field
+
+        Returns:
+            Exit code from command handler
+        """
+        if not getattr(args, "mirror_command", None):
+            logger.error("No mirror sub-command specified")
+            self.parser.parse_args(["mirror", "--help"])
+            return 1
+
+        from toolchainkit.cli.commands import mirror
+
+        mirror_command_map = {
+            "serve": mirror.run_serve,
+        }
+
+        return mirror_command_map[args.mirror_command](args)
+
+    def _dispatch_daemon_command(self, args) -> int:
+        """
+        Dispatch daemon sub-commands.
+
+        Args:
+            args: Parsed arguments with daemon_command field
+
+        Returns:
+            Exit code from command handler
+        """
+        if not getattr(args, "daemon_command", None):
+            logger.error("No daemon sub-command specified")
+            self.parser.parse_args(["daemon", "--help"])
+            return 1
+
+        from toolchainkit.cli.commands import daemon
+
+        daemon_command_map = {
+            "start": daemon.run_start,
+            "stop": daemon.run_stop,
+            "status": daemon.run_status,
+        }
+
+        return daemon_command_map[args.daemon_command](args)
+
 
 def main():
     """Main entry point for CLI."""
+    # Hand the command to a running tkgen daemon, if any
+    from toolchainkit.cli.daemon import run_client
+
+    code = run_client(sys.argv[1:])
+    if code is not None:
+        sys.exit(code)
+
     # Initialize core framework (register standard strategies, package managers)
     from toolchainkit.core.initialization import initialize_core
 
@@ -105,6 +105,52 @@ def load_yaml_config(config_file: Path, required: bool = False) -> Dict[str, Any
         raise ValueError(f"Invalid YAML in {config_file}: {e}")
 
 
+def apply_download_config(config: Dict[str, Any]) -> None:
+    """
+    Apply the ``download`` section of a project configuration.
+
+    ``download.mirrors`` lists mirror base URLs (e.g. machines running
+    ``tkgen mirror serve``) tried alongside the upstream URL of every download.
+    TOOLCHAINKIT_MIRRORS is used when the section is absent.
+
+    ``download.cache_quota`` bounds the global cache, either as a size
+    ('50G') or as a mapping with ``max_size``, ``high_watermark`` and
+    ``low_watermark``. TOOLCHAINKIT_CACHE_QUOTA is used when it is absent.
+
+    ``download.repack: true`` transcodes downloaded toolchain archives into
+    seekable bundles that re-extract in parallel (TOOLCHAINKIT_REPACK).
+
+    Args:
+        config: Loaded toolchainkit.yaml
+    """
+    from toolchainkit.core.download import set_mirrors
+
+    download = config.get("download") or {}
+    mirrors = download.get("mirrors")
+    if mirrors:
+        if isinstance(mirrors, str):
+            mirrors = [mirrors]
+        set_mirrors([str(m) for m in mirrors])
+        logger.debug(f"Download mirrors: {mirrors}")
+
+    quota = download.get("cache_quota")
+    if quota:
+        from toolchainkit.toolchain.cleanup import CacheQuota, set_cache_quota
+
+        try:
+            set_cache_quota(CacheQuota.parse(quota))
+        except ValueError as e:
+            logger.warning(f"Ignoring invalid download.cache_quota: {e}")
+        else:
+            logger.debug(f"Cache quota: {quota}")
+
+    repack = download.get("repack")
+    if repack is not None:
+        from toolchainkit.toolchain.repack import set_repack
+
+        set_repack(bool(repack))
+
+
 def validate_config(config: Dict[str, Any], required_keys: list) -> bool:
     """
     Validate that configuration contains required keys.
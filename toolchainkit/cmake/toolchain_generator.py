@@ -11,6 +11,7 @@ from dataclasses import dataclass
 from datetime import datetime
 import logging
 
+from ..core import tracing
 from ..core.platform import detect_platform
 from ..core.filesystem import atomic_write
 from ..config import LayerComposer, ComposedConfig
@@ -167,6 +168,7 @@ class CMakeToolchainGenerator:
         self.layer_composer = LayerComposer(project_root=project_root)
         self._strategy_resolver = strategy_resolver
 
+    @tracing.traced("generate toolchain file", "cmake")
     def generate(self, config: ToolchainFileConfig) -> Path:
         """Generate a CMake toolchain file.
 
@@ -292,6 +294,37 @@ class CMakeToolchainGenerator:
             lines.extend(self._generate_layer_cmake_variables(composed))
             lines.append("")
 
+        # Link flags for shared libraries or executables only (startup layer)
+        by_kind = {"TOOLCHAINKIT_SHARED_LINKER_FLAGS", "TOOLCHAINKIT_EXE_LINKER_FLAGS"}
+        if by_kind & composed.cmake_variables.keys():
+            lines.extend(self._generate_layer_link_flags_by_kind(composed))
+            lines.append("")
+
+        # Split DWARF packaging helper (debuginfo layers)
+        if "TOOLCHAINKIT_DWP" in composed.cmake_variables:
+            lines.extend(self._generate_layer_dwp_packaging(composed))
+            lines.append("")
+
+        # Optimization remarks (profiling/opt-remarks layer)
+        if "TOOLCHAINKIT_OPT_REMARKS_FLAGS" in composed.cmake_variables:
+            lines.extend(self._generate_layer_opt_remarks())
+            lines.append("")
+
+        # Function instrumentation runtime (profiling/instrument-functions layer)
+        if "TOOLCHAINKIT_INSTRUMENT_RUNTIME" in composed.cmake_variables:
+            lines.extend(self._generate_layer_instrument_runtime())
+            lines.append("")
+
+        # Allocator proxy (allocator layers with method: proxy)
+        if "TOOLCHAINKIT_ALLOCATOR_PROXY_RUNTIME" in composed.cmake_variables:
+            lines.extend(self._generate_layer_allocator_proxy())
+            lines.append("")
+
+        # Allocation trace replay driver (allocator layers)
+        if "TOOLCHAINKIT_ALLOCATOR_REPLAY_SOURCE" in composed.cmake_variables:
+            lines.extend(self._generate_layer_allocator_replay())
+            lines.append("")
+
         # Runtime environment (for wrapper scripts)
         if composed.runtime_env:
             lines.extend(self._generate_layer_runtime_env(composed))
@@ -475,6 +508,7 @@ class CMakeToolchainGenerator:
             "CMAKE_SYSTEM_PROCESSOR",
             "CMAKE_SYSROOT",
             "toolchain_root",  # Internal variable
+            "TOOLCHAINKIT_DWP",  # Looked up by the packaging helper
         }
 
         for key, value in composed.cmake_variables.items():
@@ -491,6 +525,246 @@ class CMakeToolchainGenerator:
 
         return lines
 
+    def _generate_layer_link_flags_by_kind(self, composed: ComposedConfig) -> List[str]:
+        """Append layer link flags that apply to one kind of target.
+
+        Args:
+            composed: Composed configuration
+
+        Returns:
+            List of CMake lines
+        """
+        lines = ["# Link flags for shared libraries / executables only"]
+        if "TOOLCHAINKIT_SHARED_LINKER_FLAGS" in composed.cmake_variables:
+            for kind in ("SHARED", "MODULE"):
+                lines.append(
+                    f"string(APPEND CMAKE_{kind}_LINKER_FLAGS_INIT"
+                    ' " ${TOOLCHAINKIT_SHARED_LINKER_FLAGS}")'
+                )
+        if "TOOLCHAINKIT_EXE_LINKER_FLAGS" in composed.cmake_variables:
+            lines.append(
+                'string(APPEND CMAKE_EXE_LINKER_FLAGS_INIT " ${TOOLCHAINKIT_EXE_LINKER_FLAGS}")'
+            )
+        return lines
+
+    def _generate_layer_dwp_packaging(self, composed: ComposedConfig) -> List[str]:
+        """Generate the toolchainkit_package_dwp() helper for split DWARF.
+
+        The helper packages a target's .dwo files into ``<target file>.dwp``
+        after each build and optionally installs it. The packaging tool is
+        looked up with find_program(): system clang ships llvm-dwp as
+        ``llvm-dwp-<major>`` or under ``/usr/lib/llvm-<major>/bin`` rather
+        than next to the compiler. Without one, packaging is skipped with a
+        warning instead of failing the build.
+
+        Args:
+            composed: Composed configuration
+
+        Returns:
+            List of CMake lines
+        """
+        tool = str(composed.cmake_variables["TOOLCHAINKIT_DWP"]).replace("\\", "/")
+        directory, _, name = tool.rpartition("/")
+        major = (composed.compiler_version or "").split(".")[0]
+        names = [name]
+        hints = [directory] if directory and "{{" not in directory else []
+        if name == "llvm-dwp" and major.isdigit():
+            names.append(f"llvm-dwp-{major}")
+            hints.append(f"/usr/lib/llvm-{major}/bin")
+        if "dwp" not in names:
+            names.append("dwp")
+        find = f"find_program(TOOLCHAINKIT_DWP NAMES {' '.join(names)}"
+        if hints:
+            find += " HINTS " + " ".join(f'"{hint}"' for hint in hints)
+        return [
+            "# Split DWARF packaging: toolchainkit_package_dwp(<target> [DESTINATION <dir>])",
+            f"{find})",
+            "function(toolchainkit_package_dwp target)",
+            "    if(NOT TOOLCHAINKIT_DWP)",
+            '        message(WARNING "No dwp tool found, not packaging split DWARF for ${target}")',
+            "        return()",
+            "    endif()",
+            '    cmake_parse_arguments(PARSE_ARGV 1 TK_DWP "" "DESTINATION" "")',
+            "    add_custom_command(TARGET ${target} POST_BUILD",
+            '        COMMAND "${TOOLCHAINKIT_DWP}" -e "$<TARGET_FILE:${target}>"',
+            '                -o "$<TARGET_FILE:${target}>.dwp"',
+            '        COMMENT "Packaging split DWARF for ${target}"',
+            "        VERBATIM)",
+            "    if(TK_DWP_DESTINATION)",
+            '        install(FILES "$<TARGET_FILE:${target}>.dwp"',
+            '                DESTINATION "${TK_DWP_DESTINATION}")',
+            "    endif()",
+            "endfunction()",
+        ]
+
+    def _generate_layer_opt_remarks(self) -> List[str]:
+        """Generate per-target optimization remark flags.
+
+        ``toolchainkit_opt_remarks(<target>...)`` adds the remark flags to
+        the C and C++ sources of the given targets. When the
+        TOOLCHAINKIT_OPT_REMARKS_TARGETS cache variable lists targets, the
+        call is deferred to the end of the top-level directory so the
+        targets exist; otherwise every target gets the flags.
+
+        Returns:
+            List of CMake lines
+        """
+        genex = '"$<$<COMPILE_LANGUAGE:C,CXX>:${TOOLCHAINKIT_OPT_REMARKS_FLAGS}>"'
+        return [
+            "# Optimization remarks: toolchainkit_opt_remarks(<target>...)",
+            'set(TOOLCHAINKIT_OPT_REMARKS_TARGETS "" CACHE STRING',
+            '    "Targets that record optimization remarks (empty: all targets)")',
+            "function(toolchainkit_opt_remarks)",
+            "    foreach(target IN LISTS ARGN)",
+            f"        target_compile_options(${{target}} PRIVATE {genex})",
+            "    endforeach()",
+            "endfunction()",
+            'if(NOT CMAKE_PROJECT_NAME STREQUAL "CMAKE_TRY_COMPILE")',
+            "    if(TOOLCHAINKIT_OPT_REMARKS_TARGETS)",
+            '        cmake_language(DEFER DIRECTORY "${CMAKE_SOURCE_DIR}"',
+            "            CALL toolchainkit_opt_remarks ${TOOLCHAINKIT_OPT_REMARKS_TARGETS})",
+            "    else()",
+            f"        add_compile_options({genex})",
+            "    endif()",
+            "endif()",
+        ]
+
+    def _generate_layer_instrument_runtime(self) -> List[str]:
+        """Generate the function instrumentation runtime target.
+
+        Every target links ``toolchainkit_instrument``, a shared library
+        built from TOOLCHAINKIT_INSTRUMENT_RUNTIME at the end of the
+        top-level directory, so all instrumented objects of a process share
+        one recorder. The runtime itself is built without instrumentation
+        and links nothing else from the project.
+
+        Returns:
+            List of CMake lines
+        """
+        no_instrument = "$<$<CXX_COMPILER_ID:GNU>:-fno-instrument-functions>"
+        return [
+            "# Function instrumentation runtime: toolchainkit_instrument",
+            "function(toolchainkit_instrument_runtime)",
+            "    if(TARGET toolchainkit_instrument)",
+            "        return()  # Deferred once per inclusion of this file",
+            "    endif()",
+            "    get_property(languages GLOBAL PROPERTY ENABLED_LANGUAGES)",
+            '    if(NOT "CXX" IN_LIST languages)',
+            '        message(WARNING "ToolchainKit: the instrumentation runtime '
+            'needs the CXX language")',
+            "        add_library(toolchainkit_instrument INTERFACE)",
+            "        return()",
+            "    endif()",
+            "    find_package(Threads REQUIRED)",
+            '    get_filename_component(dir "${TOOLCHAINKIT_INSTRUMENT_RUNTIME}" DIRECTORY)',
+            '    add_library(toolchainkit_instrument SHARED "${TOOLCHAINKIT_INSTRUMENT_RUNTIME}")',
+            "    set_target_properties(toolchainkit_instrument PROPERTIES",
+            '        LINK_LIBRARIES ""',
+            "        CXX_STANDARD 17",
+            "        CXX_VISIBILITY_PRESET hidden)",
+            '    target_include_directories(toolchainkit_instrument PUBLIC "${dir}")',
+            "    target_compile_definitions(toolchainkit_instrument",
+            "        PRIVATE ${TOOLCHAINKIT_INSTRUMENT_DEFINITIONS})",
+            f"    target_compile_options(toolchainkit_instrument PRIVATE {no_instrument})",
+            "    target_link_libraries(toolchainkit_instrument",
+            "        PRIVATE Threads::Threads ${CMAKE_DL_LIBS})",
+            "endfunction()",
+            'if(NOT CMAKE_PROJECT_NAME STREQUAL "CMAKE_TRY_COMPILE")',
+            "    link_libraries(toolchainkit_instrument)",
+            '    cmake_language(DEFER DIRECTORY "${CMAKE_SOURCE_DIR}"',
+            "        CALL toolchainkit_instrument_runtime)",
+            "endif()",
+        ]
+
+    def _generate_layer_allocator_proxy(self) -> List[str]:
+        """Generate the allocator proxy target.
+
+        Every target links ``toolchainkit_allocator_proxy``, a shared library
+        built from TOOLCHAINKIT_ALLOCATOR_PROXY_RUNTIME at the end of the
+        top-level directory, so the process loads it at startup and its
+        malloc and operator new replace the C and C++ libraries' ones. The
+        allocator library found by the layer is compiled in as the default.
+
+        Returns:
+            List of CMake lines
+        """
+        no_instrument = "$<$<CXX_COMPILER_ID:GNU>:-fno-instrument-functions>"
+        return [
+            "# Allocator proxy: toolchainkit_allocator_proxy",
+            "function(toolchainkit_allocator_proxy)",
+            "    if(TARGET toolchainkit_allocator_proxy)",
+            "        return()  # Deferred once per inclusion of this file",
+            "    endif()",
+            "    get_property(languages GLOBAL PROPERTY ENABLED_LANGUAGES)",
+            '    if(NOT "CXX" IN_LIST languages)',
+            '        message(WARNING "ToolchainKit: the allocator proxy '
+            'needs the CXX language")',
+            "        add_library(toolchainkit_allocator_proxy INTERFACE)",
+            "        return()",
+            "    endif()",
+            "    find_package(Threads REQUIRED)",
+            '    get_filename_component(dir "${TOOLCHAINKIT_ALLOCATOR_PROXY_RUNTIME}" '
+            "DIRECTORY)",
+            "    add_library(toolchainkit_allocator_proxy SHARED",
+            '        "${TOOLCHAINKIT_ALLOCATOR_PROXY_RUNTIME}")',
+            "    set_target_properties(toolchainkit_allocator_proxy PROPERTIES",
+            '        LINK_LIBRARIES ""',
+            "        CXX_STANDARD 17",
+            "        CXX_VISIBILITY_PRESET hidden)",
+            '    target_include_directories(toolchainkit_allocator_proxy PUBLIC "${dir}")',
+            "    target_compile_definitions(toolchainkit_allocator_proxy PRIVATE",
+            "        ${TOOLCHAINKIT_ALLOCATOR_PROXY_DEFINITIONS}",
+            '        "TK_MALLOC_DEFAULT_LIBRARY=\\"${TOOLCHAINKIT_ALLOCATOR_PROXY_LIBRARY}\\"")',
+            "    target_compile_options(toolchainkit_allocator_proxy",
+            f"        PRIVATE -fno-builtin {no_instrument})",
+            "    target_link_libraries(toolchainkit_allocator_proxy",
+            "        PRIVATE Threads::Threads ${CMAKE_DL_LIBS})",
+            "endfunction()",
+            'if(NOT CMAKE_PROJECT_NAME STREQUAL "CMAKE_TRY_COMPILE")',
+            "    link_libraries(toolchainkit_allocator_proxy)",
+            '    cmake_language(DEFER DIRECTORY "${CMAKE_SOURCE_DIR}"',
+            "        CALL toolchainkit_allocator_proxy)",
+            "endif()",
+        ]
+
+    def _generate_layer_allocator_replay(self) -> List[str]:
+        """Generate the allocation trace replay target.
+
+        ``toolchainkit_alloc_replay`` is built from
+        TOOLCHAINKIT_ALLOCATOR_REPLAY_SOURCE only when asked for (``cmake
+        --build . --target toolchainkit_alloc_replay``). It links what every
+        target links, so it replays traces against the layer's allocator,
+        or through the allocator proxy against the one TOOLCHAINKIT_ALLOCATOR
+        selects.
+
+        Returns:
+            List of CMake lines
+        """
+        no_instrument = "$<$<CXX_COMPILER_ID:GNU>:-fno-instrument-functions>"
+        return [
+            "# Allocation trace replay: toolchainkit_alloc_replay",
+            "function(toolchainkit_allocator_replay)",
+            "    if(TARGET toolchainkit_alloc_replay)",
+            "        return()  # Deferred once per inclusion of this file",
+            "    endif()",
+            "    get_property(languages GLOBAL PROPERTY ENABLED_LANGUAGES)",
+            '    if(NOT "CXX" IN_LIST languages)',
+            "        return()",
+            "    endif()",
+            "    find_package(Threads REQUIRED)",
+            "    add_executable(toolchainkit_alloc_replay EXCLUDE_FROM_ALL",
+            '        "${TOOLCHAINKIT_ALLOCATOR_REPLAY_SOURCE}")',
+            "    set_target_properties(toolchainkit_alloc_replay PROPERTIES CXX_STANDARD 17)",
+            "    target_compile_options(toolchainkit_alloc_replay",
+            f"        PRIVATE -fno-builtin {no_instrument})",
+            "    target_link_libraries(toolchainkit_alloc_replay PRIVATE Threads::Threads)",
+            "endfunction()",
+            'if(NOT CMAKE_PROJECT_NAME STREQUAL "CMAKE_TRY_COMPILE")',
+            '    cmake_language(DEFER DIRECTORY "${CMAKE_SOURCE_DIR}"',
+            "        CALL toolchainkit_allocator_replay)",
+            "endif()",
+        ]
+
     def _generate_layer_runtime_env(self, composed: ComposedConfig) -> List[str]:
         """Generate runtime environment settings from layers.
 
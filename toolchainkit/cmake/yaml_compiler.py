@@ -8,9 +8,15 @@ Supports composition, platform overrides, and variable interpolation.
 
 from pathlib import Path
 from typing import Dict, List, Optional, Any, Union
+import re
 import yaml
 
 
+def _version_tuple(version: str) -> tuple:
+    """Parse a dotted version ('18.1.8', '13') into a comparable tuple."""
+    return tuple(int(part) for part in re.findall(r"\d+", version)[:3])
+
+
 class YAMLCompilerError(Exception):
     """Base exception for YAML compiler errors."""
 
@@ -544,6 +550,46 @@ class YAMLCompilerConfig:
         # Return just the compile flags as a list
         return coverage.get("flags", [])
 
+    def get_debug_info_flags(
+        self, feature: str, version: Optional[str] = None
+    ) -> Optional[Dict[str, Any]]:
+        """
+        Get flags for a debug information feature.
+
+        Args:
+            feature: Feature name ('split_dwarf', 'gdb_index', 'compress_zstd',
+                'compress_zlib')
+            version: Compiler version; features with a higher ``min_version``
+                are reported as unsupported
+
+        Returns:
+            Dictionary with 'compile_flags', 'link_flags', 'supported_platforms',
+            'linker_feature' and 'tool' keys, or None if not supported
+
+        Example:
+            >>> config = YAMLCompilerConfig(data, "clang")
+            >>> flags = config.get_debug_info_flags('compress_zstd', '18.1.8')
+            >>> print(flags['compile_flags'])  # ['-gz=zstd']
+        """
+        features = self.config_data.get("features", {})
+        debug_info = features.get("debug_info", {})
+        if feature not in debug_info:
+            return None
+
+        feature_config = debug_info[feature]
+        min_version = feature_config.get("min_version")
+        if version and min_version:
+            if _version_tuple(version) < _version_tuple(str(min_version)):
+                return None
+
+        return {
+            "compile_flags": feature_config.get("compile_flags", []),
+            "link_flags": feature_config.get("link_flags", []),
+            "supported_platforms": feature_config.get("supported_platforms"),
+            "linker_feature": feature_config.get("linker_feature"),
+            "tool": feature_config.get("tool"),
+        }
+
     def get_cmake_variables(
         self, toolchain_root: Optional[Path] = None, **kwargs: Any
     ) -> Dict[str, str]:
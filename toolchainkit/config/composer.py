@@ -19,16 +19,19 @@ Example:
     >>> print(config.compile_flags)
 """
 
+import logging
 from dataclasses import dataclass
 from pathlib import Path
 from typing import List, Dict, Optional, Any, Set
 import yaml
 
+from toolchainkit.core.filecache import load_cached
 from toolchainkit.config.layers import (
     ConfigLayer,
     LayerContext,
     LayerError,
     LayerNotFoundError,
+    LayerRequirementError,
     LayerValidationError,
     BaseCompilerLayer,
     PlatformLayer,
@@ -39,8 +42,25 @@ from toolchainkit.config.layers import (
     AllocatorLayer,
     SecurityLayer,
     ProfilingLayer,
+    LinkerLayer,
+    AutoLinkerLayer,
+    DebugInfoLayer,
+    StartupLayer,
 )
 
+logger = logging.getLogger(__name__)
+
+
+def _parse_layer_yaml(yaml_file: Path) -> Dict:
+    """Parse a layer YAML file, raising LayerError on failure."""
+    try:
+        with open(yaml_file, "r") as f:
+            return yaml.safe_load(f)
+    except yaml.YAMLError as e:
+        raise LayerError(f"Failed to parse YAML file '{yaml_file}': {e}")
+    except OSError as e:
+        raise LayerError(f"Failed to read YAML file '{yaml_file}': {e}")
+
 
 # ============================================================================
 # ComposedConfig: Final Configuration Result
@@ -124,6 +144,11 @@ class ComposedConfig:
         """Active sanitizers."""
         return self.context.sanitizers
 
+    @property
+    def required_components(self) -> Set[str]:
+        """Toolchain components needed by the layers (e.g., bolt)."""
+        return self.context.required_components
+
     @property
     def linker(self) -> Optional[str]:
         """Linker name (if explicitly set via CMake variables)."""
@@ -250,26 +275,55 @@ class LayerComposer:
         self._validate_layer_specs(layer_specs)
 
         # Initialize context
-        context = LayerContext()
+        context = LayerContext(variables=dict(interpolation_vars))
 
-        # Apply layers in order
-        applied_layers = []
-        for spec in layer_specs:
-            layer = self.load_layer(spec["type"], spec["name"])
+        # Apply layers in order (stable sort: later phases go after the rest)
+        layers = [self.load_layer(spec["type"], spec["name"]) for spec in layer_specs]
+        layers.sort(key=lambda layer: layer.apply_phase)
 
+        applied_layers = []
+        for layer in layers:
             # Validate layer can be applied
             layer.validate(context)
 
             # Apply layer
             layer.apply(context)
+            context.required_components.update(layer.components)
             applied_layers.append(layer)
 
         # Interpolate variables in CMake variables and runtime env
         if interpolation_vars:
             self._interpolate_context(context, interpolation_vars)
 
+        if context.required_components and interpolation_vars.get("toolchain_root"):
+            self._ensure_components(
+                Path(interpolation_vars["toolchain_root"]), context.required_components
+            )
+
         return ComposedConfig(context, applied_layers)
 
+    def _ensure_components(self, toolchain_root: Path, components: Set[str]) -> None:
+        """Add toolchain components needed by layers to a partial installation.
+
+        Args:
+            toolchain_root: Toolchain installation directory
+            components: Needed component names
+
+        Raises:
+            LayerRequirementError: If a component cannot be installed
+        """
+        from toolchainkit.toolchain.components import ComponentError, ensure_components
+        from toolchainkit.toolchain.downloader import ToolchainDownloadError
+
+        try:
+            added = ensure_components(toolchain_root, sorted(components))
+        except (ComponentError, ToolchainDownloadError) as e:
+            raise LayerRequirementError(
+                f"Cannot install toolchain components {sorted(components)}: {e}"
+            ) from e
+        if added:
+            logger.info(f"Installed toolchain components for layers: {added}")
+
     def load_layer(self, layer_type: str, name: str) -> ConfigLayer:
         """Load a layer by type and name.
 
@@ -333,6 +387,8 @@ class LayerComposer:
                 "buildtype",
                 "optimization",
                 "sanitizer",
+                "linker",
+                "debuginfo",
             ]
         )
 
@@ -399,6 +455,28 @@ class LayerComposer:
                     f"Multiple '{ltype}' layers are not allowed. Only one {ltype} layer per configuration."
                 )
 
+    def preload(self) -> int:
+        """Parse every global and built-in layer YAML into the process-wide cache.
+
+        Used by long-lived processes (``tkgen daemon``) so the commands they
+        serve find the layers already parsed. Unparsable files are skipped;
+        composing them reports the error as usual.
+
+        Returns:
+            Number of layer files parsed
+        """
+        count = 0
+        for layers_dir in (self.global_layers_dir, self.builtin_layers_dir):
+            if not layers_dir.is_dir():
+                continue
+            for yaml_file in sorted(layers_dir.glob("*/*.yaml")):
+                try:
+                    load_cached(yaml_file, _parse_layer_yaml)
+                    count += 1
+                except LayerError as e:
+                    logger.debug(f"Not preloading {yaml_file}: {e}")
+        return count
+
     def _find_layer_file(self, layer_type: str, name: str) -> Optional[Path]:
         """Find layer file by searching discovery paths.
 
@@ -461,14 +539,8 @@ class LayerComposer:
         if cache_key in self._yaml_cache:
             return self._yaml_cache[cache_key]
 
-        # Load YAML
-        try:
-            with open(yaml_file, "r") as f:
-                data = yaml.safe_load(f)
-        except yaml.YAMLError as e:
-            raise LayerError(f"Failed to parse YAML file '{yaml_file}': {e}")
-        except OSError as e:
-            raise LayerError(f"Failed to read YAML file '{yaml_file}': {e}")
+        # Load YAML (parsed once per process while the file is unchanged)
+        data = load_cached(yaml_file, _parse_layer_yaml)
 
         # Cache and return
         self._yaml_cache[cache_key] = data
@@ -521,18 +593,37 @@ class LayerComposer:
         elif layer_type == "buildtype":
             layer = BuildTypeLayer(name=name, build_type=name, description=description)
         elif layer_type == "optimization":
-            layer = OptimizationLayer(
-                name=name, optimization=name, description=description
-            )
+            if "startup" in yaml_data:
+                startup = yaml_data["startup"] or {}
+                layer = StartupLayer(
+                    name=name,
+                    visibility=startup.get("visibility"),
+                    semantic_interposition=startup.get("semantic_interposition", True),
+                    bsymbolic_functions=startup.get("bsymbolic_functions", False),
+                    hash_style=startup.get("hash_style"),
+                    binding=startup.get("binding"),
+                    relr=startup.get("relr", False),
+                    static_pie=startup.get("static_pie", False),
+                    linkers=[
+                        self.load_layer("linker", linker)
+                        for linker in yaml_data.get("linkers", [])
+                    ],
+                    description=description,
+                )
+            else:
+                layer = OptimizationLayer(
+                    name=name, optimization=name, description=description
+                )
         elif layer_type == "sanitizer":
             layer = SanitizerLayer(name=name, sanitizer=name, description=description)
         elif layer_type == "allocator":
             method = yaml_data.get("method", "auto")
             layer = AllocatorLayer(
                 name=name,
-                allocator_name=name,
+                allocator_name=yaml_data.get("allocator", name),
                 method=method,
                 description=description,
+                proxy=yaml_data.get("proxy"),
             )
         elif layer_type == "security":
             security_type = yaml_data.get("security_type", name)
@@ -553,6 +644,42 @@ class LayerComposer:
                 name=name,
                 profiling_type=profiling_type,
                 description=description,
+                remarks=yaml_data.get("remarks"),
+                instrument=yaml_data.get("instrument"),
+            )
+        elif layer_type == "linker":
+            if yaml_data.get("selection") == "auto":
+                layer = AutoLinkerLayer(
+                    name=name,
+                    candidates=[
+                        self.load_layer("linker", candidate)
+                        for candidate in yaml_data.get("candidates", [])
+                    ],
+                    benchmark_options=yaml_data.get("benchmark"),
+                    description=description,
+                )
+            else:
+                layer = LinkerLayer(
+                    name=name,
+                    linker=yaml_data.get("name", name),
+                    flag=yaml_data.get("flag", ""),
+                    supported_platforms=yaml_data.get("supported_platforms"),
+                    supported_compilers=yaml_data.get("supported_compilers"),
+                    features=yaml_data.get("features"),
+                    speed=yaml_data.get("performance", {}).get("speed"),
+                    description=description,
+                )
+        elif layer_type == "debuginfo":
+            layer = DebugInfoLayer(
+                name=name,
+                enable=yaml_data.get("enable"),
+                compression=yaml_data.get("compression"),
+                dwp=yaml_data.get("dwp", False),
+                linkers=[
+                    self.load_layer("linker", linker)
+                    for linker in yaml_data.get("linkers", [])
+                ],
+                description=description,
             )
         else:
             raise LayerError(f"Unknown layer type: {layer_type}")
@@ -590,6 +717,9 @@ class LayerComposer:
         # Conflicts
         layer._conflicts_with = yaml_data.get("conflicts_with", {})
 
+        # Toolchain components
+        layer.components = yaml_data.get("components", [])
+
     def _interpolate_context(
         self, context: LayerContext, variables: Dict[str, Any]
     ) -> None:
@@ -19,9 +19,12 @@ Example:
     >>> print(context.compiler)  # "clang"
 """
 
+import logging
 from abc import ABC, abstractmethod
 from dataclasses import dataclass, field
-from typing import List, Dict, Set, Optional, Any
+from typing import List, Dict, Set, Optional, Any, Tuple
+
+logger = logging.getLogger(__name__)
 
 
 # ============================================================================
@@ -85,6 +88,8 @@ class LayerContext:
         applied_layers: List of applied layers (for debugging)
         layer_types: Set of applied layer types (for validation)
         sanitizers: Set of active sanitizers (for conflict detection)
+        variables: Interpolation variables passed to compose (e.g., toolchain_root)
+        required_components: Toolchain components needed by applied layers
     """
 
     # Toolchain identification
@@ -105,6 +110,8 @@ class LayerContext:
     applied_layers: List["ConfigLayer"] = field(default_factory=list)
     layer_types: Set[str] = field(default_factory=set)
     sanitizers: Set[str] = field(default_factory=set)
+    variables: Dict[str, Any] = field(default_factory=dict)
+    required_components: Set[str] = field(default_factory=set)
 
     def add_flags(
         self,
@@ -241,8 +248,14 @@ class ConfigLayer(ABC):
         _runtime_env: Runtime environment variables
         _requires: Requirements (e.g., {"compiler": ["clang"]})
         _conflicts_with: Conflicts (e.g., {"sanitizer": ["thread"]})
+        components: Toolchain components the layer needs (e.g., ["bolt"]),
+            added to a partially installed toolchain on composition
+        apply_phase: Layers are applied in ascending phase, in list order
+            within a phase (later phases inspect the final configuration)
     """
 
+    apply_phase: int = 0
+
     def __init__(self, name: str, layer_type: str, description: str = ""):
         """Initialize a configuration layer.
 
@@ -267,6 +280,9 @@ class ConfigLayer(ABC):
         self._requires: Dict[str, List[str]] = {}
         self._conflicts_with: Dict[str, List[str]] = {}
 
+        # Toolchain components (see toolchainkit.toolchain.components)
+        self.components: List[str] = []
+
     @abstractmethod
     def apply(self, context: LayerContext) -> None:
         """Apply this layer's settings to the context.
@@ -558,12 +574,14 @@ class AllocatorLayer(ConfigLayer):
     Integration methods:
     - link: Compile-time linking (e.g., -ljemalloc)
     - ld_preload: Runtime replacement via LD_PRELOAD (Linux/macOS only)
-    - proxy: Proxy library approach (fallback)
+    - proxy: Interposer library forwarding to the allocator loaded at
+      startup, with optional allocation statistics (Linux)
     - auto: Automatic method selection (default)
 
     Attributes:
         allocator_name: Name of the allocator
         method: Integration method (auto, link, ld_preload, proxy)
+        proxy: Proxy settings (stats, sample)
     """
 
     def __init__(
@@ -572,6 +590,7 @@ class AllocatorLayer(ConfigLayer):
         allocator_name: str,
         method: str = "auto",
         description: str = "",
+        proxy: Optional[Dict[str, Any]] = None,
     ):
         """Initialize memory allocator layer.
 
@@ -580,15 +599,33 @@ class AllocatorLayer(ConfigLayer):
             allocator_name: Allocator name (jemalloc, tcmalloc, mimalloc, etc.)
             method: Integration method (auto, link, ld_preload, proxy)
             description: Human-readable description
+            proxy: Proxy settings: stats (count allocations per size class)
+                and sample (record the call stack of one in N allocations,
+                0 for none)
+
+        Raises:
+            ValueError: If the proxy settings are invalid
         """
         if not description:
             description = f"Memory allocator: {allocator_name}"
         super().__init__(name, "allocator", description)
         self.allocator_name = allocator_name
         self.method = method
+        self.proxy = dict(proxy or {})
         self._detected = False
         self._available_library: Optional[str] = None
 
+        sample = self.proxy.get("sample", 0)
+        if not isinstance(sample, int) or isinstance(sample, bool) or sample < 0:
+            raise ValueError(
+                f"Invalid allocator proxy sample '{sample}', expected N >= 0"
+            )
+        if not isinstance(self.proxy.get("stats", False), bool):
+            raise ValueError(
+                f"Invalid allocator proxy stats '{self.proxy['stats']}', "
+                f"expected true or false"
+            )
+
     def apply(self, context: LayerContext) -> None:
         """Apply allocator settings to context.
 
@@ -603,19 +640,26 @@ class AllocatorLayer(ConfigLayer):
                 f"AddressSanitizer uses its own allocator and cannot be combined with "
                 f"custom allocators like jemalloc, tcmalloc, etc."
             )
-        if context.has_sanitizer("thread") and self.allocator_name not in ["default"]:
+        # The proxy replaces malloc even for the default allocator
+        custom = self.allocator_name != "default" or self.method == "proxy"
+        if context.has_sanitizer("thread") and custom:
             raise LayerConflictError(
                 f"Allocator '{self.allocator_name}' may conflict with ThreadSanitizer. "
                 f"TSan requires careful allocator integration. Use default allocator with TSan."
             )
-        if context.has_sanitizer("memory") and self.allocator_name not in ["default"]:
+        if context.has_sanitizer("memory") and custom:
             raise LayerConflictError(
                 f"Allocator '{self.allocator_name}' conflicts with MemorySanitizer. "
                 f"MSan requires custom allocator support. Use default allocator with MSan."
             )
 
-        # Default allocator needs no special configuration
+        self._apply_replay_driver(context)
+
+        # Default allocator needs no special configuration, except behind
+        # the proxy (allocation statistics, allocator chosen at run time)
         if self.allocator_name == "default":
+            if self.method == "proxy":
+                self._apply_proxy_method(context)
             context.layer_types.add(self.layer_type)
             context.applied_layers.append(self)
             return
@@ -841,14 +885,75 @@ class AllocatorLayer(ConfigLayer):
     def _apply_proxy_method(self, context: LayerContext) -> None:
         """Apply proxy library integration.
 
+        The generated toolchain builds the proxy in ``data/runtime/allocator``
+        and links it into every target (TOOLCHAINKIT_ALLOCATOR_PROXY_RUNTIME).
+        It replaces malloc and operator new and forwards them to the detected
+        allocator library, loaded at startup; TOOLCHAINKIT_ALLOCATOR selects
+        another one without relinking. The layer's ``proxy`` settings become
+        the defaults of its allocation statistics.
+
+        The proxy interposes ELF symbols; elsewhere the allocator is linked.
+
         Args:
             context: Layer context to modify
         """
-        # Proxy method: Create a small library that wraps malloc/free
-        # and forwards to the actual allocator
-        # This is a fallback method, not commonly used
-        # For now, we fall back to link method
-        self._apply_link_method(context)
+        platform = (context.platform or "").lower()
+        if (
+            context.compiler == "msvc"
+            or platform.startswith(("windows", "macos"))
+            or "darwin" in platform
+        ):
+            logger.info(
+                f"allocator/{self.name}: no allocator proxy for "
+                f"{context.compiler} on {platform}, linking the allocator"
+            )
+            if self.allocator_name != "default":
+                self._apply_link_method(context)
+            return
+
+        from pathlib import Path
+
+        runtime = Path(__file__).parent.parent / "data" / "runtime" / "allocator"
+        definitions = [
+            f"TK_MALLOC_DEFAULT_STATS={int(self.proxy.get('stats', False))}",
+            f"TK_MALLOC_DEFAULT_SAMPLE={self.proxy.get('sample', 0)}",
+        ]
+        context.add_cmake_variables(
+            {
+                "TOOLCHAINKIT_ALLOCATOR_PROXY_RUNTIME": (
+                    runtime / "tk_malloc_proxy.cpp"
+                ).as_posix(),
+                "TOOLCHAINKIT_ALLOCATOR_PROXY_LIBRARY": self._available_library or "",
+                "TOOLCHAINKIT_ALLOCATOR_PROXY_DEFINITIONS": ";".join(definitions),
+            }
+        )
+
+    def _apply_replay_driver(self, context: LayerContext) -> None:
+        """Provide the allocation trace replay driver.
+
+        The generated toolchain defines ``toolchainkit_alloc_replay``
+        (TOOLCHAINKIT_ALLOCATOR_REPLAY_SOURCE), built on request only, which
+        replays a trace recorded by the proxy against this layer's
+        allocator. It uses POSIX allocation calls, so it is not provided
+        for MSVC or Windows.
+
+        Args:
+            context: Layer context to modify
+        """
+        platform = (context.platform or "").lower()
+        if context.compiler == "msvc" or platform.startswith("windows"):
+            return
+
+        from pathlib import Path
+
+        runtime = Path(__file__).parent.parent / "data" / "runtime" / "allocator"
+        context.add_cmake_variables(
+            {
+                "TOOLCHAINKIT_ALLOCATOR_REPLAY_SOURCE": (
+                    runtime / "tk_alloc_replay.cpp"
+                ).as_posix()
+            }
+        )
 
 
 class SecurityLayer(ConfigLayer):
@@ -1033,25 +1138,51 @@ class ProfilingLayer(ConfigLayer):
     - instrument-functions: Function entry/exit instrumentation
     - asan-profile: AddressSanitizer with profiling
     - perf: Linux perf profiling
+    - opt_remarks: Optimization remark records (see ``tkgen remarks``)
     """
 
+    INSTRUMENT_FORMATS = ("chrome", "folded")
+
     def __init__(
         self,
         name: str,
         profiling_type: str,
         description: str = "",
+        remarks: Optional[Dict[str, Any]] = None,
+        instrument: Optional[Dict[str, Any]] = None,
     ):
         """Initialize profiling layer.
 
         Args:
             name: Layer name (e.g., "gprof")
-            profiling_type: Type of profiling (gprof, instrument_functions, asan_profile, perf)
+            profiling_type: Type of profiling (gprof, instrument_functions,
+                asan_profile, perf, opt_remarks)
             description: Human-readable description
+            remarks: ``remarks`` section of the layer YAML (opt_remarks only);
+                ``flags`` maps compiler name to its remark flags
+            instrument: ``instrument`` section of the layer YAML
+                (instrument_functions only): runtime, output_format, sample,
+                exclude, buffer_events, signal, after_inlining
+
+        Raises:
+            ValueError: If the instrument settings are invalid
         """
         if not description:
             description = f"Profiling: {profiling_type}"
         super().__init__(name, "profiling", description)
         self.profiling_type = profiling_type
+        self.remarks = remarks or {}
+        self.instrument = instrument or {}
+
+        output_format = self.instrument.get("output_format", "chrome")
+        if output_format not in self.INSTRUMENT_FORMATS:
+            raise ValueError(
+                f"Invalid instrument output_format '{output_format}', "
+                f"expected one of {', '.join(self.INSTRUMENT_FORMATS)}"
+            )
+        sample = self.instrument.get("sample", 1)
+        if not isinstance(sample, int) or sample < 1:
+            raise ValueError(f"Invalid instrument sample '{sample}', expected N >= 1")
 
     def apply(self, context: LayerContext) -> None:
         """Apply profiling settings to context.
@@ -1067,6 +1198,8 @@ class ProfilingLayer(ConfigLayer):
             self._apply_asan_profile(context)
         elif self.profiling_type == "perf":
             self._apply_perf(context)
+        elif self.profiling_type == "opt_remarks":
+            self._apply_opt_remarks(context)
         else:
             raise ValueError(f"Unknown profiling type: {self.profiling_type}")
 
@@ -1082,15 +1215,68 @@ class ProfilingLayer(ConfigLayer):
             context.link_flags.append("-pg")
 
     def _apply_instrument_functions(self, context: LayerContext) -> None:
-        """Apply function instrumentation flags.
+        """Apply function instrumentation flags and the recording runtime.
+
+        With ``instrument.runtime`` set, the generated toolchain builds the
+        runtime in ``data/runtime/instrument`` and links it into every target
+        (TOOLCHAINKIT_INSTRUMENT_RUNTIME); the layer's settings become its
+        defaults. GCC leaves functions matching ``instrument.exclude``
+        uninstrumented; for Clang the runtime filters them by name.
 
         Args:
             context: Layer context to modify
         """
         flag = "-finstrument-functions"
+        if context.compiler == "clang" and self.instrument.get("after_inlining"):
+            # Inlined calls are not instrumented, as with GCC
+            flag = "-finstrument-functions-after-inlining"
         if flag not in context.compile_flags:
             context.compile_flags.append(flag)
 
+        exclude = list(self.instrument.get("exclude", []))
+        if exclude and context.compiler == "gcc":
+            context.compile_flags.append(
+                "-finstrument-functions-exclude-function-list=" + ",".join(exclude)
+            )
+            exclude = []
+
+        if not self.instrument.get("runtime"):
+            return
+        platform = context.platform or ""
+        if context.compiler not in ("gcc", "clang") or platform.startswith("windows"):
+            logger.info(
+                f"profiling/{self.name}: no instrumentation runtime for "
+                f"{context.compiler} on {platform or 'this platform'}"
+            )
+            return
+
+        from pathlib import Path
+
+        runtime = Path(__file__).parent.parent / "data" / "runtime" / "instrument"
+        definitions = [
+            f"TK_INSTRUMENT_DEFAULT_FORMAT="
+            f"{self.instrument.get('output_format', 'chrome')}",
+            f"TK_INSTRUMENT_DEFAULT_SAMPLE={self.instrument.get('sample', 1)}",
+        ]
+        if exclude:
+            definitions.append(f"TK_INSTRUMENT_DEFAULT_EXCLUDE={','.join(exclude)}")
+        if "buffer_events" in self.instrument:
+            definitions.append(
+                f"TK_INSTRUMENT_DEFAULT_BUFFER={int(self.instrument['buffer_events'])}"
+            )
+        if "signal" in self.instrument:
+            definitions.append(
+                f"TK_INSTRUMENT_DEFAULT_SIGNAL={self.instrument['signal'] or 0}"
+            )
+        context.add_cmake_variables(
+            {
+                "TOOLCHAINKIT_INSTRUMENT_RUNTIME": (
+                    runtime / "tk_instrument.cpp"
+                ).as_posix(),
+                "TOOLCHAINKIT_INSTRUMENT_DEFINITIONS": ";".join(definitions),
+            }
+        )
+
     def _apply_asan_profile(self, context: LayerContext) -> None:
         """Apply ASan profiling flags.
 
@@ -1121,3 +1307,685 @@ class ProfilingLayer(ConfigLayer):
         # Debug info for symbol resolution
         if not any("-g" in f for f in context.compile_flags):
             context.compile_flags.append("-g")
+
+    def _apply_opt_remarks(self, context: LayerContext) -> None:
+        """Apply optimization remark flags.
+
+        The flags are not added to the global compile flags: they go into
+        TOOLCHAINKIT_OPT_REMARKS_FLAGS, which the generated toolchain applies
+        to the targets listed in TOOLCHAINKIT_OPT_REMARKS_TARGETS (or to all
+        targets when that is empty).
+
+        Args:
+            context: Layer context to modify
+
+        Raises:
+            LayerRequirementError: If the compiler has no remark flags
+        """
+        flags = self.remarks.get("flags", {}).get(context.compiler or "")
+        if not flags:
+            raise LayerRequirementError(
+                f"Layer 'profiling/{self.name}': no optimization remark flags "
+                f"for compiler '{context.compiler}'"
+            )
+        context.add_cmake_variables({"TOOLCHAINKIT_OPT_REMARKS_FLAGS": ";".join(flags)})
+
+
+class LinkerLayer(ConfigLayer):
+    """Linker selection layer (ld, gold, lld, mold).
+
+    Replaces any linker chosen by earlier layers (e.g. ``-fuse-ld=lld`` from a
+    Clang base layer) and checks compatibility with the active configuration.
+
+    Attributes:
+        linker: Linker name
+        flag: Driver flag selecting the linker (e.g., "-fuse-ld=mold")
+        supported_platforms: Operating systems the linker supports
+        supported_compilers: Compilers that can drive the linker
+        features: Feature support map (thin_lto, full_lto, icf, ...)
+        speed: Relative speed from the layer YAML (slow..very_fast)
+    """
+
+    SPEED_RANK = {"very_fast": 0, "fast": 1, "moderate": 2, "slow": 3}
+
+    def __init__(
+        self,
+        name: str,
+        linker: str,
+        flag: str = "",
+        supported_platforms: Optional[List[str]] = None,
+        supported_compilers: Optional[List[str]] = None,
+        features: Optional[Dict[str, bool]] = None,
+        speed: Optional[str] = None,
+        description: str = "",
+    ):
+        """Initialize linker layer.
+
+        Args:
+            name: Layer name (e.g., "mold")
+            linker: Linker name
+            flag: Driver flag selecting the linker
+            supported_platforms: Supported operating systems (None for any)
+            supported_compilers: Supported compilers (None for any)
+            features: Feature support map
+            speed: Relative speed (slow, moderate, fast, very_fast)
+            description: Human-readable description
+        """
+        super().__init__(name, "linker", description)
+        self.linker = linker
+        self.flag = flag
+        self.supported_platforms = supported_platforms
+        self.supported_compilers = supported_compilers
+        self.features = features or {}
+        self.speed = speed
+
+    def incompatibility(self, context: LayerContext) -> Optional[str]:
+        """Explain why this linker cannot be used with the context.
+
+        Args:
+            context: Context with the layers applied so far
+
+        Returns:
+            Reason string, or None if the linker is compatible
+        """
+        target_os = context.platform.split("-")[0] if context.platform else None
+        if (
+            target_os
+            and self.supported_platforms
+            and target_os not in self.supported_platforms
+        ):
+            return f"{self.linker} does not support {target_os}"
+        if (
+            context.compiler
+            and self.supported_compilers
+            and context.compiler not in self.supported_compilers
+        ):
+            return f"{self.linker} cannot be used with {context.compiler}"
+
+        lto_flags = [
+            f
+            for f in context.compile_flags + context.link_flags
+            if f.startswith("-flto")
+        ]
+        if any(f == "-flto=thin" for f in lto_flags):
+            if not self.features.get("thin_lto", False):
+                return f"{self.linker} does not support ThinLTO"
+        elif lto_flags:
+            if not self.features.get("full_lto", False):
+                return f"{self.linker} does not support LTO"
+            if context.compiler == "gcc" and self.linker == "lld":
+                return "lld cannot link GCC LTO objects"
+        return None
+
+    def validate(self, context: LayerContext) -> None:
+        """Validate requirements, conflicts and linker compatibility."""
+        super().validate(context)
+        reason = self.incompatibility(context)
+        if reason:
+            raise LayerRequirementError(f"Layer 'linker/{self.name}': {reason}")
+
+    def apply(self, context: LayerContext) -> None:
+        """Apply linker selection to context."""
+        if self.flag:
+            replace_linker_flags(context, [self.flag])
+        context.add_flags(
+            compile=self._compile_flags,
+            link=self._link_flags,
+            common=self._common_flags,
+        )
+        context.add_defines(self._defines)
+        context.add_cmake_variables(self._cmake_variables)
+        context.add_runtime_env(self._runtime_env)
+        context.layer_types.add(self.layer_type)
+        context.applied_layers.append(self)
+
+
+def replace_linker_flags(context: LayerContext, flags: List[str]) -> None:
+    """Replace linker selection and thread flags in the context's link flags.
+
+    Args:
+        context: Context to modify
+        flags: New linker flags (e.g., ["-fuse-ld=mold", "-Wl,--thread-count=8"])
+    """
+    context.link_flags = [
+        f
+        for f in context.link_flags
+        if not f.startswith("-fuse-ld=")
+        and not f.startswith(("-Wl,--threads", "-Wl,--thread-count"))
+    ]
+    context.link_flags.extend(flags)
+
+
+class AutoLinkerLayer(ConfigLayer):
+    """Measured linker selection (``linker/auto``).
+
+    Picks the fastest installed linker that is compatible with the other
+    active layers (e.g. only lld or mold under ThinLTO). On Linux the choice
+    is based on timing a link with every installed linker and thread count;
+    measurements are cached per toolchain and host CPU count, so they run
+    once. Elsewhere, or if measuring is not possible, the layer falls back to
+    the relative speeds declared in the linker layer YAML files.
+
+    Applied after the other layers (phase 1) so it sees the final LTO settings.
+
+    Set ``TOOLCHAINKIT_LINKER_BENCHMARK=0`` to skip measuring.
+
+    Attributes:
+        candidates: Linker layers to choose from
+        benchmark_options: LinkerBenchmark keyword arguments from the YAML
+        cache_path: Measurement cache file (default: global cache)
+        selected: Linker chosen by the last apply()
+        timing: Measurement behind the last choice (None for heuristic picks)
+    """
+
+    apply_phase = 1
+
+    def __init__(
+        self,
+        name: str,
+        candidates: List[LinkerLayer],
+        benchmark_options: Optional[Dict[str, Any]] = None,
+        cache_path: Optional[Any] = None,
+        description: str = "",
+    ):
+        """Initialize automatic linker layer.
+
+        Args:
+            name: Layer name (e.g., "auto")
+            candidates: Linker layers to choose from
+            benchmark_options: Options for LinkerBenchmark (units, functions,
+                repeats, ninja_build_dir, ninja_target)
+            cache_path: Path of the measurement cache file
+            description: Human-readable description
+        """
+        super().__init__(name, "linker", description or "Fastest compatible linker")
+        self.candidates = candidates
+        self.benchmark_options = dict(benchmark_options or {})
+        self.cache_path = cache_path
+        self.selected: Optional[LinkerLayer] = None
+        self.timing: Optional[Any] = None
+
+    def apply(self, context: LayerContext) -> None:
+        """Select and apply the fastest compatible linker.
+
+        Raises:
+            LayerRequirementError: If no candidate is compatible
+        """
+        compatible = [c for c in self.candidates if c.incompatibility(context) is None]
+        if not compatible:
+            raise LayerRequirementError(
+                "Layer 'linker/auto': no linker is compatible with the active layers"
+            )
+
+        self.timing = self._measured_choice(context, compatible)
+        if self.timing is not None:
+            self.selected = next(
+                c for c in compatible if c.linker == self.timing.linker
+            )
+            replace_linker_flags(context, self.timing.link_flags())
+        else:
+            from toolchainkit.toolchain.linker_benchmark import (
+                LINKER_EXECUTABLES,
+                LinkerTiming,
+            )
+
+            self.selected = self._heuristic_choice(compatible)
+            if self.selected and self.selected.linker in LINKER_EXECUTABLES:
+                flags = LinkerTiming(self.selected.linker).link_flags()
+                replace_linker_flags(context, flags)
+            elif self.selected and self.selected.flag:
+                replace_linker_flags(context, [self.selected.flag])
+
+        if self.selected:
+            logger.info(
+                f"linker/auto selected {self.selected.linker}"
+                + (f" ({self.timing})" if self.timing else " (by declared speed)")
+            )
+        context.layer_types.add(self.layer_type)
+        context.applied_layers.append(self)
+
+    def _heuristic_choice(self, compatible: List[LinkerLayer]) -> Optional[LinkerLayer]:
+        """Fastest installed linker by declared speed."""
+        from toolchainkit.toolchain.linker_benchmark import find_linker
+
+        installed = [c for c in compatible if find_linker(c.linker)]
+        if not installed:
+            logger.warning("linker/auto: no compatible linker found on PATH")
+            return None
+        return min(installed, key=lambda c: LinkerLayer.SPEED_RANK.get(c.speed, 99))
+
+    def _resolve_compiler(self, context: LayerContext) -> Optional[Any]:
+        """Locate the C++ compiler driver for the composed toolchain."""
+        import shutil
+        from pathlib import Path
+
+        configured = context.cmake_variables.get("CMAKE_CXX_COMPILER", "")
+        if configured:
+            path = Path(context.interpolate_variables(configured, **context.variables))
+            if "{{" not in str(path) and path.is_file():
+                return path
+
+        driver = {"clang": "clang++", "gcc": "g++"}.get(context.compiler or "")
+        if not driver:
+            return None
+        major = (context.compiler_version or "").split(".")[0]
+        for name in ([f"{driver}-{major}"] if major else []) + [driver]:
+            found = shutil.which(name)
+            if found:
+                return Path(found)
+        return None
+
+    def _measured_choice(
+        self, context: LayerContext, compatible: List[LinkerLayer]
+    ) -> Optional[Any]:
+        """Fastest compatible linker by measurement, or None if unmeasurable."""
+        import os
+        from pathlib import Path
+
+        from toolchainkit.toolchain.linker_benchmark import (
+            LinkerBenchmark,
+            LinkerSelectionCache,
+            link_command_from_ninja,
+            select_fastest,
+            toolchain_fingerprint,
+        )
+
+        if os.environ.get("TOOLCHAINKIT_LINKER_BENCHMARK", "1") == "0":
+            return None
+        if context.platform and not context.platform.startswith("linux"):
+            return None
+        compiler = self._resolve_compiler(context)
+        if compiler is None:
+            logger.debug("linker/auto: compiler not found, using declared speeds")
+            return None
+
+        if self.cache_path:
+            cache_file = Path(self.cache_path)
+        else:
+            from toolchainkit.core.directory import get_global_cache_dir
+
+            cache_file = get_global_cache_dir() / "linker-benchmark.json"
+        cache = LinkerSelectionCache(cache_file)
+
+        options = dict(self.benchmark_options)
+        build_dir = options.pop("ninja_build_dir", None)
+        target = options.pop("ninja_target", None)
+        cpu_count = os.cpu_count() or 1
+
+        probe = LinkerBenchmark(
+            compiler, cache_file.parent, search_dirs=[compiler.parent]
+        )
+        linkers = probe.available_linkers(c.linker for c in self.candidates)
+        if not linkers:
+            return None
+        fingerprint = toolchain_fingerprint(compiler, linkers)
+        if build_dir and target:
+            fingerprint += "-" + target.replace("/", "_")
+
+        timings = cache.get(fingerprint, cpu_count)
+        if timings is None:
+            link_command = None
+            if build_dir and target:
+                link_command = link_command_from_ninja(Path(build_dir), target)
+            bench = LinkerBenchmark(
+                compiler,
+                cache_file.parent / "linker-benchmark" / fingerprint,
+                link_command=link_command,
+                link_cwd=Path(build_dir) if link_command else None,
+                search_dirs=[compiler.parent],
+                **options,
+            )
+            try:
+                timings = bench.run(linkers, cpu_count)
+            except Exception as e:
+                logger.warning(f"linker/auto: benchmark failed: {e}")
+                return None
+            cache.put(fingerprint, cpu_count, timings, compiler)
+
+        return select_fastest(timings, allowed={c.linker for c in compatible})
+
+
+def _selected_linker_features(
+    context: LayerContext, linkers: List[LinkerLayer]
+) -> Tuple[str, Dict[str, bool]]:
+    """Name and feature map of the linker selected by the link flags.
+
+    Args:
+        context: Context whose ``-fuse-ld=`` flag selects the linker
+        linkers: Linker layers describing linker features
+
+    Returns:
+        (linker name, features); the features are empty for unknown linkers
+    """
+    selected = "ld"
+    for flag in context.link_flags:
+        if flag.startswith("-fuse-ld="):
+            selected = flag.split("=", 1)[1]
+    if selected == "bfd":
+        selected = "ld"
+    for linker in linkers:
+        if selected in (linker.linker, linker.flag.split("=")[-1]):
+            return linker.linker, linker.features
+    return selected, {}
+
+
+class DebugInfoLayer(ConfigLayer):
+    """Debug information layer (split DWARF, gdb index, compressed sections).
+
+    Enables each requested feature that the toolchain supports, as declared
+    under ``features.debug_info`` in the compiler YAML files
+    (``data/compilers/*.yaml``) and the ``features`` map of the linker layers.
+    Unsupported features are skipped, so the layer can be combined with any
+    compiler, platform and build type.
+
+    Applied after the linker layers so it sees the final linker.
+
+    Attributes:
+        enable: Requested features (split_dwarf, gdb_index)
+        compression: Section compression codecs in order of preference
+        dwp: Export the dwp packaging tool to CMake (split DWARF only)
+        linkers: Linker layers used to look up linker feature support
+        compilers_dir: Data directory containing ``compilers/*.yaml``
+        enabled: Features enabled by the last apply()
+    """
+
+    apply_phase = 2
+
+    def __init__(
+        self,
+        name: str,
+        enable: Optional[List[str]] = None,
+        compression: Optional[List[str]] = None,
+        dwp: bool = False,
+        linkers: Optional[List[LinkerLayer]] = None,
+        compilers_dir: Optional[Any] = None,
+        description: str = "",
+    ):
+        """Initialize debug information layer.
+
+        Args:
+            name: Layer name (e.g., "fast")
+            enable: Features to enable (split_dwarf, gdb_index)
+            compression: Compression codecs to try in order (zstd, zlib)
+            dwp: Export TOOLCHAINKIT_DWP for packaging split DWARF
+            linkers: Linker layers describing linker features
+            compilers_dir: Data directory with compiler YAML files
+            description: Human-readable description
+        """
+        super().__init__(name, "debuginfo", description or f"Debug info: {name}")
+        self.enable = enable or []
+        self.compression = compression or []
+        self.dwp = dwp
+        self.linkers = linkers or []
+        self.compilers_dir = compilers_dir
+        self.enabled: List[str] = []
+
+    def apply(self, context: LayerContext) -> None:
+        """Apply supported debug information features to context."""
+        self.enabled = []
+        if not any(f.startswith("-g") and f != "-g0" for f in context.compile_flags):
+            logger.info(f"debuginfo/{self.name}: no debug info enabled, skipping")
+        else:
+            compiler = self._load_compiler(context)
+            if compiler is not None:
+                self._apply_features(context, compiler)
+
+        context.add_flags(
+            compile=self._compile_flags,
+            link=self._link_flags,
+            common=self._common_flags,
+        )
+        context.add_defines(self._defines)
+        context.add_cmake_variables(self._cmake_variables)
+        context.add_runtime_env(self._runtime_env)
+        context.layer_types.add(self.layer_type)
+        context.applied_layers.append(self)
+
+    def _load_compiler(self, context: LayerContext) -> Optional[Any]:
+        """Load the compiler YAML configuration for the context's compiler."""
+        from pathlib import Path
+
+        from toolchainkit.cmake.yaml_compiler import (
+            YAMLCompilerError,
+            YAMLCompilerLoader,
+        )
+
+        if not context.compiler:
+            return None
+        data_dir = self.compilers_dir or Path(__file__).parent.parent / "data"
+        try:
+            return YAMLCompilerLoader(data_dir).load(context.compiler, context.platform)
+        except YAMLCompilerError as e:
+            logger.debug(f"debuginfo/{self.name}: no compiler capabilities: {e}")
+            return None
+
+    def _linker_features(self, context: LayerContext) -> Dict[str, bool]:
+        """Feature map of the linker selected by the link flags."""
+        return _selected_linker_features(context, self.linkers)[1]
+
+    def _apply_features(self, context: LayerContext, compiler: Any) -> None:
+        """Add flags for every requested feature the toolchain supports."""
+        target_os = context.platform.split("-")[0] if context.platform else None
+        linker_features = self._linker_features(context)
+
+        def supported(feature: str) -> Optional[Dict[str, Any]]:
+            flags = compiler.get_debug_info_flags(feature, context.compiler_version)
+            if flags is None:
+                return None
+            platforms = flags["supported_platforms"]
+            if target_os and platforms and target_os not in platforms:
+                return None
+            if flags["linker_feature"] and not linker_features.get(
+                flags["linker_feature"], False
+            ):
+                return None
+            return flags
+
+        requested = list(self.enable)
+        # First supported codec wins
+        for codec in self.compression:
+            if supported(f"compress_{codec}"):
+                requested.append(f"compress_{codec}")
+                break
+
+        for feature in requested:
+            flags = supported(feature)
+            if flags is None:
+                logger.info(f"debuginfo/{self.name}: {feature} not supported, skipped")
+                continue
+            context.add_flags(
+                compile=[
+                    f for f in flags["compile_flags"] if f not in context.compile_flags
+                ],
+                link=[f for f in flags["link_flags"] if f not in context.link_flags],
+            )
+            self.enabled.append(feature)
+            if feature == "split_dwarf" and self.dwp and flags["tool"]:
+                context.add_cmake_variables({"TOOLCHAINKIT_DWP": flags["tool"]})
+
+
+class StartupLayer(ConfigLayer):
+    """Startup and dynamic-linking layer for shipped binaries.
+
+    Cuts the time executables spend in the dynamic loader: fewer exported and
+    interposable symbols, faster symbol lookup, packed relative relocations
+    and a choice between lazy and immediate binding. Every link option is
+    checked against the ``features`` map of the selected linker layer and
+    skipped where unsupported; options only apply to ELF targets built with
+    GCC or Clang.
+
+    Shared-library-only and executable-only link flags are exported as
+    TOOLCHAINKIT_SHARED_LINKER_FLAGS and TOOLCHAINKIT_EXE_LINKER_FLAGS, which
+    the generated toolchain file appends to the matching CMake flags.
+
+    Applied after the linker layers so it sees the final linker.
+
+    Attributes:
+        visibility: Default symbol visibility ("hidden") or None
+        semantic_interposition: False adds -fno-semantic-interposition
+        bsymbolic_functions: Bind function references within shared libraries
+        hash_style: Symbol hash table style ("gnu", "both") or None
+        binding: "now", "lazy" or None (linker default)
+        relr: Pack relative relocations (needs glibc 2.36+ at run time)
+        static_pie: Link executables as static PIE
+        linkers: Linker layers used to look up linker feature support
+        enabled: Options enabled by the last apply()
+    """
+
+    apply_phase = 2
+
+    # Linker feature needed by each link option
+    LINK_FEATURES = {
+        "bsymbolic_functions": "bsymbolic_functions",
+        "hash_style": "hash_style",
+        "binding": "bind_now",
+        "relr": "relr",
+        "static_pie": "static_pie",
+    }
+
+    # lld before 15 has no -z pack-relative-relocs
+    RELR_FLAGS = {"lld": "-Wl,--pack-dyn-relocs=relr"}
+    DEFAULT_RELR_FLAG = "-Wl,-z,pack-relative-relocs"
+
+    def __init__(
+        self,
+        name: str,
+        visibility: Optional[str] = None,
+        semantic_interposition: bool = True,
+        bsymbolic_functions: bool = False,
+        hash_style: Optional[str] = None,
+        binding: Optional[str] = None,
+        relr: bool = False,
+        static_pie: bool = False,
+        linkers: Optional[List[LinkerLayer]] = None,
+        description: str = "",
+    ):
+        """Initialize startup layer.
+
+        Args:
+            name: Layer name (e.g., "startup")
+            visibility: Default symbol visibility ("hidden") or None
+            semantic_interposition: False adds -fno-semantic-interposition
+            bsymbolic_functions: Add -Bsymbolic-functions to shared libraries
+            hash_style: --hash-style value ("gnu", "both") or None
+            binding: "now" (-z now), "lazy" (-z lazy) or None
+            relr: Pack relative relocations (RELR)
+            static_pie: Link executables with -static-pie
+            linkers: Linker layers describing linker features
+            description: Human-readable description
+
+        Raises:
+            ValueError: If binding is not "now", "lazy" or None
+        """
+        super().__init__(name, "optimization", description or f"Startup: {name}")
+        if binding not in (None, "now", "lazy"):
+            raise ValueError(f"Invalid binding '{binding}' (expected now or lazy)")
+        self.visibility = visibility
+        self.semantic_interposition = semantic_interposition
+        self.bsymbolic_functions = bsymbolic_functions
+        self.hash_style = hash_style
+        self.binding = binding
+        self.relr = relr
+        self.static_pie = static_pie
+        self.linkers = linkers or []
+        self.enabled: List[str] = []
+
+    def apply(self, context: LayerContext) -> None:
+        """Apply supported startup options to context."""
+        self.enabled = []
+        target_os = context.platform.split("-")[0] if context.platform else None
+        if context.compiler not in ("gcc", "clang"):
+            logger.info(
+                f"optimization/{self.name}: {context.compiler} not supported, skipping"
+            )
+        elif target_os in ("windows", "macos"):
+            # Mach-O and PE: only symbol visibility applies
+            self._apply_compile_options(context, elf=False)
+        else:
+            self._apply_compile_options(context, elf=True)
+            self._apply_link_options(context)
+
+        context.add_flags(
+            compile=self._compile_flags,
+            link=self._link_flags,
+            common=self._common_flags,
+        )
+        context.add_defines(self._defines)
+        context.add_cmake_variables(self._cmake_variables)
+        context.add_runtime_env(self._runtime_env)
+        context.layer_types.add(self.layer_type)
+        context.applied_layers.append(self)
+
+    def _add_compile(self, context: LayerContext, flags: List[str]) -> None:
+        context.add_flags(compile=[f for f in flags if f not in context.compile_flags])
+
+    def _apply_compile_options(self, context: LayerContext, elf: bool) -> None:
+        """Add visibility and interposition flags."""
+        if self.visibility:
+            flags = [f"-fvisibility={self.visibility}"]
+            if self.visibility == "hidden":
+                flags.append("-fvisibility-inlines-hidden")
+            self._add_compile(context, flags)
+            self.enabled.append("visibility")
+        if not self.semantic_interposition and elf:
+            self._add_compile(context, ["-fno-semantic-interposition"])
+            self.enabled.append("semantic_interposition")
+
+    def _apply_link_options(self, context: LayerContext) -> None:
+        """Add every requested link option the selected linker supports."""
+        linker, features = _selected_linker_features(context, self.linkers)
+        shared: List[str] = []
+        exe: List[str] = []
+        link: List[str] = []
+
+        requested = {
+            "bsymbolic_functions": self.bsymbolic_functions,
+            "hash_style": self.hash_style,
+            "binding": self.binding,
+            "relr": self.relr,
+            "static_pie": self.static_pie,
+        }
+        for option, value in requested.items():
+            if not value:
+                continue
+            if not features.get(self.LINK_FEATURES[option], False):
+                logger.info(
+                    f"optimization/{self.name}: {option} not supported by "
+                    f"linker '{linker}', skipped"
+                )
+                continue
+            if option == "bsymbolic_functions":
+                shared.append("-Wl,-Bsymbolic-functions")
+            elif option == "hash_style":
+                link.append(f"-Wl,--hash-style={value}")
+            elif option == "binding":
+                if value == "lazy" and "-Wl,-z,now" in context.link_flags:
+                    # An earlier layer (e.g. security/relro-full) asked for now
+                    logger.info(
+                        f"optimization/{self.name}: -z now already set, "
+                        "keeping immediate binding"
+                    )
+                    continue
+                link.append(f"-Wl,-z,{value}")
+            elif option == "relr":
+                link.append(self.RELR_FLAGS.get(linker, self.DEFAULT_RELR_FLAG))
+            elif option == "static_pie":
+                if context.sanitizers:
+                    logger.info(
+                        f"optimization/{self.name}: static PIE does not work "
+                        "with sanitizers, skipped"
+                    )
+                    continue
+                exe.append("-static-pie")
+                context.add_cmake_variables({"CMAKE_POSITION_INDEPENDENT_CODE": "ON"})
+            self.enabled.append(option)
+
+        context.add_flags(link=[f for f in link if f not in context.link_flags])
+        if shared:
+            context.add_cmake_variables(
+                {"TOOLCHAINKIT_SHARED_LINKER_FLAGS": " ".join(shared)}
+            )
+        if exe:
+            context.add_cmake_variables(
+                {"TOOLCHAINKIT_EXE_LINKER_FLAGS": " ".join(exe)}
+            )
@@ -58,6 +58,8 @@ class LockedComponent:
         version: Component version (optional)
         verified: Whether component has been verified
         verification_date: ISO 8601 timestamp of verification
+        tree_sha256: Digest of the installed files (core.manifest.tree_digest),
+            checked when the component is imported from an offline bundle
     """
 
     url: str
@@ -66,6 +68,7 @@ class LockedComponent:
     version: Optional[str] = None
     verified: bool = False
     verification_date: Optional[str] = None
+    tree_sha256: Optional[str] = None
 
     def to_dict(self) -> dict:
         """Convert to dictionary for YAML serialization."""
@@ -80,6 +83,8 @@ class LockedComponent:
             data["verified"] = self.verified
         if self.verification_date is not None:
             data["verification_date"] = self.verification_date
+        if self.tree_sha256 is not None:
+            data["tree_sha256"] = self.tree_sha256
         return data
 
     @staticmethod
@@ -92,6 +97,7 @@ class LockedComponent:
             version=data.get("version"),
             verified=data.get("verified", False),
             verification_date=data.get("verification_date"),
+            tree_sha256=data.get("tree_sha256"),
         )
 
 
@@ -106,6 +112,7 @@ class LockFile:
         platform: Platform string (e.g., 'linux-x64-glibc')
         toolchains: Dict of toolchain_id -> LockedComponent
         build_tools: Dict of tool_name -> LockedComponent
+        sysroots: Dict of sysroot target -> LockedComponent (version required)
         packages: Dict of package_name -> package info
         metadata: Additional metadata
     """
@@ -115,6 +122,7 @@ class LockFile:
     platform: Optional[str] = None
     toolchains: Dict[str, LockedComponent] = field(default_factory=dict)
     build_tools: Dict[str, LockedComponent] = field(default_factory=dict)
+    sysroots: Dict[str, LockedComponent] = field(default_factory=dict)
     packages: Dict[str, dict] = field(default_factory=dict)
     metadata: dict = field(default_factory=dict)
 
@@ -138,6 +146,12 @@ class LockFile:
         for name, component in self.build_tools.items():
             data["build_tools"][name] = component.to_dict()  # type: ignore[index]
 
+        # Sysroots are only written when present (older lock files have none)
+        if self.sysroots:
+            data["sysroots"] = {
+                name: component.to_dict() for name, component in self.sysroots.items()
+            }
+
         return data
 
     @staticmethod
@@ -153,12 +167,18 @@ class LockFile:
         for name, comp_data in data.get("build_tools", {}).items():
             build_tools[name] = LockedComponent.from_dict(comp_data)
 
+        sysroots = {
+            name: LockedComponent.from_dict(comp_data)
+            for name, comp_data in (data.get("sysroots") or {}).items()
+        }
+
         return LockFile(
             version=data.get("version", 1),
             generated=data.get("generated"),
             platform=data.get("platform"),
             toolchains=toolchains,
             build_tools=build_tools,
+            sysroots=sysroots,
             packages=data.get("packages", {}),
             metadata=data.get("metadata", {}),
         )
@@ -233,7 +253,8 @@ class LockFileManager:
             config: Parsed configuration (ToolchainKitConfig)
             platform: Current platform info (PlatformInfo)
             toolchain_info: Dict of toolchain_id -> component info
-                           (must include: url, sha256, size_bytes, version)
+                           (must include: url, sha256, size_bytes, version;
+                           optional: tree_sha256)
             build_tools_info: Dict of tool_name -> component info (optional)
 
         Returns:
@@ -265,6 +286,7 @@ class LockFileManager:
                 version=info.get("version"),
                 verified=True,
                 verification_date=datetime.now().isoformat(),
+                tree_sha256=info.get("tree_sha256"),
             )
             logger.debug(f"Added toolchain to lock file: {toolchain_id}")
 
@@ -278,6 +300,7 @@ class LockFileManager:
                     version=info.get("version"),
                     verified=True,
                     verification_date=datetime.now().isoformat(),
+                    tree_sha256=info.get("tree_sha256"),
                 )
                 logger.debug(f"Added build tool to lock file: {tool_name}")
 
@@ -348,12 +371,17 @@ class LockFileManager:
                 f"The lock file may be corrupted or in an invalid format."
             ) from e
 
-    def verify(self, lock: LockFile) -> tuple[bool, list[str]]:
+    def verify(self, lock: LockFile, deep: bool = False) -> tuple[bool, list[str]]:
         """
         Verify current installation matches lock file.
 
+        Installed toolchains and tools are checked against the integrity
+        manifest written at install time. Only files whose size or mtime
+        changed are re-hashed unless ``deep`` is set.
+
         Args:
             lock: Lock file to verify against
+            deep: Re-hash every installed file instead of trusting stat data
 
         Returns:
             Tuple of (verified: bool, issues: list[str])
@@ -365,19 +393,32 @@ class LockFileManager:
             ...     for issue in issues:
             ...         print(f"⚠ {issue}")
         """
+        from toolchainkit.core.manifest import (
+            IntegrityManifest,
+            ManifestError,
+            find_manifest,
+        )
+
         issues = []
 
         # Verify toolchains
-        for toolchain_id, expected in lock.toolchains.items():
+        registry = None
+        if lock.toolchains:
             try:
                 from toolchainkit.core.cache_registry import ToolchainCacheRegistry
                 from toolchainkit.core.directory import get_global_cache_dir
 
-                # Get installed toolchain
-                cache_dir = get_global_cache_dir()
-                registry_file = cache_dir / "registry.json"
+                registry_file = get_global_cache_dir() / "registry.json"
                 registry = ToolchainCacheRegistry(registry_file)
+            except ImportError:
+                logger.warning(
+                    "Registry module not available, skipping toolchain verification"
+                )
 
+        for toolchain_id, expected in lock.toolchains.items():
+            if registry is None:
+                break
+            try:
                 info = registry.get_toolchain_info(toolchain_id)
 
                 if not info:
@@ -396,11 +437,25 @@ class LockFileManager:
                         f"  Got: {installed_hash}\n"
                         f"  This may indicate tampering or incorrect installation."
                     )
+                    continue
 
-            except ImportError:
-                logger.warning(
-                    "Registry module not available, skipping toolchain verification"
-                )
+                # Verify installed files against the install-time manifest
+                install_path = info.get("path")
+                if not isinstance(install_path, str):
+                    continue
+                manifest = IntegrityManifest.load(Path(install_path))
+                if manifest is None:
+                    continue
+                result = manifest.verify(deep=deep)
+                if not result.ok:
+                    issues.append(
+                        f"Toolchain files changed: {toolchain_id}\n"
+                        f"  {result.summary()}\n"
+                        f"  This may indicate tampering or a damaged installation."
+                    )
+
+            except ManifestError as e:
+                issues.append(f"Toolchain manifest unreadable: {toolchain_id}: {e}")
             except Exception as e:
                 logger.warning(f"Error verifying toolchain {toolchain_id}: {e}")
 
@@ -415,11 +470,17 @@ class LockFileManager:
                 )
                 continue
 
-            # Verify hash
+            # Verify hash (from the tool's manifest when its stat data is unchanged)
             try:
                 from toolchainkit.core.verification import compute_file_hash
 
-                actual_hash = compute_file_hash(tool_path, algorithm="sha256")
+                actual_hash = None
+                if not deep:
+                    manifest = find_manifest(tool_path, stop_at=tool_path.parent)
+                    if manifest is not None:
+                        actual_hash = manifest.file_hash(tool_path)
+                if actual_hash is None:
+                    actual_hash = compute_file_hash(tool_path, algorithm="sha256")
                 if (
                     f"sha256:{actual_hash}" != expected.sha256
                     and actual_hash != expected.sha256
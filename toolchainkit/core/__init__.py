@@ -4,36 +4,6 @@ Core functionality for ToolchainKit.
 This package contains the foundational modules that other components depend on.
 """
 
-from .directory import (
-    get_global_cache_dir,
-    get_project_local_dir,
-    ensure_global_cache_structure,
-    ensure_project_structure,
-    update_gitignore,
-    verify_directory_writable,
-    create_directory_structure,
-    DirectoryError,
-)
-
-from .locking import (
-    LockManager,
-    DownloadCoordinator,
-    try_lock,
-    LockTimeout,
-)
-
-from .platform import (
-    PlatformInfo,
-    detect_platform,
-    is_supported_platform,
-    get_supported_platforms,
-    clear_platform_cache,
-)
-
-from .cache_registry import (
-    ToolchainCacheRegistry,
-)
-
 from .exceptions import (
     ToolchainKitError,
     RegistryError,
@@ -56,6 +26,41 @@ from .exceptions import (
     PluginLoadError,
     PluginValidationError,
 )
+from .lazy import lazy_exports
+
+# Submodules are imported when one of their names is first used (keeps
+# `tkgen` startup from importing filelock and requests)
+__getattr__, __dir__ = lazy_exports(
+    __name__,
+    {
+        ".directory": [
+            "get_global_cache_dir",
+            "get_project_local_dir",
+            "ensure_global_cache_structure",
+            "ensure_project_structure",
+            "update_gitignore",
+            "verify_directory_writable",
+            "create_directory_structure",
+            "DirectoryError",
+        ],
+        ".locking": [
+            "LockManager",
+            "DownloadCoordinator",
+            "try_lock",
+            "LockTimeout",
+        ],
+        ".platform": [
+            "PlatformInfo",
+            "detect_platform",
+            "is_supported_platform",
+            "get_supported_platforms",
+            "clear_platform_cache",
+        ],
+        ".cache_registry": [
+            "ToolchainCacheRegistry",
+        ],
+    },
+)
 
 __all__ = [
     "get_global_cache_dir",
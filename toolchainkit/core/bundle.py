@@ -0,0 +1,778 @@
+"""
+Offline bundles of installed toolchains, build tools and sysroots.
+
+A bundle is one seekable file holding several installation trees, for
+air-gapped machines and ephemeral CI runners that should not download
+toolchains on every job. Every file is split into independently compressed
+frames (zstd when the ``zstandard`` package is installed, zlib otherwise),
+followed by a JSON index of all components, files and frame offsets, and a
+fixed-size trailer pointing at the index::
+
+    TKBNDL01 | frame | frame | ... | index (zlib JSON) | index offset, length, TKBNDL01
+
+Because each frame can be located and decompressed on its own, import reads
+the index once and unpacks files in parallel straight into their final
+location, without an intermediate archive extraction. The SHA256 of every
+file is recorded at export and checked while unpacking. Single files, or the
+members matching a filter, can be read without decoding anything else.
+
+Besides installation trees, a component can hold a transcoded tar or zip
+archive (``add_archive()``); the downloader uses this to keep downloaded
+toolchain archives in a form that re-extracts in parallel.
+
+Example:
+    >>> from toolchainkit.core.bundle import BundleReader, BundleWriter
+    >>> with BundleWriter(Path("toolchains.tkb")) as writer:
+    ...     writer.add_tree("toolchain", "llvm-18.1.8-linux-x64",
+    ...                     cache_dir / "toolchains" / "llvm-18.1.8-linux-x64",
+    ...                     root="toolchains/llvm-18.1.8-linux-x64")
+    >>> reader = BundleReader(Path("toolchains.tkb"))
+    >>> for component in reader.components:
+    ...     reader.extract(component, cache_dir / component.root)
+"""
+
+import json
+import logging
+import os
+import stat
+import struct
+import tarfile
+import threading
+import zipfile
+import zlib
+from collections import deque
+from concurrent.futures import ThreadPoolExecutor
+from dataclasses import dataclass, field
+from datetime import datetime, timezone
+from pathlib import Path
+from typing import Callable, Dict, List, Optional, Tuple
+
+from .hashing import new_hasher
+from .manifest import MANIFEST_NAME
+
+logger = logging.getLogger(__name__)
+
+BUNDLE_MAGIC = b"TKBNDL01"
+"""Leading and trailing file signature."""
+
+BUNDLE_VERSION = 1
+
+FRAME_SIZE = 4 * 1024 * 1024
+"""Uncompressed bytes per frame."""
+
+_TRAILER = struct.Struct("<QQ8s")
+"""Index offset, index length, magic."""
+
+CODECS = ("zstd", "zlib")
+_DEFAULT_LEVELS = {"zstd": 3, "zlib": 6}
+
+
+class BundleError(Exception):
+    """Raised when a bundle cannot be written, read or unpacked."""
+
+    pass
+
+
+def _zstd_module():
+    """Return the zstandard module if installed, else None."""
+    try:
+        import zstandard  # type: ignore[import-not-found]
+
+        return zstandard
+    except ImportError:
+        return None
+
+
+def default_codec() -> str:
+    """Best available frame codec: 'zstd' if zstandard is installed, else 'zlib'."""
+    return "zstd" if _zstd_module() is not None else "zlib"
+
+
+@dataclass
+class BundleFile:
+    """One regular file inside a bundle component."""
+
+    path: str
+    """POSIX path relative to the component root."""
+
+    size: int
+    mode: int
+    sha256: str
+    frames: List[Tuple[int, int]] = field(default_factory=list)
+    """(offset, compressed length) of each frame, in order."""
+
+
+@dataclass
+class BundleComponent:
+    """One installation tree inside a bundle."""
+
+    kind: str
+    """'toolchain', 'tool' or 'sysroot'."""
+
+    name: str
+    """Toolchain ID, tool name or sysroot key (as in the lock file)."""
+
+    root: str
+    """Install location relative to the global cache directory."""
+
+    sha256: str = ""
+    """Lock file hash the tree was exported for."""
+
+    metadata: Dict[str, str] = field(default_factory=dict)
+    files: List[BundleFile] = field(default_factory=list)
+    dirs: List[str] = field(default_factory=list)
+    links: List[Tuple[str, str]] = field(default_factory=list)
+    """(path, target) of symbolic links."""
+
+    @property
+    def total_size(self) -> int:
+        """Uncompressed size of all files in bytes."""
+        return sum(f.size for f in self.files)
+
+    @property
+    def compressed_size(self) -> int:
+        """Size of all frames in the bundle in bytes."""
+        return sum(length for f in self.files for _, length in f.frames)
+
+    def to_dict(self) -> dict:
+        """Convert to the index representation."""
+        return {
+            "kind": self.kind,
+            "name": self.name,
+            "root": self.root,
+            "sha256": self.sha256,
+            "metadata": self.metadata,
+            "dirs": self.dirs,
+            "links": [list(link) for link in self.links],
+            "files": [
+                [f.path, f.size, f.mode, f.sha256, [list(fr) for fr in f.frames]]
+                for f in self.files
+            ],
+        }
+
+    @staticmethod
+    def from_dict(data: dict) -> "BundleComponent":
+        """Create from the index representation."""
+        return BundleComponent(
+            kind=data["kind"],
+            name=data["name"],
+            root=data["root"],
+            sha256=data.get("sha256", ""),
+            metadata=data.get("metadata", {}),
+            dirs=list(data.get("dirs", [])),
+            links=[(path, target) for path, target in data.get("links", [])],
+            files=[
+                BundleFile(path, size, mode, sha256, [tuple(fr) for fr in frames])
+                for path, size, mode, sha256, frames in data["files"]
+            ],
+        )
+
+
+class _Codec:
+    """Frame compressor/decompressor (thread-safe: one context per thread)."""
+
+    def __init__(self, name: str, level: Optional[int] = None):
+        if name not in CODECS:
+            raise BundleError(
+                f"Invalid codec: {name}. Must be one of: {', '.join(CODECS)}"
+            )
+        self.name = name
+        self.level = _DEFAULT_LEVELS[name] if level is None else level
+        self._zstd = _zstd_module() if name == "zstd" else None
+        if name == "zstd" and self._zstd is None:
+            raise BundleError("zstd bundles require the 'zstandard' package")
+        self._local = threading.local()
+
+    def compress(self, data: bytes) -> bytes:
+        if self._zstd is None:
+            return zlib.compress(data, self.level)
+        if not hasattr(self._local, "cctx"):
+            self._local.cctx = self._zstd.ZstdCompressor(level=self.level)
+        return self._local.cctx.compress(data)
+
+    def decompress(self, data: bytes, size: int) -> bytes:
+        try:
+            if self._zstd is None:
+                return zlib.decompress(data, bufsize=max(size, 1))
+            if not hasattr(self._local, "dctx"):
+                self._local.dctx = self._zstd.ZstdDecompressor()
+            return self._local.dctx.decompress(data, max_output_size=size)
+        except Exception as e:
+            raise BundleError(f"Corrupt {self.name} frame: {e}") from e
+
+
+def _walk_tree(root: Path):
+    """Yield ('dir'|'link'|'file', relative POSIX path, lstat) below root."""
+    stack = [root]
+    while stack:
+        directory = stack.pop()
+        with os.scandir(directory) as entries:
+            entries = sorted(entries, key=lambda e: e.name)
+        for entry in entries:
+            path = Path(entry.path)
+            rel = path.relative_to(root).as_posix()
+            st = entry.stat(follow_symlinks=False)
+            if stat.S_ISLNK(st.st_mode):
+                yield "link", rel, st
+            elif stat.S_ISDIR(st.st_mode):
+                yield "dir", rel, st
+                stack.append(path)
+            elif rel != MANIFEST_NAME:
+                yield "file", rel, st
+
+
+def _check_member_path(rel: str) -> None:
+    """
+    Refuse member paths that would escape the destination.
+
+    The check is lexical; _check_parents() keeps members from being written
+    through symbolic links, which links unpacked earlier (or already in the
+    destination) could otherwise redirect anywhere.
+    """
+    parts = rel.replace("\\", "/").split("/")
+    if not rel or rel.startswith(("/", "\\")) or ":" in parts[0] or ".." in parts:
+        raise BundleError(
+            f"Bundle member '{rel}' attempts directory traversal. "
+            "This is a security risk and extraction has been blocked."
+        )
+
+
+def _check_link_target(rel: str, target: str) -> None:
+    """Refuse link targets that are absolute or point outside the destination."""
+    target = target.replace("\\", "/")
+    parts = rel.replace("\\", "/").split("/")[:-1]
+    for part in target.split("/"):
+        if part == "..":
+            if not parts:
+                break
+            parts.pop()
+        elif part not in ("", "."):
+            parts.append(part)
+    else:
+        if not target.startswith("/") and ":" not in target.split("/")[0]:
+            return
+    raise BundleError(
+        f"Bundle link '{rel}' points outside the destination ({target}). "
+        "This is a security risk and extraction has been blocked."
+    )
+
+
+def _check_parents(destination: Path, rel: str, include_self: bool = False) -> None:
+    """Refuse members whose path below destination passes through a symlink."""
+    parts = rel.replace("\\", "/").split("/")
+    path = destination
+    for part in parts if include_self else parts[:-1]:
+        path = path / part
+        if path.is_symlink():
+            raise BundleError(
+                f"Bundle member '{rel}' would be written through the symbolic "
+                f"link {path}. Extraction has been blocked."
+            )
+
+
+def _member_name(name: str) -> str:
+    """Archive member name as a component path ('' for the archive root)."""
+    while name.startswith("./"):
+        name = name[2:]
+    return name.rstrip("/") if name != "." else ""
+
+
+def _reader(handle):
+    """Positional read function for a file shared by several threads."""
+    if hasattr(os, "pread"):
+        fd = handle.fileno()
+        return lambda offset, length: os.pread(fd, length, offset)
+
+    lock = threading.Lock()
+
+    def read_at(offset: int, length: int) -> bytes:
+        with lock:
+            handle.seek(offset)
+            return handle.read(length)
+
+    return read_at
+
+
+class BundleWriter:
+    """
+    Write installation trees into a bundle.
+
+    Example:
+        >>> with BundleWriter(Path("ci.tkb"), workers=4) as writer:
+        ...     writer.add_tree("tool", "ninja", tools_dir / "ninja" / "1.11.1",
+        ...                     root="tools/ninja/1.11.1")
+    """
+
+    def __init__(
+        self,
+        path: Path,
+        codec: Optional[str] = None,
+        level: Optional[int] = None,
+        workers: Optional[int] = None,
+        frame_size: int = FRAME_SIZE,
+    ):
+        """
+        Initialize bundle writer (creates the file).
+
+        Args:
+            path: Bundle file to write
+            codec: 'zstd' or 'zlib' (default: best available)
+            level: Compression level (default: codec-specific)
+            workers: Compression threads (default: CPU count)
+            frame_size: Uncompressed bytes per frame
+
+        Raises:
+            BundleError: If the codec is unknown or unavailable
+        """
+        self.path = Path(path)
+        self.codec = _Codec(codec or default_codec(), level)
+        self.workers = workers or os.cpu_count() or 1
+        self.frame_size = frame_size
+        self.components: List[BundleComponent] = []
+
+        self.path.parent.mkdir(parents=True, exist_ok=True)
+        self._file = open(self.path, "wb")
+        self._file.write(BUNDLE_MAGIC)
+        self._pool = ThreadPoolExecutor(max_workers=self.workers)
+        self._queued = 0
+
+    def __enter__(self) -> "BundleWriter":
+        return self
+
+    def __exit__(self, exc_type, exc, tb):
+        if exc_type is None:
+            self.close()
+        else:
+            self.abort()
+
+    def add_tree(
+        self,
+        kind: str,
+        name: str,
+        source: Path,
+        root: str,
+        sha256: str = "",
+        metadata: Optional[Dict[str, str]] = None,
+    ) -> BundleComponent:
+        """
+        Add an installation directory (or a single file) as a component.
+
+        Files are compressed in parallel and written in order.
+
+        Args:
+            kind: Component kind ('toolchain', 'tool', 'sysroot')
+            name: Component name
+            source: Directory (or file) to add
+            root: Install location relative to the cache directory
+            sha256: Lock file hash of the component
+            metadata: Extra string fields stored in the index
+
+        Returns:
+            Added component
+        """
+        source = Path(source)
+        component = BundleComponent(kind, name, root, sha256, dict(metadata or {}))
+
+        if source.is_file():
+            entries = [("file", source.name, source.stat())]
+            base = source.parent
+        else:
+            entries = list(_walk_tree(source))
+            base = source
+
+        window: deque = deque()
+        for entry_kind, rel, st in entries:
+            if entry_kind == "dir":
+                component.dirs.append(rel)
+            elif entry_kind == "link":
+                component.links.append((rel, os.readlink(base / rel)))
+            else:
+                future = self._pool.submit(self._compress_file, base / rel)
+                window.append((rel, st, future))
+                if len(window) >= self.workers * 4:
+                    self._write_file(component, *window.popleft())
+        while window:
+            self._write_file(component, *window.popleft())
+
+        self.components.append(component)
+        logger.debug(
+            f"Bundled {kind} {name}: {len(component.files)} files, "
+            f"{component.total_size / 1024**2:.1f} -> "
+            f"{component.compressed_size / 1024**2:.1f} MB"
+        )
+        return component
+
+    def add_archive(
+        self,
+        kind: str,
+        name: str,
+        archive: Path,
+        root: str,
+        sha256: str = "",
+        metadata: Optional[Dict[str, str]] = None,
+    ) -> BundleComponent:
+        """
+        Transcode a tar (plain, gzip, bzip2, xz) or zip archive into a component.
+
+        The archive is read once, sequentially; its frames are compressed on
+        the pool while reading continues. Member names (without a leading
+        './') become the component paths, so unpacking the component gives
+        the same tree as extracting the archive. Hard links are stored as
+        files sharing the frames of their target.
+
+        Args:
+            kind: Component kind
+            name: Component name
+            archive: Archive to transcode
+            root: Install location relative to the cache directory
+            sha256: SHA256 of the archive, kept for provenance
+            metadata: Extra string fields stored in the index
+
+        Returns:
+            Added component
+
+        Raises:
+            BundleError: If the archive cannot be read
+        """
+        archive = Path(archive)
+        component = BundleComponent(kind, name, root, sha256, dict(metadata or {}))
+        pending: deque = deque()
+        try:
+            if zipfile.is_zipfile(archive):
+                self._transcode_zip(component, archive, pending)
+            else:
+                self._transcode_tar(component, archive, pending)
+        except (OSError, tarfile.TarError, zipfile.BadZipFile, EOFError) as e:
+            raise BundleError(f"Cannot transcode {archive.name}: {e}") from e
+        self._drain(component, pending, 0)
+
+        self.components.append(component)
+        logger.debug(
+            f"Transcoded {archive.name}: {len(component.files)} files, "
+            f"{component.total_size / 1024**2:.1f} -> "
+            f"{component.compressed_size / 1024**2:.1f} MB"
+        )
+        return component
+
+    def _transcode_tar(
+        self, component: BundleComponent, archive: Path, pending: deque
+    ) -> None:
+        """Add the members of a tar archive, read as a stream."""
+        hardlinks = []
+        with tarfile.open(archive, "r|*") as tar:
+            for member in tar:
+                rel = _member_name(member.name)
+                if not rel:
+                    continue
+                if member.isdir():
+                    component.dirs.append(rel)
+                elif member.issym():
+                    component.links.append((rel, member.linkname))
+                elif member.islnk():
+                    hardlinks.append((rel, _member_name(member.linkname), member.mode))
+                elif member.isfile():
+                    entry = BundleFile(rel, member.size, stat.S_IMODE(member.mode), "")
+                    self._queue_stream(
+                        component, pending, entry, tar.extractfile(member)
+                    )
+
+        self._drain(component, pending, 0)
+        files = {entry.path: entry for entry in component.files}
+        for rel, target, mode in hardlinks:
+            source = files.get(target)
+            if source is None:
+                logger.warning(f"Skipping hard link {rel}: target {target} not found")
+                continue
+            component.files.append(
+                BundleFile(
+                    rel,
+                    source.size,
+                    stat.S_IMODE(mode),
+                    source.sha256,
+                    list(source.frames),
+                )
+            )
+
+    def _transcode_zip(
+        self, component: BundleComponent, archive: Path, pending: deque
+    ) -> None:
+        """Add the members of a zip archive."""
+        with zipfile.ZipFile(archive) as zf:
+            for info in zf.infolist():
+                rel = _member_name(info.filename)
+                if not rel:
+                    continue
+                if info.is_dir():
+                    component.dirs.append(rel)
+                    continue
+                mode = stat.S_IMODE(info.external_attr >> 16) or 0o644
+                entry = BundleFile(rel, info.file_size, mode, "")
+                with zf.open(info) as stream:
+                    self._queue_stream(component, pending, entry, stream)
+
+    def _queue_stream(
+        self, component: BundleComponent, pending: deque, entry: BundleFile, stream
+    ) -> None:
+        """Read a member frame by frame and queue the frames for compression."""
+        frames: deque = deque()
+        item = [entry, frames, False]
+        pending.append(item)
+        hasher = new_hasher("sha256")
+        while True:
+            data = stream.read(self.frame_size)
+            if not data:
+                break
+            hasher.update(data)
+            frames.append(self._pool.submit(self.codec.compress, data))
+            self._queued += 1
+            self._drain(component, pending, self.workers * 4)
+        entry.sha256 = hasher.hexdigest()
+        item[2] = True
+        self._drain(component, pending, self.workers * 4)
+
+    def _drain(self, component: BundleComponent, pending: deque, limit: int) -> None:
+        """Write queued frames in order until at most ``limit`` are in flight."""
+        while pending:
+            entry, frames, done = pending[0]
+            if frames and self._queued > limit:
+                frame = frames.popleft().result()
+                entry.frames.append((self._file.tell(), len(frame)))
+                self._file.write(frame)
+                self._queued -= 1
+            elif not frames and done:
+                component.files.append(entry)
+                pending.popleft()
+            else:
+                break
+
+    def _compress_file(self, path: Path) -> Tuple[List[bytes], str]:
+        """Compress one file into frames and hash it (runs on a pool thread)."""
+        hasher = new_hasher("sha256")
+        frames = []
+        with open(path, "rb") as f:
+            while True:
+                data = f.read(self.frame_size)
+                if not data:
+                    break
+                hasher.update(data)
+                frames.append(self.codec.compress(data))
+        return frames, hasher.hexdigest()
+
+    def _write_file(self, component: BundleComponent, rel: str, st, future) -> None:
+        """Append a compressed file's frames and record it in the index."""
+        frames, digest = future.result()
+        entry = BundleFile(rel, st.st_size, stat.S_IMODE(st.st_mode), digest)
+        for frame in frames:
+            entry.frames.append((self._file.tell(), len(frame)))
+            self._file.write(frame)
+        component.files.append(entry)
+
+    def close(self) -> None:
+        """Write the index and trailer and close the file."""
+        self._pool.shutdown()
+        index = {
+            "version": BUNDLE_VERSION,
+            "codec": self.codec.name,
+            "frame_size": self.frame_size,
+            "created": datetime.now(timezone.utc).isoformat(),
+            "components": [c.to_dict() for c in self.components],
+        }
+        data = zlib.compress(json.dumps(index, separators=(",", ":")).encode())
+        offset = self._file.tell()
+        self._file.write(data)
+        self._file.write(_TRAILER.pack(offset, len(data), BUNDLE_MAGIC))
+        self._file.close()
+
+    def abort(self) -> None:
+        """Close and delete a partially written bundle."""
+        self._pool.shutdown(cancel_futures=True)
+        self._file.close()
+        self.path.unlink(missing_ok=True)
+
+
+class BundleReader:
+    """
+    Read a bundle's index and unpack its components.
+
+    Example:
+        >>> reader = BundleReader(Path("ci.tkb"))
+        >>> component = reader.get("ninja")
+        >>> hashes = reader.extract(component, cache_dir / component.root)
+    """
+
+    def __init__(self, path: Path):
+        """
+        Open a bundle and read its index.
+
+        Args:
+            path: Bundle file
+
+        Raises:
+            BundleError: If the file is not a valid bundle
+        """
+        self.path = Path(path)
+        try:
+            with open(self.path, "rb") as f:
+                if f.read(len(BUNDLE_MAGIC)) != BUNDLE_MAGIC:
+                    raise BundleError(f"Not a ToolchainKit bundle: {self.path}")
+                f.seek(-_TRAILER.size, os.SEEK_END)
+                offset, length, magic = _TRAILER.unpack(f.read(_TRAILER.size))
+                if magic != BUNDLE_MAGIC:
+                    raise BundleError(f"Bundle is truncated: {self.path}")
+                f.seek(offset)
+                index = json.loads(zlib.decompress(f.read(length)))
+        except (OSError, struct.error, zlib.error, ValueError) as e:
+            raise BundleError(f"Cannot read bundle {self.path}: {e}") from e
+
+        if index.get("version") != BUNDLE_VERSION:
+            raise BundleError(
+                f"Unsupported bundle version {index.get('version')} in {self.path}"
+            )
+        self.codec = _Codec(index["codec"])
+        self.frame_size: int = index["frame_size"]
+        self.created: Optional[str] = index.get("created")
+        self.components = [BundleComponent.from_dict(c) for c in index["components"]]
+
+    def get(self, name: str, kind: Optional[str] = None) -> Optional[BundleComponent]:
+        """Find a component by name (and kind)."""
+        for component in self.components:
+            if component.name == name and kind in (None, component.kind):
+                return component
+        return None
+
+    def extract(
+        self,
+        component: BundleComponent,
+        destination: Path,
+        workers: Optional[int] = None,
+        member_filter: Optional[Callable[[str], bool]] = None,
+        progress_callback: Optional[Callable[[int, int], None]] = None,
+    ) -> Dict[str, str]:
+        """
+        Unpack a component into a directory, files in parallel.
+
+        Every file is checked against the SHA256 recorded at export.
+
+        Args:
+            component: Component to unpack
+            destination: Directory to unpack into (created if missing)
+            workers: Unpacking threads (default: CPU count)
+            member_filter: Optional predicate on component paths; entries
+                for which it returns False are skipped
+            progress_callback: Optional callback(bytes_done, bytes_total)
+
+        Returns:
+            Relative POSIX path -> SHA256 of every unpacked file
+
+        Raises:
+            BundleError: If a file is corrupt or cannot be written, or a
+                member or link target lies outside the destination
+        """
+        destination = Path(destination)
+        destination.mkdir(parents=True, exist_ok=True)
+        keep = member_filter or (lambda rel: True)
+        dirs = [rel for rel in component.dirs if keep(rel)]
+        files = [entry for entry in component.files if keep(entry.path)]
+        links = [(rel, target) for rel, target in component.links if keep(rel)]
+        for rel in dirs + [f.path for f in files] + [link for link, _ in links]:
+            _check_member_path(rel)
+        for rel, target in links:
+            _check_link_target(rel, target)
+
+        for rel in dirs:
+            _check_parents(destination, rel, include_self=True)
+            (destination / rel).mkdir(parents=True, exist_ok=True)
+        for entry in files:
+            _check_parents(destination, entry.path)
+            target = destination / entry.path
+            target.parent.mkdir(parents=True, exist_ok=True)
+            if target.is_symlink():
+                target.unlink()  # Replace the link, do not write through it
+
+        workers = workers or os.cpu_count() or 1
+        # Largest files first so they do not end up last on one thread
+        files.sort(key=lambda f: f.size, reverse=True)
+        total = sum(f.size for f in files)
+        done = 0
+        progress_lock = threading.Lock()
+        try:
+            with open(self.path, "rb") as bundle:
+                read_at = _reader(bundle)
+
+                def unpack(entry: BundleFile):
+                    nonlocal done
+                    self._extract_file(entry, destination, read_at)
+                    if progress_callback:
+                        with progress_lock:
+                            done += entry.size
+                            progress_callback(done, total)
+
+                if workers == 1 or len(files) <= 1:
+                    for entry in files:
+                        unpack(entry)
+                else:
+                    with ThreadPoolExecutor(max_workers=workers) as pool:
+                        list(pool.map(unpack, files))
+        except OSError as e:
+            raise BundleError(f"Failed to unpack {component.name}: {e}") from e
+
+        for rel, target in links:
+            link = destination / rel
+            _check_parents(destination, rel)
+            link.parent.mkdir(parents=True, exist_ok=True)
+            if link.is_symlink() or link.exists():
+                link.unlink()
+            os.symlink(target, link)
+
+        return {entry.path: entry.sha256 for entry in files}
+
+    def read(self, component: BundleComponent, path: str) -> bytes:
+        """
+        Read one file of a component, decoding only its own frames.
+
+        Args:
+            component: Component holding the file
+            path: POSIX path relative to the component root
+
+        Returns:
+            File content (checked against the recorded SHA256)
+
+        Raises:
+            BundleError: If the file is missing or corrupt
+        """
+        entry = next((f for f in component.files if f.path == path), None)
+        if entry is None:
+            raise BundleError(f"{component.name} has no file {path}")
+        with open(self.path, "rb") as bundle:
+            return b"".join(self._decode(entry, _reader(bundle)))
+
+    def _decode(self, entry: BundleFile, read_at):
+        """Yield the verified frames of a file."""
+        hasher = new_hasher("sha256")
+        remaining = entry.size
+        for offset, length in entry.frames:
+            expected = min(self.frame_size, remaining)
+            data = self.codec.decompress(read_at(offset, length), expected)
+            if len(data) != expected:
+                raise BundleError(f"Corrupt frame in {entry.path}")
+            hasher.update(data)
+            remaining -= expected
+            yield data
+        if remaining or hasher.hexdigest() != entry.sha256:
+            raise BundleError(
+                f"Checksum mismatch for {entry.path}: "
+                f"expected {entry.sha256}, got {hasher.hexdigest()}"
+            )
+
+    def _extract_file(self, entry: BundleFile, destination: Path, read_at) -> None:
+        """Decompress, verify and write one file (runs on a pool thread)."""
+        target = destination / entry.path
+        try:
+            with open(target, "wb") as out:
+                for data in self._decode(entry, read_at):
+                    out.write(data)
+        except BundleError:
+            target.unlink(missing_ok=True)
+            raise
+        if os.name != "nt":
+            os.chmod(target, entry.mode)
@@ -7,6 +7,7 @@ enabling multiple projects to share toolchains while tracking usage through refe
 
 import json
 import logging
+import threading
 from contextlib import contextmanager
 from datetime import datetime
 from pathlib import Path
@@ -14,6 +15,7 @@ from typing import Dict, List, Optional
 
 from filelock import FileLock, Timeout
 
+from toolchainkit.core import tracing
 from toolchainkit.core.directory import get_global_cache_dir
 from toolchainkit.core.filesystem import atomic_write
 from toolchainkit.core.exceptions import (
@@ -31,7 +33,10 @@ class ToolchainCacheRegistry:
     Manages global toolchain cache registry with thread-safe access.
 
     The registry tracks toolchain installations, project references, and metadata
-    to enable shared caching and safe cleanup of unused toolchains.
+    to enable shared caching and safe cleanup of unused toolchains. It also
+    keeps the size of every toolchain and cached artifact (downloaded
+    archives, sysroots), recorded once at install time, so cache usage is
+    known without walking the disk.
 
     Example:
         >>> registry = ToolchainCacheRegistry()
@@ -60,6 +65,8 @@ class ToolchainCacheRegistry:
         self.registry_path = Path(registry_path)
         self.lock_path = self.registry_path.parent / "lock" / "registry.lock"
         self.lock_timeout = lock_timeout
+        # Per-thread lock depth and open transaction
+        self._local = threading.local()
 
         logger.debug(f"Initialized registry at {self.registry_path}")
 
@@ -70,14 +77,13 @@ class ToolchainCacheRegistry:
         Returns:
             Registry data dictionary
         """
+        transaction = getattr(self._local, "transaction", None)
+        if transaction is not None:
+            return transaction["data"]
+
         if not self.registry_path.exists():
             logger.debug("Registry file not found, creating new registry")
-            return {
-                "version": 1,
-                "toolchains": {},
-                "total_size_mb": 0.0,
-                "last_cleanup": None,
-            }
+            return _empty_registry()
 
         try:
             with open(self.registry_path, "r", encoding="utf-8") as f:
@@ -86,13 +92,9 @@ class ToolchainCacheRegistry:
             # Validate registry format
             if "version" not in data or "toolchains" not in data:
                 logger.warning("Invalid registry format, resetting")
-                return {
-                    "version": 1,
-                    "toolchains": {},
-                    "total_size_mb": 0.0,
-                    "last_cleanup": None,
-                }
+                return _empty_registry()
 
+            data.setdefault("artifacts", {})
             return data
 
         except (json.JSONDecodeError, OSError) as e:
@@ -106,6 +108,12 @@ class ToolchainCacheRegistry:
         Args:
             data: Registry data dictionary to save
         """
+        transaction = getattr(self._local, "transaction", None)
+        if transaction is not None:
+            # Written once when the transaction ends
+            transaction["dirty"] = True
+            return
+
         try:
             # Ensure parent directory exists
             self.registry_path.parent.mkdir(parents=True, exist_ok=True)
@@ -125,7 +133,9 @@ class ToolchainCacheRegistry:
         """
         Context manager for registry locking.
 
-        Acquires exclusive file lock to ensure thread-safe operations.
+        Acquires exclusive file lock to ensure thread-safe operations. The
+        lock is reentrant within a thread, so registry methods can be called
+        while it is held.
 
         Yields:
             None
@@ -133,15 +143,28 @@ class ToolchainCacheRegistry:
         Raises:
             RegistryLockTimeout: If lock cannot be acquired within timeout
         """
+        depth = getattr(self._local, "depth", 0)
+        if depth:
+            self._local.depth = depth + 1
+            try:
+                yield
+            finally:
+                self._local.depth = depth
+            return
+
         # Ensure lock directory exists
         self.lock_path.parent.mkdir(parents=True, exist_ok=True)
 
         lock = FileLock(self.lock_path, timeout=self.lock_timeout)
 
         try:
-            with lock:
+            with tracing.acquired(lock, "registry"):
                 logger.debug("Acquired registry lock")
-                yield
+                self._local.depth = 1
+                try:
+                    yield
+                finally:
+                    self._local.depth = 0
             logger.debug("Released registry lock")
 
         except Timeout as e:
@@ -150,6 +173,47 @@ class ToolchainCacheRegistry:
                 f"Could not acquire registry lock within {self.lock_timeout} seconds"
             ) from e
 
+    def lock(self):
+        """
+        Hold the registry lock across several calls.
+
+        Example:
+            >>> with registry.lock():
+            ...     info = registry.get_toolchain_info('llvm-18.1.8-linux-x64')
+            ...     if info is None:
+            ...         registry.register_toolchain(...)
+        """
+        return self._lock()
+
+    @contextmanager
+    def transaction(self):
+        """
+        Batch several registry updates into one load and one write.
+
+        Holds the lock for the whole block. Registry methods called by this
+        thread inside the block work on the same in-memory data, which is
+        written once at the end; if the block raises, nothing is written.
+
+        Example:
+            >>> with registry.transaction():
+            ...     for project in projects:
+            ...         registry.add_project_reference(new_id, project)
+            ...     registry.unregister_toolchain(old_id)
+        """
+        with self._lock():
+            if getattr(self._local, "transaction", None) is not None:
+                # Nested: part of the outer transaction
+                yield
+                return
+            self._local.transaction = {"data": self._load_registry(), "dirty": False}
+            try:
+                yield
+                transaction = self._local.transaction
+            finally:
+                self._local.transaction = None
+            if transaction["dirty"]:
+                self._save_registry(transaction["data"])
+
     def register_toolchain(
         self,
         toolchain_id: str,
@@ -158,6 +222,9 @@ class ToolchainCacheRegistry:
         hash_value: str,
         source_url: str,
         verified: bool = True,
+        size_bytes: Optional[int] = None,
+        components: Optional[List[str]] = None,
+        component_patterns: Optional[Dict[str, List[str]]] = None,
     ):
         """
         Register new toolchain installation.
@@ -169,6 +236,11 @@ class ToolchainCacheRegistry:
             hash_value: Hash of toolchain archive (e.g., 'sha256:abc...')
             source_url: URL where toolchain was downloaded from
             verified: Whether toolchain hash has been verified
+            size_bytes: Exact size in bytes (default: derived from size_mb)
+            components: Installed components, if only part of the archive was
+                installed (see toolchain.components)
+            component_patterns: Path globs of all components of the archive,
+                needed to add components later
 
         Example:
             >>> registry.register_toolchain(
@@ -184,9 +256,12 @@ class ToolchainCacheRegistry:
 
             now = datetime.now().isoformat()
 
+            if size_bytes is None:
+                size_bytes = int(size_mb * 1024 * 1024)
             data["toolchains"][toolchain_id] = {
                 "path": str(path.resolve()),
                 "size_mb": size_mb,
+                "size_bytes": size_bytes,
                 "projects": [],
                 "installed": now,
                 "last_used": now,
@@ -194,12 +269,13 @@ class ToolchainCacheRegistry:
                 "source_url": source_url,
                 "verified": verified,
             }
+            if components is not None:
+                data["toolchains"][toolchain_id]["components"] = sorted(components)
+                data["toolchains"][toolchain_id]["component_patterns"] = (
+                    component_patterns or {}
+                )
 
-            # Recalculate total size
-            data["total_size_mb"] = sum(
-                tc["size_mb"] for tc in data["toolchains"].values()
-            )
-
+            _update_totals(data)
             self._save_registry(data)
 
             logger.info(f"Registered toolchain: {toolchain_id} ({size_mb:.1f} MB)")
@@ -284,6 +360,41 @@ class ToolchainCacheRegistry:
                     f"Toolchain not found for reference removal: {toolchain_id}"
                 )
 
+    def set_project_toolchain(self, toolchain_id: str, project_path: Path) -> bool:
+        """
+        Record that a project now uses exactly this toolchain.
+
+        Called on configure: the project is added to the toolchain's
+        references (which protect it from quota eviction) and removed from
+        every other toolchain's, so toolchains it moved away from can be
+        evicted again.
+
+        Args:
+            toolchain_id: Toolchain identifier
+            project_path: Path to the configured project
+
+        Returns:
+            True if the toolchain is registered (nothing changes otherwise)
+        """
+        project_str = str(project_path.resolve())
+        with self._lock():
+            data = self._load_registry()
+            if toolchain_id not in data["toolchains"]:
+                logger.debug(f"Not recording reference to unregistered {toolchain_id}")
+                return False
+            for other_id, info in data["toolchains"].items():
+                projects = info.setdefault("projects", [])
+                if other_id == toolchain_id:
+                    if project_str not in projects:
+                        projects.append(project_str)
+                    info["last_used"] = datetime.now().isoformat()
+                elif project_str in projects:
+                    projects.remove(project_str)
+                    if info.get("ref_count", 0) > 0:
+                        info["ref_count"] -= 1
+            self._save_registry(data)
+        return True
+
     def get_toolchain_info(self, toolchain_id: str) -> Optional[Dict]:
         """
         Get toolchain metadata.
@@ -303,6 +414,49 @@ class ToolchainCacheRegistry:
         data = self._load_registry()
         return data["toolchains"].get(toolchain_id)
 
+    def find_toolchain(self, path: Path) -> Optional[str]:
+        """
+        Find the toolchain installed at a path.
+
+        Args:
+            path: Toolchain installation directory
+
+        Returns:
+            Toolchain ID, or None if no registered toolchain lives there
+        """
+        resolved = str(Path(path).resolve())
+        for toolchain_id, entry in self._load_registry()["toolchains"].items():
+            if entry["path"] == resolved:
+                return toolchain_id
+        return None
+
+    def add_components(
+        self, toolchain_id: str, components: List[str], added_bytes: int
+    ) -> None:
+        """
+        Record components added to a partial installation.
+
+        Args:
+            toolchain_id: Toolchain identifier
+            components: Component names that were extracted
+            added_bytes: Size of the extracted files
+
+        Raises:
+            ToolchainNotInCacheError: If toolchain is not registered
+        """
+        with self._lock():
+            data = self._load_registry()
+            entry = data["toolchains"].get(toolchain_id)
+            if entry is None:
+                raise ToolchainNotInCacheError(toolchain_id)
+            entry["components"] = sorted(
+                set(entry.get("components", [])) | set(components)
+            )
+            entry["size_bytes"] = entry_size(entry) + added_bytes
+            entry["size_mb"] = entry["size_bytes"] / (1024 * 1024)
+            _update_totals(data)
+            self._save_registry(data)
+
     def list_toolchains(self) -> List[str]:
         """
         Get list of all registered toolchain IDs.
@@ -355,13 +509,18 @@ class ToolchainCacheRegistry:
 
         return unused
 
-    def update_last_used(self, toolchain_id: str):
+    def update_last_used(self, toolchain_id: str) -> Optional[Dict]:
         """
         Update last used timestamp for toolchain.
 
+        The timestamp orders toolchains for LRU eviction.
+
         Args:
             toolchain_id: Toolchain identifier
 
+        Returns:
+            Updated toolchain metadata, or None if not registered
+
         Example:
             >>> registry.update_last_used('llvm-18.1.8-linux-x64')
         """
@@ -375,10 +534,12 @@ class ToolchainCacheRegistry:
                 self._save_registry(data)
 
                 logger.debug(f"Updated last used timestamp: {toolchain_id}")
+                return data["toolchains"][toolchain_id]
             else:
                 logger.warning(
                     f"Toolchain not found for timestamp update: {toolchain_id}"
                 )
+                return None
 
     def unregister_toolchain(self, toolchain_id: str):
         """
@@ -417,11 +578,7 @@ class ToolchainCacheRegistry:
 
             del data["toolchains"][toolchain_id]
 
-            # Recalculate total size
-            data["total_size_mb"] = sum(
-                tc["size_mb"] for tc in data["toolchains"].values()
-            )
-
+            _update_totals(data)
             self._save_registry(data)
 
             logger.info(f"Unregistered toolchain: {toolchain_id}")
@@ -437,6 +594,12 @@ class ToolchainCacheRegistry:
             - unused_toolchains: Number of unused toolchains
             - reclaimable_size_mb: Size that could be freed by removing unused
             - last_cleanup: Timestamp of last cleanup (if any)
+            - toolchain_bytes: Recorded size of all toolchains
+            - artifact_bytes: Recorded size of other artifacts, by kind
+            - total_bytes: toolchain_bytes plus all artifacts
+            - reclaimable_bytes: Recorded size of unused toolchains
+
+            Sizes are read from the registry; no directory is walked.
 
         Example:
             >>> stats = registry.get_cache_stats()
@@ -455,14 +618,94 @@ class ToolchainCacheRegistry:
         # Calculate space that could be freed
         reclaimable_size = sum(data["toolchains"][tc]["size_mb"] for tc in unused)
 
+        toolchain_bytes = sum(entry_size(tc) for tc in data["toolchains"].values())
+        artifact_bytes = {}
+        for artifact in data["artifacts"].values():
+            kind = artifact.get("kind", "download")
+            artifact_bytes[kind] = artifact_bytes.get(kind, 0) + entry_size(artifact)
+
         return {
             "total_toolchains": total_toolchains,
             "total_size_mb": total_size,
             "unused_toolchains": unused_count,
             "reclaimable_size_mb": reclaimable_size,
             "last_cleanup": data.get("last_cleanup"),
+            "toolchain_bytes": toolchain_bytes,
+            "artifact_bytes": artifact_bytes,
+            "total_bytes": toolchain_bytes + sum(artifact_bytes.values()),
+            "reclaimable_bytes": sum(
+                entry_size(data["toolchains"][tc]) for tc in unused
+            ),
         }
 
+    def register_artifact(self, path: Path, kind: str, size_bytes: int):
+        """
+        Record a cached artifact other than a toolchain.
+
+        Artifacts are downloaded archives and sysroots. They have no project
+        references and are evicted least recently used first.
+
+        Args:
+            path: File or directory in the cache
+            kind: 'download' or 'sysroot'
+            size_bytes: Size in bytes
+
+        Example:
+            >>> registry.register_artifact(archive, 'download', archive.stat().st_size)
+        """
+        with self._lock():
+            data = self._load_registry()
+            now = datetime.now().isoformat()
+            data["artifacts"][str(Path(path).resolve())] = {
+                "kind": kind,
+                "size_bytes": size_bytes,
+                "installed": now,
+                "last_used": now,
+            }
+            _update_totals(data)
+            self._save_registry(data)
+
+    def touch_artifact(self, path: Path) -> bool:
+        """
+        Update the last used timestamp of an artifact.
+
+        Args:
+            path: Artifact path
+
+        Returns:
+            True if the artifact is registered
+        """
+        with self._lock():
+            data = self._load_registry()
+            artifact = data["artifacts"].get(str(Path(path).resolve()))
+            if artifact is None:
+                return False
+            artifact["last_used"] = datetime.now().isoformat()
+            self._save_registry(data)
+            return True
+
+    def unregister_artifact(self, path: Path):
+        """
+        Forget an artifact (after it was deleted).
+
+        Args:
+            path: Artifact path
+        """
+        with self._lock():
+            data = self._load_registry()
+            if data["artifacts"].pop(str(Path(path).resolve()), None) is not None:
+                _update_totals(data)
+                self._save_registry(data)
+
+    def list_artifacts(self) -> Dict[str, Dict]:
+        """
+        Get all registered artifacts.
+
+        Returns:
+            Artifact path -> metadata (kind, size_bytes, installed, last_used)
+        """
+        return dict(self._load_registry()["artifacts"])
+
     def mark_cleanup(self):
         """
         Mark that cleanup was performed.
@@ -478,3 +721,39 @@ class ToolchainCacheRegistry:
             self._save_registry(data)
 
             logger.info("Marked cleanup timestamp")
+
+
+def entry_size(entry: Dict) -> int:
+    """
+    Size in bytes of a toolchain or artifact entry.
+
+    Entries written before byte accounting only have ``size_mb``.
+    """
+    size = entry.get("size_bytes")
+    if size is None:
+        size = int(entry.get("size_mb", 0.0) * 1024 * 1024)
+    return size
+
+
+def _update_totals(data: dict) -> None:
+    """Recalculate the registry's total sizes after a change."""
+    data["total_size_mb"] = sum(
+        tc.get("size_mb", 0.0) for tc in data["toolchains"].values()
+    )
+    data["total_size_bytes"] = sum(
+        entry_size(entry)
+        for section in ("toolchains", "artifacts")
+        for entry in data[section].values()
+    )
+
+
+def _empty_registry() -> dict:
+    """Registry data of an empty cache."""
+    return {
+        "version": 1,
+        "toolchains": {},
+        "artifacts": {},
+        "total_size_mb": 0.0,
+        "total_size_bytes": 0,
+        "last_cleanup": None,
+    }
@@ -8,20 +8,49 @@ This module provides robust downloading capabilities with:
 - Retry logic with exponential backoff
 - Checksum verification during download
 - Timeout handling
+- Mirror lists ranked by measured latency/throughput, with mid-download failover
 """
 
 import hashlib
 import logging
+import os
+import threading
 import time
+from concurrent.futures import ThreadPoolExecutor
+from contextlib import contextmanager
 from dataclasses import dataclass
 from pathlib import Path
-from typing import Callable, Optional
+from typing import Callable, Dict, List, Optional, Sequence
+from urllib.parse import urlparse
 
 import requests
+from requests.adapters import HTTPAdapter
 from requests.exceptions import RequestException, Timeout, ConnectionError, HTTPError
 
+from toolchainkit.core import tracing
+from toolchainkit.core.hashing import hash_file, update_from_file
+
 logger = logging.getLogger(__name__)
 
+DOWNLOAD_CHUNK_SIZE = 64 * 1024
+"""Bytes read from the response per iteration."""
+
+MIRRORS_ENV = "TOOLCHAINKIT_MIRRORS"
+"""Environment variable with mirror base URLs (comma or space separated)."""
+
+PROBE_BYTES = 64 * 1024
+"""Bytes requested from each mirror to measure latency and throughput."""
+
+MIRROR_STATS_TTL = 600.0
+"""Seconds a mirror measurement is trusted before the mirror is probed again."""
+
+_session: Optional[requests.Session] = None
+_session_lock = threading.Lock()
+_listener = threading.local()
+_mirrors: Optional[List[str]] = None
+_mirror_stats: Dict[str, "MirrorStats"] = {}
+_mirror_stats_lock = threading.Lock()
+
 
 @dataclass
 class DownloadProgress:
@@ -50,6 +79,27 @@ class ChecksumError(Exception):
     pass
 
 
+@dataclass
+class MirrorStats:
+    """Measured performance of one mirror host."""
+
+    latency: float
+    """Seconds until the response headers arrived."""
+
+    throughput: float
+    """Bytes per second (moving average over probes and downloads)."""
+
+    measured_at: float
+    """time.monotonic() of the last measurement."""
+
+    failures: int = 0
+    """Consecutive connection failures."""
+
+    def cost(self, size: int) -> float:
+        """Estimated seconds to fetch ``size`` bytes from this host."""
+        return self.latency + size / max(self.throughput, 1.0)
+
+
 class StreamingHasher:
     """Compute hash incrementally for streaming downloads."""
 
@@ -97,6 +147,228 @@ class StreamingHasher:
         return actual.lower() == expected_hash.lower()
 
 
+def get_session() -> requests.Session:
+    """
+    Get the HTTP session shared by all downloads.
+
+    The session keeps connections alive, so consecutive and concurrent
+    downloads from the same host (GitHub releases, a mirror) reuse TLS
+    connections instead of opening a new one per file.
+
+    Returns:
+        Shared requests.Session
+    """
+    global _session
+    with _session_lock:
+        if _session is None:
+            session = requests.Session()
+            adapter = HTTPAdapter(pool_connections=8, pool_maxsize=16)
+            session.mount("https://", adapter)
+            session.mount("http://", adapter)
+            _session = session
+        return _session
+
+
+@contextmanager
+def progress_listener(callback: Callable[[DownloadProgress], None]):
+    """
+    Receive progress of every download started by this thread.
+
+    Lets callers observe downloads made deep inside other code (e.g. tool
+    downloaders) without threading a callback through every layer.
+
+    Args:
+        callback: Called with DownloadProgress, in addition to any
+            progress_callback passed to download_file
+
+    Example:
+        >>> with progress_listener(lambda p: print(p.percentage)):
+        ...     NinjaDownloader(tools_dir).download()
+    """
+    previous = getattr(_listener, "callback", None)
+    _listener.callback = callback
+    try:
+        yield
+    finally:
+        _listener.callback = previous
+
+
+def _with_listener(
+    progress_callback: Optional[Callable[[DownloadProgress], None]],
+) -> Optional[Callable[[DownloadProgress], None]]:
+    """Combine a progress callback with this thread's listener."""
+    listener = getattr(_listener, "callback", None)
+    if listener is None or progress_callback is None:
+        return progress_callback or listener
+
+    def both(progress: DownloadProgress):
+        progress_callback(progress)
+        listener(progress)
+
+    return both
+
+
+def set_mirrors(mirrors: Optional[Sequence[str]]) -> None:
+    """
+    Configure the mirrors tried for every download.
+
+    Each mirror is a base URL; a file is looked up at
+    ``<mirror>/<file name of the original URL>``, the layout served by
+    ``tkgen mirror serve``. Passing None restores the default, which is
+    read from the TOOLCHAINKIT_MIRRORS environment variable.
+
+    Args:
+        mirrors: Mirror base URLs, or None
+    """
+    global _mirrors
+    _mirrors = [m for m in mirrors if m] if mirrors is not None else None
+
+
+def get_mirrors() -> List[str]:
+    """
+    Get the configured mirror base URLs.
+
+    Returns:
+        Mirrors set by set_mirrors(), else those in TOOLCHAINKIT_MIRRORS
+    """
+    if _mirrors is not None:
+        return list(_mirrors)
+    value = os.environ.get(MIRRORS_ENV, "")
+    return [m for m in value.replace(",", " ").split() if m]
+
+
+def mirror_urls(url: str, mirrors: Optional[Sequence[str]] = None) -> List[str]:
+    """
+    List every URL a file can be downloaded from.
+
+    Args:
+        url: Original (upstream) URL
+        mirrors: Full alternative URLs for this file (e.g. from toolchains.json)
+
+    Returns:
+        Per-file mirrors, then configured mirrors, then ``url``; duplicates removed
+    """
+    name = urlparse(url).path.rsplit("/", 1)[-1]
+    candidates = list(mirrors or [])
+    if name:
+        candidates += [f"{base.rstrip('/')}/{name}" for base in get_mirrors()]
+    candidates.append(url)
+    return list(dict.fromkeys(candidates))
+
+
+def _host(url: str) -> str:
+    parsed = urlparse(url)
+    return f"{parsed.scheme}://{parsed.netloc}"
+
+
+def _record_transfer(url: str, nbytes: int, seconds: float, failed: bool) -> None:
+    """Fold an observed transfer into the host's measurements."""
+    with _mirror_stats_lock:
+        stats = _mirror_stats.get(_host(url))
+        if stats is None:
+            if failed:
+                return
+            stats = MirrorStats(latency=0.0, throughput=0.0, measured_at=0.0)
+            _mirror_stats[_host(url)] = stats
+        if nbytes > 0 and seconds > 0:
+            rate = nbytes / seconds
+            stats.throughput = (
+                rate if stats.throughput <= 0 else 0.5 * stats.throughput + 0.5 * rate
+            )
+            stats.measured_at = time.monotonic()
+        stats.failures = stats.failures + 1 if failed else 0
+
+
+def probe_mirror(url: str, timeout: float = 3.0) -> Optional[MirrorStats]:
+    """
+    Measure one mirror by fetching the first PROBE_BYTES of a file.
+
+    Args:
+        url: File URL on the mirror
+        timeout: Connect/read timeout in seconds
+
+    Returns:
+        MirrorStats, or None if the mirror is unreachable or lacks the file
+    """
+    start = time.perf_counter()
+    try:
+        response = get_session().get(
+            url,
+            headers={"Range": f"bytes=0-{PROBE_BYTES - 1}"},
+            stream=True,
+            timeout=timeout,
+        )
+    except RequestException as e:
+        logger.debug(f"Mirror probe failed for {url}: {e}")
+        return None
+    latency = time.perf_counter() - start
+    try:
+        if not response.ok:
+            logger.debug(f"Mirror probe of {url}: HTTP {response.status_code}")
+            return None
+        received = 0
+        for chunk in response.iter_content(chunk_size=DOWNLOAD_CHUNK_SIZE):
+            received += len(chunk)
+            if received >= PROBE_BYTES:
+                break
+    except RequestException as e:
+        logger.debug(f"Mirror probe failed for {url}: {e}")
+        return None
+    finally:
+        response.close()
+    transfer = time.perf_counter() - start - latency
+    # A probe smaller than the window says little about bandwidth; assume the
+    # whole window would have arrived in the time it took.
+    throughput = PROBE_BYTES / max(transfer, latency / 2, 1e-4)
+    return MirrorStats(latency, throughput, time.monotonic())
+
+
+@tracing.traced("rank mirrors", "download")
+def rank_mirrors(urls: Sequence[str], size: int = 0, timeout: float = 3.0) -> List[str]:
+    """
+    Order candidate URLs by expected download time.
+
+    Hosts without a fresh measurement are probed concurrently. URLs whose
+    probe fails are dropped; among the rest, the estimated time to fetch
+    ``size`` bytes (latency + size / throughput) decides, and ties keep the
+    given order.
+
+    Args:
+        urls: Candidate URLs for the same file
+        size: Expected file size in bytes (0 if unknown)
+        timeout: Probe timeout in seconds
+
+    Returns:
+        Reachable URLs, fastest first
+    """
+    now = time.monotonic()
+    known: Dict[str, MirrorStats] = {}
+    with _mirror_stats_lock:
+        for url in urls:
+            stats = _mirror_stats.get(_host(url))
+            fresh = stats and now - stats.measured_at < MIRROR_STATS_TTL
+            if fresh and not stats.failures:
+                known[url] = stats
+    unknown = [url for url in urls if url not in known]
+    if unknown:
+        with ThreadPoolExecutor(max_workers=min(8, len(unknown))) as pool:
+            probed = dict(
+                zip(unknown, pool.map(lambda u: probe_mirror(u, timeout), unknown))
+            )
+        with _mirror_stats_lock:
+            for url, stats in probed.items():
+                if stats is not None:
+                    _mirror_stats[_host(url)] = stats
+                    known[url] = stats
+    size = size or 64 * 1024 * 1024
+    ranked = sorted(
+        (url for url in urls if url in known), key=lambda u: known[u].cost(size)
+    )
+    logger.debug(f"Mirror ranking: {ranked}")
+    return ranked
+
+
+@tracing.traced("download", "download")
 def download_file(
     url: str,
     destination: Path,
@@ -105,10 +377,21 @@ def download_file(
     resume: bool = True,
     timeout: int = 30,
     max_retries: int = 3,
+    mirrors: Optional[Sequence[str]] = None,
 ) -> Path:
     """
     Download file from URL to destination with retry logic and checksum verification.
 
+    Besides ``url``, the file is looked for on ``mirrors`` and on the
+    configured mirrors (see set_mirrors()). With more than one candidate,
+    the candidates are ranked by measured latency and throughput and tried
+    fastest first. If a source fails mid-download, the next one continues
+    from the bytes already on disk (HTTP Range). Mirrors need not be
+    trusted because they are only used when ``expected_sha256`` is given:
+    if the assembled file does not match, every mirror that contributed to
+    it is dropped and the download restarts from the remaining sources.
+    Without a hash, only ``url`` is used.
+
     Args:
         url: URL to download from
         destination: Local path to save file
@@ -117,6 +400,8 @@ def download_file(
         resume: Whether to resume partial downloads
         timeout: Request timeout in seconds
         max_retries: Maximum number of retry attempts
+        mirrors: Alternative URLs of the same file (used only with
+            ``expected_sha256``)
 
     Returns:
         Path to downloaded file
@@ -142,6 +427,9 @@ def download_file(
     if not destination:
         raise ValueError("Destination path cannot be empty")
 
+    progress_callback = _with_listener(progress_callback)
+    tracing.annotate(url=url)
+
     # Ensure destination directory exists
     destination = Path(destination)
     destination.parent.mkdir(parents=True, exist_ok=True)
@@ -156,36 +444,90 @@ def download_file(
             logger.warning("Checksum mismatch, re-downloading")
             destination.unlink()
 
-    # Determine if we can resume
-    resume_from = 0
-    if resume and destination.exists():
-        resume_from = destination.stat().st_size
-        logger.info(f"Resuming download from byte {resume_from}")
+    # Nothing could detect a mirror serving different bytes without a hash
+    candidates = mirror_urls(url, mirrors) if expected_sha256 else [url]
+    if len(candidates) > 1:
+        ranked = rank_mirrors(candidates, timeout=min(timeout, 3))
+        # The upstream URL stays as the last resort even if its probe failed
+        candidates = ranked + ([url] if url not in ranked else [])
+
+    if not resume and destination.exists():
+        destination.unlink()
+
+    # Sources whose bytes are in the current partial file
+    contributed: List[str] = []
 
     # Download with retries
     for attempt in range(max_retries):
-        try:
-            return _download_with_progress(
-                url=url,
-                destination=destination,
-                resume_from=resume_from,
-                expected_sha256=expected_sha256,
-                progress_callback=progress_callback,
-                timeout=timeout,
-            )
-        except (Timeout, ConnectionError, RequestException, HTTPError) as e:
-            if attempt == max_retries - 1:
-                raise DownloadError(
-                    f"Download failed after {max_retries} attempts: {e}"
-                ) from e
-
-            # Exponential backoff
-            backoff_seconds = 2**attempt
-            logger.warning(
-                f"Download attempt {attempt + 1} failed: {e}. "
-                f"Retrying in {backoff_seconds}s..."
-            )
-            time.sleep(backoff_seconds)
+        index = 0
+        while index < len(candidates):
+            source = candidates[index]
+            # Determine if we can resume
+            resume_from = destination.stat().st_size if destination.exists() else 0
+            if resume_from:
+                logger.info(f"Resuming download from byte {resume_from}")
+            start = time.perf_counter()
+            try:
+                result = _download_with_progress(
+                    url=source,
+                    destination=destination,
+                    resume_from=resume_from,
+                    expected_sha256=expected_sha256,
+                    progress_callback=progress_callback,
+                    timeout=timeout,
+                )
+                _record_transfer(
+                    source,
+                    destination.stat().st_size - resume_from,
+                    time.perf_counter() - start,
+                    failed=False,
+                )
+                tracing.annotate(source=source, bytes=destination.stat().st_size)
+                return result
+            except ChecksumError:
+                bad = [c for c in contributed + [source] if c != url]
+                remaining = [c for c in candidates if c not in bad]
+                if not bad or not remaining:
+                    raise
+                logger.warning(
+                    f"Checksum mismatch with bytes from {', '.join(bad)}; "
+                    "dropping these mirrors and restarting"
+                )
+                candidates = remaining
+                contributed = []
+                index = 0
+                continue
+            except (Timeout, ConnectionError, RequestException, HTTPError) as e:
+                size = destination.stat().st_size if destination.exists() else 0
+                if size > resume_from and source not in contributed:
+                    contributed.append(source)
+                _record_transfer(
+                    source,
+                    max(size - resume_from, 0),
+                    time.perf_counter() - start,
+                    failed=not isinstance(e, HTTPError),
+                )
+                last_source = index == len(candidates) - 1
+                if attempt == max_retries - 1 and last_source:
+                    raise DownloadError(
+                        f"Download failed after {max_retries} attempts: {e}"
+                    ) from e
+                if not last_source:
+                    logger.warning(
+                        f"Download from {source} failed: {e}. "
+                        f"Continuing from {candidates[index + 1]}"
+                    )
+                    index += 1
+                    continue
+
+                # Exponential backoff
+                backoff_seconds = 2**attempt
+                logger.warning(
+                    f"Download attempt {attempt + 1} failed: {e}. "
+                    f"Retrying in {backoff_seconds}s..."
+                )
+                time.sleep(backoff_seconds)
+                break
 
     # Should never reach here, but just in case
     raise DownloadError("Download failed for unknown reason")
@@ -226,10 +568,18 @@ def _download_with_progress(
     logger.info(f"Downloading from {url}")
 
     # Make request with streaming
-    response = requests.get(
+    response = get_session().get(
         url, headers=headers, stream=True, timeout=timeout, allow_redirects=True
     )
-    response.raise_for_status()
+    if not response.ok:
+        response.close()  # Return the connection to the pool
+        response.raise_for_status()
+
+    # A full response to a Range request must replace the partial file, not
+    # be appended to it
+    if resume_from > 0 and response.status_code != 206:
+        logger.info(f"{url} does not support ranges, restarting from byte 0")
+        resume_from = 0
 
     # Get total size
     content_length = response.headers.get("content-length")
@@ -247,9 +597,7 @@ def _download_with_progress(
     # If resuming, need to re-read existing bytes for checksum
     if resume_from > 0 and hasher:
         logger.debug(f"Re-computing hash for first {resume_from} bytes")
-        with open(destination, "rb") as f:
-            while chunk := f.read(8192):
-                hasher.update(chunk)
+        update_from_file(hasher.hasher, destination)
 
     downloaded = resume_from
     start_time = time.time()
@@ -257,7 +605,7 @@ def _download_with_progress(
 
     try:
         with open(destination, mode) as f:
-            for chunk in response.iter_content(chunk_size=8192):
+            for chunk in response.iter_content(chunk_size=DOWNLOAD_CHUNK_SIZE):
                 if chunk:
                     f.write(chunk)
                     downloaded += len(chunk)
@@ -294,6 +642,13 @@ def _download_with_progress(
         # Clean up partial download on error
         logger.error(f"Error during download: {e}")
         raise
+    finally:
+        response.close()
+
+    if content_length and downloaded < total_size:
+        raise ConnectionError(
+            f"Connection closed after {downloaded} of {total_size} bytes"
+        )
 
     # Verify checksum
     if expected_sha256 and hasher:
@@ -311,6 +666,7 @@ def _download_with_progress(
     return destination
 
 
+@tracing.traced("verify checksum", "hash")
 def verify_checksum(file_path: Path, expected_sha256: str) -> bool:
     """
     Verify file SHA256 checksum.
@@ -328,12 +684,7 @@ def verify_checksum(file_path: Path, expected_sha256: str) -> bool:
     if not file_path.exists():
         raise FileNotFoundError(f"File not found: {file_path}")
 
-    hasher = hashlib.sha256()
-    with open(file_path, "rb") as f:
-        while chunk := f.read(8192):
-            hasher.update(chunk)
-
-    actual_hash = hasher.hexdigest()
+    actual_hash = hash_file(file_path, "sha256")
     return actual_hash.lower() == expected_sha256.lower()
 
 
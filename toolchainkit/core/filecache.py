@@ -0,0 +1,73 @@
+"""
+Process-wide cache of parsed data files.
+
+Toolchain metadata (``toolchains.json``) and layer YAMLs are parsed by fresh
+``ToolchainMetadataRegistry`` and ``LayerComposer`` instances in every
+command. ``load_cached()`` keeps the parsed result per file and reuses it
+while the file's stat signature (mtime, size, inode) is unchanged, so a
+long-lived process - the ``tkgen daemon`` and the commands it forks - parses
+each file once. Cached values are shared: callers must not mutate them.
+
+Example:
+    >>> data = load_cached(path, _parse_json)
+    >>> clear_file_cache()  # Drop everything, e.g. after a watched change
+"""
+
+import os
+import threading
+from pathlib import Path
+from typing import Any, Callable, Dict, Optional, Tuple, TypeVar
+
+T = TypeVar("T")
+
+Signature = Tuple[int, int, int]
+
+_cache: Dict[Tuple[str, Callable], Tuple[Signature, Any]] = {}
+_cache_lock = threading.Lock()
+
+
+def file_signature(path: Path) -> Optional[Signature]:
+    """
+    Stat signature of a file or directory.
+
+    Returns:
+        (mtime_ns, size, inode), or None if the path does not exist
+    """
+    try:
+        st = os.stat(path)
+    except OSError:
+        return None
+    return st.st_mtime_ns, st.st_size, st.st_ino
+
+
+def load_cached(path: Path, loader: Callable[[Path], T]) -> T:
+    """
+    Parse a file with loader, reusing the result while the file is unchanged.
+
+    Args:
+        path: File to load
+        loader: Parser called with the path on a miss (a module-level
+            function: it is part of the cache key); its exceptions propagate
+            and nothing is cached
+
+    Returns:
+        The (possibly shared) parsed value
+    """
+    signature = file_signature(path)
+    if signature is None:
+        return loader(path)
+    key = (str(path), loader)
+    with _cache_lock:
+        entry = _cache.get(key)
+    if entry is not None and entry[0] == signature:
+        return entry[1]
+    value = loader(path)
+    with _cache_lock:
+        _cache[key] = (signature, value)
+    return value
+
+
+def clear_file_cache() -> None:
+    """Drop all cached files."""
+    with _cache_lock:
+        _cache.clear()
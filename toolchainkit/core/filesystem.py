@@ -17,12 +17,14 @@ import shutil
 import tarfile
 import zipfile
 import tempfile
-import hashlib
 import json
 from pathlib import Path
 from typing import Optional, Callable, Union, Literal
 from contextlib import contextmanager
 
+from . import tracing
+from .hashing import READ_SIZE, hash_file
+
 # Platform detection
 IS_WINDOWS = os.name == "nt"
 IS_UNIX = not IS_WINDOWS
@@ -486,10 +488,12 @@ def _validate_archive_path(path: str, destination: Path) -> None:
         )
 
 
+@tracing.traced("extract archive", "extract")
 def extract_archive(
     archive_path: Union[str, Path],
     destination: Union[str, Path],
     progress_callback: Optional[Callable[[int, int], None]] = None,
+    member_filter: Optional[Callable[[str], bool]] = None,
 ) -> None:
     """
     Extract an archive to a destination directory.
@@ -508,6 +512,10 @@ def extract_archive(
         archive_path: Path to the archive file
         destination: Directory to extract to
         progress_callback: Optional callback(current, total) for progress
+        member_filter: Optional predicate on member names (as stored in the
+            archive); members it rejects are not written. Applied to zip and
+            tar archives only (see FILTERABLE_ARCHIVES), others are extracted
+            whole.
 
     Raises:
         UnsupportedArchiveFormat: If archive format is not recognized
@@ -532,13 +540,15 @@ def extract_archive(
 
     try:
         if archive_name.endswith(".zip"):
-            _extract_zip(archive_path, destination, progress_callback)
+            _extract_zip(archive_path, destination, progress_callback, member_filter)
         elif archive_name.endswith((".tar.gz", ".tgz")):
-            _extract_tar_gz(archive_path, destination, progress_callback)
+            _extract_tar_gz(archive_path, destination, progress_callback, member_filter)
         elif archive_name.endswith(".tar.xz"):
-            _extract_tar_xz(archive_path, destination, progress_callback)
+            _extract_tar_xz(archive_path, destination, progress_callback, member_filter)
         elif archive_name.endswith((".tar.bz2", ".tbz2")):
-            _extract_tar_bz2(archive_path, destination, progress_callback)
+            _extract_tar_bz2(
+                archive_path, destination, progress_callback, member_filter
+            )
         elif archive_name.endswith(".7z"):
             _extract_7z(archive_path, destination, progress_callback)
         elif archive_name.endswith(".exe"):
@@ -554,14 +564,21 @@ def extract_archive(
         raise ArchiveExtractionError(f"Failed to extract {archive_path}: {e}")
 
 
+FILTERABLE_ARCHIVES = (".zip", ".tar.gz", ".tgz", ".tar.xz", ".tar.bz2", ".tbz2")
+"""Archive suffixes for which extract_archive() honors member_filter."""
+
+
 def _extract_zip(
     archive_path: Path,
     destination: Path,
     progress_callback: Optional[Callable[[int, int], None]] = None,
+    member_filter: Optional[Callable[[str], bool]] = None,
 ) -> None:
     """Extract a ZIP archive."""
     with zipfile.ZipFile(archive_path, "r") as zf:
         members = zf.namelist()
+        if member_filter:
+            members = [m for m in members if member_filter(m)]
         total = len(members)
 
         # Validate all paths first
@@ -579,27 +596,30 @@ def _extract_tar_gz(
     archive_path: Path,
     destination: Path,
     progress_callback: Optional[Callable[[int, int], None]] = None,
+    member_filter: Optional[Callable[[str], bool]] = None,
 ) -> None:
     """Extract a .tar.gz archive."""
-    _extract_tar(archive_path, destination, "r:gz", progress_callback)
+    _extract_tar(archive_path, destination, "r:gz", progress_callback, member_filter)
 
 
 def _extract_tar_xz(
     archive_path: Path,
     destination: Path,
     progress_callback: Optional[Callable[[int, int], None]] = None,
+    member_filter: Optional[Callable[[str], bool]] = None,
 ) -> None:
     """Extract a .tar.xz archive."""
-    _extract_tar(archive_path, destination, "r:xz", progress_callback)
+    _extract_tar(archive_path, destination, "r:xz", progress_callback, member_filter)
 
 
 def _extract_tar_bz2(
     archive_path: Path,
     destination: Path,
     progress_callback: Optional[Callable[[int, int], None]] = None,
+    member_filter: Optional[Callable[[str], bool]] = None,
 ) -> None:
     """Extract a .tar.bz2 archive."""
-    _extract_tar(archive_path, destination, "r:bz2", progress_callback)
+    _extract_tar(archive_path, destination, "r:bz2", progress_callback, member_filter)
 
 
 def _extract_tar(
@@ -607,10 +627,14 @@ def _extract_tar(
     destination: Path,
     mode: str,
     progress_callback: Optional[Callable[[int, int], None]] = None,
+    member_filter: Optional[Callable[[str], bool]] = None,
 ) -> None:
     """Extract a tar archive with specified compression."""
     with tarfile.open(archive_path, mode) as tar:
         members = tar.getmembers()
+        if member_filter:
+            # Hard links to skipped members are still extracted as copies
+            members = [m for m in members if member_filter(m.name)]
         total = len(members)
 
         # Validate all paths first
@@ -620,9 +644,9 @@ def _extract_tar(
         # Extract with filter for security (Python 3.12+)
         # For older Python, we've already validated paths above
         if sys.version_info >= (3, 12):
-            tar.extractall(destination, filter="data")
+            tar.extractall(destination, members=members, filter="data")
         else:
-            tar.extractall(destination)
+            tar.extractall(destination, members=members)
 
         if progress_callback:
             progress_callback(total, total)
@@ -934,17 +958,17 @@ def directory_size(path: Union[str, Path]) -> int:
 
 
 def compute_file_hash(
-    file_path: Union[str, Path], algorithm: str = "sha256", chunk_size: int = 8192
+    file_path: Union[str, Path], algorithm: str = "sha256", chunk_size: int = READ_SIZE
 ) -> str:
     """
     Compute hash of a file.
 
-    Memory-efficient implementation that reads file in chunks.
+    Uses the shared hashing engine (mmap or large reads, GIL released).
 
     Args:
         file_path: Path to file
         algorithm: Hash algorithm ('sha256', 'sha1', 'md5')
-        chunk_size: Number of bytes to read at once
+        chunk_size: Number of bytes hashed per update
 
     Returns:
         Hex digest of the hash
@@ -960,18 +984,7 @@ def compute_file_hash(
     if not file_path.exists():
         raise FilesystemError(f"File not found: {file_path}")
 
-    # Create hash object
-    try:
-        hasher = hashlib.new(algorithm)
-    except ValueError:
-        raise ValueError(f"Unsupported hash algorithm: {algorithm}")
-
-    # Read and hash in chunks
-    with open(file_path, "rb") as f:
-        while chunk := f.read(chunk_size):
-            hasher.update(chunk)
-
-    return hasher.hexdigest()
+    return hash_file(file_path, algorithm, read_size=chunk_size)
 
 
 # ============================================================================
@@ -0,0 +1,256 @@
+"""
+File hashing engine.
+
+All file hashing in ToolchainKit goes through this module:
+
+- Large reads: files are hashed through ``mmap`` (no copy into Python
+  buffers) or 1 MiB ``readinto`` reads, instead of 8 KB ``read()`` loops.
+  ``hashlib`` releases the GIL for each update of more than 2 KB, so hashing
+  threads run in parallel.
+- Single pass, several digests: ``hash_file_multi`` feeds every chunk to all
+  requested hashers while it is still in CPU cache.
+- Parallel trees: ``hash_files`` hashes many files on a thread pool.
+- Fast mode: ``algorithm="fast"`` selects BLAKE3 or XXH3-128 when the
+  ``blake3`` or ``xxhash`` package is installed (falling back to SHA256).
+  Use it for internal cache keys only, never for verifying downloads.
+
+Example:
+    >>> from toolchainkit.core.hashing import hash_file, hash_file_multi, hash_files
+    >>> hash_file(Path("llvm.tar.xz"))
+    'e2e96558...'
+    >>> hash_file_multi(Path("llvm.tar.xz"), ["sha256", "sha512"])
+    {'sha256': 'e2e96558...', 'sha512': '7a1f...'}
+    >>> hash_files(Path("llvm-18").rglob("*.h"), workers=8)
+    {PosixPath('llvm-18/include/...'): '...', ...}
+"""
+
+import hashlib
+import mmap
+import os
+from concurrent.futures import ThreadPoolExecutor
+from pathlib import Path
+from typing import Callable, Dict, Iterable, Optional, Sequence, Union
+
+from . import tracing
+
+READ_SIZE = 1024 * 1024
+"""Bytes per hasher update (large enough to release the GIL, small enough for L2)."""
+
+MMAP_THRESHOLD = 4 * 1024 * 1024
+"""Files at least this large are hashed through mmap."""
+
+FAST = "fast"
+"""Pseudo-algorithm: fastest available hash, for internal cache keys."""
+
+ProgressCallback = Callable[[int, int], None]
+
+
+def _blake3():
+    """blake3 constructor, or None if the package is not installed."""
+    try:
+        from blake3 import blake3
+
+        return blake3
+    except ImportError:
+        return None
+
+
+def _xxh3_128():
+    """xxh3_128 constructor, or None if the package is not installed."""
+    try:
+        from xxhash import xxh3_128
+
+        return xxh3_128
+    except ImportError:
+        return None
+
+
+def fast_algorithm() -> str:
+    """
+    Name of the algorithm used for ``algorithm="fast"``.
+
+    Returns:
+        "blake3", "xxh3_128" or "sha256" (first one available)
+    """
+    if _blake3() is not None:
+        return "blake3"
+    if _xxh3_128() is not None:
+        return "xxh3_128"
+    return "sha256"
+
+
+def new_hasher(algorithm: str = "sha256"):
+    """
+    Create a hash object.
+
+    Args:
+        algorithm: Any ``hashlib`` algorithm, "blake3", "xxh3_128" or "fast"
+
+    Returns:
+        Object with ``update()`` and ``hexdigest()``
+
+    Raises:
+        ValueError: If algorithm is not available
+    """
+    algorithm = algorithm.lower()
+    if algorithm == FAST:
+        algorithm = fast_algorithm()
+    if algorithm == "blake3":
+        constructor = _blake3()
+        if constructor is not None:
+            # blake3 hashes on several threads itself for large updates
+            return constructor(max_threads=constructor.AUTO)
+    elif algorithm in ("xxh3", "xxh3_128"):
+        constructor = _xxh3_128()
+        if constructor is not None:
+            return constructor()
+    else:
+        try:
+            return hashlib.new(algorithm)
+        except ValueError:
+            pass
+    raise ValueError(f"Unsupported hash algorithm: {algorithm}")
+
+
+def update_from_file(
+    hashers,
+    path: Union[str, Path],
+    progress_callback: Optional[ProgressCallback] = None,
+    read_size: int = READ_SIZE,
+) -> None:
+    """
+    Feed a file's contents to existing hash objects in a single read.
+
+    Args:
+        hashers: Hash object, or list of hash objects
+        path: File to read
+        progress_callback: Optional callback (bytes_read, total_bytes)
+        read_size: Bytes per hasher update
+
+    Raises:
+        OSError: If the file cannot be read
+    """
+    if not isinstance(hashers, list):
+        hashers = [hashers]
+    with open(path, "rb", buffering=0) as f:
+        size = os.fstat(f.fileno()).st_size
+
+        if size >= MMAP_THRESHOLD:
+            try:
+                mapped = mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_READ)
+            except (OSError, ValueError):
+                mapped = None  # e.g. special files; fall back to reads
+            if mapped is not None:
+                with mapped:
+                    view = memoryview(mapped)
+                    try:
+                        for offset in range(0, len(view), read_size):
+                            with view[offset : offset + read_size] as chunk:
+                                for hasher in hashers:
+                                    hasher.update(chunk)
+                            if progress_callback:
+                                progress_callback(
+                                    min(offset + read_size, len(view)), size
+                                )
+                    finally:
+                        view.release()
+                return
+
+        buffer = bytearray(max(1, min(read_size, size + 1)))  # +1 detects EOF
+        view = memoryview(buffer)
+        done = 0
+        while True:
+            n = f.readinto(buffer)
+            if not n:
+                break
+            chunk = view[:n]
+            for hasher in hashers:
+                hasher.update(chunk)
+            done += n
+            if progress_callback:
+                progress_callback(done, size)
+
+
+def hash_file(
+    path: Union[str, Path],
+    algorithm: str = "sha256",
+    progress_callback: Optional[ProgressCallback] = None,
+    read_size: int = READ_SIZE,
+) -> str:
+    """
+    Hash one file.
+
+    Args:
+        path: File to hash
+        algorithm: Hash algorithm (see ``new_hasher``)
+        progress_callback: Optional callback (bytes_read, total_bytes)
+        read_size: Bytes per hasher update
+
+    Returns:
+        Hex digest
+
+    Raises:
+        ValueError: If algorithm is not available
+        OSError: If the file cannot be read
+    """
+    hasher = new_hasher(algorithm)
+    update_from_file(hasher, path, progress_callback, read_size)
+    return hasher.hexdigest()
+
+
+def hash_file_multi(
+    path: Union[str, Path],
+    algorithms: Sequence[str],
+    progress_callback: Optional[ProgressCallback] = None,
+    read_size: int = READ_SIZE,
+) -> Dict[str, str]:
+    """
+    Compute several digests of a file in a single read.
+
+    Args:
+        path: File to hash
+        algorithms: Hash algorithms (see ``new_hasher``)
+        progress_callback: Optional callback (bytes_read, total_bytes)
+        read_size: Bytes per hasher update
+
+    Returns:
+        Dict of algorithm -> hex digest
+
+    Raises:
+        ValueError: If an algorithm is not available
+        OSError: If the file cannot be read
+    """
+    hashers = {algorithm: new_hasher(algorithm) for algorithm in algorithms}
+    update_from_file(list(hashers.values()), path, progress_callback, read_size)
+    return {algorithm: hasher.hexdigest() for algorithm, hasher in hashers.items()}
+
+
+@tracing.traced("hash files", "hash")
+def hash_files(
+    paths: Iterable[Union[str, Path]],
+    algorithm: str = "sha256",
+    workers: Optional[int] = None,
+) -> Dict[Path, str]:
+    """
+    Hash many files in parallel.
+
+    Args:
+        paths: Files to hash
+        algorithm: Hash algorithm (see ``new_hasher``)
+        workers: Hashing threads (default: CPU count)
+
+    Returns:
+        Dict of path -> hex digest, in input order
+
+    Raises:
+        ValueError: If algorithm is not available
+        OSError: If a file cannot be read
+    """
+    paths = [Path(p) for p in paths]
+    new_hasher(algorithm)  # Fail early on unknown algorithms
+    workers = workers or os.cpu_count() or 1
+    if workers == 1 or len(paths) < 2:
+        return {path: hash_file(path, algorithm) for path in paths}
+    with ThreadPoolExecutor(max_workers=min(workers, len(paths))) as pool:
+        digests = pool.map(lambda path: hash_file(path, algorithm), paths)
+        return dict(zip(paths, digests))
@@ -3,6 +3,10 @@ Core initialization module.
 
 This module provides functions to initialize core framework components,
 including registering standard compiler strategies and package managers.
+
+Everything is registered as a factory (see PluginRegistry), so initializing
+imports none of the strategy, package manager or downloader modules; each is
+imported when it is first looked up. This keeps `tkgen` startup cheap.
 """
 
 import logging
@@ -21,24 +25,26 @@ def initialize_core_strategies(registry) -> None:
     Args:
         registry: PluginRegistry instance to register strategies with
     """
-    from toolchainkit.toolchain.strategies.standard import (
-        ClangStrategy,
-        GccStrategy,
-        MsvcStrategy,
-    )
 
-    # Register standard strategies if not already registered
-    if not registry.has_compiler_strategy("clang"):
-        registry.register_compiler_strategy("clang", ClangStrategy())
-        logger.debug("Registered standard Clang strategy")
+    def standard_strategy(class_name: str):
+        def create():
+            from toolchainkit.toolchain.strategies import standard
 
-    if not registry.has_compiler_strategy("gcc"):
-        registry.register_compiler_strategy("gcc", GccStrategy())
-        logger.debug("Registered standard GCC strategy")
+            return getattr(standard, class_name)()
 
-    if not registry.has_compiler_strategy("msvc"):
-        registry.register_compiler_strategy("msvc", MsvcStrategy())
-        logger.debug("Registered standard MSVC strategy")
+        return create
+
+    # Register standard strategies if not already registered
+    for name, class_name in (
+        ("clang", "ClangStrategy"),
+        ("gcc", "GccStrategy"),
+        ("msvc", "MsvcStrategy"),
+    ):
+        if not registry.has_compiler_strategy(name):
+            registry.register_compiler_strategy_factory(
+                name, standard_strategy(class_name)
+            )
+            logger.debug(f"Registered standard {class_name}")
 
 
 def initialize_core_package_managers(registry) -> None:
@@ -51,24 +57,24 @@ def initialize_core_package_managers(registry) -> None:
     Args:
         registry: PluginRegistry instance to register package managers with
     """
-    # Import conditionally to avoid errors if dependencies missing
-    try:
-        from toolchainkit.packages.conan import ConanIntegration
 
-        if not registry.has_package_manager("conan"):
-            registry.register_package_manager("conan", ConanIntegration)
-            logger.debug("Registered Conan package manager")
-    except ImportError:
-        logger.debug("Conan integration not available")
+    def integration(module: str, class_name: str):
+        def create():
+            import importlib
 
-    try:
-        from toolchainkit.packages.vcpkg import VcpkgIntegration
+            return getattr(importlib.import_module(module), class_name)
 
-        if not registry.has_package_manager("vcpkg"):
-            registry.register_package_manager("vcpkg", VcpkgIntegration)
-            logger.debug("Registered vcpkg package manager")
-    except ImportError:
-        logger.debug("vcpkg integration not available")
+        return create
+
+    for name, module, class_name in (
+        ("conan", "toolchainkit.packages.conan", "ConanIntegration"),
+        ("vcpkg", "toolchainkit.packages.vcpkg", "VcpkgIntegration"),
+    ):
+        if not registry.has_package_manager(name):
+            registry.register_package_manager_factory(
+                name, integration(module, class_name)
+            )
+            logger.debug(f"Registered {class_name}")
 
 
 def initialize_core_providers(registry) -> None:
@@ -77,27 +83,19 @@ def initialize_core_providers(registry) -> None:
 
     This enables toolchain downloading functionality and plugin-based provision.
     """
-    try:
-        from toolchainkit.toolchain.downloader import ToolchainDownloader
-        from toolchainkit.toolchain.providers import (
-            DownloadToolchainProvider,
-        )
-
-        downloader = ToolchainDownloader()
-
-        # Create providers
-        download_provider = DownloadToolchainProvider(downloader)
 
-        # Plugin provider needs a plugin manager
-        # Use a temporary one for now, or just register download provider
-        # Ideally the plugin manager should be a singleton or passed in
-        # For now we'll register the download provider directly as it's the core requirement
+    def create():
+        try:
+            from toolchainkit.toolchain.downloader import ToolchainDownloader
+            from toolchainkit.toolchain.providers import DownloadToolchainProvider
 
-        registry.register_toolchain_provider(download_provider)
-        logger.debug("Registered download toolchain provider")
+            return DownloadToolchainProvider(ToolchainDownloader())
+        except Exception as e:
+            logger.warning(f"Failed to create core toolchain providers: {e}")
+            return None
 
-    except Exception as e:
-        logger.warning(f"Failed to register core toolchain providers: {e}")
+    registry.register_toolchain_provider_factory(create)
+    logger.debug("Registered download toolchain provider")
 
 
 def initialize_core(registry=None) -> None:
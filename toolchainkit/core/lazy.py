@@ -0,0 +1,50 @@
+"""
+Lazy package exports.
+
+Package ``__init__`` modules re-export names from their submodules. Importing
+every submodule eagerly makes ``import toolchainkit.core`` pull in filelock,
+requests and yaml, which every ``tkgen`` invocation pays for even when the
+command needs none of them. ``lazy_exports()`` builds module-level
+``__getattr__``/``__dir__`` functions (PEP 562) that import a submodule when
+one of its names is first accessed:
+
+    __getattr__, __dir__ = lazy_exports(__name__, {
+        ".locking": ["LockManager", "LockTimeout"],
+    })
+
+``from toolchainkit.core import LockManager`` keeps working unchanged.
+"""
+
+import importlib
+import sys
+from typing import Callable, Dict, Iterable, List, Tuple
+
+
+def lazy_exports(
+    package: str, exports: Dict[str, Iterable[str]]
+) -> Tuple[Callable[[str], object], Callable[[], List[str]]]:
+    """
+    Create ``__getattr__`` and ``__dir__`` for a package with lazy exports.
+
+    Args:
+        package: The package's ``__name__``
+        exports: Submodule (relative, e.g. ".locking") -> exported names
+
+    Returns:
+        (__getattr__, __dir__) to assign in the package module
+    """
+    origins = {name: module for module, names in exports.items() for name in names}
+
+    def __getattr__(name: str):
+        module = origins.get(name)
+        if module is None:
+            raise AttributeError(f"module {package!r} has no attribute {name!r}")
+        value = getattr(importlib.import_module(module, package), name)
+        # Cache so later lookups do not go through __getattr__
+        setattr(sys.modules[package], name, value)
+        return value
+
+    def __dir__() -> List[str]:
+        return sorted(set(vars(sys.modules[package])) | set(origins))
+
+    return __getattr__, __dir__
@@ -38,6 +38,8 @@ from typing import Optional
 
 from filelock import FileLock, Timeout as LockTimeout
 
+from toolchainkit.core import tracing
+
 logger = logging.getLogger(__name__)
 
 
@@ -116,7 +118,7 @@ class LockManager:
         lock = FileLock(lock_path, timeout=timeout)
 
         try:
-            with lock:
+            with tracing.acquired(lock, "registry"):
                 logger.debug(f"Acquired registry lock: {lock_path}")
                 yield
                 logger.debug(f"Released registry lock: {lock_path}")
@@ -154,13 +156,11 @@ class LockManager:
             ...     # Download and extract toolchain
             ...     download_toolchain('llvm-18', destination)
         """
-        # Sanitize toolchain_id to create valid filename
-        safe_id = toolchain_id.replace("/", "-").replace("\\", "-").replace(":", "-")
-        lock_path = self.lock_dir / f"toolchain-{safe_id}.lock"
+        lock_path = self._toolchain_lock_path(toolchain_id)
         lock = FileLock(lock_path, timeout=timeout)
 
         try:
-            with lock:
+            with tracing.acquired(lock, "toolchain"):
                 logger.debug(f"Acquired toolchain lock: {lock_path}")
                 yield
                 logger.debug(f"Released toolchain lock: {lock_path}")
@@ -174,6 +174,28 @@ class LockManager:
                 "Another process may be downloading this toolchain."
             ) from e
 
+    @contextmanager
+    def try_toolchain_lock(self, toolchain_id: str):
+        """
+        Take the toolchain lock only if no other process holds it.
+
+        Used by cache eviction, which must skip toolchains that are being
+        installed or used rather than wait for them.
+
+        Args:
+            toolchain_id: Unique toolchain identifier
+
+        Yields:
+            bool: True if the lock was acquired
+        """
+        with try_lock(self._toolchain_lock_path(toolchain_id), timeout=0) as acquired:
+            yield acquired
+
+    def _toolchain_lock_path(self, toolchain_id: str) -> Path:
+        # Sanitize toolchain_id to create valid filename
+        safe_id = toolchain_id.replace("/", "-").replace("\\", "-").replace(":", "-")
+        return self.lock_dir / f"toolchain-{safe_id}.lock"
+
     @contextmanager
     def project_lock(self, project_path: Path, timeout: int = 10):
         """
@@ -206,7 +228,7 @@ class LockManager:
         lock = FileLock(lock_path, timeout=timeout)
 
         try:
-            with lock:
+            with tracing.acquired(lock, "project"):
                 logger.debug(f"Acquired project lock: {lock_path}")
                 yield
                 logger.debug(f"Released project lock: {lock_path}")
@@ -0,0 +1,458 @@
+"""
+Integrity manifests for installed toolchains and tools.
+
+A manifest records the hash, size and modification time of every file in an
+installation directory. It is written once at install time; verification
+then only re-hashes files whose size or mtime changed, so checking a warm
+multi-gigabyte toolchain costs one ``stat`` per file. Hashing is spread
+across threads by the shared hashing engine (``core.hashing``).
+
+The manifest lives in the installation directory itself
+(``.toolchainkit-manifest.json``) so it moves with the tree.
+
+Example:
+    >>> from toolchainkit.core.manifest import IntegrityManifest, write_manifest
+    >>> write_manifest(Path("~/.toolchainkit/toolchains/llvm-18"))  # at install
+    >>> manifest = IntegrityManifest.load(Path("~/.toolchainkit/toolchains/llvm-18"))
+    >>> result = manifest.verify()            # stat-only, re-hash changed files
+    >>> result = manifest.verify(deep=True)   # re-hash everything
+    >>> print(result.summary())
+"""
+
+import hashlib
+import json
+import logging
+import os
+import stat
+import time
+from concurrent.futures import ThreadPoolExecutor
+from dataclasses import dataclass, field
+from datetime import datetime, timezone
+from pathlib import Path
+from typing import Dict, Iterable, Iterator, List, Mapping, Optional, Tuple, Union
+
+from . import tracing
+from .filesystem import atomic_write
+from .hashing import hash_file
+
+logger = logging.getLogger(__name__)
+
+MANIFEST_NAME = ".toolchainkit-manifest.json"
+"""Manifest file name inside an installation directory."""
+
+MANIFEST_VERSION = 1
+
+_LINK_PREFIX = "link:"
+"""Hash prefix for symbolic links (the link target is recorded instead)."""
+
+
+class ManifestError(Exception):
+    """Raised when a manifest cannot be read or written."""
+
+    pass
+
+
+@dataclass
+class ManifestEntry:
+    """Recorded state of one file."""
+
+    sha256: str
+    """Hex digest, or ``link:<target>`` for symbolic links."""
+
+    size: int
+    """Size in bytes (0 for symbolic links)."""
+
+    mtime_ns: int
+    """Modification time in nanoseconds (0 for symbolic links)."""
+
+
+@dataclass
+class ManifestVerification:
+    """Result of verifying an installation against its manifest."""
+
+    root: Path
+    missing: List[str] = field(default_factory=list)
+    """Files in the manifest that no longer exist."""
+
+    modified: List[str] = field(default_factory=list)
+    """Files whose content no longer matches the recorded hash."""
+
+    unexpected: List[str] = field(default_factory=list)
+    """Files present in the tree but not in the manifest (e.g. __pycache__)."""
+
+    strict: bool = False
+    """Whether unexpected files make the installation differ."""
+
+    checked: int = 0
+    """Files checked."""
+
+    rehashed: int = 0
+    """Files whose content was hashed (stat changed, or deep mode)."""
+
+    seconds: float = 0.0
+    """Verification wall time."""
+
+    @property
+    def ok(self) -> bool:
+        """Whether the installation matches the manifest."""
+        return not (self.missing or self.modified or (self.strict and self.unexpected))
+
+    def summary(self) -> str:
+        """One-line description of the result."""
+        if self.ok:
+            extra = (
+                f", {len(self.unexpected)} unexpected file(s) ignored"
+                if self.unexpected
+                else ""
+            )
+            return (
+                f"{self.checked} files intact ({self.rehashed} re-hashed, "
+                f"{self.seconds * 1000:.0f} ms){extra}"
+            )
+        parts = []
+        if self.modified:
+            parts.append(f"{len(self.modified)} modified")
+        if self.missing:
+            parts.append(f"{len(self.missing)} missing")
+        if self.unexpected:
+            parts.append(f"{len(self.unexpected)} unexpected")
+        examples = (self.modified + self.missing + self.unexpected)[:3]
+        return f"{', '.join(parts)} file(s): {', '.join(examples)}"
+
+
+def _walk(root: Path) -> Iterator[Tuple[str, os.stat_result]]:
+    """Yield (relative POSIX path, lstat) for every file and link below root."""
+    stack = [root]
+    while stack:
+        directory = stack.pop()
+        try:
+            entries = list(os.scandir(directory))
+        except OSError as e:
+            logger.debug(f"Cannot list {directory}: {e}")
+            continue
+        for entry in entries:
+            if entry.is_dir(follow_symlinks=False):
+                stack.append(Path(entry.path))
+                continue
+            rel = Path(entry.path).relative_to(root).as_posix()
+            if rel == MANIFEST_NAME:
+                continue
+            yield rel, entry.stat(follow_symlinks=False)
+
+
+def _is_link(st: os.stat_result) -> bool:
+    """Whether an lstat result describes a symbolic link."""
+    return stat.S_ISLNK(st.st_mode)
+
+
+class IntegrityManifest:
+    """
+    Per-file hash, size and mtime of an installation directory.
+
+    Example:
+        >>> manifest = IntegrityManifest.create(install_dir)
+        >>> manifest.save()
+        >>> IntegrityManifest.load(install_dir).verify().ok
+        True
+    """
+
+    def __init__(
+        self,
+        root: Path,
+        entries: Optional[Dict[str, ManifestEntry]] = None,
+        created: Optional[str] = None,
+    ):
+        """
+        Initialize manifest.
+
+        Args:
+            root: Installation directory the entries are relative to
+            entries: Relative POSIX path to recorded file state
+            created: ISO timestamp of manifest creation
+        """
+        self.root = Path(root)
+        self.entries: Dict[str, ManifestEntry] = entries or {}
+        self.created = created or datetime.now(timezone.utc).isoformat()
+
+    @property
+    def path(self) -> Path:
+        """Manifest file location."""
+        return self.root / MANIFEST_NAME
+
+    @property
+    def total_size(self) -> int:
+        """Total size of all recorded files in bytes."""
+        return sum(entry.size for entry in self.entries.values())
+
+    @classmethod
+    def create(cls, root: Path, workers: Optional[int] = None) -> "IntegrityManifest":
+        """
+        Hash every file below root.
+
+        Args:
+            root: Installation directory
+            workers: Hashing threads (default: CPU count)
+
+        Returns:
+            New manifest (not yet saved)
+        """
+        root = Path(root)
+        files = list(_walk(root))
+        entries = dict(
+            zip(
+                (rel for rel, _ in files),
+                _hash_entries(root, files, workers),
+            )
+        )
+        return cls(root, entries)
+
+    @classmethod
+    def load(cls, root: Path) -> Optional["IntegrityManifest"]:
+        """
+        Load the manifest of an installation directory.
+
+        Args:
+            root: Installation directory
+
+        Returns:
+            Manifest, or None if the directory has none
+
+        Raises:
+            ManifestError: If the manifest is unreadable
+        """
+        path = Path(root) / MANIFEST_NAME
+        if not path.exists():
+            return None
+        try:
+            data = json.loads(path.read_text(encoding="utf-8"))
+            entries = {
+                rel: ManifestEntry(sha256=v[0], size=v[1], mtime_ns=v[2])
+                for rel, v in data["files"].items()
+            }
+        except (OSError, ValueError, KeyError, IndexError, TypeError) as e:
+            raise ManifestError(f"Invalid manifest {path}: {e}") from e
+        return cls(Path(root), entries, data.get("created"))
+
+    def add(self, paths: Iterable[str], workers: Optional[int] = None) -> None:
+        """
+        Record files added to the installation; only those are hashed.
+
+        Args:
+            paths: Relative POSIX paths below root
+            workers: Hashing threads (default: CPU count)
+        """
+        files = [(rel, os.lstat(self.root / rel)) for rel in paths]
+        self.entries.update(
+            zip((rel for rel, _ in files), _hash_entries(self.root, files, workers))
+        )
+
+    def save(self) -> None:
+        """Write the manifest into the installation directory."""
+        data = {
+            "version": MANIFEST_VERSION,
+            "algorithm": "sha256",
+            "created": self.created,
+            "files": {
+                rel: [e.sha256, e.size, e.mtime_ns]
+                for rel, e in sorted(self.entries.items())
+            },
+        }
+        try:
+            atomic_write(self.path, json.dumps(data, separators=(",", ":")))
+        except OSError as e:
+            raise ManifestError(f"Cannot write manifest {self.path}: {e}") from e
+
+    @tracing.traced("verify manifest", "hash")
+    def verify(
+        self,
+        deep: bool = False,
+        workers: Optional[int] = None,
+        update: bool = False,
+        strict: bool = False,
+    ) -> ManifestVerification:
+        """
+        Verify the installation against the manifest.
+
+        Files whose size and mtime match the manifest are trusted; the rest
+        are re-hashed. A file whose content still matches but whose mtime
+        changed (e.g. after ``touch``) gets its stat data refreshed in memory.
+        Files not in the manifest are listed in ``unexpected``.
+
+        Args:
+            deep: Re-hash every file regardless of stat data
+            workers: Hashing threads (default: CPU count)
+            update: Save refreshed stat data back to the manifest; only the
+                installing code does, checks leave the tree untouched
+            strict: Count unexpected files as a difference
+
+        Returns:
+            ManifestVerification
+        """
+        start = time.perf_counter()
+        result = ManifestVerification(root=self.root, strict=strict)
+
+        present = dict(_walk(self.root))
+        result.unexpected = sorted(set(present) - set(self.entries))
+
+        to_hash = []
+        for rel, entry in self.entries.items():
+            st = present.get(rel)
+            if st is None:
+                result.missing.append(rel)
+                continue
+            result.checked += 1
+            if _is_link(st) or entry.sha256.startswith(_LINK_PREFIX):
+                if _entry_for(self.root / rel, st).sha256 != entry.sha256:
+                    result.modified.append(rel)
+            elif deep or st.st_size != entry.size or st.st_mtime_ns != entry.mtime_ns:
+                to_hash.append((rel, st))
+
+        refreshed = False
+        for (rel, st), actual in zip(
+            to_hash, _hash_entries(self.root, to_hash, workers)
+        ):
+            result.rehashed += 1
+            if actual.sha256 != self.entries[rel].sha256:
+                result.modified.append(rel)
+            elif actual.mtime_ns != self.entries[rel].mtime_ns:
+                self.entries[rel] = actual
+                refreshed = True
+
+        if refreshed and update:
+            try:
+                self.save()
+            except ManifestError as e:
+                logger.debug(f"Could not refresh manifest: {e}")
+
+        result.missing.sort()
+        result.modified.sort()
+        result.seconds = time.perf_counter() - start
+        return result
+
+    def digest(self) -> str:
+        """Tree digest of the recorded files (see tree_digest())."""
+        return tree_digest({rel: e.sha256 for rel, e in self.entries.items()})
+
+    def file_hash(self, path: Path) -> Optional[str]:
+        """
+        SHA256 of one file, re-hashing only if its stat data changed.
+
+        Args:
+            path: File inside the installation directory
+
+        Returns:
+            Hex digest, or None if the file is not in the manifest or missing
+        """
+        try:
+            rel = Path(path).resolve().relative_to(self.root.resolve()).as_posix()
+        except ValueError:
+            return None
+        entry = self.entries.get(rel)
+        if entry is None or entry.sha256.startswith(_LINK_PREFIX):
+            return None
+        try:
+            st = (self.root / rel).stat()
+        except OSError:
+            return None
+        if st.st_size == entry.size and st.st_mtime_ns == entry.mtime_ns:
+            return entry.sha256
+        return hash_file(self.root / rel)
+
+
+def tree_digest(hashes: Mapping[str, str]) -> str:
+    """
+    Digest of a whole installation from its per-file hashes.
+
+    Lock files pin this value so that a tree unpacked from an offline bundle
+    can be checked without the original archive.
+
+    Args:
+        hashes: Relative POSIX path to SHA256 (``link:<target>`` for links)
+
+    Returns:
+        Hex SHA256 over the sorted (path, hash) pairs
+    """
+    hasher = hashlib.sha256()
+    for rel, digest in sorted(hashes.items()):
+        hasher.update(f"{rel}\0{digest}\n".encode("utf-8"))
+    return hasher.hexdigest()
+
+
+def _entry_for(path: Path, st: os.stat_result) -> ManifestEntry:
+    """Current manifest entry of one file."""
+    if _is_link(st):
+        return ManifestEntry(_LINK_PREFIX + os.readlink(path), 0, 0)
+    return ManifestEntry(hash_file(path), st.st_size, st.st_mtime_ns)
+
+
+@tracing.traced("hash files", "hash")
+def _hash_entries(
+    root: Path, files: List[Tuple[str, os.stat_result]], workers: Optional[int]
+) -> List[ManifestEntry]:
+    """Compute entries for many files in parallel (order preserved)."""
+    if not files:
+        return []
+    workers = workers or os.cpu_count() or 1
+    if workers == 1 or len(files) == 1:
+        return [_entry_for(root / rel, st) for rel, st in files]
+    with ThreadPoolExecutor(max_workers=workers) as pool:
+        return list(pool.map(lambda item: _entry_for(root / item[0], item[1]), files))
+
+
+@tracing.traced("write manifest", "hash")
+def write_manifest(root: Path) -> Optional[IntegrityManifest]:
+    """
+    Create and save the manifest of a freshly installed directory.
+
+    Failures are logged, not raised: a missing manifest only means later
+    verification falls back to hashing.
+
+    Args:
+        root: Installation directory
+
+    Returns:
+        Saved manifest, or None if it could not be written
+    """
+    try:
+        start = time.perf_counter()
+        manifest = IntegrityManifest.create(root)
+        manifest.save()
+        logger.debug(
+            f"Wrote manifest for {root}: {len(manifest.entries)} files "
+            f"in {time.perf_counter() - start:.2f}s"
+        )
+        return manifest
+    except (OSError, ManifestError) as e:
+        logger.warning(f"Could not write integrity manifest for {root}: {e}")
+        return None
+
+
+def find_manifest(
+    path: Union[str, Path], stop_at: Optional[Path] = None
+) -> Optional[IntegrityManifest]:
+    """
+    Find the manifest of the installation containing path.
+
+    Args:
+        path: File or directory inside an installation
+        stop_at: Do not search above this directory
+
+    Returns:
+        Manifest, or None if no enclosing installation has one
+    """
+    current = Path(path)
+    if not current.is_dir():
+        current = current.parent
+    stop = Path(stop_at).resolve() if stop_at else None
+    while True:
+        if (current / MANIFEST_NAME).exists():
+            try:
+                return IntegrityManifest.load(current)
+            except ManifestError as e:
+                logger.warning(str(e))
+                return None
+        if stop is not None and current.resolve() == stop:
+            return None
+        if current.parent == current:
+            return None
+        current = current.parent
@@ -0,0 +1,255 @@
+"""
+LAN mirror of the global downloads directory.
+
+Serves the archives in ``~/.toolchainkit/downloads`` over plain HTTP so that
+other machines can list this one as a mirror (``TOOLCHAINKIT_MIRRORS`` or
+``download.mirrors`` in toolchainkit.yaml) instead of downloading the same
+archives from GitHub again. Files are served by name with HTTP Range
+support, which the download manager uses to probe mirrors and to continue a
+download that another source started.
+
+Mirrors are untrusted: clients verify every file against the SHA-256 from
+the toolchain metadata or lock file, so the server needs no authentication
+or integrity metadata of its own.
+
+Example:
+    >>> from toolchainkit.core.mirror import MirrorServer
+    >>> with MirrorServer(downloads_dir, host="0.0.0.0").start() as server:
+    ...     print(server.url)
+"""
+
+import logging
+import os
+import re
+import socket
+import threading
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+from pathlib import Path
+from typing import Optional, Tuple
+from urllib.parse import unquote, urlparse
+
+logger = logging.getLogger(__name__)
+
+DEFAULT_PORT = 8421
+"""Default TCP port of ``tkgen mirror serve``."""
+
+_RANGE = re.compile(r"^bytes=(\d*)-(\d*)$")
+
+
+def parse_range(header: str, size: int) -> Optional[Tuple[int, int]]:
+    """
+    Parse a single-range ``Range`` header.
+
+    Args:
+        header: Header value, e.g. 'bytes=100-' or 'bytes=-500'
+        size: File size in bytes
+
+    Returns:
+        Inclusive (first, last) byte positions, or None if the range cannot
+        be satisfied or is not a single byte range
+    """
+    match = _RANGE.match(header.strip())
+    if not match or match.groups() == ("", ""):
+        return None
+    first, last = match.groups()
+    if not first:
+        length = int(last)
+        if length == 0:
+            return None
+        return max(size - length, 0), size - 1
+    start = int(first)
+    end = min(int(last), size - 1) if last else size - 1
+    if start >= size or end < start:
+        return None
+    return start, end
+
+
+class _MirrorRequestHandler(BaseHTTPRequestHandler):
+    """Read-only file handler with single-range support."""
+
+    server_version = "ToolchainKitMirror/1.0"
+    protocol_version = "HTTP/1.1"
+
+    def log_message(self, format, *args):  # noqa: A002 - signature from base class
+        logger.debug("%s - %s", self.address_string(), format % args)
+
+    def _file(self) -> Optional[Path]:
+        """Resolve the request path to a file below the root, or None."""
+        path = unquote(urlparse(self.path).path).strip("/")
+        parts = [p for p in path.split("/") if p]
+        if not parts or any(p in (".", "..") or p.startswith(".") for p in parts):
+            return None
+        candidate = self.server.root.joinpath(*parts)  # type: ignore[attr-defined]
+        return candidate if candidate.is_file() else None
+
+    def _reply(self, status: int, headers: Optional[dict] = None) -> None:
+        self.send_response(status)
+        for name, value in (headers or {"Content-Length": "0"}).items():
+            self.send_header(name, value)
+        self.end_headers()
+
+    def do_HEAD(self):
+        self.do_GET()
+
+    def do_GET(self):
+        path = self._file()
+        if path is None:
+            self._reply(404)
+            return
+        try:
+            handle = open(path, "rb")
+        except OSError:
+            self._reply(404)
+            return
+
+        with handle:
+            size = os.fstat(handle.fileno()).st_size
+            first, last = 0, size - 1
+            status = 200
+            headers = {
+                "Content-Type": "application/octet-stream",
+                "Accept-Ranges": "bytes",
+            }
+            range_header = self.headers.get("Range")
+            if range_header:
+                byte_range = parse_range(range_header, size)
+                if byte_range is None:
+                    self._reply(
+                        416, {"Content-Range": f"bytes */{size}", "Content-Length": "0"}
+                    )
+                    return
+                first, last = byte_range
+                status = 206
+                headers["Content-Range"] = f"bytes {first}-{last}/{size}"
+            length = max(last - first + 1, 0)
+            headers["Content-Length"] = str(length)
+            self._reply(status, headers)
+            if self.command == "HEAD" or length == 0:
+                return
+
+            handle.seek(first)
+            try:
+                self._send(handle, length)
+            except (BrokenPipeError, ConnectionResetError):
+                # Clients close early when probing or failing over
+                self.close_connection = True
+
+    def _send(self, handle, length: int) -> None:
+        """Copy ``length`` bytes of ``handle`` to the client."""
+        if hasattr(os, "sendfile"):
+            try:
+                self.wfile.flush()
+                offset, remaining = handle.tell(), length
+                while remaining > 0:
+                    sent = os.sendfile(
+                        self.connection.fileno(), handle.fileno(), offset, remaining
+                    )
+                    if sent == 0:
+                        break
+                    offset += sent
+                    remaining -= sent
+                return
+            except OSError as e:
+                if isinstance(e, (BrokenPipeError, ConnectionResetError)):
+                    raise
+                # Not supported for this socket/file; fall back to copying
+        remaining = length
+        while remaining > 0:
+            chunk = handle.read(min(remaining, 1024 * 1024))
+            if not chunk:
+                break
+            self.wfile.write(chunk)
+            remaining -= len(chunk)
+
+
+class MirrorServer:
+    """
+    Threaded HTTP server exposing a directory of downloaded archives.
+
+    Attributes:
+        root: Served directory
+        host: Bind address
+        port: Bound TCP port (resolved after binding when 0 was requested)
+    """
+
+    def __init__(self, root: Path, host: str = "127.0.0.1", port: int = DEFAULT_PORT):
+        """
+        Initialize and bind the server.
+
+        Args:
+            root: Directory to serve (usually <global cache>/downloads)
+            host: Bind address ('0.0.0.0' to serve the LAN)
+            port: TCP port (0 picks a free port)
+        """
+        self.root = Path(root)
+        self.root.mkdir(parents=True, exist_ok=True)
+        self._httpd = ThreadingHTTPServer((host, port), _MirrorRequestHandler)
+        self._httpd.daemon_threads = True
+        self._httpd.root = self.root  # type: ignore[attr-defined]
+        self.host, self.port = self._httpd.server_address[:2]
+        self._thread: Optional[threading.Thread] = None
+
+    @property
+    def url(self) -> str:
+        """Base URL clients should list as a mirror."""
+        host = self.host
+        if host in ("0.0.0.0", ""):
+            host = socket.gethostname()
+        elif host == "::":
+            host = "localhost"
+        return f"http://{host}:{self.port}/"
+
+    def start(self) -> "MirrorServer":
+        """Serve requests on a background thread."""
+        self._thread = threading.Thread(
+            target=self._httpd.serve_forever,
+            kwargs={"poll_interval": 0.05},
+            name="tk-mirror-server",
+            daemon=True,
+        )
+        self._thread.start()
+        logger.info(f"Mirror server listening on {self.url}")
+        return self
+
+    def serve_forever(self) -> None:
+        """Serve requests on the calling thread until shutdown()."""
+        logger.info(f"Mirror server listening on {self.url}")
+        self._httpd.serve_forever()
+
+    def shutdown(self) -> None:
+        """Stop serving and release the socket."""
+        if self._thread is not None:
+            self._httpd.shutdown()
+            self._thread.join()
+            self._thread = None
+        self._httpd.server_close()
+
+    def __enter__(self) -> "MirrorServer":
+        return self
+
+    def __exit__(self, exc_type, exc, tb) -> None:
+        self.shutdown()
+
+
+def summarize_directory(root: Path) -> Tuple[int, int]:
+    """
+    Count the files a mirror would serve.
+
+    Args:
+        root: Served directory
+
+    Returns:
+        (file count, total bytes)
+    """
+    count = total = 0
+    for dirpath, dirnames, filenames in os.walk(root):
+        dirnames[:] = [d for d in dirnames if not d.startswith(".")]
+        for name in filenames:
+            if name.startswith("."):
+                continue
+            try:
+                total += os.stat(os.path.join(dirpath, name)).st_size
+            except OSError:
+                continue
+            count += 1
+    return count, total
@@ -0,0 +1,348 @@
+"""
+Lightweight phase tracing.
+
+Code marks phases with nested spans:
+
+    from toolchainkit.core import tracing
+
+    with tracing.span("extract", "extract", archive=name):
+        ...
+
+    @tracing.traced("generate toolchain file", "cmake")
+    def generate(...): ...
+
+Tracing is off unless a tracer is enabled (``tkgen --trace``). While off,
+``span()`` returns a shared no-op context manager, so an instrumented call
+costs one function call and a global lookup.
+
+An enabled tracer records every finished span with its thread, start,
+duration and self time (duration minus child spans on the same thread). It
+can be written as Chrome trace JSON (chrome://tracing, Perfetto) and
+summarized as a table of total and self time per span name.
+
+Locks are traced with ``acquired()``, which records the time spent waiting
+for a lock separately from the time it is held.
+"""
+
+import functools
+import json
+import os
+import threading
+import time
+from contextlib import contextmanager
+from pathlib import Path
+from typing import Any, Callable, Dict, Iterator, List, Optional, Union
+
+
+class _NullSpan:
+    """Span used while tracing is disabled."""
+
+    __slots__ = ()
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *exc):
+        return False
+
+    def set(self, **args: Any) -> None:
+        """Ignore span arguments."""
+
+
+_NULL_SPAN = _NullSpan()
+
+
+class Span:
+    """A phase being timed; records itself when it exits."""
+
+    __slots__ = ("tracer", "name", "category", "args", "start", "children")
+
+    def __init__(self, tracer: "Tracer", name: str, category: str, args: dict):
+        self.tracer = tracer
+        self.name = name
+        self.category = category
+        self.args = args
+        self.start = 0
+        self.children = 0
+
+    def set(self, **args: Any) -> None:
+        """Attach arguments (shown in the trace viewer), e.g. sizes or results."""
+        self.args.update(args)
+
+    def __enter__(self):
+        self.tracer._stack().append(self)
+        self.start = time.perf_counter_ns()
+        return self
+
+    def __exit__(self, exc_type, exc, tb):
+        end = time.perf_counter_ns()
+        stack = self.tracer._stack()
+        stack.pop()
+        duration = end - self.start
+        if stack:
+            stack[-1].children += duration
+        if exc_type is not None:
+            self.args["error"] = exc_type.__name__
+        self.tracer._record(self, duration)
+        return False
+
+
+class Tracer:
+    """Collects finished spans of this process."""
+
+    def __init__(self):
+        """Initialize an empty tracer; time zero is now."""
+        self.origin = time.perf_counter_ns()
+        self.pid = os.getpid()
+        self.events: List[Dict[str, Any]] = []
+        self._local = threading.local()
+        self._lock = threading.Lock()
+
+    def _stack(self) -> List[Span]:
+        stack = getattr(self._local, "stack", None)
+        if stack is None:
+            stack = self._local.stack = []
+        return stack
+
+    def _record(self, span: Span, duration: int) -> None:
+        event = {
+            "name": span.name,
+            "cat": span.category,
+            "ts": (span.start - self.origin) / 1000,
+            "dur": duration / 1000,
+            "self": (duration - span.children) / 1000,
+            "tid": threading.get_native_id(),
+            "args": span.args,
+        }
+        with self._lock:
+            self.events.append(event)
+
+    def chrome_trace(self) -> Dict[str, Any]:
+        """
+        Events in Chrome trace event format.
+
+        Returns:
+            Dict with "traceEvents" (complete events, times in microseconds)
+        """
+        events: List[Dict[str, Any]] = [
+            {
+                "name": "process_name",
+                "ph": "M",
+                "pid": self.pid,
+                "tid": 0,
+                "args": {"name": "tkgen"},
+            }
+        ]
+        for event in self.events:
+            events.append(
+                {
+                    "name": event["name"],
+                    "cat": event["cat"],
+                    "ph": "X",
+                    "ts": event["ts"],
+                    "dur": event["dur"],
+                    "pid": self.pid,
+                    "tid": event["tid"],
+                    "args": event["args"],
+                }
+            )
+        return {"traceEvents": events, "displayTimeUnit": "ms"}
+
+    def write_chrome_trace(self, path: Union[str, Path]) -> Path:
+        """
+        Write the Chrome trace JSON file.
+
+        Args:
+            path: Output file (parent directories are created)
+
+        Returns:
+            The written path
+        """
+        path = Path(path)
+        path.parent.mkdir(parents=True, exist_ok=True)
+        path.write_text(json.dumps(self.chrome_trace(), default=str), encoding="utf-8")
+        return path
+
+    def totals(self) -> List[Dict[str, Any]]:
+        """
+        Aggregate spans by name.
+
+        Returns:
+            Dicts with name, category, count, total_ms, self_ms and max_ms,
+            sorted by total time (longest first)
+        """
+        totals: Dict[str, Dict[str, Any]] = {}
+        for event in self.events:
+            entry = totals.setdefault(
+                event["name"],
+                {
+                    "name": event["name"],
+                    "category": event["cat"],
+                    "count": 0,
+                    "total_ms": 0.0,
+                    "self_ms": 0.0,
+                    "max_ms": 0.0,
+                },
+            )
+            entry["count"] += 1
+            entry["total_ms"] += event["dur"] / 1000
+            entry["self_ms"] += event["self"] / 1000
+            entry["max_ms"] = max(entry["max_ms"], event["dur"] / 1000)
+        return sorted(totals.values(), key=lambda e: e["total_ms"], reverse=True)
+
+    def summary(self, limit: int = 25) -> str:
+        """
+        Format the per-name totals as a table.
+
+        Args:
+            limit: Maximum number of rows
+
+        Returns:
+            Table text (no trailing newline)
+        """
+        rows = self.totals()
+        width = max([len(r["name"]) for r in rows[:limit]] + [4])
+        lines = [
+            f"  {'Span':<{width}}  {'Count':>6}  {'Total ms':>10}  {'Self ms':>10}"
+        ]
+        for row in rows[:limit]:
+            lines.append(
+                f"  {row['name']:<{width}}  {row['count']:>6}  "
+                f"{row['total_ms']:>10.1f}  {row['self_ms']:>10.1f}"
+            )
+        if len(rows) > limit:
+            lines.append(f"  ... {len(rows) - limit} more span names in the trace")
+        return "\n".join(lines)
+
+
+_tracer: Optional[Tracer] = None
+
+
+def enable() -> Tracer:
+    """
+    Start recording spans in this process.
+
+    Returns:
+        The active tracer (a new one if tracing was off)
+    """
+    global _tracer
+    if _tracer is None:
+        _tracer = Tracer()
+    return _tracer
+
+
+def disable() -> Optional[Tracer]:
+    """
+    Stop recording spans.
+
+    Returns:
+        The tracer that was active, with its recorded events, or None
+    """
+    global _tracer
+    tracer, _tracer = _tracer, None
+    return tracer
+
+
+def get_tracer() -> Optional[Tracer]:
+    """The active tracer, or None if tracing is off."""
+    return _tracer
+
+
+def span(name: str, category: str = "toolchainkit", **args: Any):
+    """
+    Time a phase.
+
+    Args:
+        name: Span name (aggregated by name in the summary)
+        category: Category shown in the trace viewer
+        **args: Arguments attached to the span
+
+    Returns:
+        Context manager yielding an object with ``set(**args)``
+    """
+    tracer = _tracer
+    if tracer is None:
+        return _NULL_SPAN
+    return Span(tracer, name, category, args)
+
+
+def annotate(**args: Any) -> None:
+    """
+    Attach arguments to the innermost open span of this thread.
+
+    Useful inside functions wrapped with ``traced()``; does nothing while
+    tracing is off or outside any span.
+    """
+    tracer = _tracer
+    if tracer is None:
+        return
+    stack = tracer._stack()
+    if stack:
+        stack[-1].args.update(args)
+
+
+def traced(name: Optional[str] = None, category: str = "toolchainkit") -> Callable:
+    """
+    Decorator running a function inside a span.
+
+    Args:
+        name: Span name (default: the function's qualified name)
+        category: Category shown in the trace viewer
+    """
+
+    def decorator(func: Callable) -> Callable:
+        span_name = name or func.__qualname__
+
+        @functools.wraps(func)
+        def wrapper(*args, **kwargs):
+            tracer = _tracer
+            if tracer is None:
+                return func(*args, **kwargs)
+            with Span(tracer, span_name, category, {}):
+                return func(*args, **kwargs)
+
+        return wrapper
+
+    return decorator
+
+
+@contextmanager
+def acquired(lock: Any, name: str) -> Iterator[Any]:
+    """
+    Enter a lock's context, tracing wait and hold time separately.
+
+    Args:
+        lock: Lock usable in a with statement (e.g. filelock.FileLock)
+        name: Lock name; spans are "lock wait: <name>" and "lock hold: <name>"
+
+    Yields:
+        The lock
+
+    Raises:
+        Whatever entering the lock raises (e.g. a timeout)
+    """
+    if _tracer is None:
+        with lock:
+            yield lock
+        return
+
+    with span(f"lock wait: {name}", "lock"):
+        lock.__enter__()
+    try:
+        with span(f"lock hold: {name}", "lock"):
+            yield lock
+    finally:
+        lock.__exit__(None, None, None)
+
+
+__all__ = [
+    "Span",
+    "Tracer",
+    "acquired",
+    "annotate",
+    "disable",
+    "enable",
+    "get_tracer",
+    "span",
+    "traced",
+]
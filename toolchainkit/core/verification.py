@@ -9,13 +9,14 @@ This module provides cryptographic hash verification capabilities including:
 - Optional GPG signature verification
 """
 
-import hashlib
 import logging
 import secrets
 import subprocess
 from pathlib import Path
 from typing import Callable, Optional
 
+from .hashing import hash_file, hash_file_multi
+
 logger = logging.getLogger(__name__)
 
 
@@ -59,39 +60,39 @@ def compute_file_hash(
     if not file_path.exists():
         raise FileNotFoundError(f"File not found: {file_path}")
 
+    algorithm = _check_algorithm(algorithm)
+    return hash_file(file_path, algorithm, progress_callback=progress_callback)
+
+
+def _check_algorithm(algorithm: str) -> str:
+    """
+    Validate a verification algorithm, warning about weak ones.
+
+    Args:
+        algorithm: Hash algorithm name
+
+    Returns:
+        Lower-case algorithm name
+
+    Raises:
+        ValueError: If algorithm is not supported
+    """
     algorithm = algorithm.lower()
 
-    if algorithm == "sha256":
-        hasher = hashlib.sha256()
-    elif algorithm == "sha512":
-        hasher = hashlib.sha512()
-    elif algorithm == "md5":
+    if algorithm == "md5":
         logger.warning(
             "MD5 is cryptographically broken and should not be used for security. "
             "Use SHA256 or SHA512 instead."
         )
-        hasher = hashlib.md5()
     elif algorithm == "sha1":
         logger.warning(
             "SHA1 is cryptographically weak and should not be used for security. "
             "Use SHA256 or SHA512 instead."
         )
-        hasher = hashlib.sha1()
-    else:
+    elif algorithm not in ("sha256", "sha512"):
         raise ValueError(f"Unsupported hash algorithm: {algorithm}")
 
-    file_size = file_path.stat().st_size
-    bytes_read = 0
-
-    with open(file_path, "rb") as f:
-        while chunk := f.read(8192):
-            hasher.update(chunk)
-            bytes_read += len(chunk)
-
-            if progress_callback:
-                progress_callback(bytes_read, file_size)
-
-    return hasher.hexdigest()
+    return algorithm
 
 
 def verify_file_hash(
@@ -148,14 +149,35 @@ def verify_multiple_hashes(file_path: Path, hashes: dict[str, str]) -> dict[str,
         ...     print("All hashes valid")
     """
     results = {}
+    expected_hashes = {}
     for algorithm, expected in hashes.items():
+        expected = expected.lower().strip()
         try:
-            results[algorithm] = verify_file_hash(file_path, expected, algorithm)
+            _check_algorithm(algorithm)
+            if not _is_valid_hash_format(expected, algorithm):
+                raise HashFormatError(
+                    f"Invalid hash format for {algorithm}: {expected}"
+                )
         except Exception as e:
             logger.error(f"Failed to verify {algorithm} hash: {e}")
             results[algorithm] = False
+            continue
+        expected_hashes[algorithm] = expected
 
-    return results
+    # Compute all digests in a single read of the file
+    if expected_hashes:
+        try:
+            actual = hash_file_multi(file_path, [a.lower() for a in expected_hashes])
+        except Exception as e:
+            logger.error(f"Failed to verify hashes of {file_path}: {e}")
+            actual = {}
+        for algorithm, expected in expected_hashes.items():
+            actual_hash = actual.get(algorithm.lower())
+            results[algorithm] = actual_hash is not None and _constant_time_compare(
+                actual_hash, expected
+            )
+
+    return {algorithm: results[algorithm] for algorithm in hashes}
 
 
 def parse_hash_file(hash_file_path: Path) -> dict[str, str]:
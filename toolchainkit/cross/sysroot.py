@@ -9,6 +9,7 @@ from pathlib import Path
 from dataclasses import dataclass
 from typing import Optional, Callable, List
 import shutil
+from toolchainkit.core.cache_registry import ToolchainCacheRegistry
 from toolchainkit.core.download import download_file
 from toolchainkit.core.filesystem import extract_archive
 
@@ -87,6 +88,8 @@ class SysrootManager:
         self.downloads_dir = self.cache_dir / "downloads"
         self.downloads_dir.mkdir(parents=True, exist_ok=True)
         self.downloader = downloader
+        # Sysroots are accounted in the cache registry for the size quota
+        self.registry = ToolchainCacheRegistry(cache_dir / "registry.json")
 
     def download_sysroot(
         self,
@@ -127,6 +130,11 @@ class SysrootManager:
 
         # Check if already downloaded
         if target_dir.exists() and not force:
+            if not self.registry.touch_artifact(target_dir):
+                # Installed before sizes were tracked
+                self.registry.register_artifact(
+                    target_dir, "sysroot", self._get_dir_size(target_dir)
+                )
             return target_dir
 
         # Determine archive filename from URL
@@ -198,6 +206,13 @@ class SysrootManager:
         if archive_path.exists():
             archive_path.unlink()
 
+        from toolchainkit.toolchain.cleanup import enforce_cache_quota
+
+        self.registry.register_artifact(
+            target_dir, "sysroot", self._get_dir_size(target_dir)
+        )
+        enforce_cache_quota(self.registry, protect=[str(target_dir.resolve())])
+
         return target_dir
 
     def get_sysroot_path(self, target: str, version: str) -> Optional[Path]:
@@ -256,6 +271,7 @@ class SysrootManager:
         path = self.cache_dir / f"{target}-{version}"
         if path.exists():
             shutil.rmtree(path)
+            self.registry.unregister_artifact(path)
             return True
         return False
 
@@ -291,6 +307,7 @@ class SysrootManager:
         for entry in self.cache_dir.iterdir():
             if entry.is_dir() and entry.name != "downloads":
                 shutil.rmtree(entry)
+                self.registry.unregister_artifact(entry)
                 count += 1
         return count
 
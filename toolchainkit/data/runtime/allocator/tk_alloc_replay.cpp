@@ -0,0 +1,649 @@
+// ToolchainKit allocation trace replay.
+//
+// Replays a trace written by the allocator proxy (TOOLCHAINKIT_ALLOCATOR_TRACE)
+// against the allocator this program is linked with, or loads through the
+// proxy. Every traced thread gets a replay thread that makes the same calls
+// in the same order, as fast as it can; the time between calls is not
+// replayed. A block freed by another thread than the one that allocated it
+// is handed over as in the traced program: the freeing thread waits until
+// the allocating thread has allocated it. All threads start together.
+//
+// Reported are the wall time and time per call, and, from a sampler thread,
+// the resident set size (RSS) and the bytes held allocated over time.
+// Fragmentation is the share of the RSS gained during the replay that does
+// not hold allocated bytes. Each new block's pages are written once, as a
+// program would, unless --no-touch is given; untouched pages are not
+// resident.
+//
+// Frees are paired with allocations by address in time order, like
+// toolchainkit.profiling.alloc_trace: frees of blocks allocated before the
+// trace (or a trimmed window) starts are skipped.
+//
+// Usage: tk_alloc_replay [--json] [--interval MS] [--no-touch] TRACE
+//   TRACE  Trace file, or - for standard input (gzip -dc trace.gz | ...)
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#if defined(__linux__)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+// Defined when the program is linked with the allocator proxy
+extern "C" const char* tk_malloc_proxy_allocator(void) __attribute__((weak));
+
+namespace {
+
+enum TraceOp : uint8_t {
+    kTraceMalloc = 1,
+    kTraceFree = 2,
+    kTraceRealloc = 3,
+    kTraceAligned = 4,
+    kTraceCalloc = 5,
+};
+
+struct TraceEvent {
+    uint64_t time;
+    uint64_t address;
+    uint64_t size;
+    uint64_t moved;
+    uint8_t op;
+    uint8_t alignment;  // log2
+};
+
+enum OpKind : uint8_t { kMalloc, kCalloc, kAligned, kRealloc, kFree };
+
+// One call of a replay thread. Blocks are numbered in allocation order; a
+// realloc frees one block and allocates another.
+struct Op {
+    OpKind kind;
+    uint8_t alignment;  // log2, kAligned
+    bool wait;          // block was allocated by another thread
+    uint32_t block;     // Allocated, or freed (kFree, kRealloc's old)
+    uint32_t moved;     // kRealloc's new block
+    uint64_t size;
+};
+
+struct alignas(64) ThreadState {
+    std::vector<Op> ops;
+    std::atomic<int64_t> live{0};  // Requested bytes allocated here minus freed here
+    uint64_t waits = 0;
+    double seconds = 0;
+};
+
+struct Sample {
+    double ms;
+    uint64_t rss;
+    int64_t live;
+};
+
+struct Replay {
+    std::vector<std::unique_ptr<ThreadState>> threads;
+    std::unique_ptr<std::atomic<void*>[]> blocks;
+    std::vector<uint64_t> sizes;  // Per block
+    uint64_t calls = 0;
+    uint64_t cross_thread_frees = 0;
+    uint64_t unmatched_frees = 0;
+    uint64_t reordered = 0;
+};
+
+void* const kFailed = reinterpret_cast<void*>(uintptr_t{1});  // Allocation returned null
+
+[[noreturn]] void fail(const std::string& message) {
+    fprintf(stderr, "tk_alloc_replay: %s\n", message.c_str());
+    exit(1);
+}
+
+std::vector<uint8_t> read_input(const char* path) {
+    FILE* in = strcmp(path, "-") == 0 ? stdin : fopen(path, "rb");
+    if (in == nullptr) {
+        fail(std::string("cannot open ") + path + ": " + strerror(errno));
+    }
+    std::vector<uint8_t> data;
+    uint8_t buffer[1 << 16];
+    size_t n;
+    while ((n = fread(buffer, 1, sizeof(buffer), in)) > 0) {
+        data.insert(data.end(), buffer, buffer + n);
+    }
+    if (in != stdin) {
+        fclose(in);
+    }
+    return data;
+}
+
+template <typename T>
+T load(const uint8_t* p) {
+    T value;
+    memcpy(&value, p, sizeof(value));  // Traces are little-endian, like the hosts
+    return value;
+}
+
+class ChunkReader {
+public:
+    ChunkReader(const uint8_t* data, size_t size) : p_(data), end_(data + size) {}
+
+    bool done() const { return p_ == end_; }
+
+    uint8_t byte() {
+        check(1);
+        return *p_++;
+    }
+
+    uint64_t varint() {
+        uint64_t value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            uint8_t b = byte();
+            value |= uint64_t(b & 0x7F) << shift;
+            if (b < 0x80) {
+                return value;
+            }
+        }
+        fail("corrupt trace: overlong number");
+    }
+
+    uint64_t address() {
+        uint64_t zigzag = varint();
+        address_ += (zigzag >> 1) ^ (~(zigzag & 1) + 1);
+        return address_;
+    }
+
+private:
+    void check(size_t n) {
+        if (size_t(end_ - p_) < n) {
+            fail("corrupt trace: truncated chunk");
+        }
+    }
+
+    const uint8_t* p_;
+    const uint8_t* end_;
+    uint64_t address_ = 0;
+};
+
+// Events per traced thread, in thread order of first appearance.
+std::vector<std::vector<TraceEvent>> parse(const std::vector<uint8_t>& data) {
+    if (data.size() >= 2 && data[0] == 0x1f && data[1] == 0x8b) {
+        fail("the trace is gzip-compressed; use: gzip -dc TRACE | tk_alloc_replay -");
+    }
+    if (data.size() >= 6 && memcmp(data.data(), "\xfd" "7zXZ", 5) == 0) {
+        fail("the trace is xz-compressed; use: xz -dc TRACE | tk_alloc_replay -");
+    }
+    if (data.size() < 32 || memcmp(data.data(), "TKAT", 4) != 0) {
+        fail("not an allocation trace");
+    }
+    if (load<uint32_t>(&data[4]) != 1) {
+        fail("unsupported trace version");
+    }
+    uint64_t start = load<uint64_t>(&data[8]);
+    std::map<uint32_t, size_t> index;
+    std::vector<std::vector<TraceEvent>> threads;
+    size_t pos = 32;  // Times stay in ticks; only their order matters
+    while (pos + 16 <= data.size()) {  // A partial last chunk is ignored
+        uint32_t thread = load<uint32_t>(&data[pos]);
+        uint32_t size = load<uint32_t>(&data[pos + 4]);
+        uint64_t time = load<uint64_t>(&data[pos + 8]) - start;
+        pos += 16;
+        if (size > data.size() - pos) {
+            break;
+        }
+        if (size == 0) {
+            continue;
+        }
+        auto found = index.emplace(thread, threads.size());
+        if (found.second) {
+            threads.emplace_back();
+        }
+        std::vector<TraceEvent>& events = threads[found.first->second];
+        ChunkReader reader(&data[pos], size);
+        while (!reader.done()) {
+            uint8_t op = reader.byte();
+            TraceEvent event = {};
+            event.op = op & 7;
+            time += reader.varint();
+            event.time = time;
+            switch (event.op) {
+            case kTraceFree:
+                event.address = reader.address();
+                break;
+            case kTraceRealloc:
+                event.address = reader.address();
+                event.size = reader.varint();
+                event.moved = reader.address();
+                break;
+            case kTraceMalloc:
+            case kTraceCalloc:
+            case kTraceAligned:
+                event.size = reader.varint();
+                event.address = reader.address();
+                event.alignment = op >> 3;
+                break;
+            default:
+                fail("corrupt trace: unknown event");
+            }
+            events.push_back(event);
+        }
+        pos += size;
+    }
+    return threads;
+}
+
+// Pairs frees with allocations by address, all threads in time order.
+Replay prepare(std::vector<std::vector<TraceEvent>> events) {
+    struct Ref {
+        uint64_t time;
+        bool allocates;  // Frees first at equal times
+        uint32_t thread;
+        uint32_t index;
+    };
+    std::vector<Ref> order;
+    for (uint32_t t = 0; t < events.size(); ++t) {
+        for (uint32_t i = 0; i < events[t].size(); ++i) {
+            order.push_back({events[t][i].time, events[t][i].op != kTraceFree, t, i});
+        }
+    }
+    std::sort(order.begin(), order.end(), [](const Ref& a, const Ref& b) {
+        if (a.time != b.time) return a.time < b.time;
+        if (a.allocates != b.allocates) return !a.allocates;
+        if (a.thread != b.thread) return a.thread < b.thread;
+        return a.index < b.index;
+    });
+
+    Replay replay;
+    for (size_t t = 0; t < events.size(); ++t) {
+        replay.threads.push_back(std::make_unique<ThreadState>());
+    }
+    std::vector<uint32_t> owner;                    // Allocating thread per block
+    std::unordered_map<uint64_t, uint32_t> live;  // Address -> block
+    auto create = [&](uint32_t thread, uint64_t size) {
+        owner.push_back(thread);
+        replay.sizes.push_back(size);
+        return uint32_t(owner.size() - 1);
+    };
+    auto release = [&](uint32_t thread, uint64_t address, Op* op) {
+        auto it = live.find(address);
+        if (it == live.end()) {
+            return false;
+        }
+        op->block = it->second;
+        op->wait = owner[it->second] != thread;
+        live.erase(it);
+        return true;
+    };
+    auto emit = [&](uint32_t thread, const Op& op) {
+        replay.threads[thread]->ops.push_back(op);
+        replay.calls++;
+        if (op.wait && op.kind == kFree) {
+            replay.cross_thread_frees++;
+        }
+    };
+    // An allocation at an address still allocated: its free was recorded
+    // after the allocation that reused it; free it here.
+    auto reuse = [&](uint32_t thread, uint64_t address) {
+        Op op = {};
+        op.kind = kFree;
+        if (release(thread, address, &op)) {
+            replay.reordered++;
+            emit(thread, op);
+        }
+    };
+
+    for (const Ref& ref : order) {
+        const TraceEvent& event = events[ref.thread][ref.index];
+        Op op = {};
+        op.size = event.size;
+        switch (event.op) {
+        case kTraceFree:
+            op.kind = kFree;
+            if (release(ref.thread, event.address, &op)) {
+                emit(ref.thread, op);
+            } else {
+                replay.unmatched_frees++;
+            }
+            break;
+        case kTraceRealloc:
+            if (event.moved == 0) {
+                op.kind = kFree;  // realloc(p, 0) that freed; otherwise it failed
+                if (event.size == 0 && release(ref.thread, event.address, &op)) {
+                    emit(ref.thread, op);
+                }
+                break;
+            }
+            op.kind = kRealloc;
+            if (!release(ref.thread, event.address, &op)) {
+                op.kind = kMalloc;
+            }
+            reuse(ref.thread, event.moved);
+            op.moved = create(ref.thread, event.size);
+            if (op.kind == kMalloc) {
+                op.block = op.moved;
+            }
+            live[event.moved] = op.moved;
+            emit(ref.thread, op);
+            break;
+        default:
+            op.kind = event.op == kTraceCalloc  ? kCalloc
+                      : event.op == kTraceAligned ? kAligned
+                                                  : kMalloc;
+            op.alignment = event.alignment;
+            reuse(ref.thread, event.address);
+            op.block = create(ref.thread, event.size);
+            live[event.address] = op.block;
+            emit(ref.thread, op);
+            break;
+        }
+    }
+    replay.blocks.reset(new std::atomic<void*>[owner.size()]);
+    for (size_t i = 0; i < owner.size(); ++i) {
+        replay.blocks[i].store(nullptr, std::memory_order_relaxed);
+    }
+    return replay;
+}
+
+// ---------------------------------------------------------------------------
+// Replay
+
+void touch(void* p, uint64_t size) {
+    auto* bytes = static_cast<volatile char*>(p);
+    for (uint64_t offset = 0; offset < size; offset += 4096) {
+        bytes[offset] = 1;
+    }
+}
+
+void* wait_for(std::atomic<void*>& slot, ThreadState& state) {
+    void* p = slot.load(std::memory_order_acquire);
+    if (p != nullptr) {
+        return p;
+    }
+    state.waits++;
+    for (int spin = 0; (p = slot.load(std::memory_order_acquire)) == nullptr; ++spin) {
+        if (spin > 64) {
+            std::this_thread::yield();
+        }
+    }
+    return p;
+}
+
+void run_thread(Replay& replay, ThreadState& state, bool touch_pages,
+                std::atomic<int>& ready, const std::atomic<bool>& go) {
+    ready.fetch_add(1);
+    while (!go.load(std::memory_order_acquire)) {
+        std::this_thread::yield();
+    }
+    auto start = std::chrono::steady_clock::now();
+    int64_t live = 0;
+    for (const Op& op : state.ops) {
+        std::atomic<void*>& slot = replay.blocks[op.block];
+        void* p = nullptr;
+        switch (op.kind) {
+        case kMalloc:
+            p = malloc(op.size);
+            break;
+        case kCalloc:
+            p = calloc(1, op.size);
+            break;
+        case kAligned:
+            if (posix_memalign(&p, std::max<size_t>(size_t{1} << op.alignment, sizeof(void*)),
+                               op.size) != 0) {
+                p = nullptr;
+            }
+            break;
+        case kRealloc: {
+            void* old = op.wait ? wait_for(slot, state) : slot.load(std::memory_order_relaxed);
+            live -= int64_t(replay.sizes[op.block]);
+            p = realloc(old != kFailed ? old : nullptr, op.size);
+            break;
+        }
+        case kFree: {
+            void* old = op.wait ? wait_for(slot, state) : slot.load(std::memory_order_relaxed);
+            if (old != kFailed) {
+                free(old);
+            }
+            live -= int64_t(replay.sizes[op.block]);
+            state.live.store(live, std::memory_order_relaxed);
+            continue;
+        }
+        }
+        uint32_t block = op.kind == kRealloc ? op.moved : op.block;
+        if (p != nullptr && touch_pages) {
+            touch(p, op.size);
+        }
+        live += int64_t(op.size);
+        state.live.store(live, std::memory_order_relaxed);
+        replay.blocks[block].store(p != nullptr ? p : kFailed, std::memory_order_release);
+    }
+    state.seconds =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+uint64_t resident_bytes() {
+#if defined(__linux__)
+    static int fd = open("/proc/self/statm", O_RDONLY | O_CLOEXEC);
+    char text[128];
+    ssize_t n = fd >= 0 ? pread(fd, text, sizeof(text) - 1, 0) : -1;
+    if (n <= 0) {
+        return 0;
+    }
+    text[n] = '\0';
+    unsigned long long pages = 0, resident = 0;
+    if (sscanf(text, "%llu %llu", &pages, &resident) != 2) {
+        return 0;
+    }
+    return resident * uint64_t(sysconf(_SC_PAGESIZE));
+#else
+    return 0;  // Not measured
+#endif
+}
+
+int64_t live_bytes(const Replay& replay) {
+    int64_t total = 0;
+    for (const auto& state : replay.threads) {
+        total += state->live.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+// ---------------------------------------------------------------------------
+// Report
+
+struct Result {
+    double seconds = 0;
+    uint64_t waits = 0;
+    uint64_t baseline_rss = 0;
+    std::vector<Sample> samples;
+};
+
+double fragmentation(const Result& result, const Sample& sample) {
+    if (sample.rss <= result.baseline_rss || sample.live <= 0) {
+        return 0;
+    }
+    double gained = double(sample.rss - result.baseline_rss);
+    return std::max(0.0, 1.0 - double(sample.live) / gained);
+}
+
+const char* allocator_name() {
+    return tk_malloc_proxy_allocator != nullptr ? tk_malloc_proxy_allocator() : nullptr;
+}
+
+void print_text(const Replay& replay, const Result& result) {
+    const Sample& end = result.samples.back();
+    const Sample* peak = &result.samples.front();
+    for (const Sample& sample : result.samples) {
+        if (sample.rss > peak->rss) {
+            peak = &sample;
+        }
+    }
+    auto mib = [](double bytes) { return bytes / (1024.0 * 1024.0); };
+    double ns_per_call = replay.calls ? result.seconds * 1e9 / double(replay.calls) : 0;
+    if (allocator_name() != nullptr) {
+        printf("Allocator: %s\n", allocator_name());
+    }
+    printf("Replayed %llu calls in %zu threads: %.3f ms, %.1f ns per call\n",
+           (unsigned long long)replay.calls, replay.threads.size(), result.seconds * 1e3,
+           ns_per_call);
+    printf("  Cross-thread frees: %llu (waited %llu times)\n",
+           (unsigned long long)replay.cross_thread_frees, (unsigned long long)result.waits);
+    if (replay.unmatched_frees || replay.reordered) {
+        printf("  Unmatched frees: %llu, reordered: %llu\n",
+               (unsigned long long)replay.unmatched_frees, (unsigned long long)replay.reordered);
+    }
+    if (end.rss == 0) {
+        printf("  RSS: not measured on this platform\n");
+        return;
+    }
+    printf("  RSS: %.1f MiB before, %.1f MiB peak at %.1f ms, %.1f MiB at end\n",
+           mib(double(result.baseline_rss)), mib(double(peak->rss)), peak->ms,
+           mib(double(end.rss)));
+    printf("  Allocated: %.1f MiB at peak RSS, %.1f MiB at end\n", mib(double(peak->live)),
+           mib(double(end.live)));
+    printf("  Fragmentation: %.1f%% at peak RSS, %.1f%% at end\n",
+           100 * fragmentation(result, *peak), 100 * fragmentation(result, end));
+}
+
+void print_json(const Replay& replay, const Result& result) {
+    const Sample& end = result.samples.back();
+    const Sample* peak = &result.samples.front();
+    for (const Sample& sample : result.samples) {
+        if (sample.rss > peak->rss) {
+            peak = &sample;
+        }
+    }
+    printf("{\n  \"allocator\": ");
+    if (allocator_name() != nullptr) {
+        printf("\"");
+        for (const char* c = allocator_name(); *c; ++c) {
+            if (*c == '"' || *c == '\\') {
+                putchar('\\');
+            }
+            putchar(*c);
+        }
+        printf("\"");
+    } else {
+        printf("null");
+    }
+    printf(",\n  \"calls\": %llu", (unsigned long long)replay.calls);
+    printf(",\n  \"threads\": %zu", replay.threads.size());
+    printf(",\n  \"seconds\": %.9f", result.seconds);
+    printf(",\n  \"ns_per_call\": %.3f",
+           replay.calls ? result.seconds * 1e9 / double(replay.calls) : 0.0);
+    printf(",\n  \"cross_thread_frees\": %llu", (unsigned long long)replay.cross_thread_frees);
+    printf(",\n  \"waits\": %llu", (unsigned long long)result.waits);
+    printf(",\n  \"unmatched_frees\": %llu", (unsigned long long)replay.unmatched_frees);
+    printf(",\n  \"reordered\": %llu", (unsigned long long)replay.reordered);
+    printf(",\n  \"baseline_rss\": %llu", (unsigned long long)result.baseline_rss);
+    printf(",\n  \"peak_rss\": %llu", (unsigned long long)peak->rss);
+    printf(",\n  \"peak_rss_ms\": %.3f", peak->ms);
+    printf(",\n  \"live_at_peak_rss\": %lld", (long long)peak->live);
+    printf(",\n  \"end_rss\": %llu", (unsigned long long)end.rss);
+    printf(",\n  \"live_at_end\": %lld", (long long)end.live);
+    printf(",\n  \"fragmentation_at_peak_rss\": %.4f", fragmentation(result, *peak));
+    printf(",\n  \"fragmentation_at_end\": %.4f", fragmentation(result, end));
+    printf(",\n  \"samples\": [");
+    for (size_t i = 0; i < result.samples.size(); ++i) {
+        const Sample& s = result.samples[i];
+        printf("%s\n    {\"ms\": %.3f, \"rss\": %llu, \"live\": %lld}", i ? "," : "", s.ms,
+               (unsigned long long)s.rss, (long long)s.live);
+    }
+    printf("\n  ]\n}\n");
+}
+
+[[noreturn]] void usage() {
+    fprintf(stderr,
+            "usage: tk_alloc_replay [--json] [--interval MS] [--no-touch] TRACE\n"
+            "  TRACE        allocation trace, or - for standard input\n"
+            "  --json       print JSON, with the RSS samples\n"
+            "  --interval   milliseconds between RSS samples (default: 10)\n"
+            "  --no-touch   do not write to allocated blocks\n");
+    exit(2);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    bool json = false;
+    bool touch_pages = true;
+    double interval_ms = 10;
+    const char* path = nullptr;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--json") {
+            json = true;
+        } else if (arg == "--no-touch") {
+            touch_pages = false;
+        } else if (arg == "--interval" && i + 1 < argc) {
+            interval_ms = atof(argv[++i]);
+            if (interval_ms <= 0) {
+                usage();
+            }
+        } else if (path == nullptr && (arg == "-" || arg[0] != '-')) {
+            path = argv[i];
+        } else {
+            usage();
+        }
+    }
+    if (path == nullptr) {
+        usage();
+    }
+
+    Replay replay = prepare(parse(read_input(path)));  // Input freed here
+    Result result;
+    result.baseline_rss = resident_bytes();
+
+    std::atomic<int> ready{0};
+    std::atomic<bool> go{false};
+    std::atomic<bool> finished{false};
+    std::vector<std::thread> workers;
+    for (auto& state : replay.threads) {
+        workers.emplace_back(run_thread, std::ref(replay), std::ref(*state), touch_pages,
+                             std::ref(ready), std::cref(go));
+    }
+    while (ready.load() != int(workers.size())) {
+        std::this_thread::yield();
+    }
+    result.samples.reserve(4096);
+    auto start = std::chrono::steady_clock::now();
+    auto elapsed_ms = [&] {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() -
+                                                         start)
+            .count();
+    };
+    std::thread sampler([&] {
+        auto period = std::chrono::duration<double, std::milli>(interval_ms);
+        auto next = std::chrono::steady_clock::now();
+        while (!finished.load(std::memory_order_acquire)) {
+            result.samples.push_back({elapsed_ms(), resident_bytes(), live_bytes(replay)});
+            next += std::chrono::duration_cast<std::chrono::steady_clock::duration>(period);
+            std::this_thread::sleep_until(next);
+        }
+    });
+    go.store(true, std::memory_order_release);
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    result.seconds =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    finished.store(true, std::memory_order_release);
+    sampler.join();
+    result.samples.push_back({elapsed_ms(), resident_bytes(), live_bytes(replay)});
+    for (const auto& state : replay.threads) {
+        result.waits += state->waits;
+    }
+
+    if (json) {
+        print_json(replay, result);
+    } else {
+        print_text(replay, result);
+    }
+    return 0;
+}
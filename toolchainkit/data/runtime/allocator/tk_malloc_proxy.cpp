@@ -0,0 +1,1243 @@
+// ToolchainKit allocator proxy.
+//
+// Replaces malloc, free, calloc, realloc, the aligned allocation functions
+// and every replaceable operator new and delete, and forwards them to an
+// allocator library loaded when the program starts: TOOLCHAINKIT_ALLOCATOR,
+// or the library the allocator layer found when the toolchain file was
+// generated. Switching allocators needs no relink; the forwarding costs one
+// indirect call.
+//
+// Optionally each thread counts allocations per power-of-two size class and
+// records the call stacks of about one in N allocations, chosen at random,
+// in its own buffers; nothing on that path locks. The counts and the
+// sampled allocation sites are written as JSON at exit or when the program
+// calls tk_malloc_proxy_report(). A realloc counts as a free and an
+// allocation. Function names come from the ELF symbol tables of the loaded
+// objects and are only looked up when writing.
+//
+// Tracing logs every allocation, free and realloc with its time, size and
+// address to a binary file, for replay against other allocators
+// (tk_alloc_replay.cpp). Each thread encodes its events into its own buffer
+// and appends the buffer as one chunk when it is full, when the thread exits
+// and at exit; chunks of different threads are interleaved in the file.
+// Tracing works with the proxy preloaded into a program built without it.
+//
+// Times are timestamp counter ticks, converted to nanoseconds with the
+// frequency measured between the start of tracing and exit.
+//
+// Trace format (little-endian):
+//   header  "TKAT", u32 version (1), u64 start time (ticks), f64 ns per
+//           tick (0 if the program did not exit normally), u64 reserved
+//   chunk   u32 thread (in order of first traced event), u32 payload bytes,
+//           u64 time (ticks) that the first event's delta is relative to
+//   events  u8 op, then LEB128 varints: time delta (ticks), and per op
+//             malloc, calloc  size, address
+//             free            address
+//             realloc         old address, size, new address (0: failed)
+//             aligned         size, address; log2(alignment) in op >> 3
+//           Addresses are zigzag deltas from the previous address in the
+//           chunk, so every chunk decodes on its own.
+//
+// Allocations made before the allocator is loaded (by the dynamic loader
+// and the constructors of libraries initialized first) come from a static
+// arena and are never freed.
+//
+// Environment (defaults are compiled in from the layer YAML):
+//   TOOLCHAINKIT_ALLOCATOR         Allocator library to load; "system" (or
+//                                  empty) for the C library's malloc
+//   TOOLCHAINKIT_ALLOCATOR_STATS   1 counts allocations per size class
+//   TOOLCHAINKIT_ALLOCATOR_SAMPLE  Record the call stack of one in N
+//                                  allocations (0: none); implies STATS
+//   TOOLCHAINKIT_ALLOCATOR_REPORT  Report file, %p is replaced by the pid
+//                                  (default: tk-alloc.%p.json)
+//   TOOLCHAINKIT_ALLOCATOR_TRACE   Trace file, %p is replaced by the pid
+//                                  (default: no trace)
+//
+// The proxy must be loaded when the process starts (linked into the
+// executable, or LD_PRELOAD): memory from another malloc cannot be freed
+// here. This file must be compiled with -fno-builtin, so the compiler does
+// not turn code below into calls to the functions it defines.
+
+#include "tk_malloc_proxy.h"
+
+#include "../common/tk_symbolizer.h"
+
+#include <dlfcn.h>
+#include <fcntl.h>
+#include <link.h>
+#include <malloc.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <time.h>
+#include <unistd.h>
+#include <unwind.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <initializer_list>
+#include <map>
+#include <mutex>
+#include <new>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Defaults, set by the toolchain file: the library as a string literal, the
+// others as bare tokens (-DNAME=value)
+#ifndef TK_MALLOC_DEFAULT_LIBRARY
+#define TK_MALLOC_DEFAULT_LIBRARY ""
+#endif
+#ifndef TK_MALLOC_DEFAULT_STATS
+#define TK_MALLOC_DEFAULT_STATS 0
+#endif
+#ifndef TK_MALLOC_DEFAULT_SAMPLE
+#define TK_MALLOC_DEFAULT_SAMPLE 0
+#endif
+
+#define TK_STRING(...) #__VA_ARGS__
+#define TK_EXPAND_STRING(...) TK_STRING(__VA_ARGS__)
+
+#define TK_EXPORT extern "C" __attribute__((visibility("default")))
+#define TK_LIKELY(x) __builtin_expect(!!(x), 1)
+#define TK_UNLIKELY(x) __builtin_expect(!!(x), 0)
+
+// Exception specification of the C library's declarations
+#if defined(__THROW)
+#define TK_NOTHROW __THROW
+#else
+#define TK_NOTHROW
+#endif
+
+namespace {
+
+constexpr size_t kArenaSize = size_t{1} << 20;
+constexpr size_t kMinAlignment = 16;
+constexpr int kSizeClasses = 48;  // Class i holds sizes up to 8 << i
+constexpr uint32_t kMaxFrames = 32;
+constexpr size_t kSiteSlots = 1024;
+constexpr size_t kSiteProbes = 64;
+constexpr size_t kTraceBuffer = size_t{64} << 10;
+constexpr size_t kTraceMaxEvent = 1 + 5 * 10;  // op and five varints
+constexpr uint32_t kNoThread = ~uint32_t{0};    // Buffer not owned by a thread
+constexpr size_t kTraceHeader = 32;
+constexpr int64_t kMinCalibrationNs = 10000000;
+
+static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__, "trace headers are written as is");
+
+enum TraceOp : uint8_t {
+    kTraceMalloc = 1,
+    kTraceFree = 2,
+    kTraceRealloc = 3,
+    kTraceAligned = 4,
+    kTraceCalloc = 5,
+};
+
+enum State : int { kStarting = 0, kLoading = 1, kReady = 2 };
+
+struct Allocator {
+    void* (*malloc)(size_t);
+    void (*free)(void*);
+    void* (*calloc)(size_t, size_t);
+    void* (*realloc)(void*, size_t);
+    int (*posix_memalign)(void**, size_t, size_t);
+    size_t (*usable_size)(void*);  // Optional
+};
+
+// A thread's pending events; the chunk header is written in front on flush.
+struct TraceBuffer {
+    uint32_t thread;
+    uint32_t used;
+    uint64_t base_time;  // Of the chunk
+    uint64_t last_time;
+    uintptr_t last_address;
+    uint8_t data[kTraceBuffer];
+};
+
+struct Site {
+    uint64_t hash;  // Published last, with a release store; 0 when empty
+    uint64_t samples;
+    uint64_t bytes;
+    uint32_t depth;
+    uintptr_t frames[kMaxFrames];  // Return addresses, innermost first
+};
+
+// One per thread; reused by a later thread once its thread exits, so the
+// counts of every thread are kept.
+struct ThreadStats {
+    uint64_t allocations[kSizeClasses];
+    uint64_t bytes[kSizeClasses];  // Requested
+    uint64_t frees;
+    uint64_t reallocs;
+    uint64_t usable_allocated;  // malloc_usable_size of blocks allocated
+    uint64_t usable_freed;
+    uint64_t dropped_samples;  // Site table full
+    Site* sites;               // kSiteSlots, created on the first sample
+    ThreadStats* next;
+    int in_use;
+    int tracing;  // Owner is appending to trace (see stop_trace)
+    TraceBuffer* trace;  // Created on the first traced event
+    // Only used by the owning thread
+    bool busy;  // Inside the profiler: allocations are not recorded
+    uint32_t countdown;  // Allocations until the next sampled one
+    uint64_t random;     // xorshift state for sampling
+};
+
+// Set on a thread that has run its exit handler and must not record.
+ThreadStats* const kDetached = reinterpret_cast<ThreadStats*>(uintptr_t{1});
+
+__thread ThreadStats* t_stats __attribute__((tls_model("initial-exec")));
+
+alignas(64) char g_arena[kArenaSize];
+size_t g_arena_used = 0;
+int g_state = kStarting;
+Allocator g_allocator = {};
+const char* g_allocator_name = "system";
+bool g_profile = false;  // Counting or tracing: the recording hooks run
+bool g_counting = false;  // Statistics and sampling
+bool g_trace = false;     // Cleared at exit and in forked children
+int g_trace_fd = -1;
+uint64_t g_trace_offset = 0;  // Where the next chunk goes
+uint32_t g_trace_threads = 0;
+uint64_t g_trace_ticks0 = 0;
+int64_t g_trace_ns0 = 0;
+uint32_t g_sample = 0;
+const char* g_report = nullptr;
+ThreadStats* g_stats = nullptr;
+pthread_key_t g_exit_key;
+
+std::mutex& report_mutex() {
+    static std::mutex mutex;
+    return mutex;
+}
+
+inline bool ready() {
+    return TK_LIKELY(__atomic_load_n(&g_state, __ATOMIC_ACQUIRE) == kReady);
+}
+
+inline bool profiling() { return TK_UNLIKELY(g_profile); }
+
+inline bool tracing() { return __atomic_load_n(&g_trace, __ATOMIC_RELAXED); }
+
+// ---------------------------------------------------------------------------
+// Arena
+
+inline bool in_arena(const void* p) {
+    return uintptr_t(p) - uintptr_t(g_arena) < kArenaSize;
+}
+
+// Each block is preceded by its size.
+void* arena_allocate(size_t size, size_t alignment) {
+    alignment = std::max(alignment, kMinAlignment);
+    uintptr_t origin = uintptr_t(g_arena);
+    size_t used = __atomic_load_n(&g_arena_used, __ATOMIC_RELAXED);
+    size_t start;
+    do {
+        start = ((origin + used + sizeof(size_t) + alignment - 1) & ~(alignment - 1)) - origin;
+        if (start > kArenaSize || size > kArenaSize - start) {
+            return nullptr;
+        }
+    } while (!__atomic_compare_exchange_n(&g_arena_used, &used, start + size, true,
+                                          __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+    memcpy(g_arena + start - sizeof(size_t), &size, sizeof(size));
+    return g_arena + start;
+}
+
+size_t arena_block_size(const void* p) {
+    size_t size;
+    memcpy(&size, static_cast<const char*>(p) - sizeof(size_t), sizeof(size));
+    return size;
+}
+
+// ---------------------------------------------------------------------------
+// Tracing
+
+// Writes a line to stderr without stdio, which allocates.
+void warn(std::initializer_list<const char*> parts) {
+    auto put = [](const char* text) {
+        ssize_t ignored = write(STDERR_FILENO, text, strlen(text));
+        (void)ignored;
+    };
+    put("toolchainkit: ");
+    for (const char* part : parts) {
+        put(part);
+    }
+    put("\n");
+}
+
+inline uint64_t ticks() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __builtin_ia32_rdtsc();
+#elif defined(__aarch64__)
+    uint64_t value;
+    __asm__ __volatile__("mrs %0, cntvct_el0" : "=r"(value));
+    return value;
+#else
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return uint64_t(now.tv_sec) * 1000000000u + uint64_t(now.tv_nsec);
+#endif
+}
+
+int64_t monotonic_ns() {
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return int64_t(now.tv_sec) * 1000000000 + now.tv_nsec;
+}
+
+// Timestamp counter frequency, measured against the monotonic clock since
+// tracing started (at least kMinCalibrationNs).
+double ns_per_tick() {
+    int64_t ns = monotonic_ns();
+    if (ns - g_trace_ns0 < kMinCalibrationNs) {
+        timespec pause = {0, long(kMinCalibrationNs - (ns - g_trace_ns0))};
+        nanosleep(&pause, nullptr);
+        ns = monotonic_ns();
+    }
+    uint64_t elapsed = ticks() - g_trace_ticks0;
+    return elapsed ? double(ns - g_trace_ns0) / double(elapsed) : 1.0;
+}
+
+bool write_at(const void* data, size_t size, uint64_t offset) {
+    const char* p = static_cast<const char*>(data);
+    while (size > 0) {
+        ssize_t written = pwrite(g_trace_fd, p, size, off_t(offset));
+        if (written < 0 && errno == EINTR) {
+            continue;
+        }
+        if (written <= 0) {
+            return false;
+        }
+        p += written;
+        size -= size_t(written);
+        offset += uint64_t(written);
+    }
+    return true;
+}
+
+// Appends the buffer as a chunk; the file range is reserved first, so
+// threads write their chunks concurrently.
+void flush_trace(TraceBuffer* trace) {
+    if (trace->used == 0) {
+        return;
+    }
+    uint8_t header[16];
+    memcpy(header, &trace->thread, 4);
+    memcpy(header + 4, &trace->used, 4);
+    memcpy(header + 8, &trace->base_time, 8);
+    uint64_t offset =
+        __atomic_fetch_add(&g_trace_offset, sizeof(header) + trace->used, __ATOMIC_RELAXED);
+    if (!write_at(header, sizeof(header), offset) ||
+        !write_at(trace->data, trace->used, offset + sizeof(header))) {
+        if (__atomic_exchange_n(&g_trace, false, __ATOMIC_SEQ_CST)) {
+            warn({"cannot write the allocation trace: ", strerror(errno), "; tracing stopped"});
+        }
+    }
+    trace->used = 0;
+    trace->base_time = trace->last_time;
+    trace->last_address = 0;
+}
+
+// The owner marks itself before checking g_trace and stop_trace clears
+// g_trace before checking the marks (both sequentially consistent), so
+// either the owner sees tracing stopped or stop_trace waits for it.
+inline bool begin_trace(ThreadStats* stats) {
+    __atomic_store_n(&stats->tracing, 1, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&g_trace, __ATOMIC_SEQ_CST)) {
+        return true;
+    }
+    __atomic_store_n(&stats->tracing, 0, __ATOMIC_RELEASE);
+    return false;
+}
+
+inline void end_trace(ThreadStats* stats) {
+    __atomic_store_n(&stats->tracing, 0, __ATOMIC_RELEASE);
+}
+
+// Starts a new thread in the trace, with a buffer of its own or one left
+// by an exited thread.
+__attribute__((noinline)) TraceBuffer* attach_trace(ThreadStats* stats) {
+    TraceBuffer* trace = stats->trace;
+    if (trace == nullptr) {
+        void* memory = mmap(nullptr, sizeof(TraceBuffer), PROT_READ | PROT_WRITE,
+                            MAP_PRIVATE | MAP_ANON, -1, 0);
+        if (memory == MAP_FAILED) {
+            return nullptr;
+        }
+        trace = static_cast<TraceBuffer*>(memory);
+        __atomic_store_n(&stats->trace, trace, __ATOMIC_RELEASE);
+    }
+    trace->thread = __atomic_fetch_add(&g_trace_threads, 1, __ATOMIC_RELAXED);
+    trace->used = 0;
+    trace->base_time = trace->last_time = ticks();
+    trace->last_address = 0;
+    return trace;
+}
+
+inline uint8_t* put_varint(uint8_t* out, uint64_t value) {
+    while (value >= 0x80) {
+        *out++ = uint8_t(value) | 0x80;
+        value >>= 7;
+    }
+    *out++ = uint8_t(value);
+    return out;
+}
+
+inline uint8_t* put_address(uint8_t* out, TraceBuffer* trace, uintptr_t address) {
+    uint64_t delta = uint64_t(address) - uint64_t(trace->last_address);
+    trace->last_address = address;
+    return put_varint(out, (delta << 1) ^ uint64_t(int64_t(delta) >> 63));  // Zigzag
+}
+
+// address: the block allocated or freed, or realloc's old block
+// moved: realloc's new block
+__attribute__((noinline)) void trace_event(ThreadStats* stats, uint8_t op, uintptr_t address,
+                                           size_t size, uintptr_t moved = 0) {
+    if (!begin_trace(stats)) {
+        return;
+    }
+    TraceBuffer* trace = stats->trace;
+    if (TK_UNLIKELY(trace == nullptr || trace->thread == kNoThread)) {
+        trace = attach_trace(stats);
+        if (trace == nullptr) {
+            end_trace(stats);
+            return;
+        }
+    }
+    if (trace->used + kTraceMaxEvent > kTraceBuffer) {
+        flush_trace(trace);
+    }
+    uint64_t time = ticks();
+    uint8_t* out = trace->data + trace->used;
+    *out++ = op;
+    out = put_varint(out, time - trace->last_time);
+    trace->last_time = time;
+    switch (op & 7) {
+    case kTraceFree:
+        out = put_address(out, trace, address);
+        break;
+    case kTraceRealloc:
+        out = put_address(out, trace, address);
+        out = put_varint(out, size);
+        out = put_address(out, trace, moved);
+        break;
+    default:
+        out = put_varint(out, size);
+        out = put_address(out, trace, address);
+        break;
+    }
+    trace->used = uint32_t(out - trace->data);
+    end_trace(stats);
+}
+
+// Writes the buffers of all threads, waiting for those appending, and
+// records nothing after.
+void stop_trace() {
+    if (!__atomic_exchange_n(&g_trace, false, __ATOMIC_SEQ_CST)) {
+        return;
+    }
+    for (ThreadStats* s = __atomic_load_n(&g_stats, __ATOMIC_ACQUIRE); s; s = s->next) {
+        while (__atomic_load_n(&s->tracing, __ATOMIC_SEQ_CST) != 0) {
+            sched_yield();
+        }
+        TraceBuffer* trace = __atomic_load_n(&s->trace, __ATOMIC_ACQUIRE);
+        if (trace != nullptr && trace->thread != kNoThread) {
+            flush_trace(trace);
+        }
+    }
+    double ratio = ns_per_tick();
+    write_at(&ratio, sizeof(ratio), 16);
+    close(g_trace_fd);
+}
+
+// A child must not append its copies of the parent's buffers.
+void stop_trace_in_child() { __atomic_store_n(&g_trace, false, __ATOMIC_SEQ_CST); }
+
+// pattern: file name, %p is replaced by the pid. Runs while the allocator
+// is being loaded, so nothing here allocates.
+void open_trace(const char* pattern) {
+    char path[4096];
+    char pid[24];
+    int pid_length = snprintf(pid, sizeof(pid), "%ld", long(getpid()));
+    size_t length = 0;
+    for (const char* c = pattern; *c != '\0' && length + pid_length < sizeof(path); ++c) {
+        if (c[0] == '%' && c[1] == 'p') {
+            memcpy(path + length, pid, size_t(pid_length));
+            length += size_t(pid_length);
+            ++c;
+        } else {
+            path[length++] = *c;
+        }
+    }
+    path[length] = '\0';
+    g_trace_fd = open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (g_trace_fd < 0) {
+        warn({"cannot write the allocation trace ", path, ": not tracing"});
+        return;
+    }
+    uint8_t header[kTraceHeader] = {'T', 'K', 'A', 'T', 1, 0, 0, 0};
+    g_trace_ns0 = monotonic_ns();
+    g_trace_ticks0 = ticks();
+    memcpy(header + 8, &g_trace_ticks0, sizeof(g_trace_ticks0));
+    if (!write_at(header, sizeof(header), 0)) {
+        warn({"cannot write the allocation trace ", path, ": not tracing"});
+        close(g_trace_fd);
+        return;
+    }
+    g_trace_offset = kTraceHeader;
+    pthread_atfork(nullptr, nullptr, stop_trace_in_child);
+    g_trace = true;
+}
+
+// ---------------------------------------------------------------------------
+// Loading the allocator
+
+bool is_system(const char* library) {
+    return library == nullptr || *library == '\0' || strcmp(library, "system") == 0;
+}
+
+// Looks name up in the allocator library only, not in its dependencies.
+template <typename Function>
+bool lookup(void* handle, const void* base, const char* name, Function* function) {
+    void* symbol = dlsym(handle, name);
+    Dl_info info;
+    if (symbol == nullptr ||
+        (base != nullptr && (dladdr(symbol, &info) == 0 || info.dli_fbase != base))) {
+        return false;
+    }
+    *function = reinterpret_cast<Function>(symbol);
+    return true;
+}
+
+// Returns an error message, or nullptr once allocator is filled in.
+const char* resolve(const char* library, Allocator* allocator) {
+    void* handle = RTLD_NEXT;
+    const void* base = nullptr;
+    if (!is_system(library)) {
+        handle = dlopen(library, RTLD_NOW | RTLD_LOCAL);
+        if (handle == nullptr) {
+            return dlerror();
+        }
+        struct link_map* map = nullptr;
+        Dl_info info;
+        if (dlinfo(handle, RTLD_DI_LINKMAP, &map) != 0 || map == nullptr ||
+            dladdr(map->l_ld, &info) == 0) {
+            return "cannot locate the loaded library";
+        }
+        base = info.dli_fbase;
+    }
+    Allocator found = {};
+    if (!lookup(handle, base, "malloc", &found.malloc) ||
+        !lookup(handle, base, "free", &found.free) ||
+        !lookup(handle, base, "calloc", &found.calloc) ||
+        !lookup(handle, base, "realloc", &found.realloc) ||
+        !lookup(handle, base, "posix_memalign", &found.posix_memalign)) {
+        return "the library does not define malloc, free, calloc, realloc and "
+               "posix_memalign";
+    }
+    lookup(handle, base, "malloc_usable_size", &found.usable_size);
+    *allocator = found;
+    return nullptr;
+}
+
+void warn_unusable(const char* library, const char* error) {
+    warn({"cannot use allocator ", library, ": ", error ? error : "unknown error",
+          "; using the system allocator"});
+}
+
+const char* setting(const char* name, const char* fallback) {
+    const char* value = getenv(name);
+    return value != nullptr ? value : fallback;
+}
+
+void on_thread_exit(void* data) {
+    auto* stats = static_cast<ThreadStats*>(data);
+    t_stats = kDetached;
+    if (stats->trace != nullptr && begin_trace(stats)) {
+        flush_trace(stats->trace);
+        stats->trace->thread = kNoThread;  // The next owner is a new thread
+        end_trace(stats);
+    }
+    __atomic_store_n(&stats->in_use, 0, __ATOMIC_RELEASE);
+}
+
+void configure_profile() {
+    long sample = atol(setting("TOOLCHAINKIT_ALLOCATOR_SAMPLE",
+                               TK_EXPAND_STRING(TK_MALLOC_DEFAULT_SAMPLE)));
+    bool stats = atoi(setting("TOOLCHAINKIT_ALLOCATOR_STATS",
+                              TK_EXPAND_STRING(TK_MALLOC_DEFAULT_STATS))) != 0;
+    const char* trace = setting("TOOLCHAINKIT_ALLOCATOR_TRACE", "");
+    g_sample = uint32_t(std::min(std::max(sample, 0L), 1L << 30));
+    if ((!stats && g_sample == 0 && *trace == '\0') ||
+        pthread_key_create(&g_exit_key, on_thread_exit) != 0) {
+        g_sample = 0;
+        return;
+    }
+    if (*trace != '\0') {
+        open_trace(trace);
+    }
+    g_counting = stats || g_sample != 0;
+    g_report = setting("TOOLCHAINKIT_ALLOCATOR_REPORT", "tk-alloc.%p.json");
+    report_mutex();
+    g_profile = true;
+}
+
+// Loads the allocator once. Returns false while it is being loaded, by this
+// thread (the dynamic loader allocates) or another; callers use the arena.
+bool load_allocator() {
+    int state = kStarting;
+    if (!__atomic_compare_exchange_n(&g_state, &state, kLoading, false, __ATOMIC_ACQUIRE,
+                                     __ATOMIC_ACQUIRE)) {
+        return state == kReady;
+    }
+    const char* library = setting("TOOLCHAINKIT_ALLOCATOR", TK_MALLOC_DEFAULT_LIBRARY);
+    const char* error = resolve(library, &g_allocator);
+    if (error != nullptr) {
+        warn_unusable(library, error);
+        library = nullptr;
+        error = resolve(nullptr, &g_allocator);
+        if (error != nullptr) {
+            warn_unusable("system", error);
+            abort();
+        }
+    }
+    g_allocator_name = is_system(library) ? "system" : library;
+    configure_profile();
+    __atomic_store_n(&g_state, kReady, __ATOMIC_RELEASE);
+    return true;
+}
+
+// Before the allocator is loaded; loads it if the arena is full.
+__attribute__((noinline)) void* early_allocate(size_t size, size_t alignment) {
+    void* p = arena_allocate(size, alignment);
+    if (p != nullptr || !load_allocator()) {
+        return p;
+    }
+    if (alignment <= kMinAlignment) {
+        return g_allocator.malloc(size);
+    }
+    return g_allocator.posix_memalign(&p, alignment, size) == 0 ? p : nullptr;
+}
+
+// ---------------------------------------------------------------------------
+// Statistics and sampling
+
+inline void add(uint64_t* counter, uint64_t value) {
+    __atomic_store_n(counter, *counter + value, __ATOMIC_RELAXED);
+}
+
+inline int size_class(size_t size) {
+    if (size <= 8) {
+        return 0;
+    }
+    int bits = 64 - __builtin_clzll(uint64_t(size - 1));  // ceil(log2(size))
+    return std::min(bits - 3, kSizeClasses - 1);
+}
+
+// Allocations until the next sampled one, uniform in [1, 2N - 1] so the
+// mean is N and periodic allocation patterns do not alias.
+inline uint32_t next_countdown(ThreadStats* stats) {
+    uint64_t x = stats->random;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    stats->random = x;
+    return 1 + uint32_t(x % (2 * uint64_t(g_sample) - 1));
+}
+
+__attribute__((noinline)) ThreadStats* attach_stats() {
+    ThreadStats* stats = nullptr;
+    for (ThreadStats* s = __atomic_load_n(&g_stats, __ATOMIC_ACQUIRE); s; s = s->next) {
+        int free_slot = 0;
+        if (__atomic_load_n(&s->in_use, __ATOMIC_RELAXED) == 0 &&
+            __atomic_compare_exchange_n(&s->in_use, &free_slot, 1, false, __ATOMIC_ACQUIRE,
+                                        __ATOMIC_RELAXED)) {
+            stats = s;
+            break;
+        }
+    }
+    if (stats == nullptr) {
+        void* memory = mmap(nullptr, sizeof(ThreadStats), PROT_READ | PROT_WRITE,
+                            MAP_PRIVATE | MAP_ANON, -1, 0);
+        if (memory == MAP_FAILED) {
+            return nullptr;
+        }
+        stats = static_cast<ThreadStats*>(memory);
+        stats->in_use = 1;
+        stats->random = (uint64_t(uintptr_t(&stats)) << 16) ^ 0x9E3779B97F4A7C15ull;
+        if (g_sample != 0) {
+            stats->countdown = next_countdown(stats);
+        }
+        ThreadStats* head = __atomic_load_n(&g_stats, __ATOMIC_RELAXED);
+        do {
+            stats->next = head;
+        } while (!__atomic_compare_exchange_n(&g_stats, &head, stats, true, __ATOMIC_RELEASE,
+                                              __ATOMIC_RELAXED));
+    }
+    t_stats = stats;
+    stats->busy = true;  // pthread_setspecific may allocate
+    pthread_setspecific(g_exit_key, stats);
+    stats->busy = false;
+    return stats;
+}
+
+// The calling thread's counters, or nullptr while it must not record.
+inline ThreadStats* current_stats() {
+    ThreadStats* stats = t_stats;
+    if (TK_UNLIKELY(stats == nullptr)) {
+        stats = attach_stats();
+    }
+    if (stats == nullptr || stats == kDetached || stats->busy) {
+        return nullptr;
+    }
+    return stats;
+}
+
+struct Backtrace {
+    uintptr_t* frames;
+    uint32_t depth;
+};
+
+_Unwind_Reason_Code collect_frame(struct _Unwind_Context* context, void* data) {
+    auto* trace = static_cast<Backtrace*>(data);
+    uintptr_t ip = _Unwind_GetIP(context);
+    if (ip == 0 || trace->depth == kMaxFrames) {
+        return _URC_END_OF_STACK;
+    }
+    trace->frames[trace->depth++] = ip;
+    return _URC_NO_REASON;
+}
+
+__attribute__((noinline)) void sample_site(ThreadStats* stats, size_t size) {
+    stats->busy = true;  // The unwinder may allocate
+    Site* sites = stats->sites;
+    if (sites == nullptr) {
+        void* memory = mmap(nullptr, kSiteSlots * sizeof(Site), PROT_READ | PROT_WRITE,
+                            MAP_PRIVATE | MAP_ANON, -1, 0);
+        if (memory != MAP_FAILED) {
+            sites = static_cast<Site*>(memory);
+            __atomic_store_n(&stats->sites, sites, __ATOMIC_RELEASE);
+        }
+    }
+    bool stored = false;
+    if (sites != nullptr) {
+        uintptr_t frames[kMaxFrames];
+        Backtrace trace = {frames, 0};
+        _Unwind_Backtrace(collect_frame, &trace);
+        uint64_t hash = 14695981039346656037ull;  // FNV-1a
+        for (uint32_t i = 0; i < trace.depth; ++i) {
+            hash = (hash ^ frames[i]) * 1099511628211ull;
+        }
+        hash |= 1;
+        for (size_t probe = 0; probe < kSiteProbes && !stored; ++probe) {
+            Site& site = sites[(hash + probe) & (kSiteSlots - 1)];
+            if (site.hash == hash && site.depth == trace.depth &&
+                memcmp(site.frames, frames, trace.depth * sizeof(uintptr_t)) == 0) {
+                add(&site.samples, 1);
+                add(&site.bytes, size);
+                stored = true;
+            } else if (site.hash == 0) {
+                memcpy(site.frames, frames, trace.depth * sizeof(uintptr_t));
+                site.depth = trace.depth;
+                site.samples = 1;
+                site.bytes = size;
+                __atomic_store_n(&site.hash, hash, __ATOMIC_RELEASE);
+                stored = true;
+            }
+        }
+    }
+    if (!stored) {
+        add(&stats->dropped_samples, 1);
+    }
+    stats->busy = false;
+}
+
+void count_allocation(ThreadStats* stats, void* p, size_t size) {
+    int index = size_class(size);
+    add(&stats->allocations[index], 1);
+    add(&stats->bytes[index], size);
+    if (g_allocator.usable_size != nullptr) {
+        add(&stats->usable_allocated, g_allocator.usable_size(p));
+    }
+    if (g_sample != 0 && --stats->countdown == 0) {
+        stats->countdown = next_countdown(stats);
+        sample_site(stats, size);
+    }
+}
+
+// op: how p was allocated (TraceOp, with the alignment for kTraceAligned)
+__attribute__((noinline)) void record_allocation(void* p, size_t size, uint8_t op) {
+    ThreadStats* stats = current_stats();
+    if (stats == nullptr || p == nullptr) {
+        return;
+    }
+    if (g_counting) {
+        count_allocation(stats, p, size);
+    }
+    if (tracing()) {
+        trace_event(stats, op, uintptr_t(p), size);
+    }
+}
+
+__attribute__((noinline)) void record_free(void* p) {
+    ThreadStats* stats = current_stats();
+    if (stats == nullptr) {
+        return;
+    }
+    if (g_counting) {
+        add(&stats->frees, 1);
+        if (g_allocator.usable_size != nullptr) {
+            add(&stats->usable_freed, g_allocator.usable_size(p));
+        }
+    }
+    if (tracing()) {
+        trace_event(stats, kTraceFree, uintptr_t(p), 0);
+    }
+}
+
+__attribute__((noinline)) void* profiled_realloc(void* p, size_t size) {
+    size_t usable =
+        g_counting && g_allocator.usable_size != nullptr ? g_allocator.usable_size(p) : 0;
+    void* moved = g_allocator.realloc(p, size);
+    ThreadStats* stats = current_stats();
+    if (stats == nullptr) {
+        return moved;
+    }
+    if (g_counting) {
+        add(&stats->reallocs, 1);
+        if (moved != nullptr || size == 0) {
+            add(&stats->frees, 1);
+            add(&stats->usable_freed, usable);
+        }
+        if (moved != nullptr) {
+            count_allocation(stats, moved, size);
+        }
+    }
+    if (tracing()) {
+        trace_event(stats, kTraceRealloc, uintptr_t(p), size, uintptr_t(moved));
+    }
+    return moved;
+}
+
+// ---------------------------------------------------------------------------
+// Forwarding
+
+inline void* allocate(size_t size) {
+    if (!ready()) {
+        return early_allocate(size, 0);
+    }
+    void* p = g_allocator.malloc(size);
+    if (profiling()) {
+        record_allocation(p, size, kTraceMalloc);
+    }
+    return p;
+}
+
+// alignment: a power of two, at least sizeof(void*)
+inline void* allocate_aligned(size_t alignment, size_t size) {
+    if (!ready()) {
+        return early_allocate(size, alignment);
+    }
+    void* p = nullptr;
+    if (g_allocator.posix_memalign(&p, alignment, size) != 0) {
+        p = nullptr;
+    }
+    if (profiling()) {
+        int log2 = std::min(__builtin_ctzll(alignment), 31);
+        record_allocation(p, size, uint8_t(kTraceAligned | (log2 << 3)));
+    }
+    return p;
+}
+
+inline void deallocate(void* p) {
+    if (p == nullptr || in_arena(p)) {
+        return;
+    }
+    if (profiling()) {
+        record_free(p);
+    }
+    g_allocator.free(p);
+}
+
+// Arena blocks are never freed; their contents move to a new block.
+void* move_from_arena(void* p, size_t size) {
+    void* moved = allocate(size);
+    if (moved != nullptr) {
+        memcpy(moved, p, std::min(size, arena_block_size(p)));
+    }
+    return moved;
+}
+
+size_t round_alignment(size_t alignment) {
+    size_t result = sizeof(void*);
+    while (result < alignment && result != 0) {
+        result <<= 1;
+    }
+    return result;
+}
+
+[[noreturn]] void throw_bad_alloc() {
+#if defined(__cpp_exceptions)
+    throw std::bad_alloc();
+#else
+    abort();
+#endif
+}
+
+void* new_or_throw(size_t size, size_t alignment) {
+    size = size != 0 ? size : 1;
+    for (;;) {
+        void* p = alignment != 0 ? allocate_aligned(alignment, size) : allocate(size);
+        if (p != nullptr) {
+            return p;
+        }
+        std::new_handler handler = std::get_new_handler();
+        if (handler == nullptr) {
+            throw_bad_alloc();
+        }
+        handler();
+    }
+}
+
+void* new_nothrow(size_t size, size_t alignment) noexcept {
+#if defined(__cpp_exceptions)
+    try {
+        return new_or_throw(size, alignment);
+    } catch (...) {
+        return nullptr;
+    }
+#else
+    size = size != 0 ? size : 1;
+    return alignment != 0 ? allocate_aligned(alignment, size) : allocate(size);
+#endif
+}
+
+// ---------------------------------------------------------------------------
+// Report
+
+tk_runtime::Symbolizer& symbolizer() {
+    static auto* instance = new tk_runtime::Symbolizer();  // Used after static destruction
+    return *instance;
+}
+
+std::string output_path(const char* path) {
+    std::string result = path ? path : g_report;
+    size_t pos;
+    while ((pos = result.find("%p")) != std::string::npos) {
+        result.replace(pos, 2, std::to_string(long(getpid())));
+    }
+    return result;
+}
+
+void write_json_string(FILE* out, const std::string& text) {
+    fputc('"', out);
+    for (unsigned char c : text) {
+        if (c == '"' || c == '\\') {
+            fputc('\\', out);
+            fputc(c, out);
+        } else if (c < 0x20) {
+            fprintf(out, "\\u%04x", c);
+        } else {
+            fputc(c, out);
+        }
+    }
+    fputc('"', out);
+}
+
+struct SiteTotal {
+    std::vector<std::string> stack;
+    uint64_t samples = 0;
+    uint64_t bytes = 0;
+};
+
+// Merges sampled sites of all threads by their symbolized stacks, dropping
+// the proxy's own frames. Largest sampled bytes first.
+std::vector<SiteTotal> collect_sites(const std::vector<ThreadStats*>& threads) {
+    Dl_info self;
+    const void* self_base = nullptr;
+    if (dladdr(reinterpret_cast<void*>(&collect_sites), &self) != 0) {
+        self_base = self.dli_fbase;
+    }
+    tk_runtime::Symbolizer& names = symbolizer();
+    std::map<std::vector<std::string>, SiteTotal> merged;
+    for (ThreadStats* stats : threads) {
+        Site* sites = __atomic_load_n(&stats->sites, __ATOMIC_ACQUIRE);
+        for (size_t i = 0; sites != nullptr && i < kSiteSlots; ++i) {
+            const Site& site = sites[i];
+            if (__atomic_load_n(&site.hash, __ATOMIC_ACQUIRE) == 0) {
+                continue;
+            }
+            std::vector<std::string> stack;
+            for (uint32_t d = 0; d < site.depth; ++d) {
+                Dl_info info;
+                void* ip = reinterpret_cast<void*>(site.frames[d] - 1);  // In the call
+                if (stack.empty() && dladdr(ip, &info) != 0 && info.dli_fbase == self_base) {
+                    continue;
+                }
+                stack.push_back(names.name(site.frames[d] - 1));
+            }
+            SiteTotal& total = merged[stack];
+            total.samples += __atomic_load_n(&site.samples, __ATOMIC_RELAXED);
+            total.bytes += __atomic_load_n(&site.bytes, __ATOMIC_RELAXED);
+        }
+    }
+    std::vector<SiteTotal> result;
+    for (auto& entry : merged) {
+        entry.second.stack = entry.first;
+        result.push_back(std::move(entry.second));
+    }
+    std::sort(result.begin(), result.end(), [](const SiteTotal& a, const SiteTotal& b) {
+        return a.bytes != b.bytes ? a.bytes > b.bytes : a.samples > b.samples;
+    });
+    return result;
+}
+
+void write_report(FILE* out, const std::vector<ThreadStats*>& threads) {
+    uint64_t allocations[kSizeClasses] = {};
+    uint64_t bytes[kSizeClasses] = {};
+    uint64_t frees = 0, reallocs = 0, usable_allocated = 0, usable_freed = 0, dropped = 0;
+    for (ThreadStats* stats : threads) {
+        for (int i = 0; i < kSizeClasses; ++i) {
+            allocations[i] += __atomic_load_n(&stats->allocations[i], __ATOMIC_RELAXED);
+            bytes[i] += __atomic_load_n(&stats->bytes[i], __ATOMIC_RELAXED);
+        }
+        frees += __atomic_load_n(&stats->frees, __ATOMIC_RELAXED);
+        reallocs += __atomic_load_n(&stats->reallocs, __ATOMIC_RELAXED);
+        usable_allocated += __atomic_load_n(&stats->usable_allocated, __ATOMIC_RELAXED);
+        usable_freed += __atomic_load_n(&stats->usable_freed, __ATOMIC_RELAXED);
+        dropped += __atomic_load_n(&stats->dropped_samples, __ATOMIC_RELAXED);
+    }
+    uint64_t total_allocations = 0, total_bytes = 0;
+    for (int i = 0; i < kSizeClasses; ++i) {
+        total_allocations += allocations[i];
+        total_bytes += bytes[i];
+    }
+
+    fputs("{\n  \"allocator\": ", out);
+    write_json_string(out, g_allocator_name);
+    fprintf(out, ",\n  \"threads\": %zu", threads.size());
+    fprintf(out, ",\n  \"allocations\": %llu", (unsigned long long)total_allocations);
+    fprintf(out, ",\n  \"bytes\": %llu", (unsigned long long)total_bytes);
+    fprintf(out, ",\n  \"frees\": %llu", (unsigned long long)frees);
+    fprintf(out, ",\n  \"reallocs\": %llu", (unsigned long long)reallocs);
+    if (g_allocator.usable_size != nullptr) {
+        fprintf(out, ",\n  \"live_bytes\": %lld",
+                (long long)(int64_t(usable_allocated) - int64_t(usable_freed)));
+    }
+    fputs(",\n  \"size_classes\": [", out);
+    const char* separator = "\n";
+    for (int i = 0; i < kSizeClasses; ++i) {
+        if (allocations[i] == 0) {
+            continue;
+        }
+        fprintf(out, "%s    {\"max_size\": %llu, \"allocations\": %llu, \"bytes\": %llu}",
+                separator, (unsigned long long)(uint64_t{8} << i),
+                (unsigned long long)allocations[i], (unsigned long long)bytes[i]);
+        separator = ",\n";
+    }
+    fputs("\n  ]", out);
+    fprintf(out, ",\n  \"sample_rate\": %u", g_sample);
+    fprintf(out, ",\n  \"dropped_samples\": %llu", (unsigned long long)dropped);
+    fputs(",\n  \"sites\": [", out);
+    separator = "\n";
+    for (const SiteTotal& site : collect_sites(threads)) {
+        fprintf(out, "%s    {\"samples\": %llu, \"bytes\": %llu, \"stack\": [", separator,
+                (unsigned long long)site.samples, (unsigned long long)site.bytes);
+        for (size_t i = 0; i < site.stack.size(); ++i) {
+            fputs(i ? ", " : "", out);
+            write_json_string(out, site.stack[i]);
+        }
+        fputs("]}", out);
+        separator = ",\n";
+    }
+    fputs("\n  ]\n}\n", out);
+}
+
+int report(const char* path) {
+    if (!g_counting) {
+        return -1;
+    }
+    // Allocations made while writing are not recorded
+    ThreadStats* self = current_stats();
+    if (self != nullptr) {
+        self->busy = true;
+    }
+    int result = -1;
+    {
+        std::lock_guard<std::mutex> lock(report_mutex());
+        std::vector<ThreadStats*> threads;
+        for (ThreadStats* s = __atomic_load_n(&g_stats, __ATOMIC_ACQUIRE); s; s = s->next) {
+            threads.push_back(s);
+        }
+        std::string target = output_path(path);
+        std::string temporary = target + ".tmp";
+        FILE* out = fopen(temporary.c_str(), "w");
+        if (out != nullptr) {
+            write_report(out, threads);
+            bool ok = ferror(out) == 0;
+            ok = fclose(out) == 0 && ok;
+            if (ok && rename(temporary.c_str(), target.c_str()) == 0) {
+                result = 0;
+            } else {
+                unlink(temporary.c_str());
+            }
+        }
+    }
+    if (self != nullptr) {
+        self->busy = false;
+    }
+    return result;
+}
+
+__attribute__((constructor(101))) void initialize() { load_allocator(); }
+
+__attribute__((destructor(101))) void finish() {
+    stop_trace();
+    report(nullptr);
+}
+
+}  // namespace
+
+// ---------------------------------------------------------------------------
+// C allocation functions
+
+TK_EXPORT void* malloc(size_t size) TK_NOTHROW { return allocate(size); }
+
+TK_EXPORT void free(void* p) TK_NOTHROW { deallocate(p); }
+
+TK_EXPORT void* calloc(size_t count, size_t size) TK_NOTHROW {
+    size_t total;
+    if (__builtin_mul_overflow(count, size, &total)) {
+        errno = ENOMEM;
+        return nullptr;
+    }
+    if (!ready()) {
+        void* p = early_allocate(total, 0);  // Arena memory is zero
+        if (p != nullptr && !in_arena(p)) {
+            memset(p, 0, total);
+        }
+        return p;
+    }
+    void* p = g_allocator.calloc(count, size);
+    if (profiling()) {
+        record_allocation(p, total, kTraceCalloc);
+    }
+    return p;
+}
+
+TK_EXPORT void* realloc(void* p, size_t size) TK_NOTHROW {
+    if (p == nullptr) {
+        return allocate(size);
+    }
+    if (in_arena(p)) {
+        return move_from_arena(p, size);
+    }
+    if (profiling()) {
+        return profiled_realloc(p, size);
+    }
+    return g_allocator.realloc(p, size);
+}
+
+TK_EXPORT int posix_memalign(void** out, size_t alignment, size_t size) TK_NOTHROW {
+    if (alignment < sizeof(void*) || (alignment & (alignment - 1)) != 0) {
+        return EINVAL;
+    }
+    void* p = allocate_aligned(alignment, size);
+    if (p == nullptr) {
+        return ENOMEM;
+    }
+    *out = p;
+    return 0;
+}
+
+TK_EXPORT void* aligned_alloc(size_t alignment, size_t size) TK_NOTHROW {
+    if (alignment == 0 || (alignment & (alignment - 1)) != 0) {
+        errno = EINVAL;
+        return nullptr;
+    }
+    void* p = allocate_aligned(round_alignment(alignment), size);
+    if (p == nullptr) {
+        errno = ENOMEM;
+    }
+    return p;
+}
+
+TK_EXPORT void* memalign(size_t alignment, size_t size) TK_NOTHROW {
+    void* p = allocate_aligned(round_alignment(alignment), size);
+    if (p == nullptr) {
+        errno = ENOMEM;
+    }
+    return p;
+}
+
+TK_EXPORT void* valloc(size_t size) TK_NOTHROW {
+    return memalign(size_t(sysconf(_SC_PAGESIZE)), size);
+}
+
+TK_EXPORT void* pvalloc(size_t size) TK_NOTHROW {
+    size_t page = size_t(sysconf(_SC_PAGESIZE));
+    size_t rounded = (size + page - 1) & ~(page - 1);
+    return memalign(page, rounded != 0 ? rounded : page);
+}
+
+TK_EXPORT size_t malloc_usable_size(void* p) TK_NOTHROW {
+    if (p == nullptr) {
+        return 0;
+    }
+    if (in_arena(p)) {
+        return arena_block_size(p);
+    }
+    return g_allocator.usable_size != nullptr ? g_allocator.usable_size(p) : 0;
+}
+
+// ---------------------------------------------------------------------------
+// C++ allocation functions
+
+void* operator new(size_t size) { return new_or_throw(size, 0); }
+void* operator new[](size_t size) { return new_or_throw(size, 0); }
+void* operator new(size_t size, const std::nothrow_t&) noexcept { return new_nothrow(size, 0); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+    return new_nothrow(size, 0);
+}
+void* operator new(size_t size, std::align_val_t alignment) {
+    return new_or_throw(size, round_alignment(size_t(alignment)));
+}
+void* operator new[](size_t size, std::align_val_t alignment) {
+    return new_or_throw(size, round_alignment(size_t(alignment)));
+}
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return new_nothrow(size, round_alignment(size_t(alignment)));
+}
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return new_nothrow(size, round_alignment(size_t(alignment)));
+}
+
+void operator delete(void* p) noexcept { deallocate(p); }
+void operator delete[](void* p) noexcept { deallocate(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { deallocate(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { deallocate(p); }
+void operator delete(void* p, size_t) noexcept { deallocate(p); }
+void operator delete[](void* p, size_t) noexcept { deallocate(p); }
+void operator delete(void* p, std::align_val_t) noexcept { deallocate(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { deallocate(p); }
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept {
+    deallocate(p);
+}
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept {
+    deallocate(p);
+}
+void operator delete(void* p, size_t, std::align_val_t) noexcept { deallocate(p); }
+void operator delete[](void* p, size_t, std::align_val_t) noexcept { deallocate(p); }
+
+// ---------------------------------------------------------------------------
+// API
+
+TK_EXPORT const char* tk_malloc_proxy_allocator(void) {
+    load_allocator();
+    return g_allocator_name;
+}
+
+TK_EXPORT int tk_malloc_proxy_report(const char* path) { return report(path); }
@@ -0,0 +1,32 @@
+/*
+ * ToolchainKit allocator proxy.
+ *
+ * Linked into every target by an allocator layer with "method: proxy". The
+ * proxy replaces malloc and operator new and forwards them to the allocator
+ * selected when the program starts (TOOLCHAINKIT_ALLOCATOR); these
+ * functions query it from the program itself.
+ */
+#ifndef TOOLCHAINKIT_MALLOC_PROXY_H
+#define TOOLCHAINKIT_MALLOC_PROXY_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Path of the allocator library in use, or "system" for the C library. */
+const char* tk_malloc_proxy_allocator(void);
+
+/*
+ * Write the allocation report (size classes and sampled sites) so far.
+ *
+ * path: Output file, or NULL for TOOLCHAINKIT_ALLOCATOR_REPORT
+ * Returns 0 on success, -1 if statistics are off or the file cannot be
+ * written.
+ */
+int tk_malloc_proxy_report(const char* path);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TOOLCHAINKIT_MALLOC_PROXY_H */
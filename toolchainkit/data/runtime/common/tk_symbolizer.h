@@ -0,0 +1,187 @@
+// Function names for addresses in the loaded objects.
+//
+// Shared by the ToolchainKit runtimes. On Linux names come from the ELF
+// symbol tables (.symtab, or .dynsym for stripped objects) of every loaded
+// object, so static functions and executables linked without -rdynamic are
+// named too; elsewhere, and for addresses outside any symbol, from dladdr.
+// Names are demangled and cached. Not thread-safe: callers serialize use.
+#ifndef TOOLCHAINKIT_SYMBOLIZER_H
+#define TOOLCHAINKIT_SYMBOLIZER_H
+
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if defined(__linux__)
+#include <elf.h>
+#include <link.h>
+#endif
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace tk_runtime {
+
+class Symbolizer {
+public:
+    std::string name(uintptr_t address) {
+        auto cached = cache_.find(address);
+        if (cached != cache_.end()) {
+            return cached->second;
+        }
+        std::string name = lookup(address);
+        cache_.emplace(address, name);
+        return name;
+    }
+
+private:
+    struct Symbol {
+        uintptr_t start;
+        uintptr_t size;
+        std::string name;
+    };
+
+    std::string lookup(uintptr_t address) {
+#if defined(__linux__)
+        load();
+        auto it = std::upper_bound(
+            symbols_.begin(), symbols_.end(), address,
+            [](uintptr_t value, const Symbol& symbol) { return value < symbol.start; });
+        if (it != symbols_.begin()) {
+            const Symbol& symbol = *(it - 1);
+            if (address == symbol.start || address < symbol.start + symbol.size) {
+                return demangle(symbol.name.c_str());
+            }
+        }
+#endif
+        Dl_info info;
+        if (dladdr(reinterpret_cast<void*>(address), &info) != 0) {
+            if (info.dli_sname != nullptr) {
+                return demangle(info.dli_sname);
+            }
+            if (info.dli_fname != nullptr) {
+                const char* base = strrchr(info.dli_fname, '/');
+                char offset[32];
+                snprintf(offset, sizeof(offset), "+0x%lx",
+                         static_cast<unsigned long>(
+                             address - reinterpret_cast<uintptr_t>(info.dli_fbase)));
+                return std::string(base ? base + 1 : info.dli_fname) + offset;
+            }
+        }
+        char hex[32];
+        snprintf(hex, sizeof(hex), "0x%lx", static_cast<unsigned long>(address));
+        return hex;
+    }
+
+    static std::string demangle(const char* name) {
+        int status = 0;
+        char* demangled = abi::__cxa_demangle(name, nullptr, nullptr, &status);
+        if (status != 0 || demangled == nullptr) {
+            return name;
+        }
+        std::string result(demangled);
+        free(demangled);
+        return result;
+    }
+
+#if defined(__linux__)
+    // Reloads when objects were loaded (dlopen) since the last load.
+    void load() {
+        size_t objects = 0;
+        dl_iterate_phdr(
+            [](struct dl_phdr_info*, size_t, void* data) {
+                ++*static_cast<size_t*>(data);
+                return 0;
+            },
+            &objects);
+        if (objects == objects_) {
+            return;
+        }
+        objects_ = objects;
+        symbols_.clear();
+        dl_iterate_phdr(
+            [](struct dl_phdr_info* info, size_t, void* data) {
+                const char* path = info->dlpi_name;
+                if (path == nullptr || *path == '\0') {
+                    path = "/proc/self/exe";
+                }
+                static_cast<Symbolizer*>(data)->load_object(path, info->dlpi_addr);
+                return 0;
+            },
+            this);
+        std::sort(symbols_.begin(), symbols_.end(),
+                  [](const Symbol& a, const Symbol& b) { return a.start < b.start; });
+    }
+
+    // Reads function symbols from .symtab, or .dynsym for stripped objects.
+    void load_object(const char* path, uintptr_t bias) {
+        int fd = open(path, O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            return;
+        }
+        struct stat st;
+        void* map = MAP_FAILED;
+        if (fstat(fd, &st) == 0 && st.st_size > 0) {
+            map = mmap(nullptr, size_t(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        }
+        close(fd);
+        if (map == MAP_FAILED) {
+            return;
+        }
+        const char* base = static_cast<const char*>(map);
+        size_t size = size_t(st.st_size);
+        const auto* header = reinterpret_cast<const ElfW(Ehdr)*>(base);
+        if (size >= sizeof(*header) && memcmp(header->e_ident, ELFMAG, SELFMAG) == 0 &&
+            header->e_shoff != 0 && header->e_shentsize == sizeof(ElfW(Shdr)) &&
+            header->e_shoff + size_t(header->e_shnum) * sizeof(ElfW(Shdr)) <= size) {
+            const auto* sections = reinterpret_cast<const ElfW(Shdr)*>(base + header->e_shoff);
+            const ElfW(Shdr)* table = nullptr;
+            for (size_t i = 0; i < header->e_shnum; ++i) {
+                if (sections[i].sh_type == SHT_SYMTAB) {
+                    table = &sections[i];
+                    break;
+                }
+                if (sections[i].sh_type == SHT_DYNSYM) {
+                    table = &sections[i];
+                }
+            }
+            if (table != nullptr && table->sh_link < header->e_shnum &&
+                table->sh_offset + table->sh_size <= size) {
+                const ElfW(Shdr)& strings = sections[table->sh_link];
+                const auto* symbols = reinterpret_cast<const ElfW(Sym)*>(base + table->sh_offset);
+                size_t count = table->sh_size / sizeof(ElfW(Sym));
+                for (size_t i = 0; i < count; ++i) {
+                    const ElfW(Sym)& symbol = symbols[i];
+                    unsigned type = symbol.st_info & 0xf;
+                    if ((type != STT_FUNC && type != STT_GNU_IFUNC) ||
+                        symbol.st_shndx == SHN_UNDEF || symbol.st_value == 0 ||
+                        symbol.st_name >= strings.sh_size ||
+                        strings.sh_offset + strings.sh_size > size) {
+                        continue;
+                    }
+                    symbols_.push_back({bias + symbol.st_value, symbol.st_size,
+                                        base + strings.sh_offset + symbol.st_name});
+                }
+            }
+        }
+        munmap(map, size);
+    }
+
+    std::vector<Symbol> symbols_;
+    size_t objects_ = 0;
+#endif
+    std::unordered_map<uintptr_t, std::string> cache_;
+};
+
+}  // namespace tk_runtime
+
+#endif  // TOOLCHAINKIT_SYMBOLIZER_H
@@ -0,0 +1,723 @@
+// ToolchainKit function instrumentation runtime.
+//
+// Implements __cyg_profile_func_enter/exit for code built with
+// -finstrument-functions. Each thread appends 16-byte events (timestamp
+// counter and function address) to its own ring buffer; nothing on the hot
+// path locks, allocates or makes a system call. When a ring is full the
+// oldest events are overwritten, so a dump holds the most recent events of
+// every thread.
+//
+// Events are turned into a Chrome trace (chrome://tracing, Perfetto) or
+// folded stacks (flamegraph.pl, speedscope) at exit, on a signal, or when
+// the program calls tk_instrument_dump(). Function names come from the ELF
+// symbol tables of the loaded objects (dladdr elsewhere) and are only looked
+// up when writing, or once per function when exclusion filters are set.
+//
+// Sampling records about one in N calls, chosen at random per thread, with
+// both its enter and exit so its duration is exact. A recorded call appears
+// under its nearest recorded caller; calls nested deeper than kMaxDepth are
+// not recorded.
+//
+// Environment (defaults are compiled in from the layer YAML):
+//   TOOLCHAINKIT_INSTRUMENT          0 disables recording
+//   TOOLCHAINKIT_INSTRUMENT_OUTPUT   Output file, %p is replaced by the pid
+//                                    (default: tk-instrument.%p.json/.folded)
+//   TOOLCHAINKIT_INSTRUMENT_FORMAT   chrome or folded
+//   TOOLCHAINKIT_INSTRUMENT_SAMPLE   Record one in N calls (1: all calls)
+//   TOOLCHAINKIT_INSTRUMENT_EXCLUDE  Comma-separated substrings of function
+//                                    names that are not recorded
+//   TOOLCHAINKIT_INSTRUMENT_BUFFER   Events per thread (rounded up to a power
+//                                    of two)
+//   TOOLCHAINKIT_INSTRUMENT_SIGNAL   Signal that writes the output (name or
+//                                    number, 0 for none)
+//
+// This file must be compiled without -finstrument-functions (GCC:
+// -fno-instrument-functions). With Clang, which has no negative flag, the
+// hot path only calls functions marked no_instrument_function and every
+// other path runs with the thread's recording disabled.
+
+#include "tk_instrument.h"
+
+#include "../common/tk_symbolizer.h"
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <time.h>
+#include <unistd.h>
+
+#if defined(__linux__)
+#include <sys/syscall.h>
+#endif
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Defaults, set by the toolchain file as bare tokens (-DNAME=value)
+#ifndef TK_INSTRUMENT_DEFAULT_FORMAT
+#define TK_INSTRUMENT_DEFAULT_FORMAT chrome
+#endif
+#ifndef TK_INSTRUMENT_DEFAULT_SAMPLE
+#define TK_INSTRUMENT_DEFAULT_SAMPLE 1
+#endif
+#ifndef TK_INSTRUMENT_DEFAULT_EXCLUDE
+#define TK_INSTRUMENT_DEFAULT_EXCLUDE
+#endif
+#ifndef TK_INSTRUMENT_DEFAULT_BUFFER
+#define TK_INSTRUMENT_DEFAULT_BUFFER 262144
+#endif
+#ifndef TK_INSTRUMENT_DEFAULT_SIGNAL
+#define TK_INSTRUMENT_DEFAULT_SIGNAL USR2
+#endif
+
+#define TK_STRING(...) #__VA_ARGS__
+#define TK_EXPAND_STRING(...) TK_STRING(__VA_ARGS__)
+
+#define TK_NO_INSTRUMENT __attribute__((no_instrument_function))
+#define TK_EXPORT extern "C" __attribute__((visibility("default"))) TK_NO_INSTRUMENT
+
+namespace {
+
+constexpr uint64_t kExitBit = uint64_t{1} << 63;
+constexpr size_t kFilterSlots = 1 << 16;
+constexpr size_t kFilterProbes = 32;
+constexpr uint32_t kMaxDepth = 1024;
+constexpr int64_t kMinCalibrationNs = 10 * 1000 * 1000;
+
+enum State : int { kNotStarted = 0, kRecording = 1, kPaused = 2, kStopped = 3 };
+
+struct Event {
+    uint64_t stamp;  // Timestamp counter; kExitBit set for exits
+    uintptr_t fn;
+};
+
+// One per thread; never freed, so a dump includes threads that have exited.
+struct Ring {
+    Event* events;
+    uint64_t mask;
+    uint64_t head;  // Events written; published with release stores
+    Ring* next;
+    uint64_t tid;
+    char name[32];
+    // Only used by the owning thread
+    uint32_t depth;
+    uint32_t countdown;  // Calls until the next sampled call
+    uint64_t random;     // xorshift state for sampling
+    bool sampled[kMaxDepth];  // Whether the call at each depth is recorded
+};
+
+struct FilterSlot {
+    uintptr_t fn;  // Published last, with a release store
+    bool excluded;
+};
+
+struct Config {
+    std::string output;
+    bool folded = false;
+    uint32_t sample = 1;
+    uint64_t buffer = 0;
+    int signal = 0;
+    std::vector<std::string> exclude;
+};
+
+// Set while a thread must not record: the dump thread, ring creation and
+// name lookups, which may call instrumented code (operator new, malloc).
+Ring* const kDisabled = reinterpret_cast<Ring*>(uintptr_t{1});
+
+__thread Ring* t_ring __attribute__((tls_model("initial-exec")));
+
+int g_state = kNotStarted;
+uint32_t g_sample = 1;
+uint64_t g_buffer = 0;
+bool g_filter = false;
+Ring* g_rings = nullptr;
+FilterSlot* g_filter_slots = nullptr;
+Config* g_config = nullptr;
+uint64_t g_ticks0 = 0;
+int64_t g_ns0 = 0;
+int g_pipe[2] = {-1, -1};
+
+std::mutex& symbol_mutex() {
+    static std::mutex mutex;
+    return mutex;
+}
+
+std::mutex& dump_mutex() {
+    static std::mutex mutex;
+    return mutex;
+}
+
+TK_NO_INSTRUMENT inline uint64_t ticks() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __builtin_ia32_rdtsc();
+#elif defined(__aarch64__)
+    uint64_t value;
+    __asm__ __volatile__("mrs %0, cntvct_el0" : "=r"(value));
+    return value;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return uint64_t(ts.tv_sec) * 1000000000u + uint64_t(ts.tv_nsec);
+#endif
+}
+
+int64_t monotonic_ns() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return int64_t(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+uint64_t thread_id() {
+#if defined(__linux__)
+    return uint64_t(syscall(SYS_gettid));
+#elif defined(__APPLE__)
+    uint64_t tid = 0;
+    pthread_threadid_np(nullptr, &tid);
+    return tid;
+#else
+    static uint64_t next = 1;
+    return __atomic_fetch_add(&next, 1, __ATOMIC_RELAXED);
+#endif
+}
+
+// Disables recording on the calling thread for the lifetime of the guard.
+class ThreadGuard {
+public:
+    TK_NO_INSTRUMENT ThreadGuard() : saved_(t_ring) { t_ring = kDisabled; }
+    TK_NO_INSTRUMENT ~ThreadGuard() { t_ring = saved_; }
+    ThreadGuard(const ThreadGuard&) = delete;
+    ThreadGuard& operator=(const ThreadGuard&) = delete;
+
+private:
+    Ring* saved_;
+};
+
+// ---------------------------------------------------------------------------
+// Recording
+
+__attribute__((noinline)) TK_NO_INSTRUMENT Ring* create_ring() {
+    t_ring = kDisabled;
+    if (__atomic_load_n(&g_state, __ATOMIC_ACQUIRE) == kStopped) {
+        return kDisabled;
+    }
+    size_t bytes = size_t(g_buffer) * sizeof(Event);
+    void* events =
+        mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANON, -1, 0);
+    Ring* ring = static_cast<Ring*>(calloc(1, sizeof(Ring)));
+    if (events == MAP_FAILED || ring == nullptr) {
+        return kDisabled;  // Leave this thread unrecorded
+    }
+    ring->events = static_cast<Event*>(events);
+    ring->mask = g_buffer - 1;
+    ring->tid = thread_id();
+    ring->countdown = 1;
+    ring->random = (uint64_t(ring->tid) << 32) ^ ticks() ^ 0x9E3779B97F4A7C15ull;
+    pthread_getname_np(pthread_self(), ring->name, sizeof(ring->name));
+
+    Ring* head = __atomic_load_n(&g_rings, __ATOMIC_RELAXED);
+    do {
+        ring->next = head;
+    } while (!__atomic_compare_exchange_n(
+        &g_rings, &head, ring, true, __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+    t_ring = ring;
+    return ring;
+}
+
+TK_NO_INSTRUMENT inline void push(Ring* ring, uint64_t stamp, uintptr_t fn) {
+    uint64_t head = ring->head;
+    Event* event = &ring->events[head & ring->mask];
+    __atomic_store_n(&event->stamp, stamp, __ATOMIC_RELAXED);
+    __atomic_store_n(&event->fn, fn, __ATOMIC_RELAXED);
+    __atomic_store_n(&ring->head, head + 1, __ATOMIC_RELEASE);
+}
+
+// Calls until the next recorded one: 1 without sampling, otherwise uniform
+// in [1, 2N - 1] so the mean is N and periodic call patterns do not alias.
+TK_NO_INSTRUMENT inline uint32_t next_countdown(Ring* ring) {
+    if (g_sample == 1) {
+        return 1;
+    }
+    uint64_t x = ring->random;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    ring->random = x;
+    return 1 + uint32_t(x % (2 * uint64_t(g_sample) - 1));
+}
+
+std::string symbol_name(uintptr_t address);
+
+bool matches_exclusion(uintptr_t fn) {
+    const std::string name = symbol_name(fn);
+    for (const std::string& pattern : g_config->exclude) {
+        if (name.find(pattern) != std::string::npos) {
+            return true;
+        }
+    }
+    return false;
+}
+
+__attribute__((noinline)) TK_NO_INSTRUMENT bool resolve_exclusion(uintptr_t fn) {
+    ThreadGuard guard;
+    bool excluded = matches_exclusion(fn);
+
+    std::lock_guard<std::mutex> lock(symbol_mutex());
+    size_t slot = (fn * 0x9E3779B97F4A7C15ull) >> 48;
+    for (size_t probe = 0; probe < kFilterProbes; ++probe) {
+        FilterSlot& entry = g_filter_slots[(slot + probe) & (kFilterSlots - 1)];
+        uintptr_t key = __atomic_load_n(&entry.fn, __ATOMIC_ACQUIRE);
+        if (key == fn) {
+            break;
+        }
+        if (key == 0) {
+            entry.excluded = excluded;
+            __atomic_store_n(&entry.fn, fn, __ATOMIC_RELEASE);
+            break;
+        }
+    }
+    return excluded;
+}
+
+TK_NO_INSTRUMENT inline bool is_excluded(uintptr_t fn) {
+    size_t slot = (fn * 0x9E3779B97F4A7C15ull) >> 48;
+    for (size_t probe = 0; probe < kFilterProbes; ++probe) {
+        const FilterSlot& entry = g_filter_slots[(slot + probe) & (kFilterSlots - 1)];
+        uintptr_t key = __atomic_load_n(&entry.fn, __ATOMIC_ACQUIRE);
+        if (key == fn) {
+            return entry.excluded;
+        }
+        if (key == 0) {
+            break;
+        }
+    }
+    return resolve_exclusion(fn);
+}
+
+// ---------------------------------------------------------------------------
+// Symbol names
+
+tk_runtime::Symbolizer& symbolizer() {
+    static auto* instance = new tk_runtime::Symbolizer();  // Used after static destruction
+    return *instance;
+}
+
+std::string symbol_name(uintptr_t address) {
+    std::lock_guard<std::mutex> lock(symbol_mutex());
+    return symbolizer().name(address);
+}
+
+// ---------------------------------------------------------------------------
+// Output
+
+struct Frame {
+    uintptr_t fn;
+    uint64_t start;
+    uint64_t children;  // Ticks spent in recorded callees
+};
+
+// Copies a ring's events, dropping any the owner overwrote meanwhile.
+std::vector<Event> snapshot(Ring* ring) {
+    uint64_t capacity = ring->mask + 1;
+    uint64_t head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+    uint64_t first = head > capacity ? head - capacity : 0;
+    std::vector<Event> events;
+    events.reserve(head - first);
+    for (uint64_t i = first; i < head; ++i) {
+        const Event* event = &ring->events[i & ring->mask];
+        events.push_back({__atomic_load_n(&event->stamp, __ATOMIC_RELAXED),
+                          __atomic_load_n(&event->fn, __ATOMIC_RELAXED)});
+    }
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    uint64_t after = __atomic_load_n(&ring->head, __ATOMIC_RELAXED);
+    uint64_t valid = after > capacity ? after - capacity : 0;
+    if (valid > first) {
+        events.erase(events.begin(),
+                     events.begin() + std::min<uint64_t>(valid - first, events.size()));
+    }
+    return events;
+}
+
+// Rebuilds call frames and calls close(stack, end) for each, innermost
+// first. Exits without a recorded enter (overwritten) are skipped; frames
+// still open at the end close at the last timestamp.
+template <typename Close>
+void replay(const std::vector<Event>& events, Close close) {
+    std::vector<Frame> stack;
+    uint64_t last = 0;
+    for (const Event& event : events) {
+        uint64_t stamp = event.stamp & ~kExitBit;
+        last = std::max(last, stamp);
+        if ((event.stamp & kExitBit) == 0) {
+            stack.push_back({event.fn, stamp, 0});
+            continue;
+        }
+        size_t depth = stack.size();
+        while (depth > 0 && stack[depth - 1].fn != event.fn) {
+            --depth;
+        }
+        if (depth == 0) {
+            continue;
+        }
+        // Frames above the match were left without an exit (longjmp)
+        while (stack.size() >= depth) {
+            close(stack, stamp);
+            stack.pop_back();
+        }
+    }
+    while (!stack.empty()) {
+        close(stack, last);
+        stack.pop_back();
+    }
+}
+
+void write_json_string(FILE* out, const std::string& text) {
+    fputc('"', out);
+    for (unsigned char c : text) {
+        if (c == '"' || c == '\\') {
+            fputc('\\', out);
+            fputc(c, out);
+        } else if (c < 0x20) {
+            fprintf(out, "\\u%04x", c);
+        } else {
+            fputc(c, out);
+        }
+    }
+    fputc('"', out);
+}
+
+void write_chrome(FILE* out, const std::vector<Ring*>& rings, double us_per_tick) {
+    tk_runtime::Symbolizer& names = symbolizer();
+    long pid = long(getpid());
+    bool first = true;
+    auto separator = [&]() {
+        fputs(first ? "\n" : ",\n", out);
+        first = false;
+    };
+
+    fputs("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[", out);
+    for (Ring* ring : rings) {
+        separator();
+        fprintf(out, "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":%ld,\"tid\":%llu,"
+                     "\"args\":{\"name\":",
+                pid, static_cast<unsigned long long>(ring->tid));
+        write_json_string(out, ring->name[0] ? std::string(ring->name)
+                                             : "thread " + std::to_string(ring->tid));
+        fputs("}}", out);
+
+        replay(snapshot(ring), [&](std::vector<Frame>& stack, uint64_t end) {
+            const Frame& frame = stack.back();
+            separator();
+            fputs("{\"ph\":\"X\",\"name\":", out);
+            write_json_string(out, names.name(frame.fn));
+            fprintf(out, ",\"pid\":%ld,\"tid\":%llu,\"ts\":%.3f,\"dur\":%.3f}", pid,
+                    static_cast<unsigned long long>(ring->tid),
+                    double(int64_t(frame.start - g_ticks0)) * us_per_tick,
+                    double(end - frame.start) * us_per_tick);
+        });
+    }
+    fputs("\n]}\n", out);
+}
+
+// One line per call stack: "outer;inner <self time in ns>"
+void write_folded(FILE* out, const std::vector<Ring*>& rings, double ns_per_tick) {
+    tk_runtime::Symbolizer& names = symbolizer();
+    std::map<std::string, double> self_time;
+    for (Ring* ring : rings) {
+        replay(snapshot(ring), [&](std::vector<Frame>& stack, uint64_t end) {
+            Frame& frame = stack.back();
+            uint64_t total = end - frame.start;
+            if (stack.size() > 1) {
+                stack[stack.size() - 2].children += total;
+            }
+            std::string path;
+            for (const Frame& caller : stack) {
+                if (!path.empty()) {
+                    path += ';';
+                }
+                path += names.name(caller.fn);
+            }
+            uint64_t self = total > frame.children ? total - frame.children : 0;
+            self_time[path] += double(self) * ns_per_tick;
+        });
+    }
+    for (const auto& entry : self_time) {
+        unsigned long long ns = static_cast<unsigned long long>(entry.second + 0.5);
+        if (ns > 0) {
+            fprintf(out, "%s %llu\n", entry.first.c_str(), ns);
+        }
+    }
+}
+
+// Timestamp counter frequency, measured against the monotonic clock over
+// the program's lifetime (at least kMinCalibrationNs).
+double ns_per_tick() {
+    int64_t ns = monotonic_ns();
+    if (ns - g_ns0 < kMinCalibrationNs) {
+        struct timespec pause = {0, long(kMinCalibrationNs - (ns - g_ns0))};
+        nanosleep(&pause, nullptr);
+        ns = monotonic_ns();
+    }
+    uint64_t elapsed = ticks() - g_ticks0;
+    return elapsed ? double(ns - g_ns0) / double(elapsed) : 1.0;
+}
+
+std::string output_path(const char* path) {
+    std::string result = path ? path : g_config->output;
+    size_t pos;
+    while ((pos = result.find("%p")) != std::string::npos) {
+        result.replace(pos, 2, std::to_string(long(getpid())));
+    }
+    return result;
+}
+
+int dump(const char* path) {
+    if (g_config == nullptr) {
+        return -1;
+    }
+    ThreadGuard guard;
+    std::lock_guard<std::mutex> dumping(dump_mutex());
+
+    std::vector<Ring*> rings;
+    for (Ring* ring = __atomic_load_n(&g_rings, __ATOMIC_ACQUIRE); ring; ring = ring->next) {
+        rings.push_back(ring);
+    }
+    std::sort(rings.begin(), rings.end(),
+              [](const Ring* a, const Ring* b) { return a->tid < b->tid; });
+    double scale = ns_per_tick();
+
+    std::string target = output_path(path);
+    std::string temporary = target + ".tmp";
+    FILE* out = fopen(temporary.c_str(), "w");
+    if (out == nullptr) {
+        return -1;
+    }
+    {
+        std::lock_guard<std::mutex> lock(symbol_mutex());
+        if (g_config->folded) {
+            write_folded(out, rings, scale);
+        } else {
+            write_chrome(out, rings, scale / 1000.0);
+        }
+    }
+    bool ok = ferror(out) == 0;
+    ok = fclose(out) == 0 && ok;
+    if (!ok || rename(temporary.c_str(), target.c_str()) != 0) {
+        unlink(temporary.c_str());
+        return -1;
+    }
+    return 0;
+}
+
+// ---------------------------------------------------------------------------
+// Setup
+
+TK_NO_INSTRUMENT void on_signal(int) {
+    int saved = errno;
+    char byte = 1;
+    ssize_t ignored = write(g_pipe[1], &byte, 1);
+    (void)ignored;
+    errno = saved;
+}
+
+void* dump_thread(void*) {
+    t_ring = kDisabled;
+    char byte;
+    for (;;) {
+        ssize_t n = read(g_pipe[0], &byte, 1);
+        if (n == 1) {
+            dump(nullptr);
+        } else if (n == 0 || errno != EINTR) {
+            return nullptr;
+        }
+    }
+}
+
+int parse_signal(const char* value) {
+    if (value == nullptr || *value == '\0') {
+        return 0;
+    }
+    if (strncmp(value, "SIG", 3) == 0) {
+        value += 3;
+    }
+    static const struct {
+        const char* name;
+        int number;
+    } names[] = {{"USR1", SIGUSR1}, {"USR2", SIGUSR2}, {"HUP", SIGHUP},
+                 {"PROF", SIGPROF}, {"QUIT", SIGQUIT}};
+    for (const auto& entry : names) {
+        if (strcmp(value, entry.name) == 0) {
+            return entry.number;
+        }
+    }
+    return atoi(value);
+}
+
+const char* setting(const char* name, const char* fallback) {
+    const char* value = getenv(name);
+    return value != nullptr ? value : fallback;
+}
+
+void start_signal_handler(int signal) {
+    if (signal <= 0 || pipe(g_pipe) != 0) {
+        return;
+    }
+    fcntl(g_pipe[0], F_SETFD, FD_CLOEXEC);
+    fcntl(g_pipe[1], F_SETFD, FD_CLOEXEC);
+    fcntl(g_pipe[1], F_SETFL, O_NONBLOCK);
+
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+    pthread_t thread;
+    bool started = pthread_create(&thread, &attr, dump_thread, nullptr) == 0;
+    pthread_attr_destroy(&attr);
+    if (!started) {
+        return;
+    }
+
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = on_signal;
+    action.sa_flags = SA_RESTART;
+    sigemptyset(&action.sa_mask);
+    sigaction(signal, &action, nullptr);
+}
+
+__attribute__((constructor(101))) TK_NO_INSTRUMENT void initialize() {
+    t_ring = kDisabled;
+    if (strcmp(setting("TOOLCHAINKIT_INSTRUMENT", "1"), "0") == 0) {
+        __atomic_store_n(&g_state, kStopped, __ATOMIC_RELEASE);
+        t_ring = nullptr;
+        return;
+    }
+
+    auto* config = new Config();
+    const char* format = setting("TOOLCHAINKIT_INSTRUMENT_FORMAT",
+                                 TK_EXPAND_STRING(TK_INSTRUMENT_DEFAULT_FORMAT));
+    config->folded = strcmp(format, "folded") == 0;
+    config->output = setting("TOOLCHAINKIT_INSTRUMENT_OUTPUT",
+                             config->folded ? "tk-instrument.%p.folded"
+                                            : "tk-instrument.%p.json");
+    long sample = atol(setting("TOOLCHAINKIT_INSTRUMENT_SAMPLE",
+                               TK_EXPAND_STRING(TK_INSTRUMENT_DEFAULT_SAMPLE)));
+    config->sample = uint32_t(std::max(1L, sample));
+    long long buffer = atoll(setting("TOOLCHAINKIT_INSTRUMENT_BUFFER",
+                                     TK_EXPAND_STRING(TK_INSTRUMENT_DEFAULT_BUFFER)));
+    config->buffer = 1024;
+    while (config->buffer < uint64_t(std::max(1LL, buffer)) && config->buffer < (1ull << 32)) {
+        config->buffer <<= 1;
+    }
+    std::string exclude = setting("TOOLCHAINKIT_INSTRUMENT_EXCLUDE",
+                                  TK_EXPAND_STRING(TK_INSTRUMENT_DEFAULT_EXCLUDE));
+    size_t start = 0;
+    while (start <= exclude.size()) {
+        size_t end = exclude.find(',', start);
+        if (end == std::string::npos) {
+            end = exclude.size();
+        }
+        if (end > start) {
+            config->exclude.push_back(exclude.substr(start, end - start));
+        }
+        start = end + 1;
+    }
+    config->signal = parse_signal(setting("TOOLCHAINKIT_INSTRUMENT_SIGNAL",
+                                          TK_EXPAND_STRING(TK_INSTRUMENT_DEFAULT_SIGNAL)));
+
+    g_config = config;
+    g_sample = config->sample;
+    g_buffer = config->buffer;
+    if (!config->exclude.empty()) {
+        g_filter_slots = static_cast<FilterSlot*>(calloc(kFilterSlots, sizeof(FilterSlot)));
+        g_filter = g_filter_slots != nullptr;
+    }
+    symbol_mutex();
+    dump_mutex();
+    start_signal_handler(config->signal);
+
+    g_ns0 = monotonic_ns();
+    g_ticks0 = ticks();
+    t_ring = nullptr;
+    __atomic_store_n(&g_state, kRecording, __ATOMIC_RELEASE);
+}
+
+__attribute__((destructor(101))) TK_NO_INSTRUMENT void finish() {
+    if (__atomic_exchange_n(&g_state, kStopped, __ATOMIC_ACQ_REL) == kStopped) {
+        return;
+    }
+    dump(nullptr);
+}
+
+}  // namespace
+
+// ---------------------------------------------------------------------------
+// Hooks and API
+
+TK_EXPORT void __cyg_profile_func_enter(void* fn, void*) {
+    int state = __atomic_load_n(&g_state, __ATOMIC_RELAXED);
+    if (state != kRecording && state != kPaused) {
+        return;
+    }
+    Ring* ring = t_ring;
+    if (__builtin_expect(ring == nullptr, 0)) {
+        ring = create_ring();
+    }
+    if (ring == kDisabled) {
+        return;
+    }
+    uintptr_t address = reinterpret_cast<uintptr_t>(fn);
+    if (g_filter && is_excluded(address)) {
+        return;
+    }
+    uint32_t depth = ring->depth++;
+    if (depth >= kMaxDepth) {
+        return;
+    }
+    bool record = state == kRecording && --ring->countdown == 0;
+    ring->sampled[depth] = record;
+    if (record) {
+        ring->countdown = next_countdown(ring);
+        push(ring, ticks(), address);
+    }
+}
+
+TK_EXPORT void __cyg_profile_func_exit(void* fn, void*) {
+    Ring* ring = t_ring;
+    if (ring == nullptr || ring == kDisabled ||
+        __atomic_load_n(&g_state, __ATOMIC_RELAXED) == kStopped) {
+        return;
+    }
+    uintptr_t address = reinterpret_cast<uintptr_t>(fn);
+    if (g_filter && is_excluded(address)) {
+        return;
+    }
+    if (ring->depth == 0) {
+        return;  // Entered before the thread's first recorded call
+    }
+    uint32_t depth = --ring->depth;
+    if (depth < kMaxDepth && ring->sampled[depth]) {
+        push(ring, ticks() | kExitBit, address);
+    }
+}
+
+TK_EXPORT int tk_instrument_dump(const char* path) { return dump(path); }
+
+TK_EXPORT void tk_instrument_pause(void) {
+    int expected = kRecording;
+    __atomic_compare_exchange_n(&g_state, &expected, kPaused, false, __ATOMIC_ACQ_REL,
+                                __ATOMIC_RELAXED);
+}
+
+TK_EXPORT void tk_instrument_resume(void) {
+    int expected = kPaused;
+    __atomic_compare_exchange_n(&g_state, &expected, kRecording, false, __ATOMIC_ACQ_REL,
+                                __ATOMIC_RELAXED);
+}
@@ -0,0 +1,34 @@
+/*
+ * ToolchainKit function instrumentation runtime.
+ *
+ * Linked into every target by the profiling/instrument-functions layer. The
+ * runtime records __cyg_profile_func_enter/exit events and writes them at
+ * exit and on a signal (SIGUSR2 by default); these functions control it from
+ * the program itself.
+ */
+#ifndef TOOLCHAINKIT_INSTRUMENT_H
+#define TOOLCHAINKIT_INSTRUMENT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Write the events recorded so far.
+ *
+ * path: Output file, or NULL for TOOLCHAINKIT_INSTRUMENT_OUTPUT
+ * Returns 0 on success, -1 if the file cannot be written.
+ */
+int tk_instrument_dump(const char* path);
+
+/* Stop starting new recorded call trees; calls already recorded complete. */
+void tk_instrument_pause(void);
+
+/* Resume recording after tk_instrument_pause(). */
+void tk_instrument_resume(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TOOLCHAINKIT_INSTRUMENT_H */
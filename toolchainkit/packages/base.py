@@ -22,6 +22,7 @@ from dataclasses import dataclass
 from pathlib import Path
 from typing import List, Optional
 
+from toolchainkit.core import tracing
 from toolchainkit.core.exceptions import (
     PackageManagerDetectionError,
 )
@@ -307,7 +308,11 @@ class PackageManagerDetector:
 
         for manager in self.managers:
             try:
-                if manager.detect():
+                with tracing.span(
+                    "detect package manager", "packages", manager=manager.get_name()
+                ):
+                    found = manager.detect()
+                if found:
                     detected.append(manager)
             except Exception as e:
                 raise PackageManagerDetectionError(
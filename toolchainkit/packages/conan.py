@@ -35,6 +35,7 @@ import os
 from pathlib import Path
 from typing import Optional, Dict
 
+from toolchainkit.core import tracing
 from toolchainkit.packages.base import PackageManager
 from toolchainkit.core.exceptions import (
     PackageManagerError,
@@ -369,9 +370,11 @@ class ConanIntegration(PackageManager):
 
         # Run conan install
         try:
-            result = subprocess.run(
-                cmd, capture_output=True, text=True, cwd=self.project_root, env=env
-            )
+            with tracing.span("conan install", "subprocess", command=cmd) as span:
+                result = subprocess.run(
+                    cmd, capture_output=True, text=True, cwd=self.project_root, env=env
+                )
+                span.set(returncode=result.returncode)
         except Exception as e:
             raise PackageManagerInstallError(
                 f"Failed to execute Conan: {e}\n" f"Command: {' '.join(cmd)}"
@@ -12,6 +12,7 @@ from typing import Optional
 from dataclasses import dataclass
 
 from toolchainkit.core.filesystem import safe_rmtree
+from toolchainkit.core.manifest import write_manifest
 from toolchainkit.core.platform import PlatformInfo, detect_platform
 
 logger = logging.getLogger(__name__)
@@ -481,6 +482,7 @@ class CMakeDownloader:
             if not self.is_installed():
                 raise ToolDownloadError("CMake installation verification failed")
 
+            write_manifest(self.install_dir)
             logger.info(f"CMake {self.version} installed successfully")
             return self.install_dir
 
@@ -663,6 +665,7 @@ class NinjaDownloader:
             if not self.is_installed():
                 raise ToolDownloadError("Ninja installation verification failed")
 
+            write_manifest(self.install_dir)
             logger.info(f"Ninja {self.version} installed successfully")
             return self.install_dir
 
@@ -867,6 +870,7 @@ class SccacheDownloader:
             if not self.is_installed():
                 raise ToolDownloadError("sccache installation verification failed")
 
+            write_manifest(self.install_dir)
             logger.info(f"sccache {self.version} installed successfully")
             return self.install_dir
 
@@ -1122,6 +1126,7 @@ class PythonDownloader:
             if self.platform.os == "windows":
                 self._install_pip_on_windows()
 
+            write_manifest(self.install_dir)
             logger.info(f"Python {self.version} installed successfully")
             return self.install_dir
 
@@ -1422,6 +1427,7 @@ class MakeDownloader:
             if not self.is_installed():
                 raise ToolDownloadError("Make installation verification failed")
 
+            write_manifest(self.install_dir)
             logger.info(f"Make (w64devkit {self.version}) installed successfully")
             return self.install_dir
 
@@ -1590,6 +1596,8 @@ class GitDownloader:
             if not exe_path or not exe_path.exists():
                 raise ToolDownloadError("Git executable not found after extraction")
 
+            write_manifest(self.tool_dir)
+
             return exe_path
 
         except Exception as e:
@@ -1768,6 +1776,8 @@ class ClangToolsDownloader:
             if not format_path or not format_path.exists():
                 raise ToolDownloadError("clang-format not found after extraction")
 
+            write_manifest(self.tool_dir)
+
             return (tidy_path, format_path)
 
         except Exception as e:
@@ -1981,6 +1991,8 @@ class CppcheckDownloader:
                     "Cppcheck executable not found after extraction"
                 )
 
+            write_manifest(self.tool_dir)
+
             return exe_path
 
         except Exception as e:
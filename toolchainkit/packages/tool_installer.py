@@ -0,0 +1,358 @@
+"""
+Concurrent installation of build tools.
+
+Installs a set of tools (CMake, Ninja, sccache, clang-tidy/clang-format,
+cppcheck, Python, Git, Conan) on a bounded thread pool instead of one after
+another. Downloads overlap with each other and with the extraction of tools
+that already finished downloading; all downloads share the keep-alive HTTP
+session of ``toolchainkit.core.download``. Dependencies are respected (Conan
+with hermetic Python waits for Python).
+
+Progress of all tools is aggregated into one ``InstallProgress`` snapshot,
+suitable for a single status line.
+
+Example:
+    >>> from toolchainkit.packages.tool_installer import ToolInstaller
+    >>> installer = ToolInstaller(tools_dir, max_workers=4)
+    >>> results = installer.install(
+    ...     ["cmake", "ninja", "sccache", "clang-tools"],
+    ...     progress_callback=lambda p: print(p.summary()),
+    ... )
+    >>> results["cmake"].success
+    True
+"""
+
+import logging
+import threading
+import time
+from concurrent.futures import FIRST_COMPLETED, Future, ThreadPoolExecutor, wait
+from dataclasses import dataclass, field
+from pathlib import Path
+from typing import Any, Callable, Dict, List, Optional, Sequence, Tuple
+
+from toolchainkit.core.download import DownloadProgress, progress_listener
+from toolchainkit.core.platform import PlatformInfo, detect_platform
+
+from .tool_downloader import (
+    ClangToolsDownloader,
+    CMakeDownloader,
+    ConanDownloader,
+    CppcheckDownloader,
+    GitDownloader,
+    NinjaDownloader,
+    PythonDownloader,
+    SccacheDownloader,
+)
+
+logger = logging.getLogger(__name__)
+
+DEFAULT_WORKERS = 4
+"""Concurrent installs (downloads are network bound, extraction CPU bound)."""
+
+
+@dataclass
+class ToolSpec:
+    """How to create and install one tool."""
+
+    create: Callable[[Path, PlatformInfo], Any]
+    """Factory (tools_dir, platform) -> downloader."""
+
+    depends_on: Tuple[str, ...] = ()
+    """Tools that must be installed first."""
+
+
+TOOL_SPECS: Dict[str, ToolSpec] = {
+    "cmake": ToolSpec(lambda d, p: CMakeDownloader(d, platform=p)),
+    "ninja": ToolSpec(lambda d, p: NinjaDownloader(d, platform=p)),
+    "sccache": ToolSpec(lambda d, p: SccacheDownloader(d, platform=p)),
+    "clang-tools": ToolSpec(lambda d, p: ClangToolsDownloader(p, d)),
+    "cppcheck": ToolSpec(lambda d, p: CppcheckDownloader(p, d)),
+    "python": ToolSpec(lambda d, p: PythonDownloader(d, platform=p)),
+    "git": ToolSpec(lambda d, p: GitDownloader(p, d)),
+    "conan": ToolSpec(lambda d, p: ConanDownloader(d, platform=p)),
+}
+"""Installable tools by name."""
+
+
+@dataclass
+class ToolProgress:
+    """Progress of one tool."""
+
+    phase: str = "pending"
+    """pending, downloading, installing, done, failed or skipped."""
+
+    bytes_downloaded: int = 0
+    total_bytes: int = 0
+
+
+@dataclass
+class InstallProgress:
+    """Aggregated progress of all tools being installed."""
+
+    tools: Dict[str, ToolProgress] = field(default_factory=dict)
+    elapsed_seconds: float = 0.0
+
+    @property
+    def bytes_downloaded(self) -> int:
+        """Bytes downloaded by all tools."""
+        return sum(t.bytes_downloaded for t in self.tools.values())
+
+    @property
+    def total_bytes(self) -> int:
+        """Known download size of all tools (grows as downloads start)."""
+        return sum(t.total_bytes for t in self.tools.values())
+
+    @property
+    def finished(self) -> int:
+        """Tools that are done, failed or skipped."""
+        return sum(
+            t.phase in ("done", "failed", "skipped") for t in self.tools.values()
+        )
+
+    def summary(self) -> str:
+        """One status line, e.g. ``[2/5] 41.0/96.3 MB  cmake 43%, sccache installing``."""
+        active = []
+        for name, tool in self.tools.items():
+            if tool.phase == "downloading" and tool.total_bytes:
+                active.append(
+                    f"{name} {tool.bytes_downloaded * 100 // tool.total_bytes}%"
+                )
+            elif tool.phase in ("downloading", "installing"):
+                active.append(f"{name} {tool.phase}")
+        return (
+            f"[{self.finished}/{len(self.tools)}] "
+            f"{self.bytes_downloaded / 1024**2:.1f}/{self.total_bytes / 1024**2:.1f} MB"
+            + (f"  {', '.join(active)}" if active else "")
+        )
+
+
+@dataclass
+class ToolInstallResult:
+    """Result of installing one tool."""
+
+    name: str
+    success: bool
+    path: Optional[Path] = None
+    error: Optional[str] = None
+    seconds: float = 0.0
+    already_installed: bool = False
+
+
+class ToolInstaller:
+    """
+    Install several build tools concurrently.
+
+    Example:
+        >>> installer = ToolInstaller(get_global_cache_dir() / "tools")
+        >>> results = installer.install(["cmake", "ninja"])
+        >>> failed = [r for r in results.values() if not r.success]
+    """
+
+    def __init__(
+        self,
+        tools_dir: Path,
+        platform: Optional[PlatformInfo] = None,
+        max_workers: int = DEFAULT_WORKERS,
+        hermetic_python: bool = False,
+        specs: Optional[Dict[str, ToolSpec]] = None,
+    ):
+        """
+        Initialize tool installer.
+
+        Args:
+            tools_dir: Directory to install tools into
+            platform: Platform information (auto-detected if None)
+            max_workers: Maximum concurrent installs
+            hermetic_python: Install Conan with the downloaded Python
+            specs: Tool specifications (default: TOOL_SPECS)
+        """
+        self.tools_dir = Path(tools_dir)
+        self.platform = platform or detect_platform()
+        self.max_workers = max(1, max_workers)
+        self.hermetic_python = hermetic_python
+        self.specs = dict(specs or TOOL_SPECS)
+        if hermetic_python and "conan" in self.specs:
+            self.specs["conan"] = ToolSpec(self.specs["conan"].create, ("python",))
+
+        self._lock = threading.Lock()
+        self._progress = InstallProgress()
+        self._callback: Optional[Callable[[InstallProgress], None]] = None
+        self._start = 0.0
+
+    def install(
+        self,
+        names: Sequence[str],
+        progress_callback: Optional[Callable[[InstallProgress], None]] = None,
+    ) -> Dict[str, ToolInstallResult]:
+        """
+        Install tools, running independent installs concurrently.
+
+        Dependencies missing from ``names`` are added automatically. A tool
+        whose dependency failed is skipped.
+
+        Args:
+            names: Tool names (keys of TOOL_SPECS)
+            progress_callback: Called with an InstallProgress snapshot
+
+        Returns:
+            Dict of tool name -> ToolInstallResult
+
+        Raises:
+            ValueError: If a tool name is unknown or dependencies are cyclic
+        """
+        order = self._resolve(names)
+        self._progress = InstallProgress(tools={name: ToolProgress() for name in order})
+        self._callback = progress_callback
+        self._start = time.perf_counter()
+
+        results: Dict[str, ToolInstallResult] = {}
+        pending = list(order)
+        running: Dict[Future, str] = {}
+
+        with ThreadPoolExecutor(max_workers=self.max_workers) as pool:
+            while pending or running:
+                for name in list(pending):
+                    deps = self.specs[name].depends_on
+                    if any(dep in pending or dep in running.values() for dep in deps):
+                        continue
+                    pending.remove(name)
+                    failed = [d for d in deps if not results[d].success]
+                    if failed:
+                        results[name] = ToolInstallResult(
+                            name, False, error=f"dependency failed: {', '.join(failed)}"
+                        )
+                        self._update(name, phase="skipped")
+                        continue
+                    running[pool.submit(self._install_one, name)] = name
+
+                if not running:
+                    continue
+                done, _ = wait(running, return_when=FIRST_COMPLETED)
+                for future in done:
+                    name = running.pop(future)
+                    results[name] = future.result()
+
+        return {name: results[name] for name in order}
+
+    def _resolve(self, names: Sequence[str]) -> List[str]:
+        """Expand dependencies and return tools in dependency order."""
+        order: List[str] = []
+        visiting: List[str] = []
+
+        def visit(name: str):
+            if name in order:
+                return
+            if name not in self.specs:
+                raise ValueError(
+                    f"Unknown tool: {name}. Available: {', '.join(sorted(self.specs))}"
+                )
+            if name in visiting:
+                raise ValueError(f"Dependency cycle: {' -> '.join(visiting + [name])}")
+            visiting.append(name)
+            for dep in self.specs[name].depends_on:
+                visit(dep)
+            visiting.pop()
+            order.append(name)
+
+        for name in names:
+            visit(name)
+        return order
+
+    def _install_one(self, name: str) -> ToolInstallResult:
+        """Install one tool (runs on a pool thread)."""
+        start = time.perf_counter()
+        try:
+            downloader = self.specs[name].create(self.tools_dir, self.platform)
+            if downloader.is_installed():
+                self._update(name, phase="done")
+                return ToolInstallResult(
+                    name,
+                    True,
+                    path=tool_executable(downloader),
+                    already_installed=True,
+                )
+
+            self._update(name, phase="downloading")
+
+            def on_download(progress: DownloadProgress):
+                phase = (
+                    "installing"
+                    if progress.bytes_downloaded >= progress.total_bytes > 0
+                    else "downloading"
+                )
+                self._update(
+                    name,
+                    phase=phase,
+                    bytes_downloaded=progress.bytes_downloaded,
+                    total_bytes=progress.total_bytes,
+                )
+
+            with progress_listener(on_download):
+                if name == "conan":
+                    downloader.download(use_hermetic_python=self.hermetic_python)
+                else:
+                    downloader.download()
+
+            self._update(name, phase="done")
+            return ToolInstallResult(
+                name,
+                True,
+                path=tool_executable(downloader),
+                seconds=time.perf_counter() - start,
+            )
+        except Exception as e:
+            logger.error(f"Failed to install {name}: {e}")
+            self._update(name, phase="failed")
+            return ToolInstallResult(
+                name, False, error=str(e), seconds=time.perf_counter() - start
+            )
+
+    def _update(self, name: str, **changes) -> None:
+        """Update one tool's progress and report the aggregate."""
+        with self._lock:
+            tool = self._progress.tools[name]
+            for key, value in changes.items():
+                setattr(tool, key, value)
+            self._progress.elapsed_seconds = time.perf_counter() - self._start
+            if self._callback:
+                self._callback(self._progress)
+
+
+def tool_executable(downloader) -> Optional[Path]:
+    """
+    Main executable of a tool installed by a tool downloader.
+
+    Args:
+        downloader: Downloader instance (e.g. from a ToolSpec)
+
+    Returns:
+        Executable path, or None if the tool is not installed
+    """
+    for getter in ("get_executable_path", "get_clang_tidy_path"):
+        if hasattr(downloader, getter):
+            return getattr(downloader, getter)()
+    return None
+
+
+def install_tools(
+    names: Sequence[str],
+    tools_dir: Path,
+    platform: Optional[PlatformInfo] = None,
+    max_workers: int = DEFAULT_WORKERS,
+    progress_callback: Optional[Callable[[InstallProgress], None]] = None,
+) -> Dict[str, ToolInstallResult]:
+    """
+    Install build tools concurrently (convenience wrapper for ToolInstaller).
+
+    Args:
+        names: Tool names (keys of TOOL_SPECS)
+        tools_dir: Directory to install tools into
+        platform: Platform information (auto-detected if None)
+        max_workers: Maximum concurrent installs
+        progress_callback: Called with an InstallProgress snapshot
+
+    Returns:
+        Dict of tool name -> ToolInstallResult
+    """
+    installer = ToolInstaller(tools_dir, platform=platform, max_workers=max_workers)
+    return installer.install(names, progress_callback=progress_callback)
@@ -32,6 +32,7 @@ import os
 from pathlib import Path
 from typing import Optional
 
+from toolchainkit.core import tracing
 from toolchainkit.packages.base import PackageManager
 from toolchainkit.core.exceptions import (
     PackageManagerError,
@@ -275,9 +276,11 @@ class VcpkgIntegration(PackageManager):
 
         # Run vcpkg install
         try:
-            result = subprocess.run(
-                cmd, capture_output=True, text=True, cwd=self.project_root
-            )
+            with tracing.span("vcpkg install", "subprocess", command=cmd) as span:
+                result = subprocess.run(
+                    cmd, capture_output=True, text=True, cwd=self.project_root
+                )
+                span.set(returncode=result.returncode)
         except Exception as e:
             raise PackageManagerInstallError(
                 f"Failed to execute vcpkg: {e}\n" f"Command: {' '.join(cmd)}"
@@ -189,29 +189,28 @@ class Plugin(ABC):
 
 
 # Export public API
-# Import plugin types
-from toolchainkit.plugins.compiler import CompilerPlugin  # noqa: E402
-from toolchainkit.plugins.package_manager import (  # noqa: E402
-    PackageManagerPlugin,
-    PackageManagerError,
+# Plugin types, discovery, loading and the manager are imported on first use;
+# the registry alone must stay cheap because every `tkgen` run imports it
+from toolchainkit.core.lazy import lazy_exports  # noqa: E402
+
+__getattr__, __dir__ = lazy_exports(
+    __name__,
+    {
+        ".compiler": ["CompilerPlugin"],
+        ".package_manager": ["PackageManagerPlugin", "PackageManagerError"],
+        ".build_backend": ["BuildBackendPlugin", "BuildBackendError"],
+        ".metadata": ["PluginMetadata", "PluginMetadataParser"],
+        ".discovery": ["PluginDiscoverer"],
+        ".loader": ["PluginLoader"],
+        ".registry": [
+            "PluginRegistry",
+            "get_global_registry",
+            "reset_global_registry",
+        ],
+        ".context": ["PluginContext"],
+        ".manager": ["PluginManager"],
+    },
 )
-from toolchainkit.plugins.build_backend import (  # noqa: E402
-    BuildBackendPlugin,
-    BuildBackendError,
-)
-from toolchainkit.plugins.metadata import (  # noqa: E402
-    PluginMetadata,
-    PluginMetadataParser,
-)
-from toolchainkit.plugins.discovery import PluginDiscoverer  # noqa: E402
-from toolchainkit.plugins.loader import PluginLoader  # noqa: E402
-from toolchainkit.plugins.registry import (  # noqa: E402
-    PluginRegistry,
-    get_global_registry,
-    reset_global_registry,
-)
-from toolchainkit.plugins.context import PluginContext  # noqa: E402
-from toolchainkit.plugins.manager import PluginManager  # noqa: E402
 
 __all__ = [
     # Base class
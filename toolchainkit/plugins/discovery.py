@@ -2,12 +2,15 @@
 Plugin discovery system for finding available plugins.
 
 This module provides functionality to scan plugin directories and discover
-available plugins without loading their code.
+available plugins without loading their code. Parsed manifests are kept
+in a persistent index (see toolchainkit.plugins.index), so unchanged plugin
+directories are revalidated with stat calls instead of YAML parsing.
 """
 
 import os
 from pathlib import Path
 from typing import List, Dict, Optional
+from toolchainkit.plugins.index import PluginIndex
 from toolchainkit.plugins.metadata import PluginMetadata, PluginMetadataParser
 from toolchainkit.plugins import PluginValidationError
 
@@ -25,7 +28,10 @@ class PluginDiscoverer:
     """
 
     def __init__(
-        self, project_root: Optional[Path] = None, project_config: Optional[dict] = None
+        self,
+        project_root: Optional[Path] = None,
+        project_config: Optional[dict] = None,
+        index: Optional[PluginIndex] = None,
     ):
         """
         Initialize plugin discoverer.
@@ -34,10 +40,12 @@ class PluginDiscoverer:
             project_root: Optional project root for project-local plugins.
                          If None, only global and env plugins discovered.
             project_config: Optional project configuration dict (from toolchainkit.yaml)
+            index: Manifest index (defaults to ~/.toolchainkit/plugin-index.json)
         """
         self.project_root = project_root
         self.project_config = project_config or {}
         self.parser = PluginMetadataParser()
+        self.index = index or PluginIndex()
 
     def discover(self) -> List[PluginMetadata]:
         """
@@ -60,10 +68,10 @@ class PluginDiscoverer:
 
         # Scan in reverse priority order (so higher priority overwrites)
         for directory in reversed(self._get_plugin_directories()):
-            discovered = self.discover_in_directory(directory)
-            for plugin in discovered:
+            for plugin in self._scan(directory):
                 plugins_by_name[plugin.name] = plugin
 
+        self.index.save()
         return list(plugins_by_name.values())
 
     def discover_in_directory(self, directory: Path) -> List[PluginMetadata]:
@@ -84,52 +92,14 @@ class PluginDiscoverer:
             discoverer = PluginDiscoverer()
             plugins = discoverer.discover_in_directory(Path("~/.toolchainkit/plugins"))
         """
-        if not directory.exists():
-            return []
-
-        if not directory.is_dir():
-            return []
-
-        plugins = []
-
-        try:
-            # Each plugin is in its own subdirectory
-            for item in directory.iterdir():
-                if not item.is_dir():
-                    continue
-
-                plugin_yaml = item / "plugin.yaml"
-                if not plugin_yaml.exists():
-                    continue
-
-                try:
-                    metadata = self.parser.parse_file(plugin_yaml)
-                    plugins.append(metadata)
-                except PluginValidationError as e:
-                    # Log warning but continue discovery
-                    import warnings
-
-                    warnings.warn(
-                        f"Skipping invalid plugin at {plugin_yaml}: {e}",
-                        RuntimeWarning,
-                    )
-                except Exception as e:
-                    # Log warning for any other errors
-                    import warnings
-
-                    warnings.warn(
-                        f"Error loading plugin at {plugin_yaml}: {e}", RuntimeWarning
-                    )
-
-        except PermissionError:
-            # Can't read directory - skip silently
-            pass
-        except Exception:
-            # Other errors - skip silently
-            pass
-
+        plugins = self._scan(directory)
+        self.index.save()
         return plugins
 
+    def _scan(self, directory: Path) -> List[PluginMetadata]:
+        """Plugins in a directory, from the index where still valid."""
+        return self.index.scan(directory, self.parser.parse_file, _warn_invalid)
+
     def _get_plugin_directories(self) -> List[Path]:
         """
         Get list of plugin directories to search (in priority order).
@@ -208,4 +178,15 @@ class PluginDiscoverer:
             return []
 
 
+def _warn_invalid(plugin_yaml: Path, error: Exception) -> None:
+    """Warn about a plugin.yaml that could not be parsed; discovery continues."""
+    import warnings
+
+    if isinstance(error, PluginValidationError):
+        message = f"Skipping invalid plugin at {plugin_yaml}: {error}"
+    else:
+        message = f"Error loading plugin at {plugin_yaml}: {error}"
+    warnings.warn(message, RuntimeWarning)
+
+
 __all__ = ["PluginDiscoverer"]
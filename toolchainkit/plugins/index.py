@@ -0,0 +1,193 @@
+"""
+Persistent index of discovered plugin manifests.
+
+Discovery used to list every plugin directory and YAML-parse every
+plugin.yaml on each run. The index records, per plugin directory, its
+mtime and the plugin subdirectories it contained, and per plugin.yaml its
+stat signature, SHA-256 and parsed metadata. An unchanged directory is then
+revalidated with one stat per plugin; a plugin.yaml whose stat changed but
+whose content did not (touched, copied, checked out again) is rehashed but
+not reparsed.
+
+The index lives at ~/.toolchainkit/plugin-index.json. It is only a cache:
+a missing, corrupt or outdated index is rebuilt, and failing to write it
+is not an error.
+"""
+
+import dataclasses
+import hashlib
+import json
+import logging
+import os
+from pathlib import Path
+from typing import Any, Callable, Dict, List, Optional
+
+from toolchainkit.core.filecache import file_signature
+from toolchainkit.plugins.metadata import PluginMetadata
+
+logger = logging.getLogger(__name__)
+
+# Bump when PluginMetadata or the index layout changes
+INDEX_VERSION = 1
+
+INDEX_FILE = "plugin-index.json"
+
+
+def default_index_path() -> Path:
+    """Location of the per-user plugin index."""
+    from toolchainkit.core.directory import get_global_cache_dir
+
+    return get_global_cache_dir() / INDEX_FILE
+
+
+def _dump(metadata: PluginMetadata) -> Dict[str, Any]:
+    data = dataclasses.asdict(metadata)
+    del data["plugin_dir"]
+    return data
+
+
+def _restore(data: Dict[str, Any], plugin_dir: Path) -> PluginMetadata:
+    return PluginMetadata(**data, plugin_dir=plugin_dir)
+
+
+class PluginIndex:
+    """
+    Cache of plugin manifests keyed by directory mtimes and manifest hashes.
+
+    Example:
+        index = PluginIndex()
+        plugins = index.scan(Path("~/.toolchainkit/plugins"), parser.parse_file)
+        index.save()
+    """
+
+    def __init__(self, path: Optional[Path] = None):
+        """
+        Initialize the index.
+
+        Args:
+            path: Index file (defaults to ~/.toolchainkit/plugin-index.json)
+        """
+        self.path = path or default_index_path()
+        self._directories: Optional[Dict[str, Any]] = None
+        self._dirty = False
+
+    def _load(self) -> Dict[str, Any]:
+        if self._directories is None:
+            self._directories = {}
+            try:
+                data = json.loads(self.path.read_text(encoding="utf-8"))
+                if data.get("version") == INDEX_VERSION:
+                    self._directories = data["directories"]
+            except (OSError, ValueError, KeyError, AttributeError):
+                pass
+        return self._directories
+
+    def scan(
+        self,
+        directory: Path,
+        parse: Callable[[Path], PluginMetadata],
+        on_error: Optional[Callable[[Path, Exception], None]] = None,
+    ) -> List[PluginMetadata]:
+        """
+        List the plugins in a directory, parsing only changed manifests.
+
+        Args:
+            directory: Directory containing <plugin>/plugin.yaml subdirectories
+            parse: Parser for manifests that are not in the index
+            on_error: Called with the manifest path and exception when
+                parsing fails; failed manifests are skipped and reparsed
+                on the next scan
+
+        Returns:
+            PluginMetadata for every valid plugin, sorted by subdirectory
+        """
+        directories = self._load()
+        key = str(directory)
+        record = directories.get(key)
+
+        try:
+            mtime = directory.stat().st_mtime_ns
+        except OSError:
+            if directories.pop(key, None) is not None:
+                self._dirty = True
+            return []
+
+        if record and record["mtime"] == mtime:
+            names = list(record["plugins"])
+            manifests = record["plugins"]
+        else:
+            try:
+                names = sorted(
+                    item.name for item in directory.iterdir() if item.is_dir()
+                )
+            except OSError:
+                return []
+            manifests = record["plugins"] if record else {}
+
+        plugins = []
+        entries: Dict[str, Any] = {}
+        for name in names:
+            manifest = directory / name / "plugin.yaml"
+            signature = file_signature(manifest)
+            cached = manifests.get(name)
+            entries[name] = None
+            if signature is None:
+                continue
+
+            signature = list(signature)
+            try:
+                if cached and cached["signature"] == signature:
+                    digest = cached["sha256"]
+                else:
+                    digest = hashlib.sha256(manifest.read_bytes()).hexdigest()
+                metadata = None
+                if cached and cached["sha256"] == digest:
+                    try:
+                        metadata = _restore(cached["metadata"], manifest.parent)
+                        entries[name] = dict(cached, signature=signature)
+                    except TypeError:
+                        pass  # Written by a version with different fields
+                if metadata is None:
+                    metadata = parse(manifest)
+                    entries[name] = {
+                        "signature": signature,
+                        "sha256": digest,
+                        "metadata": _dump(metadata),
+                    }
+            except Exception as e:
+                if on_error is not None:
+                    on_error(manifest, e)
+                continue
+
+            plugins.append(metadata)
+
+        new_record = {"mtime": mtime, "plugins": entries}
+        if new_record != record:
+            directories[key] = new_record
+            self._dirty = True
+        return plugins
+
+    def save(self) -> None:
+        """Write the index if it changed since it was loaded."""
+        if not self._dirty:
+            return
+        from toolchainkit.core.filesystem import atomic_write
+
+        data = {"version": INDEX_VERSION, "directories": self._directories}
+        try:
+            atomic_write(self.path, json.dumps(data, sort_keys=True))
+            self._dirty = False
+        except OSError as e:
+            logger.debug(f"Could not write plugin index {self.path}: {e}")
+
+    def clear(self) -> None:
+        """Forget every indexed directory and remove the index file."""
+        self._directories = {}
+        self._dirty = False
+        try:
+            os.unlink(self.path)
+        except OSError:
+            pass
+
+
+__all__ = ["INDEX_VERSION", "PluginIndex", "default_index_path"]
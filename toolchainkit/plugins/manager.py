@@ -13,6 +13,7 @@ from typing import TYPE_CHECKING, Any, Optional, Dict, List, Tuple
 from toolchainkit.plugins.context import PluginContext
 from toolchainkit.plugins.discovery import PluginDiscoverer
 from toolchainkit.plugins.loader import PluginLoader
+from toolchainkit.plugins.metadata import PluginMetadata
 from toolchainkit.plugins.registry import get_global_registry
 
 if TYPE_CHECKING:
@@ -71,6 +72,7 @@ class PluginManager:
         self,
         cache_base_dir: Optional[Path] = None,
         config: Optional[Dict[str, Any]] = None,
+        lazy: bool = True,
     ) -> int:
         """
         Discover and load all available plugins.
@@ -82,14 +84,22 @@ class PluginManager:
         4. Calls plugin.initialize(context)
         5. Handles errors gracefully (continues loading other plugins)
 
+        Plugins that declare capabilities under 'provides' in plugin.yaml
+        are not imported here: their declared names are registered with the
+        registry, which loads the plugin the first time one of them is
+        looked up.
+
         Args:
             cache_base_dir: Base directory for plugin caches
                            (defaults to ~/.toolchainkit/plugins/cache)
             config: Global configuration dict to pass to plugins
                    (defaults to empty dict)
+            lazy: Defer plugins that declare capabilities (False loads
+                  every plugin now)
 
         Returns:
-            Number of plugins successfully loaded and initialized
+            Number of plugins successfully loaded and initialized, or
+            registered for loading on first use
 
         Example:
             ```python
@@ -98,49 +108,21 @@ class PluginManager:
             print(f"Successfully loaded {loaded_count} plugins")
             ```
         """
-        if cache_base_dir is None:
-            cache_base_dir = Path.home() / ".toolchainkit" / "plugins" / "cache"
-
-        if config is None:
-            config = {}
-
         # Discover all plugins
         metadata_list = self.discoverer.discover()
         logger.info(f"Discovered {len(metadata_list)} plugins")
 
         loaded_count = 0
         for metadata in metadata_list:
-            try:
-                # Load plugin module and instantiate plugin class
-                plugin = self.loader.load(metadata)
-                logger.debug(f"Loaded plugin: {metadata.name}")
-
-                # Create plugin-specific cache directory
-                plugin_cache_dir = cache_base_dir / metadata.name
-                plugin_cache_dir.mkdir(parents=True, exist_ok=True)
-
-                # Create context for plugin
-                context = PluginContext(
-                    registry=self.registry,
-                    cache_dir=plugin_cache_dir,
-                    config=config,
+            if lazy and metadata.is_lazy:
+                self.registry.register_plugin_loader(
+                    metadata.provides,
+                    lambda m=metadata: self._load_plugin(m, cache_base_dir, config),
                 )
-
-                # Initialize plugin
-                plugin.initialize(context)
-                logger.info(f"Initialized plugin: {metadata.name} v{metadata.version}")
-
-                # Store reference to loaded plugin
-                self._loaded_plugins.append((metadata.name, plugin))
+                logger.debug(f"Deferred plugin: {metadata.name}")
+                loaded_count += 1
+            elif self._load_plugin(metadata, cache_base_dir, config):
                 loaded_count += 1
-
-            except Exception as e:
-                # Log error but continue with other plugins
-                logger.error(
-                    f"Failed to load plugin '{metadata.name}': {e}",
-                    exc_info=True,
-                )
-                continue
 
         logger.info(f"Successfully loaded {loaded_count}/{len(metadata_list)} plugins")
         return loaded_count
@@ -169,46 +151,65 @@ class PluginManager:
                 print("Zig compiler plugin loaded")
             ```
         """
-        if cache_base_dir is None:
-            cache_base_dir = Path.home() / ".toolchainkit" / "plugins" / "cache"
-
-        if config is None:
-            config = {}
-
         # Discover all plugins and find the one we want
         metadata_list = self.discoverer.discover()
 
         for metadata in metadata_list:
             if metadata.name == plugin_name:
-                try:
-                    plugin = self.loader.load(metadata)
-
-                    plugin_cache_dir = cache_base_dir / metadata.name
-                    plugin_cache_dir.mkdir(parents=True, exist_ok=True)
+                return self._load_plugin(metadata, cache_base_dir, config)
 
-                    context = PluginContext(
-                        registry=self.registry,
-                        cache_dir=plugin_cache_dir,
-                        config=config,
-                    )
+        logger.warning(f"Plugin '{plugin_name}' not found")
+        return False
 
-                    plugin.initialize(context)
-                    logger.info(
-                        f"Initialized plugin: {metadata.name} v{metadata.version}"
-                    )
+    def _load_plugin(
+        self,
+        metadata: PluginMetadata,
+        cache_base_dir: Optional[Path],
+        config: Optional[Dict[str, Any]],
+    ) -> bool:
+        """
+        Load, instantiate and initialize one plugin.
 
-                    self._loaded_plugins.append((metadata.name, plugin))
-                    return True
+        Returns:
+            True if the plugin was initialized, False if it failed (logged)
+        """
+        if cache_base_dir is None:
+            cache_base_dir = Path.home() / ".toolchainkit" / "plugins" / "cache"
 
-                except Exception as e:
-                    logger.error(
-                        f"Failed to load plugin '{metadata.name}': {e}",
-                        exc_info=True,
-                    )
-                    return False
+        if config is None:
+            config = {}
 
-        logger.warning(f"Plugin '{plugin_name}' not found")
-        return False
+        try:
+            # Load plugin module and instantiate plugin class
+            plugin = self.loader.load(metadata)
+            logger.debug(f"Loaded plugin: {metadata.name}")
+
+            # Create plugin-specific cache directory
+            plugin_cache_dir = cache_base_dir / metadata.name
+            plugin_cache_dir.mkdir(parents=True, exist_ok=True)
+
+            # Create context for plugin
+            context = PluginContext(
+                registry=self.registry,
+                cache_dir=plugin_cache_dir,
+                config=config,
+            )
+
+            # Initialize plugin
+            plugin.initialize(context)
+            logger.info(f"Initialized plugin: {metadata.name} v{metadata.version}")
+
+            # Store reference to loaded plugin
+            self._loaded_plugins.append((metadata.name, plugin))
+            return True
+
+        except Exception as e:
+            # Log error but let the caller continue with other plugins
+            logger.error(
+                f"Failed to load plugin '{metadata.name}': {e}",
+                exc_info=True,
+            )
+            return False
 
     def cleanup_all(self) -> None:
         """
@@ -5,7 +5,6 @@ This module handles parsing and validating plugin.yaml files according to the
 plugin metadata schema.
 """
 
-import yaml
 from dataclasses import dataclass, field
 from typing import List, Optional, Dict, Any
 from pathlib import Path
@@ -39,6 +38,9 @@ class PluginMetadata:
     platforms: List[str] = field(default_factory=list)
     tags: List[str] = field(default_factory=list)
     permissions: List[str] = field(default_factory=list)
+    # Capability kind -> names the plugin registers (see CAPABILITIES).
+    # Plugins that declare capabilities are imported on first lookup.
+    provides: Dict[str, List[str]] = field(default_factory=dict)
 
     # Set by parser
     plugin_dir: Optional[Path] = None
@@ -119,6 +121,11 @@ class PluginMetadata:
         """
         return self.entry_point.rsplit(".", 1)[1]
 
+    @property
+    def is_lazy(self) -> bool:
+        """True if the plugin declares capabilities and can be loaded on demand."""
+        return any(self.provides.values())
+
 
 class PluginMetadataParser:
     """
@@ -139,6 +146,9 @@ class PluginMetadataParser:
 
     VALID_TYPES = ["compiler", "package_manager", "backend"]
 
+    # Capability kinds a plugin may declare under 'provides'
+    CAPABILITIES = ["compilers", "package_managers", "backends", "toolchain_providers"]
+
     def parse_file(self, yaml_path: Path) -> PluginMetadata:
         """
         Parse plugin.yaml file.
@@ -162,6 +172,8 @@ class PluginMetadataParser:
                 str(yaml_path), [f"File not found: {yaml_path}"]
             )
 
+        import yaml
+
         try:
             with open(yaml_path, "r", encoding="utf-8") as f:
                 data = yaml.safe_load(f)
@@ -196,6 +208,7 @@ class PluginMetadataParser:
             platforms=data.get("platforms", []),
             tags=data.get("tags", []),
             permissions=data.get("permissions", []),
+            provides={k: v for k, v in (data.get("provides") or {}).items() if v},
             plugin_dir=yaml_path.parent,
         )
 
@@ -273,6 +286,23 @@ class PluginMetadataParser:
                 elif not all(isinstance(item, str) for item in data[field_name]):
                     issues.append(f"All items in '{field_name}' must be strings")
 
+        provides = data.get("provides")
+        if provides is not None:
+            if not isinstance(provides, dict):
+                issues.append("Field 'provides' must be a dictionary")
+            else:
+                for kind, names in provides.items():
+                    if kind not in self.CAPABILITIES:
+                        issues.append(
+                            f"Unknown capability '{kind}' in 'provides'. "
+                            f"Must be one of: {', '.join(self.CAPABILITIES)}"
+                        )
+                    elif names is not None and (
+                        not isinstance(names, list)
+                        or not all(isinstance(name, str) for name in names)
+                    ):
+                        issues.append(f"'provides.{kind}' must be a list of strings")
+
         return issues
 
     def _is_valid_semver(self, version_str: str) -> bool:
@@ -3,9 +3,36 @@ Plugin registry for managing registered plugins.
 
 This module provides a central registry for storing and accessing
 registered compilers, package managers, and build backends from plugins.
+
+Built-in compiler strategies, package managers and toolchain providers are
+registered as factories: has/list queries see them immediately, but their
+modules are imported only when they are first looked up, so commands that
+never need them do not pay for the imports.
+
+Plugins that declare their capabilities in plugin.yaml are handled the same
+way, one level up: the plugin manager registers a loader for the declared
+names, and the plugin is imported and initialized (registering its real
+entries) when one of them is first looked up.
 """
 
-from typing import Dict, List, Any, Optional
+from typing import Any, Callable, Dict, List, Optional
+
+
+class _Deferred:
+    """Registry entry created by a factory on first lookup."""
+
+    __slots__ = ("factory",)
+
+    def __init__(self, factory: Callable[[], Any]):
+        self.factory = factory
+
+
+def _resolve(store: Dict[str, Any], name: str) -> Any:
+    """Return a registry entry, creating it first if it is deferred."""
+    value = store[name]
+    if isinstance(value, _Deferred):
+        value = store[name] = value.factory()
+    return value
 
 
 class PluginRegistry:
@@ -28,6 +55,8 @@ class PluginRegistry:
         self._package_managers: Dict[str, Any] = {}
         self._backends: Dict[str, Any] = {}
         self._toolchain_providers: List[Any] = []  # List of ToolchainProvider instances
+        # Capability kind -> declared name -> loader of a not yet loaded plugin
+        self._pending: Dict[str, Dict[str, Callable[[], None]]] = {}
 
     # ========================================================================
     # Registration Methods
@@ -69,6 +98,21 @@ class PluginRegistry:
             raise ValueError(f"Compiler strategy '{name}' is already registered")
         self._compiler_strategies[name] = strategy
 
+    def register_compiler_strategy_factory(
+        self, name: str, factory: Callable[[], Any]
+    ) -> None:
+        """
+        Register a compiler strategy created on first lookup.
+
+        Args:
+            name: Compiler type name
+            factory: Callable returning the CompilerStrategy instance
+
+        Raises:
+            ValueError: If strategy with same name already registered
+        """
+        self.register_compiler_strategy(name, _Deferred(factory))
+
     def register_package_manager(self, name: str, manager: Any) -> None:
         """
         Register a package manager.
@@ -87,6 +131,21 @@ class PluginRegistry:
             raise ValueError(f"Package manager '{name}' is already registered")
         self._package_managers[name] = manager
 
+    def register_package_manager_factory(
+        self, name: str, factory: Callable[[], Any]
+    ) -> None:
+        """
+        Register a package manager created on first lookup.
+
+        Args:
+            name: Package manager name
+            factory: Callable returning the package manager (class or instance)
+
+        Raises:
+            ValueError: If package manager with same name already registered
+        """
+        self.register_package_manager(name, _Deferred(factory))
+
     def register_backend(self, name: str, backend: Any) -> None:
         """
         Register a build backend.
@@ -117,6 +176,60 @@ class PluginRegistry:
         """
         self._toolchain_providers.append(provider)
 
+    def register_toolchain_provider_factory(self, factory: Callable[[], Any]) -> None:
+        """
+        Register a toolchain provider created when providers are first listed.
+
+        Args:
+            factory: Callable returning the ToolchainProvider instance, or
+                None if the provider is unavailable (it is then dropped)
+        """
+        self._toolchain_providers.append(_Deferred(factory))
+
+    def register_plugin_loader(
+        self, provides: Dict[str, List[str]], load: Callable[[], None]
+    ) -> None:
+        """
+        Register a plugin that is loaded when one of its capabilities is used.
+
+        Until then, the declared names count as registered for has/list
+        queries. Looking one of them up (or listing toolchain providers, for
+        a plugin that provides any) calls load() once, which is expected to
+        initialize the plugin and register the real entries.
+
+        Args:
+            provides: Capability kind ('compilers', 'package_managers',
+                'backends', 'toolchain_providers') -> names; 'compilers'
+                covers both compiler configurations and strategies
+            load: Callable loading and initializing the plugin
+
+        Example:
+            registry.register_plugin_loader({"compilers": ["zig"]}, load_zig)
+        """
+        for kind, names in provides.items():
+            pending = self._pending.setdefault(kind, {})
+            for name in names:
+                pending.setdefault(name, load)
+
+    def _load_pending(self, kind: str, name: Optional[str] = None) -> None:
+        """Load the plugin declaring name (or all plugins declaring kind)."""
+        pending = self._pending.get(kind)
+        if not pending:
+            return
+        for key in list(pending) if name is None else [name]:
+            load = pending.get(key)
+            if load is None:
+                continue
+            # Forget every name of this plugin first, so that its own
+            # registrations do not trigger it again
+            for declared in self._pending.values():
+                for other in [k for k, v in declared.items() if v is load]:
+                    del declared[other]
+            load()
+
+    def _pending_names(self, kind: str, registered: Dict[str, Any]) -> List[str]:
+        return [n for n in self._pending.get(kind, {}) if n not in registered]
+
     # ========================================================================
     # Lookup Methods
     # ========================================================================
@@ -137,6 +250,8 @@ class PluginRegistry:
         Example:
             zig_config = registry.get_compiler('zig')
         """
+        if name not in self._compilers:
+            self._load_pending("compilers", name)
         if name not in self._compilers:
             raise KeyError(f"Compiler '{name}' not found in registry")
         return self._compilers[name]
@@ -157,9 +272,11 @@ class PluginRegistry:
         Example:
             zig_strategy = registry.get_compiler_strategy('zig')
         """
+        if name not in self._compiler_strategies:
+            self._load_pending("compilers", name)
         if name not in self._compiler_strategies:
             raise KeyError(f"Compiler strategy '{name}' not found in registry")
-        return self._compiler_strategies[name]
+        return _resolve(self._compiler_strategies, name)
 
     def get_package_manager(self, name: str) -> Any:
         """
@@ -177,9 +294,11 @@ class PluginRegistry:
         Example:
             hunter = registry.get_package_manager('hunter')
         """
+        if name not in self._package_managers:
+            self._load_pending("package_managers", name)
         if name not in self._package_managers:
             raise KeyError(f"Package manager '{name}' not found in registry")
-        return self._package_managers[name]
+        return _resolve(self._package_managers, name)
 
     def get_backend(self, name: str) -> Any:
         """
@@ -197,6 +316,8 @@ class PluginRegistry:
         Example:
             meson = registry.get_backend('meson')
         """
+        if name not in self._backends:
+            self._load_pending("backends", name)
         if name not in self._backends:
             raise KeyError(f"Build backend '{name}' not found in registry")
         return self._backends[name]
@@ -219,7 +340,7 @@ class PluginRegistry:
             if registry.has_compiler('zig'):
                 config = registry.get_compiler('zig')
         """
-        return name in self._compilers
+        return name in self._compilers or name in self._pending.get("compilers", {})
 
     def has_compiler_strategy(self, name: str) -> bool:
         """
@@ -231,7 +352,9 @@ class PluginRegistry:
         Returns:
             True if registered, False otherwise
         """
-        return name in self._compiler_strategies
+        return name in self._compiler_strategies or name in self._pending.get(
+            "compilers", {}
+        )
 
     def has_package_manager(self, name: str) -> bool:
         """
@@ -243,7 +366,9 @@ class PluginRegistry:
         Returns:
             True if registered, False otherwise
         """
-        return name in self._package_managers
+        return name in self._package_managers or name in self._pending.get(
+            "package_managers", {}
+        )
 
     def has_backend(self, name: str) -> bool:
         """
@@ -255,7 +380,7 @@ class PluginRegistry:
         Returns:
             True if registered, False otherwise
         """
-        return name in self._backends
+        return name in self._backends or name in self._pending.get("backends", {})
 
     def get_toolchain_providers(self) -> List[Any]:
         """
@@ -270,6 +395,12 @@ class PluginRegistry:
                 if provider.can_provide('zig', '0.13.0'):
                     path = provider.provide_toolchain('zig', '0.13.0', 'windows-x64')
         """
+        self._load_pending("toolchain_providers")
+        providers = [
+            p.factory() if isinstance(p, _Deferred) else p
+            for p in self._toolchain_providers
+        ]
+        self._toolchain_providers = [p for p in providers if p is not None]
         return self._toolchain_providers.copy()
 
     def list_compilers(self) -> List[str]:
@@ -283,7 +414,7 @@ class PluginRegistry:
             compilers = registry.list_compilers()
             print(f"Available compilers: {', '.join(compilers)}")
         """
-        return list(self._compilers.keys())
+        return list(self._compilers) + self._pending_names("compilers", self._compilers)
 
     def list_compiler_strategies(self) -> List[str]:
         """
@@ -292,7 +423,9 @@ class PluginRegistry:
         Returns:
             List of compiler strategy names
         """
-        return list(self._compiler_strategies.keys())
+        return list(self._compiler_strategies) + self._pending_names(
+            "compilers", self._compiler_strategies
+        )
 
     def list_package_managers(self) -> List[str]:
         """
@@ -301,7 +434,9 @@ class PluginRegistry:
         Returns:
             List of package manager names
         """
-        return list(self._package_managers.keys())
+        return list(self._package_managers) + self._pending_names(
+            "package_managers", self._package_managers
+        )
 
     def list_backends(self) -> List[str]:
         """
@@ -310,7 +445,7 @@ class PluginRegistry:
         Returns:
             List of backend names
         """
-        return list(self._backends.keys())
+        return list(self._backends) + self._pending_names("backends", self._backends)
 
     # ========================================================================
     # Management Methods
@@ -320,7 +455,8 @@ class PluginRegistry:
         """
         Clear all registered items.
 
-        Removes all compilers, compiler strategies, package managers, and backends.
+        Removes all compilers, compiler strategies, package managers, backends
+        and not yet loaded plugins.
         Useful for testing or reinitialization.
 
         Example:
@@ -330,6 +466,7 @@ class PluginRegistry:
         self._compiler_strategies.clear()
         self._package_managers.clear()
         self._backends.clear()
+        self._pending.clear()
 
 
 # ============================================================================
@@ -0,0 +1,6 @@
+"""
+Profiling support for ToolchainKit.
+
+This package analyzes the output of the profiling layers, such as the
+optimization records of ``profiling/opt-remarks`` (``tkgen remarks``).
+"""
@@ -0,0 +1,467 @@
+"""
+Allocation traces.
+
+The allocator proxy (``data/runtime/allocator/tk_malloc_proxy.cpp``) writes
+every allocation, free and realloc of a program to a binary trace when
+``TOOLCHAINKIT_ALLOCATOR_TRACE`` is set; ``tk_alloc_replay.cpp`` replays one
+against another allocator. This module reads traces, summarizes them and
+writes trimmed or compressed copies.
+
+A trace is a header followed by chunks of events, one thread per chunk;
+see the proxy's source for the byte layout. The proxy records timestamp
+counter ticks and the counter's frequency at exit; times read here are
+nanoseconds since the trace started (ticks, if the program did not exit
+normally). Events of different threads are put in one order by time,
+frees first at equal times, to pair frees with allocations by address:
+
+- A free of an address that is not allocated (allocated before tracing
+  started, or before a trimmed window) is unmatched and ignored.
+- An allocation of an address that is still allocated means its free was
+  recorded later than the allocation that reused the block (a race between
+  threads); the old block counts as freed.
+
+Example:
+    >>> trace = read_trace("app.1234.tkat")
+    >>> print(format_summary(summarize(trace)))
+    >>> write_trace(trim_trace(trace, start=2.0, end=5.0), "window.tkat.gz")
+"""
+
+import gzip
+import heapq
+import lzma
+import struct
+from dataclasses import asdict, dataclass, field
+from pathlib import Path
+from typing import Any, Dict, Iterator, List, NamedTuple, Optional, Tuple, Union
+
+MAGIC = b"TKAT"
+VERSION = 1
+
+MALLOC = 1
+FREE = 2
+REALLOC = 3
+ALIGNED = 4
+CALLOC = 5
+
+OP_NAMES = {
+    MALLOC: "malloc",
+    FREE: "free",
+    REALLOC: "realloc",
+    ALIGNED: "aligned",
+    CALLOC: "calloc",
+}
+
+# Written chunks are at most this large, like the proxy's buffers
+CHUNK_BYTES = 64 * 1024
+
+_HEADER = struct.Struct("<4sIQdQ")
+_CHUNK = struct.Struct("<IIQ")
+_GZIP_MAGIC = b"\x1f\x8b"
+_XZ_MAGIC = b"\xfd7zXZ\x00"
+
+
+class TraceError(Exception):
+    """Raised when a trace cannot be read or written."""
+
+
+class Event(NamedTuple):
+    """One traced call; time in nanoseconds since the trace started."""
+
+    time: int
+    op: int
+    address: int  # Block allocated or freed; realloc's old block
+    size: int = 0
+    moved: int = 0  # realloc's new block, 0 if it failed or freed
+    alignment: int = 0  # ALIGNED only
+
+
+@dataclass
+class Trace:
+    """Events per traced thread, each in the order the thread made them."""
+
+    start_ns: int = 0  # Timestamp counter when tracing started, in ns
+    threads: Dict[int, List[Event]] = field(default_factory=dict)
+
+    @property
+    def event_count(self) -> int:
+        return sum(len(events) for events in self.threads.values())
+
+    @property
+    def duration_ns(self) -> int:
+        return max((e[-1].time for e in self.threads.values() if e), default=0)
+
+
+def _open(path: Path, mode: str):
+    """Open a plain, gzip or xz file (by content when reading)."""
+    if "r" in mode:
+        with open(path, "rb") as f:
+            magic = f.read(6)
+        if magic.startswith(_GZIP_MAGIC):
+            return gzip.open(path, mode)
+        if magic == _XZ_MAGIC:
+            return lzma.open(path, mode)
+        return open(path, mode)
+    if path.suffix == ".gz":
+        return gzip.open(path, mode)
+    if path.suffix == ".xz":
+        return lzma.open(path, mode)
+    return open(path, mode)
+
+
+def _decode_chunk(
+    payload: bytes, ticks: int, ns_per_tick: float, events: List[Event]
+) -> None:
+    """Decode one chunk's events, appending them to events."""
+    pos = 0
+    end = len(payload)
+    address = 0
+
+    def varint() -> int:
+        nonlocal pos
+        result = shift = 0
+        while True:
+            byte = payload[pos]
+            pos += 1
+            result |= (byte & 0x7F) << shift
+            if byte < 0x80:
+                return result
+            shift += 7
+
+    def next_address() -> int:
+        nonlocal address
+        value = varint()
+        delta = (value >> 1) ^ -(value & 1)  # Zigzag
+        address = (address + delta) & 0xFFFFFFFFFFFFFFFF
+        return address
+
+    try:
+        while pos < end:
+            op_byte = payload[pos]
+            pos += 1
+            ticks += varint()
+            time = round(ticks * ns_per_tick)
+            op = op_byte & 7
+            if op == FREE:
+                events.append(Event(time, FREE, next_address()))
+            elif op == REALLOC:
+                old = next_address()
+                size = varint()
+                events.append(Event(time, REALLOC, old, size, next_address()))
+            elif op in (MALLOC, CALLOC, ALIGNED):
+                size = varint()
+                alignment = 1 << (op_byte >> 3) if op == ALIGNED else 0
+                events.append(Event(time, op, next_address(), size, 0, alignment))
+            else:
+                raise TraceError(f"Unknown trace event {op_byte:#x}")
+    except IndexError as e:
+        raise TraceError("Truncated trace chunk") from e
+
+
+def read_trace(path: Union[str, Path]) -> Trace:
+    """
+    Read a trace written by the proxy or by write_trace().
+
+    Compressed traces (gzip, xz) are detected by content.
+
+    Raises:
+        TraceError: If the file is not a trace or is corrupt
+    """
+    path = Path(path)
+    try:
+        with _open(path, "rb") as f:
+            data = f.read()
+    except (OSError, EOFError, lzma.LZMAError) as e:
+        raise TraceError(f"Cannot read {path}: {e}") from e
+    if len(data) < _HEADER.size:
+        raise TraceError(f"{path} is not an allocation trace")
+    magic, version, start, ns_per_tick, _ = _HEADER.unpack_from(data)
+    if magic != MAGIC:
+        raise TraceError(f"{path} is not an allocation trace")
+    if version != VERSION:
+        raise TraceError(f"{path}: unsupported trace version {version}")
+
+    ns_per_tick = ns_per_tick or 1.0  # Not calibrated
+    trace = Trace(start_ns=round(start * ns_per_tick))
+    pos = _HEADER.size
+    # A process killed while writing may leave a partial last chunk
+    while pos + _CHUNK.size <= len(data):
+        thread, size, base_time = _CHUNK.unpack_from(data, pos)
+        pos += _CHUNK.size
+        if pos + size > len(data):
+            break
+        if size:
+            events = trace.threads.setdefault(thread, [])
+            _decode_chunk(
+                data[pos : pos + size], base_time - start, ns_per_tick, events
+            )
+        pos += size
+    return trace
+
+
+def _varint(value: int, out: bytearray) -> None:
+    while value >= 0x80:
+        out.append((value & 0x7F) | 0x80)
+        value >>= 7
+    out.append(value)
+
+
+def _encode_chunks(events: List[Event], start_ns: int) -> Iterator[Tuple[int, bytes]]:
+    """Encode a thread's events; yields (base time, payload) per chunk."""
+    payload = bytearray()
+    base = last_time = events[0].time if events else 0
+    address = 0
+
+    def put_address(value: int) -> None:
+        nonlocal address
+        delta = (value - address + (1 << 63)) % (1 << 64) - (1 << 63)
+        address = value
+        _varint(((delta << 1) ^ (delta >> 63)) & 0xFFFFFFFFFFFFFFFF, payload)
+
+    for event in events:
+        if len(payload) > CHUNK_BYTES - 64:
+            yield base + start_ns, bytes(payload)
+            payload = bytearray()
+            base = last_time
+            address = 0
+        op_byte = event.op
+        if event.op == ALIGNED:
+            op_byte |= (max(event.alignment, 1).bit_length() - 1) << 3
+        payload.append(op_byte)
+        _varint(event.time - last_time, payload)
+        last_time = event.time
+        if event.op == FREE:
+            put_address(event.address)
+        elif event.op == REALLOC:
+            put_address(event.address)
+            _varint(event.size, payload)
+            put_address(event.moved)
+        else:
+            _varint(event.size, payload)
+            put_address(event.address)
+    if payload:
+        yield base + start_ns, bytes(payload)
+
+
+def write_trace(trace: Trace, path: Union[str, Path]) -> None:
+    """
+    Write a trace; compressed with gzip or xz for a .gz or .xz path.
+
+    Chunks are ordered by time, so the threads' events stay interleaved
+    roughly as they happened.
+
+    Raises:
+        TraceError: If the file cannot be written
+    """
+    path = Path(path)
+    chunks = []
+    for thread, events in trace.threads.items():
+        for base, payload in _encode_chunks(events, trace.start_ns):
+            chunks.append((base, thread, payload))
+    chunks.sort(key=lambda c: (c[0], c[1]))
+    try:
+        with _open(path, "wb") as f:
+            f.write(_HEADER.pack(MAGIC, VERSION, trace.start_ns, 1.0, 0))
+            for base, thread, payload in chunks:
+                f.write(_CHUNK.pack(thread, len(payload), base))
+                f.write(payload)
+    except OSError as e:
+        raise TraceError(f"Cannot write {path}: {e}") from e
+
+
+def _keyed(thread: int, events: List[Event]) -> Iterator[Tuple[tuple, int, Event]]:
+    for event in events:
+        yield (event.time, event.op != FREE, thread), thread, event
+
+
+def merged_events(trace: Trace) -> Iterator[Tuple[int, Event]]:
+    """Yield (thread, event) for all threads in time order, frees first."""
+    streams = [_keyed(thread, events) for thread, events in trace.threads.items()]
+    for _, thread, event in heapq.merge(*streams, key=lambda item: item[0]):
+        yield thread, event
+
+
+class _Heap:
+    """Blocks allocated at each point of the merged event order."""
+
+    def __init__(self):
+        self.live: Dict[int, Tuple[int, int, Event]] = {}  # address -> size, thread
+        self.live_bytes = 0
+        self.unmatched_frees = 0
+        self.reordered = 0
+        self.cross_thread_frees = 0
+
+    def allocate(self, thread: int, address: int, size: int, event: Event) -> None:
+        if address in self.live:
+            self.reordered += 1
+            self.release(thread, address)
+        self.live[address] = (size, thread, event)
+        self.live_bytes += size
+
+    def release(self, thread: int, address: int) -> bool:
+        block = self.live.pop(address, None)
+        if block is None:
+            self.unmatched_frees += 1
+            return False
+        self.live_bytes -= block[0]
+        if block[1] != thread:
+            self.cross_thread_frees += 1
+        return True
+
+    def apply(self, thread: int, event: Event) -> None:
+        if event.op == FREE:
+            self.release(thread, event.address)
+        elif event.op == REALLOC:
+            if event.moved == 0 and event.size != 0:
+                return  # Failed; the block is unchanged
+            if event.address in self.live:
+                self.live_bytes -= self.live.pop(event.address)[0]
+            if event.moved != 0:
+                self.allocate(thread, event.moved, event.size, event)
+        else:
+            self.allocate(thread, event.address, event.size, event)
+
+
+@dataclass
+class TraceSummary:
+    """What a trace contains."""
+
+    threads: int = 0
+    events: int = 0
+    duration_s: float = 0.0
+    calls: Dict[str, int] = field(default_factory=dict)  # Per op
+    allocated_bytes: int = 0
+    peak_live_bytes: int = 0
+    peak_time_s: float = 0.0
+    live_blocks_at_end: int = 0
+    live_bytes_at_end: int = 0
+    cross_thread_frees: int = 0
+    unmatched_frees: int = 0
+    reordered: int = 0
+    size_classes: Dict[int, int] = field(default_factory=dict)  # Max size -> count
+
+    def to_dict(self) -> Dict[str, Any]:
+        return asdict(self)
+
+
+def _size_class(size: int) -> int:
+    """Smallest power of two >= size, at least 8."""
+    return max(8, 1 << max(size - 1, 0).bit_length())
+
+
+def summarize(trace: Trace) -> TraceSummary:
+    """Count calls and sizes and follow the live heap through the trace."""
+    summary = TraceSummary(
+        threads=len(trace.threads),
+        events=trace.event_count,
+        duration_s=trace.duration_ns / 1e9,
+    )
+    heap = _Heap()
+    classes: Dict[int, int] = {}
+    for thread, event in merged_events(trace):
+        name = OP_NAMES[event.op]
+        summary.calls[name] = summary.calls.get(name, 0) + 1
+        heap.apply(thread, event)
+        if event.op != FREE and (event.op != REALLOC or event.moved):
+            summary.allocated_bytes += event.size
+            size_class = _size_class(event.size)
+            classes[size_class] = classes.get(size_class, 0) + 1
+        if heap.live_bytes > summary.peak_live_bytes:
+            summary.peak_live_bytes = heap.live_bytes
+            summary.peak_time_s = event.time / 1e9
+    summary.live_blocks_at_end = len(heap.live)
+    summary.live_bytes_at_end = heap.live_bytes
+    summary.cross_thread_frees = heap.cross_thread_frees
+    summary.unmatched_frees = heap.unmatched_frees
+    summary.reordered = heap.reordered
+    summary.size_classes = dict(sorted(classes.items()))
+    return summary
+
+
+def trim_trace(
+    trace: Trace,
+    start: Optional[float] = None,
+    end: Optional[float] = None,
+    keep_live: bool = True,
+) -> Trace:
+    """
+    Cut a trace to a time window.
+
+    Args:
+        trace: Trace to cut
+        start: Window start, seconds since the trace started (default: 0)
+        end: Window end, seconds (default: the end of the trace)
+        keep_live: Start the window with an allocation of every block that
+            is allocated at its start, on the thread that allocated it, so
+            a replay begins from the same heap
+
+    Returns:
+        New trace whose times start at the window
+    """
+    start_ns = int((start or 0) * 1e9)
+    end_ns = int(end * 1e9) if end is not None else None
+    result = Trace(start_ns=trace.start_ns + start_ns)
+    heap = _Heap()
+    opened = False
+
+    def add(thread: int, event: Event) -> None:
+        result.threads.setdefault(thread, []).append(event)
+
+    for thread, event in merged_events(trace):
+        if end_ns is not None and event.time >= end_ns:
+            break
+        if event.time < start_ns:
+            if keep_live:
+                heap.apply(thread, event)
+            continue
+        if not opened:
+            opened = True
+            for size, owner, allocation in heap.live.values():
+                add(
+                    owner,
+                    allocation._replace(
+                        time=0,
+                        op=allocation.op if allocation.op != REALLOC else MALLOC,
+                        address=allocation.moved or allocation.address,
+                        size=size,
+                        moved=0,
+                    ),
+                )
+        add(thread, event._replace(time=event.time - start_ns))
+    return result
+
+
+def format_summary(summary: TraceSummary) -> str:
+    """Format a summary as text."""
+    calls = ", ".join(f"{count:,} {name}" for name, count in summary.calls.items())
+    peak = _bytes(summary.peak_live_bytes)
+    live = _bytes(summary.live_bytes_at_end)
+    duration = f"{summary.duration_s:.3f} s"
+    lines = [
+        f"{summary.events:,} events in {summary.threads} thread(s) over {duration}",
+        f"  Calls: {calls or 'none'}",
+        f"  Allocated: {_bytes(summary.allocated_bytes)}",
+        f"  Peak live: {peak} at {summary.peak_time_s:.3f} s",
+        f"  Live at end: {live} in {summary.live_blocks_at_end:,} block(s)",
+        f"  Cross-thread frees: {summary.cross_thread_frees:,}",
+    ]
+    if summary.unmatched_frees or summary.reordered:
+        lines.append(
+            f"  Unmatched frees: {summary.unmatched_frees:,}, "
+            f"reordered: {summary.reordered:,}"
+        )
+    if summary.size_classes:
+        total = sum(summary.size_classes.values())
+        lines.append("  Allocation sizes:")
+        for max_size, count in summary.size_classes.items():
+            lines.append(
+                f"    <= {_bytes(max_size):>10}  {count:>12,}  {count / total:6.1%}"
+            )
+    return "\n".join(lines)
+
+
+def _bytes(count: int) -> str:
+    for unit in ("B", "KiB", "MiB", "GiB"):
+        if count < 1024 or unit == "GiB":
+            return f"{count} {unit}" if unit == "B" else f"{count:.1f} {unit}"
+        count /= 1024
+    return f"{count} B"
@@ -0,0 +1,655 @@
+"""
+Optimization remark aggregation.
+
+Reads the optimization records written by the ``profiling/opt-remarks``
+layer and reports missed vectorizations and inlining failures, hottest
+first:
+
+- Clang ``-fsave-optimization-record``: ``<object>.opt.yaml`` (YAML
+  remarks) or ``<object>.opt.bitstream``, which is converted with
+  ``llvm-remarkutil bitstream2yaml`` when that tool is on PATH
+- GCC ``-fsave-optimization-record``: ``<source>.opt-record.json.gz``
+
+Remarks for the same source location (e.g. an inline function in a header
+compiled by many translation units) are merged into one finding. The
+analysis remarks the compiler emits next to a missed remark ("could not
+determine number of loop iterations") are attached as its reasons.
+
+Hotness comes from a perf profile when one is given: every finding is
+ranked by the share of samples in its function. Without a profile the
+compiler's own hotness is used, which exists only for builds with profile
+feedback (Clang ``Hotness``, GCC counts of precise/adjusted/afdo quality).
+"""
+
+import gzip
+import json
+import logging
+import os
+import re
+import shutil
+import subprocess
+from dataclasses import asdict, dataclass, field
+from pathlib import Path
+from typing import Any, Dict, Iterable, List, Optional, Tuple
+
+import yaml
+
+logger = logging.getLogger(__name__)
+
+CATEGORIES = ("vectorization", "inlining")
+
+# Pass names (Clang and GCC) per report category
+VECTORIZATION_PASSES = {"loop-vectorize", "slp-vectorizer", "vect", "slp"}
+INLINING_PASSES = {"inline", "always-inline", "einline"}
+
+# GCC count qualities that come from a real profile
+GCC_PROFILE_QUALITIES = {"precise", "adjusted", "afdo"}
+
+RECORD_SUFFIXES = (
+    ".opt.yaml",
+    ".opt.bitstream",
+    ".opt-record.json.gz",
+    ".opt-record.json",
+)
+
+# Summary remarks that head a finding; the vectorizer's other missed
+# remarks at the same loop say why
+SUMMARY_MESSAGES = {"loop not vectorized", "couldn't vectorize loop"}
+
+_CLANG_DOCUMENT = re.compile(r"^--- !(\w+)\s*$", re.MULTILINE)
+_CLANG_PASS = re.compile(r"^Pass:\s*'?([\w.-]+)", re.MULTILINE)
+_PERF_LINE = re.compile(r"^\s*([\d.]+)%\s+(?:\S+\s+)*?\[.\]\s+(.+?)\s*$")
+
+
+class RemarksError(Exception):
+    """Raised when records or a profile cannot be read."""
+
+
+@dataclass
+class Remark:
+    """One optimization remark."""
+
+    kind: str  # missed, passed, analysis, note
+    pass_name: str
+    file: str
+    line: int
+    column: int
+    function: str
+    message: str
+    hotness: Optional[float] = None
+
+    @property
+    def category(self) -> Optional[str]:
+        if self.pass_name in VECTORIZATION_PASSES:
+            return "vectorization"
+        if self.pass_name in INLINING_PASSES:
+            return "inlining"
+        return None
+
+
+@dataclass
+class Finding:
+    """A missed optimization at one source location."""
+
+    category: str
+    file: str
+    line: int
+    column: int
+    function: str
+    message: str
+    reasons: List[str] = field(default_factory=list)
+    count: int = 1
+    hotness: Optional[float] = None
+    hotness_source: Optional[str] = None  # "profile" or "compiler"
+
+    @property
+    def location(self) -> str:
+        return f"{self.file}:{self.line}:{self.column}" if self.file else "?"
+
+    def to_dict(self) -> Dict[str, Any]:
+        return asdict(self)
+
+
+# ----------------------------------------------------------------------
+# Record files
+
+
+def find_record_files(build_dir: Path) -> List[Path]:
+    """Find optimization record files under a build directory."""
+    files = []
+    for root, _, names in os.walk(build_dir):
+        for name in names:
+            if name.endswith(RECORD_SUFFIXES):
+                files.append(Path(root) / name)
+    return sorted(files)
+
+
+def _clang_arg_text(arg: Dict[str, Any]) -> str:
+    return "".join(str(v) for k, v in arg.items() if k != "DebugLoc")
+
+
+def parse_clang_yaml(text: str, passes: Optional[Iterable[str]] = None) -> List[Remark]:
+    """
+    Parse Clang/LLVM YAML remarks.
+
+    Each remark is a YAML document tagged with its kind (``--- !Missed``).
+    Documents are split on the tag lines and parsed without the tag, so
+    that unknown kinds do not need YAML constructors.
+
+    Args:
+        text: Contents of an .opt.yaml file
+        passes: Only keep remarks of these passes (default: all)
+
+    Returns:
+        Remarks in file order
+    """
+    wanted = set(passes) if passes is not None else None
+    matches = list(_CLANG_DOCUMENT.finditer(text))
+    remarks = []
+    for i, match in enumerate(matches):
+        end = matches[i + 1].start() if i + 1 < len(matches) else len(text)
+        body = text[match.end() : end]
+        # Cheap pass filter before paying for the YAML parser
+        pass_match = _CLANG_PASS.search(body)
+        if wanted is not None and (not pass_match or pass_match.group(1) not in wanted):
+            continue
+        body = body.rsplit("\n...", 1)[0]
+        try:
+            data = yaml.load(body, Loader=getattr(yaml, "CSafeLoader", yaml.SafeLoader))
+        except yaml.YAMLError as e:
+            logger.debug(f"Skipping malformed remark: {e}")
+            continue
+        if not isinstance(data, dict):
+            continue
+        tag = match.group(1)
+        kind = "missed" if tag in ("Missed", "Failure") else tag.lower()
+        if kind.startswith("analysis"):
+            kind = "analysis"
+        loc = data.get("DebugLoc") or {}
+        hotness = data.get("Hotness")
+        remarks.append(
+            Remark(
+                kind=kind,
+                pass_name=str(data.get("Pass", "")),
+                file=str(loc.get("File", "")),
+                line=int(loc.get("Line", 0)),
+                column=int(loc.get("Column", 0)),
+                function=str(data.get("Function", "")),
+                message="".join(
+                    _clang_arg_text(arg)
+                    for arg in data.get("Args") or []
+                    if isinstance(arg, dict)
+                ).strip(),
+                hotness=float(hotness) if hotness is not None else None,
+            )
+        )
+    return remarks
+
+
+def _gcc_message(parts: List[Any]) -> str:
+    text = []
+    for part in parts:
+        if isinstance(part, str):
+            text.append(part)
+        elif isinstance(part, dict):
+            if "symtab_node" in part:
+                # Drop the symbol table order ("heavy(float)/158")
+                text.append(re.sub(r"/\d+$", "", str(part["symtab_node"])))
+            elif "expr" in part or "stmt" in part:
+                text.append(str(part.get("expr", part.get("stmt"))).strip())
+    # GCC appends pass statistics after the first line
+    lines = [line.strip() for line in "".join(text).splitlines()]
+    return next((line for line in lines if line), "")
+
+
+def parse_gcc_json(
+    data: List[Any], passes: Optional[Iterable[str]] = None
+) -> List[Remark]:
+    """
+    Parse a GCC optimization record (``[metadata, passes, records]``).
+
+    Args:
+        data: Decoded JSON of an .opt-record.json(.gz) file
+        passes: Only keep remarks of these passes (default: all)
+
+    Returns:
+        Remarks in file order, nested scopes flattened
+    """
+    if not isinstance(data, list) or len(data) != 3:
+        raise RemarksError("not a GCC optimization record")
+    wanted = set(passes) if passes is not None else None
+
+    pass_names: Dict[str, str] = {}
+    stack = list(data[1])
+    while stack:
+        entry = stack.pop()
+        pass_names[entry.get("id", "")] = entry.get("name", "")
+        stack.extend(entry.get("children", []))
+
+    # GCC's "note" and "scope" records are dump-file detail, not reasons
+    kinds = {"failure": "missed", "success": "passed"}
+    remarks = []
+    stack = list(reversed(data[2]))
+    while stack:
+        record = stack.pop()
+        stack.extend(reversed(record.get("children", [])))
+        pass_name = pass_names.get(record.get("pass", ""), "")
+        if wanted is not None and pass_name not in wanted:
+            continue
+        loc = record.get("location") or {}
+        count = record.get("count") or {}
+        hotness = None
+        if count.get("quality") in GCC_PROFILE_QUALITIES:
+            hotness = float(count.get("value", 0))
+        function = record.get("function", "")
+        if not function and record.get("inlining_chain"):
+            function = record["inlining_chain"][0].get("fndecl", "")
+        remarks.append(
+            Remark(
+                kind=kinds.get(record.get("kind"), "note"),
+                pass_name=pass_name,
+                file=str(loc.get("file", "")),
+                line=int(loc.get("line", 0)),
+                column=int(loc.get("column", 0)),
+                function=function,
+                message=_gcc_message(record.get("message", [])),
+                hotness=hotness,
+            )
+        )
+    return remarks
+
+
+def load_record_file(
+    path: Path, passes: Optional[Iterable[str]] = None
+) -> List[Remark]:
+    """
+    Parse one record file of any supported format.
+
+    Raises:
+        RemarksError: If the file cannot be read or parsed
+    """
+    name = path.name
+    try:
+        if name.endswith(".opt.yaml"):
+            return parse_clang_yaml(path.read_text(errors="replace"), passes)
+        if name.endswith(".opt.bitstream"):
+            return parse_clang_yaml(_bitstream_to_yaml(path), passes)
+        opener = gzip.open if name.endswith(".gz") else open
+        with opener(path, "rt") as f:
+            return parse_gcc_json(json.load(f), passes)
+    except (OSError, ValueError, EOFError) as e:
+        raise RemarksError(f"{path}: {e}") from e
+
+
+def _bitstream_to_yaml(path: Path) -> str:
+    tool = shutil.which("llvm-remarkutil")
+    if tool is None:
+        raise RemarksError(
+            f"{path}: bitstream remarks need llvm-remarkutil on PATH "
+            "(or build with -fsave-optimization-record=yaml)"
+        )
+    result = subprocess.run(
+        [tool, "bitstream2yaml", str(path), "-o", "-"],
+        capture_output=True,
+        text=True,
+        check=False,
+    )
+    if result.returncode != 0:
+        raise RemarksError(f"{path}: {result.stderr.strip()}")
+    return result.stdout
+
+
+# ----------------------------------------------------------------------
+# Aggregation
+
+
+def aggregate(remarks: Iterable[Remark]) -> List[Finding]:
+    """
+    Merge missed remarks into findings.
+
+    Missed remarks are grouped by category, file, line and function. A
+    summary remark ("loop not vectorized") or else the first message
+    becomes the finding's message; the other missed and analysis messages
+    at that line become its reasons. The count is the number of times the
+    message was seen (once per translation unit and per loop version).
+    Compiler hotness is the maximum seen.
+
+    Lines where a loop was vectorized have no vectorization finding: the
+    remaining missed remarks there are about versions of the loop that
+    were not needed.
+    """
+    findings: Dict[Tuple[str, str, int, str], Finding] = {}
+    analysis: Dict[Tuple[str, int, str], List[str]] = {}
+    vectorized = set()
+
+    for remark in remarks:
+        category = remark.category
+        if category is None:
+            continue
+        if remark.kind == "passed" and category == "vectorization":
+            vectorized.add((category, remark.file, remark.line, remark.function))
+            continue
+        if remark.kind == "analysis":
+            analysis.setdefault((remark.file, remark.line, remark.function), []).append(
+                remark.message
+            )
+            continue
+        if remark.kind != "missed" or not remark.message:
+            continue
+        key = (category, remark.file, remark.line, remark.function)
+        finding = findings.get(key)
+        if finding is None:
+            findings[key] = Finding(
+                category=category,
+                file=remark.file,
+                line=remark.line,
+                column=remark.column,
+                function=remark.function,
+                message=remark.message,
+                count=0,
+            )
+            finding = findings[key]
+        if remark.message == finding.message:
+            finding.count += 1
+        elif (
+            remark.message in SUMMARY_MESSAGES
+            and finding.message not in SUMMARY_MESSAGES
+        ):
+            finding.reasons.insert(0, finding.message)
+            finding.message = remark.message
+            finding.column = remark.column
+            finding.count = 1
+        elif remark.message not in finding.reasons:
+            finding.reasons.append(remark.message)
+        if remark.hotness is not None:
+            finding.hotness = max(finding.hotness or 0.0, remark.hotness)
+            finding.hotness_source = "compiler"
+
+    for key in vectorized:
+        findings.pop(key, None)
+    for (_, file, line, function), finding in findings.items():
+        for message in analysis.get((file, line, function), []):
+            if (
+                message
+                and message != finding.message
+                and message not in finding.reasons
+            ):
+                finding.reasons.append(message)
+    return list(findings.values())
+
+
+def rank(findings: List[Finding]) -> List[Finding]:
+    """Sort findings by hotness (unknown last), then by count."""
+    return sorted(
+        findings,
+        key=lambda f: (f.hotness is not None, f.hotness or 0.0, f.count),
+        reverse=True,
+    )
+
+
+# ----------------------------------------------------------------------
+# Perf profiles
+
+
+def demangle(names: Iterable[str]) -> Dict[str, str]:
+    """
+    Demangle C++ symbol names with c++filt.
+
+    Returns:
+        Mapping of each name to its demangled form (the name itself when
+        c++filt is missing or the name is not mangled)
+    """
+    names = sorted(set(names))
+    tool = shutil.which("c++filt")
+    mangled = [n for n in names if n.startswith("_Z")]
+    result = {n: n for n in names}
+    if tool is None or not mangled:
+        return result
+    try:
+        out = subprocess.run(
+            [tool],
+            input="\n".join(mangled) + "\n",
+            capture_output=True,
+            text=True,
+            check=False,
+        ).stdout.splitlines()
+    except OSError:
+        return result
+    if len(out) == len(mangled):
+        result.update(zip(mangled, out))
+    return result
+
+
+def base_name(function: str) -> str:
+    """
+    Qualified function name without return type and parameters.
+
+    ``float ns::scale(float*, int) const`` becomes ``ns::scale``.
+    """
+    depth = 0
+    end = len(function)
+    for i, ch in enumerate(function):
+        if ch == "<":
+            depth += 1
+        elif ch == ">":
+            depth -= 1
+        elif ch == "(" and depth == 0 and i > 0:
+            end = i
+            break
+    head = function[:end]
+    # Drop the return type: the last space outside template brackets
+    depth = 0
+    for i in range(len(head) - 1, -1, -1):
+        ch = head[i]
+        if ch == ">":
+            depth += 1
+        elif ch == "<":
+            depth -= 1
+        elif ch == " " and depth == 0:
+            return head[i + 1 :]
+    return head
+
+
+def parse_perf_report(text: str) -> Dict[str, float]:
+    """
+    Parse ``perf report --stdio`` output into sample share per symbol.
+
+    Lines look like ``45.20%  bench  bench  [.] _Z5heavyf``; the dso and
+    command columns are optional. Kernel symbols (``[k]``) are kept; they
+    never match a remark.
+
+    Returns:
+        Percentage of samples per symbol (summed over DSOs)
+    """
+    profile: Dict[str, float] = {}
+    for line in text.splitlines():
+        if line.startswith("#"):
+            continue
+        match = _PERF_LINE.match(line)
+        if match:
+            symbol = match.group(2)
+            profile[symbol] = profile.get(symbol, 0.0) + float(match.group(1))
+    return profile
+
+
+def load_profile(path: Path) -> Dict[str, float]:
+    """
+    Load a perf profile: a perf.data file or saved ``perf report --stdio``.
+
+    Raises:
+        RemarksError: If the file cannot be read or perf is not available
+    """
+    try:
+        with open(path, "rb") as f:
+            magic = f.read(8)
+    except OSError as e:
+        raise RemarksError(f"Cannot read profile {path}: {e}") from e
+
+    if magic != b"PERFILE2":
+        return parse_perf_report(Path(path).read_text(errors="replace"))
+
+    perf = shutil.which("perf")
+    if perf is None:
+        raise RemarksError(
+            f"{path} is a perf.data file but perf is not on PATH; "
+            "pass the output of 'perf report --stdio' instead"
+        )
+    result = subprocess.run(
+        [
+            perf,
+            "report",
+            "-i",
+            str(path),
+            "--stdio",
+            "--no-children",
+            "--sort",
+            "symbol",
+            "--no-demangle",
+            "-q",
+        ],
+        capture_output=True,
+        text=True,
+        check=False,
+    )
+    if result.returncode != 0:
+        raise RemarksError(f"perf report failed: {result.stderr.strip()}")
+    return parse_perf_report(result.stdout)
+
+
+def apply_profile(findings: List[Finding], profile: Dict[str, float]) -> None:
+    """
+    Set each finding's hotness to its function's share of samples.
+
+    Functions are matched by symbol, demangled name or base name, so
+    mangled (Clang, GCC) and demangled (GCC inlining) remark names both
+    match mangled or demangled profiles. Findings whose function is not in
+    the profile keep no hotness.
+    """
+    demangled = demangle(list(profile) + [f.function for f in findings])
+    by_name: Dict[str, float] = {}
+    for symbol, share in profile.items():
+        full = demangled.get(symbol, symbol)
+        for name in (symbol, full, base_name(full)):
+            by_name[name] = max(by_name.get(name, 0.0), share)
+
+    for finding in findings:
+        full = demangled.get(finding.function, finding.function)
+        finding.hotness = None
+        finding.hotness_source = None
+        for name in (finding.function, full, base_name(full)):
+            if name in by_name:
+                finding.hotness = by_name[name]
+                finding.hotness_source = "profile"
+                break
+
+
+# ----------------------------------------------------------------------
+# Report
+
+
+@dataclass
+class Report:
+    """Ranked findings of a build."""
+
+    findings: List[Finding]
+    record_files: int
+    errors: List[str] = field(default_factory=list)
+    profile: Optional[str] = None
+
+    def to_dict(self) -> Dict[str, Any]:
+        return {
+            "record_files": self.record_files,
+            "profile": self.profile,
+            "errors": self.errors,
+            "findings": [f.to_dict() for f in self.findings],
+        }
+
+
+def collect(
+    build_dir: Path,
+    profile: Optional[Path] = None,
+    categories: Iterable[str] = CATEGORIES,
+) -> Report:
+    """
+    Aggregate the optimization records of a build.
+
+    Args:
+        build_dir: Build directory to search for record files
+        profile: Optional perf.data or ``perf report --stdio`` output
+        categories: Report categories to include
+
+    Returns:
+        Report with findings ranked hottest first; unreadable record files
+        are listed in ``errors``
+
+    Raises:
+        RemarksError: If the profile cannot be loaded
+    """
+    categories = set(categories)
+    passes = set()
+    if "vectorization" in categories:
+        passes |= VECTORIZATION_PASSES
+    if "inlining" in categories:
+        passes |= INLINING_PASSES
+
+    files = find_record_files(Path(build_dir))
+    remarks: List[Remark] = []
+    errors = []
+    for path in files:
+        try:
+            remarks.extend(load_record_file(path, passes))
+        except RemarksError as e:
+            logger.warning(str(e))
+            errors.append(str(e))
+
+    findings = aggregate(remarks)
+    if profile is not None:
+        apply_profile(findings, load_profile(Path(profile)))
+
+    names = demangle(f.function for f in findings)
+    for finding in findings:
+        finding.function = names.get(finding.function, finding.function)
+
+    return Report(
+        findings=rank(findings),
+        record_files=len(files),
+        errors=errors,
+        profile=str(profile) if profile is not None else None,
+    )
+
+
+def format_report(report: Report, limit: Optional[int] = None) -> str:
+    """Format a report as text, hottest findings first."""
+    findings = report.findings[:limit] if limit else report.findings
+    per_category = {
+        c: sum(1 for f in report.findings if f.category == c) for c in CATEGORIES
+    }
+    summary = ", ".join(f"{n} {c}" for c, n in per_category.items() if n)
+    lines = [
+        (
+            f"{len(report.findings)} missed optimization(s) "
+            f"({summary or 'none'}) in {report.record_files} record file(s)"
+        )
+    ]
+    if report.profile:
+        lines.append(f"Hotness: share of samples per function in {report.profile}")
+    if len(findings) < len(report.findings):
+        lines.append(f"Showing the {len(findings)} hottest")
+
+    for i, finding in enumerate(findings, 1):
+        if finding.hotness is None:
+            hotness = "-"
+        elif finding.hotness_source == "profile":
+            hotness = f"{finding.hotness:.2f}%"
+        else:
+            hotness = f"{finding.hotness:g}"
+        seen = f" (x{finding.count})" if finding.count > 1 else ""
+        lines.append("")
+        lines.append(
+            f"{i:>3}. [{hotness}] {finding.category}  {finding.location}"
+            f"  in {finding.function or '?'}{seen}"
+        )
+        lines.append(f"     {finding.message}")
+        for reason in finding.reasons:
+            lines.append(f"       - {reason}")
+    return "\n".join(lines)
@@ -0,0 +1,305 @@
+"""
+Startup time measurement.
+
+Times how long a program takes from exec to exit, over many runs, and
+reads the dynamic loader's own statistics (glibc ``LD_DEBUG=statistics``):
+cycles spent in the loader, in relocation and in loading objects, and the
+number of relocations processed at startup and by exit (the difference is
+lazy binding).
+
+Two commands can be measured A/B: their runs are interleaved so that
+frequency scaling and background load affect both alike.
+
+Example:
+    >>> from toolchainkit.profiling.startup import compare_startup, format_results
+    >>> results = compare_startup(["./build-lazy/tool", "--version"],
+    ...                           ["./build-now/tool", "--version"])
+    >>> print(format_results(results))
+"""
+
+import os
+import re
+import statistics
+import subprocess
+import sys
+import tempfile
+import time
+from dataclasses import asdict, dataclass, field
+from pathlib import Path
+from typing import Any, Dict, List, Optional, Sequence
+
+DEFAULT_RUNS = 50
+DEFAULT_WARMUP = 3
+
+_STAT_LINE = re.compile(r"^\s*\d+:\s*(.+?):\s*(\d+)")
+
+# LD_DEBUG=statistics labels -> LoaderStats fields
+_STAT_FIELDS = {
+    "total startup time in dynamic loader": "startup_cycles",
+    "time needed for relocation": "relocation_cycles",
+    "time needed to load objects": "load_cycles",
+    "number of relocations": "relocations",
+    "number of relocations from cache": "relocations_from_cache",
+    "number of relative relocations": "relative_relocations",
+    "final number of relocations": "final_relocations",
+}
+
+
+class StartupError(Exception):
+    """Raised when a command cannot be run."""
+
+
+@dataclass
+class LoaderStats:
+    """Dynamic loader statistics of one run (glibc LD_DEBUG=statistics)."""
+
+    startup_cycles: int = 0
+    relocation_cycles: int = 0
+    load_cycles: int = 0
+    relocations: int = 0
+    relocations_from_cache: int = 0
+    relative_relocations: int = 0
+    final_relocations: Optional[int] = None  # Including lazy binding
+
+    @property
+    def lazy_relocations(self) -> Optional[int]:
+        """Relocations resolved after startup (lazy binding)."""
+        if self.final_relocations is None:
+            return None
+        return self.final_relocations - self.relocations
+
+
+@dataclass
+class StartupResult:
+    """Exec-to-exit times of one command, in seconds."""
+
+    command: List[str]
+    samples: List[float] = field(default_factory=list)
+    loader: Optional[LoaderStats] = None
+
+    @property
+    def median(self) -> float:
+        return statistics.median(self.samples)
+
+    @property
+    def minimum(self) -> float:
+        return min(self.samples)
+
+    @property
+    def p90(self) -> float:
+        ordered = sorted(self.samples)
+        return ordered[min(len(ordered) - 1, int(len(ordered) * 0.9))]
+
+    def to_dict(self) -> Dict[str, Any]:
+        return {
+            "command": self.command,
+            "samples": self.samples,
+            "median": self.median,
+            "min": self.minimum,
+            "p90": self.p90,
+            "loader": asdict(self.loader) if self.loader else None,
+        }
+
+
+def parse_ld_debug_statistics(text: str) -> Optional[LoaderStats]:
+    """
+    Parse the output of ``LD_DEBUG=statistics``.
+
+    The loader prints one block at startup and, on exit, the final
+    relocation counts. Lines are prefixed with the process id.
+
+    Returns:
+        LoaderStats, or None if the text has no statistics
+    """
+    stats = LoaderStats()
+    found = False
+    for line in text.splitlines():
+        match = _STAT_LINE.match(line)
+        if not match:
+            continue
+        name = _STAT_FIELDS.get(match.group(1).strip())
+        if name is None:
+            continue
+        setattr(stats, name, int(match.group(2)))
+        found = True
+    return stats if found else None
+
+
+def _spawn_and_wait(command: Sequence[str], env: Optional[Dict[str, str]]) -> float:
+    """Run command once with output discarded; return wall time."""
+    if hasattr(os, "posix_spawn"):
+        devnull = [
+            (os.POSIX_SPAWN_OPEN, 1, os.devnull, os.O_WRONLY, 0),
+            (os.POSIX_SPAWN_OPEN, 2, os.devnull, os.O_WRONLY, 0),
+        ]
+        start = time.perf_counter()
+        try:
+            pid = os.posix_spawn(
+                command[0],
+                list(command),
+                env if env is not None else os.environ,
+                file_actions=devnull,
+            )
+        except OSError as e:
+            raise StartupError(f"Cannot run {command[0]}: {e}") from e
+        _, status = os.waitpid(pid, 0)
+        elapsed = time.perf_counter() - start
+        code = os.waitstatus_to_exitcode(status)
+    else:
+        start = time.perf_counter()
+        try:
+            code = subprocess.call(
+                list(command),
+                env=env,
+                stdout=subprocess.DEVNULL,
+                stderr=subprocess.DEVNULL,
+            )
+        except OSError as e:
+            raise StartupError(f"Cannot run {command[0]}: {e}") from e
+        elapsed = time.perf_counter() - start
+    if code != 0:
+        raise StartupError(f"{' '.join(command)} exited with status {code}")
+    return elapsed
+
+
+def _resolve(command: Sequence[str]) -> List[str]:
+    if not command:
+        raise StartupError("No command given")
+    program = command[0]
+    if os.sep not in program:
+        from shutil import which
+
+        found = which(program)
+        if found is None:
+            raise StartupError(f"Command not found: {program}")
+        program = found
+    return [program, *command[1:]]
+
+
+def loader_statistics(
+    command: Sequence[str], env: Optional[Dict[str, str]] = None
+) -> Optional[LoaderStats]:
+    """
+    Run command once with ``LD_DEBUG=statistics``.
+
+    The statistics are written to a temporary file (LD_DEBUG_OUTPUT), not
+    mixed into the program's output.
+
+    Returns:
+        LoaderStats, or None where the loader does not support it (static
+        binaries, non-glibc systems)
+    """
+    if not sys.platform.startswith("linux"):
+        return None
+    command = _resolve(command)
+    with tempfile.TemporaryDirectory(prefix="tk-startup-") as tmp:
+        run_env = dict(env if env is not None else os.environ)
+        run_env["LD_DEBUG"] = "statistics"
+        run_env["LD_DEBUG_OUTPUT"] = str(Path(tmp) / "ld")
+        _spawn_and_wait(command, run_env)
+        # One file per process: ld.<pid>; the first is the command itself
+        files = sorted(Path(tmp).glob("ld.*"), key=lambda p: int(p.suffix[1:]))
+        if not files:
+            return None
+        return parse_ld_debug_statistics(files[0].read_text(errors="replace"))
+
+
+def measure_startup(
+    command: Sequence[str],
+    runs: int = DEFAULT_RUNS,
+    warmup: int = DEFAULT_WARMUP,
+    env: Optional[Dict[str, str]] = None,
+) -> StartupResult:
+    """
+    Time a command from exec to exit.
+
+    Args:
+        command: Program and arguments; the program must exit with status 0
+        runs: Timed runs
+        warmup: Untimed runs first (page cache, dynamic loader cache)
+        env: Environment (default: the current one)
+
+    Returns:
+        StartupResult with one sample per run and loader statistics
+
+    Raises:
+        StartupError: If the command cannot be run or fails
+    """
+    return compare_startup(command, runs=runs, warmup=warmup, env=env)[0]
+
+
+def compare_startup(
+    *commands: Sequence[str],
+    runs: int = DEFAULT_RUNS,
+    warmup: int = DEFAULT_WARMUP,
+    env: Optional[Dict[str, str]] = None,
+) -> List[StartupResult]:
+    """
+    Time several commands with interleaved runs (A, B, A, B, ...).
+
+    Args:
+        commands: Commands to compare, the first being the baseline
+        runs: Timed runs per command
+        warmup: Untimed runs per command first
+        env: Environment (default: the current one)
+
+    Returns:
+        One StartupResult per command, in order
+
+    Raises:
+        StartupError: If a command cannot be run or fails
+    """
+    resolved = [_resolve(c) for c in commands]
+    results = [StartupResult(command=list(c)) for c in commands]
+    for _ in range(warmup):
+        for command in resolved:
+            _spawn_and_wait(command, env)
+    for _ in range(runs):
+        for command, result in zip(resolved, results):
+            result.samples.append(_spawn_and_wait(command, env))
+    for command, result in zip(resolved, results):
+        result.loader = loader_statistics(command, env)
+    return results
+
+
+def _ms(seconds: float) -> str:
+    return f"{seconds * 1000:.3f} ms"
+
+
+def format_results(results: List[StartupResult]) -> str:
+    """
+    Format results as a table; later results are compared to the first.
+    """
+    baseline = results[0]
+    columns = [" ".join(r.command) for r in results]
+    width = max(len(c) for c in columns + ["Command"])
+    lines = [
+        f"{'Command':<{width}}  {'Median':>10}  {'Min':>10}  {'p90':>10}  Change",
+    ]
+    for name, result in zip(columns, results):
+        change = ""
+        if result is not baseline and baseline.median:
+            change = f"{result.median / baseline.median - 1:+.1%}"
+        lines.append(
+            f"{name:<{width}}  {_ms(result.median):>10}  {_ms(result.minimum):>10}  "
+            f"{_ms(result.p90):>10}  {change}".rstrip()
+        )
+
+    if any(r.loader for r in results):
+        lines.append("")
+        lines.append("Dynamic loader (LD_DEBUG=statistics, one run):")
+        rows = [
+            ("startup cycles", "startup_cycles"),
+            ("relocation cycles", "relocation_cycles"),
+            ("load cycles", "load_cycles"),
+            ("relocations", "relocations"),
+            ("relative relocations", "relative_relocations"),
+            ("lazy relocations", "lazy_relocations"),
+        ]
+        for label, attr in rows:
+            values = []
+            for result in results:
+                value = getattr(result.loader, attr) if result.loader else None
+                values.append("-" if value is None else f"{value:,}")
+            lines.append(f"  {label:<22}" + "".join(f"{v:>14}" for v in values))
+    return "\n".join(lines)
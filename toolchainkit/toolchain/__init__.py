@@ -13,53 +13,59 @@ from toolchainkit.core.exceptions import (
     ToolchainMetadataNotFoundError,
     ToolchainRegistryError,
 )
-from toolchainkit.toolchain.downloader import (
-    ToolchainDownloader,
-    ToolchainDownloadError,
-    ToolchainExtractionError,
-    DownloadResult,
-    ProgressInfo,
-    download_toolchain,
-)
+from toolchainkit.core.lazy import lazy_exports
 
-from toolchainkit.toolchain.metadata_registry import (
-    ToolchainMetadata,
-    ToolchainMetadataRegistry,
-)
-from toolchainkit.toolchain.system_detector import (
-    SystemToolchainDetector,
-    SystemToolchain,
-    CompilerVersionExtractor,
-    PathSearcher,
-    StandardLocationSearcher,
-    RegistrySearcher,
-    PackageManagerSearcher,
-)
-
-from toolchainkit.toolchain.upgrader import (
-    ToolchainUpgrader,
-    UpdateCheckError,
-    UpdateInfo,
-    UpgradeError,
-    UpgradeResult,
-    Version,
-    VersionComparisonError,
-    check_toolchainkit_updates,
-    upgrade_toolchainkit,
-)
-from toolchainkit.toolchain.verifier import (
-    ABICheck,
-    CheckResult,
-    CompileTestCheck,
-    ExecutabilityCheck,
-    FilePresenceCheck,
-    SymlinkCheck,
-    ToolchainSpec,
-    ToolchainVerifier,
-    VerificationLevel,
-    VerificationResult,
-    VersionCheck,
-    verify_toolchain,
+# Submodules are imported on first use of one of their names
+__getattr__, __dir__ = lazy_exports(
+    __name__,
+    {
+        ".downloader": [
+            "ToolchainDownloader",
+            "ToolchainDownloadError",
+            "ToolchainExtractionError",
+            "DownloadResult",
+            "ProgressInfo",
+            "download_toolchain",
+        ],
+        ".metadata_registry": [
+            "ToolchainMetadata",
+            "ToolchainMetadataRegistry",
+        ],
+        ".system_detector": [
+            "SystemToolchainDetector",
+            "SystemToolchain",
+            "CompilerVersionExtractor",
+            "PathSearcher",
+            "StandardLocationSearcher",
+            "RegistrySearcher",
+            "PackageManagerSearcher",
+        ],
+        ".upgrader": [
+            "ToolchainUpgrader",
+            "UpdateCheckError",
+            "UpdateInfo",
+            "UpgradeError",
+            "UpgradeResult",
+            "Version",
+            "VersionComparisonError",
+            "check_toolchainkit_updates",
+            "upgrade_toolchainkit",
+        ],
+        ".verifier": [
+            "ABICheck",
+            "CheckResult",
+            "CompileTestCheck",
+            "ExecutabilityCheck",
+            "FilePresenceCheck",
+            "SymlinkCheck",
+            "ToolchainSpec",
+            "ToolchainVerifier",
+            "VerificationLevel",
+            "VerificationResult",
+            "VersionCheck",
+            "verify_toolchain",
+        ],
+    },
 )
 
 # For backward compatibility, export ToolchainNotFoundError as an alias
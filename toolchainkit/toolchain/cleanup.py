@@ -6,21 +6,154 @@ Toolchain cleanup with reference counting for safe removal.
 This module provides functionality to safely remove unused toolchains from the
 shared cache while tracking which projects reference them to prevent accidental
 deletion of toolchains that are still in use.
+
+The cache can also be bounded by a quota: when the sizes recorded in the
+registry exceed the high watermark, unreferenced toolchains, downloaded
+archives and sysroots are evicted least recently used first until usage is
+back under the low watermark. Installs call ``enforce_cache_quota()``;
+``tkgen configure`` records which toolchain each project uses, and
+toolchains locked by another process are skipped.
 """
 
 import os
+import threading
 from pathlib import Path
-from typing import List, Optional
+from typing import Any, Dict, Iterable, List, Optional, Union
 from dataclasses import dataclass, field
 from datetime import datetime, timedelta
 import logging
 
-from ..core.cache_registry import ToolchainCacheRegistry
-from ..core.filesystem import safe_rmtree
+from ..core.cache_registry import ToolchainCacheRegistry, _update_totals, entry_size
+from ..core.filesystem import directory_size, safe_rmtree
 from ..core.locking import LockManager
 
 logger = logging.getLogger(__name__)
 
+QUOTA_ENV = "TOOLCHAINKIT_CACHE_QUOTA"
+"""Environment variable with the cache quota (e.g. '50G')."""
+
+DEFAULT_HIGH_WATERMARK = 0.9
+DEFAULT_LOW_WATERMARK = 0.75
+
+
+@dataclass
+class CacheQuota:
+    """Size limit of the global cache."""
+
+    max_bytes: int
+    high_watermark: float = DEFAULT_HIGH_WATERMARK
+    """Eviction starts when usage exceeds this fraction of max_bytes."""
+
+    low_watermark: float = DEFAULT_LOW_WATERMARK
+    """Eviction stops once usage is at or below this fraction of max_bytes."""
+
+    def __post_init__(self):
+        if self.max_bytes <= 0:
+            raise ValueError(f"Cache quota must be positive: {self.max_bytes}")
+        if not 0 < self.low_watermark <= self.high_watermark <= 1:
+            raise ValueError(
+                "Cache quota watermarks must satisfy 0 < low <= high <= 1 "
+                f"(got low={self.low_watermark}, high={self.high_watermark})"
+            )
+
+    @property
+    def high_bytes(self) -> int:
+        return int(self.max_bytes * self.high_watermark)
+
+    @property
+    def low_bytes(self) -> int:
+        return int(self.max_bytes * self.low_watermark)
+
+    @classmethod
+    def parse(cls, value: Union[str, int, Dict[str, Any]]) -> "CacheQuota":
+        """
+        Build a quota from configuration.
+
+        Args:
+            value: Size ('50G', '500M', bytes) or a mapping with ``max_size``
+                and optional ``high_watermark`` / ``low_watermark``
+
+        Raises:
+            ValueError: If the value is malformed
+        """
+        from ..caching.server import parse_size
+
+        if isinstance(value, dict):
+            if "max_size" not in value:
+                raise ValueError("Cache quota needs 'max_size'")
+            return cls(
+                parse_size(value["max_size"]),
+                float(value.get("high_watermark", DEFAULT_HIGH_WATERMARK)),
+                float(value.get("low_watermark", DEFAULT_LOW_WATERMARK)),
+            )
+        return cls(parse_size(value))
+
+
+_quota: Optional[CacheQuota] = None
+_quota_lock = threading.Lock()
+
+
+def set_cache_quota(quota: Optional[CacheQuota]) -> None:
+    """
+    Set the cache quota for this process (overrides TOOLCHAINKIT_CACHE_QUOTA).
+
+    Args:
+        quota: Quota, or None to fall back to the environment
+    """
+    global _quota
+    with _quota_lock:
+        _quota = quota
+
+
+def get_cache_quota() -> Optional[CacheQuota]:
+    """
+    Get the configured cache quota.
+
+    Returns:
+        Quota from set_cache_quota(), else from TOOLCHAINKIT_CACHE_QUOTA,
+        else None (no limit)
+    """
+    with _quota_lock:
+        if _quota is not None:
+            return _quota
+    value = os.environ.get(QUOTA_ENV, "").strip()
+    if not value:
+        return None
+    try:
+        return CacheQuota.parse(value)
+    except ValueError as e:
+        logger.warning(f"Ignoring invalid {QUOTA_ENV}={value!r}: {e}")
+        return None
+
+
+def enforce_cache_quota(
+    cache_registry: ToolchainCacheRegistry, protect: Iterable[str] = ()
+) -> Optional["CleanupResult"]:
+    """
+    Evict least recently used cache entries if the cache is over quota.
+
+    Called after installs. Does nothing (and does not read the registry)
+    when no quota is configured; errors are logged, never raised.
+
+    Args:
+        cache_registry: Registry of the cache
+        protect: Toolchain IDs or artifact paths that must not be evicted
+            (e.g. what was just installed)
+
+    Returns:
+        CleanupResult if a quota is configured, else None
+    """
+    quota = get_cache_quota()
+    if quota is None:
+        return None
+    try:
+        return ToolchainCleanupManager(cache_registry, LockManager()).enforce_quota(
+            quota, protect=protect
+        )
+    except Exception as e:
+        logger.warning(f"Cache quota enforcement failed: {e}")
+        return None
+
 
 @dataclass
 class ToolchainInfo:
@@ -77,14 +210,16 @@ class ToolchainCleanupManager:
         unused = []
         cutoff = datetime.now() - timedelta(days=min_age_days)
 
-        with self.registry._lock():
+        with self.registry.transaction():
             data = self.registry._load_registry()
             toolchains = data.get("toolchains", {})
 
             for toolchain_id, tc_data in toolchains.items():
                 # Check reference count and last access time
                 ref_count = tc_data.get("ref_count", 0)
-                last_access_str = tc_data.get("last_access")
+                last_access_str = tc_data.get("last_access") or tc_data.get(
+                    "last_used"
+                )
 
                 if last_access_str:
                     try:
@@ -108,10 +243,10 @@ class ToolchainCleanupManager:
                         continue
 
                 # Include if unused and old enough
-                if ref_count == 0 and last_access < cutoff:
+                if not _is_referenced(tc_data) and last_access < cutoff:
                     toolchain_path = Path(tc_data["path"])
                     if toolchain_path.exists():
-                        size = self._calculate_directory_size(toolchain_path)
+                        size = self._recorded_size(tc_data)
 
                         info = ToolchainInfo(
                             id=toolchain_id,
@@ -165,11 +300,14 @@ class ToolchainCleanupManager:
                         # Clean up registry entry for non-existent toolchain
                         if not dry_run:
                             del toolchains[toolchain_id]
+                            _update_totals(data)
                             self.registry._save_registry(data)
                         continue
 
                     # Check reference count
-                    ref_count = tc_data.get("ref_count", 0)
+                    ref_count = tc_data.get("ref_count", 0) or len(
+                        tc_data.get("projects", [])
+                    )
                     if ref_count > 0:
                         logger.warning(
                             f"Skipping {toolchain_id}: still referenced by {ref_count} projects"
@@ -180,8 +318,7 @@ class ToolchainCleanupManager:
                         )
                         continue
 
-                    # Calculate size
-                    size = self._calculate_directory_size(toolchain_path)
+                    size = self._recorded_size(tc_data)
 
                     if dry_run:
                         logger.info(
@@ -197,6 +334,7 @@ class ToolchainCleanupManager:
 
                         # Remove from registry
                         del toolchains[toolchain_id]
+                        _update_totals(data)
                         self.registry._save_registry(data)
 
                         logger.info(f"Removed toolchain: {toolchain_id} ({size} bytes)")
@@ -249,8 +387,14 @@ class ToolchainCleanupManager:
         return self.cleanup(toolchain_ids, dry_run=dry_run)
 
     def get_statistics(self) -> dict:
-        """Get toolchain cache statistics."""
-        with self.registry._lock():
+        """
+        Get toolchain cache statistics.
+
+        Sizes come from the registry, which records them at install time,
+        so no directory is walked (except once for entries registered by
+        older versions, whose size is then stored).
+        """
+        with self.registry.transaction():
             data = self.registry._load_registry()
             toolchains = data.get("toolchains", {})
 
@@ -259,24 +403,171 @@ class ToolchainCleanupManager:
             unused_count = 0
 
             for toolchain_id, tc_data in toolchains.items():
-                toolchain_path = Path(tc_data["path"])
-                if toolchain_path.exists():
-                    size = self._calculate_directory_size(toolchain_path)
-                    total_size += size
+                size = self._recorded_size(tc_data)
+                total_size += size
+
+                if not _is_referenced(tc_data):
+                    unused_size += size
+                    unused_count += 1
+
+            artifact_sizes: Dict[str, int] = {}
+            artifact_counts: Dict[str, int] = {}
+            for artifact in data.get("artifacts", {}).values():
+                kind = artifact.get("kind", "download")
+                artifact_sizes[kind] = artifact_sizes.get(kind, 0) + entry_size(
+                    artifact
+                )
+                artifact_counts[kind] = artifact_counts.get(kind, 0) + 1
+
+        quota = get_cache_quota()
+        return {
+            "total_toolchains": len(toolchains),
+            "total_size": total_size,
+            "unused_toolchains": unused_count,
+            "unused_size": unused_size,
+            "artifact_sizes": artifact_sizes,
+            "artifact_counts": artifact_counts,
+            "cache_size": total_size + sum(artifact_sizes.values()),
+            "quota": quota.max_bytes if quota else None,
+            "free_space": self._get_free_space_gb() * 1024**3,  # Convert to bytes
+        }
+
+    def enforce_quota(
+        self,
+        quota: Optional[CacheQuota] = None,
+        protect: Iterable[str] = (),
+        dry_run: bool = False,
+    ) -> CleanupResult:
+        """
+        Evict least recently used entries while the cache is over quota.
+
+        Nothing happens until usage exceeds the high watermark; then
+        unreferenced toolchains, downloaded archives and sysroots are removed
+        oldest ``last_used`` first until usage is at or below the low
+        watermark. Toolchains referenced by existing project directories are
+        never evicted, and neither are toolchains whose lock another process
+        holds (they are reported in ``skipped``).
+
+        Args:
+            quota: Quota to enforce (default: get_cache_quota())
+            protect: Toolchain IDs or artifact paths to keep
+            dry_run: If True, only report what would be removed
 
-                    ref_count = tc_data.get("ref_count", 0)
+        Returns:
+            CleanupResult; ``removed`` holds toolchain IDs and artifact paths
+        """
+        quota = quota or get_cache_quota()
+        result = CleanupResult()
+        if quota is None:
+            return result
+        protected = {str(p) for p in protect}
+        cache_root = self.registry.registry_path.parent
 
-                    if ref_count == 0:
-                        unused_size += size
-                        unused_count += 1
+        with self.registry.transaction():
+            data = self.registry._load_registry()
+            toolchains = data["toolchains"]
+            artifacts = data["artifacts"]
+            usage = sum(self._recorded_size(tc) for tc in toolchains.values()) + sum(
+                entry_size(a) for a in artifacts.values()
+            )
+            if usage <= quota.high_bytes:
+                return result
+
+            candidates = [
+                (_last_used(tc), "toolchain", toolchain_id)
+                for toolchain_id, tc in toolchains.items()
+                if not _is_referenced(tc, existing_only=True)
+                and toolchain_id not in protected
+            ] + [
+                (_last_used(artifact), "artifact", path)
+                for path, artifact in artifacts.items()
+                if path not in protected
+            ]
+            candidates.sort(key=lambda c: c[0] or datetime.min)
+            logger.info(
+                f"Cache over quota ({usage / 1024**3:.2f} of "
+                f"{quota.max_bytes / 1024**3:.2f} GB), evicting"
+            )
 
-            return {
-                "total_toolchains": len(toolchains),
-                "total_size": total_size,
-                "unused_toolchains": unused_count,
-                "unused_size": unused_size,
-                "free_space": self._get_free_space_gb() * 1024**3,  # Convert to bytes
-            }
+            for _when, section, key in candidates:
+                if usage <= quota.low_bytes:
+                    break
+                entries = toolchains if section == "toolchain" else artifacts
+                entry = entries[key]
+                size = (
+                    self._recorded_size(entry)
+                    if section == "toolchain"
+                    else entry_size(entry)
+                )
+                if section == "artifact":
+                    if not dry_run and not self._evict(Path(key), cache_root, result):
+                        continue
+                else:
+                    # A toolchain being installed or used holds its lock
+                    with self.lock_manager.try_toolchain_lock(key) as acquired:
+                        if not acquired:
+                            logger.info(
+                                f"Not evicting {key}: locked by another process"
+                            )
+                            result.skipped.append(key)
+                            continue
+                        if not dry_run and not self._evict(
+                            Path(entry["path"]), cache_root, result, key
+                        ):
+                            continue
+                if not dry_run:
+                    del entries[key]
+                logger.info(f"Evicted {key} ({size / 1024**2:.1f} MB)")
+                result.removed.append(key)
+                result.space_reclaimed += size
+                usage -= size
+
+            if result.removed and not dry_run:
+                _update_totals(data)
+                data["last_cleanup"] = datetime.now().isoformat()
+                self.registry._save_registry(data)
+
+        if usage > quota.low_bytes:
+            logger.warning(
+                f"Cache still over quota after eviction ({usage / 1024**3:.2f} GB); "
+                "remaining toolchains are referenced by projects or in use"
+            )
+        return result
+
+    def _evict(
+        self,
+        path: Path,
+        cache_root: Path,
+        result: CleanupResult,
+        key: Optional[str] = None,
+    ) -> bool:
+        """Remove one evicted entry from disk; failures go into result."""
+        key = key or str(path)
+        try:
+            if path.is_dir() and not path.is_symlink():
+                safe_rmtree(path, require_prefix=cache_root)
+            elif path.exists():
+                path.unlink()
+        except Exception as e:
+            logger.error(f"Failed to evict {key}: {e}")
+            result.failed.append(key)
+            result.errors.append(f"{key}: {e}")
+            return False
+        return True
+
+    def _recorded_size(self, tc_data: dict) -> int:
+        """
+        Size of a toolchain from its registry entry.
+
+        Entries without a recorded size are measured once and the size is
+        stored (the caller saves the registry data).
+        """
+        if "size_bytes" in tc_data or "size_mb" in tc_data:
+            return entry_size(tc_data)
+        path = Path(tc_data["path"])
+        size = directory_size(path) if path.exists() else 0
+        tc_data["size_bytes"] = size
+        return size
 
     def _calculate_directory_size(self, path: Path) -> int:
         """Calculate total size of directory in bytes."""
@@ -311,6 +602,30 @@ class ToolchainCleanupManager:
         return free_bytes / (1024**3)
 
 
+def _is_referenced(tc_data: dict, existing_only: bool = False) -> bool:
+    """
+    Whether a toolchain is used by any project (either bookkeeping).
+
+    With existing_only, references from project directories that no longer
+    exist are ignored.
+    """
+    projects = tc_data.get("projects") or []
+    if existing_only and projects:
+        return any(Path(project).is_dir() for project in projects)
+    return bool(projects) or tc_data.get("ref_count", 0) > 0
+
+
+def _last_used(entry: dict) -> Optional[datetime]:
+    """Most recent use of a registry entry, for LRU ordering."""
+    stamps = []
+    for key in ("last_used", "last_access", "installed"):
+        try:
+            stamps.append(datetime.fromisoformat(entry[key]))
+        except (KeyError, TypeError, ValueError):
+            continue
+    return max(stamps) if stamps else None
+
+
 class ReferenceCounter:
     """Manages reference counting for toolchains."""
 
@@ -0,0 +1,172 @@
+"""
+Component-selective toolchain installation.
+
+Toolchain archives ship far more than most builds use: an LLVM release
+contains lldb, MLIR, Flang, static development libraries and documentation
+next to clang and lld. The ``components`` of a toolchain in
+``toolchains.json`` name parts of the archive by path globs (relative to the
+toolchain root), and ``profiles`` name sets of components:
+
+    "components": {"debugger": ["bin/lldb*", "lib/liblldb*"], ...},
+    "profiles": {"minimal": ["compiler", "linker", "runtimes", "tools"]}
+
+Installing with a selection skips the members of every component that was not
+selected. Files that belong to no component are always installed, so an
+incomplete component list never removes something a build needs. The
+installed components are recorded in the cache registry; a component that is
+needed later (e.g. ``bolt`` for a layer that runs ``llvm-bolt``) is extracted
+into the existing installation by ``ensure_components()``.
+
+Example:
+    >>> downloader.download_toolchain("llvm", "18", "linux-x64", components="minimal")
+    >>> ensure_components(toolchain_root, ["bolt"])
+"""
+
+import logging
+from fnmatch import fnmatchcase
+from pathlib import Path
+from typing import Callable, Dict, Iterable, List, Optional, Sequence, Union
+
+logger = logging.getLogger(__name__)
+
+FULL = "full"
+"""Selection that installs the whole archive."""
+
+
+class ComponentError(ValueError):
+    """Raised for unknown components or profiles."""
+
+    pass
+
+
+def resolve_selection(
+    components: Dict[str, List[str]],
+    profiles: Dict[str, List[str]],
+    requested: Union[None, str, Sequence[str]],
+) -> Optional[List[str]]:
+    """
+    Expand a requested selection into component names.
+
+    Args:
+        components: Component name -> path globs of the toolchain
+        profiles: Profile name -> component names of the toolchain
+        requested: None or "full" for everything, or profile and component
+            names (a single name or a list, e.g. ["minimal", "bolt"])
+
+    Returns:
+        Sorted component names, or None for a full installation (also when
+        the toolchain defines no components)
+
+    Raises:
+        ComponentError: If a name is neither a profile nor a component
+    """
+    if requested is None:
+        return None
+    names = [requested] if isinstance(requested, str) else list(requested)
+    if FULL in names:
+        return None
+    if not components:
+        logger.debug("Toolchain defines no components, installing everything")
+        return None
+
+    selected = set()
+    for name in names:
+        if name in profiles:
+            selected.update(profiles[name])
+        elif name in components:
+            selected.add(name)
+        else:
+            known = sorted(set(components) | set(profiles) | {FULL})
+            raise ComponentError(
+                f"Unknown component or profile '{name}' (known: {', '.join(known)})"
+            )
+    if selected >= set(components):
+        return None
+    return sorted(selected)
+
+
+def _candidates(name: str) -> List[str]:
+    """Member name relative to the archive and to its top-level directory."""
+    if name.startswith("./"):
+        name = name[2:]
+    name = name.rstrip("/")
+    _head, sep, rest = name.partition("/")
+    return [name, rest] if sep else [name]
+
+
+def member_component(components: Dict[str, List[str]], name: str) -> List[str]:
+    """
+    Components an archive member belongs to.
+
+    Args:
+        components: Component name -> path globs
+        name: Member name as stored in the archive
+
+    Returns:
+        Names of matching components (empty if none)
+    """
+    paths = _candidates(name)
+    return [
+        component
+        for component, patterns in components.items()
+        if any(fnmatchcase(path, pattern) for path in paths for pattern in patterns)
+    ]
+
+
+def member_filter(
+    components: Dict[str, List[str]], selected: Iterable[str], only: bool = False
+) -> Callable[[str], bool]:
+    """
+    Predicate for extract_archive() that keeps the selected components.
+
+    Args:
+        components: Component name -> path globs
+        selected: Components to keep
+        only: Keep only members of the selected components (for adding
+            components to an installation); by default members that belong
+            to no component are kept as well
+
+    Returns:
+        Function taking an archive member name
+    """
+    selected = set(selected)
+
+    def keep(name: str) -> bool:
+        matched = member_component(components, name)
+        if not matched:
+            return not only
+        return any(component in selected for component in matched)
+
+    return keep
+
+
+def ensure_components(
+    toolchain_root: Path, components: Iterable[str], downloader=None
+) -> List[str]:
+    """
+    Make sure an installed toolchain has the given components.
+
+    Missing components are extracted from the toolchain's archive (downloaded
+    again if it is no longer cached). Toolchains that are not in the cache
+    registry, or were installed completely, are left alone.
+
+    Args:
+        toolchain_root: Toolchain installation directory
+        components: Needed component names
+        downloader: ToolchainDownloader (default: a new one)
+
+    Returns:
+        Components that were added
+
+    Raises:
+        ComponentError: If a component is unknown to the toolchain
+        ToolchainDownloadError: If the archive cannot be fetched or extracted
+    """
+    from toolchainkit.toolchain.downloader import ToolchainDownloader
+
+    downloader = downloader or ToolchainDownloader()
+    toolchain_id = downloader.cache_registry.find_toolchain(Path(toolchain_root))
+    if toolchain_id is None:
+        logger.debug(f"{toolchain_root} is not a cached toolchain, nothing to add")
+        return []
+    return downloader.materialize_components(toolchain_id, components)
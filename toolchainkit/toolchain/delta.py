@@ -0,0 +1,536 @@
+"""
+Delta upgrades between toolchain versions.
+
+A point release (LLVM 18.1.7 -> 18.1.8) changes only part of a ~1 GB tree.
+A delta patch describes the target tree relative to an installed base
+version, file by file:
+
+- ``copy``: the target file is identical to a base file (found by content
+  hash, so moved and renamed files are matched too)
+- ``patch``: a binary delta against the base file with the same path, using
+  zstd's patch-from mode (the base file is the compression dictionary, with
+  long-distance matching); requires the ``zstandard`` package
+- ``data``: the complete file
+
+Patches are stored in the bundle container (``core.bundle``): the payload of
+``patch`` and ``data`` files is a component of kind ``delta`` whose metadata
+holds the operations and the target manifest (hash, size and mode of every
+file, plus directories and symbolic links).
+
+Applying a patch builds the target in a fresh directory, hashing every file
+as it is written. The result must match the target manifest exactly;
+otherwise DeltaError is raised and callers fall back to a full download.
+
+Example:
+    >>> # Publisher with both versions installed
+    >>> create_delta(cache / "llvm-18.1.7-linux-x64", cache / "llvm-18.1.8-linux-x64",
+    ...              Path("llvm-18.1.7-to-18.1.8.tkdelta"))
+    >>> # Client with 18.1.7 installed
+    >>> apply_delta(Path("llvm-18.1.7-to-18.1.8.tkdelta"),
+    ...             cache / "llvm-18.1.7-linux-x64", cache / "llvm-18.1.8-linux-x64")
+"""
+
+import json
+import logging
+import os
+import shutil
+import stat
+import sys
+import time
+from concurrent.futures import ThreadPoolExecutor
+from dataclasses import dataclass
+from pathlib import Path
+from typing import Dict, List, Optional, Tuple
+
+from toolchainkit.core.bundle import (
+    BundleComponent,
+    BundleError,
+    BundleReader,
+    BundleWriter,
+)
+from toolchainkit.core.filesystem import safe_rmtree
+from toolchainkit.core.hashing import new_hasher
+from toolchainkit.core.manifest import (
+    MANIFEST_NAME,
+    IntegrityManifest,
+    ManifestEntry,
+    ManifestError,
+)
+
+logger = logging.getLogger(__name__)
+
+DELTA_KIND = "delta"
+"""Bundle component kind of a delta patch."""
+
+DELTA_FORMAT = "1"
+
+PATCH_MAX_SIZE = 1024 * 1024 * 1024
+"""Largest base or target file diffed in memory; larger files are stored whole."""
+
+PATCH_LEVEL = 9
+"""zstd level for binary patches (long-distance matching is always on)."""
+
+_COPY_CHUNK = 1024 * 1024
+
+
+class DeltaError(Exception):
+    """Raised when a delta cannot be created or applied."""
+
+    pass
+
+
+@dataclass
+class DeltaStats:
+    """What a delta patch contains."""
+
+    copied: int = 0
+    """Files taken unchanged from the base version."""
+
+    patched: int = 0
+    """Files rebuilt from a binary patch."""
+
+    stored: int = 0
+    """Files stored whole."""
+
+    target_bytes: int = 0
+    """Size of the target tree."""
+
+    patch_bytes: int = 0
+    """Size of the patch file (bytes transferred)."""
+
+    seconds: float = 0.0
+
+    def summary(self) -> str:
+        """One-line description, e.g. for logs and benchmarks."""
+        return (
+            f"{self.copied} copied, {self.patched} patched, {self.stored} stored; "
+            f"{self.patch_bytes / 1024**2:.1f} MB for "
+            f"{self.target_bytes / 1024**2:.1f} MB ({self.seconds:.1f}s)"
+        )
+
+
+def _zstd_module():
+    """Import zstandard lazily (optional dependency)."""
+    try:
+        import zstandard
+
+        return zstandard
+    except ImportError:
+        return None
+
+
+def _window_log(*sizes: int) -> int:
+    """zstd window covering the dictionary and the content (patch-from rule)."""
+    limit = 31 if sys.maxsize > 2**32 else 30
+    return max(10, min(limit, max(sizes).bit_length()))
+
+
+def make_patch(base: bytes, target: bytes, level: int = PATCH_LEVEL) -> bytes:
+    """
+    Compute a binary patch turning ``base`` into ``target``.
+
+    Args:
+        base: Old file content
+        target: New file content
+        level: zstd compression level
+
+    Returns:
+        Patch bytes (a zstd frame compressed against ``base``)
+
+    Raises:
+        DeltaError: If zstandard is not installed
+    """
+    zstandard = _zstd_module()
+    if zstandard is None:
+        raise DeltaError("Binary patches require the 'zstandard' package")
+    params = zstandard.ZstdCompressionParameters.from_level(
+        level, window_log=_window_log(len(base), len(target)), enable_ldm=True
+    )
+    dictionary = zstandard.ZstdCompressionDict(
+        base, dict_type=zstandard.DICT_TYPE_RAWCONTENT
+    )
+    return zstandard.ZstdCompressor(
+        dict_data=dictionary, compression_params=params
+    ).compress(target)
+
+
+def apply_patch(base: bytes, patch: bytes, size: int) -> bytes:
+    """
+    Rebuild a file from its base content and a patch from make_patch().
+
+    Args:
+        base: Old file content
+        patch: Patch bytes
+        size: Size of the rebuilt file
+
+    Returns:
+        Rebuilt file content
+
+    Raises:
+        DeltaError: If zstandard is missing or the patch does not apply
+    """
+    zstandard = _zstd_module()
+    if zstandard is None:
+        raise DeltaError("Binary patches require the 'zstandard' package")
+    dictionary = zstandard.ZstdCompressionDict(
+        base, dict_type=zstandard.DICT_TYPE_RAWCONTENT
+    )
+    try:
+        return zstandard.ZstdDecompressor(
+            dict_data=dictionary, max_window_size=1 << _window_log(len(base), size)
+        ).decompress(patch, max_output_size=size)
+    except zstandard.ZstdError as e:
+        raise DeltaError(f"Patch does not apply: {e}") from e
+
+
+def _load_manifest(root: Path, workers: Optional[int]) -> IntegrityManifest:
+    """Use the installed manifest if it is intact, else hash the tree."""
+    try:
+        manifest = IntegrityManifest.load(root)
+    except ManifestError:
+        manifest = None
+    if manifest is not None and manifest.verify(update=True).ok:
+        return manifest
+    return IntegrityManifest.create(root, workers=workers)
+
+
+def _tree_layout(root: Path) -> Tuple[List[str], List[Tuple[str, str]], Dict[str, int]]:
+    """Directories, symbolic links and file modes below root."""
+    dirs, links, modes = [], [], {}
+    for dirpath, dirnames, filenames in os.walk(root):
+        rel_dir = Path(dirpath).relative_to(root)
+        for name in list(dirnames):
+            path = Path(dirpath) / name
+            rel = (rel_dir / name).as_posix()
+            if path.is_symlink():
+                links.append((rel, os.readlink(path)))
+                dirnames.remove(name)
+            else:
+                dirs.append(rel)
+        for name in filenames:
+            path = Path(dirpath) / name
+            rel = (rel_dir / name).as_posix()
+            if rel == MANIFEST_NAME:
+                continue
+            st = path.lstat()
+            if stat.S_ISLNK(st.st_mode):
+                links.append((rel, os.readlink(path)))
+            else:
+                modes[rel] = stat.S_IMODE(st.st_mode)
+    return dirs, links, modes
+
+
+def _counterpart(
+    rel: str, base_files: Dict[str, ManifestEntry], versions: Tuple[str, str]
+) -> Optional[str]:
+    """Base file a changed target file should be diffed against."""
+    if rel in base_files:
+        return rel
+    base_version, target_version = versions
+    if base_version and target_version and target_version in rel:
+        renamed = rel.replace(target_version, base_version)
+        if renamed in base_files:
+            return renamed
+    return None
+
+
+def create_delta(
+    base_dir: Path,
+    target_dir: Path,
+    output: Path,
+    base_id: str = "",
+    target_id: str = "",
+    codec: Optional[str] = None,
+    workers: Optional[int] = None,
+    binary_patches: bool = True,
+) -> DeltaStats:
+    """
+    Write a delta patch that rebuilds ``target_dir`` from ``base_dir``.
+
+    Args:
+        base_dir: Installed base version
+        target_dir: Installed target version
+        output: Patch file to write
+        base_id: Base toolchain ID (e.g. 'llvm-18.1.7-linux-x64')
+        target_id: Target toolchain ID (e.g. 'llvm-18.1.8-linux-x64')
+        codec: Bundle codec for stored files (default: best available)
+        workers: Threads for hashing and diffing (default: CPU count)
+        binary_patches: Diff changed files (needs zstandard); if False or
+            zstandard is missing, changed files are stored whole
+
+    Returns:
+        DeltaStats of the written patch
+
+    Raises:
+        DeltaError: If a tree cannot be read or the patch cannot be written
+    """
+    start = time.perf_counter()
+    base_dir, target_dir, output = Path(base_dir), Path(target_dir), Path(output)
+    workers = workers or os.cpu_count() or 1
+    if binary_patches and _zstd_module() is None:
+        logger.warning("zstandard not installed, changed files are stored whole")
+        binary_patches = False
+
+    base = _load_manifest(base_dir, workers)
+    target = _load_manifest(target_dir, workers)
+    dirs, links, modes = _tree_layout(target_dir)
+    by_hash = {
+        e.sha256: rel
+        for rel, e in sorted(base.entries.items())
+        if not e.sha256.startswith("link:")
+    }
+    versions = (_id_version(base_id), _id_version(target_id))
+
+    ops: Dict[str, list] = {}
+    diff: List[Tuple[str, str]] = []
+    stats = DeltaStats()
+    for rel, entry in sorted(target.entries.items()):
+        if rel not in modes:
+            continue  # symbolic link (recorded in links)
+        stats.target_bytes += entry.size
+        if entry.sha256 in by_hash:
+            ops[rel] = [
+                "copy",
+                entry.sha256,
+                entry.size,
+                modes[rel],
+                by_hash[entry.sha256],
+            ]
+            stats.copied += 1
+            continue
+        source = _counterpart(rel, base.entries, versions) if binary_patches else None
+        if (
+            source is not None
+            and base.entries[source].size <= PATCH_MAX_SIZE
+            and entry.size <= PATCH_MAX_SIZE
+        ):
+            diff.append((rel, source))
+        else:
+            ops[rel] = ["data", entry.sha256, entry.size, modes[rel], ""]
+            stats.stored += 1
+
+    staging = output.parent / f".{output.name}.staging"
+    if staging.exists():
+        shutil.rmtree(staging)
+    try:
+        staging.mkdir(parents=True)
+
+        def diff_one(item: Tuple[str, str]) -> Tuple[str, str, int]:
+            rel, source = item
+            data = (target_dir / rel).read_bytes()
+            patch = make_patch((base_dir / source).read_bytes(), data)
+            if len(patch) >= len(data):
+                return rel, source, -1
+            payload = staging / rel
+            payload.parent.mkdir(parents=True, exist_ok=True)
+            payload.write_bytes(patch)
+            return rel, source, len(patch)
+
+        with ThreadPoolExecutor(max_workers=workers) as pool:
+            for rel, source, patch_size in pool.map(diff_one, diff):
+                entry = target.entries[rel]
+                if patch_size < 0:
+                    ops[rel] = ["data", entry.sha256, entry.size, modes[rel], ""]
+                    stats.stored += 1
+                else:
+                    ops[rel] = ["patch", entry.sha256, entry.size, modes[rel], source]
+                    stats.patched += 1
+
+        for rel, op in ops.items():
+            if op[0] == "data":
+                payload = staging / rel
+                payload.parent.mkdir(parents=True, exist_ok=True)
+                try:
+                    os.link(target_dir / rel, payload)
+                except OSError:
+                    shutil.copyfile(target_dir / rel, payload)
+
+        layout = {"format": DELTA_FORMAT, "files": ops, "dirs": dirs, "links": links}
+        with BundleWriter(output, codec=codec, workers=workers) as writer:
+            writer.add_tree(
+                DELTA_KIND,
+                f"{base_id}..{target_id}",
+                staging,
+                root=f"toolchains/{target_id}",
+                metadata={
+                    "base": base_id,
+                    "target": target_id,
+                    "layout": json.dumps(layout, separators=(",", ":")),
+                },
+            )
+    except (BundleError, OSError) as e:
+        raise DeltaError(f"Failed to create delta {output}: {e}") from e
+    finally:
+        if staging.exists():
+            shutil.rmtree(staging, ignore_errors=True)
+
+    stats.patch_bytes = output.stat().st_size
+    stats.seconds = time.perf_counter() - start
+    logger.info(f"Delta {base_id} -> {target_id}: {stats.summary()}")
+    return stats
+
+
+def _id_version(toolchain_id: str) -> str:
+    """Version part of a '<type>-<version>-<platform>' toolchain ID."""
+    parts = toolchain_id.split("-")
+    return parts[1] if len(parts) >= 3 else ""
+
+
+def read_delta(path: Path) -> Tuple[BundleReader, BundleComponent, dict]:
+    """
+    Open a delta patch.
+
+    Args:
+        path: Patch file
+
+    Returns:
+        (reader, component, layout)
+
+    Raises:
+        DeltaError: If the file is not a delta patch
+    """
+    try:
+        reader = BundleReader(path)
+    except BundleError as e:
+        raise DeltaError(str(e)) from e
+    component = next((c for c in reader.components if c.kind == DELTA_KIND), None)
+    if component is None:
+        raise DeltaError(f"No delta in {path}")
+    try:
+        layout = json.loads(component.metadata["layout"])
+    except (KeyError, ValueError) as e:
+        raise DeltaError(f"Invalid delta layout in {path}: {e}") from e
+    if layout.get("format") != DELTA_FORMAT:
+        raise DeltaError(f"Unsupported delta format {layout.get('format')} in {path}")
+    return reader, component, layout
+
+
+def apply_delta(
+    patch_path: Path,
+    base_dir: Path,
+    destination: Path,
+    workers: Optional[int] = None,
+) -> DeltaStats:
+    """
+    Build the target version of a delta patch in a new directory.
+
+    The tree is built in ``.<name>.delta`` next to ``destination`` and moved
+    into place only after every file matched the target manifest. An
+    integrity manifest is written for the new tree.
+
+    Args:
+        patch_path: Delta patch file
+        base_dir: Installed base version
+        destination: Directory to create (must not exist)
+        workers: Threads (default: CPU count)
+
+    Returns:
+        DeltaStats of the applied patch
+
+    Raises:
+        DeltaError: If the patch is invalid, a base file is missing or the
+            result does not match the target manifest
+    """
+    start = time.perf_counter()
+    base_dir, destination = Path(base_dir), Path(destination)
+    workers = workers or os.cpu_count() or 1
+    if destination.exists():
+        raise DeltaError(f"Destination already exists: {destination}")
+
+    reader, component, layout = read_delta(patch_path)
+    staging = destination.parent / f".{destination.name}.delta"
+    payload_dir = destination.parent / f".{destination.name}.payload"
+    for leftover in (staging, payload_dir):
+        if leftover.exists():
+            safe_rmtree(leftover, require_prefix=destination.parent)
+
+    stats = DeltaStats(patch_bytes=Path(patch_path).stat().st_size)
+    try:
+        reader.extract(component, payload_dir, workers=workers)
+        staging.mkdir(parents=True)
+        for rel in layout["dirs"]:
+            (staging / rel).mkdir(parents=True, exist_ok=True)
+
+        def build(item: Tuple[str, list]) -> Tuple[str, str]:
+            rel, (op, expected, size, mode, source) = item
+            target = staging / rel
+            target.parent.mkdir(parents=True, exist_ok=True)
+            if op == "copy":
+                digest = _copy_hashed(base_dir / source, target)
+            elif op == "patch":
+                data = apply_patch(
+                    (base_dir / source).read_bytes(),
+                    (payload_dir / rel).read_bytes(),
+                    size,
+                )
+                target.write_bytes(data)
+                hasher = new_hasher("sha256")
+                hasher.update(data)
+                digest = hasher.hexdigest()
+            elif op == "data":
+                # Verified against the patch index while unpacking
+                os.replace(payload_dir / rel, target)
+                digest = expected
+            else:
+                raise DeltaError(f"Unknown delta operation '{op}' for {rel}")
+            if os.name != "nt":
+                os.chmod(target, mode)
+            return rel, digest
+
+        files = sorted(layout["files"].items(), key=lambda i: i[1][2], reverse=True)
+        with ThreadPoolExecutor(max_workers=workers) as pool:
+            hashes = dict(pool.map(build, files))
+
+        for rel, link_target in layout["links"]:
+            link = staging / rel
+            link.parent.mkdir(parents=True, exist_ok=True)
+            os.symlink(link_target, link)
+
+        mismatched = [
+            rel for rel, op in layout["files"].items() if hashes.get(rel) != op[1]
+        ]
+        if mismatched:
+            raise DeltaError(
+                f"{len(mismatched)} file(s) do not match the target manifest: "
+                f"{', '.join(sorted(mismatched)[:3])}"
+            )
+
+        entries = {}
+        for rel, digest in hashes.items():
+            st = os.stat(staging / rel)
+            entries[rel] = ManifestEntry(digest, st.st_size, st.st_mtime_ns)
+        for rel, link_target in layout["links"]:
+            entries[rel] = ManifestEntry("link:" + link_target, 0, 0)
+        IntegrityManifest(staging, entries).save()
+        staging.rename(destination)
+    except (BundleError, ManifestError, OSError) as e:
+        raise DeltaError(f"Failed to apply delta {patch_path}: {e}") from e
+    finally:
+        for leftover in (staging, payload_dir):
+            if leftover.exists():
+                safe_rmtree(leftover, require_prefix=destination.parent)
+
+    for op, _digest, size, _mode, _source in layout["files"].values():
+        stats.target_bytes += size
+        if op == "copy":
+            stats.copied += 1
+        elif op == "patch":
+            stats.patched += 1
+        else:
+            stats.stored += 1
+    stats.seconds = time.perf_counter() - start
+    logger.info(f"Applied delta to {destination.name}: {stats.summary()}")
+    return stats
+
+
+def _copy_hashed(source: Path, target: Path) -> str:
+    """Copy a file and return the SHA256 of what was written."""
+    hasher = new_hasher("sha256")
+    with open(source, "rb") as src, open(target, "wb") as dst:
+        while True:
+            chunk = src.read(_COPY_CHUNK)
+            if not chunk:
+                break
+            hasher.update(chunk)
+            dst.write(chunk)
+    return hasher.hexdigest()
@@ -7,20 +7,47 @@ and shared cache registry.
 """
 
 import logging
+import os
 import time
 from pathlib import Path
-from typing import Optional, Callable
+from typing import Callable, List, Optional, Sequence, Tuple, Union
 from dataclasses import dataclass
 
-from toolchainkit.core.download import download_file, DownloadProgress
-from toolchainkit.core.filesystem import extract_archive, safe_rmtree
+from toolchainkit.core import tracing
+from toolchainkit.core.bundle import BundleError
+from toolchainkit.core.download import (
+    ChecksumError,
+    DownloadError,
+    DownloadProgress,
+    download_file,
+)
+from toolchainkit.core.filesystem import (
+    FILTERABLE_ARCHIVES,
+    ArchiveExtractionError,
+    directory_size,
+    extract_archive,
+    safe_rmtree,
+)
 from toolchainkit.core.cache_registry import ToolchainCacheRegistry as CoreRegistry
 from toolchainkit.core.locking import DownloadCoordinator, LockManager
+from toolchainkit.core.manifest import IntegrityManifest, ManifestError, write_manifest
 from toolchainkit.core.directory import get_global_cache_dir
+from toolchainkit.toolchain.cleanup import enforce_cache_quota
+from toolchainkit.toolchain.components import (
+    ComponentError,
+    member_filter,
+    resolve_selection,
+)
 from toolchainkit.toolchain.metadata_registry import (
     ToolchainMetadataRegistry,
     ToolchainMetadata,
 )
+from toolchainkit.toolchain.repack import (
+    RepackedArchive,
+    open_repacked,
+    repack_archive,
+    repack_enabled,
+)
 
 logger = logging.getLogger(__name__)
 
@@ -142,6 +169,7 @@ class ToolchainDownloader:
         platform: str,
         force: bool = False,
         progress_callback: Optional[Callable[[ProgressInfo], None]] = None,
+        components: Union[None, str, Sequence[str]] = None,
     ) -> DownloadResult:
         """
         Download and extract a toolchain.
@@ -152,6 +180,9 @@ class ToolchainDownloader:
             platform: Platform string (e.g., "linux-x64")
             force: Force re-download even if cached
             progress_callback: Optional callback for progress updates
+            components: Profile or component names to install (e.g.
+                "minimal" or ["minimal", "bolt"]); None installs everything.
+                Components missing from a cached installation are added.
 
         Returns:
             DownloadResult with installation details
@@ -178,51 +209,337 @@ class ToolchainDownloader:
             toolchain_name, version
         )
         toolchain_id = f"{toolchain_name}-{resolved_version}-{platform}"
+        try:
+            selection = resolve_selection(
+                metadata.components, metadata.profiles, components
+            )
+        except ComponentError as e:
+            raise ToolchainDownloadError(f"{toolchain_id}: {e}") from e
+        if selection and not metadata.url.lower().endswith(FILTERABLE_ARCHIVES):
+            logger.info(f"Cannot select components of {metadata.url}, installing all")
+            selection = None
+        return self._install(
+            toolchain_id, metadata, force, progress_callback, selection
+        )
+
+    def download_locked(
+        self,
+        toolchain_id: str,
+        url: str,
+        sha256: str,
+        size_bytes: int = 0,
+        force: bool = False,
+        progress_callback: Optional[Callable[[ProgressInfo], None]] = None,
+    ) -> DownloadResult:
+        """
+        Download a toolchain pinned by a lock file entry.
+
+        Unlike download_toolchain(), no metadata lookup is done: the URL and
+        checksum come from the lock file, so the exact pinned archive is
+        installed even if the embedded metadata has moved on.
+
+        Args:
+            toolchain_id: Toolchain ID (install directory name)
+            url: Archive URL
+            sha256: Archive SHA256 (with or without 'sha256:' prefix)
+            size_bytes: Archive size, if known
+            force: Force re-download even if cached
+            progress_callback: Optional callback for progress updates
+
+        Returns:
+            DownloadResult with installation details
+
+        Raises:
+            ToolchainDownloadError: If download fails
+        """
+        metadata = ToolchainMetadata(
+            url=url,
+            sha256=sha256.replace("sha256:", ""),
+            size_mb=max(1, size_bytes // (1024 * 1024)),
+        )
+        return self._install(toolchain_id, metadata, force, progress_callback)
+
+    def download_and_install(
+        self,
+        toolchain_id: str,
+        url: str,
+        checksum: str,
+        progress_callback: Optional[Callable[[ProgressInfo], None]] = None,
+    ) -> Path:
+        """
+        Download and install a toolchain archive, returning its directory.
+
+        Args:
+            toolchain_id: Toolchain ID (install directory name)
+            url: Archive URL
+            checksum: Archive hash ('sha256:<hex>' or '<hex>')
+            progress_callback: Optional callback for progress updates
+
+        Returns:
+            Path to the installed toolchain
+
+        Raises:
+            ToolchainDownloadError: If download fails
+        """
+        return self.download_locked(
+            toolchain_id, url, checksum, progress_callback=progress_callback
+        ).toolchain_path
+
+    def install_delta(
+        self,
+        toolchain_id: str,
+        base_dir: Path,
+        url: str,
+        sha256: str,
+        archive_sha256: str = "",
+        progress_callback: Optional[Callable[[ProgressInfo], None]] = None,
+    ) -> DownloadResult:
+        """
+        Install a toolchain from an installed base version and a delta patch.
+
+        The patch is downloaded and verified, then applied into a new
+        directory (see ``toolchain.delta``). The result is checked against
+        the target manifest carried by the patch before it is registered.
+
+        Args:
+            toolchain_id: Toolchain ID to install (the delta's target)
+            base_dir: Installed base toolchain directory
+            url: Delta patch URL
+            sha256: Delta patch SHA256
+            archive_sha256: SHA256 of the full target archive (for the registry)
+            progress_callback: Optional callback for download progress
+
+        Returns:
+            DownloadResult; extraction_time is the time spent applying the patch
+
+        Raises:
+            ToolchainDownloadError: If the patch cannot be downloaded or applied
+        """
+        from toolchainkit.toolchain.delta import DeltaError, apply_delta
+
         install_dir = self.toolchains_dir / toolchain_id
+        patch_path = self.downloads_dir / url.split("/")[-1]
+        if not Path(base_dir).is_dir():
+            raise ToolchainDownloadError(f"Base toolchain not installed: {base_dir}")
 
-        logger.info(f"Downloading toolchain: {toolchain_id}")
+        with self.coordinator.coordinate_download(
+            toolchain_id, install_dir
+        ) as should_download:
+            if not should_download:
+                logger.info(f"Toolchain already installed: {toolchain_id}")
+                return DownloadResult(toolchain_id, install_dir, 0.0, 0.0, 0, True)
+            if install_dir.exists():
+                # Incomplete installation
+                safe_rmtree(install_dir, require_prefix=self.cache_dir)
 
-        # Check if already cached
-        if not force and install_dir.exists():
-            logger.info(f"Toolchain already cached: {install_dir}")
+            def download_progress(dp: DownloadProgress):
+                progress_callback(
+                    ProgressInfo(
+                        phase="downloading",
+                        percentage=dp.percentage,
+                        current_bytes=dp.bytes_downloaded,
+                        total_bytes=dp.total_bytes,
+                        speed_bps=dp.speed_bps,
+                        eta_seconds=dp.eta_seconds,
+                    )
+                )
+
+            try:
+                download_start = time.time()
+                download_file(
+                    url=url,
+                    destination=patch_path,
+                    expected_sha256=sha256.replace("sha256:", ""),
+                    progress_callback=download_progress if progress_callback else None,
+                )
+                download_time = time.time() - download_start
+                stats = apply_delta(patch_path, Path(base_dir), install_dir)
+            except (DownloadError, ChecksumError, DeltaError) as e:
+                patch_path.unlink(missing_ok=True)
+                raise ToolchainDownloadError(
+                    f"Delta install of {toolchain_id} failed: {e}"
+                ) from e
 
-            # Calculate size
-            total_size = sum(
-                f.stat().st_size for f in install_dir.rglob("*") if f.is_file()
+            self.cache_registry.register_toolchain(
+                toolchain_id=toolchain_id,
+                path=install_dir,
+                size_mb=stats.target_bytes / (1024 * 1024),
+                hash_value=f"sha256:{archive_sha256 or sha256}",
+                source_url=url,
+                verified=True,
+                size_bytes=stats.target_bytes,
+            )
+            logger.info(f"Registered toolchain: {toolchain_id} ({stats.summary()})")
+            enforce_cache_quota(
+                self.cache_registry, protect=[toolchain_id, Path(base_dir).name]
             )
 
             return DownloadResult(
                 toolchain_id=toolchain_id,
                 toolchain_path=install_dir,
-                download_time=0.0,
-                extraction_time=0.0,
-                total_size_bytes=total_size,
-                was_cached=True,
+                download_time=download_time,
+                extraction_time=stats.seconds,
+                total_size_bytes=stats.target_bytes,
+                was_cached=False,
             )
 
-        # Use download coordinator for safe concurrent access
-        with self.coordinator.coordinate_download(
-            toolchain_id, install_dir
-        ) as should_download:
-            if not should_download:
+    @tracing.traced("install toolchain", "toolchain")
+    def _install(
+        self,
+        toolchain_id: str,
+        metadata: ToolchainMetadata,
+        force: bool,
+        progress_callback: Optional[Callable[[ProgressInfo], None]],
+        selection: Optional[List[str]] = None,
+    ) -> DownloadResult:
+        """Return the cached toolchain, or download it under the download lock."""
+        install_dir = self.toolchains_dir / toolchain_id
+        tracing.annotate(toolchain=toolchain_id)
+
+        logger.info(f"Downloading toolchain: {toolchain_id}")
+
+        # Check if already cached
+        if not force and install_dir.exists():
+            logger.info(f"Toolchain already cached: {install_dir}")
+        else:
+            # Use download coordinator for safe concurrent access
+            with self.coordinator.coordinate_download(
+                toolchain_id, install_dir
+            ) as should_download:
+                if should_download:
+                    # This process won the race - perform download
+                    return self._download_and_extract(
+                        toolchain_id,
+                        metadata,
+                        install_dir,
+                        progress_callback,
+                        selection,
+                    )
                 # Another process completed the download
                 logger.info(f"Toolchain downloaded by another process: {toolchain_id}")
-                total_size = sum(
-                    f.stat().st_size for f in install_dir.rglob("*") if f.is_file()
-                )
-                return DownloadResult(
-                    toolchain_id=toolchain_id,
-                    toolchain_path=install_dir,
-                    download_time=0.0,
-                    extraction_time=0.0,
-                    total_size_bytes=total_size,
-                    was_cached=True,
+
+        # Outside the toolchain lock, which materialization takes itself
+        if selection:
+            self.materialize_components(toolchain_id, selection)
+        return self._cached_result(toolchain_id, install_dir)
+
+    @tracing.traced("add components", "toolchain")
+    def materialize_components(
+        self, toolchain_id: str, components: Sequence[str]
+    ) -> List[str]:
+        """
+        Add components to a toolchain that was installed with a selection.
+
+        Only the members of the missing components are extracted from the
+        archive in the downloads cache (downloaded again and verified if it
+        was evicted) and moved into the installation. The integrity manifest,
+        registry size and component list are updated.
+
+        Args:
+            toolchain_id: Installed toolchain ID
+            components: Needed component names
+
+        Returns:
+            Components that were added (empty if all were present, or the
+            toolchain was installed completely)
+
+        Raises:
+            ComponentError: If a component is unknown to the toolchain
+            ToolchainDownloadError: If the archive cannot be fetched or extracted
+        """
+        entry = self.cache_registry.get_toolchain_info(toolchain_id)
+        if not entry or "components" not in entry:
+            return []
+        patterns = entry.get("component_patterns", {})
+        unknown = sorted(set(components) - set(patterns))
+        if unknown:
+            raise ComponentError(
+                f"{toolchain_id} has no component(s) {', '.join(unknown)}"
+            )
+        if set(components) <= set(entry["components"]):
+            return []
+
+        with self.lock_manager.toolchain_lock(toolchain_id):
+            # Another process may have added them meanwhile
+            entry = self.cache_registry.get_toolchain_info(toolchain_id)
+            missing = sorted(set(components) - set(entry["components"]))
+            if not missing:
+                return []
+
+            start = time.time()
+            install_dir = Path(entry["path"])
+            url = entry["source_url"]
+            archive_path = self.downloads_dir / url.split("/")[-1]
+            sha256 = entry["hash"].replace("sha256:", "")
+            temp_dir = self.downloads_dir / f"{toolchain_id}_components"
+            keep = member_filter(patterns, missing, only=True)
+            try:
+                repacked = open_repacked(archive_path, sha256)
+                if repacked is not None:
+                    repacked = self._extract_repacked(repacked, temp_dir, keep, None)
+                if repacked is None:
+                    if not archive_path.exists():
+                        logger.info(f"Fetching {url} for components {missing}")
+                        download_file(
+                            url=url, destination=archive_path, expected_sha256=sha256
+                        )
+                    extract_archive(archive_path, temp_dir, member_filter=keep)
+                else:
+                    archive_path = repacked.path
+                added, added_bytes = _merge_tree(
+                    _component_root(temp_dir, install_dir), install_dir
                 )
+            except (DownloadError, ChecksumError, ArchiveExtractionError, OSError) as e:
+                raise ToolchainDownloadError(
+                    f"Failed to add components {missing} to {toolchain_id}: {e}"
+                ) from e
+            finally:
+                if temp_dir.exists():
+                    safe_rmtree(temp_dir, require_prefix=self.downloads_dir)
 
-            # This process won the race - perform download
-            return self._download_and_extract(
-                toolchain_id, metadata, install_dir, progress_callback
+            try:
+                manifest = IntegrityManifest.load(install_dir)
+                if manifest is not None:
+                    manifest.add(added)
+                    manifest.save()
+            except ManifestError as e:
+                logger.warning(f"Could not update manifest of {toolchain_id}: {e}")
+            self.cache_registry.add_components(toolchain_id, missing, added_bytes)
+            self.cache_registry.register_artifact(
+                archive_path, "download", archive_path.stat().st_size
             )
+            logger.info(
+                f"Added components {', '.join(missing)} to {toolchain_id}: "
+                f"{len(added)} files, {added_bytes / (1024 * 1024):.1f} MB "
+                f"in {time.time() - start:.2f}s"
+            )
+
+        enforce_cache_quota(
+            self.cache_registry, protect=[toolchain_id, str(archive_path.resolve())]
+        )
+        return missing
+
+    def _cached_result(self, toolchain_id: str, install_dir: Path) -> DownloadResult:
+        """
+        Result for an already installed toolchain.
+
+        Records the use for LRU eviction and takes the size from the
+        registry; only unregistered installs are measured on disk.
+        """
+        entry = self.cache_registry.update_last_used(toolchain_id)
+        if isinstance(entry, dict) and "size_bytes" in entry:
+            total_size = entry["size_bytes"]
+        else:
+            total_size = directory_size(install_dir)
+
+        return DownloadResult(
+            toolchain_id=toolchain_id,
+            toolchain_path=install_dir,
+            download_time=0.0,
+            extraction_time=0.0,
+            total_size_bytes=total_size,
+            was_cached=True,
+        )
 
     def _download_and_extract(
         self,
@@ -230,6 +547,7 @@ class ToolchainDownloader:
         metadata: ToolchainMetadata,
         install_dir: Path,
         progress_callback: Optional[Callable[[ProgressInfo], None]],
+        selection: Optional[List[str]] = None,
     ) -> DownloadResult:
         """
         Perform the actual download and extraction.
@@ -239,6 +557,7 @@ class ToolchainDownloader:
             metadata: Toolchain metadata with URL and checksum
             install_dir: Target installation directory
             progress_callback: Optional progress callback
+            selection: Components to install (None: the whole archive)
 
         Returns:
             DownloadResult with timing and size information
@@ -249,10 +568,10 @@ class ToolchainDownloader:
 
         download_time = 0.0
         extraction_time = 0.0
+        repacked = open_repacked(archive_path, metadata.sha256)
 
         try:
             # Phase 1: Download
-            logger.info(f"Downloading from: {metadata.url}")
             download_start = time.time()
 
             def download_progress(dp: DownloadProgress):
@@ -269,15 +588,18 @@ class ToolchainDownloader:
                         )
                     )
 
-            download_file(
-                url=metadata.url,
-                destination=archive_path,
-                expected_sha256=metadata.sha256,
-                progress_callback=download_progress if progress_callback else None,
-            )
+            if repacked is None:
+                logger.info(f"Downloading from: {metadata.url}")
+                download_file(
+                    url=metadata.url,
+                    destination=archive_path,
+                    expected_sha256=metadata.sha256,
+                    progress_callback=download_progress if progress_callback else None,
+                    mirrors=metadata.mirrors,
+                )
 
-            download_time = time.time() - download_start
-            logger.info(f"Download complete in {download_time:.2f}s")
+                download_time = time.time() - download_start
+                logger.info(f"Download complete in {download_time:.2f}s")
 
             # Phase 2: Extract
             logger.info(f"Extracting to: {install_dir}")
@@ -300,11 +622,37 @@ class ToolchainDownloader:
 
             # Extract to temporary directory first
             temp_extract_dir.mkdir(parents=True, exist_ok=True)
-            extract_archive(
-                archive_path=archive_path,
-                destination=temp_extract_dir,
-                progress_callback=extraction_progress if progress_callback else None,
-            )
+            extract_options = {}
+            if selection:
+                logger.info(f"Installing components: {', '.join(selection)}")
+                extract_options["member_filter"] = member_filter(
+                    metadata.components, selection
+                )
+            if repacked is not None:
+                repacked = self._extract_repacked(
+                    repacked,
+                    temp_extract_dir,
+                    extract_options.get("member_filter"),
+                    extraction_progress if progress_callback else None,
+                )
+                if repacked is None:
+                    # The re-pack was corrupt (and deleted): use the original
+                    logger.info(f"Downloading from: {metadata.url}")
+                    download_file(
+                        url=metadata.url,
+                        destination=archive_path,
+                        expected_sha256=metadata.sha256,
+                        mirrors=metadata.mirrors,
+                    )
+            if repacked is None:
+                extract_archive(
+                    archive_path=archive_path,
+                    destination=temp_extract_dir,
+                    progress_callback=(
+                        extraction_progress if progress_callback else None
+                    ),
+                    **extract_options,
+                )
 
             # Normalize root directory
             final_root = self._normalize_root_directory(temp_extract_dir)
@@ -317,10 +665,14 @@ class ToolchainDownloader:
             extraction_time = time.time() - extraction_start
             logger.info(f"Extraction complete in {extraction_time:.2f}s")
 
-            # Calculate total size
-            total_size = sum(
-                f.stat().st_size for f in install_dir.rglob("*") if f.is_file()
-            )
+            # Record per-file integrity data (also gives the total size)
+            manifest = write_manifest(install_dir)
+            if manifest is not None:
+                total_size = manifest.total_size
+            else:
+                total_size = sum(
+                    f.stat().st_size for f in install_dir.rglob("*") if f.is_file()
+                )
 
             # Register in cache
             self.cache_registry.register_toolchain(
@@ -330,9 +682,26 @@ class ToolchainDownloader:
                 hash_value=f"sha256:{metadata.sha256}",
                 source_url=metadata.url,
                 verified=True,
+                size_bytes=total_size,
+                components=selection,
+                component_patterns=metadata.components if selection else None,
             )
+            # The archive is kept for re-installs; account for it so the
+            # quota can evict it
+            kept_path = archive_path
+            if repacked is not None:
+                kept_path = repacked.path
+                self.cache_registry.touch_artifact(kept_path)
+            elif archive_path.exists():
+                kept_path = self._repack(archive_path, metadata)
+                self.cache_registry.register_artifact(
+                    kept_path, "download", kept_path.stat().st_size
+                )
 
             logger.info(f"Registered toolchain: {toolchain_id}")
+            enforce_cache_quota(
+                self.cache_registry, protect=[toolchain_id, str(kept_path.resolve())]
+            )
 
             # Report completion
             if progress_callback:
@@ -369,6 +738,54 @@ class ToolchainDownloader:
             if temp_extract_dir.exists():
                 safe_rmtree(temp_extract_dir, require_prefix=self.downloads_dir)
 
+    @tracing.traced("extract re-pack", "extract")
+    def _extract_repacked(
+        self,
+        repacked: RepackedArchive,
+        destination: Path,
+        keep: Optional[Callable[[str], bool]],
+        progress: Optional[Callable[[int, int], None]],
+    ) -> Optional[RepackedArchive]:
+        """
+        Extract from a re-packed archive, in parallel.
+
+        Returns:
+            The re-pack, or None if it was corrupt (it is deleted and the
+            caller falls back to the original archive)
+        """
+        logger.info(f"Extracting from re-pack: {repacked.path.name}")
+        try:
+            repacked.extract(
+                destination, member_filter=keep, progress_callback=progress
+            )
+            return repacked
+        except BundleError as e:
+            logger.warning(f"Re-pack {repacked.path.name} is unusable: {e}")
+            repacked.path.unlink(missing_ok=True)
+            self.cache_registry.unregister_artifact(repacked.path)
+            if destination.exists():
+                safe_rmtree(destination, require_prefix=self.downloads_dir)
+            return None
+
+    @tracing.traced("repack", "extract")
+    def _repack(self, archive_path: Path, metadata: ToolchainMetadata) -> Path:
+        """
+        Replace a verified archive by its seekable re-pack, if enabled.
+
+        Returns:
+            Path of the file kept in the downloads cache
+        """
+        if not repack_enabled() or not archive_path.name.endswith(FILTERABLE_ARCHIVES):
+            return archive_path
+        try:
+            bundle = repack_archive(archive_path, metadata.sha256, metadata.url)
+        except BundleError as e:
+            logger.warning(f"Keeping {archive_path.name}, repacking failed: {e}")
+            return archive_path
+        archive_path.unlink()
+        self.cache_registry.unregister_artifact(archive_path)
+        return bundle
+
     def _normalize_root_directory(self, extract_dir: Path) -> Path:
         """
         Normalize extracted directory structure.
@@ -477,6 +894,48 @@ class ToolchainDownloader:
         return install_dir if install_dir.exists() else None
 
 
+def _component_root(extract_dir: Path, install_dir: Path) -> Path:
+    """
+    Toolchain root inside a partial extraction.
+
+    A single directory is the archive's top-level directory unless the
+    installation itself has an entry of that name (e.g. only ``bin/`` was
+    extracted from an archive without a top-level directory).
+    """
+    items = list(extract_dir.iterdir()) if extract_dir.exists() else []
+    if (
+        len(items) == 1
+        and items[0].is_dir()
+        and not (install_dir / items[0].name).exists()
+    ):
+        return items[0]
+    return extract_dir
+
+
+def _merge_tree(source: Path, destination: Path) -> Tuple[List[str], int]:
+    """
+    Move files that do not exist yet from source into destination.
+
+    Returns:
+        (relative POSIX paths of moved files, their total size in bytes)
+    """
+    added = []
+    added_bytes = 0
+    for dirpath, dirnames, filenames in os.walk(source):
+        rel_dir = Path(dirpath).relative_to(source)
+        (destination / rel_dir).mkdir(parents=True, exist_ok=True)
+        # Symlinks to directories are moved like files
+        names = filenames + [d for d in dirnames if (Path(dirpath) / d).is_symlink()]
+        for name in names:
+            target = destination / rel_dir / name
+            if target.exists() or target.is_symlink():
+                continue
+            added_bytes += (Path(dirpath) / name).lstat().st_size
+            os.replace(Path(dirpath) / name, target)
+            added.append((rel_dir / name).as_posix())
+    return added, added_bytes
+
+
 # Convenience function for quick downloads
 def download_toolchain(
     toolchain_name: str,
@@ -0,0 +1,536 @@
+"""
+toolchainkit/toolchain/linker_benchmark.py
+
+Measured linker selection - times ld/gold/lld/mold on a real or synthetic link.
+
+The benchmark links the same set of object files with every available linker
+(and, for parallel linkers, several thread counts) and records the median
+wall-clock time. Results are cached per toolchain fingerprint and host CPU
+count, so the measurement runs once per toolchain and machine.
+
+The link under test is either the project's own final link step (taken from
+``ninja -t commands``) or a synthetic large link: many translation units with
+function sections and debug info, compiled once and reused.
+
+Usage:
+    from toolchainkit.toolchain.linker_benchmark import (
+        LinkerBenchmark, LinkerSelectionCache, select_fastest
+    )
+
+    bench = LinkerBenchmark(Path("/usr/bin/clang++"), work_dir)
+    timings = bench.run(bench.available_linkers(["mold", "lld", "gold", "ld"]))
+    best = select_fastest(timings, allowed={"lld", "mold"})
+    print(best.link_flags())  # ['-fuse-ld=mold', '-Wl,--thread-count=8']
+"""
+
+import hashlib
+import json
+import logging
+import os
+import shlex
+import shutil
+import statistics
+import subprocess
+import time
+from concurrent.futures import ThreadPoolExecutor
+from dataclasses import asdict, dataclass
+from datetime import datetime, timezone
+from pathlib import Path
+from typing import Dict, Iterable, List, Optional, Sequence
+
+from ..core.filesystem import atomic_write
+
+logger = logging.getLogger(__name__)
+
+LINKER_EXECUTABLES: Dict[str, List[str]] = {
+    "ld": ["ld.bfd", "ld"],
+    "gold": ["ld.gold"],
+    "lld": ["ld.lld"],
+    "mold": ["mold", "ld.mold"],
+}
+"""Executable names probed for each linker."""
+
+FUSE_LD_NAMES: Dict[str, str] = {"ld": "bfd"}
+"""``-fuse-ld=`` value when it differs from the linker name."""
+
+THREAD_FLAGS: Dict[str, str] = {
+    "lld": "-Wl,--threads={n}",
+    "mold": "-Wl,--thread-count={n}",
+    "gold": "-Wl,--threads,--thread-count={n}",
+}
+"""Driver flag selecting the linker thread count (parallel linkers only)."""
+
+CACHE_VERSION = 1
+
+
+@dataclass
+class LinkerTiming:
+    """Measured link time for one linker/thread-count combination."""
+
+    linker: str
+    """Linker name ('ld', 'gold', 'lld', 'mold')."""
+
+    threads: Optional[int] = None
+    """Thread count passed to the linker (None for the linker default)."""
+
+    seconds: Optional[float] = None
+    """Median link time, or None if the link failed."""
+
+    runs: int = 0
+    """Number of timed runs."""
+
+    error: Optional[str] = None
+    """Failure reason if the link did not succeed."""
+
+    @property
+    def ok(self) -> bool:
+        """Whether the link succeeded."""
+        return self.seconds is not None
+
+    def link_flags(self) -> List[str]:
+        """Driver flags selecting this linker and thread count."""
+        flags = [f"-fuse-ld={FUSE_LD_NAMES.get(self.linker, self.linker)}"]
+        if self.threads is not None and self.linker in THREAD_FLAGS:
+            flags.append(THREAD_FLAGS[self.linker].format(n=self.threads))
+        return flags
+
+    def __str__(self) -> str:
+        """Format as a one-line summary."""
+        threads = f"{self.threads} threads" if self.threads else "default threads"
+        if not self.ok:
+            return f"{self.linker:<5} ({threads}): failed ({self.error})"
+        return f"{self.linker:<5} ({threads}): {self.seconds * 1000:.0f} ms"
+
+
+def find_linker(linker: str, search_dirs: Sequence[Path] = ()) -> Optional[Path]:
+    """
+    Locate a linker executable.
+
+    Args:
+        linker: Linker name ('ld', 'gold', 'lld', 'mold')
+        search_dirs: Directories searched before PATH (e.g., toolchain bin/)
+
+    Returns:
+        Path to the executable, or None if not installed
+    """
+    for exe in LINKER_EXECUTABLES.get(linker, [linker]):
+        for directory in search_dirs:
+            candidate = Path(directory) / exe
+            if candidate.is_file() and os.access(candidate, os.X_OK):
+                return candidate
+        found = shutil.which(exe)
+        if found:
+            return Path(found)
+    return None
+
+
+def thread_candidates(linker: str, cpu_count: int) -> List[Optional[int]]:
+    """
+    Thread counts worth measuring for a linker on this host.
+
+    Args:
+        linker: Linker name
+        cpu_count: Host CPU count
+
+    Returns:
+        [None] (linker default) plus a few explicit counts for parallel linkers
+    """
+    if linker not in THREAD_FLAGS:
+        return [None]
+    counts = {max(1, cpu_count // 4), max(1, cpu_count // 2), max(1, cpu_count)}
+    return [None] + sorted(counts)
+
+
+def toolchain_fingerprint(compiler: Path, linkers: Dict[str, Path]) -> str:
+    """
+    Hash identifying a compiler plus linker installation.
+
+    Uses resolved paths, sizes and modification times, so upgrading or
+    installing any tool produces a new fingerprint without hashing binaries.
+
+    Args:
+        compiler: Compiler driver path
+        linkers: Linker name to executable path
+
+    Returns:
+        Hex digest (16 characters)
+    """
+    digest = hashlib.sha256()
+    for name, path in [("compiler", compiler)] + sorted(linkers.items()):
+        resolved = Path(path).resolve()
+        try:
+            st = resolved.stat()
+            ident = f"{name}={resolved}:{st.st_size}:{st.st_mtime_ns}"
+        except OSError:
+            ident = f"{name}={resolved}:missing"
+        digest.update(ident.encode() + b"\n")
+    return digest.hexdigest()[:16]
+
+
+def select_fastest(
+    timings: Iterable[LinkerTiming], allowed: Optional[Iterable[str]] = None
+) -> Optional[LinkerTiming]:
+    """
+    Pick the fastest successful measurement among allowed linkers.
+
+    Args:
+        timings: Benchmark measurements
+        allowed: Linker names permitted by the active layers (None for all)
+
+    Returns:
+        Fastest LinkerTiming, or None if no allowed linker succeeded
+    """
+    allowed_set = set(allowed) if allowed is not None else None
+    candidates = [
+        t for t in timings if t.ok and (allowed_set is None or t.linker in allowed_set)
+    ]
+    if not candidates:
+        return None
+    return min(candidates, key=lambda t: t.seconds)
+
+
+def link_command_from_ninja(build_dir: Path, target: str) -> Optional[List[str]]:
+    """
+    Extract the final link command of a target from a Ninja build.
+
+    Args:
+        build_dir: Configured Ninja build directory
+        target: Link target (e.g., 'bin/app')
+
+    Returns:
+        Link command as an argument list, or None if unavailable
+    """
+    try:
+        result = subprocess.run(
+            ["ninja", "-C", str(build_dir), "-t", "commands", target],
+            capture_output=True,
+            text=True,
+            timeout=60,
+        )
+    except (OSError, subprocess.TimeoutExpired) as e:
+        logger.debug(f"ninja -t commands failed: {e}")
+        return None
+    lines = [line for line in result.stdout.splitlines() if line.strip()]
+    if result.returncode != 0 or not lines:
+        return None
+    # The last command builds the target itself; drop a leading "cd dir &&"
+    command = lines[-1].split(" && ")[-1]
+    return shlex.split(command)
+
+
+def synthetic_unit_source(unit: int, units: int, functions: int) -> str:
+    """
+    C++ source for one translation unit of the synthetic link.
+
+    Args:
+        unit: Unit index (0 is main, calling every other unit)
+        units: Number of non-main units
+        functions: Functions per unit
+
+    Returns:
+        Source text
+    """
+    if unit == 0:
+        decls = "\n".join(f"int entry{u}(int);" for u in range(1, units + 1))
+        calls = " + ".join(f"entry{u}(argc)" for u in range(1, units + 1))
+        return f"{decls}\nint main(int argc, char**) {{ return ({calls}) & 1; }}\n"
+
+    n = functions
+    # No headers: keep compile time low while producing many sections,
+    # symbols, relocations, template instantiations and debug info
+    lines = [
+        f"namespace u{unit} {{",
+        "template <int N> struct Node { const char* name; int v = N; };",
+    ]
+    for i in range(n):
+        lines.append(f"int f{i}(int x);")
+    for i in range(n):
+        callee = (i * 7 + 1) % n
+        lines.append(
+            f'int f{i}(int x) {{ static Node<{i % 16}> node{{"u{unit}f{i}"}}; '
+            f"return x > {i} ? f{callee}(x - 1) + node.v + node.name[0] : x; }}"
+        )
+    lines.append("}")
+    lines.append(f"int entry{unit}(int x) {{ return u{unit}::f0(x); }}")
+    return "\n".join(lines) + "\n"
+
+
+class LinkerBenchmark:
+    """
+    Time a link step with each available linker.
+
+    Example:
+        >>> bench = LinkerBenchmark(Path("/usr/bin/g++"), Path("/tmp/linkbench"))
+        >>> timings = bench.run(bench.available_linkers(["gold", "ld"]))
+    """
+
+    def __init__(
+        self,
+        compiler: Path,
+        work_dir: Path,
+        units: int = 32,
+        functions: int = 300,
+        repeats: int = 3,
+        link_command: Optional[List[str]] = None,
+        link_cwd: Optional[Path] = None,
+        search_dirs: Sequence[Path] = (),
+        timeout: float = 300.0,
+    ):
+        """
+        Initialize linker benchmark.
+
+        Args:
+            compiler: C++ compiler driver used to link
+            work_dir: Scratch directory for synthetic objects and outputs
+            units: Synthetic translation units
+            functions: Functions per synthetic translation unit
+            repeats: Timed runs per configuration (median is reported)
+            link_command: Project link command to replay instead of the
+                synthetic link (e.g., from link_command_from_ninja)
+            link_cwd: Working directory for link_command
+            search_dirs: Directories searched for linkers before PATH
+            timeout: Per-link timeout in seconds
+        """
+        self.compiler = Path(compiler)
+        self.work_dir = Path(work_dir)
+        self.units = units
+        self.functions = functions
+        self.repeats = max(1, repeats)
+        self.link_command = link_command
+        self.link_cwd = link_cwd
+        self.search_dirs = list(search_dirs)
+        self.timeout = timeout
+        self._objects: Optional[List[Path]] = None
+
+    def available_linkers(self, names: Iterable[str]) -> Dict[str, Path]:
+        """Map each installed linker among names to its executable."""
+        found = {}
+        for name in names:
+            path = find_linker(name, self.search_dirs)
+            if path:
+                found[name] = path
+        return found
+
+    def prepare(self) -> List[Path]:
+        """
+        Generate and compile the synthetic link inputs (once).
+
+        Returns:
+            Object files to link
+
+        Raises:
+            RuntimeError: If compilation fails
+        """
+        if self._objects is not None:
+            return self._objects
+
+        src_dir = self.work_dir / "src"
+        obj_dir = self.work_dir / "obj"
+        src_dir.mkdir(parents=True, exist_ok=True)
+        obj_dir.mkdir(parents=True, exist_ok=True)
+
+        def compile_unit(unit: int) -> Path:
+            source = src_dir / f"unit{unit}.cpp"
+            obj = obj_dir / f"unit{unit}.o"
+            if obj.exists():
+                return obj
+            source.write_text(self._unit_source(unit))
+            tmp_obj = obj.with_suffix(".o.tmp")
+            result = subprocess.run(
+                [
+                    str(self.compiler),
+                    "-c",
+                    "-O0",
+                    "-g",
+                    "-ffunction-sections",
+                    "-fdata-sections",
+                    str(source),
+                    "-o",
+                    str(tmp_obj),
+                ],
+                capture_output=True,
+                text=True,
+                timeout=self.timeout,
+            )
+            if result.returncode != 0:
+                raise RuntimeError(
+                    f"Failed to compile synthetic link input: {result.stderr.strip()}"
+                )
+            tmp_obj.replace(obj)
+            return obj
+
+        with ThreadPoolExecutor(max_workers=os.cpu_count() or 1) as pool:
+            objects = list(pool.map(compile_unit, range(self.units + 1)))
+
+        self._objects = objects
+        return objects
+
+    def _unit_source(self, unit: int) -> str:
+        """C++ source for one synthetic translation unit (unit 0 is main)."""
+        return synthetic_unit_source(unit, self.units, self.functions)
+
+    def _command(self, timing: LinkerTiming, output: Path) -> List[str]:
+        """Build the link command for one configuration."""
+        if self.link_command:
+            command = [
+                arg
+                for arg in self.link_command
+                if not arg.startswith("-fuse-ld=")
+                and not arg.startswith(("-Wl,--threads", "-Wl,--thread-count"))
+            ]
+            # Never overwrite the project's own output
+            if "-o" in command:
+                command[command.index("-o") + 1] = str(output)
+            return command + timing.link_flags()
+
+        objects = [str(obj) for obj in self.prepare()]
+        return (
+            [str(self.compiler)] + objects + ["-o", str(output)] + timing.link_flags()
+        )
+
+    def measure(self, linker: str, threads: Optional[int] = None) -> LinkerTiming:
+        """
+        Time one linker/thread-count configuration.
+
+        One untimed warm-up link primes the page cache, then ``repeats``
+        timed links are run and the median is reported.
+
+        Args:
+            linker: Linker name
+            threads: Thread count (None for the linker default)
+
+        Returns:
+            LinkerTiming (``seconds`` is None if linking failed)
+        """
+        timing = LinkerTiming(linker=linker, threads=threads)
+        suffix = f"{linker}-{threads or 'default'}"
+        output = self.work_dir / f"bench-{suffix}.out"
+        try:
+            command = self._command(timing, output)
+        except (RuntimeError, OSError, subprocess.TimeoutExpired) as e:
+            timing.error = str(e)
+            return timing
+
+        samples = []
+        for run in range(self.repeats + 1):
+            start = time.perf_counter()
+            try:
+                result = subprocess.run(
+                    command,
+                    cwd=self.link_cwd,
+                    capture_output=True,
+                    text=True,
+                    timeout=self.timeout,
+                )
+            except (OSError, subprocess.TimeoutExpired) as e:
+                timing.error = str(e)
+                return timing
+            elapsed = time.perf_counter() - start
+            if result.returncode != 0:
+                last = (result.stderr.strip().splitlines() or ["link failed"])[-1]
+                timing.error = last
+                return timing
+            if run > 0:
+                samples.append(elapsed)
+
+        output.unlink(missing_ok=True)
+        timing.seconds = statistics.median(samples)
+        timing.runs = len(samples)
+        return timing
+
+    def run(
+        self, linkers: Dict[str, Path], cpu_count: Optional[int] = None
+    ) -> List[LinkerTiming]:
+        """
+        Measure every linker at each candidate thread count.
+
+        Args:
+            linkers: Linker name to executable (see available_linkers)
+            cpu_count: Host CPU count (default: os.cpu_count())
+
+        Returns:
+            All measurements, including failed ones
+        """
+        cpus = cpu_count or os.cpu_count() or 1
+        self.work_dir.mkdir(parents=True, exist_ok=True)
+        timings = []
+        for linker in linkers:
+            for threads in thread_candidates(linker, cpus):
+                timing = self.measure(linker, threads)
+                logger.info(f"Linker benchmark: {timing}")
+                timings.append(timing)
+        return timings
+
+
+class LinkerSelectionCache:
+    """
+    JSON cache of linker measurements keyed by toolchain and CPU count.
+
+    Example:
+        >>> cache = LinkerSelectionCache(get_global_cache_dir() / "linker-benchmark.json")
+        >>> timings = cache.get(fingerprint, os.cpu_count())
+    """
+
+    def __init__(self, path: Path):
+        """
+        Initialize cache.
+
+        Args:
+            path: JSON file holding all cached measurements
+        """
+        self.path = Path(path)
+
+    @staticmethod
+    def key(fingerprint: str, cpu_count: int) -> str:
+        """Cache key for a toolchain fingerprint on a host."""
+        return f"{fingerprint}-cpu{cpu_count}"
+
+    def _load(self) -> Dict:
+        try:
+            data = json.loads(self.path.read_text(encoding="utf-8"))
+        except (OSError, ValueError):
+            return {"version": CACHE_VERSION, "entries": {}}
+        if data.get("version") != CACHE_VERSION:
+            return {"version": CACHE_VERSION, "entries": {}}
+        return data
+
+    def get(self, fingerprint: str, cpu_count: int) -> Optional[List[LinkerTiming]]:
+        """
+        Look up cached measurements.
+
+        Args:
+            fingerprint: Toolchain fingerprint
+            cpu_count: Host CPU count
+
+        Returns:
+            Cached timings, or None if not measured yet
+        """
+        entry = self._load()["entries"].get(self.key(fingerprint, cpu_count))
+        if not entry:
+            return None
+        return [LinkerTiming(**t) for t in entry["timings"]]
+
+    def put(
+        self,
+        fingerprint: str,
+        cpu_count: int,
+        timings: List[LinkerTiming],
+        compiler: Optional[Path] = None,
+    ) -> None:
+        """
+        Store measurements.
+
+        Args:
+            fingerprint: Toolchain fingerprint
+            cpu_count: Host CPU count
+            timings: Measurements to store
+            compiler: Compiler path (informational)
+        """
+        data = self._load()
+        data["entries"][self.key(fingerprint, cpu_count)] = {
+            "measured": datetime.now(timezone.utc).isoformat(),
+            "compiler": str(compiler) if compiler else None,
+            "cpu_count": cpu_count,
+            "timings": [asdict(t) for t in timings],
+        }
+        atomic_write(self.path, json.dumps(data, indent=2))
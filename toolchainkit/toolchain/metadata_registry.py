@@ -12,6 +12,7 @@ from pathlib import Path
 from typing import Optional, List, Dict, Any
 import logging
 
+from toolchainkit.core.filecache import load_cached
 from toolchainkit.core.exceptions import (
     ToolchainRegistryError,
     InvalidVersionError,
@@ -20,6 +21,12 @@ from toolchainkit.core.exceptions import (
 logger = logging.getLogger(__name__)
 
 
+def _parse_json(path: Path) -> Dict[str, Any]:
+    """Parse a JSON metadata file."""
+    with open(path, "r", encoding="utf-8") as f:
+        return json.load(f)
+
+
 @dataclass
 class ToolchainMetadata:
     """Metadata for a specific toolchain version/platform combination."""
@@ -39,6 +46,18 @@ class ToolchainMetadata:
     requires_installer: bool = False
     """Whether this is an installer executable (e.g., MSVC)"""
 
+    mirrors: List[str] = field(default_factory=list)
+    """Alternative download URLs of the same archive"""
+
+    deltas: Dict[str, Dict[str, Any]] = field(default_factory=dict)
+    """Delta patches by base version: {"18.1.7": {"url": ..., "sha256": ...}}"""
+
+    components: Dict[str, List[str]] = field(default_factory=dict)
+    """Selectable parts of the archive: component name -> path globs"""
+
+    profiles: Dict[str, List[str]] = field(default_factory=dict)
+    """Named component sets (e.g. "minimal")"""
+
     def __post_init__(self):
         """Validate metadata after initialization."""
         if not self.url:
@@ -101,8 +120,7 @@ class ToolchainMetadataRegistry:
             )
 
         try:
-            with open(self.metadata_path, "r", encoding="utf-8") as f:
-                data = json.load(f)
+            data = load_cached(self.metadata_path, _parse_json)
         except json.JSONDecodeError as e:
             raise ToolchainRegistryError(
                 f"Invalid JSON in metadata file: {e}\n" f"File: {self.metadata_path}"
@@ -182,6 +200,10 @@ class ToolchainMetadataRegistry:
                 size_mb=data["size_mb"],
                 stdlib=data.get("stdlib", []),
                 requires_installer=data.get("requires_installer", False),
+                mirrors=data.get("mirrors", []),
+                deltas=data.get("deltas", {}),
+                components={**tc.get("components", {}), **data.get("components", {})},
+                profiles={**tc.get("profiles", {}), **data.get("profiles", {})},
             )
         except (KeyError, ValueError) as e:
             raise ToolchainRegistryError(
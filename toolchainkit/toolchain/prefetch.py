@@ -0,0 +1,705 @@
+"""
+Lock file driven prefetch and offline bundles.
+
+``prefetch_from_lock`` downloads every toolchain, build tool and sysroot
+pinned in ``toolchainkit.lock`` into the global cache, concurrently, so a CI
+job pays for all downloads at once instead of one after another during
+configure.
+
+``export_bundle`` packs the installed components of a lock file into one
+offline bundle (``core.bundle``), and ``import_bundle`` unpacks a bundle
+straight into the cache on an air-gapped or fresh machine. Import never
+downloads or extracts archives: files are unpacked in parallel, checked
+against the SHA256 recorded at export, and every unpacked tree must match
+the tree digest pinned in the lock file. The bundle itself is not trusted;
+``pin_tree_digests`` records those digests from the installed components.
+
+Example:
+    >>> from toolchainkit.config.lockfile import LockFileManager
+    >>> from toolchainkit.toolchain.prefetch import export_bundle, import_bundle
+    >>> lock = LockFileManager(project_root).load()
+    >>> prefetch_from_lock(lock)                    # online machine
+    >>> pin_tree_digests(lock)
+    >>> export_bundle(lock, Path("deps.tkb"))
+    >>> import_bundle(Path("deps.tkb"), lock)      # offline machine
+"""
+
+import logging
+import os
+import time
+from concurrent.futures import ThreadPoolExecutor
+from dataclasses import dataclass
+from pathlib import Path
+from typing import Callable, Dict, List, Optional, Tuple
+
+from toolchainkit.config.lockfile import LockedComponent, LockFile
+from toolchainkit.core.bundle import (
+    BundleComponent,
+    BundleError,
+    BundleReader,
+    BundleWriter,
+)
+from toolchainkit.core.directory import get_global_cache_dir
+from toolchainkit.core.filesystem import is_relative_to, safe_rmtree
+from toolchainkit.core.manifest import (
+    _LINK_PREFIX,
+    IntegrityManifest,
+    ManifestEntry,
+    ManifestError,
+    find_manifest,
+    tree_digest,
+)
+from toolchainkit.core.platform import PlatformInfo, detect_platform
+
+logger = logging.getLogger(__name__)
+
+DEFAULT_WORKERS = 4
+"""Concurrent component downloads."""
+
+
+@dataclass
+class FetchResult:
+    """Outcome of fetching or importing one locked component."""
+
+    kind: str
+    """'toolchain', 'tool' or 'sysroot'."""
+
+    name: str
+    success: bool
+    path: Optional[Path] = None
+    error: Optional[str] = None
+    cached: bool = False
+    """Already present in the cache; nothing was downloaded or unpacked."""
+
+    seconds: float = 0.0
+
+
+def _clean_hash(value: str) -> str:
+    """Lock file hash without 'sha256:' prefix, lower case."""
+    return (value or "").replace("sha256:", "").lower()
+
+
+def _locked_components(lock: LockFile) -> List[Tuple[str, str, LockedComponent]]:
+    """(kind, name, component) of every component in a lock file."""
+    return (
+        [("toolchain", name, c) for name, c in lock.toolchains.items()]
+        + [("tool", name, c) for name, c in lock.build_tools.items()]
+        + [("sysroot", name, c) for name, c in lock.sysroots.items()]
+    )
+
+
+def _sysroot_dir(cache_dir: Path, name: str, component: LockedComponent) -> Path:
+    """Install directory of a locked sysroot (as used by SysrootManager)."""
+    return cache_dir / "sysroots" / f"{name}-{component.version}"
+
+
+def _locate_tool(
+    name: str, tools_dir: Path, platform: PlatformInfo
+) -> Optional[Tuple[Path, Path]]:
+    """
+    Find an installed build tool.
+
+    Returns:
+        (install directory or file, executable), or None if not installed
+    """
+    from toolchainkit.packages.tool_installer import TOOL_SPECS, tool_executable
+
+    spec = TOOL_SPECS.get(name)
+    if spec is not None:
+        executable = tool_executable(spec.create(tools_dir, platform))
+        if executable is not None and executable.exists():
+            manifest = find_manifest(executable, stop_at=tools_dir)
+            return (manifest.root if manifest else executable.parent), executable
+
+    # Single executables placed directly in the tools directory
+    single = tools_dir / (f"{name}.exe" if os.name == "nt" else name)
+    if single.is_file():
+        return single, single
+    return None
+
+
+def _tool_hash_error(name: str, actual: str, expected: str) -> Optional[str]:
+    """Error message if a tool's executable hash differs from the lock file."""
+    if _clean_hash(actual) == _clean_hash(expected):
+        return None
+    return (
+        f"Build tool hash mismatch: {name} (expected {expected}, got sha256:{actual})"
+    )
+
+
+# ----------------------------------------------------------------------
+# Prefetch
+# ----------------------------------------------------------------------
+
+
+def prefetch_from_lock(
+    lock: LockFile,
+    cache_dir: Optional[Path] = None,
+    platform: Optional[PlatformInfo] = None,
+    workers: int = DEFAULT_WORKERS,
+    force: bool = False,
+    progress_callback: Optional[Callable[[FetchResult], None]] = None,
+) -> List[FetchResult]:
+    """
+    Download every component pinned in a lock file into the cache.
+
+    Toolchains and sysroots are downloaded from their locked URL and checked
+    against the locked archive hash; build tools are installed with
+    ``ToolInstaller`` and their executable checked against the locked hash.
+    All components download concurrently.
+
+    Args:
+        lock: Lock file
+        cache_dir: Global cache directory (default: get_global_cache_dir())
+        platform: Platform information (auto-detected if None)
+        workers: Concurrent downloads
+        force: Re-download components that are already cached
+        progress_callback: Called with each FetchResult
+
+    Returns:
+        One FetchResult per locked component (toolchains, tools, sysroots)
+    """
+    cache_dir = Path(cache_dir) if cache_dir else get_global_cache_dir()
+    platform = platform or detect_platform()
+
+    jobs: List[Callable[[], List[FetchResult]]] = []
+    for name, component in lock.toolchains.items():
+        jobs.append(
+            lambda n=name, c=component: [_fetch_toolchain(cache_dir, n, c, force)]
+        )
+    if lock.build_tools:
+        jobs.append(
+            lambda: _fetch_tools(cache_dir, lock.build_tools, platform, workers)
+        )
+    for name, component in lock.sysroots.items():
+        jobs.append(
+            lambda n=name, c=component: [_fetch_sysroot(cache_dir, n, c, force)]
+        )
+
+    results: List[FetchResult] = []
+    with ThreadPoolExecutor(max_workers=max(1, workers)) as pool:
+        for batch in pool.map(lambda job: job(), jobs):
+            for result in batch:
+                if progress_callback:
+                    progress_callback(result)
+                results.append(result)
+
+    order = {
+        (kind, name): i for i, (kind, name, _) in enumerate(_locked_components(lock))
+    }
+    return sorted(results, key=lambda r: order.get((r.kind, r.name), len(order)))
+
+
+def _fetch_toolchain(
+    cache_dir: Path, toolchain_id: str, component: LockedComponent, force: bool
+) -> FetchResult:
+    """Download one locked toolchain (runs on a pool thread)."""
+    from toolchainkit.toolchain.downloader import ToolchainDownloader
+
+    start = time.perf_counter()
+    try:
+        result = ToolchainDownloader(cache_dir=cache_dir).download_locked(
+            toolchain_id,
+            url=component.url,
+            sha256=component.sha256,
+            size_bytes=component.size_bytes,
+            force=force,
+        )
+        return FetchResult(
+            "toolchain",
+            toolchain_id,
+            True,
+            path=result.toolchain_path,
+            cached=result.was_cached,
+            seconds=time.perf_counter() - start,
+        )
+    except Exception as e:
+        logger.error(f"Failed to fetch toolchain {toolchain_id}: {e}")
+        return FetchResult(
+            "toolchain",
+            toolchain_id,
+            False,
+            error=str(e),
+            seconds=time.perf_counter() - start,
+        )
+
+
+def _fetch_sysroot(
+    cache_dir: Path, name: str, component: LockedComponent, force: bool
+) -> FetchResult:
+    """Download one locked sysroot (runs on a pool thread)."""
+    from toolchainkit.cross.sysroot import SysrootManager, SysrootSpec
+
+    start = time.perf_counter()
+    if not component.version:
+        return FetchResult(
+            "sysroot", name, False, error="Locked sysroot has no version"
+        )
+    cached = _sysroot_dir(cache_dir, name, component).exists() and not force
+    try:
+        path = SysrootManager(cache_dir).download_sysroot(
+            SysrootSpec(
+                target=name,
+                version=component.version,
+                url=component.url,
+                hash=_clean_hash(component.sha256),
+            ),
+            force=force,
+        )
+        return FetchResult(
+            "sysroot",
+            name,
+            True,
+            path=path,
+            cached=cached,
+            seconds=time.perf_counter() - start,
+        )
+    except Exception as e:
+        logger.error(f"Failed to fetch sysroot {name}: {e}")
+        return FetchResult(
+            "sysroot", name, False, error=str(e), seconds=time.perf_counter() - start
+        )
+
+
+def _fetch_tools(
+    cache_dir: Path,
+    tools: Dict[str, LockedComponent],
+    platform: PlatformInfo,
+    workers: int,
+) -> List[FetchResult]:
+    """Install locked build tools concurrently and check their hashes."""
+    from toolchainkit.core.hashing import hash_file
+    from toolchainkit.packages.tool_installer import TOOL_SPECS, ToolInstaller
+
+    tools_dir = cache_dir / "tools"
+    known = [name for name in tools if name in TOOL_SPECS]
+    results = [
+        FetchResult("tool", name, False, error=f"No downloader for build tool: {name}")
+        for name in tools
+        if name not in TOOL_SPECS
+    ]
+    if not known:
+        return results
+
+    installed = ToolInstaller(tools_dir, platform, max_workers=workers).install(known)
+    for name in known:
+        outcome = installed[name]
+        result = FetchResult(
+            "tool",
+            name,
+            outcome.success,
+            path=outcome.path,
+            error=outcome.error,
+            cached=outcome.already_installed,
+            seconds=outcome.seconds,
+        )
+        if outcome.success and outcome.path is not None:
+            manifest = find_manifest(outcome.path, stop_at=tools_dir)
+            actual = (
+                manifest.file_hash(outcome.path) if manifest else None
+            ) or hash_file(outcome.path)
+            error = _tool_hash_error(name, actual, tools[name].sha256)
+            if error:
+                result.success, result.error = False, error
+        results.append(result)
+    return results
+
+
+# ----------------------------------------------------------------------
+# Bundles
+# ----------------------------------------------------------------------
+
+
+def _installed_digest(
+    source: Path, kind: str, name: str, component: LockedComponent, pin: bool
+) -> str:
+    """
+    Tree digest of an installed component, checked against its manifest.
+
+    Single-file tools are checked against their locked hash instead.
+
+    Args:
+        source: Installed directory or file
+        kind: Component kind
+        name: Component name
+        component: Locked component
+        pin: Re-hash every file, and write a manifest for trees without one
+
+    Returns:
+        Hex tree digest (see core.manifest.tree_digest)
+
+    Raises:
+        BundleError: If the installation changed or has no manifest
+    """
+    if source.is_file():
+        from toolchainkit.core.hashing import hash_file
+
+        actual = hash_file(source)
+        error = _tool_hash_error(name, actual, component.sha256)
+        if error:
+            raise BundleError(error)
+        return tree_digest({source.name: actual})
+
+    try:
+        manifest = IntegrityManifest.load(source)
+        if manifest is None:
+            if not pin:
+                raise BundleError(f"{kind} {name} has no integrity manifest")
+            manifest = IntegrityManifest.create(source)
+            manifest.save()
+            return manifest.digest()
+    except ManifestError as e:
+        raise BundleError(str(e)) from e
+
+    result = manifest.verify(deep=pin)
+    if not result.ok:
+        raise BundleError(
+            f"{kind} {name} changed since it was installed: {result.summary()}"
+        )
+    return manifest.digest()
+
+
+def pin_tree_digests(
+    lock: LockFile,
+    cache_dir: Optional[Path] = None,
+    platform: Optional[PlatformInfo] = None,
+) -> List[FetchResult]:
+    """
+    Record the tree digest of every installed locked component in the lock.
+
+    Installed files are re-hashed and checked against their integrity
+    manifest first; sysroots, which are installed without one, get a
+    manifest now. Save the lock file afterwards so that bundle imports can
+    verify what they unpack.
+
+    Args:
+        lock: Lock file (updated in place)
+        cache_dir: Global cache directory (default: get_global_cache_dir())
+        platform: Platform information (auto-detected if None)
+
+    Returns:
+        One FetchResult per locked component
+    """
+    cache_dir = Path(cache_dir) if cache_dir else get_global_cache_dir()
+    platform = platform or detect_platform()
+
+    results = []
+    for kind, name, component in _locked_components(lock):
+        start = time.perf_counter()
+        source, _ = _export_source(cache_dir, kind, name, component, platform)
+        if source is None or not is_relative_to(source, cache_dir):
+            results.append(FetchResult(kind, name, False, error="Not installed"))
+            continue
+        try:
+            digest = _installed_digest(source, kind, name, component, pin=True)
+        except (BundleError, OSError) as e:
+            results.append(
+                FetchResult(
+                    kind, name, False, error=str(e), seconds=time.perf_counter() - start
+                )
+            )
+            continue
+        component.tree_sha256 = f"sha256:{digest}"
+        results.append(
+            FetchResult(
+                kind, name, True, path=source, seconds=time.perf_counter() - start
+            )
+        )
+    return results
+
+
+def export_bundle(
+    lock: LockFile,
+    output: Path,
+    cache_dir: Optional[Path] = None,
+    platform: Optional[PlatformInfo] = None,
+    codec: Optional[str] = None,
+    workers: Optional[int] = None,
+) -> List[BundleComponent]:
+    """
+    Pack the installed components of a lock file into an offline bundle.
+
+    Every component must have a tree digest in the lock file (see
+    pin_tree_digests()) and still match it and its integrity manifest.
+
+    Args:
+        lock: Lock file
+        output: Bundle file to write
+        cache_dir: Global cache directory (default: get_global_cache_dir())
+        platform: Platform information (auto-detected if None)
+        codec: 'zstd' or 'zlib' (default: best available)
+        workers: Compression threads (default: CPU count)
+
+    Returns:
+        Components written to the bundle
+
+    Raises:
+        BundleError: If a locked component is not installed in the cache,
+            is not pinned, or changed since it was installed
+    """
+    cache_dir = Path(cache_dir) if cache_dir else get_global_cache_dir()
+    platform = platform or detect_platform()
+
+    sources = []
+    missing = []
+    unpinned = []
+    for kind, name, component in _locked_components(lock):
+        source, metadata = _export_source(cache_dir, kind, name, component, platform)
+        if source is None or not is_relative_to(source, cache_dir):
+            missing.append(f"{kind} {name}")
+            continue
+        if not component.tree_sha256:
+            unpinned.append(f"{kind} {name}")
+            continue
+        sources.append((kind, name, component, source, metadata))
+    if missing:
+        raise BundleError(
+            f"Not installed in {cache_dir}: {', '.join(missing)}. "
+            f"Run 'tkgen fetch --from-lock' first."
+        )
+    if unpinned:
+        raise BundleError(
+            f"No tree digest in the lock file: {', '.join(unpinned)}. "
+            f"Run 'tkgen bundle pin' first."
+        )
+
+    for kind, name, component, source, _ in sources:
+        digest = _installed_digest(source, kind, name, component, pin=False)
+        if digest != _clean_hash(component.tree_sha256):
+            raise BundleError(
+                f"{kind} {name} does not match the lock file "
+                f"(tree sha256:{digest}, lock file pins {component.tree_sha256})"
+            )
+
+    with BundleWriter(output, codec=codec, workers=workers) as writer:
+        for kind, name, component, source, metadata in sources:
+            root = source if source.is_dir() else source.parent
+            writer.add_tree(
+                kind,
+                name,
+                source,
+                root=root.relative_to(cache_dir).as_posix(),
+                sha256=component.sha256,
+                metadata=metadata,
+            )
+        return list(writer.components)
+
+
+def _export_source(
+    cache_dir: Path,
+    kind: str,
+    name: str,
+    component: LockedComponent,
+    platform: PlatformInfo,
+) -> Tuple[Optional[Path], Dict[str, str]]:
+    """Installed location and bundle metadata of one locked component."""
+    if kind == "toolchain":
+        from toolchainkit.core.cache_registry import ToolchainCacheRegistry
+
+        info = ToolchainCacheRegistry(cache_dir / "registry.json").get_toolchain_info(
+            name
+        )
+        path = Path(info["path"]) if info else cache_dir / "toolchains" / name
+        metadata = {
+            "registry_hash": (info or {}).get("hash")
+            or f"sha256:{_clean_hash(component.sha256)}",
+            "source_url": component.url,
+        }
+        return (path if path.is_dir() else None), metadata
+
+    if kind == "sysroot":
+        path = _sysroot_dir(cache_dir, name, component)
+        return (path if path.is_dir() else None), {}
+
+    located = _locate_tool(name, cache_dir / "tools", platform)
+    if located is None:
+        return None, {}
+    source, executable = located
+    root = source if source.is_dir() else source.parent
+    return source, {"executable": executable.relative_to(root).as_posix()}
+
+
+def import_bundle(
+    bundle_path: Path,
+    lock: Optional[LockFile] = None,
+    cache_dir: Optional[Path] = None,
+    workers: Optional[int] = None,
+    force: bool = False,
+) -> List[FetchResult]:
+    """
+    Unpack an offline bundle into the cache.
+
+    With a lock file, only components pinned in it are imported, and each
+    unpacked tree must match the tree digest in the lock file before it is
+    moved into the cache. Locked components missing from the bundle are
+    reported as failures. Without a lock file, nothing vouches for the
+    bundle and imported toolchains are registered as unverified.
+
+    Args:
+        bundle_path: Bundle file
+        lock: Lock file to verify against (recommended)
+        cache_dir: Global cache directory (default: get_global_cache_dir())
+        workers: Unpacking threads (default: CPU count)
+        force: Replace components that are already in the cache
+
+    Returns:
+        One FetchResult per imported (or expected) component
+
+    Raises:
+        BundleError: If the bundle cannot be read
+    """
+    cache_dir = Path(cache_dir) if cache_dir else get_global_cache_dir()
+    reader = BundleReader(bundle_path)
+
+    expected = {}
+    if lock is not None:
+        expected = {(k, n): c for k, n, c in _locked_components(lock)}
+
+    results = []
+    for component in reader.components:
+        locked = expected.pop((component.kind, component.name), None)
+        if lock is not None and locked is None:
+            logger.info(f"Skipping {component.kind} {component.name}: not in lock file")
+            continue
+        if locked is not None and _clean_hash(locked.sha256) != _clean_hash(
+            component.sha256
+        ):
+            results.append(
+                FetchResult(
+                    component.kind,
+                    component.name,
+                    False,
+                    error=(
+                        f"Bundle has {component.sha256 or 'no hash'}, "
+                        f"lock file pins {locked.sha256}"
+                    ),
+                )
+            )
+            continue
+        if locked is not None and not locked.tree_sha256:
+            results.append(
+                FetchResult(
+                    component.kind,
+                    component.name,
+                    False,
+                    error="Lock file pins no tree digest (run 'tkgen bundle pin')",
+                )
+            )
+            continue
+        results.append(
+            _import_component(reader, component, locked, cache_dir, workers, force)
+        )
+
+    for kind, name in expected:
+        results.append(FetchResult(kind, name, False, error="Not in bundle"))
+    return results
+
+
+def _import_component(
+    reader: BundleReader,
+    component: BundleComponent,
+    locked: Optional[LockedComponent],
+    cache_dir: Path,
+    workers: Optional[int],
+    force: bool,
+) -> FetchResult:
+    """Unpack one component into the cache via a staging directory."""
+    start = time.perf_counter()
+    kind, name = component.kind, component.name
+    destination = cache_dir / component.root
+    if not is_relative_to(destination.resolve(), cache_dir.resolve()):
+        return FetchResult(kind, name, False, error=f"Unsafe root: {component.root}")
+
+    # Single-file tools live directly in a shared directory (e.g. tools/)
+    single_file = kind == "tool" and not component.dirs and len(component.files) == 1
+    target = destination / component.files[0].path if single_file else destination
+    if target.exists() and not force:
+        return FetchResult(kind, name, True, path=target, cached=True)
+
+    staging = destination.parent / f".{destination.name}.import"
+    try:
+        if staging.exists():
+            safe_rmtree(staging, require_prefix=cache_dir)
+        hashes = reader.extract(component, staging, workers=workers)
+
+        executable = component.metadata.get("executable")
+        if kind == "tool" and locked is not None and executable:
+            error = _tool_hash_error(name, hashes.get(executable, ""), locked.sha256)
+            if error:
+                raise BundleError(error)
+        if locked is not None:
+            links = {rel: _LINK_PREFIX + target for rel, target in component.links}
+            digest = tree_digest({**hashes, **links})
+            if digest != _clean_hash(locked.tree_sha256):
+                raise BundleError(
+                    f"Unpacked files do not match the lock file (tree "
+                    f"sha256:{digest}, lock file pins {locked.tree_sha256})"
+                )
+
+        if single_file:
+            destination.mkdir(parents=True, exist_ok=True)
+            os.replace(staging / component.files[0].path, target)
+            safe_rmtree(staging, require_prefix=cache_dir)
+        else:
+            if destination.exists():
+                safe_rmtree(destination, require_prefix=cache_dir)
+            staging.rename(destination)
+            _write_imported_manifest(destination, component, hashes)
+
+        if kind == "toolchain":
+            _register_toolchain(cache_dir, component, locked, destination)
+
+        return FetchResult(
+            kind, name, True, path=target, seconds=time.perf_counter() - start
+        )
+    except (BundleError, OSError) as e:
+        logger.error(f"Failed to import {kind} {name}: {e}")
+        if staging.exists():
+            safe_rmtree(staging, require_prefix=cache_dir)
+        return FetchResult(
+            kind, name, False, error=str(e), seconds=time.perf_counter() - start
+        )
+
+
+def _write_imported_manifest(
+    root: Path, component: BundleComponent, hashes: Dict[str, str]
+) -> None:
+    """Write the integrity manifest from the hashes verified during unpacking."""
+    entries = {}
+    for rel, digest in hashes.items():
+        st = os.stat(root / rel)
+        entries[rel] = ManifestEntry(digest, st.st_size, st.st_mtime_ns)
+    for rel, target in component.links:
+        entries[rel] = ManifestEntry(_LINK_PREFIX + target, 0, 0)
+    IntegrityManifest(root, entries).save()
+
+
+def _register_toolchain(
+    cache_dir: Path,
+    component: BundleComponent,
+    locked: Optional[LockedComponent],
+    path: Path,
+) -> None:
+    """
+    Register an imported toolchain like a downloaded one.
+
+    Only toolchains verified against a lock file are registered as verified,
+    with the lock file's hash; the bundle's own fields are not trusted.
+    """
+    from toolchainkit.core.cache_registry import ToolchainCacheRegistry
+
+    if locked is not None:
+        hash_value = f"sha256:{_clean_hash(locked.sha256)}"
+    else:
+        hash_value = (
+            component.metadata.get("registry_hash")
+            or f"sha256:{_clean_hash(component.sha256)}"
+        )
+    ToolchainCacheRegistry(cache_dir / "registry.json").register_toolchain(
+        toolchain_id=component.name,
+        path=path,
+        size_mb=component.total_size / (1024 * 1024),
+        hash_value=hash_value,
+        source_url=component.metadata.get("source_url", ""),
+        verified=locked is not None,
+    )
@@ -56,9 +56,10 @@ class DownloadToolchainProvider(ToolchainProvider):
         version: str,
         platform: str,
         progress_callback=None,
+        components=None,
         **kwargs,
     ) -> Optional[Path]:
-        """Download and provide toolchain."""
+        """Download and provide toolchain (optionally only some components)."""
         try:
             result = self._downloader.download_toolchain(
                 toolchain_name=toolchain_type,
@@ -66,6 +67,7 @@ class DownloadToolchainProvider(ToolchainProvider):
                 platform=platform,
                 force=False,
                 progress_callback=progress_callback,
+                components=components,
             )
             self._last_result = result
             return result.toolchain_path
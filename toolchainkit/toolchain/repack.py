@@ -0,0 +1,204 @@
+"""
+Seekable re-packs of downloaded toolchain archives.
+
+Toolchain archives are usually ``.tar.xz``: re-creating an installation
+from the downloads cache (after cleanup, with ``force=True``, or when a
+component is added later) decodes the whole archive on one core at LZMA
+speed. With repacking enabled, the downloader transcodes every verified
+archive once into a bundle (see ``toolchainkit.core.bundle``) stored next to
+it as ``<archive>.tkb`` and deletes the original. The bundle holds the
+archive's members as independently compressed frames (zstd when the
+``zstandard`` package is installed, zlib otherwise) with an index, so later
+extractions unpack files in parallel and single files or components can be
+read without decoding the rest.
+
+The archive's SHA256 and URL are kept in the bundle: a re-pack is only used
+for the toolchain whose metadata lists the same hash, and every unpacked
+file is checked against the hash recorded while transcoding.
+
+Enable with ``download.repack: true`` in ``toolchainkit.yaml``,
+``TOOLCHAINKIT_REPACK=1`` or ``set_repack(True)``.
+
+Example:
+    >>> set_repack(True)
+    >>> downloader.download_toolchain("llvm", "18", "linux-x64")  # writes .tkb
+    >>> repacked = open_repacked(archive_path, sha256)
+    >>> repacked.extract(destination)
+"""
+
+import logging
+import os
+import threading
+from pathlib import Path
+from typing import Callable, Dict, Optional
+
+from toolchainkit.core.bundle import (
+    BundleComponent,
+    BundleError,
+    BundleReader,
+    BundleWriter,
+)
+
+logger = logging.getLogger(__name__)
+
+REPACK_ENV = "TOOLCHAINKIT_REPACK"
+"""Environment variable enabling repacking ('1', 'true', 'yes', 'on')."""
+
+REPACK_SUFFIX = ".tkb"
+
+_KIND = "archive"
+
+_repack: Optional[bool] = None
+_repack_lock = threading.Lock()
+
+
+def set_repack(enabled: Optional[bool]) -> None:
+    """
+    Enable or disable repacking for this process (overrides TOOLCHAINKIT_REPACK).
+
+    Args:
+        enabled: True/False, or None to fall back to the environment
+    """
+    global _repack
+    with _repack_lock:
+        _repack = enabled
+
+
+def repack_enabled() -> bool:
+    """Whether downloaded archives are transcoded into seekable bundles."""
+    with _repack_lock:
+        if _repack is not None:
+            return _repack
+    return os.environ.get(REPACK_ENV, "").strip().lower() in ("1", "true", "yes", "on")
+
+
+def repacked_path(archive_path: Path) -> Path:
+    """Location of the re-pack of a downloaded archive."""
+    archive_path = Path(archive_path)
+    return archive_path.with_name(archive_path.name + REPACK_SUFFIX)
+
+
+class RepackedArchive:
+    """A re-packed archive whose provenance matched the expected hash."""
+
+    def __init__(self, reader: BundleReader, component: BundleComponent):
+        self.reader = reader
+        self.component = component
+
+    @property
+    def path(self) -> Path:
+        """Bundle file."""
+        return self.reader.path
+
+    @property
+    def sha256(self) -> str:
+        """SHA256 of the original archive."""
+        return self.component.sha256
+
+    def extract(
+        self,
+        destination: Path,
+        member_filter: Optional[Callable[[str], bool]] = None,
+        progress_callback: Optional[Callable[[int, int], None]] = None,
+        workers: Optional[int] = None,
+    ) -> Dict[str, str]:
+        """
+        Unpack the archive's members in parallel.
+
+        Produces the same tree as extract_archive() on the original.
+
+        Args:
+            destination: Directory to unpack into
+            member_filter: Optional predicate on member names
+            progress_callback: Optional callback(bytes_done, bytes_total)
+            workers: Unpacking threads (default: CPU count)
+
+        Returns:
+            Member name -> SHA256 of every unpacked file
+
+        Raises:
+            BundleError: If a member is corrupt or cannot be written
+        """
+        return self.reader.extract(
+            self.component,
+            destination,
+            workers=workers,
+            member_filter=member_filter,
+            progress_callback=progress_callback,
+        )
+
+    def read(self, member: str) -> bytes:
+        """Read one member without unpacking anything else."""
+        return self.reader.read(self.component, member)
+
+
+def repack_archive(
+    archive_path: Path,
+    sha256: str,
+    url: str = "",
+    workers: Optional[int] = None,
+) -> Path:
+    """
+    Transcode a verified archive into a seekable bundle next to it.
+
+    The original archive is left in place; the caller decides whether to
+    delete it.
+
+    Args:
+        archive_path: Downloaded archive (already checked against sha256)
+        sha256: SHA256 of the archive, recorded for provenance
+        url: Download URL, recorded for provenance
+        workers: Compression threads (default: CPU count)
+
+    Returns:
+        Path of the bundle
+
+    Raises:
+        BundleError: If the archive cannot be transcoded
+    """
+    archive_path = Path(archive_path)
+    destination = repacked_path(archive_path)
+    partial = destination.with_name(destination.name + ".partial")
+    with BundleWriter(partial, workers=workers) as writer:
+        writer.add_archive(
+            _KIND,
+            archive_path.name,
+            archive_path,
+            root=archive_path.name,
+            sha256=sha256.replace("sha256:", ""),
+            metadata={"url": url} if url else None,
+        )
+    os.replace(partial, destination)
+    logger.info(
+        f"Repacked {archive_path.name}: {archive_path.stat().st_size / 1024**2:.1f}"
+        f" -> {destination.stat().st_size / 1024**2:.1f} MB"
+    )
+    return destination
+
+
+def open_repacked(archive_path: Path, sha256: str) -> Optional[RepackedArchive]:
+    """
+    Open the re-pack of an archive if it exists and matches the expected hash.
+
+    Args:
+        archive_path: Path the archive was (or would be) downloaded to
+        sha256: Expected SHA256 of the original archive
+
+    Returns:
+        RepackedArchive, or None if there is no usable re-pack (unreadable
+        bundles and bundles of a different archive are ignored)
+    """
+    path = repacked_path(archive_path)
+    if not path.exists():
+        return None
+    try:
+        reader = BundleReader(path)
+    except BundleError as e:
+        logger.warning(f"Ignoring unreadable re-pack {path}: {e}")
+        return None
+    component = reader.get(Path(archive_path).name, _KIND)
+    expected = sha256.replace("sha256:", "").lower()
+    if component is None or component.sha256.lower() != expected:
+        logger.warning(f"Ignoring re-pack {path}: it is not of the expected archive")
+        return None
+    return RepackedArchive(reader, component)
@@ -9,9 +9,11 @@ verification, and safe replacement of existing installations.
 import logging
 import subprocess
 import sys
-from dataclasses import dataclass
+import time
+from concurrent.futures import ThreadPoolExecutor
+from dataclasses import dataclass, field
 from pathlib import Path
-from typing import Optional, List
+from typing import Any, Dict, Optional, List, Tuple
 import requests
 
 from .metadata_registry import ToolchainMetadataRegistry
@@ -19,11 +21,18 @@ from .downloader import ToolchainDownloader
 from .verifier import ToolchainVerifier, VerificationLevel
 from ..core.cache_registry import ToolchainCacheRegistry
 from ..core.directory import get_global_cache_dir
+from ..core.download import DownloadProgress, progress_listener
 from ..core.locking import LockManager
 from ..core.exceptions import ToolchainMetadataNotFoundError
 
 logger = logging.getLogger(__name__)
 
+DEFAULT_CHECK_WORKERS = 8
+"""Concurrent update checks in upgrade_all_toolchains()."""
+
+DEFAULT_UPGRADE_WORKERS = 3
+"""Concurrent downloads and extractions in upgrade_all_toolchains()."""
+
 
 class UpgradeError(Exception):
     """Base exception for upgrade errors."""
@@ -183,6 +192,9 @@ class UpdateInfo:
     size_mb: int
     """Download size in megabytes"""
 
+    deltas: Dict[str, Dict[str, Any]] = field(default_factory=dict)
+    """Delta patches to the latest version by base version"""
+
 
 @dataclass
 class UpgradeResult:
@@ -203,6 +215,33 @@ class UpgradeResult:
     error: Optional[str] = None
     """Error message if failed"""
 
+    method: str = "full"
+    """How the new version was installed: 'full' or 'delta'"""
+
+    bytes_transferred: int = 0
+    """Bytes downloaded (delta patch and/or full archive)"""
+
+    seconds: float = 0.0
+    """Wall time of the upgrade"""
+
+
+class _TransferCounter:
+    """Sum bytes of every download made by this thread."""
+
+    def __init__(self):
+        self.total = 0
+        self._current = 0
+
+    def __call__(self, progress: DownloadProgress) -> None:
+        if progress.bytes_downloaded < self._current:
+            # A new download started
+            self.total += self._current
+        self._current = progress.bytes_downloaded
+
+    @property
+    def bytes(self) -> int:
+        return self.total + self._current
+
 
 class ToolchainUpgrader:
     """
@@ -313,6 +352,7 @@ class ToolchainUpgrader:
                 download_url=metadata.url,
                 sha256=metadata.sha256,
                 size_mb=metadata.size_mb,
+                deltas=metadata.deltas,
             )
 
         except ToolchainMetadataNotFoundError as e:
@@ -321,15 +361,31 @@ class ToolchainUpgrader:
             raise UpdateCheckError(f"Failed to compare versions: {e}") from e
 
     def upgrade_toolchain(
-        self, toolchain_id: str, force: bool = False, progress_callback=None
+        self,
+        toolchain_id: str,
+        force: bool = False,
+        progress_callback=None,
+        delta: bool = True,
+        update_info: Optional[UpdateInfo] = None,
+        registry_updates: Optional[List[Tuple[str, str]]] = None,
     ) -> UpgradeResult:
         """
         Upgrade a specific toolchain to latest version.
 
+        When the metadata offers a delta patch from the installed version,
+        the new version is built from the installed tree and the patch; if
+        that fails or the result does not verify, the full archive is
+        downloaded instead.
+
         Args:
             toolchain_id: Toolchain to upgrade (e.g., "llvm-18.1.8-linux-x64")
             force: Force re-download even if already latest
             progress_callback: Optional progress callback function
+            delta: Use a delta patch when one is available
+            update_info: Result of check_for_updates() if already known
+            registry_updates: If given, the (old ID, new ID) pair is appended
+                here instead of moving project references and removing the
+                old version; pass the list to commit_upgrades() later
 
         Returns:
             UpgradeResult with upgrade details
@@ -353,10 +409,12 @@ class ToolchainUpgrader:
         toolchain_type = parts[0]
         current_version = parts[1]
         platform = "-".join(parts[2:])
+        start = time.perf_counter()
+        transferred = _TransferCounter()
 
         try:
             # Check for updates
-            if not force:
+            if update_info is None and not force:
                 update_info = self.check_for_updates(toolchain_id)
                 if not update_info:
                     logger.info(f"{toolchain_id} is already up to date")
@@ -366,7 +424,7 @@ class ToolchainUpgrader:
                         new_version=current_version,
                         success=True,
                     )
-            else:
+            elif update_info is None:
                 # Force upgrade - get latest version
                 versions = self.metadata_registry.list_versions(toolchain_type)
                 if not versions:
@@ -396,29 +454,43 @@ class ToolchainUpgrader:
                     download_url=metadata.url,
                     sha256=metadata.sha256,
                     size_mb=metadata.size_mb,
+                    deltas=metadata.deltas,
                 )
 
             new_toolchain_id = (
                 f"{toolchain_type}-{update_info.latest_version}-{platform}"
             )
 
-            # Download and install new version
-            logger.info(f"Downloading {new_toolchain_id}...")
-            toolchain_path = self.downloader.download_and_install(
-                toolchain_id=new_toolchain_id,
-                url=update_info.download_url,
-                checksum=f"sha256:{update_info.sha256}",
-                progress_callback=progress_callback,
-            )
+            with progress_listener(transferred):
+                toolchain_path, method = self._install_update(
+                    toolchain_id,
+                    new_toolchain_id,
+                    update_info,
+                    progress_callback,
+                    delta,
+                )
 
-            # Verify new installation
-            logger.info(f"Verifying {new_toolchain_id}...")
-            verification = self.verifier.verify(
-                toolchain_path=toolchain_path,
-                toolchain_type=toolchain_type,
-                expected_version=update_info.latest_version,
-                level=VerificationLevel.STANDARD,
-            )
+                # Verify new installation
+                logger.info(f"Verifying {new_toolchain_id}...")
+                verification = self._verify(toolchain_path, toolchain_type, update_info)
+                if not verification.success and method == "delta":
+                    logger.warning(
+                        f"{new_toolchain_id} built from delta failed verification, "
+                        "downloading the full archive"
+                    )
+                    from ..core.filesystem import safe_rmtree
+
+                    safe_rmtree(toolchain_path, require_prefix=get_global_cache_dir())
+                    toolchain_path, method = self._install_update(
+                        toolchain_id,
+                        new_toolchain_id,
+                        update_info,
+                        progress_callback,
+                        delta=False,
+                    )
+                    verification = self._verify(
+                        toolchain_path, toolchain_type, update_info
+                    )
 
             if not verification.success:
                 raise UpgradeError(
@@ -426,38 +498,25 @@ class ToolchainUpgrader:
                     f"Issues: {', '.join(verification.issues)}"
                 )
 
-            # Get project references from old toolchain
-            with self.cache_registry.lock():
-                old_info = self.cache_registry.get_toolchain_info(toolchain_id)
-                if old_info:
-                    # Transfer references to new toolchain
-                    new_info = self.cache_registry.get_toolchain_info(new_toolchain_id)
-                    if new_info and old_info.get("projects"):
-                        for project_path in old_info["projects"]:
-                            self.cache_registry.add_project_reference(
-                                toolchain_id=new_toolchain_id,
-                                project_path=Path(project_path),
-                            )
-
-                    # Remove old toolchain if no longer referenced
-                    if not old_info.get("projects"):
-                        logger.info(f"Removing old version: {toolchain_id}")
-                        self.cache_registry.unregister_toolchain(toolchain_id)
-
-                        # Delete old toolchain directory
-                        old_path = Path(old_info["path"])
-                        if old_path.exists():
-                            from ..core.filesystem import safe_rmtree
-
-                            safe_rmtree(old_path, require_prefix=get_global_cache_dir())
-
-            logger.info(f"Successfully upgraded to {new_toolchain_id}")
+            if registry_updates is not None:
+                registry_updates.append((toolchain_id, new_toolchain_id))
+            else:
+                self.commit_upgrades([(toolchain_id, new_toolchain_id)])
+
+            seconds = time.perf_counter() - start
+            logger.info(
+                f"Successfully upgraded to {new_toolchain_id} ({method}, "
+                f"{transferred.bytes / 1024**2:.1f} MB in {seconds:.1f}s)"
+            )
 
             return UpgradeResult(
                 toolchain_id=toolchain_id,
                 old_version=current_version,
                 new_version=update_info.latest_version,
                 success=True,
+                method=method,
+                bytes_transferred=transferred.bytes,
+                seconds=seconds,
             )
 
         except Exception as e:
@@ -469,20 +528,212 @@ class ToolchainUpgrader:
                 new_version="unknown",
                 success=False,
                 error=error_msg,
+                bytes_transferred=transferred.bytes,
+                seconds=time.perf_counter() - start,
             )
 
+    def commit_upgrades(self, upgrades: List[Tuple[str, str]]) -> List[str]:
+        """
+        Move project references to new versions and remove old versions.
+
+        All registry changes are made in one transaction; old directories
+        are deleted after it is written.
+
+        Args:
+            upgrades: (old toolchain ID, new toolchain ID) pairs
+
+        Returns:
+            Old toolchain IDs that were removed (unreferenced ones)
+        """
+        removed = []
+        old_paths = []
+        with self.cache_registry.transaction():
+            for toolchain_id, new_toolchain_id in upgrades:
+                old_info = self.cache_registry.get_toolchain_info(toolchain_id)
+                if not old_info:
+                    continue
+
+                # Transfer references to new toolchain
+                new_info = self.cache_registry.get_toolchain_info(new_toolchain_id)
+                if new_info and old_info.get("projects"):
+                    for project_path in old_info["projects"]:
+                        self.cache_registry.add_project_reference(
+                            toolchain_id=new_toolchain_id,
+                            project_path=Path(project_path),
+                        )
+
+                # Remove old toolchain if no longer referenced
+                if not old_info.get("projects"):
+                    logger.info(f"Removing old version: {toolchain_id}")
+                    self.cache_registry.unregister_toolchain(toolchain_id)
+                    removed.append(toolchain_id)
+                    old_paths.append(Path(old_info["path"]))
+
+        # Delete old toolchain directories
+        for old_path in old_paths:
+            if old_path.exists():
+                from ..core.filesystem import safe_rmtree
+
+                safe_rmtree(old_path, require_prefix=get_global_cache_dir())
+        return removed
+
+    def _install_update(
+        self,
+        toolchain_id: str,
+        new_toolchain_id: str,
+        update_info: UpdateInfo,
+        progress_callback,
+        delta: bool,
+    ) -> tuple[Path, str]:
+        """
+        Install the new version, from a delta patch if possible.
+
+        Returns:
+            (installed path, 'delta' or 'full')
+        """
+        patch = update_info.deltas.get(update_info.current_version) if delta else None
+        if patch:
+            with self.cache_registry.lock():
+                old_info = self.cache_registry.get_toolchain_info(toolchain_id)
+            if old_info and Path(old_info["path"]).is_dir():
+                logger.info(f"Applying delta {toolchain_id} -> {new_toolchain_id}...")
+                try:
+                    result = self.downloader.install_delta(
+                        toolchain_id=new_toolchain_id,
+                        base_dir=Path(old_info["path"]),
+                        url=patch["url"],
+                        sha256=patch["sha256"],
+                        archive_sha256=update_info.sha256,
+                        progress_callback=progress_callback,
+                    )
+                    return result.toolchain_path, "delta"
+                except Exception as e:
+                    logger.warning(f"Delta upgrade failed, using full download: {e}")
+
+        logger.info(f"Downloading {new_toolchain_id}...")
+        toolchain_path = self.downloader.download_and_install(
+            toolchain_id=new_toolchain_id,
+            url=update_info.download_url,
+            checksum=f"sha256:{update_info.sha256}",
+            progress_callback=progress_callback,
+        )
+        return toolchain_path, "full"
+
+    def _verify(self, toolchain_path: Path, toolchain_type: str, update_info):
+        """Run standard verification of an installed toolchain."""
+        return self.verifier.verify(
+            toolchain_path=toolchain_path,
+            toolchain_type=toolchain_type,
+            expected_version=update_info.latest_version,
+            level=VerificationLevel.STANDARD,
+        )
+
     def upgrade_all_toolchains(
-        self, force: bool = False, progress_callback=None
+        self,
+        force: bool = False,
+        progress_callback=None,
+        workers: int = DEFAULT_UPGRADE_WORKERS,
+        check_workers: int = DEFAULT_CHECK_WORKERS,
+        updates: Optional[Dict[str, UpdateInfo]] = None,
     ) -> List[UpgradeResult]:
         """
         Upgrade all installed toolchains.
 
+        Update checks run concurrently; downloads and extractions run on a
+        pool of ``workers`` threads, since a few concurrent transfers already
+        saturate the network and the disk. Project references and removal of
+        old versions are committed in one registry transaction at the end. A
+        failing toolchain only fails its own result.
+
         Args:
             force: Force re-download even if already latest
             progress_callback: Optional progress callback function
+            workers: Concurrent upgrades (downloads and extractions)
+            check_workers: Concurrent update checks
+            updates: Toolchain ID -> UpdateInfo from an earlier check; only
+                these are upgraded and no checks are made
+
+        Returns:
+            List of UpgradeResult for each upgraded toolchain and each
+            toolchain whose update check failed, in registry order
+        """
+        if updates is None:
+            checked = self._check_all(force=force, workers=check_workers)
+        else:
+            checked = [
+                (toolchain_id, info, None) for toolchain_id, info in updates.items()
+            ]
+        if not checked:
+            return []
+
+        registry_updates: List[Tuple[str, str]] = []
+
+        def upgrade(
+            item: Tuple[str, Optional[UpdateInfo], Optional[str]],
+        ) -> UpgradeResult:
+            toolchain_id, update_info, error = item
+            if error is not None:
+                return _failed(toolchain_id, f"Update check failed: {error}")
+            try:
+                return self.upgrade_toolchain(
+                    toolchain_id=toolchain_id,
+                    force=force,
+                    progress_callback=progress_callback,
+                    update_info=update_info,
+                    registry_updates=registry_updates,
+                )
+            except Exception as e:
+                logger.error(f"Failed to upgrade {toolchain_id}: {e}")
+                return _failed(toolchain_id, str(e))
+
+        with ThreadPoolExecutor(max_workers=max(1, workers)) as pool:
+            results = list(pool.map(upgrade, checked))
+
+        if registry_updates:
+            try:
+                self.commit_upgrades(registry_updates)
+            except Exception as e:
+                logger.error(f"Failed to update the toolchain registry: {e}")
+                committed = {old for old, _new in registry_updates}
+                results = [
+                    _failed(r.toolchain_id, f"Registry update failed: {e}")
+                    if r.toolchain_id in committed
+                    else r
+                    for r in results
+                ]
+        return results
+
+    def check_all_updates(
+        self, force: bool = False, workers: int = DEFAULT_CHECK_WORKERS
+    ) -> Dict[str, Optional[UpdateInfo]]:
+        """
+        Check every installed toolchain for updates concurrently.
+
+        Args:
+            force: Include every toolchain (mapped to None: upgrade_toolchain()
+                then looks up the latest version itself)
+            workers: Concurrent checks
 
         Returns:
-            List of UpgradeResult for each toolchain
+            Toolchain ID -> UpdateInfo for toolchains to upgrade, in registry
+            order; toolchains that fail to check are logged and skipped
+        """
+        updates = {}
+        for toolchain_id, update_info, error in self._check_all(force, workers):
+            if error is None:
+                updates[toolchain_id] = update_info
+        return updates
+
+    def _check_all(
+        self, force: bool, workers: int
+    ) -> List[Tuple[str, Optional[UpdateInfo], Optional[str]]]:
+        """
+        Check every installed toolchain for updates concurrently.
+
+        Returns:
+            (toolchain ID, UpdateInfo, None) for toolchains to upgrade and
+            (toolchain ID, None, error) for toolchains that failed to check,
+            in registry order
         """
         logger.info("Checking all toolchains for updates...")
 
@@ -493,41 +744,39 @@ class ToolchainUpgrader:
         if not toolchain_ids:
             logger.info("No toolchains installed")
             return []
+        if force:
+            return [(toolchain_id, None, None) for toolchain_id in toolchain_ids]
 
-        results = []
-
-        for toolchain_id in toolchain_ids:
-            # Check for updates
+        def check(toolchain_id: str) -> Tuple[Optional[UpdateInfo], Optional[str]]:
             try:
-                if not force:
-                    update_info = self.check_for_updates(toolchain_id)
-                    if not update_info:
-                        logger.debug(f"{toolchain_id} is up to date")
-                        continue
-
-                # Upgrade this toolchain
-                result = self.upgrade_toolchain(
-                    toolchain_id=toolchain_id,
-                    force=force,
-                    progress_callback=progress_callback,
-                )
-                results.append(result)
-
+                return self.check_for_updates(toolchain_id), None
             except Exception as e:
-                logger.error(f"Failed to upgrade {toolchain_id}: {e}")
-                results.append(
-                    UpgradeResult(
-                        toolchain_id=toolchain_id,
-                        old_version="unknown",
-                        new_version="unknown",
-                        success=False,
-                        error=str(e),
-                    )
-                )
+                logger.warning(f"Failed to check {toolchain_id}: {e}")
+                return None, str(e)
+
+        with ThreadPoolExecutor(max_workers=max(1, workers)) as pool:
+            checked = list(pool.map(check, toolchain_ids))
 
+        results = []
+        for toolchain_id, (update_info, error) in zip(toolchain_ids, checked):
+            if update_info or error is not None:
+                results.append((toolchain_id, update_info, error))
+            else:
+                logger.debug(f"{toolchain_id} is up to date")
         return results
 
 
+def _failed(toolchain_id: str, error: str) -> UpgradeResult:
+    """UpgradeResult of a toolchain that could not be upgraded."""
+    return UpgradeResult(
+        toolchain_id=toolchain_id,
+        old_version="unknown",
+        new_version="unknown",
+        success=False,
+        error=error,
+    )
+
+
 def check_toolchainkit_updates() -> Optional[tuple[str, str]]:
     """
     Check if ToolchainKit update is available on PyPI.
@@ -16,6 +16,7 @@ from enum import Enum
 from pathlib import Path
 from typing import Dict, List, Optional, Any
 
+from toolchainkit.core.manifest import IntegrityManifest, ManifestError
 from toolchainkit.core.platform import PlatformInfo
 
 logger = logging.getLogger(__name__)
@@ -26,8 +27,8 @@ class VerificationLevel(Enum):
 
     MINIMAL = "minimal"  # File presence only (~1s)
     STANDARD = "standard"  # + Executability + Version (~5s)
-    THOROUGH = "thorough"  # + ABI + Symlinks (~10s)
-    PARANOID = "paranoid"  # + Full compile test (~30s)
+    THOROUGH = "thorough"  # + ABI + Symlinks + Integrity (~10s)
+    PARANOID = "paranoid"  # + Deep integrity + Full compile test (~30s)
 
 
 @dataclass
@@ -38,6 +39,7 @@ class CheckResult:
     passed: bool
     message: str
     details: Dict[str, Any] = field(default_factory=dict)
+    warning: Optional[str] = None
 
 
 @dataclass
@@ -62,6 +64,8 @@ class VerificationResult:
             self.checks_passed.append(result.name)
             if result.message:
                 logger.debug(f"{result.name}: {result.message}")
+            if result.warning:
+                self.warnings.append(f"{result.name}: {result.warning}")
         else:
             self.checks_failed.append(result.name)
             self.errors.append(f"{result.name}: {result.message}")
@@ -223,6 +227,64 @@ class SymlinkCheck:
         return CheckResult(name="symlinks", passed=True, message="All symlinks valid")
 
 
+class IntegrityCheck:
+    """Verify installed files against the manifest written at install time."""
+
+    def __init__(self, deep: bool = False, strict: bool = False):
+        """
+        Initialize integrity check.
+
+        Args:
+            deep: Re-hash every file instead of only files whose stat changed
+            strict: Fail on files not in the manifest (else a warning)
+        """
+        self.deep = deep
+        self.strict = strict
+
+    def check(self, toolchain_path: Path, spec: ToolchainSpec) -> CheckResult:
+        """
+        Check file contents against the integrity manifest.
+
+        Args:
+            toolchain_path: Path to toolchain installation
+            spec: Toolchain specification
+
+        Returns:
+            CheckResult with integrity status
+        """
+        try:
+            manifest = IntegrityManifest.load(toolchain_path)
+        except ManifestError as e:
+            return CheckResult(name="integrity", passed=False, message=str(e))
+
+        if manifest is None:
+            return CheckResult(
+                name="integrity",
+                passed=True,
+                message="No integrity manifest, check skipped",
+            )
+
+        result = manifest.verify(deep=self.deep, strict=self.strict)
+        warning = None
+        if result.ok and result.unexpected:
+            warning = (
+                f"{len(result.unexpected)} file(s) not in the manifest: "
+                + ", ".join(result.unexpected[:3])
+            )
+        return CheckResult(
+            name="integrity",
+            passed=result.ok,
+            message=result.summary(),
+            warning=warning,
+            details={
+                "missing": result.missing,
+                "modified": result.modified,
+                "unexpected": result.unexpected,
+                "rehashed": result.rehashed,
+            },
+        )
+
+
 class ExecutabilityCheck:
     """Verify compilers can execute."""
 
@@ -620,6 +682,7 @@ class ToolchainVerifier:
                 VersionCheck(platform),
                 ABICheck(platform),
                 SymlinkCheck(),
+                IntegrityCheck(),
             ],
             VerificationLevel.PARANOID: [
                 FilePresenceCheck(platform),
@@ -627,6 +690,7 @@ class ToolchainVerifier:
                 VersionCheck(platform),
                 ABICheck(platform),
                 SymlinkCheck(),
+                IntegrityCheck(deep=True, strict=True),
                 CompileTestCheck(platform),
             ],
         }